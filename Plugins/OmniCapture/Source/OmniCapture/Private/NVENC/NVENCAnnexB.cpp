@@ -2,6 +2,112 @@
 
 #include "NVENC/NVENCAnnexB.h"
 
+namespace
+{
+    constexpr uint8 H264NALTypeSPS = 7;
+    constexpr uint8 H264NALTypePPS = 8;
+    constexpr uint8 H264NALTypeAUD = 9;
+    constexpr uint8 H264NALTypeFiller = 12;
+    constexpr uint8 HEVCNALTypeVPS = 32;
+    constexpr uint8 HEVCNALTypeSPS = 33;
+    constexpr uint8 HEVCNALTypePPS = 34;
+    constexpr uint8 HEVCNALTypeAUD = 35;
+    constexpr uint8 HEVCNALTypeFiller = 38;
+
+    uint8 GetNALType(const TArrayView<const uint8>& Unit, bool bHEVC)
+    {
+        return bHEVC ? static_cast<uint8>((Unit[0] >> 1) & 0x3F) : static_cast<uint8>(Unit[0] & 0x1F);
+    }
+
+    void AppendU16(TArray<uint8>& Out, uint32 Value)
+    {
+        Out.Add(static_cast<uint8>(Value >> 8));
+        Out.Add(static_cast<uint8>(Value));
+    }
+
+    void AppendU32(TArray<uint8>& Out, uint32 Value)
+    {
+        AppendU16(Out, Value >> 16);
+        AppendU16(Out, Value & 0xFFFF);
+    }
+
+    /** Reads the bits of a NAL unit payload after removing its emulation prevention bytes. */
+    class FRBSPReader
+    {
+    public:
+        explicit FRBSPReader(const TArrayView<const uint8>& Payload)
+        {
+            Bytes.Reserve(Payload.Num());
+            int32 ZeroCount = 0;
+            for (const uint8 Byte : Payload)
+            {
+                if (ZeroCount >= 2 && Byte == 0x03)
+                {
+                    ZeroCount = 0;
+                    continue;
+                }
+                Bytes.Add(Byte);
+                ZeroCount = Byte == 0 ? ZeroCount + 1 : 0;
+            }
+        }
+
+        uint32 ReadBits(int32 Count)
+        {
+            uint32 Value = 0;
+            for (int32 Bit = 0; Bit < Count; ++Bit)
+            {
+                const int64 ByteIndex = BitOffset >> 3;
+                if (ByteIndex >= Bytes.Num())
+                {
+                    bOverrun = true;
+                    return 0;
+                }
+                Value = (Value << 1) | ((Bytes[ByteIndex] >> (7 - (BitOffset & 7))) & 1);
+                ++BitOffset;
+            }
+            return Value;
+        }
+
+        /** Unsigned Exp-Golomb, ue(v). */
+        uint32 ReadUE()
+        {
+            int32 LeadingZeros = 0;
+            while (ReadBits(1) == 0 && !bOverrun)
+            {
+                if (++LeadingZeros > 31)
+                {
+                    bOverrun = true;
+                    return 0;
+                }
+            }
+            return ((1u << LeadingZeros) - 1) + ReadBits(LeadingZeros);
+        }
+
+        void SkipBits(int64 Count)
+        {
+            BitOffset += Count;
+            bOverrun |= (BitOffset >> 3) > Bytes.Num();
+        }
+
+        const TArray<uint8>& GetBytes() const { return Bytes; }
+        bool IsOverrun() const { return bOverrun; }
+
+    private:
+        TArray<uint8> Bytes;
+        int64 BitOffset = 0;
+        bool bOverrun = false;
+    };
+
+    void AppendParameterSets(TArray<uint8>& Out, const TArray<TArrayView<const uint8>>& Units)
+    {
+        for (const TArrayView<const uint8>& Unit : Units)
+        {
+            AppendU16(Out, Unit.Num());
+            Out.Append(Unit.GetData(), Unit.Num());
+        }
+    }
+}
+
 namespace OmniNVENC
 {
     void FNVENCAnnexB::Reset()
@@ -30,5 +136,246 @@ namespace OmniNVENC
         CodecConfig.Append(AnnexBStartCode, UE_ARRAY_COUNT(AnnexBStartCode));
         CodecConfig.Append(InData);
     }
-}
 
+    void FNVENCAnnexB::SplitNALUnits(const uint8* Data, int64 Size, TArray<TArrayView<const uint8>>& OutUnits)
+    {
+        OutUnits.Reset();
+
+        auto AddUnit = [Data, &OutUnits](int64 Start, int64 End)
+        {
+            // Zeros before the next start code are either its leading byte or trailing_zero_8bits.
+            while (End > Start && Data[End - 1] == 0)
+            {
+                --End;
+            }
+            if (End > Start)
+            {
+                OutUnits.Add(TArrayView<const uint8>(Data + Start, static_cast<int32>(End - Start)));
+            }
+        };
+
+        int64 UnitStart = -1;
+        int64 Index = 0;
+        while (Index + 3 <= Size)
+        {
+            if (Data[Index] == 0 && Data[Index + 1] == 0 && Data[Index + 2] == 1)
+            {
+                if (UnitStart >= 0)
+                {
+                    AddUnit(UnitStart, Index);
+                }
+                Index += 3;
+                UnitStart = Index;
+                continue;
+            }
+            ++Index;
+        }
+
+        if (UnitStart >= 0)
+        {
+            AddUnit(UnitStart, Size);
+        }
+    }
+
+    void FNVENCAnnexB::ToLengthPrefixed(const uint8* Data, int64 Size, bool bHEVC, TArray<uint8>& OutSample)
+    {
+        OutSample.Reset();
+
+        TArray<TArrayView<const uint8>> Units;
+        SplitNALUnits(Data, Size, Units);
+        for (const TArrayView<const uint8>& Unit : Units)
+        {
+            const uint8 Type = GetNALType(Unit, bHEVC);
+            const bool bOutOfBand = bHEVC
+                ? (Type == HEVCNALTypeVPS || Type == HEVCNALTypeSPS || Type == HEVCNALTypePPS || Type == HEVCNALTypeAUD || Type == HEVCNALTypeFiller)
+                : (Type == H264NALTypeSPS || Type == H264NALTypePPS || Type == H264NALTypeAUD || Type == H264NALTypeFiller);
+            if (bOutOfBand)
+            {
+                continue;
+            }
+
+            AppendU32(OutSample, Unit.Num());
+            OutSample.Append(Unit.GetData(), Unit.Num());
+        }
+    }
+
+    bool FNVENCAnnexB::BuildAVCDecoderConfigurationRecord(const uint8* Data, int64 Size, TArray<uint8>& OutRecord)
+    {
+        OutRecord.Reset();
+
+        TArray<TArrayView<const uint8>> Units;
+        SplitNALUnits(Data, Size, Units);
+
+        TArray<TArrayView<const uint8>> SPS;
+        TArray<TArrayView<const uint8>> PPS;
+        for (const TArrayView<const uint8>& Unit : Units)
+        {
+            const uint8 Type = GetNALType(Unit, false);
+            if (Type == H264NALTypeSPS)
+            {
+                SPS.Add(Unit);
+            }
+            else if (Type == H264NALTypePPS)
+            {
+                PPS.Add(Unit);
+            }
+        }
+
+        if (SPS.Num() == 0 || PPS.Num() == 0 || SPS[0].Num() < 4 || SPS.Num() > 31)
+        {
+            return false;
+        }
+
+        const uint8 ProfileIdc = SPS[0][1];
+        OutRecord.Add(1);
+        OutRecord.Add(ProfileIdc);
+        OutRecord.Add(SPS[0][2]);
+        OutRecord.Add(SPS[0][3]);
+        OutRecord.Add(0xFF); // 4-byte NAL lengths
+        OutRecord.Add(static_cast<uint8>(0xE0 | SPS.Num()));
+        AppendParameterSets(OutRecord, SPS);
+        OutRecord.Add(static_cast<uint8>(PPS.Num()));
+        AppendParameterSets(OutRecord, PPS);
+
+        // High profiles carry their chroma format and bit depths in the record as well.
+        if (ProfileIdc == 100 || ProfileIdc == 110 || ProfileIdc == 122 || ProfileIdc == 144 || ProfileIdc == 244)
+        {
+            FRBSPReader Reader(SPS[0].Slice(1, SPS[0].Num() - 1));
+            Reader.SkipBits(24);
+            Reader.ReadUE(); // seq_parameter_set_id
+            const uint32 ChromaFormat = Reader.ReadUE();
+            if (ChromaFormat == 3)
+            {
+                Reader.SkipBits(1);
+            }
+            const uint32 LumaDepthMinus8 = Reader.ReadUE();
+            const uint32 ChromaDepthMinus8 = Reader.ReadUE();
+            if (Reader.IsOverrun())
+            {
+                OutRecord.Reset();
+                return false;
+            }
+
+            OutRecord.Add(static_cast<uint8>(0xFC | (ChromaFormat & 0x3)));
+            OutRecord.Add(static_cast<uint8>(0xF8 | (LumaDepthMinus8 & 0x7)));
+            OutRecord.Add(static_cast<uint8>(0xF8 | (ChromaDepthMinus8 & 0x7)));
+            OutRecord.Add(0); // numOfSequenceParameterSetExt
+        }
+        return true;
+    }
+
+    bool FNVENCAnnexB::BuildHEVCDecoderConfigurationRecord(const uint8* Data, int64 Size, TArray<uint8>& OutRecord)
+    {
+        OutRecord.Reset();
+
+        TArray<TArrayView<const uint8>> Units;
+        SplitNALUnits(Data, Size, Units);
+
+        TArray<TArrayView<const uint8>> VPS;
+        TArray<TArrayView<const uint8>> SPS;
+        TArray<TArrayView<const uint8>> PPS;
+        for (const TArrayView<const uint8>& Unit : Units)
+        {
+            if (Unit.Num() < 2)
+            {
+                continue;
+            }
+            switch (GetNALType(Unit, true))
+            {
+            case HEVCNALTypeVPS:
+                VPS.Add(Unit);
+                break;
+            case HEVCNALTypeSPS:
+                SPS.Add(Unit);
+                break;
+            case HEVCNALTypePPS:
+                PPS.Add(Unit);
+                break;
+            default:
+                break;
+            }
+        }
+
+        if (VPS.Num() == 0 || SPS.Num() == 0 || PPS.Num() == 0)
+        {
+            return false;
+        }
+
+        // seq_parameter_set_rbsp() up to the bit depths; the general profile_tier_level is byte aligned after the first byte.
+        FRBSPReader Reader(SPS[0].Slice(2, SPS[0].Num() - 2));
+        Reader.SkipBits(4); // sps_video_parameter_set_id
+        const uint32 MaxSubLayersMinus1 = Reader.ReadBits(3);
+        const uint32 TemporalIdNesting = Reader.ReadBits(1);
+        if (Reader.GetBytes().Num() < 13)
+        {
+            return false;
+        }
+        const TArray<uint8>& Bytes = Reader.GetBytes();
+        const uint8* GeneralProfileTierLevel = Bytes.GetData() + 1;
+        Reader.SkipBits(96);
+
+        bool SubLayerProfilePresent[8] = {};
+        bool SubLayerLevelPresent[8] = {};
+        for (uint32 Layer = 0; Layer < MaxSubLayersMinus1; ++Layer)
+        {
+            SubLayerProfilePresent[Layer] = Reader.ReadBits(1) != 0;
+            SubLayerLevelPresent[Layer] = Reader.ReadBits(1) != 0;
+        }
+        if (MaxSubLayersMinus1 > 0)
+        {
+            Reader.SkipBits(2 * (8 - MaxSubLayersMinus1));
+        }
+        for (uint32 Layer = 0; Layer < MaxSubLayersMinus1; ++Layer)
+        {
+            Reader.SkipBits((SubLayerProfilePresent[Layer] ? 88 : 0) + (SubLayerLevelPresent[Layer] ? 8 : 0));
+        }
+
+        Reader.ReadUE(); // sps_seq_parameter_set_id
+        const uint32 ChromaFormat = Reader.ReadUE();
+        if (ChromaFormat == 3)
+        {
+            Reader.SkipBits(1);
+        }
+        Reader.ReadUE(); // pic_width_in_luma_samples
+        Reader.ReadUE(); // pic_height_in_luma_samples
+        if (Reader.ReadBits(1) != 0)
+        {
+            for (int32 Offset = 0; Offset < 4; ++Offset)
+            {
+                Reader.ReadUE(); // conf_win_*_offset
+            }
+        }
+        const uint32 LumaDepthMinus8 = Reader.ReadUE();
+        const uint32 ChromaDepthMinus8 = Reader.ReadUE();
+        if (Reader.IsOverrun())
+        {
+            return false;
+        }
+
+        OutRecord.Add(1);
+        OutRecord.Append(GeneralProfileTierLevel, 1 + 4 + 6); // profile space/tier/idc, compatibility and constraint flags
+        OutRecord.Add(GeneralProfileTierLevel[11]);           // general_level_idc
+        AppendU16(OutRecord, 0xF000);                         // min_spatial_segmentation_idc
+        OutRecord.Add(0xFC);                                  // parallelismType unknown
+        OutRecord.Add(static_cast<uint8>(0xFC | (ChromaFormat & 0x3)));
+        OutRecord.Add(static_cast<uint8>(0xF8 | (LumaDepthMinus8 & 0x7)));
+        OutRecord.Add(static_cast<uint8>(0xF8 | (ChromaDepthMinus8 & 0x7)));
+        AppendU16(OutRecord, 0);                              // avgFrameRate unspecified
+        OutRecord.Add(static_cast<uint8>(((MaxSubLayersMinus1 + 1) << 3) | (TemporalIdNesting << 2) | 0x3));
+        OutRecord.Add(3);
+
+        const TPair<uint8, const TArray<TArrayView<const uint8>>*> Arrays[] =
+        {
+            { HEVCNALTypeVPS, &VPS },
+            { HEVCNALTypeSPS, &SPS },
+            { HEVCNALTypePPS, &PPS },
+        };
+        for (const TPair<uint8, const TArray<TArrayView<const uint8>>*>& Array : Arrays)
+        {
+            OutRecord.Add(static_cast<uint8>(0x80 | Array.Key)); // array_completeness
+            AppendU16(OutRecord, Array.Value->Num());
+            AppendParameterSets(OutRecord, *Array.Value);
+        }
+        return true;
+    }
+}
@@ -0,0 +1,392 @@
+#include "OmniCaptureAudioClock.h"
+
+#include "OmniCaptureAudioRing.h"
+
+namespace
+{
+    constexpr int32 GFilterTaps = FOmniCaptureAudioResampler::HalfTaps * 2;
+    // Filter phases per input frame; coefficients between two phases are interpolated linearly.
+    constexpr int32 GFilterPhases = 256;
+    constexpr double GKaiserBeta = 8.0;
+    // Consumed input is only moved out of the FIFO once this much has piled up.
+    constexpr int32 GCompactThresholdFrames = 8192;
+
+    // Controller tuning: the buffered input is smoothed over GBacklogSmoothingSeconds, then a PI loop with natural
+    // frequency sqrt(GIntegralGain) and damping near 0.7 settles a step in drift within about 40 seconds.
+    constexpr double GBacklogSmoothingSeconds = 0.5;
+    constexpr double GProportionalGain = 0.2;
+    constexpr double GIntegralGain = 0.02;
+    // Timestamp gaps shorter than this are rounding on the audio clock, not missing audio.
+    constexpr double GInputGapToleranceSeconds = 0.002;
+
+    double BesselI0(double X)
+    {
+        double Sum = 1.0;
+        double Term = 1.0;
+        const double HalfX = X * 0.5;
+        for (int32 K = 1; K < 32; ++K)
+        {
+            Term *= (HalfX / K) * (HalfX / K);
+            Sum += Term;
+            if (Term < Sum * 1e-12)
+            {
+                break;
+            }
+        }
+        return Sum;
+    }
+
+    // Row P holds the taps for a read position P / GFilterPhases past an input frame; tap J weights the frame at
+    // offset J - HalfTaps + 1. Rows are normalised so every phase has unity gain at DC.
+    const TArray<float>& GetFilterTable()
+    {
+        static const TArray<float> Table = []()
+        {
+            constexpr int32 HalfTaps = FOmniCaptureAudioResampler::HalfTaps;
+            TArray<float> Coefficients;
+            Coefficients.SetNumZeroed((GFilterPhases + 1) * GFilterTaps);
+            const double WindowNormalisation = BesselI0(GKaiserBeta);
+            for (int32 Phase = 0; Phase <= GFilterPhases; ++Phase)
+            {
+                float* Row = Coefficients.GetData() + Phase * GFilterTaps;
+                if (Phase == 0 || Phase == GFilterPhases)
+                {
+                    // Whole-frame positions are the input frame itself.
+                    Row[Phase == 0 ? HalfTaps - 1 : HalfTaps] = 1.0f;
+                    continue;
+                }
+
+                const double Fraction = static_cast<double>(Phase) / GFilterPhases;
+                double Sum = 0.0;
+                double Taps[GFilterTaps];
+                for (int32 Tap = 0; Tap < GFilterTaps; ++Tap)
+                {
+                    const double X = static_cast<double>(Tap - HalfTaps + 1) - Fraction;
+                    const double Sinc = FMath::Sin(PI * X) / (PI * X);
+                    const double Normalised = X / HalfTaps;
+                    const double Window = FMath::Abs(Normalised) < 1.0 ? BesselI0(GKaiserBeta * FMath::Sqrt(1.0 - Normalised * Normalised)) / WindowNormalisation : 0.0;
+                    Taps[Tap] = Sinc * Window;
+                    Sum += Taps[Tap];
+                }
+                for (int32 Tap = 0; Tap < GFilterTaps; ++Tap)
+                {
+                    Row[Tap] = static_cast<float>(Taps[Tap] / Sum);
+                }
+            }
+            return Coefficients;
+        }();
+        return Table;
+    }
+}
+
+void FOmniCaptureAudioResampler::Reset(int32 InNumChannels)
+{
+    NumChannels = FMath::Max(1, InNumChannels);
+    Buffer.Reset();
+    // Silent history so the first output frames have something to filter against.
+    Buffer.SetNumZeroed(HalfTaps * NumChannels);
+    ReadPosition = HalfTaps;
+}
+
+void FOmniCaptureAudioResampler::AddInput(const int16* Samples, int32 NumFrames)
+{
+    if (NumChannels == 0 || NumFrames <= 0)
+    {
+        return;
+    }
+
+    constexpr float Scale = 1.0f / 32767.0f;
+    const int32 Count = NumFrames * NumChannels;
+    const int32 Start = Buffer.AddUninitialized(Count);
+    float* Destination = Buffer.GetData() + Start;
+    for (int32 Index = 0; Index < Count; ++Index)
+    {
+        Destination[Index] = Samples[Index] * Scale;
+    }
+}
+
+void FOmniCaptureAudioResampler::AddSilence(int32 NumFrames)
+{
+    if (NumChannels == 0 || NumFrames <= 0)
+    {
+        return;
+    }
+
+    Buffer.AddZeroed(NumFrames * NumChannels);
+}
+
+void FOmniCaptureAudioResampler::Skip(double NumFrames)
+{
+    ReadPosition += FMath::Clamp(NumFrames, 0.0, GetBufferedFrames());
+    Compact();
+}
+
+double FOmniCaptureAudioResampler::GetBufferedFrames() const
+{
+    if (NumChannels == 0)
+    {
+        return 0.0;
+    }
+
+    const int32 Frames = Buffer.Num() / NumChannels;
+    return FMath::Max(0.0, static_cast<double>(Frames - HalfTaps) - ReadPosition);
+}
+
+int32 FOmniCaptureAudioResampler::Process(double Ratio, float* Output, int32 MaxFrames)
+{
+    if (NumChannels == 0)
+    {
+        return 0;
+    }
+
+    const TArray<float>& Table = GetFilterTable();
+    const int32 Frames = Buffer.Num() / NumChannels;
+    const float* Input = Buffer.GetData();
+
+    int32 Written = 0;
+    while (Written < MaxFrames)
+    {
+        const int32 Base = FMath::FloorToInt(ReadPosition);
+        if (Base + HalfTaps >= Frames)
+        {
+            break;
+        }
+
+        const double PhasePosition = (ReadPosition - Base) * GFilterPhases;
+        const int32 Phase = FMath::Min(FMath::FloorToInt(PhasePosition), GFilterPhases - 1);
+        const float Blend = static_cast<float>(PhasePosition - Phase);
+        const float* RowA = Table.GetData() + Phase * GFilterTaps;
+        const float* RowB = RowA + GFilterTaps;
+
+        float Coefficients[GFilterTaps];
+        for (int32 Tap = 0; Tap < GFilterTaps; ++Tap)
+        {
+            Coefficients[Tap] = RowA[Tap] + (RowB[Tap] - RowA[Tap]) * Blend;
+        }
+
+        const float* Window = Input + (Base - HalfTaps + 1) * NumChannels;
+        float* Frame = Output + Written * NumChannels;
+        for (int32 Channel = 0; Channel < NumChannels; ++Channel)
+        {
+            float Sum = 0.0f;
+            for (int32 Tap = 0; Tap < GFilterTaps; ++Tap)
+            {
+                Sum += Window[Tap * NumChannels + Channel] * Coefficients[Tap];
+            }
+            Frame[Channel] = Sum;
+        }
+
+        ReadPosition += Ratio;
+        ++Written;
+    }
+
+    Compact();
+    return Written;
+}
+
+void FOmniCaptureAudioResampler::Compact()
+{
+    // Keep HalfTaps - 1 frames of history behind the read position for the filter.
+    const int32 Removable = FMath::FloorToInt(ReadPosition) - (HalfTaps - 1);
+    if (Removable < GCompactThresholdFrames)
+    {
+        return;
+    }
+
+    Buffer.RemoveAt(0, Removable * NumChannels, EAllowShrinking::No);
+    ReadPosition -= Removable;
+}
+
+FOmniCaptureAudioClock::FOmniCaptureAudioClock()
+{
+    Reset();
+}
+
+void FOmniCaptureAudioClock::Reset()
+{
+    Resampler = FOmniCaptureAudioResampler();
+    SampleRate = 0;
+    bHasInputTime = false;
+    NextInputTimestamp = 0.0;
+    bRealign = false;
+    bRealignAfterGap = false;
+    bHasOrigin = false;
+    Origin = 0.0;
+    LastVideoTimestamp = 0.0;
+    EmittedFrames = 0;
+    SmoothedBacklog = 0.0;
+    IntegratedBacklog = 0.0;
+    Ratio = 1.0;
+    Stats = FOmniCaptureAudioClockStats();
+}
+
+void FOmniCaptureAudioClock::SetMaxRatioDeviation(double InMaxRatioDeviation)
+{
+    MaxRatioDeviation = FMath::Clamp(InMaxRatioDeviation, 0.0, 0.1);
+}
+
+void FOmniCaptureAudioClock::AddInput(const FOmniAudioPacket& Packet)
+{
+    if (Packet.SampleRate <= 0 || Packet.NumChannels <= 0 || Packet.PCM16.Num() < Packet.NumChannels)
+    {
+        return;
+    }
+
+    if (Packet.SampleRate != SampleRate || Packet.NumChannels != Resampler.GetNumChannels())
+    {
+        // Output already emitted stays where it is; only the input and the controller start over.
+        if (SampleRate > 0 && Packet.SampleRate != SampleRate)
+        {
+            EmittedFrames = FMath::RoundToInt64((LastVideoTimestamp - Origin) * Packet.SampleRate);
+        }
+        SampleRate = Packet.SampleRate;
+        Resampler.Reset(Packet.NumChannels);
+        bHasInputTime = false;
+        SmoothedBacklog = 0.0;
+        IntegratedBacklog = 0.0;
+        Ratio = 1.0;
+    }
+
+    const int32 NumFrames = Packet.PCM16.Num() / Packet.NumChannels;
+    if (!bHasInputTime)
+    {
+        bRealign = true;
+    }
+    else
+    {
+        const double Gap = Packet.Timestamp - NextInputTimestamp;
+        if (Gap > MaxBacklogSeconds)
+        {
+            // The device stalled or the capture was paused. Whatever the video timeline is owed up to this block
+            // becomes silence in Produce; leftovers from before the gap would land in the wrong place.
+            Resampler.Skip(Resampler.GetBufferedFrames());
+            bRealign = true;
+            bRealignAfterGap = true;
+        }
+        else if (Gap > GInputGapToleranceSeconds)
+        {
+            Resampler.AddSilence(FMath::RoundToInt(Gap * SampleRate));
+        }
+    }
+
+    Resampler.AddInput(Packet.PCM16.GetData(), NumFrames);
+    NextInputTimestamp = Packet.Timestamp + static_cast<double>(NumFrames) / SampleRate;
+    bHasInputTime = true;
+    Stats.InputFrames += NumFrames;
+}
+
+bool FOmniCaptureAudioClock::Produce(double VideoTimestamp, FOmniAudioPacket& OutPacket)
+{
+    if (!bHasOrigin)
+    {
+        bHasOrigin = true;
+        Origin = VideoTimestamp;
+        LastVideoTimestamp = VideoTimestamp;
+        // Audio captured so far precedes the first frame.
+        Resampler.Skip(Resampler.GetBufferedFrames());
+        bRealign = false;
+        bRealignAfterGap = false;
+        return false;
+    }
+
+    const double DeltaSeconds = VideoTimestamp - LastVideoTimestamp;
+    if (DeltaSeconds <= 0.0)
+    {
+        return false;
+    }
+    LastVideoTimestamp = VideoTimestamp;
+
+    if (SampleRate <= 0)
+    {
+        // No input has arrived yet, so this frame has no audio at all.
+        ++Stats.Underruns;
+        return false;
+    }
+
+    const int64 Target = FMath::RoundToInt64((VideoTimestamp - Origin) * SampleRate);
+    const int32 Owed = static_cast<int32>(Target - EmittedFrames);
+    if (Owed <= 0)
+    {
+        return false;
+    }
+
+    const double MaxBacklogFrames = MaxBacklogSeconds * SampleRate;
+    const double Surplus = Resampler.GetBufferedFrames() - Owed * Ratio;
+    if (Surplus > MaxBacklogFrames)
+    {
+        Resampler.Skip(Surplus);
+        SmoothedBacklog = 0.0;
+        IntegratedBacklog = 0.0;
+        ++Stats.Resyncs;
+    }
+
+    const int32 NumChannels = Resampler.GetNumChannels();
+    OutputScratch.SetNumUninitialized(Owed * NumChannels, EAllowShrinking::No);
+    int32 Produced = 0;
+    if (bRealign)
+    {
+        // The newest buffered frame is now; pad in front so the input ends where this frame does.
+        Produced = FMath::Max(0, Owed - FMath::FloorToInt(Resampler.GetBufferedFrames()));
+        FMemory::Memzero(OutputScratch.GetData(), Produced * NumChannels * sizeof(float));
+        if (bRealignAfterGap && Produced > 0)
+        {
+            ++Stats.Resyncs;
+        }
+        bRealign = false;
+        bRealignAfterGap = false;
+        SmoothedBacklog = 0.0;
+        IntegratedBacklog = 0.0;
+    }
+    Produced += Resampler.Process(Ratio, OutputScratch.GetData() + Produced * NumChannels, Owed - Produced);
+
+    const int32 Deficit = Owed - Produced;
+    if (Deficit > 0)
+    {
+        ++Stats.Underruns;
+    }
+    if (Deficit > MaxBacklogFrames)
+    {
+        FMemory::Memzero(OutputScratch.GetData() + Produced * NumChannels, Deficit * NumChannels * sizeof(float));
+        Produced = Owed;
+        SmoothedBacklog = 0.0;
+        IntegratedBacklog = 0.0;
+        ++Stats.Resyncs;
+    }
+    else
+    {
+        UpdateCorrection((Resampler.GetBufferedFrames() - Deficit * Ratio) / SampleRate, DeltaSeconds);
+    }
+
+    if (Produced == 0)
+    {
+        return false;
+    }
+
+    OutPacket.Timestamp = Origin + static_cast<double>(EmittedFrames) / SampleRate;
+    OutPacket.SampleRate = SampleRate;
+    OutPacket.NumChannels = NumChannels;
+    OutPacket.PCM16.SetNumUninitialized(Produced * NumChannels);
+    FOmniCaptureAudioRing::ConvertToPCM16(OutputScratch.GetData(), OutPacket.PCM16.GetData(), Produced * NumChannels, 1.0f);
+
+    EmittedFrames += Produced;
+    Stats.OutputFrames += Produced;
+    return true;
+}
+
+void FOmniCaptureAudioClock::UpdateCorrection(double Backlog, double DeltaSeconds)
+{
+    const double Alpha = 1.0 - FMath::Exp(-DeltaSeconds / GBacklogSmoothingSeconds);
+    SmoothedBacklog += (Backlog - SmoothedBacklog) * Alpha;
+
+    const double Unclamped = GProportionalGain * SmoothedBacklog + GIntegralGain * (IntegratedBacklog + SmoothedBacklog * DeltaSeconds);
+    // Stop integrating while the ratio is pinned at its bound, so the loop recovers without overshoot.
+    if (FMath::Abs(Unclamped) <= MaxRatioDeviation || (Unclamped > 0.0) != (SmoothedBacklog > 0.0))
+    {
+        IntegratedBacklog += SmoothedBacklog * DeltaSeconds;
+    }
+
+    const double Correction = FMath::Clamp(GProportionalGain * SmoothedBacklog + GIntegralGain * IntegratedBacklog, -MaxRatioDeviation, MaxRatioDeviation);
+    Ratio = 1.0 + Correction;
+    Stats.LockErrorMilliseconds = SmoothedBacklog * 1000.0;
+    Stats.CorrectionPPM = Correction * 1e6;
+}
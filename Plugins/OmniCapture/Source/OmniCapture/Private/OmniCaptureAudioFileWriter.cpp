@@ -0,0 +1,569 @@
+#include "OmniCaptureAudioFileWriter.h"
+
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "OmniCaptureLog.h"
+
+namespace
+{
+    constexpr int32 GBytesPerSample = sizeof(int16);
+    // RIFF/RF64, JUNK/ds64 with room for the 64-bit sizes, a PCM fmt chunk and the data chunk header.
+    constexpr int64 GWavHeaderBytes = 80;
+    constexpr int64 GWavDs64Offset = 12;
+    constexpr uint32 GWavDs64Bytes = 28;
+    // caff file header, desc chunk and the data chunk header with its edit count.
+    constexpr int64 GCafHeaderBytes = 68;
+    // Enough to find the data chunk of any file this writer produced or that a typical tool wrote.
+    constexpr int64 GRecoveryScanBytes = 64 * 1024;
+
+    void AppendTag(TArray<uint8>& Out, const char (&Tag)[5])
+    {
+        Out.Append(reinterpret_cast<const uint8*>(Tag), 4);
+    }
+
+    void AppendLE(TArray<uint8>& Out, uint64 Value, int32 Bytes)
+    {
+        for (int32 Index = 0; Index < Bytes; ++Index)
+        {
+            Out.Add(static_cast<uint8>(Value >> (8 * Index)));
+        }
+    }
+
+    void AppendBE(TArray<uint8>& Out, uint64 Value, int32 Bytes)
+    {
+        for (int32 Index = Bytes - 1; Index >= 0; --Index)
+        {
+            Out.Add(static_cast<uint8>(Value >> (8 * Index)));
+        }
+    }
+
+    uint64 ReadLE(const uint8* Data, int32 Bytes)
+    {
+        uint64 Value = 0;
+        for (int32 Index = Bytes - 1; Index >= 0; --Index)
+        {
+            Value = (Value << 8) | Data[Index];
+        }
+        return Value;
+    }
+
+    uint64 ReadBE(const uint8* Data, int32 Bytes)
+    {
+        uint64 Value = 0;
+        for (int32 Index = 0; Index < Bytes; ++Index)
+        {
+            Value = (Value << 8) | Data[Index];
+        }
+        return Value;
+    }
+
+    bool HasTag(const uint8* Data, const char (&Tag)[5])
+    {
+        return FMemory::Memcmp(Data, Tag, 4) == 0;
+    }
+
+    bool PatchFile(const FString& FilePath, const TArray<TPair<int64, TArray<uint8>>>& Patches)
+    {
+        TUniquePtr<IFileHandle> File(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, true, true));
+        if (!File.IsValid())
+        {
+            return false;
+        }
+        for (const TPair<int64, TArray<uint8>>& Patch : Patches)
+        {
+            if (!File->Seek(Patch.Key) || !File->Write(Patch.Value.GetData(), Patch.Value.Num()))
+            {
+                return false;
+            }
+        }
+        return File->Flush();
+    }
+
+    bool RecoverWav(const FString& FilePath, const TArray<uint8>& Head, int64 FileSize)
+    {
+        const uint8* Data = Head.GetData();
+        int32 NumChannels = 0;
+        int32 SampleRate = 0;
+        int32 BlockAlign = 0;
+        int32 FormatTag = 0;
+        int32 BitsPerSample = 0;
+        int64 FmtOffset = INDEX_NONE;
+        int64 DataOffset = INDEX_NONE;
+
+        // In RF64 files the data chunk's 32-bit size is a placeholder, so the walk stops at the data chunk.
+        int64 Position = 12;
+        while (Position + 8 <= Head.Num())
+        {
+            const uint32 ChunkSize = static_cast<uint32>(ReadLE(Data + Position + 4, 4));
+            if (HasTag(Data + Position, "data"))
+            {
+                DataOffset = Position + 8;
+                break;
+            }
+            if (HasTag(Data + Position, "fmt ") && ChunkSize >= 16 && Position + 8 + 16 <= Head.Num())
+            {
+                const uint8* Fmt = Data + Position + 8;
+                FmtOffset = Position;
+                FormatTag = static_cast<int32>(ReadLE(Fmt, 2));
+                NumChannels = static_cast<int32>(ReadLE(Fmt + 2, 2));
+                SampleRate = static_cast<int32>(ReadLE(Fmt + 4, 4));
+                BlockAlign = static_cast<int32>(ReadLE(Fmt + 12, 2));
+                BitsPerSample = static_cast<int32>(ReadLE(Fmt + 14, 2));
+            }
+            Position += 8 + static_cast<int64>(ChunkSize) + (ChunkSize & 1);
+        }
+
+        if (FmtOffset == INDEX_NONE || DataOffset == INDEX_NONE || BlockAlign <= 0)
+        {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: no fmt and data chunks in its header."), *FilePath);
+            return false;
+        }
+
+        // A partly written frame at the end is left out rather than played as noise.
+        int64 DataBytes = FMath::Max<int64>(0, FileSize - DataOffset);
+        DataBytes -= DataBytes % BlockAlign;
+
+        const bool bOwnLayout = FmtOffset == 48 && DataOffset == GWavHeaderBytes && FormatTag == 1 && BitsPerSample == 16
+            && (HasTag(Data + GWavDs64Offset, "JUNK") || HasTag(Data + GWavDs64Offset, "ds64"))
+            && ReadLE(Data + GWavDs64Offset + 4, 4) == GWavDs64Bytes;
+        TArray<TPair<int64, TArray<uint8>>> Patches;
+        if (bOwnLayout)
+        {
+            Patches.Emplace(0, FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat::WAV, SampleRate, NumChannels, DataBytes));
+        }
+        else
+        {
+            const int64 RiffBytes = DataOffset - 8 + DataBytes;
+            if (RiffBytes > MAX_uint32 || !HasTag(Data, "RIFF"))
+            {
+                UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: its header has no room for the recovered size."), *FilePath);
+                return false;
+            }
+            TArray<uint8> RiffSize;
+            AppendLE(RiffSize, static_cast<uint64>(RiffBytes), 4);
+            TArray<uint8> DataSize;
+            AppendLE(DataSize, static_cast<uint64>(DataBytes), 4);
+            Patches.Emplace(4, MoveTemp(RiffSize));
+            Patches.Emplace(DataOffset - 4, MoveTemp(DataSize));
+        }
+
+        if (!PatchFile(FilePath, Patches))
+        {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: the header could not be rewritten."), *FilePath);
+            return false;
+        }
+        UE_LOG(LogOmniCaptureAudio, Log, TEXT("Recovered %lld sample frames in %s."), DataBytes / BlockAlign, *FilePath);
+        return true;
+    }
+
+    bool RecoverCaf(const FString& FilePath, const TArray<uint8>& Head, int64 FileSize)
+    {
+        const uint8* Data = Head.GetData();
+        int64 BytesPerPacket = 0;
+        int64 DataChunkOffset = INDEX_NONE;
+
+        // The data chunk of an unfinished file has a size of -1, so the walk stops there too.
+        int64 Position = 8;
+        while (Position + 12 <= Head.Num())
+        {
+            const int64 ChunkSize = static_cast<int64>(ReadBE(Data + Position + 4, 8));
+            if (HasTag(Data + Position, "data"))
+            {
+                DataChunkOffset = Position;
+                break;
+            }
+            if (ChunkSize < 0 || ChunkSize > Head.Num())
+            {
+                break;
+            }
+            if (HasTag(Data + Position, "desc") && ChunkSize >= 32 && Position + 12 + 32 <= Head.Num())
+            {
+                BytesPerPacket = static_cast<int64>(ReadBE(Data + Position + 12 + 16, 4));
+            }
+            Position += 12 + ChunkSize;
+        }
+
+        if (DataChunkOffset == INDEX_NONE || BytesPerPacket <= 0)
+        {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: no desc and data chunks in its header."), *FilePath);
+            return false;
+        }
+
+        // The chunk body opens with a 32-bit edit count before the audio.
+        const int64 AudioOffset = DataChunkOffset + 12 + 4;
+        int64 DataBytes = FMath::Max<int64>(0, FileSize - AudioOffset);
+        DataBytes -= DataBytes % BytesPerPacket;
+
+        TArray<uint8> ChunkSize;
+        AppendBE(ChunkSize, static_cast<uint64>(DataBytes + 4), 8);
+        TArray<TPair<int64, TArray<uint8>>> Patches;
+        Patches.Emplace(DataChunkOffset + 4, MoveTemp(ChunkSize));
+        if (!PatchFile(FilePath, Patches))
+        {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: the header could not be rewritten."), *FilePath);
+            return false;
+        }
+        UE_LOG(LogOmniCaptureAudio, Log, TEXT("Recovered %lld sample frames in %s."), DataBytes / BytesPerPacket, *FilePath);
+        return true;
+    }
+}
+
+FOmniCaptureAudioFileWriter::FOmniCaptureAudioFileWriter()
+{
+    WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+    SpaceEvent = FPlatformProcess::GetSynchEventFromPool();
+}
+
+FOmniCaptureAudioFileWriter::~FOmniCaptureAudioFileWriter()
+{
+    Close();
+
+    FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+    WorkEvent = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+    SpaceEvent = nullptr;
+}
+
+bool FOmniCaptureAudioFileWriter::Open(const FString& InPath, EOmniCaptureAudioFileFormat InFormat, int32 InSampleRate, int32 InNumChannels)
+{
+    check(!Thread.IsValid());
+    if (InSampleRate <= 0 || InNumChannels <= 0 || InNumChannels > MAX_uint16)
+    {
+        return false;
+    }
+
+    Path = InPath;
+    Format = InFormat;
+    SampleRate = InSampleRate;
+    NumChannels = InNumChannels;
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+    File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path, false, false));
+    if (!File.IsValid())
+    {
+        UE_LOG(LogOmniCaptureAudio, Error, TEXT("Failed to create audio file %s"), *Path);
+        return false;
+    }
+
+    const TArray<uint8> Header = BuildHeader(Format, SampleRate, NumChannels, -1);
+    if (!File->Write(Header.GetData(), Header.Num()))
+    {
+        UE_LOG(LogOmniCaptureAudio, Error, TEXT("Failed to write the header of audio file %s"), *Path);
+        File.Reset();
+        return false;
+    }
+    HeaderBytes = Header.Num();
+    DataBytes = 0;
+
+    // Chunks hold whole sample frames, so every header the writer patches in describes a playable file.
+    const int32 FrameBytes = NumChannels * GBytesPerSample;
+    PendingChunk.Reset();
+    PendingChunk.Reserve(ChunkBytes - ChunkBytes % FrameBytes);
+    {
+        FScopeLock Lock(&CriticalSection);
+        Queue.Reset();
+        Stats = FOmniCaptureAudioFileStats();
+        Stats.BytesWritten = HeaderBytes;
+        bInputClosed = false;
+    }
+
+    Thread.Reset(FRunnableThread::Create(this, TEXT("OmniCaptureAudioFileWriter")));
+    if (!Thread.IsValid())
+    {
+        File.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FOmniCaptureAudioFileWriter::Write(const FOmniAudioPacket& Packet)
+{
+    if (!Thread.IsValid())
+    {
+        return false;
+    }
+
+    if (Packet.SampleRate != SampleRate || Packet.NumChannels != NumChannels || Packet.PCM16.Num() % NumChannels != 0)
+    {
+        FScopeLock Lock(&CriticalSection);
+        ++Stats.RejectedPackets;
+        return false;
+    }
+
+    const int32 FrameBytes = NumChannels * GBytesPerSample;
+    const int32 ChunkLimit = ChunkBytes - ChunkBytes % FrameBytes;
+    const uint8* Source = reinterpret_cast<const uint8*>(Packet.PCM16.GetData());
+    int64 Remaining = static_cast<int64>(Packet.PCM16.Num()) * GBytesPerSample;
+    while (Remaining > 0)
+    {
+        const int32 Count = static_cast<int32>(FMath::Min<int64>(Remaining, ChunkLimit - PendingChunk.Num()));
+        PendingChunk.Append(Source, Count);
+        Source += Count;
+        Remaining -= Count;
+
+        if (PendingChunk.Num() >= ChunkLimit)
+        {
+            TArray<uint8> Chunk = MoveTemp(PendingChunk);
+            PendingChunk.Reserve(ChunkLimit);
+            if (!QueueChunk(MoveTemp(Chunk)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool FOmniCaptureAudioFileWriter::Close()
+{
+    if (!Thread.IsValid())
+    {
+        return false;
+    }
+
+    if (PendingChunk.Num() > 0)
+    {
+        QueueChunk(MoveTemp(PendingChunk));
+        PendingChunk.Reset();
+    }
+
+    {
+        FScopeLock Lock(&CriticalSection);
+        bInputClosed = true;
+    }
+    WorkEvent->Trigger();
+    Thread->WaitForCompletion();
+    Thread.Reset();
+
+    return !GetStats().bFailed;
+}
+
+FOmniCaptureAudioFileStats FOmniCaptureAudioFileWriter::GetStats() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return Stats;
+}
+
+const TCHAR* FOmniCaptureAudioFileWriter::GetExtension(EOmniCaptureAudioFileFormat Format)
+{
+    return Format == EOmniCaptureAudioFileFormat::CAF ? TEXT(".caf") : TEXT(".wav");
+}
+
+TArray<uint8> FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat Format, int32 SampleRate, int32 NumChannels, int64 DataBytes)
+{
+    const uint32 FrameBytes = static_cast<uint32>(NumChannels * GBytesPerSample);
+
+    TArray<uint8> Header;
+    if (Format == EOmniCaptureAudioFileFormat::CAF)
+    {
+        Header.Reserve(GCafHeaderBytes);
+        AppendTag(Header, "caff");
+        AppendBE(Header, 1, 2);
+        AppendBE(Header, 0, 2);
+
+        AppendTag(Header, "desc");
+        AppendBE(Header, 32, 8);
+        const double Rate = SampleRate;
+        uint64 RateBits = 0;
+        FMemory::Memcpy(&RateBits, &Rate, sizeof(RateBits));
+        AppendBE(Header, RateBits, 8);
+        AppendTag(Header, "lpcm");
+        // kCAFLinearPCMFormatFlagIsLittleEndian: the samples go to disk as the recorder holds them.
+        AppendBE(Header, 2, 4);
+        AppendBE(Header, FrameBytes, 4);
+        AppendBE(Header, 1, 4);
+        AppendBE(Header, static_cast<uint32>(NumChannels), 4);
+        AppendBE(Header, 16, 4);
+
+        // A size of -1 marks a data chunk that runs to the end of the file.
+        AppendTag(Header, "data");
+        AppendBE(Header, DataBytes < 0 ? MAX_uint64 : static_cast<uint64>(DataBytes + 4), 8);
+        AppendBE(Header, 0, 4);
+        check(Header.Num() == GCafHeaderBytes);
+        return Header;
+    }
+
+    // An unfinished WAV file simply claims no samples until the first chunk lands.
+    const uint64 Data = static_cast<uint64>(FMath::Max<int64>(0, DataBytes));
+    const uint64 RiffBytes = GWavHeaderBytes - 8 + Data;
+    const bool bRF64 = RiffBytes > MAX_uint32;
+
+    Header.Reserve(GWavHeaderBytes);
+    AppendTag(Header, bRF64 ? "RF64" : "RIFF");
+    AppendLE(Header, bRF64 ? MAX_uint32 : RiffBytes, 4);
+    AppendTag(Header, "WAVE");
+
+    // ds64 carries the real sizes once they outgrow 32 bits; until then the same bytes are a JUNK chunk readers skip.
+    AppendTag(Header, bRF64 ? "ds64" : "JUNK");
+    AppendLE(Header, GWavDs64Bytes, 4);
+    AppendLE(Header, bRF64 ? RiffBytes : 0, 8);
+    AppendLE(Header, bRF64 ? Data : 0, 8);
+    AppendLE(Header, bRF64 ? Data / FrameBytes : 0, 8);
+    AppendLE(Header, 0, 4);
+
+    AppendTag(Header, "fmt ");
+    AppendLE(Header, 16, 4);
+    AppendLE(Header, 1, 2);
+    AppendLE(Header, static_cast<uint32>(NumChannels), 2);
+    AppendLE(Header, static_cast<uint32>(SampleRate), 4);
+    AppendLE(Header, static_cast<uint64>(SampleRate) * FrameBytes, 4);
+    AppendLE(Header, FrameBytes, 2);
+    AppendLE(Header, 16, 2);
+
+    AppendTag(Header, "data");
+    AppendLE(Header, bRF64 ? MAX_uint32 : Data, 4);
+    check(Header.Num() == GWavHeaderBytes);
+    return Header;
+}
+
+bool FOmniCaptureAudioFileWriter::RecoverFile(const FString& FilePath)
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const int64 FileSize = PlatformFile.FileSize(*FilePath);
+    if (FileSize < 12)
+    {
+        UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: the file is missing or too short."), *FilePath);
+        return false;
+    }
+
+    TArray<uint8> Head;
+    {
+        TUniquePtr<IFileHandle> File(PlatformFile.OpenRead(*FilePath));
+        Head.SetNumUninitialized(static_cast<int32>(FMath::Min(FileSize, GRecoveryScanBytes)));
+        if (!File.IsValid() || !File->Read(Head.GetData(), Head.Num()))
+        {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: the file could not be read."), *FilePath);
+            return false;
+        }
+    }
+
+    if ((HasTag(Head.GetData(), "RIFF") || HasTag(Head.GetData(), "RF64")) && HasTag(Head.GetData() + 8, "WAVE"))
+    {
+        return RecoverWav(FilePath, Head, FileSize);
+    }
+    if (HasTag(Head.GetData(), "caff"))
+    {
+        return RecoverCaf(FilePath, Head, FileSize);
+    }
+
+    UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Cannot recover %s: it is neither a WAV nor a CAF file."), *FilePath);
+    return false;
+}
+
+uint32 FOmniCaptureAudioFileWriter::Run()
+{
+    for (;;)
+    {
+        TArray<uint8> Chunk;
+        bool bHasChunk = false;
+        bool bDone = false;
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (Queue.Num() > 0)
+            {
+                Chunk = MoveTemp(Queue[0]);
+                Queue.RemoveAt(0, 1, EAllowShrinking::No);
+                bHasChunk = true;
+            }
+            else
+            {
+                bDone = bInputClosed;
+            }
+        }
+
+        if (!bHasChunk)
+        {
+            if (bDone)
+            {
+                break;
+            }
+            WorkEvent->Wait();
+            continue;
+        }
+
+        SpaceEvent->Trigger();
+        WriteChunk(Chunk);
+    }
+
+    // CAF files only learn their size here; WAV files get a final patch in case the last chunk's failed.
+    const bool bClosed = PatchHeader() && File->Flush();
+    File.Reset();
+    if (!bClosed)
+    {
+        UE_LOG(LogOmniCaptureAudio, Error, TEXT("Failed to finish audio file %s"), *Path);
+        FScopeLock Lock(&CriticalSection);
+        Stats.bFailed = true;
+    }
+    return 0;
+}
+
+bool FOmniCaptureAudioFileWriter::QueueChunk(TArray<uint8>&& Chunk)
+{
+    bool bCountedBlock = false;
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (Stats.bFailed)
+            {
+                return false;
+            }
+            if (Queue.Num() < MaxQueuedChunks)
+            {
+                Queue.Add(MoveTemp(Chunk));
+                break;
+            }
+            if (!bCountedBlock)
+            {
+                ++Stats.BlockedWrites;
+                bCountedBlock = true;
+            }
+        }
+        // The writer thread raises this after every chunk it takes, and when the file fails.
+        SpaceEvent->Wait();
+    }
+    WorkEvent->Trigger();
+    return true;
+}
+
+bool FOmniCaptureAudioFileWriter::WriteChunk(const TArray<uint8>& Chunk)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (Stats.bFailed)
+        {
+            return false;
+        }
+    }
+
+    // Keeping the WAV header current costs a seek per chunk and leaves at most one chunk to recover after a crash.
+    bool bWritten = File->Write(Chunk.GetData(), Chunk.Num());
+    if (bWritten)
+    {
+        DataBytes += Chunk.Num();
+        bWritten = Format != EOmniCaptureAudioFileFormat::WAV || PatchHeader();
+    }
+
+    FScopeLock Lock(&CriticalSection);
+    if (!bWritten)
+    {
+        UE_LOG(LogOmniCaptureAudio, Error, TEXT("Failed to write audio file %s; the rest of the take is dropped."), *Path);
+        Stats.bFailed = true;
+        SpaceEvent->Trigger();
+        return false;
+    }
+    Stats.FramesWritten += Chunk.Num() / (NumChannels * GBytesPerSample);
+    Stats.BytesWritten += Chunk.Num();
+    return true;
+}
+
+bool FOmniCaptureAudioFileWriter::PatchHeader()
+{
+    const TArray<uint8> Header = BuildHeader(Format, SampleRate, NumChannels, DataBytes);
+    return File->Seek(0)
+        && File->Write(Header.GetData(), Header.Num())
+        && File->Seek(HeaderBytes + DataBytes);
+}
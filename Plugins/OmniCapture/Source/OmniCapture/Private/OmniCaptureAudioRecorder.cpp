@@ -1,23 +1,24 @@
 #include "OmniCaptureAudioRecorder.h"
 
-#include "AudioMixerBlueprintLibrary.h"
 #include "AudioDevice.h"
 #include "Engine/World.h"
 #include "Misc/Paths.h"
-#include "HAL/FileManager.h"
+#include "OmniCaptureLog.h"
 #include "Sound/SoundWave.h"
 #include "Sound/SoundSubmix.h"
-#include "Misc/ScopeLock.h"
 
 #if WITH_AUDIOMIXER
 #include "AudioMixerDevice.h"
 #endif
 
-DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureAudio, Log, All);
+DEFINE_LOG_CATEGORY(LogOmniCaptureAudio);
 
 namespace
 {
     constexpr int32 GMaxPendingAudioPackets = 256;
+    // The sample ring holds this much audio at the device rate, sized for up to 7.1 submixes.
+    constexpr int32 GAudioRingSeconds = 2;
+    constexpr int32 GAudioRingMaxChannels = 8;
 
 #if WITH_AUDIOMIXER
     class FOmniCaptureSubmixListener final : public Audio::ISubmixBufferListener
@@ -47,6 +48,7 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
 {
     WorldPtr = InWorld;
     Gain = Settings.AudioGain;
+    FileFormat = Settings.AudioFileFormat;
     TargetSubmix = Settings.SubmixToRecord.Get();
     if (!TargetSubmix.IsValid() && Settings.SubmixToRecord.ToSoftObjectPath().IsValid())
     {
@@ -55,13 +57,20 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
             TargetSubmix = LoadedSubmix;
         }
     }
-    PendingPacketCount = 0;
     DroppedPacketCount = 0;
+    UnderrunCount = 0;
+    ClockCorrectionPPM = 0;
+    ClockResyncCount = 0;
     bLoggedOverflowWarning = false;
     AudioClockOrigin = -1.0;
     AudioStartTime = 0.0;
     bPaused.Store(false);
 
+    const FString BaseFileName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
+    const FString Directory = Settings.OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : Settings.OutputDirectory;
+    OutputFilePath = FPaths::ConvertRelativePathToFull(Directory) / (BaseFileName + FOmniCaptureAudioFileWriter::GetExtension(FileFormat));
+    bFileWriterFailed = false;
+
 #if WITH_AUDIOMIXER
     MixerDevice = nullptr;
     if (WorldPtr.IsValid())
@@ -71,11 +80,16 @@ bool FOmniCaptureAudioRecorder::Initialize(UWorld* InWorld, const FOmniCaptureSe
             if (AudioDevice->IsAudioMixerEnabled())
             {
                 MixerDevice = static_cast<Audio::FMixerDevice*>(AudioDevice);
+                CachedSampleRate = FMath::Max(1, FMath::RoundToInt(AudioDevice->GetSampleRate()));
             }
         }
     }
 #endif
 
+    // Everything the audio thread writes into is allocated here, never in the submix callback.
+    SampleRing.Initialize(GMaxPendingAudioPackets, CachedSampleRate.Load() * GAudioRingMaxChannels * GAudioRingSeconds);
+    AudioClock.Reset();
+
     return WorldPtr.IsValid();
 }
 
@@ -87,88 +101,116 @@ void FOmniCaptureAudioRecorder::Start()
     }
 
     DroppedPacketCount = 0;
+    UnderrunCount = 0;
+    ClockCorrectionPPM = 0;
+    ClockResyncCount = 0;
     bLoggedOverflowWarning = false;
+    SampleRing.DiscardAll();
+    AudioClock.Reset();
 
     RegisterListener();
     AudioStartTime = FPlatformTime::Seconds();
-
-    USoundSubmix* Submix = TargetSubmix.IsValid() ? TargetSubmix.Get() : nullptr;
-    UAudioMixerBlueprintLibrary::StartRecordingOutput(WorldPtr.Get(), 0.0f, Submix);
     bIsRecording = true;
     bPaused.Store(false);
 }
 
-void FOmniCaptureAudioRecorder::Stop(const FString& OutputDirectory, const FString& BaseFileName)
+void FOmniCaptureAudioRecorder::Stop()
 {
-    if (!WorldPtr.IsValid() || !bIsRecording)
+    if (!bIsRecording)
     {
         return;
     }
 
-    const FString SanitizedName = BaseFileName.IsEmpty() ? TEXT("OmniCapture") : BaseFileName;
-    FString Directory = OutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : OutputDirectory;
-    Directory = FPaths::ConvertRelativePathToFull(Directory);
-    IFileManager::Get().MakeDirectory(*Directory, true);
-
-    USoundSubmix* Submix = TargetSubmix.IsValid() ? TargetSubmix.Get() : nullptr;
-    UAudioMixerBlueprintLibrary::StopRecordingOutput(WorldPtr.Get(), EAudioRecordingExportType::WavFile, SanitizedName, Directory, Submix);
-    OutputFilePath = Directory / (SanitizedName + TEXT(".wav"));
-
     UnregisterListener();
 
     bIsRecording = false;
 
+    if (FileWriter.IsOpen())
     {
-        FScopeLock Lock(&PacketCS);
-        FOmniAudioPacket Packet;
-        while (PendingPackets.Dequeue(Packet))
+        if (!FileWriter.Close())
         {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("Audio file %s is incomplete; FOmniCaptureAudioFileWriter::RecoverFile can repair what reached the disk."), *OutputFilePath);
+        }
+        const FOmniCaptureAudioFileStats FileStats = FileWriter.GetStats();
+        if (FileStats.RejectedPackets > 0)
+        {
+            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("%d audio packets changed format mid-take and were left out of %s."), FileStats.RejectedPackets, *OutputFilePath);
         }
-        PendingPacketCount = 0;
     }
+    else
+    {
+        OutputFilePath.Reset();
+    }
+
+    SampleRing.DiscardAll();
+    AudioClock.Reset();
 
     AudioClockOrigin = -1.0;
     AudioStartTime = 0.0;
     DroppedPacketCount = 0;
+    UnderrunCount = 0;
     bLoggedOverflowWarning = false;
     bPaused.Store(false);
 }
 
 void FOmniCaptureAudioRecorder::GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets)
 {
-    FScopeLock Lock(&PacketCS);
+    if (DroppedPacketCount.Load() > 0 && !bLoggedOverflowWarning.Exchange(true))
+    {
+        UE_LOG(LogOmniCaptureAudio, Warning, TEXT("OmniCapture audio ring overflowed. Dropping new audio blocks until the game thread catches up."));
+    }
+
+    FOmniAudioPacket Block;
+    while (SampleRing.Read(Block))
+    {
+        AudioClock.AddInput(Block);
+    }
 
-    const double Threshold = FrameTimestamp + (1.0 / 120.0);
-    for (;;)
+    // A frame with no new block is normal when device blocks are longer than frames; only a frame the buffered
+    // audio could not cover is an underrun.
+    const int32 PreviousUnderruns = AudioClock.GetStats().Underruns;
+    FOmniAudioPacket Packet;
+    const bool bProduced = AudioClock.Produce(FrameTimestamp, Packet);
+    if (AudioClock.GetStats().Underruns > PreviousUnderruns && bIsRecording && !bPaused.Load())
     {
-        FOmniAudioPacket Packet;
-        if (!PendingPackets.Peek(Packet))
+        UnderrunCount.IncrementExchange();
+    }
+
+    if (bProduced)
+    {
+        if (bIsRecording && !bFileWriterFailed && !FileWriter.IsOpen())
         {
-            break;
+            bFileWriterFailed = !FileWriter.Open(OutputFilePath, FileFormat, Packet.SampleRate, Packet.NumChannels);
+            if (bFileWriterFailed)
+            {
+                UE_LOG(LogOmniCaptureAudio, Error, TEXT("Failed to open audio file %s; this segment is recorded without an audio file."), *OutputFilePath);
+            }
         }
-
-        if (Packet.Timestamp > Threshold)
+        if (FileWriter.IsOpen())
         {
-            break;
+            FileWriter.Write(Packet);
         }
-
-        PendingPackets.Dequeue(Packet);
-        PendingPacketCount.DecrementExchange();
         OutPackets.Add(MoveTemp(Packet));
     }
+
+    const FOmniCaptureAudioClockStats ClockStats = AudioClock.GetStats();
+    ClockCorrectionPPM = FMath::RoundToInt(ClockStats.CorrectionPPM);
+    ClockResyncCount = ClockStats.Resyncs;
 }
 
 FString FOmniCaptureAudioRecorder::GetDebugStatus() const
 {
-    const int32 Pending = PendingPacketCount.Load();
+    const int32 Pending = SampleRing.GetPendingBlockCount();
     const int32 Dropped = DroppedPacketCount.Load();
+    const int32 Underruns = UnderrunCount.Load();
     const FString SubmixName = TargetSubmix.IsValid() ? TargetSubmix->GetName() : TEXT("Master");
-    return FString::Printf(TEXT("AudioPackets:%d Dropped:%d SR:%d Submix:%s"), Pending, Dropped, CachedSampleRate, *SubmixName);
+    const FOmniCaptureAudioFileStats FileStats = FileWriter.GetStats();
+    return FString::Printf(TEXT("AudioPackets:%d Dropped:%d Underruns:%d SR:%d Submix:%s File:%lldKB Blocked:%d"), Pending, Dropped, Underruns, CachedSampleRate.Load(), *SubmixName, FileStats.BytesWritten / 1024, FileStats.BlockedWrites);
 }
 
 int32 FOmniCaptureAudioRecorder::GetPendingPacketCount() const
 {
-    return PendingPacketCount.Load();
+    return SampleRing.GetPendingBlockCount();
 }
 
 void FOmniCaptureAudioRecorder::SetPaused(bool bInPaused)
@@ -223,6 +265,7 @@ void FOmniCaptureAudioRecorder::HandleSubmixBuffer(const float* AudioData, int32
     }
 
 #if WITH_AUDIOMIXER
+    // Runs on the audio render thread: no locks, no allocation, no logging. Overflow is reported from GatherAudio.
     CachedSampleRate = SampleRate;
 
     if (AudioClockOrigin < 0.0)
@@ -231,43 +274,9 @@ void FOmniCaptureAudioRecorder::HandleSubmixBuffer(const float* AudioData, int32
     }
 
     const double RelativeTimestamp = FMath::Max(0.0, AudioClock - AudioClockOrigin);
-    FOmniAudioPacket Packet;
-    Packet.Timestamp = RelativeTimestamp;
-    Packet.SampleRate = SampleRate;
-    Packet.NumChannels = NumChannels;
-    Packet.PCM16.SetNumUninitialized(NumSamples);
-
-    for (int32 Index = 0; Index < NumSamples; ++Index)
-    {
-        const float SampleValue = AudioData[Index] * Gain;
-        const int32 IntValue = FMath::RoundToInt(SampleValue * 32767.0f);
-        Packet.PCM16[Index] = static_cast<int16>(FMath::Clamp(IntValue, -32768, 32767));
-    }
-
+    if (!SampleRing.Write(AudioData, NumSamples, NumChannels, SampleRate, RelativeTimestamp, Gain))
     {
-        FScopeLock Lock(&PacketCS);
-        bool bDropped = false;
-        while (PendingPacketCount.Load() >= GMaxPendingAudioPackets)
-        {
-            FOmniAudioPacket DiscardedPacket;
-            if (!PendingPackets.Dequeue(DiscardedPacket))
-            {
-                PendingPacketCount = 0;
-                break;
-            }
-
-            PendingPacketCount.DecrementExchange();
-            DroppedPacketCount.IncrementExchange();
-            bDropped = true;
-        }
-
-        PendingPackets.Enqueue(MoveTemp(Packet));
-        PendingPacketCount.IncrementExchange();
-
-        if (bDropped && !bLoggedOverflowWarning.Exchange(true))
-        {
-            UE_LOG(LogOmniCaptureAudio, Warning, TEXT("OmniCapture audio queue overflowed. Dropping oldest packets to keep audio in sync."));
-        }
+        DroppedPacketCount.IncrementExchange();
     }
 #else
     (void)AudioData;
@@ -0,0 +1,157 @@
+#include "OmniCaptureAudioRing.h"
+
+namespace
+{
+    constexpr float GPCM16Scale = 32767.0f;
+
+    FORCEINLINE int16 ConvertSampleToPCM16(float Sample, float ScaledGain)
+    {
+        const float Scaled = FMath::Clamp(Sample * ScaledGain, -GPCM16Scale, GPCM16Scale);
+        // Ties go to even, as they do in the vector path, so a sample converts the same wherever it falls in a block.
+        return static_cast<int16>(FMath::RoundHalfToEven(Scaled));
+    }
+}
+
+void FOmniCaptureAudioRing::Initialize(int32 InMaxBlocks, int32 InMaxSamples)
+{
+    BlockCapacity = static_cast<uint64>(FMath::Max(1, InMaxBlocks));
+    SampleCapacity = static_cast<uint64>(FMath::Max(1, InMaxSamples));
+    Blocks.SetNum(static_cast<int32>(BlockCapacity));
+    Samples.SetNumZeroed(static_cast<int32>(SampleCapacity));
+
+    SampleWritePosition = 0;
+    BlockWritePosition.store(0, std::memory_order_relaxed);
+    BlockReadPosition.store(0, std::memory_order_relaxed);
+    SampleReadPosition.store(0, std::memory_order_relaxed);
+}
+
+bool FOmniCaptureAudioRing::Write(const float* InSamples, int32 NumSamples, int32 NumChannels, int32 SampleRate, double Timestamp, float Gain)
+{
+    if (!InSamples || NumSamples <= 0 || SampleCapacity == 0)
+    {
+        return false;
+    }
+
+    const uint64 BlockWrite = BlockWritePosition.load(std::memory_order_relaxed);
+    if (BlockWrite - BlockReadPosition.load(std::memory_order_acquire) >= BlockCapacity)
+    {
+        return false;
+    }
+
+    const uint64 Count = static_cast<uint64>(NumSamples);
+    const uint64 UsedSamples = SampleWritePosition - SampleReadPosition.load(std::memory_order_acquire);
+    if (UsedSamples + Count > SampleCapacity)
+    {
+        return false;
+    }
+
+    // A block that crosses the end of the ring is converted in two runs.
+    const uint64 Start = SampleWritePosition % SampleCapacity;
+    const uint64 FirstRun = FMath::Min(Count, SampleCapacity - Start);
+    ConvertToPCM16(InSamples, Samples.GetData() + Start, static_cast<int32>(FirstRun), Gain);
+    if (FirstRun < Count)
+    {
+        ConvertToPCM16(InSamples + FirstRun, Samples.GetData(), static_cast<int32>(Count - FirstRun), Gain);
+    }
+
+    FBlock& Block = Blocks[static_cast<int32>(BlockWrite % BlockCapacity)];
+    Block.Timestamp = Timestamp;
+    Block.SampleStart = SampleWritePosition;
+    Block.NumSamples = NumSamples;
+    Block.SampleRate = SampleRate;
+    Block.NumChannels = NumChannels;
+
+    SampleWritePosition += Count;
+    BlockWritePosition.store(BlockWrite + 1, std::memory_order_release);
+    return true;
+}
+
+bool FOmniCaptureAudioRing::PeekTimestamp(double& OutTimestamp) const
+{
+    const uint64 BlockRead = BlockReadPosition.load(std::memory_order_relaxed);
+    if (BlockRead == BlockWritePosition.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    OutTimestamp = Blocks[static_cast<int32>(BlockRead % BlockCapacity)].Timestamp;
+    return true;
+}
+
+bool FOmniCaptureAudioRing::Read(FOmniAudioPacket& OutPacket)
+{
+    const uint64 BlockRead = BlockReadPosition.load(std::memory_order_relaxed);
+    if (BlockRead == BlockWritePosition.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+
+    const FBlock& Block = Blocks[static_cast<int32>(BlockRead % BlockCapacity)];
+    OutPacket.Timestamp = Block.Timestamp;
+    OutPacket.SampleRate = Block.SampleRate;
+    OutPacket.NumChannels = Block.NumChannels;
+    OutPacket.PCM16.SetNumUninitialized(Block.NumSamples);
+
+    const uint64 Count = static_cast<uint64>(Block.NumSamples);
+    const uint64 Start = Block.SampleStart % SampleCapacity;
+    const uint64 FirstRun = FMath::Min(Count, SampleCapacity - Start);
+    FMemory::Memcpy(OutPacket.PCM16.GetData(), Samples.GetData() + Start, FirstRun * sizeof(int16));
+    if (FirstRun < Count)
+    {
+        FMemory::Memcpy(OutPacket.PCM16.GetData() + FirstRun, Samples.GetData(), (Count - FirstRun) * sizeof(int16));
+    }
+
+    SampleReadPosition.store(Block.SampleStart + Count, std::memory_order_release);
+    BlockReadPosition.store(BlockRead + 1, std::memory_order_release);
+    return true;
+}
+
+void FOmniCaptureAudioRing::DiscardAll()
+{
+    const uint64 BlockRead = BlockReadPosition.load(std::memory_order_relaxed);
+    const uint64 BlockWrite = BlockWritePosition.load(std::memory_order_acquire);
+    if (BlockRead == BlockWrite)
+    {
+        return;
+    }
+
+    const FBlock& Last = Blocks[static_cast<int32>((BlockWrite - 1) % BlockCapacity)];
+    SampleReadPosition.store(Last.SampleStart + static_cast<uint64>(Last.NumSamples), std::memory_order_release);
+    BlockReadPosition.store(BlockWrite, std::memory_order_release);
+}
+
+int32 FOmniCaptureAudioRing::GetPendingBlockCount() const
+{
+    const uint64 BlockWrite = BlockWritePosition.load(std::memory_order_acquire);
+    const uint64 BlockRead = BlockReadPosition.load(std::memory_order_acquire);
+    return BlockWrite > BlockRead ? static_cast<int32>(BlockWrite - BlockRead) : 0;
+}
+
+void FOmniCaptureAudioRing::ConvertToPCM16(const float* Source, int16* Destination, int32 Count, float Gain)
+{
+    const float ScaledGain = Gain * GPCM16Scale;
+    int32 Index = 0;
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+    const VectorRegister4Float GainVector = VectorSetFloat1(ScaledGain);
+    const VectorRegister4Float MinVector = VectorSetFloat1(-GPCM16Scale);
+    const VectorRegister4Float MaxVector = VectorSetFloat1(GPCM16Scale);
+    for (; Index + 8 <= Count; Index += 8)
+    {
+        const VectorRegister4Float Low = VectorMin(VectorMax(VectorMultiply(VectorLoad(Source + Index), GainVector), MinVector), MaxVector);
+        const VectorRegister4Float High = VectorMin(VectorMax(VectorMultiply(VectorLoad(Source + Index + 4), GainVector), MinVector), MaxVector);
+        const VectorRegister4Int LowInt = VectorRoundToIntHalfToEven(Low);
+        const VectorRegister4Int HighInt = VectorRoundToIntHalfToEven(High);
+#if PLATFORM_ENABLE_VECTORINTRINSICS_NEON
+        vst1q_s16(Destination + Index, vcombine_s16(vqmovn_s32(LowInt), vqmovn_s32(HighInt)));
+#else
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Destination + Index), _mm_packs_epi32(LowInt, HighInt));
+#endif
+    }
+#endif
+
+    for (; Index < Count; ++Index)
+    {
+        Destination[Index] = ConvertSampleToPCM16(Source[Index], ScaledGain);
+    }
+}
@@ -0,0 +1,364 @@
+#include "OmniCaptureContainer.h"
+
+#include "Algo/StableSort.h"
+#include "Async/MappedFileHandle.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureContainer, Log, All);
+
+FOmniCaptureContainerWriter::FOmniCaptureContainerWriter(const FString& InFilePath)
+    : FilePath(InFilePath)
+{
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+    Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*FilePath, false, false));
+    if (!Handle.IsValid())
+    {
+        UE_LOG(LogOmniCaptureContainer, Error, TEXT("Failed to create capture container %s"), *FilePath);
+        return;
+    }
+
+    const FOmniCaptureContainerHeader Header;
+    if (!Handle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header)))
+    {
+        bFailed = true;
+        return;
+    }
+    WriteOffset = sizeof(Header);
+}
+
+FOmniCaptureContainerWriter::~FOmniCaptureContainerWriter()
+{
+    Close();
+}
+
+FString FOmniCaptureContainerWriter::GetContainerPath(const FString& Directory, const FString& BaseName)
+{
+    return Directory / (BaseName + TEXT(".omnicap"));
+}
+
+bool FOmniCaptureContainerWriter::IsOpen() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return Handle.IsValid() && !bFailed;
+}
+
+bool FOmniCaptureContainerWriter::Append(const FString& Name, const FOmniCaptureFrameMetadata& Metadata, bool bPrimary, const uint8* Data, int64 Size)
+{
+    if (!Data || Size <= 0)
+    {
+        return false;
+    }
+
+    const FTCHARToUTF8 NameUtf8(*Name);
+    if (NameUtf8.Length() > MAX_uint16)
+    {
+        return false;
+    }
+
+    FOmniCaptureContainerChunkHeader Chunk;
+    Chunk.NameLength = static_cast<uint32>(NameUtf8.Length());
+    Chunk.PayloadSize = static_cast<uint64>(Size);
+    Chunk.FrameIndex = Metadata.FrameIndex;
+    Chunk.Timecode = Metadata.Timecode;
+    Chunk.bPrimary = bPrimary ? 1 : 0;
+    Chunk.bKeyFrame = Metadata.bKeyFrame ? 1 : 0;
+
+    FScopeLock Lock(&CriticalSection);
+    if (!Handle.IsValid() || bFailed)
+    {
+        return false;
+    }
+
+    if (!Handle->Write(reinterpret_cast<const uint8*>(&Chunk), sizeof(Chunk))
+        || !Handle->Write(reinterpret_cast<const uint8*>(NameUtf8.Get()), NameUtf8.Length())
+        || !Handle->Write(Data, Size))
+    {
+        // The chunk may be half written; nothing more can be appended behind it.
+        UE_LOG(LogOmniCaptureContainer, Error, TEXT("Failed to append %s to capture container %s"), *Name, *FilePath);
+        bFailed = true;
+        return false;
+    }
+
+    FOmniCaptureContainerEntry& Entry = Entries.AddDefaulted_GetRef();
+    Entry.Name = Name;
+    Entry.FrameIndex = Metadata.FrameIndex;
+    Entry.Timecode = Metadata.Timecode;
+    Entry.PayloadOffset = WriteOffset + sizeof(Chunk) + NameUtf8.Length();
+    Entry.PayloadSize = Size;
+    Entry.bPrimary = bPrimary;
+    Entry.bKeyFrame = Metadata.bKeyFrame;
+    WriteOffset = Entry.PayloadOffset + Size;
+    IndexBytes += sizeof(FOmniCaptureContainerIndexRecord) + NameUtf8.Length();
+    PrimaryEntryCount += bPrimary ? 1 : 0;
+    return true;
+}
+
+bool FOmniCaptureContainerWriter::Close()
+{
+    FScopeLock Lock(&CriticalSection);
+    if (!Handle.IsValid())
+    {
+        return !bFailed;
+    }
+
+    TArray<FOmniCaptureContainerIndexRecord> Records;
+    TArray<uint8> Names;
+    Records.Reserve(Entries.Num());
+    for (const FOmniCaptureContainerEntry& Entry : Entries)
+    {
+        const FTCHARToUTF8 NameUtf8(*Entry.Name);
+        FOmniCaptureContainerIndexRecord& Record = Records.AddDefaulted_GetRef();
+        Record.FrameIndex = Entry.FrameIndex;
+        Record.Timecode = Entry.Timecode;
+        Record.PayloadOffset = static_cast<uint64>(Entry.PayloadOffset);
+        Record.PayloadSize = static_cast<uint64>(Entry.PayloadSize);
+        Record.NameOffset = static_cast<uint32>(Names.Num());
+        Record.NameLength = static_cast<uint16>(NameUtf8.Length());
+        Record.bPrimary = Entry.bPrimary ? 1 : 0;
+        Record.bKeyFrame = Entry.bKeyFrame ? 1 : 0;
+        Names.Append(reinterpret_cast<const uint8*>(NameUtf8.Get()), NameUtf8.Length());
+    }
+
+    // A container that failed mid-chunk keeps a zero index offset, so readers recover what is intact instead.
+    bool bWritten = !bFailed;
+    if (bWritten)
+    {
+        FOmniCaptureContainerHeader Header;
+        Header.IndexOffset = static_cast<uint64>(WriteOffset);
+        Header.IndexSize = static_cast<uint64>(Records.Num()) * sizeof(FOmniCaptureContainerIndexRecord) + Names.Num();
+        Header.EntryCount = static_cast<uint32>(Records.Num());
+
+        bWritten = Handle->Write(reinterpret_cast<const uint8*>(Records.GetData()), static_cast<int64>(Records.Num()) * sizeof(FOmniCaptureContainerIndexRecord))
+            && Handle->Write(Names.GetData(), Names.Num())
+            && Handle->Flush()
+            && Handle->Seek(0)
+            && Handle->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+        if (!bWritten)
+        {
+            UE_LOG(LogOmniCaptureContainer, Error, TEXT("Failed to write the index of capture container %s"), *FilePath);
+        }
+    }
+
+    Handle.Reset();
+    bFailed |= !bWritten;
+    return bWritten;
+}
+
+int64 FOmniCaptureContainerWriter::GetBytesWritten() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return WriteOffset + IndexBytes;
+}
+
+int32 FOmniCaptureContainerWriter::GetEntryCount() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return Entries.Num();
+}
+
+int32 FOmniCaptureContainerWriter::GetFrameCount() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return PrimaryEntryCount;
+}
+
+FOmniCaptureContainerReader::FOmniCaptureContainerReader() = default;
+
+FOmniCaptureContainerReader::~FOmniCaptureContainerReader()
+{
+    Close();
+}
+
+bool FOmniCaptureContainerReader::Open(const FString& InFilePath)
+{
+    Close();
+    FilePath = InFilePath;
+
+    MappedHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+    if (MappedHandle.IsValid() && MappedHandle->GetFileSize() > 0)
+    {
+        MappedRegion.Reset(MappedHandle->MapRegion(0, MappedHandle->GetFileSize()));
+    }
+    if (MappedRegion.IsValid())
+    {
+        Data = MappedRegion->GetMappedPtr();
+        DataSize = MappedRegion->GetMappedSize();
+    }
+    else if (FFileHelper::LoadFileToArray(LoadedData, *FilePath))
+    {
+        Data = LoadedData.GetData();
+        DataSize = LoadedData.Num();
+    }
+
+    FOmniCaptureContainerHeader Header;
+    Header.Magic = 0;
+    if (Data && DataSize >= static_cast<int64>(sizeof(Header)))
+    {
+        FMemory::Memcpy(&Header, Data, sizeof(Header));
+    }
+    if (Header.Magic != FOmniCaptureContainerHeader::ExpectedMagic || Header.Version > FOmniCaptureContainerHeader::CurrentVersion)
+    {
+        UE_LOG(LogOmniCaptureContainer, Warning, TEXT("%s is not a capture container this version can read"), *FilePath);
+        Close();
+        return false;
+    }
+
+    if (Header.IndexOffset == 0 || !ReadIndex(Header))
+    {
+        RecoverIndex();
+    }
+
+    EntriesByName.Reserve(Entries.Num());
+    for (int32 Index = 0; Index < Entries.Num(); ++Index)
+    {
+        EntriesByName.Add(Entries[Index].Name, Index);
+    }
+    return true;
+}
+
+void FOmniCaptureContainerReader::Close()
+{
+    MappedRegion.Reset();
+    MappedHandle.Reset();
+    LoadedData.Empty();
+    Data = nullptr;
+    DataSize = 0;
+    Entries.Reset();
+    EntriesByName.Reset();
+    bRecovered = false;
+}
+
+bool FOmniCaptureContainerReader::ReadIndex(const FOmniCaptureContainerHeader& Header)
+{
+    // Offsets and sizes come from the file; each is checked against the room left before it is added to anything, so
+    // a damaged value can neither wrap around nor turn negative.
+    const int64 RecordBytes = static_cast<int64>(Header.EntryCount) * sizeof(FOmniCaptureContainerIndexRecord);
+    if (Header.IndexOffset < sizeof(Header) || Header.IndexOffset > static_cast<uint64>(DataSize) || Header.IndexSize > static_cast<uint64>(DataSize) - Header.IndexOffset || Header.IndexSize < static_cast<uint64>(RecordBytes))
+    {
+        return false;
+    }
+    const int64 IndexOffset = static_cast<int64>(Header.IndexOffset);
+
+    const uint8* NameTable = Data + IndexOffset + RecordBytes;
+    const int64 NameTableSize = static_cast<int64>(Header.IndexSize) - RecordBytes;
+    Entries.Reserve(Header.EntryCount);
+    for (uint32 Index = 0; Index < Header.EntryCount; ++Index)
+    {
+        FOmniCaptureContainerIndexRecord Record;
+        FMemory::Memcpy(&Record, Data + IndexOffset + Index * sizeof(Record), sizeof(Record));
+        if (static_cast<int64>(Record.NameOffset) + Record.NameLength > NameTableSize
+            || Record.PayloadOffset > static_cast<uint64>(IndexOffset)
+            || Record.PayloadSize > static_cast<uint64>(IndexOffset) - Record.PayloadOffset)
+        {
+            Entries.Reset();
+            return false;
+        }
+
+        FOmniCaptureContainerEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.Name = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(NameTable + Record.NameOffset), Record.NameLength));
+        Entry.FrameIndex = Record.FrameIndex;
+        Entry.Timecode = Record.Timecode;
+        Entry.PayloadOffset = static_cast<int64>(Record.PayloadOffset);
+        Entry.PayloadSize = static_cast<int64>(Record.PayloadSize);
+        Entry.bPrimary = Record.bPrimary != 0;
+        Entry.bKeyFrame = Record.bKeyFrame != 0;
+    }
+    return true;
+}
+
+void FOmniCaptureContainerReader::RecoverIndex()
+{
+    // Walk the chunks written before the capture stopped; a chunk cut short at the end is dropped.
+    Entries.Reset();
+    int64 Offset = sizeof(FOmniCaptureContainerHeader);
+    while (Offset + static_cast<int64>(sizeof(FOmniCaptureContainerChunkHeader)) <= DataSize)
+    {
+        FOmniCaptureContainerChunkHeader Chunk;
+        FMemory::Memcpy(&Chunk, Data + Offset, sizeof(Chunk));
+        const int64 NameOffset = Offset + sizeof(Chunk);
+        if (Chunk.Magic != FOmniCaptureContainerChunkHeader::ExpectedMagic || Chunk.NameLength > static_cast<uint64>(DataSize - NameOffset))
+        {
+            break;
+        }
+
+        // Checked before the cast, as a size past 2^63 would come out negative and walk the offset backwards.
+        const int64 PayloadOffset = NameOffset + Chunk.NameLength;
+        if (Chunk.PayloadSize > static_cast<uint64>(DataSize - PayloadOffset))
+        {
+            break;
+        }
+
+        FOmniCaptureContainerEntry& Entry = Entries.AddDefaulted_GetRef();
+        Entry.Name = FString(FUTF8ToTCHAR(reinterpret_cast<const ANSICHAR*>(Data + NameOffset), Chunk.NameLength));
+        Entry.FrameIndex = Chunk.FrameIndex;
+        Entry.Timecode = Chunk.Timecode;
+        Entry.PayloadOffset = PayloadOffset;
+        Entry.PayloadSize = static_cast<int64>(Chunk.PayloadSize);
+        Entry.bPrimary = Chunk.bPrimary != 0;
+        Entry.bKeyFrame = Chunk.bKeyFrame != 0;
+        Offset = PayloadOffset + Entry.PayloadSize;
+    }
+
+    bRecovered = true;
+    UE_LOG(LogOmniCaptureContainer, Warning, TEXT("Capture container %s was not closed; recovered %d image(s) from its chunks"), *FilePath, Entries.Num());
+}
+
+TArray<const FOmniCaptureContainerEntry*> FOmniCaptureContainerReader::GetPrimaryEntries() const
+{
+    TArray<const FOmniCaptureContainerEntry*> Primary;
+    for (const FOmniCaptureContainerEntry& Entry : Entries)
+    {
+        if (Entry.bPrimary)
+        {
+            Primary.Add(&Entry);
+        }
+    }
+
+    // Writer threads finish frames out of order.
+    Algo::StableSortBy(Primary, [](const FOmniCaptureContainerEntry* Entry) { return Entry->FrameIndex; });
+    return Primary;
+}
+
+const FOmniCaptureContainerEntry* FOmniCaptureContainerReader::FindEntry(const FString& Name) const
+{
+    const int32* Index = EntriesByName.Find(Name);
+    return Index ? &Entries[*Index] : nullptr;
+}
+
+const uint8* FOmniCaptureContainerReader::GetPayload(const FOmniCaptureContainerEntry& Entry) const
+{
+    return Data ? Data + Entry.PayloadOffset : nullptr;
+}
+
+int32 FOmniCaptureContainerReader::ExtractAll(const FString& Directory) const
+{
+    IFileManager::Get().MakeDirectory(*Directory, true);
+
+    int32 Extracted = 0;
+    for (const FOmniCaptureContainerEntry& Entry : Entries)
+    {
+        // Names are plain file names; anything with a path in it did not come from the image writer.
+        if (Entry.Name.IsEmpty() || FPaths::GetCleanFilename(Entry.Name) != Entry.Name)
+        {
+            continue;
+        }
+
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*(Directory / Entry.Name)));
+        if (!Writer.IsValid())
+        {
+            continue;
+        }
+
+        Writer->Serialize(const_cast<uint8*>(GetPayload(Entry)), Entry.PayloadSize);
+        if (Writer->Close())
+        {
+            ++Extracted;
+        }
+    }
+    return Extracted;
+}
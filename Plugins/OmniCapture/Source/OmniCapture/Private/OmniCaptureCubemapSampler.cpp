@@ -0,0 +1,565 @@
+#include "OmniCaptureCubemapSampler.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformMisc.h"
+
+#include <type_traits>
+
+namespace
+{
+    // Samples ahead of the current pixel whose texel is prefetched. Projection rows walk faces diagonally, so the
+    // hardware prefetcher rarely predicts the next cache line on its own.
+    constexpr int32 GGatherPrefetchDistance = 8;
+
+    constexpr int32 GFixedHalfTexel = 1 << (FOmniCaptureProjectionSample::FractionBits - 1);
+    constexpr float GFixedToFloat = 1.0f / (1 << FOmniCaptureProjectionSample::FractionBits);
+
+    // Filtered samples are stored relative to the face's outer edge. Shifting by half a texel puts texel centres on
+    // integers; the footprint is the texel above-left of the sample and the blend weights towards the next one.
+    struct FFilterFootprint
+    {
+        int32 X0 = 0;
+        int32 Y0 = 0;
+        float FracX = 0.0f;
+        float FracY = 0.0f;
+    };
+
+    FORCEINLINE FFilterFootprint GetFootprint(const FOmniCaptureProjectionSample& Sample)
+    {
+        // Bias by the seam apron so the shift below never sees a negative value.
+        constexpr int32 Bias = FOmniCaptureCubeSeamTable::Apron << FOmniCaptureProjectionSample::FractionBits;
+        const int32 BiasedX = static_cast<int32>(Sample.GetFixedX()) + Bias - GFixedHalfTexel;
+        const int32 BiasedY = static_cast<int32>(Sample.GetFixedY()) + Bias - GFixedHalfTexel;
+
+        FFilterFootprint Footprint;
+        Footprint.X0 = (BiasedX >> FOmniCaptureProjectionSample::FractionBits) - FOmniCaptureCubeSeamTable::Apron;
+        Footprint.Y0 = (BiasedY >> FOmniCaptureProjectionSample::FractionBits) - FOmniCaptureCubeSeamTable::Apron;
+        Footprint.FracX = static_cast<float>(BiasedX & FOmniCaptureProjectionSample::FractionMask) * GFixedToFloat;
+        Footprint.FracY = static_cast<float>(BiasedY & FOmniCaptureProjectionSample::FractionMask) * GFixedToFloat;
+        return Footprint;
+    }
+
+    FORCEINLINE void GetCatmullRomWeights(float T, float OutWeights[4])
+    {
+        const float T2 = T * T;
+        const float T3 = T2 * T;
+        OutWeights[0] = -0.5f * T3 + T2 - 0.5f * T;
+        OutWeights[1] = 1.5f * T3 - 2.5f * T2 + 1.0f;
+        OutWeights[2] = -1.5f * T3 + 2.0f * T2 + 0.5f * T;
+        OutWeights[3] = 0.5f * T3 - 0.5f * T2;
+    }
+
+    template <typename TexelType>
+    FORCEINLINE const TexelType* ResolveNearestTexel(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample& Sample)
+    {
+        return Cubemap.GetFace<TexelType>(Sample.GetFace()) + static_cast<int64>(Sample.GetTexelY()) * Cubemap.Resolution + Sample.GetTexelX();
+    }
+
+    // Texels up to the seam apron outside the face are read from the neighbouring face.
+    template <typename TexelType>
+    FORCEINLINE const TexelType* ResolveTexel(const FOmniCaptureCubemapView& Cubemap, uint32 Face, int32 X, int32 Y)
+    {
+        const int32 Resolution = Cubemap.Resolution;
+        if (static_cast<uint32>(X) < static_cast<uint32>(Resolution) && static_cast<uint32>(Y) < static_cast<uint32>(Resolution))
+        {
+            return Cubemap.GetFace<TexelType>(Face) + static_cast<int64>(Y) * Resolution + X;
+        }
+
+        const FOmniCaptureCubeTexel& Texel = Cubemap.SeamTable->Resolve(Face, X, Y);
+        return Cubemap.GetFace<TexelType>(Texel.Face) + Texel.Offset;
+    }
+
+    FORCEINLINE FLinearColor ToLinearScalar(const FLinearColor& Texel) { return Texel; }
+    FORCEINLINE FLinearColor ToLinearScalar(const FFloat16Color& Texel) { return FLinearColor(Texel); }
+    FORCEINLINE FLinearColor ToLinearScalar(const float& Texel) { return FLinearColor(Texel, Texel, Texel, Texel); }
+
+    template <EOmniCaptureCPUFilter Filter, typename TexelType>
+    FLinearColor SampleScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample& Sample)
+    {
+        if (!Sample.IsValid())
+        {
+            return FLinearColor::Transparent;
+        }
+
+        if constexpr (Filter == EOmniCaptureCPUFilter::Nearest)
+        {
+            return ToLinearScalar(*ResolveNearestTexel<TexelType>(Cubemap, Sample));
+        }
+        else if constexpr (Filter == EOmniCaptureCPUFilter::Bilinear)
+        {
+            const uint32 Face = Sample.GetFace();
+            const FFilterFootprint Footprint = GetFootprint(Sample);
+            const FLinearColor Texel00 = ToLinearScalar(*ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0, Footprint.Y0));
+            const FLinearColor Texel10 = ToLinearScalar(*ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0 + 1, Footprint.Y0));
+            const FLinearColor Texel01 = ToLinearScalar(*ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0, Footprint.Y0 + 1));
+            const FLinearColor Texel11 = ToLinearScalar(*ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0 + 1, Footprint.Y0 + 1));
+
+            const FLinearColor Top = Texel00 + (Texel10 - Texel00) * Footprint.FracX;
+            const FLinearColor Bottom = Texel01 + (Texel11 - Texel01) * Footprint.FracX;
+            return Top + (Bottom - Top) * Footprint.FracY;
+        }
+        else
+        {
+            const uint32 Face = Sample.GetFace();
+            const FFilterFootprint Footprint = GetFootprint(Sample);
+            float WeightsX[4];
+            float WeightsY[4];
+            GetCatmullRomWeights(Footprint.FracX, WeightsX);
+            GetCatmullRomWeights(Footprint.FracY, WeightsY);
+
+            FLinearColor Result(0.0f, 0.0f, 0.0f, 0.0f);
+            for (int32 Row = 0; Row < 4; ++Row)
+            {
+                FLinearColor RowColor(0.0f, 0.0f, 0.0f, 0.0f);
+                for (int32 Column = 0; Column < 4; ++Column)
+                {
+                    RowColor += ToLinearScalar(*ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0 - 1 + Column, Footprint.Y0 - 1 + Row)) * WeightsX[Column];
+                }
+                Result += RowColor * WeightsY[Row];
+            }
+            return Result;
+        }
+    }
+
+    FORCEINLINE void ConvertScalar(const FLinearColor& Color, FLinearColor& OutPixel) { OutPixel = Color; }
+    FORCEINLINE void ConvertScalar(const FLinearColor& Color, FFloat16Color& OutPixel) { OutPixel = FFloat16Color(Color); }
+    FORCEINLINE void ConvertScalar(const FLinearColor& Color, FColor& OutPixel) { OutPixel = Color.ToFColor(true); }
+    FORCEINLINE void ConvertScalar(const FLinearColor& Color, float& OutPixel) { OutPixel = Color.R; }
+    FORCEINLINE void ConvertScalar(const FLinearColor& Color, FVector2f& OutPixel) { OutPixel = FVector2f(Color.R, Color.G); }
+
+    template <EOmniCaptureCPUFilter Filter, typename TexelType, typename PixelType>
+    void GatherRowScalarImpl(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FLinearColor Color = SampleScalar<Filter, TexelType>(Cubemap, Samples[Index]);
+            ConvertScalar(Color, OutPixels[Index]);
+        }
+    }
+
+    template <typename TexelType, typename PixelType>
+    void DispatchGatherRowScalarForTexel(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+        switch (Cubemap.Filter)
+        {
+        case EOmniCaptureCPUFilter::Bilinear:
+            GatherRowScalarImpl<EOmniCaptureCPUFilter::Bilinear, TexelType>(Cubemap, Samples, Count, OutPixels);
+            break;
+        case EOmniCaptureCPUFilter::Bicubic:
+            GatherRowScalarImpl<EOmniCaptureCPUFilter::Bicubic, TexelType>(Cubemap, Samples, Count, OutPixels);
+            break;
+        default:
+            GatherRowScalarImpl<EOmniCaptureCPUFilter::Nearest, TexelType>(Cubemap, Samples, Count, OutPixels);
+            break;
+        }
+    }
+
+    template <typename PixelType>
+    void DispatchGatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+        if (Cubemap.bScalarTexels)
+        {
+            DispatchGatherRowScalarForTexel<float>(Cubemap, Samples, Count, OutPixels);
+        }
+        else if (Cubemap.Precision == EOmniCapturePixelPrecision::HalfFloat)
+        {
+            DispatchGatherRowScalarForTexel<FFloat16Color>(Cubemap, Samples, Count, OutPixels);
+        }
+        else
+        {
+            DispatchGatherRowScalarForTexel<FLinearColor>(Cubemap, Samples, Count, OutPixels);
+        }
+    }
+
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+    template <typename TexelType>
+    FORCEINLINE void PrefetchSample(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Index, int32 Count)
+    {
+        const int32 AheadIndex = Index + GGatherPrefetchDistance;
+        if (AheadIndex < Count && Samples[AheadIndex].IsValid())
+        {
+            FPlatformMisc::Prefetch(ResolveNearestTexel<TexelType>(Cubemap, Samples[AheadIndex]));
+        }
+    }
+
+    FORCEINLINE VectorRegister4Float LoadTexel(const FLinearColor* Texel)
+    {
+        return VectorLoad(&Texel->R);
+    }
+
+    FORCEINLINE VectorRegister4Float LoadTexel(const FFloat16Color* Texel)
+    {
+        alignas(16) float Components[4];
+        FPlatformMath::VectorLoadHalf(Components, reinterpret_cast<const uint16*>(Texel));
+        return VectorLoadAligned(Components);
+    }
+
+    FORCEINLINE VectorRegister4Float LoadTexel(const float* Texel)
+    {
+        return VectorSetFloat1(*Texel);
+    }
+
+    FORCEINLINE VectorRegister4Float LerpVector(const VectorRegister4Float& A, const VectorRegister4Float& B, const VectorRegister4Float& Alpha)
+    {
+        return VectorMultiplyAdd(VectorSubtract(B, A), Alpha, A);
+    }
+
+    template <EOmniCaptureCPUFilter Filter, typename TexelType>
+    FORCEINLINE VectorRegister4Float SampleVector(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample& Sample)
+    {
+        if (!Sample.IsValid())
+        {
+            return VectorZeroFloat();
+        }
+
+        if constexpr (Filter == EOmniCaptureCPUFilter::Nearest)
+        {
+            return LoadTexel(ResolveNearestTexel<TexelType>(Cubemap, Sample));
+        }
+        else if constexpr (Filter == EOmniCaptureCPUFilter::Bilinear)
+        {
+            const uint32 Face = Sample.GetFace();
+            const FFilterFootprint Footprint = GetFootprint(Sample);
+            const int32 Resolution = Cubemap.Resolution;
+
+            VectorRegister4Float Texel00, Texel10, Texel01, Texel11;
+            if (static_cast<uint32>(Footprint.X0) < static_cast<uint32>(Resolution - 1) && static_cast<uint32>(Footprint.Y0) < static_cast<uint32>(Resolution - 1))
+            {
+                const TexelType* Row0 = Cubemap.GetFace<TexelType>(Face) + static_cast<int64>(Footprint.Y0) * Resolution + Footprint.X0;
+                const TexelType* Row1 = Row0 + Resolution;
+                Texel00 = LoadTexel(Row0);
+                Texel10 = LoadTexel(Row0 + 1);
+                Texel01 = LoadTexel(Row1);
+                Texel11 = LoadTexel(Row1 + 1);
+            }
+            else
+            {
+                Texel00 = LoadTexel(ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0, Footprint.Y0));
+                Texel10 = LoadTexel(ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0 + 1, Footprint.Y0));
+                Texel01 = LoadTexel(ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0, Footprint.Y0 + 1));
+                Texel11 = LoadTexel(ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0 + 1, Footprint.Y0 + 1));
+            }
+
+            const VectorRegister4Float FracX = VectorSetFloat1(Footprint.FracX);
+            const VectorRegister4Float Top = LerpVector(Texel00, Texel10, FracX);
+            const VectorRegister4Float Bottom = LerpVector(Texel01, Texel11, FracX);
+            return LerpVector(Top, Bottom, VectorSetFloat1(Footprint.FracY));
+        }
+        else
+        {
+            const uint32 Face = Sample.GetFace();
+            const FFilterFootprint Footprint = GetFootprint(Sample);
+            const int32 Resolution = Cubemap.Resolution;
+            float WeightsX[4];
+            float WeightsY[4];
+            GetCatmullRomWeights(Footprint.FracX, WeightsX);
+            GetCatmullRomWeights(Footprint.FracY, WeightsY);
+
+            const VectorRegister4Float WeightX0 = VectorSetFloat1(WeightsX[0]);
+            const VectorRegister4Float WeightX1 = VectorSetFloat1(WeightsX[1]);
+            const VectorRegister4Float WeightX2 = VectorSetFloat1(WeightsX[2]);
+            const VectorRegister4Float WeightX3 = VectorSetFloat1(WeightsX[3]);
+            const bool bInterior = Resolution >= 4
+                && static_cast<uint32>(Footprint.X0 - 1) < static_cast<uint32>(Resolution - 3)
+                && static_cast<uint32>(Footprint.Y0 - 1) < static_cast<uint32>(Resolution - 3);
+
+            VectorRegister4Float Result = VectorZeroFloat();
+            for (int32 Row = 0; Row < 4; ++Row)
+            {
+                const int32 Y = Footprint.Y0 - 1 + Row;
+                VectorRegister4Float Taps[4];
+                if (bInterior)
+                {
+                    const TexelType* RowTexels = Cubemap.GetFace<TexelType>(Face) + static_cast<int64>(Y) * Resolution + Footprint.X0 - 1;
+                    for (int32 Column = 0; Column < 4; ++Column)
+                    {
+                        Taps[Column] = LoadTexel(RowTexels + Column);
+                    }
+                }
+                else
+                {
+                    for (int32 Column = 0; Column < 4; ++Column)
+                    {
+                        Taps[Column] = LoadTexel(ResolveTexel<TexelType>(Cubemap, Face, Footprint.X0 - 1 + Column, Y));
+                    }
+                }
+
+                VectorRegister4Float RowColor = VectorMultiply(Taps[0], WeightX0);
+                RowColor = VectorMultiplyAdd(Taps[1], WeightX1, RowColor);
+                RowColor = VectorMultiplyAdd(Taps[2], WeightX2, RowColor);
+                RowColor = VectorMultiplyAdd(Taps[3], WeightX3, RowColor);
+                Result = VectorMultiplyAdd(RowColor, VectorSetFloat1(WeightsY[Row]), Result);
+            }
+            return Result;
+        }
+    }
+
+    // Linear -> 8-bit sRGB without leaving the register. The transfer curve uses the three-square-root fit of
+    // 1.055 * x^(1/2.4) - 0.055 (max error about a quarter of an 8-bit step), alpha stays linear, and the final
+    // truncation mirrors FLinearColor::ToFColor so results differ from the scalar path by at most one step.
+    FORCEINLINE void StoreSRGB8(const VectorRegister4Float& Linear, FColor* OutColor)
+    {
+        const VectorRegister4Float Clamped = VectorMin(VectorMax(Linear, VectorZeroFloat()), VectorOneFloat());
+        const VectorRegister4Float Sqrt1 = VectorSqrt(Clamped);
+        const VectorRegister4Float Sqrt2 = VectorSqrt(Sqrt1);
+        const VectorRegister4Float Sqrt3 = VectorSqrt(Sqrt2);
+
+        VectorRegister4Float Curve = VectorMultiply(Clamped, VectorSetFloat1(-0.0225411470f));
+        Curve = VectorMultiplyAdd(Sqrt3, VectorSetFloat1(-0.323583601f), Curve);
+        Curve = VectorMultiplyAdd(Sqrt2, VectorSetFloat1(0.684122060f), Curve);
+        Curve = VectorMultiplyAdd(Sqrt1, VectorSetFloat1(0.662002687f), Curve);
+
+        const VectorRegister4Float Toe = VectorMultiply(Clamped, VectorSetFloat1(12.92f));
+        const VectorRegister4Float ToeMask = VectorCompareGE(VectorSetFloat1(0.0031308f), Clamped);
+        VectorRegister4Float Encoded = VectorSelect(ToeMask, Toe, Curve);
+        Encoded = VectorSelect(GlobalVectorConstants::XYZMask(), Encoded, Clamped);
+
+        // FColor is laid out B, G, R, A in memory.
+        const VectorRegister4Float Swizzled = VectorSwizzle(Encoded, 2, 1, 0, 3);
+        VectorStoreByte4(VectorMultiply(Swizzled, VectorSetFloat1(255.999f)), OutColor);
+    }
+
+    FORCEINLINE void StoreVector(const VectorRegister4Float& Color, FLinearColor* OutPixel)
+    {
+        VectorStore(Color, &OutPixel->R);
+    }
+
+    FORCEINLINE void StoreVector(const VectorRegister4Float& Color, FFloat16Color* OutPixel)
+    {
+        alignas(16) float Components[4];
+        VectorStoreAligned(Color, Components);
+        FPlatformMath::VectorStoreHalf(reinterpret_cast<uint16*>(OutPixel), Components);
+    }
+
+    FORCEINLINE void StoreVector(const VectorRegister4Float& Color, FColor* OutPixel)
+    {
+        StoreSRGB8(Color, OutPixel);
+    }
+
+    FORCEINLINE void StoreVector(const VectorRegister4Float& Color, float* OutPixel)
+    {
+        VectorStoreFloat1(Color, OutPixel);
+    }
+
+    FORCEINLINE void StoreVector(const VectorRegister4Float& Color, FVector2f* OutPixel)
+    {
+        alignas(16) float Components[4];
+        VectorStoreAligned(Color, Components);
+        OutPixel->X = Components[0];
+        OutPixel->Y = Components[1];
+    }
+
+    template <EOmniCaptureCPUFilter Filter, typename TexelType, typename PixelType>
+    void GatherRowVectorImpl(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            PrefetchSample<TexelType>(Cubemap, Samples, Index, Count);
+
+            if constexpr (Filter == EOmniCaptureCPUFilter::Nearest && std::is_same_v<TexelType, PixelType>)
+            {
+                // Same storage in and out: move the texel bits untouched.
+                const FOmniCaptureProjectionSample& Sample = Samples[Index];
+                if (Sample.IsValid())
+                {
+                    OutPixels[Index] = *ResolveNearestTexel<TexelType>(Cubemap, Sample);
+                }
+                else
+                {
+                    FMemory::Memzero(&OutPixels[Index], sizeof(PixelType));
+                }
+            }
+            else
+            {
+                StoreVector(SampleVector<Filter, TexelType>(Cubemap, Samples[Index]), &OutPixels[Index]);
+            }
+        }
+    }
+
+    template <typename TexelType, typename PixelType>
+    void DispatchGatherRowVectorForTexel(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+        switch (Cubemap.Filter)
+        {
+        case EOmniCaptureCPUFilter::Bilinear:
+            GatherRowVectorImpl<EOmniCaptureCPUFilter::Bilinear, TexelType>(Cubemap, Samples, Count, OutPixels);
+            break;
+        case EOmniCaptureCPUFilter::Bicubic:
+            GatherRowVectorImpl<EOmniCaptureCPUFilter::Bicubic, TexelType>(Cubemap, Samples, Count, OutPixels);
+            break;
+        default:
+            GatherRowVectorImpl<EOmniCaptureCPUFilter::Nearest, TexelType>(Cubemap, Samples, Count, OutPixels);
+            break;
+        }
+    }
+
+    template <typename PixelType>
+    void DispatchGatherRowVector(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+        if (Cubemap.bScalarTexels)
+        {
+            DispatchGatherRowVectorForTexel<float>(Cubemap, Samples, Count, OutPixels);
+        }
+        else if (Cubemap.Precision == EOmniCapturePixelPrecision::HalfFloat)
+        {
+            DispatchGatherRowVectorForTexel<FFloat16Color>(Cubemap, Samples, Count, OutPixels);
+        }
+        else
+        {
+            DispatchGatherRowVectorForTexel<FLinearColor>(Cubemap, Samples, Count, OutPixels);
+        }
+    }
+#endif
+
+    template <typename PixelType>
+    void DispatchGatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, PixelType* OutPixels)
+    {
+#if PLATFORM_ENABLE_VECTORINTRINSICS
+        DispatchGatherRowVector(Cubemap, Samples, Count, OutPixels);
+#else
+        DispatchGatherRowScalar(Cubemap, Samples, Count, OutPixels);
+#endif
+    }
+
+    constexpr int32 GProjectionRowsPerBand = 16;
+    constexpr int32 GProjectionRunLength = 256;
+
+    // Splits the output into row bands (and per-eye column halves for side-by-side stereo). Bands are small enough for
+    // idle workers to steal the tail.
+    void ForEachOutputTile(int32 OutputWidth, int32 OutputHeight, int32 EyeColumns, bool bParallel, TFunctionRef<void(int32 StartX, int32 EndX, int32 StartY, int32 EndY)> Body)
+    {
+        if (OutputWidth <= 0 || OutputHeight <= 0)
+        {
+            return;
+        }
+
+        const int32 ColumnCount = FMath::Clamp(EyeColumns, 1, OutputWidth);
+        const int32 ColumnWidth = FMath::DivideAndRoundUp(OutputWidth, ColumnCount);
+        const int32 BandCount = FMath::DivideAndRoundUp(OutputHeight, GProjectionRowsPerBand);
+
+        ParallelFor(BandCount * ColumnCount, [&](int32 TileIndex)
+        {
+            const int32 Band = TileIndex / ColumnCount;
+            const int32 Column = TileIndex % ColumnCount;
+            const int32 StartY = Band * GProjectionRowsPerBand;
+            const int32 EndY = FMath::Min(StartY + GProjectionRowsPerBand, OutputHeight);
+            const int32 StartX = Column * ColumnWidth;
+            const int32 EndX = FMath::Min(StartX + ColumnWidth, OutputWidth);
+            if (StartX < EndX)
+            {
+                Body(StartX, EndX, StartY, EndY);
+            }
+        }, bParallel ? EParallelForFlags::Unbalanced : EParallelForFlags::ForceSingleThread);
+    }
+
+    void GatherLayerRun(const FOmniCaptureCubemapView& View, EOmniCapturePixelDataType PixelDataType, const FOmniCaptureProjectionSample* Samples, int32 Count, void* Pixels, int64 Index)
+    {
+        switch (PixelDataType)
+        {
+        case EOmniCapturePixelDataType::LinearColorFloat32:
+            FOmniCaptureCubemapSampler::GatherRow(View, Samples, Count, static_cast<FLinearColor*>(Pixels) + Index);
+            break;
+        case EOmniCapturePixelDataType::LinearColorFloat16:
+            FOmniCaptureCubemapSampler::GatherRow(View, Samples, Count, static_cast<FFloat16Color*>(Pixels) + Index);
+            break;
+        case EOmniCapturePixelDataType::Color8:
+            FOmniCaptureCubemapSampler::GatherRow(View, Samples, Count, static_cast<FColor*>(Pixels) + Index);
+            break;
+        case EOmniCapturePixelDataType::ScalarFloat32:
+            FOmniCaptureCubemapSampler::GatherRow(View, Samples, Count, static_cast<float*>(Pixels) + Index);
+            break;
+        case EOmniCapturePixelDataType::Vector2Float32:
+            FOmniCaptureCubemapSampler::GatherRow(View, Samples, Count, static_cast<FVector2f*>(Pixels) + Index);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void FOmniCaptureCubemapSampler::GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FLinearColor* OutPixels)
+{
+    DispatchGatherRow(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FFloat16Color* OutPixels)
+{
+    DispatchGatherRow(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FColor* OutPixels)
+{
+    DispatchGatherRow(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FLinearColor* OutPixels)
+{
+    DispatchGatherRowScalar(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FFloat16Color* OutPixels)
+{
+    DispatchGatherRowScalar(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FColor* OutPixels)
+{
+    DispatchGatherRowScalar(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, float* OutPixels)
+{
+    DispatchGatherRow(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FVector2f* OutPixels)
+{
+    DispatchGatherRow(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, float* OutPixels)
+{
+    DispatchGatherRowScalar(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FVector2f* OutPixels)
+{
+    DispatchGatherRowScalar(Cubemap, Samples, Count, OutPixels);
+}
+
+void FOmniCaptureCubemapSampler::GatherProjection(const FOmniCaptureProjectionLUT& ProjectionLUT, TConstArrayView<FOmniCaptureGatherLayer> Layers, bool bStereo, bool bSideBySide, const FIntPoint& OutputSize, bool bParallel)
+{
+    const int32 EyeWidth = ProjectionLUT.GetEyeResolution().X;
+    const int32 EyeHeight = ProjectionLUT.GetEyeResolution().Y;
+
+    ForEachOutputTile(OutputSize.X, OutputSize.Y, bSideBySide ? 2 : 1, bParallel, [&](int32 StartX, int32 EndX, int32 StartY, int32 EndY)
+    {
+        for (int32 Y = StartY; Y < EndY; ++Y)
+        {
+            const bool bBottomEye = bStereo && !bSideBySide && Y >= EyeHeight;
+            const int32 EyeY = (bStereo && !bSideBySide) ? Y % EyeHeight : Y;
+            const FOmniCaptureProjectionSample* LUTRow = ProjectionLUT.GetRow(EyeY);
+            const int64 RowOffset = static_cast<int64>(Y) * OutputSize.X;
+
+            int32 X = StartX;
+            while (X < EndX)
+            {
+                int32 EyeX = X;
+                int32 RunLength = FMath::Min(EndX - X, GProjectionRunLength);
+                bool bRightEye = bBottomEye;
+                if (bSideBySide)
+                {
+                    bRightEye = X >= EyeWidth;
+                    EyeX = X % EyeWidth;
+                    RunLength = FMath::Min(RunLength, EyeWidth - EyeX);
+                }
+
+                for (const FOmniCaptureGatherLayer& Layer : Layers)
+                {
+                    GatherLayerRun(bRightEye ? Layer.Right : Layer.Left, Layer.PixelDataType, LUTRow + EyeX, RunLength, Layer.Pixels, RowOffset + X);
+                }
+                X += RunLength;
+            }
+        }
+    });
+}
@@ -1,6 +1,10 @@
 #include "OmniCaptureEquirectConverter.h"
 
 #include "OmniCaptureIncludeFixes.h" // 统一兼容：TRT2D + TRTResource
+#include "OmniCaptureCubemapSampler.h"
+#include "OmniCaptureFramePool.h"
+#include "OmniCaptureProjectionLUT.h"
+#include "OmniCaptureReadbackQueue.h"
 #include "OmniCaptureTypes.h"
 
 #include "GlobalShader.h"
@@ -20,18 +24,50 @@
 #endif
 #include "RHICommandList.h"
 #include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Algo/AllOf.h"
+#include "Algo/Transform.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureEquirect, Log, All);
 
 namespace
 {
+    // Face texels stay in the precision they were read back in; only the array matching Precision is populated.
+    // Single-channel targets such as depth keep one float per texel in ScalarPixels instead.
     struct FCPUFaceData
     {
-        int32 Resolution = 0;
+        FIntPoint Size = FIntPoint::ZeroValue;
         EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
-        TArray<FLinearColor> Pixels;
+        bool bScalar = false;
+        TArray<FLinearColor> FullPixels;
+        TArray<FFloat16Color> HalfPixels;
+        TArray<float> ScalarPixels;
+
+        const void* GetPixelData() const
+        {
+            if (bScalar)
+            {
+                return ScalarPixels.GetData();
+            }
+
+            return Precision == EOmniCapturePixelPrecision::FullFloat
+                ? static_cast<const void*>(FullPixels.GetData())
+                : static_cast<const void*>(HalfPixels.GetData());
+        }
+
+        int32 GetPixelCount() const
+        {
+            if (bScalar)
+            {
+                return ScalarPixels.Num();
+            }
+
+            return Precision == EOmniCapturePixelPrecision::FullFloat ? FullPixels.Num() : HalfPixels.Num();
+        }
 
         bool IsValid() const
         {
-            return Resolution > 0 && Pixels.Num() == Resolution * Resolution;
+            return Size.X > 0 && Size.Y > 0 && Precision != EOmniCapturePixelPrecision::Unknown && GetPixelCount() == Size.X * Size.Y;
         }
     };
 
@@ -44,7 +80,7 @@ namespace
         {
             for (int32 Index = 0; Index < 6; ++Index)
             {
-                if (!Faces[Index].IsValid())
+                if (!Faces[Index].IsValid() || Faces[Index].Size != FIntPoint(Faces[0].Size.X, Faces[0].Size.X) || Faces[Index].bScalar != Faces[0].bScalar)
                 {
                     return false;
                 }
@@ -52,6 +88,34 @@ namespace
 
             return Precision != EOmniCapturePixelPrecision::Unknown;
         }
+
+        int32 GetResolution() const
+        {
+            return Faces[0].Size.X;
+        }
+
+        FOmniCaptureCubemapView MakeView(const FOmniCaptureProjectionLUT& ProjectionLUT) const
+        {
+            FOmniCaptureCubemapView View;
+            View.Resolution = GetResolution();
+            View.Precision = Precision;
+            View.bScalarTexels = Faces[0].bScalar;
+            View.Filter = ProjectionLUT.GetKey().Filter;
+            View.SeamTable = &ProjectionLUT.GetSeamTable();
+            for (int32 Index = 0; Index < 6; ++Index)
+            {
+                View.Faces[Index] = Faces[Index].GetPixelData();
+            }
+            return View;
+        }
+    };
+
+    // An auxiliary pass read back for the CPU gather. Planar captures only fill the first left face.
+    struct FCPUAuxiliaryLayer
+    {
+        EOmniCaptureAuxiliaryPassType PassType = EOmniCaptureAuxiliaryPassType::None;
+        FCPUCubemap Left;
+        FCPUCubemap Right;
     };
 
     EOmniCapturePixelPrecision PixelPrecisionFromFormat(EPixelFormat Format)
@@ -256,7 +320,10 @@ namespace
             return false;
         }
 
-        OutFace.Pixels.Reset();
+        OutFace.FullPixels.Reset();
+        OutFace.HalfPixels.Reset();
+        OutFace.ScalarPixels.Reset();
+        OutFace.bScalar = false;
         OutFace.Precision = PixelPrecisionFromFormat(RenderTarget->GetFormat());
 
         // Use the standard UNorm readback mode instead of the Min/Max resolve
@@ -270,28 +337,24 @@ namespace
 
         if (OutFace.Precision == EOmniCapturePixelPrecision::FullFloat)
         {
-            if (!Resource->ReadLinearColorPixels(OutFace.Pixels, Flags, FIntRect()))
+            if (!Resource->ReadLinearColorPixels(OutFace.FullPixels, Flags, FIntRect()))
             {
                 return false;
             }
         }
         else
         {
-            TArray<FFloat16Color> HalfPixels;
-            if (!Resource->ReadFloat16Pixels(HalfPixels, Flags, FIntRect()))
+            // Keep half-float faces as they are; the sampler widens texels on load, so there is no full-size
+            // FLinearColor copy of every face.
+            if (!Resource->ReadFloat16Pixels(OutFace.HalfPixels, Flags, FIntRect()))
             {
                 return false;
             }
 
             OutFace.Precision = EOmniCapturePixelPrecision::HalfFloat;
-            OutFace.Pixels.SetNum(HalfPixels.Num());
-            for (int32 Index = 0; Index < HalfPixels.Num(); ++Index)
-            {
-                OutFace.Pixels[Index] = FLinearColor(HalfPixels[Index]);
-            }
         }
 
-        OutFace.Resolution = SizeX;
+        OutFace.Size = FIntPoint(SizeX, SizeY);
         return OutFace.IsValid();
     }
 
@@ -315,152 +378,35 @@ namespace
                 OutCubemap.Precision = EOmniCapturePixelPrecision::Unknown;
                 return false;
             }
-        }
-
-        return OutCubemap.IsValid();
-    }
-
-    FVector DirectionFromEquirectPixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double LongitudeSpan, double LatitudeSpan, float& OutLatitude)
-    {
-        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
-        const double Longitude = (UV.X - 0.5) * LongitudeSpan;
-        const double Latitude = (0.5 - UV.Y) * LatitudeSpan;
-        OutLatitude = static_cast<float>(Latitude);
-
-        const double CosLat = FMath::Cos(Latitude);
-        const double SinLat = FMath::Sin(Latitude);
-        const double CosLon = FMath::Cos(Longitude);
-        const double SinLon = FMath::Sin(Longitude);
-
-        FVector Direction;
-        Direction.X = CosLat * CosLon;
-        Direction.Y = SinLat;
-        Direction.Z = CosLat * SinLon;
-        return Direction.GetSafeNormal();
-    }
-
-    FVector DirectionFromFisheyePixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double FovRadians, bool& bOutValid)
-    {
-        if (EyeResolution.X <= 0 || EyeResolution.Y <= 0)
-        {
-            bOutValid = false;
-            return FVector::ZeroVector;
-        }
-
-        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
-        FVector2D Normalized = FVector2D(UV.X * 2.0 - 1.0, 1.0 - UV.Y * 2.0);
-
-        const double Radius = Normalized.Size();
-        if (Radius > 1.0)
-        {
-            bOutValid = false;
-            return FVector::ZeroVector;
-        }
-
-        const double HalfFov = FMath::Clamp(FovRadians * 0.5, 0.0, PI);
-        const double Theta = Radius * HalfFov;
-        const double Phi = FMath::Atan2(Normalized.Y, Normalized.X);
-        const double SinTheta = FMath::Sin(Theta);
-
-        FVector Direction;
-        Direction.X = FMath::Cos(Theta);
-        Direction.Y = SinTheta * FMath::Sin(Phi);
-        Direction.Z = SinTheta * FMath::Cos(Phi);
-
-        bOutValid = true;
-        return Direction.GetSafeNormal();
-    }
-
-    void DirectionToFaceUVCPU(const FVector& Direction, uint32& OutFaceIndex, FVector2D& OutUV, int32 FaceResolution, float SeamStrength)
-    {
-        const FVector AbsDir = Direction.GetAbs();
 
-        if (AbsDir.X >= AbsDir.Y && AbsDir.X >= AbsDir.Z)
-        {
-            if (Direction.X > 0.0f)
-            {
-                OutFaceIndex = 0;
-                OutUV = FVector2D(-Direction.Z, Direction.Y) / AbsDir.X;
-            }
-            else
-            {
-                OutFaceIndex = 1;
-                OutUV = FVector2D(Direction.Z, Direction.Y) / AbsDir.X;
-            }
-        }
-        else if (AbsDir.Y >= AbsDir.X && AbsDir.Y >= AbsDir.Z)
-        {
-            if (Direction.Y > 0.0f)
-            {
-                OutFaceIndex = 2;
-                OutUV = FVector2D(Direction.X, -Direction.Z) / AbsDir.Y;
-            }
-            else
-            {
-                OutFaceIndex = 3;
-                OutUV = FVector2D(Direction.X, Direction.Z) / AbsDir.Y;
-            }
-        }
-        else
-        {
-            if (Direction.Z > 0.0f)
-            {
-                OutFaceIndex = 4;
-                OutUV = FVector2D(Direction.X, Direction.Y) / AbsDir.Z;
-            }
-            else
-            {
-                OutFaceIndex = 5;
-                OutUV = FVector2D(-Direction.X, Direction.Y) / AbsDir.Z;
-            }
         }
 
-        OutUV = (OutUV + FVector2D(1.0, 1.0)) * 0.5f;
-
-        const double Resolution = static_cast<double>(FMath::Max(1, FaceResolution));
-        const double Scale = FMath::Lerp(1.0, (Resolution - 1.0) / Resolution, SeamStrength);
-        const double Bias = (0.5 / Resolution) * SeamStrength;
-        OutUV = FVector2D(OutUV.X * Scale + Bias, OutUV.Y * Scale + Bias);
-        OutUV.X = FMath::Clamp(OutUV.X, 0.0f, 1.0f);
-        OutUV.Y = FMath::Clamp(OutUV.Y, 0.0f, 1.0f);
+        return OutCubemap.IsValid();
     }
 
-    FLinearColor SampleCubemapCPU(const FCPUCubemap& Cubemap, const FVector& Direction, int32 FaceResolution, float SeamStrength)
+    // One output layer of a CPU gather: the cubemaps it samples and the pixels it writes, in the layer's own format.
+    struct FCPUGatherLayer
     {
-        uint32 FaceIndex = 0;
-        FVector2D FaceUV = FVector2D::ZeroVector;
-        DirectionToFaceUVCPU(Direction, FaceIndex, FaceUV, FaceResolution, SeamStrength);
-
-        const FCPUFaceData& Face = Cubemap.Faces[FaceIndex];
-        const int32 SampleX = FMath::Clamp(static_cast<int32>(FaceUV.X * (Face.Resolution - 1)), 0, Face.Resolution - 1);
-        const int32 SampleY = FMath::Clamp(static_cast<int32>(FaceUV.Y * (Face.Resolution - 1)), 0, Face.Resolution - 1);
-        const int32 SampleIndex = SampleY * Face.Resolution + SampleX;
-
-        return Face.Pixels.IsValidIndex(SampleIndex)
-            ? FLinearColor(Face.Pixels[SampleIndex])
-            : FLinearColor::Black;
-    }
+        const FCPUCubemap* Left = nullptr;
+        const FCPUCubemap* Right = nullptr;
+        EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
+        void* Pixels = nullptr;
+    };
 
-    void ApplyPolarMitigation(float PolarStrength, float Latitude, FVector& Direction)
+    // Resolves every layer through one projection LUT on the task graph; see FOmniCaptureCubemapSampler::GatherProjection.
+    void GatherLayersCPU(const FOmniCaptureProjectionLUT& ProjectionLUT, TConstArrayView<FCPUGatherLayer> Layers, bool bStereo, bool bSideBySide, const FIntPoint& OutputSize)
     {
-        if (PolarStrength <= 0.0f)
-        {
-            return;
-        }
-
-        double PoleFactor = FMath::Clamp(FMath::Abs(Latitude) / (PI * 0.5), 0.0, 1.0);
-        PoleFactor = FMath::Pow(PoleFactor, 4.0);
-        const double Blend = PoleFactor * PolarStrength;
-        if (Blend <= 0.0)
+        TArray<FOmniCaptureGatherLayer, TInlineAllocator<8>> GatherLayers;
+        for (const FCPUGatherLayer& Layer : Layers)
         {
-            return;
+            FOmniCaptureGatherLayer& GatherLayer = GatherLayers.AddDefaulted_GetRef();
+            GatherLayer.Left = Layer.Left->MakeView(ProjectionLUT);
+            GatherLayer.Right = bStereo ? Layer.Right->MakeView(ProjectionLUT) : GatherLayer.Left;
+            GatherLayer.PixelDataType = Layer.PixelDataType;
+            GatherLayer.Pixels = Layer.Pixels;
         }
 
-        const FVector PoleVector(0.0f, Latitude >= 0.0f ? 1.0f : -1.0f, 0.0f);
-        Direction = FVector(FMath::Lerp(Direction.X, PoleVector.X, Blend),
-            FMath::Lerp(Direction.Y, PoleVector.Y, Blend),
-            FMath::Lerp(Direction.Z, PoleVector.Z, Blend));
-        Direction.Normalize();
+        FOmniCaptureCubemapSampler::GatherProjection(ProjectionLUT, GatherLayers, bStereo, bSideBySide, OutputSize);
     }
 
     void AddYUVConversionPasses(
@@ -568,6 +514,250 @@ namespace
         return OutputTexture;
     }
 
+    // FRHIGPUTextureReadback behind the capture's readback interface. Must be used on the render thread.
+    class FOmniRHITextureReadback final : public IOmniCaptureReadback
+    {
+    public:
+        FOmniRHITextureReadback(const TCHAR* Name, uint32 InBytesPerPixel)
+            : Readback(Name)
+            , BytesPerPixel(InBytesPerPixel)
+        {
+        }
+
+        void EnqueueCopy(FRHICommandListImmediate& RHICmdList, FRHITexture* Texture, const FIntPoint& Size)
+        {
+            Readback.EnqueueCopy(RHICmdList, Texture, FResolveRect(0, 0, Size.X, Size.Y));
+        }
+
+        virtual bool IsReady() override
+        {
+            return Readback.IsReady();
+        }
+
+        virtual void WaitUntilReady() override
+        {
+            if (Readback.IsReady())
+            {
+                return;
+            }
+
+            FRHICommandListExecutor::GetImmediateCommandList().SubmitCommandsAndFlushGPU();
+            while (!Readback.IsReady())
+            {
+                FPlatformProcess::SleepNoStats(0.0f);
+            }
+        }
+
+        virtual const void* Lock(int32& OutRowPitchInBytes) override
+        {
+            // The RHI reports the pitch of the staging texture in pixels.
+            int32 RowPitchInPixels = 0;
+            const void* Data = Readback.Lock(RowPitchInPixels);
+            OutRowPitchInBytes = RowPitchInPixels * static_cast<int32>(BytesPerPixel);
+            return Data;
+        }
+
+        virtual void Unlock() override
+        {
+            Readback.Unlock();
+        }
+
+    private:
+        FRHIGPUTextureReadback Readback;
+        uint32 BytesPerPixel = 0;
+    };
+
+    // Either hands the issued copy to the caller for pipelined resolution or waits for it and resolves it in place.
+    void FinishReadback(FRHICommandListImmediate& RHICmdList, TUniquePtr<FOmniRHITextureReadback>&& Readback, EOmniCaptureReadbackMode ReadbackMode, FOmniCaptureEquirectResult& OutResult)
+    {
+        if (ReadbackMode == EOmniCaptureReadbackMode::Deferred)
+        {
+            // Get the copy onto the GPU without waiting for it; the capture's readback queue picks it up frames later.
+            RHICmdList.ImmediateFlush(EImmediateFlushType::DispatchToRHIThread);
+            OutResult.PendingReadback = MoveTemp(Readback);
+            return;
+        }
+
+        Readback->WaitUntilReady();
+        FOmniCaptureReadbackQueue::ResolvePixels(*Readback, OutResult.Size, OutResult.PixelPrecision, OutResult.bIsLinear, OutResult.PixelData, OutResult.PixelDataType);
+    }
+
+    // An auxiliary render target and the CPU face its texels are read into.
+    struct FAuxiliaryFaceReadback
+    {
+        FTextureRHIRef Texture;
+        FIntPoint Size = FIntPoint::ZeroValue;
+        FCPUFaceData* Face = nullptr;
+    };
+
+    // Copies the locked texels of an auxiliary target into OutFace in the format they were rendered in, widening
+    // half-float single-channel targets to floats. Formats the gather cannot sample leave the face empty.
+    bool CopyAuxiliaryTexels(EPixelFormat Format, const uint8* Data, int32 RowPitchInBytes, const FIntPoint& Size, FCPUFaceData& OutFace)
+    {
+        OutFace.Size = Size;
+        OutFace.FullPixels.Reset();
+        OutFace.HalfPixels.Reset();
+        OutFace.ScalarPixels.Reset();
+        OutFace.bScalar = Format == PF_R32_FLOAT || Format == PF_R16F;
+        OutFace.Precision = Format == PF_FloatRGBA || Format == OmniCapture::GetHalfFloatPixelFormat()
+            ? EOmniCapturePixelPrecision::HalfFloat
+            : EOmniCapturePixelPrecision::FullFloat;
+
+        if (!Data || RowPitchInBytes < Size.X * static_cast<int32>(GPixelFormats[Format].BlockBytes))
+        {
+            return false;
+        }
+
+        const int32 PixelCount = Size.X * Size.Y;
+        if (OutFace.bScalar)
+        {
+            OutFace.ScalarPixels.SetNumUninitialized(PixelCount);
+        }
+        else if (Format == PF_A32B32G32R32F)
+        {
+            OutFace.FullPixels.SetNumUninitialized(PixelCount);
+        }
+        else if (OutFace.Precision == EOmniCapturePixelPrecision::HalfFloat)
+        {
+            OutFace.HalfPixels.SetNumUninitialized(PixelCount);
+        }
+        else
+        {
+            return false;
+        }
+
+        for (int32 Row = 0; Row < Size.Y; ++Row)
+        {
+            const uint8* SourceRow = Data + static_cast<int64>(Row) * RowPitchInBytes;
+            const int64 RowOffset = static_cast<int64>(Row) * Size.X;
+            switch (Format)
+            {
+            case PF_R32_FLOAT:
+                FMemory::Memcpy(OutFace.ScalarPixels.GetData() + RowOffset, SourceRow, Size.X * sizeof(float));
+                break;
+            case PF_R16F:
+            {
+                const FFloat16* Source = reinterpret_cast<const FFloat16*>(SourceRow);
+                float* Destination = OutFace.ScalarPixels.GetData() + RowOffset;
+                for (int32 X = 0; X < Size.X; ++X)
+                {
+                    Destination[X] = Source[X].GetFloat();
+                }
+                break;
+            }
+            case PF_A32B32G32R32F:
+                FMemory::Memcpy(OutFace.FullPixels.GetData() + RowOffset, SourceRow, Size.X * sizeof(FLinearColor));
+                break;
+            default:
+                FMemory::Memcpy(OutFace.HalfPixels.GetData() + RowOffset, SourceRow, Size.X * sizeof(FFloat16Color));
+                break;
+            }
+        }
+
+        return OutFace.IsValid();
+    }
+
+    // Settles the cubemap's precision once its faces are read back; false unless the first FaceCount faces arrived
+    // and agree on size and format.
+    bool FinishAuxiliaryCubemap(FCPUCubemap& Cubemap, int32 FaceCount)
+    {
+        Cubemap.Precision = Cubemap.Faces[0].Precision;
+        for (int32 FaceIndex = 0; FaceIndex < FaceCount; ++FaceIndex)
+        {
+            const FCPUFaceData& Face = Cubemap.Faces[FaceIndex];
+            if (!Face.IsValid() || Face.Precision != Cubemap.Precision || Face.bScalar != Cubemap.Faces[0].bScalar)
+            {
+                return false;
+            }
+        }
+
+        return FaceCount < 6 || Cubemap.IsValid();
+    }
+
+    // Reads every requested auxiliary pass of both eyes back in one render command with a single GPU flush, instead
+    // of a readback and a wait per face and pass. Passes with a missing target or an unsupported format are dropped.
+    void ReadAuxiliaryLayers(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TConstArrayView<EOmniCaptureAuxiliaryPassType> AuxiliaryPasses, TArray<FCPUAuxiliaryLayer>& OutLayers)
+    {
+        const int32 FaceCount = Settings.IsPlanar() ? 1 : 6;
+        const int32 EyeCount = !Settings.IsPlanar() && Settings.Mode == EOmniCaptureMode::Stereo ? 2 : 1;
+
+        // The readbacks point into the layers, so the array must not grow past its reservation.
+        OutLayers.Reset(AuxiliaryPasses.Num());
+        TArray<FAuxiliaryFaceReadback> Readbacks;
+        for (const EOmniCaptureAuxiliaryPassType PassType : AuxiliaryPasses)
+        {
+            if (PassType == EOmniCaptureAuxiliaryPassType::None || OutLayers.ContainsByPredicate([PassType](const FCPUAuxiliaryLayer& Layer) { return Layer.PassType == PassType; }))
+            {
+                continue;
+            }
+
+            FCPUAuxiliaryLayer& Layer = OutLayers.AddDefaulted_GetRef();
+            Layer.PassType = PassType;
+            const int32 FirstReadback = Readbacks.Num();
+            bool bComplete = true;
+            for (int32 EyeIndex = 0; EyeIndex < EyeCount && bComplete; ++EyeIndex)
+            {
+                const FOmniEyeCapture& Eye = EyeIndex == 0 ? LeftEye : RightEye;
+                FCPUCubemap& Cubemap = EyeIndex == 0 ? Layer.Left : Layer.Right;
+                for (int32 FaceIndex = 0; FaceIndex < FaceCount && bComplete; ++FaceIndex)
+                {
+                    UTextureRenderTarget2D* RenderTarget = FaceIndex < Eye.ActiveFaceCount ? Eye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType) : nullptr;
+                    FTextureRenderTargetResource* Resource = RenderTarget ? RenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+                    FTextureRHIRef Texture = Resource ? Resource->GetTextureRHI() : nullptr;
+                    bComplete = Texture.IsValid() && RenderTarget->SizeX > 0 && RenderTarget->SizeY > 0;
+                    if (bComplete)
+                    {
+                        Readbacks.Add({ Texture, FIntPoint(RenderTarget->SizeX, RenderTarget->SizeY), &Cubemap.Faces[FaceIndex] });
+                    }
+                }
+            }
+
+            if (!bComplete)
+            {
+                Readbacks.SetNum(FirstReadback);
+                OutLayers.Pop(EAllowShrinking::No);
+            }
+        }
+
+        if (Readbacks.Num() == 0)
+        {
+            return;
+        }
+
+        FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
+        ENQUEUE_RENDER_COMMAND(OmniCaptureAuxiliaryReadback)([&Readbacks, CompletionEvent](FRHICommandListImmediate& RHICmdList)
+        {
+            TArray<TUniquePtr<FOmniRHITextureReadback>> Copies;
+            Copies.Reserve(Readbacks.Num());
+            for (const FAuxiliaryFaceReadback& Readback : Readbacks)
+            {
+                const uint32 BytesPerPixel = GPixelFormats[Readback.Texture->GetFormat()].BlockBytes;
+                Copies.Add_GetRef(MakeUnique<FOmniRHITextureReadback>(TEXT("OmniAuxiliaryReadback"), BytesPerPixel))->EnqueueCopy(RHICmdList, Readback.Texture, Readback.Size);
+            }
+
+            // The first wait flushes the GPU for every copy; the rest are ready by then.
+            for (int32 Index = 0; Index < Copies.Num(); ++Index)
+            {
+                const FAuxiliaryFaceReadback& Readback = Readbacks[Index];
+                Copies[Index]->WaitUntilReady();
+                int32 RowPitchInBytes = 0;
+                const uint8* Data = static_cast<const uint8*>(Copies[Index]->Lock(RowPitchInBytes));
+                CopyAuxiliaryTexels(Readback.Texture->GetFormat(), Data, RowPitchInBytes, Readback.Size, *Readback.Face);
+                Copies[Index]->Unlock();
+            }
+
+            CompletionEvent->Trigger();
+        });
+
+        CompletionEvent->Wait();
+        FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+
+        OutLayers.RemoveAll([FaceCount, EyeCount](FCPUAuxiliaryLayer& Layer)
+        {
+            return !FinishAuxiliaryCubemap(Layer.Left, FaceCount) || (EyeCount > 1 && !FinishAuxiliaryCubemap(Layer.Right, FaceCount));
+        });
+    }
+
     FRDGTextureRef BuildFaceArray(FRDGBuilder& GraphBuilder, const TArray<FTextureRHIRef, TInlineAllocator<6>>& Faces, int32 FaceResolution, EPixelFormat PixelFormat, const TCHAR* DebugName)
     {
         if (Faces.Num() == 0)
@@ -597,7 +787,7 @@ namespace
         return ArrayTexture;
     }
 
-    void ConvertOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult)
+    void ConvertOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, EOmniCaptureReadbackMode ReadbackMode, FOmniCaptureEquirectResult& OutResult)
     {
         const int32 FaceResolution = Settings.Resolution;
         const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
@@ -741,121 +931,14 @@ namespace
             return;
         }
 
-        FRHIGPUTextureReadback Readback(TEXT("OmniEquirectReadback"));
-        Readback.EnqueueCopy(RHICmdList, OutputTextureRHI, FResolveRect(0, 0, OutputWidth, OutputHeight));
-        RHICmdList.SubmitCommandsAndFlushGPU();
-
-        while (!Readback.IsReady())
-        {
-            FPlatformProcess::SleepNoStats(0.001f);
-        }
-
-        const uint32 PixelCount = OutputWidth * OutputHeight;
         const uint32 BytesPerPixel = Precision == EOmniCapturePixelPrecision::FullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
-        int32 RowPitchInBytes = 0;
-        const uint8* RawData = static_cast<const uint8*>(Readback.Lock(RowPitchInBytes));
-
-        if (RawData)
-        {
-            const uint32 RowStrideInBytes = RowPitchInBytes > 0
-                ? static_cast<uint32>(RowPitchInBytes)
-                : static_cast<uint32>(OutputWidth * BytesPerPixel);
-            if (bUseLinear)
-            {
-                if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                {
-                    TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(FIntPoint(OutputWidth, OutputHeight));
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FLinearColor* DestData = PixelData->Pixels.GetData();
-                    for (int32 Row = 0; Row < OutputHeight; ++Row)
-                    {
-                        const uint8* SourceRowBytes = RawData + RowStrideInBytes * Row;
-                        const FLinearColor* SourceRow = reinterpret_cast<const FLinearColor*>(SourceRowBytes);
-                        FMemory::Memcpy(DestData + Row * OutputWidth, SourceRow, OutputWidth * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FLinearColor>* FloatData = static_cast<const TImagePixelData<FLinearColor>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            OutResult.PreviewPixels[Index] = FloatData->Pixels[Index].ToFColor(true);
-                        }
-                    }
-                }
-                else
-                {
-                    TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(FIntPoint(OutputWidth, OutputHeight));
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FFloat16Color* DestData = PixelData->Pixels.GetData();
-                    for (int32 Row = 0; Row < OutputHeight; ++Row)
-                    {
-                        const uint8* SourceRowBytes = RawData + RowStrideInBytes * Row;
-                        const FFloat16Color* SourceRow = reinterpret_cast<const FFloat16Color*>(SourceRowBytes);
-                        FMemory::Memcpy(DestData + Row * OutputWidth, SourceRow, OutputWidth * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            const FFloat16Color& Source = FloatData->Pixels[Index];
-                            const FLinearColor Linear(Source.R.GetFloat(), Source.G.GetFloat(), Source.B.GetFloat(), Source.A.GetFloat());
-                            OutResult.PreviewPixels[Index] = Linear.ToFColor(true);
-                        }
-                    }
-                }
-            }
-            else
-            {
-                TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(FIntPoint(OutputWidth, OutputHeight));
-                PixelData->Pixels.SetNum(PixelCount);
-                OutResult.PreviewPixels.SetNum(PixelCount);
-
-                for (int32 Row = 0; Row < OutputHeight; ++Row)
-                {
-                    const uint8* SourceRow = RawData + RowStrideInBytes * Row;
-                    FColor* DestRow = PixelData->Pixels.GetData() + Row * OutputWidth;
-                    for (int32 Column = 0; Column < OutputWidth; ++Column)
-                    {
-                        FLinearColor Linear;
-                        if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                        {
-                            const FLinearColor* Pixel = reinterpret_cast<const FLinearColor*>(SourceRow) + Column;
-                            Linear = *Pixel;
-                        }
-                        else
-                        {
-                            const FFloat16Color* Pixel = reinterpret_cast<const FFloat16Color*>(SourceRow) + Column;
-                            Linear = FLinearColor(Pixel->R.GetFloat(), Pixel->G.GetFloat(), Pixel->B.GetFloat(), Pixel->A.GetFloat());
-                        }
-                        const FColor SRGB = Linear.ToFColor(true);
-                        DestRow[Column] = SRGB;
-                        OutResult.PreviewPixels[Row * OutputWidth + Column] = SRGB;
-                    }
-                }
-
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
-            }
-        }
-
-        Readback.Unlock();
+        TUniquePtr<FOmniRHITextureReadback> Readback = MakeUnique<FOmniRHITextureReadback>(TEXT("OmniEquirectReadback"), BytesPerPixel);
+        Readback->EnqueueCopy(RHICmdList, OutputTextureRHI, FIntPoint(OutputWidth, OutputHeight));
         OutResult.PixelPrecision = Precision;
+        FinishReadback(RHICmdList, MoveTemp(Readback), ReadbackMode, OutResult);
     }
 
-    void ConvertFisheyeOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, FOmniCaptureEquirectResult& OutResult)
+    void ConvertFisheyeOnRenderThread(const FOmniCaptureSettings Settings, const TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces, const TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces, EOmniCaptureReadbackMode ReadbackMode, FOmniCaptureEquirectResult& OutResult)
     {
         const int32 FaceResolution = Settings.Resolution;
         const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
@@ -1012,143 +1095,36 @@ namespace
             return;
         }
 
-        FRHIGPUTextureReadback Readback(TEXT("OmniFisheyeReadback"));
-        Readback.EnqueueCopy(RHICmdList, OutputTextureRHI, FResolveRect(0, 0, OutputSize.X, OutputSize.Y));
-        RHICmdList.SubmitCommandsAndFlushGPU();
+        const uint32 BytesPerPixel = Precision == EOmniCapturePixelPrecision::FullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
+        TUniquePtr<FOmniRHITextureReadback> Readback = MakeUnique<FOmniRHITextureReadback>(TEXT("OmniFisheyeReadback"), BytesPerPixel);
+        Readback->EnqueueCopy(RHICmdList, OutputTextureRHI, OutputSize);
+        OutResult.PixelPrecision = Precision;
+        FinishReadback(RHICmdList, MoveTemp(Readback), ReadbackMode, OutResult);
+    }
+}
 
-        while (!Readback.IsReady())
+    void ConvertPlanarOnRenderThread(const FOmniCaptureSettings Settings, FTextureRHIRef SourceTexture, const FIntPoint OutputSize, bool bSourceLinear, FOmniCaptureEquirectResult& OutResult)
+    {
+        if (!SourceTexture.IsValid())
         {
-            FPlatformProcess::SleepNoStats(0.001f);
+            return;
         }
 
-        const uint32 PixelCount = OutputSize.X * OutputSize.Y;
-        const uint32 BytesPerPixel = Precision == EOmniCapturePixelPrecision::FullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
-        int32 RowPitchInBytes = 0;
-        const uint8* RawData = static_cast<const uint8*>(Readback.Lock(RowPitchInBytes));
+        const int32 OutputWidth = OutputSize.X;
+        const int32 OutputHeight = OutputSize.Y;
+
+        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
+        FRDGBuilder GraphBuilder(RHICmdList);
 
-        if (RawData)
+        EOmniCapturePixelPrecision Precision = PixelPrecisionFromFormat(SourceTexture->GetFormat());
+        if (Precision == EOmniCapturePixelPrecision::Unknown)
         {
-            const uint32 RowStrideInBytes = RowPitchInBytes > 0
-                ? static_cast<uint32>(RowPitchInBytes)
-                : static_cast<uint32>(OutputSize.X * BytesPerPixel);
-            if (bUseLinear)
-            {
-                if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                {
-                    TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(OutputSize);
-                    PixelData->Pixels.SetNum(PixelCount);
+            Precision = Settings.HDRPrecision == EOmniCaptureHDRPrecision::FullFloat
+                ? EOmniCapturePixelPrecision::FullFloat
+                : EOmniCapturePixelPrecision::HalfFloat;
+        }
 
-                    FLinearColor* DestData = PixelData->Pixels.GetData();
-                    for (int32 Row = 0; Row < OutputSize.Y; ++Row)
-                    {
-                        const uint8* SourceRowBytes = RawData + RowStrideInBytes * Row;
-                        const FLinearColor* SourceRow = reinterpret_cast<const FLinearColor*>(SourceRowBytes);
-                        FMemory::Memcpy(DestData + Row * OutputSize.X, SourceRow, OutputSize.X * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FLinearColor>* FloatData = static_cast<const TImagePixelData<FLinearColor>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            OutResult.PreviewPixels[Index] = FloatData->Pixels[Index].ToFColor(true);
-                        }
-                    }
-                }
-                else
-                {
-                    TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
-                    PixelData->Pixels.SetNum(PixelCount);
-
-                    FFloat16Color* DestData = PixelData->Pixels.GetData();
-                    for (int32 Row = 0; Row < OutputSize.Y; ++Row)
-                    {
-                        const uint8* SourceRowBytes = RawData + RowStrideInBytes * Row;
-                        const FFloat16Color* SourceRow = reinterpret_cast<const FFloat16Color*>(SourceRowBytes);
-                        FMemory::Memcpy(DestData + Row * OutputSize.X, SourceRow, OutputSize.X * BytesPerPixel);
-                    }
-
-                    OutResult.PixelData = MoveTemp(PixelData);
-                    OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
-
-                    OutResult.PreviewPixels.SetNum(PixelCount);
-                    const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(OutResult.PixelData.Get());
-                    if (FloatData)
-                    {
-                        for (uint32 Index = 0; Index < PixelCount; ++Index)
-                        {
-                            const FFloat16Color& Source = FloatData->Pixels[Index];
-                            const FLinearColor Linear(Source.R.GetFloat(), Source.G.GetFloat(), Source.B.GetFloat(), Source.A.GetFloat());
-                            OutResult.PreviewPixels[Index] = Linear.ToFColor(true);
-                        }
-                    }
-                }
-            }
-            else
-            {
-                TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(OutputSize);
-                PixelData->Pixels.SetNum(PixelCount);
-                OutResult.PreviewPixels.SetNum(PixelCount);
-
-                for (int32 Row = 0; Row < OutputSize.Y; ++Row)
-                {
-                    const uint8* SourceRow = RawData + RowStrideInBytes * Row;
-                    FColor* DestRow = PixelData->Pixels.GetData() + Row * OutputSize.X;
-                    for (int32 Column = 0; Column < OutputSize.X; ++Column)
-                    {
-                        FLinearColor Linear;
-                        if (Precision == EOmniCapturePixelPrecision::FullFloat)
-                        {
-                            const FLinearColor* Pixel = reinterpret_cast<const FLinearColor*>(SourceRow) + Column;
-                            Linear = *Pixel;
-                        }
-                        else
-                        {
-                            const FFloat16Color* Pixel = reinterpret_cast<const FFloat16Color*>(SourceRow) + Column;
-                            Linear = FLinearColor(Pixel->R.GetFloat(), Pixel->G.GetFloat(), Pixel->B.GetFloat(), Pixel->A.GetFloat());
-                        }
-                        const FColor SRGB = Linear.ToFColor(true);
-                        DestRow[Column] = SRGB;
-                        OutResult.PreviewPixels[Row * OutputSize.X + Column] = SRGB;
-                    }
-                }
-
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
-            }
-        }
-
-        Readback.Unlock();
-        OutResult.PixelPrecision = Precision;
-    }
-}
-
-    void ConvertPlanarOnRenderThread(const FOmniCaptureSettings Settings, FTextureRHIRef SourceTexture, const FIntPoint OutputSize, bool bSourceLinear, FOmniCaptureEquirectResult& OutResult)
-    {
-        if (!SourceTexture.IsValid())
-        {
-            return;
-        }
-
-        const int32 OutputWidth = OutputSize.X;
-        const int32 OutputHeight = OutputSize.Y;
-
-        FRHICommandListImmediate& RHICmdList = FRHICommandListExecutor::GetImmediateCommandList();
-        FRDGBuilder GraphBuilder(RHICmdList);
-
-        EOmniCapturePixelPrecision Precision = PixelPrecisionFromFormat(SourceTexture->GetFormat());
-        if (Precision == EOmniCapturePixelPrecision::Unknown)
-        {
-            Precision = Settings.HDRPrecision == EOmniCaptureHDRPrecision::FullFloat
-                ? EOmniCapturePixelPrecision::FullFloat
-                : EOmniCapturePixelPrecision::HalfFloat;
-        }
-
-        FRDGTextureRef Source = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(SourceTexture, TEXT("OmniPlanarSource")));
+        FRDGTextureRef Source = GraphBuilder.RegisterExternalTexture(CreateRenderTarget(SourceTexture, TEXT("OmniPlanarSource")));
 
         FRDGTextureRef LumaTexture = nullptr;
         FRDGTextureRef ChromaTexture = nullptr;
@@ -1236,130 +1212,152 @@ namespace
 
 namespace
 {
-    void ConvertOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
+    enum class EProjectionKind : uint8
     {
-        FCPUCubemap LeftCubemap;
-        if (!BuildCPUCubemap(LeftEye, LeftCubemap))
+        Equirect,
+        Fisheye
+    };
+
+    // The output a CPU gather fills and the LUT its pixels are resolved through.
+    struct FCPUProjection
+    {
+        TSharedPtr<const FOmniCaptureProjectionLUT> LUT;
+        FIntPoint OutputSize = FIntPoint::ZeroValue;
+        bool bStereo = false;
+        bool bSideBySide = false;
+    };
+
+    FCPUProjection MakeCPUProjection(const FOmniCaptureSettings& Settings, EProjectionKind Kind, int32 FaceResolution)
+    {
+        FCPUProjection Projection;
+        Projection.bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+        Projection.bSideBySide = Projection.bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
+
+        if (Kind == EProjectionKind::Fisheye)
         {
-            return;
+            const FIntPoint EyeSize = Settings.GetFisheyeResolution();
+            Projection.OutputSize = Settings.GetOutputResolution();
+            Projection.LUT = FOmniCaptureProjectionLUT::FindOrBuild(
+                FOmniCaptureProjectionKey::MakeFisheye(Settings, FaceResolution, FIntPoint(FMath::Max(1, EyeSize.X), FMath::Max(1, EyeSize.Y))));
         }
-
-        FCPUCubemap RightCubemap;
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
+        else
         {
-            if (!BuildCPUCubemap(RightEye, RightCubemap))
-            {
-                return;
-            }
+            Projection.OutputSize = Settings.GetEquirectResolution();
+            const int32 EyeWidth = Projection.bSideBySide ? Projection.OutputSize.X / 2 : Projection.OutputSize.X;
+            const int32 EyeHeight = (Projection.bStereo && !Projection.bSideBySide) ? Projection.OutputSize.Y / 2 : Projection.OutputSize.Y;
+            Projection.LUT = FOmniCaptureProjectionLUT::FindOrBuild(
+                FOmniCaptureProjectionKey::MakeEquirect(Settings, FaceResolution, FIntPoint(EyeWidth, EyeHeight)));
         }
 
-        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
-        const bool bSideBySide = bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
-        const int32 FaceResolution = LeftCubemap.Faces[0].Resolution;
-        const FIntPoint OutputSize = Settings.GetEquirectResolution();
-        const int32 OutputWidth = OutputSize.X;
-        const int32 OutputHeight = OutputSize.Y;
-        const double LongitudeSpan = Settings.GetLongitudeSpanRadians();
-        const double LatitudeSpan = Settings.GetLatitudeSpanRadians();
-        const bool bHalfSphere = Settings.IsVR180();
+        return Projection;
+    }
 
-        OutResult.Size = FIntPoint(OutputWidth, OutputHeight);
-        OutResult.bIsLinear = Settings.Gamma == EOmniCaptureGamma::Linear;
-        OutResult.bUsedCPUFallback = true;
-        OutResult.OutputTarget.SafeRelease();
-        OutResult.Texture.SafeRelease();
-        OutResult.ReadyFence.SafeRelease();
-        OutResult.EncoderPlanes.Reset();
+    template <typename PixelType>
+    void* AcquireLayerPixels(const FIntPoint& Size, TUniquePtr<FImagePixelData>& OutPixelData)
+    {
+        TUniquePtr<TImagePixelData<PixelType>> PixelData = FOmniCaptureFramePool::Get().Acquire<PixelType>(Size);
+        void* Pixels = PixelData->Pixels.GetData();
+        OutPixelData = MoveTemp(PixelData);
+        return Pixels;
+    }
 
-        const int32 PixelCount = OutputWidth * OutputHeight;
-        OutResult.PreviewPixels.SetNum(PixelCount);
-        OutResult.PixelPrecision = LeftCubemap.Precision;
+    // Takes pooled pixels of PixelDataType for a layer and returns where the gather writes them.
+    void* AcquireLayerPixels(EOmniCapturePixelDataType PixelDataType, const FIntPoint& Size, TUniquePtr<FImagePixelData>& OutPixelData)
+    {
+        switch (PixelDataType)
+        {
+        case EOmniCapturePixelDataType::LinearColorFloat32:
+            return AcquireLayerPixels<FLinearColor>(Size, OutPixelData);
+        case EOmniCapturePixelDataType::LinearColorFloat16:
+            return AcquireLayerPixels<FFloat16Color>(Size, OutPixelData);
+        case EOmniCapturePixelDataType::Color8:
+            return AcquireLayerPixels<FColor>(Size, OutPixelData);
+        case EOmniCapturePixelDataType::ScalarFloat32:
+            return AcquireLayerPixels<float>(Size, OutPixelData);
+        case EOmniCapturePixelDataType::Vector2Float32:
+            return AcquireLayerPixels<FVector2f>(Size, OutPixelData);
+        default:
+            return nullptr;
+        }
+    }
 
-        auto ProcessPixel = [&](auto& PixelArray, auto ConvertColor)
+    // Depth, roughness and occlusion are single values and motion vectors two; the other passes are colours in the
+    // precision they were rendered in. Every layer is linear data, whatever gamma the beauty pass is encoded with.
+    FOmniCaptureLayerPayload MakeAuxiliaryPayload(const FCPUAuxiliaryLayer& Layer)
+    {
+        FOmniCaptureLayerPayload Payload;
+        Payload.bLinear = true;
+        Payload.Precision = EOmniCapturePixelPrecision::FullFloat;
+        switch (Layer.PassType)
+        {
+        case EOmniCaptureAuxiliaryPassType::SceneDepth:
+        case EOmniCaptureAuxiliaryPassType::Roughness:
+        case EOmniCaptureAuxiliaryPassType::AmbientOcclusion:
+            Payload.PixelDataType = EOmniCapturePixelDataType::ScalarFloat32;
+            break;
+        case EOmniCaptureAuxiliaryPassType::MotionVector:
+            Payload.PixelDataType = EOmniCapturePixelDataType::Vector2Float32;
+            break;
+        default:
+            Payload.Precision = Layer.Left.Precision;
+            Payload.PixelDataType = Payload.Precision == EOmniCapturePixelPrecision::FullFloat
+                ? EOmniCapturePixelDataType::LinearColorFloat32
+                : EOmniCapturePixelDataType::LinearColorFloat16;
+            break;
+        }
+        return Payload;
+    }
+
+    // Adds a gather layer, and its pooled payload in OutResult, for every auxiliary pass rendered at FaceResolution;
+    // the LUT's texel coordinates only fit faces of the resolution it was built for, so other layers are left to
+    // ConvertAuxiliaryLayersOnCPU.
+    void AddAuxiliaryGatherLayers(TConstArrayView<FCPUAuxiliaryLayer> AuxiliaryLayers, int32 FaceResolution, const FIntPoint& OutputSize, FOmniCaptureEquirectResult& OutResult, TArray<FCPUGatherLayer, TInlineAllocator<8>>& OutGatherLayers)
+    {
+        for (const FCPUAuxiliaryLayer& Layer : AuxiliaryLayers)
         {
-            for (int32 Y = 0; Y < OutputHeight; ++Y)
+            if (Layer.Left.GetResolution() != FaceResolution)
             {
-                for (int32 X = 0; X < OutputWidth; ++X)
-                {
-                    const int32 Index = Y * OutputWidth + X;
-
-                    FIntPoint EyePixel(X, Y);
-                    FIntPoint EyeResolution(OutputWidth, OutputHeight);
-                    bool bRightEye = false;
-
-                    if (bStereo)
-                    {
-                        if (bSideBySide)
-                        {
-                            const int32 EyeWidth = OutputWidth / 2;
-                            bRightEye = X >= EyeWidth;
-                            EyePixel.X = X % EyeWidth;
-                            EyeResolution = FIntPoint(EyeWidth, OutputHeight);
-                        }
-                        else
-                        {
-                            const int32 EyeHeight = OutputHeight / 2;
-                            bRightEye = Y >= EyeHeight;
-                            EyePixel.Y = Y % EyeHeight;
-                            EyeResolution = FIntPoint(OutputWidth, EyeHeight);
-                        }
-                    }
-
-                    float Latitude = 0.0f;
-                    FVector Direction = DirectionFromEquirectPixelCPU(EyePixel, EyeResolution, LongitudeSpan, LatitudeSpan, Latitude);
-                    ApplyPolarMitigation(Settings.PolarDampening, Latitude, Direction);
-
-                    if (bHalfSphere && Direction.X < 0.0f)
-                    {
-                        PixelArray[Index] = ConvertColor(FLinearColor::Transparent);
-                        OutResult.PreviewPixels[Index] = FColor::Transparent;
-                        continue;
-                    }
-
-                    const FLinearColor LinearColor = SampleCubemapCPU(
-                        (bStereo && bRightEye) ? RightCubemap : LeftCubemap,
-                        Direction,
-                        FaceResolution,
-                        Settings.SeamBlend);
-
-                    PixelArray[Index] = ConvertColor(LinearColor);
-                    OutResult.PreviewPixels[Index] = LinearColor.ToFColor(true);
-                }
+                continue;
             }
-        };
 
-        if (OutResult.bIsLinear)
+            FOmniCaptureLayerPayload Payload = MakeAuxiliaryPayload(Layer);
+            FCPUGatherLayer& GatherLayer = OutGatherLayers.AddDefaulted_GetRef();
+            GatherLayer.Left = &Layer.Left;
+            GatherLayer.Right = &Layer.Right;
+            GatherLayer.PixelDataType = Payload.PixelDataType;
+            GatherLayer.Pixels = AcquireLayerPixels(Payload.PixelDataType, OutputSize, Payload.PixelData);
+            OutResult.AuxiliaryLayers.Add(Layer.PassType, MoveTemp(Payload));
+        }
+    }
+
+    // Resolves the auxiliary layers on the CPU, one gather per face resolution, skipping those at ConvertedResolution.
+    // Used for frames whose beauty pass the GPU already converted, and for layers that do not match the beauty faces.
+    void ConvertAuxiliaryLayersOnCPU(const FOmniCaptureSettings& Settings, EProjectionKind Kind, TConstArrayView<FCPUAuxiliaryLayer> AuxiliaryLayers, int32 ConvertedResolution, FOmniCaptureEquirectResult& OutResult)
+    {
+        TArray<int32, TInlineAllocator<4>> FaceResolutions;
+        for (const FCPUAuxiliaryLayer& Layer : AuxiliaryLayers)
         {
-            if (OutResult.PixelPrecision == EOmniCapturePixelPrecision::FullFloat)
+            if (Layer.Left.GetResolution() != ConvertedResolution)
             {
-                TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(OutResult.Size);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear; });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-            }
-            else
-            {
-                OutResult.PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
-                TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutResult.Size);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return FFloat16Color(Linear); });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+                FaceResolutions.AddUnique(Layer.Left.GetResolution());
             }
         }
-        else
+
+        for (const int32 FaceResolution : FaceResolutions)
         {
-            TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(OutResult.Size);
-            PixelData->Pixels.SetNum(PixelCount);
-            ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear.ToFColor(true); });
-            OutResult.PixelData = MoveTemp(PixelData);
-            OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+            const FCPUProjection Projection = MakeCPUProjection(Settings, Kind, FaceResolution);
+
+            TArray<FCPUGatherLayer, TInlineAllocator<8>> GatherLayers;
+            AddAuxiliaryGatherLayers(AuxiliaryLayers, FaceResolution, Projection.OutputSize, OutResult, GatherLayers);
+            GatherLayersCPU(*Projection.LUT, GatherLayers, Projection.bStereo, Projection.bSideBySide, Projection.OutputSize);
         }
     }
 
-    void ConvertFisheyeOnCPU(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, FOmniCaptureEquirectResult& OutResult)
+    // Resolves the beauty pass and every auxiliary layer on the CPU in one tiled pass over the projection.
+    void ConvertOnCPU(const FOmniCaptureSettings& Settings, EProjectionKind Kind, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TConstArrayView<FCPUAuxiliaryLayer> AuxiliaryLayers, FOmniCaptureEquirectResult& OutResult)
     {
+        const double ConversionStartSeconds = FPlatformTime::Seconds();
+
         FCPUCubemap LeftCubemap;
         if (!BuildCPUCubemap(LeftEye, LeftCubemap))
         {
@@ -1375,15 +1373,10 @@ namespace
             }
         }
 
-        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
-        const bool bSideBySide = bStereo && Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide;
-        const int32 FaceResolution = LeftCubemap.Faces[0].Resolution;
-        const FIntPoint OutputSize = Settings.GetOutputResolution();
-        const FIntPoint EyeSize = Settings.GetFisheyeResolution();
-        const bool bHalfSphere = Settings.IsVR180();
-        const double FovRadians = FMath::DegreesToRadians(FMath::Clamp(Settings.FisheyeFOV, 0.0f, 360.0f));
+        const int32 FaceResolution = LeftCubemap.GetResolution();
+        const FCPUProjection Projection = MakeCPUProjection(Settings, Kind, FaceResolution);
 
-        OutResult.Size = OutputSize;
+        OutResult.Size = Projection.OutputSize;
         OutResult.bIsLinear = Settings.Gamma == EOmniCaptureGamma::Linear;
         OutResult.bUsedCPUFallback = true;
         OutResult.OutputTarget.SafeRelease();
@@ -1391,262 +1384,416 @@ namespace
         OutResult.ReadyFence.SafeRelease();
         OutResult.EncoderPlanes.Reset();
 
-        const int32 PixelCount = OutputSize.X * OutputSize.Y;
-        OutResult.PreviewPixels.SetNum(PixelCount);
         OutResult.PixelPrecision = LeftCubemap.Precision;
+        if (!OutResult.bIsLinear)
+        {
+            OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+        }
+        else if (OutResult.PixelPrecision == EOmniCapturePixelPrecision::FullFloat)
+        {
+            OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
+        }
+        else
+        {
+            OutResult.PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
+            OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+        }
+
+        TArray<FCPUGatherLayer, TInlineAllocator<8>> GatherLayers;
+        FCPUGatherLayer& BeautyLayer = GatherLayers.AddDefaulted_GetRef();
+        BeautyLayer.Left = &LeftCubemap;
+        BeautyLayer.Right = &RightCubemap;
+        BeautyLayer.PixelDataType = OutResult.PixelDataType;
+        BeautyLayer.Pixels = AcquireLayerPixels(OutResult.PixelDataType, OutResult.Size, OutResult.PixelData);
+
+        AddAuxiliaryGatherLayers(AuxiliaryLayers, FaceResolution, OutResult.Size, OutResult, GatherLayers);
+        GatherLayersCPU(*Projection.LUT, GatherLayers, Projection.bStereo, Projection.bSideBySide, OutResult.Size);
 
-        auto ProcessPixel = [&](auto& PixelArray, auto ConvertColor)
+        // Layers rendered at another face size cannot share the beauty LUT; they get a projection of their own.
+        bool bHasMismatchedLayers = false;
+        for (const FCPUAuxiliaryLayer& Layer : AuxiliaryLayers)
+        {
+            bHasMismatchedLayers |= Layer.Left.GetResolution() != FaceResolution;
+        }
+        if (bHasMismatchedLayers)
         {
-            for (int32 Y = 0; Y < OutputSize.Y; ++Y)
+            static TAtomic<bool> bLoggedMismatch(false);
+            if (!bLoggedMismatch.Exchange(true))
             {
-                for (int32 X = 0; X < OutputSize.X; ++X)
-                {
-                    const int32 Index = Y * OutputSize.X + X;
-
-                    FIntPoint EyePixel(X, Y);
-                    FIntPoint EyeResolution = EyeSize;
-                    bool bRightEye = false;
+                UE_LOG(LogOmniCaptureEquirect, Warning, TEXT("Auxiliary layers differ from the %d px beauty faces and are converted separately, which costs an extra projection per frame."), FaceResolution);
+            }
+            ConvertAuxiliaryLayersOnCPU(Settings, Kind, AuxiliaryLayers, FaceResolution, OutResult);
+        }
 
-                    if (bStereo)
-                    {
-                        if (bSideBySide)
-                        {
-                            const int32 EyeWidth = FMath::Max(1, EyeSize.X);
-                            bRightEye = X >= EyeWidth;
-                            EyePixel.X = X % EyeWidth;
-                            EyeResolution = FIntPoint(EyeWidth, EyeSize.Y);
-                        }
-                        else
-                        {
-                            const int32 EyeHeight = FMath::Max(1, EyeSize.Y);
-                            bRightEye = Y >= EyeHeight;
-                            EyePixel.Y = Y % EyeHeight;
-                            EyeResolution = FIntPoint(EyeSize.X, EyeHeight);
-                        }
-                    }
+        OutResult.ConversionMilliseconds = (FPlatformTime::Seconds() - ConversionStartSeconds) * 1000.0;
+    }
 
-                    bool bValid = false;
-                    FVector Direction = DirectionFromFisheyePixelCPU(EyePixel, EyeResolution, FovRadians, bValid);
-                    if (!bValid)
-                    {
-                        PixelArray[Index] = ConvertColor(FLinearColor::Transparent);
-                        OutResult.PreviewPixels[Index] = FColor::Transparent;
-                        continue;
-                    }
 
-                    if (bHalfSphere && Direction.X < 0.0f)
-                    {
-                        PixelArray[Index] = ConvertColor(FLinearColor::Transparent);
-                        OutResult.PreviewPixels[Index] = FColor::Transparent;
-                        continue;
-                    }
+    FORCEINLINE FLinearColor PlanarTexelToLinear(const FLinearColor& Texel) { return Texel; }
+    FORCEINLINE FLinearColor PlanarTexelToLinear(const FFloat16Color& Texel) { return FLinearColor(Texel); }
+    FORCEINLINE FLinearColor PlanarTexelToLinear(float Texel) { return FLinearColor(Texel, Texel, Texel, Texel); }
 
-                    const FLinearColor LinearColor = SampleCubemapCPU(
-                        (bStereo && bRightEye) ? RightCubemap : LeftCubemap,
-                        Direction,
-                        FaceResolution,
-                        Settings.SeamBlend);
+    FORCEINLINE void StorePlanarPixel(const FLinearColor& Color, FLinearColor& OutPixel) { OutPixel = Color; }
+    FORCEINLINE void StorePlanarPixel(const FLinearColor& Color, FFloat16Color& OutPixel) { OutPixel = FFloat16Color(Color); }
+    FORCEINLINE void StorePlanarPixel(const FLinearColor& Color, float& OutPixel) { OutPixel = Color.R; }
+    FORCEINLINE void StorePlanarPixel(const FLinearColor& Color, FVector2f& OutPixel) { OutPixel = FVector2f(Color.R, Color.G); }
 
-                    PixelArray[Index] = ConvertColor(LinearColor);
-                    OutResult.PreviewPixels[Index] = LinearColor.ToFColor(true);
-                }
+    template <typename PixelType>
+    void CopyPlanarFace(const FCPUFaceData& Face, PixelType* OutPixels)
+    {
+        const int32 PixelCount = Face.GetPixelCount();
+        auto CopyTexels = [PixelCount, OutPixels](const auto* Texels)
+        {
+            for (int32 Index = 0; Index < PixelCount; ++Index)
+            {
+                StorePlanarPixel(PlanarTexelToLinear(Texels[Index]), OutPixels[Index]);
             }
         };
 
-        if (OutResult.bIsLinear)
+        if (Face.bScalar)
         {
-            if (OutResult.PixelPrecision == EOmniCapturePixelPrecision::FullFloat)
-            {
-                TUniquePtr<TImagePixelData<FLinearColor>> PixelData = MakeUnique<TImagePixelData<FLinearColor>>(OutputSize);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear; });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
-            }
-            else
-            {
-                OutResult.PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
-                TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
-                PixelData->Pixels.SetNum(PixelCount);
-                ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return FFloat16Color(Linear); });
-                OutResult.PixelData = MoveTemp(PixelData);
-                OutResult.PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
-            }
+            CopyTexels(Face.ScalarPixels.GetData());
+        }
+        else if (Face.Precision == EOmniCapturePixelPrecision::FullFloat)
+        {
+            CopyTexels(Face.FullPixels.GetData());
         }
         else
         {
-            TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(OutputSize);
-            PixelData->Pixels.SetNum(PixelCount);
-            ProcessPixel(PixelData->Pixels, [](const FLinearColor& Linear) { return Linear.ToFColor(true); });
-            OutResult.PixelData = MoveTemp(PixelData);
-            OutResult.PixelDataType = EOmniCapturePixelDataType::Color8;
+            CopyTexels(Face.HalfPixels.GetData());
         }
     }
-}
 
-FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
-{
-    FOmniCaptureEquirectResult Result;
-
-    if (Settings.Resolution <= 0)
+    // Planar captures have no projection to resolve: each auxiliary target is its layer, in the layer's format.
+    void CopyPlanarLayers(TConstArrayView<FCPUAuxiliaryLayer> AuxiliaryLayers, FOmniCaptureEquirectResult& OutResult)
     {
-        return Result;
-    }
-
-    TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces;
-    TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces;
-
-    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
-    {
-        if (UTextureRenderTarget2D* LeftTarget = LeftEye.Faces[FaceIndex].RenderTarget)
+        for (const FCPUAuxiliaryLayer& Layer : AuxiliaryLayers)
         {
-            if (FTextureRenderTargetResource* Resource = LeftTarget->GameThread_GetRenderTargetResource())
+            const FCPUFaceData& Face = Layer.Left.Faces[0];
+            FOmniCaptureLayerPayload Payload = MakeAuxiliaryPayload(Layer);
+            void* Pixels = AcquireLayerPixels(Payload.PixelDataType, Face.Size, Payload.PixelData);
+            switch (Payload.PixelDataType)
             {
-                if (FTextureRHIRef Texture = Resource->GetTextureRHI())
-                {
-                    LeftFaces.Add(Texture);
-                }
+            case EOmniCapturePixelDataType::LinearColorFloat32:
+                CopyPlanarFace(Face, static_cast<FLinearColor*>(Pixels));
+                break;
+            case EOmniCapturePixelDataType::LinearColorFloat16:
+                CopyPlanarFace(Face, static_cast<FFloat16Color*>(Pixels));
+                break;
+            case EOmniCapturePixelDataType::ScalarFloat32:
+                CopyPlanarFace(Face, static_cast<float*>(Pixels));
+                break;
+            case EOmniCapturePixelDataType::Vector2Float32:
+                CopyPlanarFace(Face, static_cast<FVector2f*>(Pixels));
+                break;
+            default:
+                continue;
             }
+            OutResult.AuxiliaryLayers.Add(Layer.PassType, MoveTemp(Payload));
         }
+    }
 
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
+    bool SupportsComputeConversion()
+    {
+        bool bSupportsCompute = GDynamicRHI != nullptr;
+#if defined(GRHISupportsComputeShaders)
+        bSupportsCompute = bSupportsCompute && GRHISupportsComputeShaders;
+#elif defined(GSupportsComputeShaders)
+        bSupportsCompute = bSupportsCompute && GSupportsComputeShaders;
+#else
+        bSupportsCompute = false;
+#endif
+        return bSupportsCompute;
+    }
+
+    using FFaceTextures = TArray<FTextureRHIRef, TInlineAllocator<6>>;
+
+    // Adds the eye's face textures of the beauty pass (PassType None) or of an auxiliary pass. Fewer than six means
+    // the eye is incomplete.
+    void CollectFaceTextures(const FOmniEyeCapture& Eye, EOmniCaptureAuxiliaryPassType PassType, FFaceTextures& OutFaces)
+    {
+        for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
         {
-            if (UTextureRenderTarget2D* RightTarget = RightEye.Faces[FaceIndex].RenderTarget)
+            UTextureRenderTarget2D* Target = PassType == EOmniCaptureAuxiliaryPassType::None
+                ? Eye.Faces[FaceIndex].RenderTarget
+                : Eye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType);
+            if (Target)
             {
-                if (FTextureRenderTargetResource* Resource = RightTarget->GameThread_GetRenderTargetResource())
+                if (FTextureRenderTargetResource* Resource = Target->GameThread_GetRenderTargetResource())
                 {
                     if (FTextureRHIRef Texture = Resource->GetTextureRHI())
                     {
-                        RightFaces.Add(Texture);
+                        OutFaces.Add(Texture);
                     }
                 }
             }
         }
     }
 
-    if (LeftFaces.Num() != 6)
+    void ProjectOnRenderThread(const FOmniCaptureSettings& Settings, EProjectionKind Kind, const FFaceTextures& LeftFaces, const FFaceTextures& RightFaces, EOmniCaptureReadbackMode ReadbackMode, FOmniCaptureEquirectResult& OutResult)
     {
-        return Result;
+        if (Kind == EProjectionKind::Fisheye)
+        {
+            ConvertFisheyeOnRenderThread(Settings, LeftFaces, RightFaces.Num() > 0 ? RightFaces : LeftFaces, ReadbackMode, OutResult);
+        }
+        else
+        {
+            ConvertOnRenderThread(Settings, LeftFaces, RightFaces, ReadbackMode, OutResult);
+        }
     }
 
-    if (Settings.Mode == EOmniCaptureMode::Stereo && RightFaces.Num() != 6)
+    // Converts the beauty pass on the GPU when it can, falling back to the CPU gather, which then resolves the
+    // auxiliary layers in the same pass. The auxiliary layers passed in of a GPU-converted frame are gathered on the
+    // CPU from their batched readback. A deferred GPU conversion is only returned, for the caller to run on the render
+    // thread behind its own work.
+    FOmniCaptureEquirectResult ConvertProjection(const FOmniCaptureSettings& Settings, EProjectionKind Kind, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, EOmniCaptureReadbackMode ReadbackMode, TConstArrayView<FCPUAuxiliaryLayer> AuxiliaryLayers)
     {
-        return Result;
-    }
+        FOmniCaptureEquirectResult Result;
 
-    bool bSupportsCompute = GDynamicRHI != nullptr;
-#if defined(GRHISupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GRHISupportsComputeShaders;
-#elif defined(GSupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GSupportsComputeShaders;
-#else
-    bSupportsCompute = false;
-#endif
-    if (!bSupportsCompute)
-    {
-        ConvertOnCPU(Settings, LeftEye, RightEye, Result);
-        return Result;
-    }
+        if (Settings.Resolution <= 0)
+        {
+            return Result;
+        }
 
-    FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
+        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+        FFaceTextures LeftFaces;
+        FFaceTextures RightFaces;
+        CollectFaceTextures(LeftEye, EOmniCaptureAuxiliaryPassType::None, LeftFaces);
+        if (bStereo)
+        {
+            CollectFaceTextures(RightEye, EOmniCaptureAuxiliaryPassType::None, RightFaces);
+        }
 
-    ENQUEUE_RENDER_COMMAND(OmniCaptureEquirect)([Settings, LeftFaces, RightFaces, &Result, CompletionEvent](FRHICommandListImmediate&)
-    {
-        ConvertOnRenderThread(Settings, LeftFaces, RightFaces, Result);
-        CompletionEvent->Trigger();
-    });
+        if (LeftFaces.Num() != 6)
+        {
+            return Result;
+        }
 
-    CompletionEvent->Wait();
-    FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+        if (bStereo && RightFaces.Num() != 6)
+        {
+            return Result;
+        }
 
-    if (!Result.PixelData.IsValid() && (!Result.Texture.IsValid() || !Result.OutputTarget.IsValid()))
-    {
-        ConvertOnCPU(Settings, LeftEye, RightEye, Result);
-    }
+        if (SupportsComputeConversion() && ReadbackMode == EOmniCaptureReadbackMode::Deferred)
+        {
+            Result.DeferredConversion = [Settings, Kind, LeftFaces, RightFaces](FOmniCaptureEquirectResult& OutResult)
+            {
+                ProjectOnRenderThread(Settings, Kind, LeftFaces, RightFaces, EOmniCaptureReadbackMode::Deferred, OutResult);
+            };
+            ConvertAuxiliaryLayersOnCPU(Settings, Kind, AuxiliaryLayers, INDEX_NONE, Result);
+            return Result;
+        }
 
-    return Result;
-}
+        if (SupportsComputeConversion())
+        {
+            FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
+            ENQUEUE_RENDER_COMMAND(OmniCaptureProjection)([&Settings, Kind, &LeftFaces, &RightFaces, ReadbackMode, &Result, CompletionEvent](FRHICommandListImmediate&)
+            {
+                ProjectOnRenderThread(Settings, Kind, LeftFaces, RightFaces, ReadbackMode, Result);
+                CompletionEvent->Trigger();
+            });
 
-FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToFisheye(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye)
-{
-    FOmniCaptureEquirectResult Result;
+            CompletionEvent->Wait();
+            FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+        }
+
+        if (!Result.PixelData.IsValid() && (!Result.Texture.IsValid() || !Result.OutputTarget.IsValid()))
+        {
+            ConvertOnCPU(Settings, Kind, LeftEye, RightEye, AuxiliaryLayers, Result);
+        }
+        else
+        {
+            ConvertAuxiliaryLayersOnCPU(Settings, Kind, AuxiliaryLayers, INDEX_NONE, Result);
+        }
 
-    if (!Settings.IsFisheye() || Settings.Resolution <= 0)
-    {
         return Result;
     }
 
-    TArray<FTextureRHIRef, TInlineAllocator<6>> LeftFaces;
-    TArray<FTextureRHIRef, TInlineAllocator<6>> RightFaces;
+    // An auxiliary colour pass projected by the same compute shader as the beauty pass.
+    struct FGPUAuxiliaryLayer
+    {
+        EOmniCaptureAuxiliaryPassType PassType = EOmniCaptureAuxiliaryPassType::None;
+        FFaceTextures LeftFaces;
+        FFaceTextures RightFaces;
+        FOmniCaptureEquirectResult Result;
+    };
 
-    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    // Normals and base colour are colours the projection shader writes as they are. Depth, roughness, occlusion and
+    // motion stay on the CPU gather, which writes them as one or two floats rather than as a colour. The faces also
+    // have to be float RGBA at the beauty resolution, which is what the shader's face array is built from.
+    bool TryAddGPUAuxiliaryLayer(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, EOmniCaptureAuxiliaryPassType PassType, TArray<FGPUAuxiliaryLayer>& OutLayers)
     {
-        if (UTextureRenderTarget2D* LeftTarget = LeftEye.Faces[FaceIndex].RenderTarget)
+        if (PassType != EOmniCaptureAuxiliaryPassType::WorldNormal && PassType != EOmniCaptureAuxiliaryPassType::BaseColor)
         {
-            if (FTextureRenderTargetResource* Resource = LeftTarget->GameThread_GetRenderTargetResource())
-            {
-                if (FTextureRHIRef Texture = Resource->GetTextureRHI())
-                {
-                    LeftFaces.Add(Texture);
-                }
-            }
+            return false;
         }
 
-        if (Settings.Mode == EOmniCaptureMode::Stereo)
+        const bool bStereo = Settings.Mode == EOmniCaptureMode::Stereo;
+        FGPUAuxiliaryLayer Layer;
+        Layer.PassType = PassType;
+        CollectFaceTextures(LeftEye, PassType, Layer.LeftFaces);
+        if (bStereo)
+        {
+            CollectFaceTextures(RightEye, PassType, Layer.RightFaces);
+        }
+        if (Layer.LeftFaces.Num() != 6 || (bStereo && Layer.RightFaces.Num() != 6))
+        {
+            return false;
+        }
+
+        const EPixelFormat Format = Layer.LeftFaces[0]->GetFormat();
+        auto IsConvertible = [&Settings, Format](const FTextureRHIRef& Texture)
+        {
+            return Texture->GetFormat() == Format && Texture->GetDesc().Extent == FIntPoint(Settings.Resolution, Settings.Resolution);
+        };
+        if (PixelPrecisionFromFormat(Format) == EOmniCapturePixelPrecision::Unknown
+            || !Algo::AllOf(Layer.LeftFaces, IsConvertible)
+            || !Algo::AllOf(Layer.RightFaces, IsConvertible))
         {
-            if (UTextureRenderTarget2D* RightTarget = RightEye.Faces[FaceIndex].RenderTarget)
+            return false;
+        }
+
+        OutLayers.Add(MoveTemp(Layer));
+        return true;
+    }
+
+    // Projects the layers on the GPU in one render command, each with its own dispatch and blocking readback, and
+    // adds their payloads to OutResult. Passes the GPU could not convert are returned in OutFailedPasses. Deferred,
+    // the layers are projected after the beauty pass in OutResult's DeferredConversion and copied back with it.
+    void ConvertAuxiliaryLayersOnGPU(const FOmniCaptureSettings& Settings, EProjectionKind Kind, TArray<FGPUAuxiliaryLayer>& Layers, EOmniCaptureReadbackMode ReadbackMode, FOmniCaptureEquirectResult& OutResult, TArray<EOmniCaptureAuxiliaryPassType, TInlineAllocator<8>>& OutFailedPasses)
+    {
+        // Every layer is linear data whatever the beauty gamma, and none of them feeds the encoder.
+        FOmniCaptureSettings LayerSettings = Settings;
+        LayerSettings.Gamma = EOmniCaptureGamma::Linear;
+        LayerSettings.OutputFormat = EOmniOutputFormat::ImageSequence;
+
+        if (ReadbackMode == EOmniCaptureReadbackMode::Deferred)
+        {
+            OutResult.DeferredConversion = [ConvertBeauty = MoveTemp(OutResult.DeferredConversion), LayerSettings, Kind, Layers = MoveTemp(Layers)](FOmniCaptureEquirectResult& DeferredResult) mutable
             {
-                if (FTextureRenderTargetResource* Resource = RightTarget->GameThread_GetRenderTargetResource())
+                if (ConvertBeauty)
                 {
-                    if (FTextureRHIRef Texture = Resource->GetTextureRHI())
+                    ConvertBeauty(DeferredResult);
+                }
+                for (FGPUAuxiliaryLayer& Layer : Layers)
+                {
+                    ProjectOnRenderThread(LayerSettings, Kind, Layer.LeftFaces, Layer.RightFaces, EOmniCaptureReadbackMode::Deferred, Layer.Result);
+                    if (Layer.Result.PendingReadback.IsValid())
                     {
-                        RightFaces.Add(Texture);
+                        FOmniCaptureLayerReadback& LayerReadback = DeferredResult.PendingLayerReadbacks.Add(Layer.PassType);
+                        LayerReadback.Readback = MoveTemp(Layer.Result.PendingReadback);
+                        LayerReadback.Size = Layer.Result.Size;
+                        LayerReadback.Precision = Layer.Result.PixelPrecision;
                     }
                 }
+            };
+            return;
+        }
+
+        FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
+        ENQUEUE_RENDER_COMMAND(OmniCaptureAuxiliaryProjection)([&LayerSettings, Kind, &Layers, CompletionEvent](FRHICommandListImmediate&)
+        {
+            for (FGPUAuxiliaryLayer& Layer : Layers)
+            {
+                ProjectOnRenderThread(LayerSettings, Kind, Layer.LeftFaces, Layer.RightFaces, EOmniCaptureReadbackMode::Blocking, Layer.Result);
+            }
+            CompletionEvent->Trigger();
+        });
+
+        CompletionEvent->Wait();
+        FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+
+        for (FGPUAuxiliaryLayer& Layer : Layers)
+        {
+            if (!Layer.Result.PixelData.IsValid())
+            {
+                OutFailedPasses.Add(Layer.PassType);
+                continue;
             }
+
+            FOmniCaptureLayerPayload Payload;
+            Payload.PixelData = MoveTemp(Layer.Result.PixelData);
+            Payload.bLinear = true;
+            Payload.Precision = Layer.Result.PixelPrecision;
+            Payload.PixelDataType = Layer.Result.PixelDataType;
+            OutResult.AuxiliaryLayers.Add(Layer.PassType, MoveTemp(Payload));
         }
     }
+}
 
-    if (LeftFaces.Num() != 6)
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, EOmniCaptureReadbackMode ReadbackMode)
+{
+    return ConvertProjection(Settings, EProjectionKind::Equirect, LeftEye, RightEye, ReadbackMode, {});
+}
+
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToFisheye(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, EOmniCaptureReadbackMode ReadbackMode)
+{
+    if (!Settings.IsFisheye())
     {
-        return Result;
+        return FOmniCaptureEquirectResult();
     }
 
-    if (Settings.Mode == EOmniCaptureMode::Stereo && RightFaces.Num() != 6)
+    return ConvertProjection(Settings, EProjectionKind::Fisheye, LeftEye, RightEye, ReadbackMode, {});
+}
+
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertLayers(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TConstArrayView<EOmniCaptureAuxiliaryPassType> AuxiliaryPasses, EOmniCaptureReadbackMode ReadbackMode)
+{
+    // With the compute conversion available, colour passes are projected on the GPU like the beauty pass, so only the
+    // data passes pay for a readback and a CPU gather.
+    TArray<FGPUAuxiliaryLayer> GPULayers;
+    TArray<EOmniCaptureAuxiliaryPassType, TInlineAllocator<8>> CPUPasses;
+    const bool bGPUAuxiliaryLayers = !Settings.IsPlanar() && Settings.Resolution > 0 && SupportsComputeConversion();
+    for (const EOmniCaptureAuxiliaryPassType PassType : AuxiliaryPasses)
     {
-        return Result;
+        if (PassType == EOmniCaptureAuxiliaryPassType::None || CPUPasses.Contains(PassType) || GPULayers.ContainsByPredicate([PassType](const FGPUAuxiliaryLayer& Layer) { return Layer.PassType == PassType; }))
+        {
+            continue;
+        }
+        if (!bGPUAuxiliaryLayers || !TryAddGPUAuxiliaryLayer(Settings, LeftEye, RightEye, PassType, GPULayers))
+        {
+            CPUPasses.Add(PassType);
+        }
     }
 
-    bool bSupportsCompute = GDynamicRHI != nullptr;
-#if defined(GRHISupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GRHISupportsComputeShaders;
-#elif defined(GSupportsComputeShaders)
-    bSupportsCompute = bSupportsCompute && GSupportsComputeShaders;
-#else
-    bSupportsCompute = false;
-#endif
+    TArray<FCPUAuxiliaryLayer> AuxiliaryLayers;
+    ReadAuxiliaryLayers(Settings, LeftEye, RightEye, CPUPasses, AuxiliaryLayers);
 
-    if (bSupportsCompute)
+    if (Settings.IsPlanar())
     {
-        FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
-        ENQUEUE_RENDER_COMMAND(OmniCaptureFisheyeConvert)([Settings, LeftFaces, RightFaces, &Result, CompletionEvent](FRHICommandListImmediate&)
-        {
-            ConvertFisheyeOnRenderThread(Settings, LeftFaces, RightFaces.Num() > 0 ? RightFaces : LeftFaces, Result);
-            CompletionEvent->Trigger();
-        });
+        FOmniCaptureEquirectResult Result = ConvertToPlanar(Settings, LeftEye, ReadbackMode);
+        CopyPlanarLayers(AuxiliaryLayers, Result);
+        return Result;
+    }
 
-        CompletionEvent->Wait();
-        FPlatformProcess::ReturnSynchEventToPool(CompletionEvent);
+    const EProjectionKind Kind = Settings.IsFisheye() && !Settings.ShouldConvertFisheyeToEquirect() ? EProjectionKind::Fisheye : EProjectionKind::Equirect;
+    FOmniCaptureEquirectResult Result = ConvertProjection(Settings, Kind, LeftEye, RightEye, ReadbackMode, AuxiliaryLayers);
+    if (GPULayers.Num() == 0)
+    {
+        return Result;
+    }
+
+    // A beauty pass that fell back to the CPU means the GPU path is not working; its colour layers follow it there.
+    TArray<EOmniCaptureAuxiliaryPassType, TInlineAllocator<8>> FallbackPasses;
+    if (Result.OutputTarget.IsValid() || Result.DeferredConversion)
+    {
+        ConvertAuxiliaryLayersOnGPU(Settings, Kind, GPULayers, ReadbackMode, Result, FallbackPasses);
     }
     else
     {
-        ConvertFisheyeOnCPU(Settings, LeftEye, RightEye, Result);
+        Algo::Transform(GPULayers, FallbackPasses, [](const FGPUAuxiliaryLayer& Layer) { return Layer.PassType; });
+    }
+
+    if (FallbackPasses.Num() > 0)
+    {
+        TArray<FCPUAuxiliaryLayer> FallbackLayers;
+        ReadAuxiliaryLayers(Settings, LeftEye, RightEye, FallbackPasses, FallbackLayers);
+        ConvertAuxiliaryLayersOnCPU(Settings, Kind, FallbackLayers, INDEX_NONE, Result);
     }
 
     return Result;
 }
 
-FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToPlanar(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& SourceEye)
+FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToPlanar(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& SourceEye, EOmniCaptureReadbackMode ReadbackMode)
 {
     FOmniCaptureEquirectResult Result;
 
@@ -1681,8 +1828,6 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToPlanar(const
     Result.OutputTarget.SafeRelease();
     Result.GPUSource.SafeRelease();
 
-    const int32 PixelCount = OutputSize.X * OutputSize.Y;
-
     if (Result.bIsLinear)
     {
         TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(OutputSize);
@@ -1718,39 +1863,20 @@ FOmniCaptureEquirectResult FOmniCaptureEquirectConverter::ConvertToPlanar(const
 
     if (!Result.PixelData.IsValid())
     {
-        Result.PreviewPixels.Reset();
         return Result;
     }
 
-    Result.PreviewPixels.SetNum(PixelCount);
-    if (Result.bIsLinear)
-    {
-        const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(Result.PixelData.Get());
-        if (FloatData)
-        {
-            for (int32 Index = 0; Index < PixelCount; ++Index)
-            {
-                Result.PreviewPixels[Index] = FLinearColor(FloatData->Pixels[Index]).ToFColor(true);
-            }
-        }
-    }
-    else
-    {
-        const TImagePixelData<FColor>* ColorData = static_cast<const TImagePixelData<FColor>*>(Result.PixelData.Get());
-        if (ColorData)
-        {
-            Result.PreviewPixels = ColorData->Pixels;
-        }
-    }
+    Result.Texture = Resource->GetRenderTargetTexture();
 
-    if (Result.PreviewPixels.Num() != PixelCount)
+    if (Result.Texture.IsValid() && Settings.OutputFormat == EOmniOutputFormat::NVENCHardware && ReadbackMode == EOmniCaptureReadbackMode::Deferred)
     {
-        Result.PreviewPixels.Init(FColor::Black, PixelCount);
+        // The pixels were read above; only the encoder planes are left to the render thread.
+        Result.DeferredConversion = [Settings, SourceTexture = Result.Texture, OutputSize, bLinear = Result.bIsLinear](FOmniCaptureEquirectResult& OutResult)
+        {
+            ConvertPlanarOnRenderThread(Settings, SourceTexture, OutputSize, bLinear, OutResult);
+        };
     }
-
-    Result.Texture = Resource->GetRenderTargetTexture();
-
-    if (Result.Texture.IsValid() && Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    else if (Result.Texture.IsValid() && Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
     {
         FEvent* CompletionEvent = FPlatformProcess::GetSynchEventFromPool();
         ENQUEUE_RENDER_COMMAND(OmniCapturePlanarConvert)([Settings, SourceTexture = Result.Texture, OutputSize, bLinear = Result.bIsLinear, &Result, CompletionEvent](FRHICommandListImmediate& RHICmdList)
@@ -0,0 +1,379 @@
+#include "OmniCaptureFFmpegPipe.h"
+
+#include "HAL/FileManager.h"
+#include "ImageWriteTypes.h"
+#include "Misc/ScopeLock.h"
+#include "Templates/Function.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureFFmpeg, Log, All);
+
+namespace
+{
+    constexpr int64 ConversionBandBytes = 4 * 1024 * 1024;
+
+    uint16 ToUInt16(float Value)
+    {
+        return static_cast<uint16>(FMath::RoundToInt(FMath::Clamp(Value, 0.0f, 1.0f) * 65535.0f));
+    }
+
+    // Converts float RGBA pixels to rgba64le a band of rows at a time and sends each band.
+    template <typename PixelType, typename ReadChannelsType>
+    bool SendConvertedRows(const TArray64<PixelType>& Pixels, const FIntPoint& Size, TArray64<uint8>& Buffer, TFunctionRef<bool(const uint8*, int64)> Send, ReadChannelsType ReadChannels)
+    {
+        const int64 BytesPerRow = static_cast<int64>(Size.X) * 4 * sizeof(uint16);
+        const int32 RowsPerBand = FMath::Max<int32>(1, static_cast<int32>(ConversionBandBytes / FMath::Max<int64>(BytesPerRow, 1)));
+        Buffer.SetNum(BytesPerRow * FMath::Min(RowsPerBand, Size.Y), EAllowShrinking::No);
+
+        for (int32 RowStart = 0; RowStart < Size.Y; RowStart += RowsPerBand)
+        {
+            const int32 RowCount = FMath::Min(RowsPerBand, Size.Y - RowStart);
+            uint16* Dest = reinterpret_cast<uint16*>(Buffer.GetData());
+            const PixelType* Source = Pixels.GetData() + static_cast<int64>(RowStart) * Size.X;
+            for (int64 Index = 0; Index < static_cast<int64>(RowCount) * Size.X; ++Index)
+            {
+                float R, G, B, A;
+                ReadChannels(Source[Index], R, G, B, A);
+                *Dest++ = ToUInt16(R);
+                *Dest++ = ToUInt16(G);
+                *Dest++ = ToUInt16(B);
+                *Dest++ = ToUInt16(A);
+            }
+
+            if (!Send(Buffer.GetData(), BytesPerRow * RowCount))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+FOmniCaptureFFmpegPipe::FOmniCaptureFFmpegPipe()
+{
+    WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+    SpaceEvent = FPlatformProcess::GetSynchEventFromPool();
+}
+
+FOmniCaptureFFmpegPipe::~FOmniCaptureFFmpegPipe()
+{
+    if (ProcHandle.IsValid() && !bExited)
+    {
+        WaitForExit();
+    }
+
+    FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+    WorkEvent = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+    SpaceEvent = nullptr;
+}
+
+bool FOmniCaptureFFmpegPipe::Start(const FString& Binary, const FString& Arguments, const FString& WorkingDirectory, const FIntPoint& InFrameSize, EOmniCapturePixelDataType InPixelDataType, int32 InMaxQueuedFrames)
+{
+    check(!ProcHandle.IsValid());
+
+    if (!GetRawPixelFormat(InPixelDataType) || InFrameSize.X <= 0 || InFrameSize.Y <= 0)
+    {
+        return false;
+    }
+
+    FrameSize = InFrameSize;
+    PixelDataType = InPixelDataType;
+    MaxQueuedFrames = FMath::Max(1, InMaxQueuedFrames);
+
+    if (!FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true))
+    {
+        UE_LOG(LogOmniCaptureFFmpeg, Warning, TEXT("Failed to create a pipe for %s."), *Binary);
+        return false;
+    }
+
+    ProcHandle = FPlatformProcess::CreateProc(*Binary, *Arguments, false, true, true, nullptr, 0, WorkingDirectory.IsEmpty() ? nullptr : *WorkingDirectory, nullptr, StdInRead);
+    if (!ProcHandle.IsValid())
+    {
+        UE_LOG(LogOmniCaptureFFmpeg, Warning, TEXT("Failed to launch %s for live encoding."), *Binary);
+        FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+        StdInRead = StdInWrite = nullptr;
+        return false;
+    }
+
+    Thread.Reset(FRunnableThread::Create(this, TEXT("OmniCaptureFFmpegPipe")));
+    if (!Thread.IsValid())
+    {
+        FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+        StdInRead = StdInWrite = nullptr;
+        FPlatformProcess::TerminateProc(ProcHandle);
+        FPlatformProcess::CloseProc(ProcHandle);
+        return false;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+    bStarted = true;
+    return true;
+}
+
+void FOmniCaptureFFmpegPipe::WatchOutputFile(const FString& InOutputPath)
+{
+    check(!ProcHandle.IsValid());
+    OutputPath = InOutputPath;
+}
+
+bool FOmniCaptureFFmpegPipe::PushFrame(const FOmniCaptureSharedFrame& Frame)
+{
+    bool bCountedBlock = false;
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (!bStarted || bInputClosed || bBroken)
+            {
+                ++Stats.SkippedFrames;
+                return false;
+            }
+            if (Queue.Num() < MaxQueuedFrames)
+            {
+                Queue.Add(Frame);
+                break;
+            }
+            if (!bCountedBlock)
+            {
+                ++Stats.BlockedPushes;
+                bCountedBlock = true;
+            }
+        }
+
+        // The pipe thread raises this after every frame it takes, and when it gives up on the pipe.
+        SpaceEvent->Wait();
+    }
+
+    WorkEvent->Trigger();
+    return true;
+}
+
+void FOmniCaptureFFmpegPipe::CloseInput()
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        bInputClosed = true;
+    }
+    WorkEvent->Trigger();
+}
+
+bool FOmniCaptureFFmpegPipe::WaitForExit(double TimeoutSeconds)
+{
+    if (bExited)
+    {
+        return bExitResult;
+    }
+
+    CloseInput();
+
+    // The pipe thread closes stdin once the queue is written out, which is what lets the encoder finish. Killing an
+    // encoder that never gets there also unblocks that thread, whose writes fail once the process is gone.
+    bool bTimedOut = false;
+    const double Deadline = FPlatformTime::Seconds() + FMath::Max(TimeoutSeconds, 0.0);
+    while (ProcHandle.IsValid() && FPlatformProcess::IsProcRunning(ProcHandle))
+    {
+        if (FPlatformTime::Seconds() >= Deadline)
+        {
+            UE_LOG(LogOmniCaptureFFmpeg, Warning, TEXT("Live encoder did not exit within %.0f seconds; terminating it."), TimeoutSeconds);
+            FPlatformProcess::TerminateProc(ProcHandle, true);
+            bTimedOut = true;
+            break;
+        }
+        FPlatformProcess::Sleep(0.01f);
+    }
+
+    if (Thread.IsValid())
+    {
+        Thread->WaitForCompletion();
+        Thread.Reset();
+    }
+
+    bExited = true;
+    if (!ProcHandle.IsValid())
+    {
+        return false;
+    }
+
+    FPlatformProcess::WaitForProc(ProcHandle);
+    int32 ReturnCode = -1;
+    FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
+    FPlatformProcess::CloseProc(ProcHandle);
+    if (ReturnCode != 0)
+    {
+        UE_LOG(LogOmniCaptureFFmpeg, Warning, TEXT("Live encoder exited with code %d."), ReturnCode);
+    }
+
+    FScopeLock Lock(&CriticalSection);
+    bExitResult = !bBroken && !bTimedOut && ReturnCode == 0;
+    return bExitResult;
+}
+
+bool FOmniCaptureFFmpegPipe::IsRunning() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return bStarted && !bInputClosed && !bBroken;
+}
+
+FOmniCaptureFFmpegPipeStats FOmniCaptureFFmpegPipe::GetStats() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return Stats;
+}
+
+uint32 FOmniCaptureFFmpegPipe::Run()
+{
+    for (;;)
+    {
+        FOmniCaptureSharedFrame Frame;
+        bool bDone = false;
+        bool bPipeBroken = false;
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (Queue.Num() > 0)
+            {
+                Frame = Queue[0];
+                Queue.RemoveAt(0, 1, EAllowShrinking::No);
+            }
+            else
+            {
+                bDone = bInputClosed;
+            }
+            bPipeBroken = bBroken;
+        }
+
+        if (!Frame.IsValid())
+        {
+            if (bDone)
+            {
+                break;
+            }
+            WorkEvent->Wait();
+            continue;
+        }
+        SpaceEvent->Trigger();
+
+        const bool bWritten = !bPipeBroken && WriteFrame(*Frame);
+        Frame.Reset();
+        SampleOutputSize();
+
+        FScopeLock Lock(&CriticalSection);
+        if (bWritten)
+        {
+            ++Stats.FramesWritten;
+        }
+        else
+        {
+            ++Stats.SkippedFrames;
+        }
+    }
+
+    // Closing our end is the encoder's end of input.
+    FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+    StdInRead = StdInWrite = nullptr;
+    return 0;
+}
+
+void FOmniCaptureFFmpegPipe::SampleOutputSize()
+{
+    const double NowSeconds = FPlatformTime::Seconds();
+    if (OutputPath.IsEmpty() || NowSeconds < NextOutputSizeSeconds)
+    {
+        return;
+    }
+    NextOutputSizeSeconds = NowSeconds + OutputSizeIntervalSeconds;
+
+    const int64 Size = IFileManager::Get().FileSize(*OutputPath);
+    FScopeLock Lock(&CriticalSection);
+    Stats.OutputBytes = FMath::Max<int64>(Size, 0);
+}
+
+bool FOmniCaptureFFmpegPipe::WriteFrame(const FOmniCaptureFrame& Frame)
+{
+    if (!Frame.PixelData.IsValid() || Frame.PixelDataType != PixelDataType || Frame.PixelData->GetSize() != FrameSize)
+    {
+        UE_LOG(LogOmniCaptureFFmpeg, Verbose, TEXT("Skipping frame %d: it does not match the live stream's format."), Frame.Metadata.FrameIndex);
+        return false;
+    }
+
+    auto Send = [this](const uint8* Data, int64 Size)
+    {
+        if (!WriteToProcess(ProcHandle, StdInWrite, Data, Size))
+        {
+            // The process stopped reading; whatever follows would be misaligned anyway.
+            UE_LOG(LogOmniCaptureFFmpeg, Warning, TEXT("Live encoder closed its input; the remaining frames are dropped."));
+            FScopeLock Lock(&CriticalSection);
+            bBroken = true;
+            SpaceEvent->Trigger();
+            return false;
+        }
+        FScopeLock Lock(&CriticalSection);
+        Stats.BytesWritten += Size;
+        return true;
+    };
+
+    switch (PixelDataType)
+    {
+    case EOmniCapturePixelDataType::Color8:
+    {
+        const void* RawData = nullptr;
+        int64 RawSize = 0;
+        Frame.PixelData->GetRawData(RawData, RawSize);
+        return RawData && Send(static_cast<const uint8*>(RawData), RawSize);
+    }
+    case EOmniCapturePixelDataType::LinearColorFloat16:
+        return SendConvertedRows(static_cast<const TImagePixelData<FFloat16Color>&>(*Frame.PixelData).Pixels, FrameSize, ConversionBuffer, Send, [](const FFloat16Color& Pixel, float& R, float& G, float& B, float& A)
+        {
+            R = Pixel.R.GetFloat();
+            G = Pixel.G.GetFloat();
+            B = Pixel.B.GetFloat();
+            A = Pixel.A.GetFloat();
+        });
+    case EOmniCapturePixelDataType::LinearColorFloat32:
+        return SendConvertedRows(static_cast<const TImagePixelData<FLinearColor>&>(*Frame.PixelData).Pixels, FrameSize, ConversionBuffer, Send, [](const FLinearColor& Pixel, float& R, float& G, float& B, float& A)
+        {
+            R = Pixel.R;
+            G = Pixel.G;
+            B = Pixel.B;
+            A = Pixel.A;
+        });
+    default:
+        return false;
+    }
+}
+
+const TCHAR* FOmniCaptureFFmpegPipe::GetRawPixelFormat(EOmniCapturePixelDataType InPixelDataType)
+{
+    switch (InPixelDataType)
+    {
+    case EOmniCapturePixelDataType::Color8:
+        return TEXT("bgra");
+    case EOmniCapturePixelDataType::LinearColorFloat16:
+    case EOmniCapturePixelDataType::LinearColorFloat32:
+        return TEXT("rgba64le");
+    default:
+        return nullptr;
+    }
+}
+
+bool FOmniCaptureFFmpegPipe::WriteToProcess(FProcHandle& InProcHandle, void* WritePipe, const uint8* Data, int64 Size)
+{
+    constexpr int64 MaxWriteBytes = 1024 * 1024;
+    while (Size > 0)
+    {
+        int32 Written = 0;
+        FPlatformProcess::WritePipe(WritePipe, Data, static_cast<int32>(FMath::Min(Size, MaxWriteBytes)), &Written);
+        if (Written <= 0)
+        {
+            if (!FPlatformProcess::IsProcRunning(InProcHandle))
+            {
+                return false;
+            }
+            FPlatformProcess::Sleep(0.001f);
+            continue;
+        }
+
+        Data += Written;
+        Size -= Written;
+    }
+    return true;
+}
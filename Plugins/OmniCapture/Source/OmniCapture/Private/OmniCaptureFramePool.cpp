@@ -0,0 +1,136 @@
+#include "OmniCaptureFramePool.h"
+
+#include "Misc/ScopeLock.h"
+
+FOmniCaptureFramePool& FOmniCaptureFramePool::Get()
+{
+    static const TSharedRef<FOmniCaptureFramePool, ESPMode::ThreadSafe> Pool = MakeShared<FOmniCaptureFramePool, ESPMode::ThreadSafe>();
+    return *Pool;
+}
+
+void FOmniCaptureFramePool::Trim()
+{
+    FScopeLock Lock(&CriticalSection);
+    ColorBuffers.Reset();
+    HalfBuffers.Reset();
+    FloatBuffers.Reset();
+    ScalarBuffers.Reset();
+    Vector2Buffers.Reset();
+    Stats.IdleBuffers = 0;
+    Stats.IdleBytes = 0;
+}
+
+FOmniCaptureFramePoolStats FOmniCaptureFramePool::GetStats() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return Stats;
+}
+
+template <typename PixelType>
+void FOmniCaptureFramePool::TakeBufferImpl(TMap<FIntPoint, TArray<TArray64<PixelType>>>& FreeLists, const FIntPoint& Size, TArray64<PixelType>& OutPixels)
+{
+    const int64 PixelCount = static_cast<int64>(FMath::Max(Size.X, 0)) * FMath::Max(Size.Y, 0);
+    const int64 Bytes = PixelCount * sizeof(PixelType);
+
+    {
+        FScopeLock Lock(&CriticalSection);
+        TArray<TArray64<PixelType>>* FreeList = FreeLists.Find(Size);
+        if (FreeList && FreeList->Num() > 0)
+        {
+            OutPixels = FreeList->Pop(EAllowShrinking::No);
+            ++Stats.Hits;
+            --Stats.IdleBuffers;
+            Stats.IdleBytes -= Bytes;
+        }
+        else
+        {
+            ++Stats.Misses;
+        }
+
+        ++Stats.OutstandingBuffers;
+        Stats.OutstandingBytes += Bytes;
+        Stats.HighWaterBuffers = FMath::Max(Stats.HighWaterBuffers, Stats.OutstandingBuffers);
+        Stats.HighWaterBytes = FMath::Max(Stats.HighWaterBytes, Stats.OutstandingBytes);
+    }
+
+    // A miss allocates outside the lock. Recycled buffers already hold PixelCount pixels, so this is free for them.
+    OutPixels.SetNumUninitialized(PixelCount, EAllowShrinking::No);
+}
+
+template <typename PixelType>
+void FOmniCaptureFramePool::ReturnBufferImpl(TMap<FIntPoint, TArray<TArray64<PixelType>>>& FreeLists, const FIntPoint& Size, TArray64<PixelType>&& Pixels)
+{
+    const int64 PixelCount = static_cast<int64>(FMath::Max(Size.X, 0)) * FMath::Max(Size.Y, 0);
+    const int64 Bytes = PixelCount * sizeof(PixelType);
+
+    // Holds a buffer the pool declines so it is freed after the lock is released.
+    TArray64<PixelType> Discarded;
+    {
+        FScopeLock Lock(&CriticalSection);
+        --Stats.OutstandingBuffers;
+        Stats.OutstandingBytes -= Bytes;
+
+        // Pixels moved out (FImagePixelData::Move) or resized in place leave nothing reusable under this key.
+        TArray<TArray64<PixelType>>& FreeList = FreeLists.FindOrAdd(Size);
+        if (Pixels.Num() == PixelCount && FreeList.Num() < MaxIdleBuffersPerKey)
+        {
+            FreeList.Add(MoveTemp(Pixels));
+            ++Stats.IdleBuffers;
+            Stats.IdleBytes += Bytes;
+        }
+        else
+        {
+            Discarded = MoveTemp(Pixels);
+        }
+    }
+}
+
+void FOmniCaptureFramePool::TakeBuffer(const FIntPoint& Size, TArray64<FColor>& OutPixels)
+{
+    TakeBufferImpl(ColorBuffers, Size, OutPixels);
+}
+
+void FOmniCaptureFramePool::TakeBuffer(const FIntPoint& Size, TArray64<FFloat16Color>& OutPixels)
+{
+    TakeBufferImpl(HalfBuffers, Size, OutPixels);
+}
+
+void FOmniCaptureFramePool::TakeBuffer(const FIntPoint& Size, TArray64<FLinearColor>& OutPixels)
+{
+    TakeBufferImpl(FloatBuffers, Size, OutPixels);
+}
+
+void FOmniCaptureFramePool::TakeBuffer(const FIntPoint& Size, TArray64<float>& OutPixels)
+{
+    TakeBufferImpl(ScalarBuffers, Size, OutPixels);
+}
+
+void FOmniCaptureFramePool::TakeBuffer(const FIntPoint& Size, TArray64<FVector2f>& OutPixels)
+{
+    TakeBufferImpl(Vector2Buffers, Size, OutPixels);
+}
+
+void FOmniCaptureFramePool::ReturnBuffer(const FIntPoint& Size, TArray64<FColor>&& Pixels)
+{
+    ReturnBufferImpl(ColorBuffers, Size, MoveTemp(Pixels));
+}
+
+void FOmniCaptureFramePool::ReturnBuffer(const FIntPoint& Size, TArray64<FFloat16Color>&& Pixels)
+{
+    ReturnBufferImpl(HalfBuffers, Size, MoveTemp(Pixels));
+}
+
+void FOmniCaptureFramePool::ReturnBuffer(const FIntPoint& Size, TArray64<FLinearColor>&& Pixels)
+{
+    ReturnBufferImpl(FloatBuffers, Size, MoveTemp(Pixels));
+}
+
+void FOmniCaptureFramePool::ReturnBuffer(const FIntPoint& Size, TArray64<float>&& Pixels)
+{
+    ReturnBufferImpl(ScalarBuffers, Size, MoveTemp(Pixels));
+}
+
+void FOmniCaptureFramePool::ReturnBuffer(const FIntPoint& Size, TArray64<FVector2f>&& Pixels)
+{
+    ReturnBufferImpl(Vector2Buffers, Size, MoveTemp(Pixels));
+}
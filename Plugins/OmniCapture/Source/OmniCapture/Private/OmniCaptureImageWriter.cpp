@@ -1,8 +1,8 @@
 #include "OmniCaptureImageWriter.h"
 
 
-#include "Async/Async.h"
 #include "Async/Future.h"
+#include "Async/ParallelFor.h"
 #include "HAL/FileManager.h"
 #include "IImageWrapperModule.h"
 #include "IImageWrapper.h"
@@ -14,9 +14,11 @@
 #include "Containers/StringConv.h"
 #include "Internationalization/Internationalization.h"
 #include "Math/Vector2D.h"
+#include "Serialization/MemoryWriter.h"
 #include "OmniCaptureVersion.h"
 
 #include <exception>
+#include <stdexcept>
 
 #ifndef WITH_OMNICAPTURE_OPENEXR
 #define WITH_OMNICAPTURE_OPENEXR 0
@@ -35,7 +37,14 @@ THIRD_PARTY_INCLUDES_START
 #include "OpenEXR/ImfFrameBuffer.h"
 #include "OpenEXR/ImfStringAttribute.h"
 #include "OpenEXR/ImfCompression.h"
+#include "OpenEXR/ImfIO.h"
+#include "OpenEXR/ImfStdIO.h"
 #include "OpenEXR/ImfNamespace.h"
+#include "OpenEXR/ImfThreading.h"
+#include "OpenEXR/ImfTiledOutputFile.h"
+#include "OpenEXR/ImfTiledOutputPart.h"
+#include "OpenEXR/ImfTileDescription.h"
+#include "OpenEXR/ImfPartType.h"
 #include "Imath/half.h"
 THIRD_PARTY_INCLUDES_END
 #endif
@@ -44,6 +53,104 @@ namespace
 {
     constexpr int32 DefaultJpegQuality = 85;
 
+    // The frame this writer thread is encoding, so images appended to the capture container are filed under it.
+    struct FContainerFrameContext
+    {
+        const FOmniCaptureFrameMetadata* Metadata = nullptr;
+        const FString* PrimaryPath = nullptr;
+    };
+    thread_local FContainerFrameContext GContainerFrameContext;
+
+    class FScopedContainerFrame
+    {
+    public:
+        FScopedContainerFrame(const FOmniCaptureFrameMetadata& Metadata, const FString& PrimaryPath)
+            : Previous(GContainerFrameContext)
+        {
+            GContainerFrameContext.Metadata = &Metadata;
+            GContainerFrameContext.PrimaryPath = &PrimaryPath;
+        }
+
+        ~FScopedContainerFrame()
+        {
+            GContainerFrameContext = Previous;
+        }
+
+    private:
+        FContainerFrameContext Previous;
+    };
+
+    struct FContainerEntryBytes
+    {
+        TArray64<uint8> Bytes;
+    };
+
+    // Collects one encoded image in memory and hands it to the container when closed without error.
+    class FContainerEntryArchive final : private FContainerEntryBytes, public FMemoryWriter64
+    {
+    public:
+        explicit FContainerEntryArchive(TFunction<bool(const TArray64<uint8>&)>&& InCommit)
+            : FMemoryWriter64(Bytes, true)
+            , Commit(MoveTemp(InCommit))
+        {
+        }
+
+        virtual bool Close() override
+        {
+            if (!bClosed)
+            {
+                bClosed = true;
+                if (!IsError() && !Commit(Bytes))
+                {
+                    SetError();
+                }
+            }
+            return !IsError();
+        }
+
+    private:
+        TFunction<bool(const TArray64<uint8>&)> Commit;
+        bool bClosed = false;
+    };
+
+#if WITH_OMNICAPTURE_OPENEXR
+    // Collects an EXR in memory for the capture container. OpenEXR seeks back to fill in offset tables.
+    class FExrMemoryOStream final : public OPENEXR_IMF_NAMESPACE::OStream
+    {
+    public:
+        explicit FExrMemoryOStream(const char* FileName)
+            : OPENEXR_IMF_NAMESPACE::OStream(FileName)
+        {
+        }
+
+        virtual void write(const char Data[], int Count) override
+        {
+            const int64 End = Position + Count;
+            if (End > Bytes.Num())
+            {
+                Bytes.SetNumUninitialized(End, EAllowShrinking::No);
+            }
+            FMemory::Memcpy(Bytes.GetData() + Position, Data, Count);
+            Position = End;
+        }
+
+        virtual uint64_t tellp() override
+        {
+            return static_cast<uint64_t>(Position);
+        }
+
+        virtual void seekp(uint64_t Pos) override
+        {
+            Position = static_cast<int64>(Pos);
+        }
+
+        TArray64<uint8> Bytes;
+
+    private:
+        int64 Position = 0;
+    };
+#endif
+
 #if WITH_OMNICAPTURE_OPENEXR
     OPENEXR_IMF_NAMESPACE::Compression ToOpenExrCompression(EOmniCaptureEXRCompression Compression)
     {
@@ -82,38 +189,304 @@ namespace
         }
     }
 
+    // FFloat16 and Imath's half are both IEEE binary16, so half-float pixels can be handed to OpenEXR as they are.
+    static_assert(sizeof(FFloat16) == sizeof(IMATH_NAMESPACE::half), "FFloat16 must match the OpenEXR half layout");
+    static_assert(sizeof(FFloat16Color) == 4 * sizeof(IMATH_NAMESPACE::half), "FFloat16Color must be tightly packed RGBA");
+    static_assert(sizeof(FLinearColor) == 4 * sizeof(float), "FLinearColor must be tightly packed RGBA");
+
     struct FPreparedExrLayer
     {
         std::string Name;
         OPENEXR_IMF_NAMESPACE::PixelType PixelType = OPENEXR_IMF_NAMESPACE::PixelType::HALF;
         int32 ChannelCount = 4;
-        TArray<float> FloatBuffer;
-        TArray<IMATH_NAMESPACE::half> HalfBuffer;
+        // The layer's own pixel array, or StagingBuffer when the payload had to be copied.
+        const char* BasePointer = nullptr;
+        TArray64<uint8> StagingBuffer;
+
+        int32 GetComponentSize() const
+        {
+            return PixelType == OPENEXR_IMF_NAMESPACE::PixelType::FLOAT ? sizeof(float) : sizeof(IMATH_NAMESPACE::half);
+        }
 
-        const char* GetBasePointer() const
+        size_t GetPixelStride() const
         {
+            return static_cast<size_t>(GetComponentSize()) * ChannelCount;
+        }
+
+        template <typename SourcePixelType>
+        void Reference(const TImagePixelData<SourcePixelType>& PixelData, OPENEXR_IMF_NAMESPACE::PixelType InPixelType, int32 InChannelCount)
+        {
+            PixelType = InPixelType;
+            ChannelCount = InChannelCount;
+            BasePointer = reinterpret_cast<const char*>(PixelData.Pixels.GetData());
+            check(GetPixelStride() == sizeof(SourcePixelType));
+        }
+
+        // Set instead of BasePointer when a tiled write converts 8-bit pixels one tile row at a time.
+        const FColor* Color8Source = nullptr;
+
+        // Channel value of a level-0 pixel, for building lower mip or rip levels.
+        float ReadChannel(int64 PixelIndex, int32 Channel) const
+        {
+            if (Color8Source)
+            {
+                const FColor& Color = Color8Source[PixelIndex];
+                const uint8 Values[4] = { Color.R, Color.G, Color.B, Color.A };
+                return Values[Channel] / 255.0f;
+            }
+
+            const char* Pixel = BasePointer + PixelIndex * static_cast<int64>(GetPixelStride());
             if (PixelType == OPENEXR_IMF_NAMESPACE::PixelType::FLOAT)
             {
-                return reinterpret_cast<const char*>(FloatBuffer.GetData());
+                return reinterpret_cast<const float*>(Pixel)[Channel];
             }
+            return reinterpret_cast<const IMATH_NAMESPACE::half*>(Pixel)[Channel];
+        }
 
-            return reinterpret_cast<const char*>(HalfBuffer.GetData());
+        // Converts rows [FirstRow, FirstRow + RowCount) of Color8Source into StagingBuffer as float RGBA.
+        void ConvertColor8Rows(int32 Width, int32 FirstRow, int32 RowCount)
+        {
+            const int64 PixelCount = static_cast<int64>(Width) * RowCount;
+            StagingBuffer.SetNumUninitialized(PixelCount * sizeof(FLinearColor), EAllowShrinking::No);
+            FLinearColor* Converted = reinterpret_cast<FLinearColor*>(StagingBuffer.GetData());
+            const FColor* Source = Color8Source + static_cast<int64>(FirstRow) * Width;
+            for (int64 Index = 0; Index < PixelCount; ++Index)
+            {
+                Converted[Index] = Source[Index].ReinterpretAsLinear();
+            }
         }
 
-        int32 GetComponentSize() const
+        // Copies the referenced pixels into StagingBuffer, as every layer was before the zero-copy path existed.
+        void Stage(int64 PixelCount)
         {
-            return PixelType == OPENEXR_IMF_NAMESPACE::PixelType::FLOAT ? sizeof(float) : sizeof(IMATH_NAMESPACE::half);
+            const int64 Bytes = PixelCount * static_cast<int64>(GetPixelStride());
+            StagingBuffer.SetNumUninitialized(Bytes);
+            FMemory::Memcpy(StagingBuffer.GetData(), BasePointer, Bytes);
+            BasePointer = reinterpret_cast<const char*>(StagingBuffer.GetData());
         }
     };
+
+    // One mip or rip level of a layer below level 0, as float channels.
+    struct FExrLevelImage
+    {
+        TArray64<float> Pixels;
+        int32 Width = 0;
+        int32 Height = 0;
+    };
+
+    // Box-filters Source (read through Read) down to DstWidth x DstHeight. Either axis may stay the same size, as
+    // ripmap levels halve one axis at a time.
+    FExrLevelImage DownsampleExrLevel(TFunctionRef<float(int64 PixelIndex, int32 Channel)> Read, int32 SrcWidth, int32 SrcHeight, int32 DstWidth, int32 DstHeight, int32 ChannelCount)
+    {
+        FExrLevelImage Level;
+        Level.Width = DstWidth;
+        Level.Height = DstHeight;
+        Level.Pixels.SetNumUninitialized(static_cast<int64>(DstWidth) * DstHeight * ChannelCount);
+
+        ParallelFor(DstHeight, [&](int32 Y)
+        {
+            const int32 SrcY0 = static_cast<int32>(static_cast<int64>(Y) * SrcHeight / DstHeight);
+            const int32 SrcY1 = FMath::Max(SrcY0 + 1, static_cast<int32>(static_cast<int64>(Y + 1) * SrcHeight / DstHeight));
+            for (int32 X = 0; X < DstWidth; ++X)
+            {
+                const int32 SrcX0 = static_cast<int32>(static_cast<int64>(X) * SrcWidth / DstWidth);
+                const int32 SrcX1 = FMath::Max(SrcX0 + 1, static_cast<int32>(static_cast<int64>(X + 1) * SrcWidth / DstWidth));
+                const float Weight = 1.0f / ((SrcX1 - SrcX0) * (SrcY1 - SrcY0));
+                float* Destination = Level.Pixels.GetData() + (static_cast<int64>(Y) * DstWidth + X) * ChannelCount;
+                for (int32 Channel = 0; Channel < ChannelCount; ++Channel)
+                {
+                    float Sum = 0.0f;
+                    for (int32 SrcY = SrcY0; SrcY < SrcY1; ++SrcY)
+                    {
+                        for (int32 SrcX = SrcX0; SrcX < SrcX1; ++SrcX)
+                        {
+                            Sum += Read(static_cast<int64>(SrcY) * SrcWidth + SrcX, Channel);
+                        }
+                    }
+                    Destination[Channel] = Sum * Weight;
+                }
+            }
+        });
+
+        return Level;
+    }
+
+    FExrLevelImage DownsampleExrLevel(const FExrLevelImage& Source, int32 DstWidth, int32 DstHeight, int32 ChannelCount)
+    {
+        return DownsampleExrLevel([&Source, ChannelCount](int64 PixelIndex, int32 Channel)
+        {
+            return Source.Pixels[PixelIndex * ChannelCount + Channel];
+        }, Source.Width, Source.Height, DstWidth, DstHeight, ChannelCount);
+    }
+
+    std::string GetExrChannelName(const FPreparedExrLayer& Layer, int32 ChannelIndex, bool bPrefixLayerName)
+    {
+        const std::string Suffix = TCHAR_TO_UTF8(GetChannelSuffix(ChannelIndex));
+        return (bPrefixLayerName && !Layer.Name.empty()) ? Layer.Name + "." + Suffix : Suffix;
+    }
+
+    // Writes the layers of one tiled file or part. Level 0 tiles are written a tile row at a time straight from each
+    // layer's pixels; 8-bit layers are converted one tile row at a time rather than up front. Lower levels are built
+    // from the level above and freed once nothing below needs them.
+    template <typename TiledOutputType>
+    void WriteExrTiles(TiledOutputType& Output, TArrayView<FPreparedExrLayer* const> Layers, const FIntPoint& Size, bool bPrefixLayerNames, TFunctionRef<bool()> ShouldCancel)
+    {
+        using namespace OPENEXR_IMF_NAMESPACE;
+
+        const int32 TileHeight = static_cast<int32>(Output.tileYSize());
+        for (int32 TileY = 0; TileY < Output.numYTiles(0); ++TileY)
+        {
+            if (ShouldCancel())
+            {
+                throw std::runtime_error("EXR write cancelled");
+            }
+
+            const int32 FirstRow = TileY * TileHeight;
+            const int32 RowCount = FMath::Min(TileHeight, Size.Y - FirstRow);
+
+            FrameBuffer Buffer;
+            for (FPreparedExrLayer* Layer : Layers)
+            {
+                const char* Base = Layer->BasePointer;
+                if (Layer->Color8Source)
+                {
+                    // Slice coordinates are absolute, so offset the row buffer back to where row 0 would be.
+                    Layer->ConvertColor8Rows(Size.X, FirstRow, RowCount);
+                    Base = reinterpret_cast<const char*>(Layer->StagingBuffer.GetData()) - static_cast<int64>(FirstRow) * Size.X * sizeof(FLinearColor);
+                }
+
+                const size_t PixelStride = Layer->GetPixelStride();
+                for (int32 ChannelIndex = 0; ChannelIndex < Layer->ChannelCount; ++ChannelIndex)
+                {
+                    const size_t ChannelOffset = static_cast<size_t>(Layer->GetComponentSize()) * ChannelIndex;
+                    Buffer.insert(GetExrChannelName(*Layer, ChannelIndex, bPrefixLayerNames).c_str(), Slice(Layer->PixelType, const_cast<char*>(Base) + ChannelOffset, PixelStride, PixelStride * Size.X));
+                }
+            }
+
+            Output.setFrameBuffer(Buffer);
+            Output.writeTiles(0, Output.numXTiles(0) - 1, TileY, TileY, 0, 0);
+        }
+
+        const int32 NumXLevels = Output.numXLevels();
+        const int32 NumYLevels = Output.numYLevels();
+        if (NumXLevels <= 1 && NumYLevels <= 1)
+        {
+            return;
+        }
+
+        const auto WriteLevel = [&Output, &Layers, bPrefixLayerNames](const TArray<FExrLevelImage>& LevelImages, int32 LevelX, int32 LevelY)
+        {
+            FrameBuffer Buffer;
+            for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+            {
+                const FPreparedExrLayer& Layer = *Layers[LayerIndex];
+                const FExrLevelImage& Image = LevelImages[LayerIndex];
+                const size_t PixelStride = sizeof(float) * Layer.ChannelCount;
+                for (int32 ChannelIndex = 0; ChannelIndex < Layer.ChannelCount; ++ChannelIndex)
+                {
+                    // OpenEXR converts the float level data to the channel's half type where needed.
+                    char* Base = reinterpret_cast<char*>(const_cast<float*>(Image.Pixels.GetData()) + ChannelIndex);
+                    Buffer.insert(GetExrChannelName(Layer, ChannelIndex, bPrefixLayerNames).c_str(), Slice(PixelType::FLOAT, Base, PixelStride, PixelStride * Image.Width));
+                }
+            }
+
+            Output.setFrameBuffer(Buffer);
+            Output.writeTiles(0, Output.numXTiles(LevelX) - 1, 0, Output.numYTiles(LevelY) - 1, LevelX, LevelY);
+        };
+
+        const auto DownsampleAll = [&Output, &Layers, &Size](const TArray<FExrLevelImage>* Previous, int32 LevelX, int32 LevelY)
+        {
+            TArray<FExrLevelImage> LevelImages;
+            LevelImages.Reserve(Layers.Num());
+            const int32 Width = Output.levelWidth(LevelX);
+            const int32 Height = Output.levelHeight(LevelY);
+            for (int32 LayerIndex = 0; LayerIndex < Layers.Num(); ++LayerIndex)
+            {
+                const FPreparedExrLayer& Layer = *Layers[LayerIndex];
+                if (Previous)
+                {
+                    LevelImages.Add(DownsampleExrLevel((*Previous)[LayerIndex], Width, Height, Layer.ChannelCount));
+                }
+                else
+                {
+                    LevelImages.Add(DownsampleExrLevel([&Layer](int64 PixelIndex, int32 Channel) { return Layer.ReadChannel(PixelIndex, Channel); }, Size.X, Size.Y, Width, Height, Layer.ChannelCount));
+                }
+            }
+            return LevelImages;
+        };
+
+        if (Output.levelMode() == MIPMAP_LEVELS)
+        {
+            TArray<FExrLevelImage> Previous;
+            for (int32 Level = 1; Level < NumXLevels; ++Level)
+            {
+                TArray<FExrLevelImage> Current = DownsampleAll(Level > 1 ? &Previous : nullptr, Level, Level);
+                WriteLevel(Current, Level, Level);
+                Previous = MoveTemp(Current);
+            }
+            return;
+        }
+
+        // Ripmaps: walk each column of levels down from its top (LevelX, 0), which is derived from the previous column's top.
+        TArray<FExrLevelImage> ColumnTop;
+        for (int32 LevelX = 0; LevelX < NumXLevels; ++LevelX)
+        {
+            if (ShouldCancel())
+            {
+                throw std::runtime_error("EXR write cancelled");
+            }
+
+            if (LevelX > 0)
+            {
+                ColumnTop = DownsampleAll(LevelX > 1 ? &ColumnTop : nullptr, LevelX, 0);
+                WriteLevel(ColumnTop, LevelX, 0);
+            }
+
+            TArray<FExrLevelImage> Previous;
+            for (int32 LevelY = 1; LevelY < NumYLevels; ++LevelY)
+            {
+                const TArray<FExrLevelImage>* Source = LevelY > 1 ? &Previous : (LevelX > 0 ? &ColumnTop : nullptr);
+                TArray<FExrLevelImage> Current = DownsampleAll(Source, LevelX, LevelY);
+                WriteLevel(Current, LevelX, LevelY);
+                Previous = MoveTemp(Current);
+            }
+        }
+    }
+
+    OPENEXR_IMF_NAMESPACE::LevelMode ToOpenExrLevelMode(EOmniCaptureEXRTileLevels Levels)
+    {
+        using namespace OPENEXR_IMF_NAMESPACE;
+        switch (Levels)
+        {
+        case EOmniCaptureEXRTileLevels::MipMaps:
+            return MIPMAP_LEVELS;
+        case EOmniCaptureEXRTileLevels::RipMaps:
+            return RIPMAP_LEVELS;
+        case EOmniCaptureEXRTileLevels::SingleLevel:
+        default:
+            return ONE_LEVEL;
+        }
+    }
 #endif
 
+    int64 GetPayloadBytes(const FImagePixelData* PixelData)
+    {
+        const void* RawData = nullptr;
+        int64 SizeInBytes = 0;
+        if (PixelData)
+        {
+            PixelData->GetRawData(RawData, SizeInBytes);
+        }
+        return SizeInBytes;
+    }
+
     TSharedPtr<IImageWrapper> CreateImageWrapper(EImageFormat Format)
     {
         IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
         return ImageWrapperModule.CreateImageWrapper(Format);
     }
 
-    bool WritePNGWithImageWrapper(const FString& FilePath, const FIntPoint& Size, const void* RawData, int64 RawSizeInBytes, ERGBFormat Format, int32 BitDepth)
+    bool EncodePNGWithImageWrapper(const FIntPoint& Size, const void* RawData, int64 RawSizeInBytes, ERGBFormat Format, int32 BitDepth, TArray64<uint8>& OutCompressedData)
     {
         if (!RawData || RawSizeInBytes <= 0 || Size.X <= 0 || Size.Y <= 0)
         {
@@ -131,14 +504,8 @@ namespace
             return false;
         }
 
-        const TArray64<uint8> CompressedData = ImageWrapper->GetCompressed(0);
-        if (CompressedData.Num() == 0)
-        {
-            return false;
-        }
-
-        IFileManager::Get().Delete(*FilePath, false, true, false);
-        return FFileHelper::SaveArrayToFile(CompressedData, *FilePath);
+        OutCompressedData = ImageWrapper->GetCompressed(0);
+        return OutCompressedData.Num() > 0;
     }
 
     FString NormalizeFilePath(const FString& InPath)
@@ -220,56 +587,125 @@ void FOmniCaptureImageWriter::Initialize(const FOmniCaptureSettings& Settings, c
     IFileManager::Get().MakeDirectory(*OutputDirectory, true);
     TargetFormat = Settings.ImageFormat;
     TargetPNGBitDepth = Settings.PNGBitDepth;
+    bParallelPNGEncoding = Settings.bParallelPNGEncoding;
+    PNGEncodeOptions = FOmniCapturePNGEncodeOptions::FromSettings(Settings);
     MaxPendingTasks = FMath::Max(1, Settings.MaxPendingImageTasks);
     bPackEXRAuxiliaryLayers = Settings.bPackEXRAuxiliaryLayers;
     bUseEXRMultiPart = Settings.bUseEXRMultiPart;
     TargetEXRCompression = Settings.EXRCompression;
+    bZeroCopyEXRLayers = Settings.bZeroCopyEXRLayers;
+    bWriteTiledEXR = Settings.bWriteTiledEXR;
+    EXRTileSize = FMath::Clamp(Settings.EXRTileSize, 16, 4096);
+    EXRTileLevels = Settings.EXRTileLevels;
+    OutputBytesWritten.Store(0);
+    if (TargetFormat == EOmniCaptureImageFormat::EXR)
+    {
+        EXRConcurrency = ResolveEXRConcurrency(Settings, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+#if WITH_OMNICAPTURE_OPENEXR
+        // Per-file compression runs on OpenEXR's global pool, which every concurrent file shares. Only ever grow it,
+        // since other EXR users in the process may rely on its current size.
+        const int32 RequiredPoolThreads = EXRConcurrency.CompressionThreads > 1 ? EXRConcurrency.ConcurrentFrames * EXRConcurrency.CompressionThreads : 0;
+        if (RequiredPoolThreads > OPENEXR_IMF_NAMESPACE::globalThreadCount())
+        {
+            OPENEXR_IMF_NAMESPACE::setGlobalThreadCount(RequiredPoolThreads);
+        }
+#endif
+        UE_LOG(LogTemp, Log, TEXT("EXR output writes %d frame(s) at once with %d compression thread(s) each"), EXRConcurrency.ConcurrentFrames, EXRConcurrency.CompressionThreads);
+    }
+
+    RawWriter.Reset();
+    Container.Reset();
+    if (TargetFormat == EOmniCaptureImageFormat::Raw)
+    {
+        RawWriter = MakeUnique<FOmniCaptureRawSegmentWriter>(OutputDirectory, SequenceBaseName, static_cast<int64>(FMath::Max(64, Settings.RawSegmentSizeMB)) * 1024 * 1024, Settings.bRawUnbufferedIO);
+    }
+    else if (Settings.bWriteFrameContainer)
+    {
+        Container = MakeUnique<FOmniCaptureContainerWriter>(FOmniCaptureContainerWriter::GetContainerPath(OutputDirectory, SequenceBaseName));
+        if (!Container->IsOpen())
+        {
+            Container.Reset();
+        }
+    }
+
+    // Each worker writes one frame at a time, so for EXR the worker count is the inter-frame parallelism. Raw frames
+    // are appended to one segment in order and only need a single thread to keep the disk busy.
+    int32 WorkerCount = 1;
+    if (TargetFormat == EOmniCaptureImageFormat::EXR)
+    {
+        WorkerCount = EXRConcurrency.ConcurrentFrames;
+    }
+    else if (TargetFormat != EOmniCaptureImageFormat::Raw)
+    {
+        WorkerCount = Settings.ImageWriterThreads > 0 ? Settings.ImageWriterThreads : FMath::Clamp(FPlatformMisc::NumberOfCoresIncludingHyperthreads() / 2, 1, MaxPendingTasks);
+    }
+    MaxBytesInFlight = static_cast<int64>(FMath::Max(0, Settings.ImageWriterMaxInFlightMB)) * 1024 * 1024;
+    WriterPool.Reset();
+    // Below normal so encoding never starves the game and render threads it is recording.
+    WriterPool = MakeUnique<FOmniCaptureWriterPool>(TEXT("ImageWrite"), WorkerCount, static_cast<uint64>(Settings.ImageWriterAffinityMask), TPri_BelowNormal, MaxBytesInFlight);
+    FinalWriterPoolStats = FOmniCaptureWriterPoolStats();
     bStopRequested.Store(false);
     bInitialized = true;
 }
 
 void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame, const FString& FrameFileName)
 {
-    if (!bInitialized || !Frame.IsValid() || IsStopRequested())
+    if (Frame.IsValid())
     {
-        return;
+        EnqueueFrame(FOmniCaptureSharedFrame(MakeShareable(Frame.Release())), FrameFileName);
     }
+}
 
-    PruneCompletedTasks();
-    WaitForAvailableTaskSlot();
-
-    if (IsStopRequested())
+void FOmniCaptureImageWriter::EnqueueFrame(const FOmniCaptureSharedFrame& Frame, const FString& FrameFileName)
+{
+    if (!bInitialized || IsStopRequested() || !Frame.IsValid() || !Frame->PixelData.IsValid())
     {
         return;
     }
 
     FString TargetPath = NormalizeFilePath(OutputDirectory / FrameFileName);
-    FOmniCaptureFrameMetadata Metadata = Frame->Metadata;
-    bool bIsLinear = Frame->bLinearColor;
+    const FOmniCaptureFrameMetadata Metadata = Frame->Metadata;
 
-    TUniquePtr<FImagePixelData> PixelData = MoveTemp(Frame->PixelData);
-    TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers = MoveTemp(Frame->AuxiliaryLayers);
-    if (!PixelData.IsValid())
+    int64 PayloadBytes = GetPayloadBytes(Frame->PixelData.Get());
+    for (const TPair<FName, FOmniCaptureLayerPayload>& Pair : Frame->AuxiliaryLayers)
     {
-        return;
+        PayloadBytes += GetPayloadBytes(Pair.Value.PixelData.Get());
+    }
+
+    if (MaxBytesInFlight <= 0)
+    {
+        MaxBytesInFlight = PayloadBytes * MaxPendingTasks;
+        WriterPool->SetMaxBytesInFlight(MaxBytesInFlight);
     }
 
-    const EOmniCapturePixelPrecision PixelPrecision = Frame->PixelPrecision;
-    const EOmniCapturePixelDataType PixelDataType = Frame->PixelDataType;
     const FString LayerDirectory = FPaths::GetPath(TargetPath);
     const FString LayerBaseName = FPaths::GetBaseFilename(TargetPath);
     const FString LayerExtension = FPaths::GetExtension(TargetPath, true);
 
-    TFuture<bool> Future = Async(EAsyncExecution::ThreadPool, [this, FilePath = MoveTemp(TargetPath), Format = TargetFormat, bIsLinear, PixelPrecision, PixelDataType, PixelData = MoveTemp(PixelData), AuxiliaryLayers = MoveTemp(AuxiliaryLayers), LayerDirectory, LayerBaseName, LayerExtension]() mutable
+    // The task holds a reference to the frame instead of taking its pixels, since the other sinks share the same frame.
+    WriterPool->Submit([this, Frame, FilePath = MoveTemp(TargetPath), Format = TargetFormat, LayerDirectory, LayerBaseName, LayerExtension]()
     {
+        const FOmniCaptureFrameMetadata& Metadata = Frame->Metadata;
+        const FImagePixelData& PixelData = *Frame->PixelData;
+        const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers = Frame->AuxiliaryLayers;
+        const bool bIsLinear = Frame->bLinearColor;
+        const EOmniCapturePixelPrecision PixelPrecision = Frame->PixelPrecision;
+        const EOmniCapturePixelDataType PixelDataType = Frame->PixelDataType;
+
+        FScopedContainerFrame ContainerFrame(Metadata, FilePath);
+        if (Format == EOmniCaptureImageFormat::Raw)
+        {
+            return WriteRawFrame(Metadata, bIsLinear, PixelData, PixelPrecision, PixelDataType, AuxiliaryLayers);
+        }
+
         if (Format == EOmniCaptureImageFormat::EXR)
         {
-            return WriteEXRFrame(FilePath, bIsLinear, MoveTemp(PixelData), PixelPrecision, PixelDataType, MoveTemp(AuxiliaryLayers), LayerDirectory, LayerBaseName, LayerExtension);
+            return WriteEXRFrame(FilePath, bIsLinear, PixelData, PixelPrecision, PixelDataType, AuxiliaryLayers, LayerDirectory, LayerBaseName, LayerExtension);
         }
 
-        bool bResult = WritePixelDataToDisk(MoveTemp(PixelData), FilePath, Format, bIsLinear, PixelPrecision, PixelDataType);
+        bool bResult = WritePixelDataToDisk(PixelData, FilePath, Format, bIsLinear, PixelPrecision, PixelDataType);
 
-        for (TPair<FName, FOmniCaptureLayerPayload>& Pair : AuxiliaryLayers)
+        for (const TPair<FName, FOmniCaptureLayerPayload>& Pair : AuxiliaryLayers)
         {
             if (!Pair.Value.PixelData.IsValid())
             {
@@ -294,15 +730,11 @@ void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame
                     LayerType = EOmniCapturePixelDataType::Color8;
                 }
             }
-            bResult &= WritePixelDataToDisk(MoveTemp(Pair.Value.PixelData), LayerPath, Format, bLayerLinear, LayerPrecision, LayerType);
+            bResult &= WritePixelDataToDisk(*Pair.Value.PixelData, LayerPath, Format, bLayerLinear, LayerPrecision, LayerType);
         }
 
         return bResult;
-    });
-
-    TrackPendingTask(MoveTemp(Future));
-    PruneCompletedTasks();
-    EnforcePendingTaskLimit();
+    }, PayloadBytes);
 
     {
         FScopeLock Lock(&MetadataCS);
@@ -312,12 +744,34 @@ void FOmniCaptureImageWriter::EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame
 
 void FOmniCaptureImageWriter::Flush()
 {
+    if (WriterPool)
+    {
+        WriterPool->WaitUntilIdle();
+        FinalWriterPoolStats = WriterPool->GetStats();
+    }
+
     RequestStop();
-    PruneCompletedTasks();
-    WaitForAllTasks();
+    WriterPool.Reset();
+    if (RawWriter)
+    {
+        RawWriter->Close();
+        OutputBytesWritten += RawWriter->GetBytesWritten();
+        RawWriter.Reset();
+    }
+    if (Container)
+    {
+        Container->Close();
+        OutputBytesWritten += Container->GetBytesWritten();
+        Container.Reset();
+    }
     bInitialized = false;
 }
 
+FOmniCaptureWriterPoolStats FOmniCaptureImageWriter::GetWriterPoolStats() const
+{
+    return WriterPool ? WriterPool->GetStats() : FinalWriterPoolStats;
+}
+
 TArray<FOmniCaptureFrameMetadata> FOmniCaptureImageWriter::ConsumeCapturedFrames()
 {
     FScopeLock Lock(&MetadataCS);
@@ -326,25 +780,74 @@ TArray<FOmniCaptureFrameMetadata> FOmniCaptureImageWriter::ConsumeCapturedFrames
     return Result;
 }
 
-bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EOmniCaptureImageFormat Format, bool bIsLinear, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const
+FOmniCaptureEXRConcurrency FOmniCaptureImageWriter::ResolveEXRConcurrency(const FOmniCaptureSettings& Settings, int32 CoreCount)
 {
-    if (!PixelData.IsValid())
+    const int32 Cores = FMath::Max(1, CoreCount);
+    const int32 MaxFrames = FMath::Max(1, Settings.MaxPendingImageTasks);
+    const int32 RequestedThreads = FMath::Max(0, Settings.EXRCompressionThreads);
+    const int32 RequestedFrames = FMath::Max(0, Settings.EXRConcurrentFrames);
+
+    // Uncompressed and RLE output is bound by memory bandwidth, not by the codec, so threads inside a file buy nothing.
+    const bool bCheapCompression = Settings.EXRCompression == EOmniCaptureEXRCompression::None || Settings.EXRCompression == EOmniCaptureEXRCompression::Rle;
+
+    FOmniCaptureEXRConcurrency Result;
+    if (RequestedFrames > 0 && RequestedThreads > 0)
     {
-        return false;
+        Result.ConcurrentFrames = RequestedFrames;
+        Result.CompressionThreads = RequestedThreads;
+    }
+    else if (RequestedFrames > 0)
+    {
+        Result.ConcurrentFrames = RequestedFrames;
+        Result.CompressionThreads = bCheapCompression ? 1 : FMath::Max(1, Cores / RequestedFrames);
     }
+    else if (RequestedThreads > 0)
+    {
+        Result.CompressionThreads = RequestedThreads;
+        Result.ConcurrentFrames = FMath::Clamp(Cores / RequestedThreads, 1, MaxFrames);
+    }
+    else if (bCheapCompression)
+    {
+        Result.ConcurrentFrames = FMath::Min(Cores, MaxFrames);
+        Result.CompressionThreads = 1;
+    }
+    else
+    {
+        // Whole frames scale best but each one holds a full frame of memory, so use about a quarter of the cores
+        // that way and let the compression threads take up the rest.
+        Result.ConcurrentFrames = FMath::Clamp(Cores / 4, 1, MaxFrames);
+        Result.CompressionThreads = FMath::Max(1, Cores / Result.ConcurrentFrames);
+    }
+
+    return Result;
+}
+
+FOmniCaptureEXRStagingStats FOmniCaptureImageWriter::GetEXRStagingStats() const
+{
+    FOmniCaptureEXRStagingStats Stats;
+    Stats.StagedBytes = EXRStagedBytes.Load();
+    Stats.ReferencedBytes = EXRReferencedBytes.Load();
+    return Stats;
+}
 
+bool FOmniCaptureImageWriter::WritePixelDataToDisk(const FImagePixelData& SourcePixelData, const FString& FilePath, EOmniCaptureImageFormat Format, bool bIsLinear, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const
+{
     if (IsStopRequested())
     {
         return false;
     }
 
+    // The source belongs to a frame other sinks may still be reading, so widened copies live here instead.
+    const FImagePixelData* PixelData = &SourcePixelData;
+    TUniquePtr<FImagePixelData> ExpandedPixelData;
+
     EOmniCapturePixelDataType EffectiveType = PixelDataType;
 
     if (Format != EOmniCaptureImageFormat::EXR)
     {
         if (EffectiveType == EOmniCapturePixelDataType::ScalarFloat32)
         {
-            const TImagePixelData<float>* ScalarData = static_cast<const TImagePixelData<float>*>(PixelData.Get());
+            const TImagePixelData<float>* ScalarData = static_cast<const TImagePixelData<float>*>(PixelData);
             const FIntPoint Size = ScalarData->GetSize();
             const int32 PixelCount = Size.X * Size.Y;
             TUniquePtr<TImagePixelData<FLinearColor>> Expanded = MakeUnique<TImagePixelData<FLinearColor>>(Size);
@@ -355,14 +858,15 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
                 Expanded->Pixels[Index] = FLinearColor(Value, Value, Value, Value);
             }
 
-            PixelData = MoveTemp(Expanded);
+            ExpandedPixelData = MoveTemp(Expanded);
+            PixelData = ExpandedPixelData.Get();
             PixelPrecision = EOmniCapturePixelPrecision::FullFloat;
             bIsLinear = true;
             EffectiveType = EOmniCapturePixelDataType::LinearColorFloat32;
         }
         else if (EffectiveType == EOmniCapturePixelDataType::Vector2Float32)
         {
-            const TImagePixelData<FVector2f>* VectorData = static_cast<const TImagePixelData<FVector2f>*>(PixelData.Get());
+            const TImagePixelData<FVector2f>* VectorData = static_cast<const TImagePixelData<FVector2f>*>(PixelData);
             const FIntPoint Size = VectorData->GetSize();
             const int32 PixelCount = Size.X * Size.Y;
             TUniquePtr<TImagePixelData<FLinearColor>> Expanded = MakeUnique<TImagePixelData<FLinearColor>>(Size);
@@ -373,7 +877,8 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
                 Expanded->Pixels[Index] = FLinearColor(Value.X, Value.Y, 0.0f, 0.0f);
             }
 
-            PixelData = MoveTemp(Expanded);
+            ExpandedPixelData = MoveTemp(Expanded);
+            PixelData = ExpandedPixelData.Get();
             PixelPrecision = EOmniCapturePixelPrecision::FullFloat;
             bIsLinear = true;
             EffectiveType = EOmniCapturePixelDataType::LinearColorFloat32;
@@ -401,7 +906,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
             {
                 if (RequireType(EOmniCapturePixelDataType::LinearColorFloat32))
                 {
-                    const TImagePixelData<FLinearColor>* FloatData = static_cast<const TImagePixelData<FLinearColor>*>(PixelData.Get());
+                    const TImagePixelData<FLinearColor>* FloatData = static_cast<const TImagePixelData<FLinearColor>*>(PixelData);
                     bWriteSuccessful = WriteJPEGFromLinearFloat32(*FloatData, FilePath);
                 }
             }
@@ -409,7 +914,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
             {
                 if (RequireType(EOmniCapturePixelDataType::LinearColorFloat16))
                 {
-                    const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData.Get());
+                    const TImagePixelData<FFloat16Color>* FloatData = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData);
                     bWriteSuccessful = WriteJPEGFromLinear(*FloatData, FilePath);
                 }
             }
@@ -418,7 +923,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
         {
             if (RequireType(EOmniCapturePixelDataType::Color8))
             {
-                const TImagePixelData<FColor>* ColorData = static_cast<const TImagePixelData<FColor>*>(PixelData.Get());
+                const TImagePixelData<FColor>* ColorData = static_cast<const TImagePixelData<FColor>*>(PixelData);
                 bWriteSuccessful = WriteJPEG(*ColorData, FilePath);
             }
         }
@@ -426,13 +931,13 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
     case EOmniCaptureImageFormat::EXR:
         if (bIsLinear)
         {
-            bWriteSuccessful = WriteEXR(MoveTemp(PixelData), FilePath, PixelPrecision, EffectiveType);
+            bWriteSuccessful = WriteEXR(*PixelData, FilePath, PixelPrecision, EffectiveType);
         }
         else
         {
             if (RequireType(EOmniCapturePixelDataType::Color8))
             {
-                const TImagePixelData<FColor>* SRGBData = static_cast<const TImagePixelData<FColor>*>(PixelData.Get());
+                const TImagePixelData<FColor>* SRGBData = static_cast<const TImagePixelData<FColor>*>(PixelData);
                 bWriteSuccessful = WriteEXRFromColor(*SRGBData, FilePath);
             }
         }
@@ -444,7 +949,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
             {
                 if (RequireType(EOmniCapturePixelDataType::LinearColorFloat32))
                 {
-                    const TImagePixelData<FLinearColor>* LinearBMP = static_cast<const TImagePixelData<FLinearColor>*>(PixelData.Get());
+                    const TImagePixelData<FLinearColor>* LinearBMP = static_cast<const TImagePixelData<FLinearColor>*>(PixelData);
                     bWriteSuccessful = WriteBMPFromLinearFloat32(*LinearBMP, FilePath);
                 }
             }
@@ -452,7 +957,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
             {
                 if (RequireType(EOmniCapturePixelDataType::LinearColorFloat16))
                 {
-                    const TImagePixelData<FFloat16Color>* LinearBMP = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData.Get());
+                    const TImagePixelData<FFloat16Color>* LinearBMP = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData);
                     bWriteSuccessful = WriteBMPFromLinear(*LinearBMP, FilePath);
                 }
             }
@@ -461,7 +966,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
         {
             if (RequireType(EOmniCapturePixelDataType::Color8))
             {
-                const TImagePixelData<FColor>* BmpColor = static_cast<const TImagePixelData<FColor>*>(PixelData.Get());
+                const TImagePixelData<FColor>* BmpColor = static_cast<const TImagePixelData<FColor>*>(PixelData);
                 bWriteSuccessful = WriteBMP(*BmpColor, FilePath);
             }
         }
@@ -474,7 +979,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
             {
                 if (RequireType(EOmniCapturePixelDataType::LinearColorFloat32))
                 {
-                    const TImagePixelData<FLinearColor>* LinearData = static_cast<const TImagePixelData<FLinearColor>*>(PixelData.Get());
+                    const TImagePixelData<FLinearColor>* LinearData = static_cast<const TImagePixelData<FLinearColor>*>(PixelData);
                     bWriteSuccessful = WritePNGFromLinearFloat32(*LinearData, FilePath);
                 }
             }
@@ -482,7 +987,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
             {
                 if (RequireType(EOmniCapturePixelDataType::LinearColorFloat16))
                 {
-                    const TImagePixelData<FFloat16Color>* LinearData = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData.Get());
+                    const TImagePixelData<FFloat16Color>* LinearData = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData);
                     bWriteSuccessful = WritePNGFromLinear(*LinearData, FilePath);
                 }
             }
@@ -491,7 +996,7 @@ bool FOmniCaptureImageWriter::WritePixelDataToDisk(TUniquePtr<FImagePixelData> P
         {
             if (RequireType(EOmniCapturePixelDataType::Color8))
             {
-                const TImagePixelData<FColor>* PngData = static_cast<const TImagePixelData<FColor>*>(PixelData.Get());
+                const TImagePixelData<FColor>* PngData = static_cast<const TImagePixelData<FColor>*>(PixelData);
                 bWriteSuccessful = WritePNG(*PngData, FilePath);
             }
         }
@@ -551,16 +1056,52 @@ bool FOmniCaptureImageWriter::WritePNGRaw(const FString& FilePath, const FIntPoi
         return true;
     }
 
-    if (BitDepth == 8)
+    TArray64<uint8> CompressedData;
+    if (BitDepth == 8 && EncodePNGWithImageWrapper(Size, RawData, RawSizeInBytes, Format, BitDepth, CompressedData))
     {
-        return WritePNGWithImageWrapper(FilePath, Size, RawData, RawSizeInBytes, Format, BitDepth);
+        return SaveOutputFile(CompressedData, FilePath);
     }
 
     return false;
 }
 
+bool FOmniCaptureImageWriter::WritePNGParallel(const FString& FilePath, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, TFunctionRef<void(int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)> PrepareRows) const
+{
+    if (IsStopRequested())
+    {
+        return false;
+    }
+
+    TUniquePtr<FArchive> Archive = CreateOutputArchive(FilePath);
+    if (!Archive.IsValid())
+    {
+        return false;
+    }
+
+    const bool bEncoded = FOmniCaptureParallelPNGEncoder::Encode(*Archive, Size, Format, BitDepth, PNGEncodeOptions, PrepareRows, [this]()
+    {
+        return IsStopRequested();
+    });
+
+    if (!bEncoded)
+    {
+        Archive->SetError();
+    }
+    if (!CloseOutputArchive(*Archive))
+    {
+        IFileManager::Get().Delete(*FilePath, false, true, true);
+        return false;
+    }
+    return true;
+}
+
 bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, TFunctionRef<void(int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)> PrepareRows) const
 {
+    if (bParallelPNGEncoding)
+    {
+        return WritePNGParallel(FilePath, Size, Format, BitDepth, PrepareRows);
+    }
+
 #if WITH_LIBPNG
     const int32 Channels = GetChannelCountForFormat(Format);
     if (Channels <= 0 || BitDepth <= 0 || Size.X <= 0 || Size.Y <= 0)
@@ -591,8 +1132,7 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
         return false;
     }
 
-    IFileManager::Get().Delete(*FilePath, false, true, false);
-    TUniquePtr<FArchive> Archive(IFileManager::Get().CreateFileWriter(*FilePath));
+    TUniquePtr<FArchive> Archive = CreateOutputArchive(FilePath);
     if (!Archive.IsValid())
     {
         return false;
@@ -601,6 +1141,7 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
     png_structp PngPtr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
     if (!PngPtr)
     {
+        Archive->SetError();
         Archive->Close();
         return false;
     }
@@ -609,6 +1150,7 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
     if (!InfoPtr)
     {
         png_destroy_write_struct(&PngPtr, nullptr);
+        Archive->SetError();
         Archive->Close();
         return false;
     }
@@ -616,6 +1158,7 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
     if (setjmp(png_jmpbuf(PngPtr)))
     {
         png_destroy_write_struct(&PngPtr, &InfoPtr);
+        Archive->SetError();
         Archive->Close();
         IFileManager::Get().Delete(*FilePath, false, true, true);
         return false;
@@ -623,6 +1166,8 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
 
     png_set_write_fn(PngPtr, Archive.Get(), PngWriteDataCallback, PngFlushCallback);
     png_set_IHDR(PngPtr, InfoPtr, Size.X, Size.Y, BitDepth, ColorType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+    png_set_compression_level(PngPtr, PNGEncodeOptions.CompressionLevel);
+    png_set_compression_strategy(PngPtr, FOmniCaptureParallelPNGEncoder::ToZlibStrategy(PNGEncodeOptions.Strategy));
 
     if (BitDepth == 16)
     {
@@ -650,6 +1195,7 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
         if (IsStopRequested())
         {
             png_destroy_write_struct(&PngPtr, &InfoPtr);
+            Archive->SetError();
             Archive->Close();
             IFileManager::Get().Delete(*FilePath, false, true, true);
             return false;
@@ -665,8 +1211,7 @@ bool FOmniCaptureImageWriter::WritePNGWithRowSource(const FString& FilePath, con
     png_write_end(PngPtr, InfoPtr);
     png_destroy_write_struct(&PngPtr, &InfoPtr);
 
-    Archive->Close();
-    return !Archive->IsError();
+    return CloseOutputArchive(*Archive);
 #else
     return false;
 #endif
@@ -767,8 +1312,7 @@ bool FOmniCaptureImageWriter::WriteBMP(const TImagePixelData<FColor>& PixelData,
         return false;
     }
 
-    IFileManager::Get().Delete(*FilePath, false, true, false);
-    return FFileHelper::SaveArrayToFile(CompressedData, *FilePath);
+    return SaveOutputFile(CompressedData, FilePath);
 }
 
 bool FOmniCaptureImageWriter::WritePNGFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const
@@ -854,7 +1398,9 @@ bool FOmniCaptureImageWriter::WritePNGFromLinear(const TImagePixelData<FFloat16C
         return true;
     }
 
-    return WritePNGWithImageWrapper(FilePath, Size, ConvertedPixels.GetData(), ConvertedPixels.Num(), ERGBFormat::BGRA, 8);
+    TArray64<uint8> CompressedData;
+    return EncodePNGWithImageWrapper(Size, ConvertedPixels.GetData(), ConvertedPixels.Num(), ERGBFormat::BGRA, 8, CompressedData)
+        && SaveOutputFile(CompressedData, FilePath);
 }
 
 bool FOmniCaptureImageWriter::WritePNGFromLinearFloat32(const TImagePixelData<FLinearColor>& PixelData, const FString& FilePath) const
@@ -1018,8 +1564,7 @@ bool FOmniCaptureImageWriter::WriteJPEG(const TImagePixelData<FColor>& PixelData
         return false;
     }
 
-    IFileManager::Get().Delete(*FilePath, false, true, false);
-    return FFileHelper::SaveArrayToFile(CompressedData, *FilePath);
+    return SaveOutputFile(CompressedData, FilePath);
 }
 
 bool FOmniCaptureImageWriter::WriteJPEGFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const
@@ -1079,19 +1624,14 @@ bool FOmniCaptureImageWriter::WriteJPEGFromLinearFloat32(const TImagePixelData<F
     return WriteJPEG(*TempData, FilePath);
 }
 
-bool FOmniCaptureImageWriter::WriteEXRFrame(const FString& FilePath, bool bIsLinear, TUniquePtr<FImagePixelData> PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, TMap<FName, FOmniCaptureLayerPayload>&& AuxiliaryLayers, const FString& LayerDirectory, const FString& LayerBaseName, const FString& LayerExtension) const
+bool FOmniCaptureImageWriter::WriteEXRFrame(const FString& FilePath, bool bIsLinear, const FImagePixelData& PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers, const FString& LayerDirectory, const FString& LayerBaseName, const FString& LayerExtension) const
 {
-    if (!PixelData.IsValid())
-    {
-        return false;
-    }
-
     TArray<FExrLayerRequest> Layers;
     Layers.Reserve(1 + AuxiliaryLayers.Num());
 
     FExrLayerRequest& BeautyLayer = Layers.Emplace_GetRef();
     BeautyLayer.Name = TEXT("Beauty");
-    BeautyLayer.PixelData = MoveTemp(PixelData);
+    BeautyLayer.PixelData = &PixelData;
     BeautyLayer.bLinear = bIsLinear;
     BeautyLayer.Precision = PixelPrecision;
     BeautyLayer.PixelDataType = PixelDataType;
@@ -1102,7 +1642,7 @@ bool FOmniCaptureImageWriter::WriteEXRFrame(const FString& FilePath, bool bIsLin
             : EOmniCapturePixelDataType::LinearColorFloat16;
     }
 
-    for (TPair<FName, FOmniCaptureLayerPayload>& Pair : AuxiliaryLayers)
+    for (const TPair<FName, FOmniCaptureLayerPayload>& Pair : AuxiliaryLayers)
     {
         if (!Pair.Value.PixelData.IsValid())
         {
@@ -1111,7 +1651,7 @@ bool FOmniCaptureImageWriter::WriteEXRFrame(const FString& FilePath, bool bIsLin
 
         FExrLayerRequest& Request = Layers.Emplace_GetRef();
         Request.Name = Pair.Key.ToString();
-        Request.PixelData = MoveTemp(Pair.Value.PixelData);
+        Request.PixelData = Pair.Value.PixelData.Get();
         Request.bLinear = Pair.Value.bLinear;
         Request.Precision = (Pair.Value.Precision == EOmniCapturePixelPrecision::Unknown) ? PixelPrecision : Pair.Value.Precision;
         Request.PixelDataType = Pair.Value.PixelDataType;
@@ -1146,22 +1686,47 @@ bool FOmniCaptureImageWriter::WriteEXRFrame(const FString& FilePath, bool bIsLin
 #endif
     }
 
+#if WITH_OMNICAPTURE_OPENEXR
+    if (bWriteTiledEXR)
+    {
+        // The engine's EXR writer only produces scanline images, so tiled layers go through OpenEXR one file each.
+        bool bTiledResult = true;
+        for (int32 Index = 0; Index < Layers.Num(); ++Index)
+        {
+            if (!Layers[Index].PixelData)
+            {
+                continue;
+            }
+
+            const FString LayerPath = (Index == 0) ? FilePath : FPaths::Combine(LayerDirectory, FString::Printf(TEXT("%s_%s%s"), *LayerBaseName, *Layers[Index].Name, *LayerExtension));
+            TArray<FExrLayerRequest> SingleLayer;
+            SingleLayer.Add(Layers[Index]);
+            if (!WriteCombinedEXR(LayerPath, SingleLayer))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Falling back to scanline EXR output for %s"), *LayerPath);
+                bTiledResult &= WriteEXR(*SingleLayer[0].PixelData, LayerPath, SingleLayer[0].Precision, SingleLayer[0].PixelDataType);
+            }
+        }
+        return bTiledResult;
+    }
+#endif
+
     bool bResult = true;
     if (Layers.Num() > 0)
     {
-        bResult = WriteEXR(MoveTemp(Layers[0].PixelData), FilePath, Layers[0].Precision, Layers[0].PixelDataType);
+        bResult = WriteEXR(*Layers[0].PixelData, FilePath, Layers[0].Precision, Layers[0].PixelDataType);
     }
 
     for (int32 Index = 1; Index < Layers.Num(); ++Index)
     {
-        if (!Layers[Index].PixelData.IsValid())
+        if (!Layers[Index].PixelData)
         {
             continue;
         }
 
         const FString LayerFileName = FString::Printf(TEXT("%s_%s%s"), *LayerBaseName, *Layers[Index].Name, *LayerExtension);
         const FString LayerPath = FPaths::Combine(LayerDirectory, LayerFileName);
-        bResult &= WriteEXR(MoveTemp(Layers[Index].PixelData), LayerPath, Layers[Index].Precision, Layers[Index].PixelDataType);
+        bResult &= WriteEXR(*Layers[Index].PixelData, LayerPath, Layers[Index].Precision, Layers[Index].PixelDataType);
     }
 
     return bResult;
@@ -1180,7 +1745,7 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
         return false;
     }
 
-    const FIntPoint ExpectedSize = Layers[0].PixelData.IsValid() ? Layers[0].PixelData->GetSize() : FIntPoint::ZeroValue;
+    const FIntPoint ExpectedSize = Layers[0].PixelData ? Layers[0].PixelData->GetSize() : FIntPoint::ZeroValue;
     if (ExpectedSize.X <= 0 || ExpectedSize.Y <= 0)
     {
         return false;
@@ -1194,10 +1759,12 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
 
     TArray<FPreparedExrLayer> PreparedLayers;
     PreparedLayers.Reserve(Layers.Num());
+    int64 StagedBytes = 0;
+    int64 ReferencedBytes = 0;
 
     for (FExrLayerRequest& Layer : Layers)
     {
-        if (!Layer.PixelData.IsValid())
+        if (!Layer.PixelData)
         {
             return false;
         }
@@ -1211,65 +1778,35 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
         FPreparedExrLayer& Prepared = PreparedLayers.Emplace_GetRef();
         FTCHARToUTF8 NameUtf8(*Layer.Name);
         Prepared.Name = std::string(NameUtf8.Length() > 0 ? NameUtf8.Get() : "");
-        Prepared.ChannelCount = 4;
-
-        const FImagePixelData* PixelData = Layer.PixelData.Get();
-        EOmniCapturePixelPrecision Precision = Layer.Precision;
-        if (Precision == EOmniCapturePixelPrecision::Unknown)
-        {
-            Precision = EOmniCapturePixelPrecision::HalfFloat;
-        }
 
+        // Strided slices let OpenEXR read each channel straight out of the frame's pixel array, so only payloads
+        // without a matching EXR channel type are converted.
+        const FImagePixelData* PixelData = Layer.PixelData;
         switch (Layer.PixelDataType)
         {
         case EOmniCapturePixelDataType::LinearColorFloat32:
-        {
-            const TImagePixelData<FLinearColor>* Float32Data = static_cast<const TImagePixelData<FLinearColor>*>(PixelData);
-            Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::FLOAT;
-            Prepared.FloatBuffer.SetNum(PixelCount * 4);
-
-            for (int64 Index = 0; Index < PixelCount; ++Index)
-            {
-                const FLinearColor& Src = Float32Data->Pixels[Index];
-                const int64 Base = Index * 4;
-                Prepared.FloatBuffer[Base + 0] = Src.R;
-                Prepared.FloatBuffer[Base + 1] = Src.G;
-                Prepared.FloatBuffer[Base + 2] = Src.B;
-                Prepared.FloatBuffer[Base + 3] = Src.A;
-            }
+            Prepared.Reference(*static_cast<const TImagePixelData<FLinearColor>*>(PixelData), OPENEXR_IMF_NAMESPACE::PixelType::FLOAT, 4);
             break;
-        }
         case EOmniCapturePixelDataType::LinearColorFloat16:
-        {
-            const TImagePixelData<FFloat16Color>* Float16Data = static_cast<const TImagePixelData<FFloat16Color>*>(PixelData);
-            Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::HALF;
-            Prepared.HalfBuffer.SetNum(PixelCount * 4);
-
-            for (int64 Index = 0; Index < PixelCount; ++Index)
-            {
-                const FFloat16Color& Src = Float16Data->Pixels[Index];
-                const int64 Base = Index * 4;
-                Prepared.HalfBuffer[Base + 0] = IMATH_NAMESPACE::half(Src.R.GetFloat());
-                Prepared.HalfBuffer[Base + 1] = IMATH_NAMESPACE::half(Src.G.GetFloat());
-                Prepared.HalfBuffer[Base + 2] = IMATH_NAMESPACE::half(Src.B.GetFloat());
-                Prepared.HalfBuffer[Base + 3] = IMATH_NAMESPACE::half(Src.A.GetFloat());
-            }
+            Prepared.Reference(*static_cast<const TImagePixelData<FFloat16Color>*>(PixelData), OPENEXR_IMF_NAMESPACE::PixelType::HALF, 4);
+            break;
+        case EOmniCapturePixelDataType::ScalarFloat32:
+            Prepared.Reference(*static_cast<const TImagePixelData<float>*>(PixelData), OPENEXR_IMF_NAMESPACE::PixelType::FLOAT, 1);
+            break;
+        case EOmniCapturePixelDataType::Vector2Float32:
+            Prepared.Reference(*static_cast<const TImagePixelData<FVector2f>*>(PixelData), OPENEXR_IMF_NAMESPACE::PixelType::FLOAT, 2);
             break;
-        }
         case EOmniCapturePixelDataType::Color8:
         {
-            const TImagePixelData<FColor>* ColorData = static_cast<const TImagePixelData<FColor>*>(PixelData);
+            // EXR has no 8-bit channel type. Tiled writes convert a tile row at a time; scanline writes convert up front.
             Prepared.PixelType = OPENEXR_IMF_NAMESPACE::PixelType::FLOAT;
-            Prepared.FloatBuffer.SetNum(PixelCount * 4);
-
-            for (int64 Index = 0; Index < PixelCount; ++Index)
+            Prepared.ChannelCount = 4;
+            Prepared.Color8Source = static_cast<const TImagePixelData<FColor>*>(PixelData)->Pixels.GetData();
+            if (!bWriteTiledEXR)
             {
-                const FLinearColor Src = ColorData->Pixels[Index].ReinterpretAsLinear();
-                const int64 Base = Index * 4;
-                Prepared.FloatBuffer[Base + 0] = Src.R;
-                Prepared.FloatBuffer[Base + 1] = Src.G;
-                Prepared.FloatBuffer[Base + 2] = Src.B;
-                Prepared.FloatBuffer[Base + 3] = Src.A;
+                Prepared.ConvertColor8Rows(ExpectedSize.X, 0, ExpectedSize.Y);
+                Prepared.BasePointer = reinterpret_cast<const char*>(Prepared.StagingBuffer.GetData());
+                Prepared.Color8Source = nullptr;
             }
             break;
         }
@@ -1277,15 +1814,113 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
             UE_LOG(LogTemp, Warning, TEXT("Unsupported pixel payload for EXR layer '%s'"), *Layer.Name);
             return false;
         }
+
+        if (!bZeroCopyEXRLayers && Prepared.StagingBuffer.Num() == 0 && !Prepared.Color8Source)
+        {
+            Prepared.Stage(PixelCount);
+        }
+
+        if (Prepared.Color8Source)
+        {
+            StagedBytes += static_cast<int64>(FMath::Min(EXRTileSize, ExpectedSize.Y)) * ExpectedSize.X * sizeof(FLinearColor);
+        }
+        else if (Prepared.StagingBuffer.Num() > 0)
+        {
+            StagedBytes += Prepared.StagingBuffer.Num();
+        }
+        else
+        {
+            ReferencedBytes += PixelCount * static_cast<int64>(Prepared.GetPixelStride());
+        }
     }
 
+    EXRStagedBytes += StagedBytes;
+    EXRReferencedBytes += ReferencedBytes;
+
     IFileManager::Get().Delete(*FilePath, false, true, false);
 
+    // OpenEXR treats 0 as "compress on this thread"; anything above hands line blocks to the global pool.
+    const int32 FileThreadCount = EXRConcurrency.CompressionThreads > 1 ? EXRConcurrency.CompressionThreads : 0;
     bool bSucceeded = false;
 
     try
     {
-        if (bUseEXRMultiPart)
+        // OpenEXR writes to disk through its own file stream, or into memory when the file goes to the container.
+        const FTCHARToUTF8 FilePathUtf8(*FilePath);
+        TUniquePtr<FExrMemoryOStream> MemoryStream;
+        TUniquePtr<OPENEXR_IMF_NAMESPACE::StdOFStream> FileStream;
+        if (Container)
+        {
+            MemoryStream = MakeUnique<FExrMemoryOStream>(FilePathUtf8.Get());
+        }
+        else
+        {
+            FileStream = MakeUnique<OPENEXR_IMF_NAMESPACE::StdOFStream>(FilePathUtf8.Get());
+        }
+        OPENEXR_IMF_NAMESPACE::OStream& Stream = MemoryStream.IsValid() ? static_cast<OPENEXR_IMF_NAMESPACE::OStream&>(*MemoryStream) : *FileStream;
+
+        if (bWriteTiledEXR)
+        {
+            using namespace OPENEXR_IMF_NAMESPACE;
+
+            TArray<FPreparedExrLayer*> LayerPointers;
+            for (FPreparedExrLayer& Prepared : PreparedLayers)
+            {
+                LayerPointers.Add(&Prepared);
+            }
+
+            const TileDescription Tiles(EXRTileSize, EXRTileSize, ToOpenExrLevelMode(EXRTileLevels), ROUND_DOWN);
+            const auto MakeTiledHeader = [&](TArrayView<FPreparedExrLayer* const> PartLayers, bool bPrefixLayerNames)
+            {
+                Header TiledHeader(ExpectedSize.X, ExpectedSize.Y);
+                TiledHeader.compression() = ToOpenExrCompression(TargetEXRCompression);
+                // Tiles are written in row order, which keeps a viewer reading one region from seeking all over the file.
+                TiledHeader.lineOrder() = INCREASING_Y;
+                TiledHeader.setTileDescription(Tiles);
+                for (const FPreparedExrLayer* Prepared : PartLayers)
+                {
+                    for (int32 ChannelIndex = 0; ChannelIndex < Prepared->ChannelCount; ++ChannelIndex)
+                    {
+                        TiledHeader.channels().insert(GetExrChannelName(*Prepared, ChannelIndex, bPrefixLayerNames).c_str(), Channel(Prepared->PixelType));
+                    }
+                }
+                return TiledHeader;
+            };
+            const auto ShouldCancel = [this]()
+            {
+                return IsStopRequested();
+            };
+
+            if (bUseEXRMultiPart && LayerPointers.Num() > 1)
+            {
+                TArray<Header> Headers;
+                Headers.Reserve(LayerPointers.Num());
+                for (int32 PartIndex = 0; PartIndex < LayerPointers.Num(); ++PartIndex)
+                {
+                    Header& PartHeader = Headers.Add_GetRef(MakeTiledHeader(MakeArrayView(&LayerPointers[PartIndex], 1), false));
+                    PartHeader.setType(TILEDIMAGE);
+                    if (!LayerPointers[PartIndex]->Name.empty())
+                    {
+                        PartHeader.setName(LayerPointers[PartIndex]->Name.c_str());
+                    }
+                }
+
+                MultiPartOutputFile OutputFile(Stream, Headers.GetData(), Headers.Num(), false, FileThreadCount);
+                for (int32 PartIndex = 0; PartIndex < LayerPointers.Num(); ++PartIndex)
+                {
+                    TiledOutputPart Part(OutputFile, PartIndex);
+                    WriteExrTiles(Part, MakeArrayView(&LayerPointers[PartIndex], 1), ExpectedSize, false, ShouldCancel);
+                }
+            }
+            else
+            {
+                // A lone layer keeps bare R/G/B/A names so it reads like any other single-layer EXR.
+                const bool bPrefixLayerNames = LayerPointers.Num() > 1;
+                TiledOutputFile OutputFile(Stream, MakeTiledHeader(LayerPointers, bPrefixLayerNames), FileThreadCount);
+                WriteExrTiles(OutputFile, LayerPointers, ExpectedSize, bPrefixLayerNames, ShouldCancel);
+            }
+        }
+        else if (bUseEXRMultiPart)
         {
             TArray<OPENEXR_IMF_NAMESPACE::Header> Headers;
             TArray<OPENEXR_IMF_NAMESPACE::FrameBuffer> FrameBuffers;
@@ -1308,20 +1943,18 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
                     FTCHARToUTF8 ChannelUtf8(ChannelSuffix);
                     Header.channels().insert(ChannelUtf8.Get(), OPENEXR_IMF_NAMESPACE::Channel(Prepared.PixelType));
 
-                    const char* BasePtr = Prepared.GetBasePointer();
-                    const int32 ComponentSize = Prepared.GetComponentSize();
-                    const size_t PixelStride = static_cast<size_t>(ComponentSize) * Prepared.ChannelCount;
+                    const size_t PixelStride = Prepared.GetPixelStride();
                     const size_t RowStride = PixelStride * ExpectedSize.X;
-                    const size_t ChannelOffset = static_cast<size_t>(ComponentSize) * ChannelIndex;
+                    const size_t ChannelOffset = static_cast<size_t>(Prepared.GetComponentSize()) * ChannelIndex;
 
-                    Buffer.insert(ChannelUtf8.Get(), OPENEXR_IMF_NAMESPACE::Slice(Prepared.PixelType, const_cast<char*>(BasePtr) + ChannelOffset, PixelStride, RowStride));
+                    Buffer.insert(ChannelUtf8.Get(), OPENEXR_IMF_NAMESPACE::Slice(Prepared.PixelType, const_cast<char*>(Prepared.BasePointer) + ChannelOffset, PixelStride, RowStride));
                 }
 
                 Headers.Add(Header);
                 FrameBuffers.Add(Buffer);
             }
 
-            OPENEXR_IMF_NAMESPACE::MultiPartOutputFile OutputFile(TCHAR_TO_UTF8(*FilePath), Headers.GetData(), Headers.Num());
+            OPENEXR_IMF_NAMESPACE::MultiPartOutputFile OutputFile(Stream, Headers.GetData(), Headers.Num(), false, FileThreadCount);
             for (int32 PartIndex = 0; PartIndex < Headers.Num(); ++PartIndex)
             {
                 OPENEXR_IMF_NAMESPACE::OutputPart Part(OutputFile, PartIndex);
@@ -1346,36 +1979,35 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
 
                     Header.channels().insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Channel(Prepared.PixelType));
 
-                    const char* BasePtr = Prepared.GetBasePointer();
-                    const int32 ComponentSize = Prepared.GetComponentSize();
-                    const size_t PixelStride = static_cast<size_t>(ComponentSize) * Prepared.ChannelCount;
+                    const size_t PixelStride = Prepared.GetPixelStride();
                     const size_t RowStride = PixelStride * ExpectedSize.X;
-                    const size_t ChannelOffset = static_cast<size_t>(ComponentSize) * ChannelIndex;
+                    const size_t ChannelOffset = static_cast<size_t>(Prepared.GetComponentSize()) * ChannelIndex;
 
-                    FrameBuffer.insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Slice(Prepared.PixelType, const_cast<char*>(BasePtr) + ChannelOffset, PixelStride, RowStride));
+                    FrameBuffer.insert(ChannelName.c_str(), OPENEXR_IMF_NAMESPACE::Slice(Prepared.PixelType, const_cast<char*>(Prepared.BasePointer) + ChannelOffset, PixelStride, RowStride));
                 }
             }
 
-            OPENEXR_IMF_NAMESPACE::OutputFile OutputFile(TCHAR_TO_UTF8(*FilePath), Header);
+            OPENEXR_IMF_NAMESPACE::OutputFile OutputFile(Stream, Header, FileThreadCount);
             OutputFile.setFrameBuffer(FrameBuffer);
             OutputFile.writePixels(ExpectedSize.Y);
         }
 
-        bSucceeded = true;
+        if (MemoryStream.IsValid())
+        {
+            bSucceeded = AppendToContainer(FilePath, MemoryStream->Bytes.GetData(), MemoryStream->Bytes.Num());
+        }
+        else
+        {
+            // OutputFile leaves the stream at the end of the file once it has written its offset table.
+            OutputBytesWritten += static_cast<int64>(FileStream->tellp());
+            bSucceeded = true;
+        }
     }
     catch (const std::exception& Exception)
     {
         UE_LOG(LogTemp, Warning, TEXT("Failed to write multi-layer EXR '%s': %s"), *FilePath, UTF8_TO_TCHAR(Exception.what()));
     }
 
-    if (bSucceeded)
-    {
-        for (FExrLayerRequest& Layer : Layers)
-        {
-            Layer.PixelData.Reset();
-        }
-    }
-
     return bSucceeded;
 }
 #endif // WITH_OMNICAPTURE_OPENEXR
@@ -1388,13 +2020,8 @@ bool FOmniCaptureImageWriter::WriteCombinedEXR(const FString& FilePath, TArray<F
 }
 #endif
 
-bool FOmniCaptureImageWriter::WriteEXR(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const
+bool FOmniCaptureImageWriter::WriteEXR(const FImagePixelData& PixelData, const FString& FilePath, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const
 {
-    if (!PixelData.IsValid())
-    {
-        return false;
-    }
-
     if (IsStopRequested())
     {
         return false;
@@ -1431,7 +2058,7 @@ bool FOmniCaptureImageWriter::WriteEXR(TUniquePtr<FImagePixelData> PixelData, co
     }
 
     IFileManager::Get().Delete(*FilePath, false, true, false);
-    return WriteEXRInternal(MoveTemp(PixelData), FilePath, PixelType);
+    return WriteEXRInternal(PixelData, FilePath, PixelType);
 }
 
 bool FOmniCaptureImageWriter::WriteEXRFromColor(const TImagePixelData<FColor>& PixelData, const FString& FilePath) const
@@ -1457,16 +2084,11 @@ bool FOmniCaptureImageWriter::WriteEXRFromColor(const TImagePixelData<FColor>& P
 
     TUniquePtr<TImagePixelData<FFloat16Color>> TempData = MakeUnique<TImagePixelData<FFloat16Color>>(Size);
     TempData->Pixels = MoveTemp(Converted);
-    return WriteEXR(MoveTemp(TempData), FilePath, EOmniCapturePixelPrecision::HalfFloat, EOmniCapturePixelDataType::LinearColorFloat16);
+    return WriteEXR(*TempData, FilePath, EOmniCapturePixelPrecision::HalfFloat, EOmniCapturePixelDataType::LinearColorFloat16);
 }
 
-bool FOmniCaptureImageWriter::WriteEXRInternal(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EImagePixelType PixelType) const
+bool FOmniCaptureImageWriter::WriteEXRInternal(const FImagePixelData& PixelData, const FString& FilePath, EImagePixelType PixelType) const
 {
-    if (!PixelData.IsValid())
-    {
-        return false;
-    }
-
     if (IsStopRequested())
     {
         return false;
@@ -1476,7 +2098,7 @@ bool FOmniCaptureImageWriter::WriteEXRInternal(TUniquePtr<FImagePixelData> Pixel
 #if WITH_OMNICAPTURE_OPENEXR
     TArray<FExrLayerRequest> Layers;
     FExrLayerRequest& Layer = Layers.Emplace_GetRef();
-    Layer.PixelData = MoveTemp(PixelData);
+    Layer.PixelData = &PixelData;
     Layer.bLinear = true;
     Layer.Precision = (PixelType == EImagePixelType::Float32)
         ? EOmniCapturePixelPrecision::FullFloat
@@ -1488,6 +2110,21 @@ bool FOmniCaptureImageWriter::WriteEXRInternal(TUniquePtr<FImagePixelData> Pixel
     return false;
 #endif // WITH_OMNICAPTURE_OPENEXR
 #else
+    if (Container)
+    {
+        // The engine's write queue only writes files, so encode through the image wrapper instead.
+        const void* RawData = nullptr;
+        int64 RawSizeInBytes = 0;
+        PixelData.GetRawData(RawData, RawSizeInBytes);
+        const TSharedPtr<IImageWrapper> ImageWrapper = CreateImageWrapper(EImageFormat::EXR);
+        const int32 BitDepth = (PixelType == EImagePixelType::Float32) ? 32 : 16;
+        if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(static_cast<const uint8*>(RawData), RawSizeInBytes, PixelData.GetSize().X, PixelData.GetSize().Y, ERGBFormat::RGBAF, BitDepth))
+        {
+            return false;
+        }
+        return SaveOutputFile(ImageWrapper->GetCompressed(0), FilePath);
+    }
+
     IImageWriteQueueModule& ImageWriteModule = FModuleManager::LoadModuleChecked<IImageWriteQueueModule>(TEXT("ImageWriteQueue"));
     IImageWriteQueue& WriteQueue = ImageWriteModule.GetWriteQueue();
 
@@ -1497,7 +2134,8 @@ bool FOmniCaptureImageWriter::WriteEXRInternal(TUniquePtr<FImagePixelData> Pixel
     TUniquePtr<FImageWriteTask> Task = WriteQueue.CreateTask(EImageWriteTaskType::HighPriority);
     Task->Format = EImageFormat::EXR;
     Task->Filename = FilePath;
-    Task->PixelData = MoveTemp(PixelData);
+    // The write queue takes ownership of what it writes, and the caller's pixels may still be read by other sinks.
+    Task->PixelData = PixelData.CopyImageData();
     Task->PixelType = PixelType;
     Task->CompressionQuality = static_cast<int32>(EImageCompressionQuality::Default);
     Task->bOverwriteFile = true;
@@ -1507,122 +2145,115 @@ bool FOmniCaptureImageWriter::WriteEXRInternal(TUniquePtr<FImagePixelData> Pixel
     });
 
     WriteQueue.Enqueue(MoveTemp(Task));
-    return CompletionFuture.Get();
-#endif // OMNICAPTURE_UE_VERSION_AT_LEAST(5, 5, 0)
-}
-
-void FOmniCaptureImageWriter::RequestStop()
-{
-    bStopRequested.Store(true);
-}
+    if (!CompletionFuture.Get())
+    {
+        return false;
+    }
 
-bool FOmniCaptureImageWriter::IsStopRequested() const
-{
-    return bStopRequested.Load();
+    // The write queue does not report sizes; one stat of the file just written.
+    OutputBytesWritten += FMath::Max<int64>(0, IFileManager::Get().FileSize(*FilePath));
+    return true;
+#endif // OMNICAPTURE_UE_VERSION_AT_LEAST(5, 5, 0)
 }
 
-void FOmniCaptureImageWriter::WaitForAvailableTaskSlot()
+bool FOmniCaptureImageWriter::WriteRawFrame(const FOmniCaptureFrameMetadata& Metadata, bool bIsLinear, const FImagePixelData& PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers) const
 {
-    if (MaxPendingTasks <= 0)
+    if (!RawWriter || IsStopRequested())
     {
-        return;
+        return false;
     }
 
-    while (!IsStopRequested())
+    bool bResult = RawWriter->WritePayload(Metadata, NAME_None, PixelData, PixelDataType, PixelPrecision, bIsLinear);
+    for (const TPair<FName, FOmniCaptureLayerPayload>& Pair : AuxiliaryLayers)
     {
-        TFuture<bool> TaskToWait;
+        if (Pair.Value.PixelData.IsValid())
         {
-            FScopeLock Lock(&PendingTasksCS);
-            if (PendingTasks.Num() < MaxPendingTasks)
-            {
-                break;
-            }
-
-            TaskToWait = MoveTemp(PendingTasks[0]);
-            PendingTasks.RemoveAt(0, 1, EAllowShrinking::No);
-        }
-
-        if (TaskToWait.IsValid())
-        {
-            const bool bResult = TaskToWait.Get();
-            if (!bResult)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("OmniCapture image write task failed"));
-            }
+            const EOmniCapturePixelPrecision LayerPrecision = (Pair.Value.Precision == EOmniCapturePixelPrecision::Unknown) ? PixelPrecision : Pair.Value.Precision;
+            bResult &= RawWriter->WritePayload(Metadata, Pair.Key, *Pair.Value.PixelData, Pair.Value.PixelDataType, LayerPrecision, Pair.Value.bLinear);
         }
     }
+    return bResult;
 }
 
-void FOmniCaptureImageWriter::TrackPendingTask(TFuture<bool>&& TaskFuture)
-{
-    FScopeLock Lock(&PendingTasksCS);
-    PendingTasks.Add(MoveTemp(TaskFuture));
-}
-
-void FOmniCaptureImageWriter::PruneCompletedTasks()
+TUniquePtr<FArchive> FOmniCaptureImageWriter::CreateOutputArchive(const FString& FilePath) const
 {
-    FScopeLock Lock(&PendingTasksCS);
-    for (int32 Index = PendingTasks.Num() - 1; Index >= 0; --Index)
+    if (Container)
     {
-        if (PendingTasks[Index].IsReady())
+        return MakeUnique<FContainerEntryArchive>([this, FilePath](const TArray64<uint8>& Bytes)
         {
-            const bool bResult = PendingTasks[Index].Get();
-            if (!bResult)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("OmniCapture image write task failed"));
-            }
-            PendingTasks.RemoveAtSwap(Index, 1, EAllowShrinking::No);
-        }
+            return AppendToContainer(FilePath, Bytes.GetData(), Bytes.Num());
+        });
     }
+
+    IFileManager::Get().Delete(*FilePath, false, true, false);
+    return TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*FilePath));
 }
 
-void FOmniCaptureImageWriter::EnforcePendingTaskLimit()
+bool FOmniCaptureImageWriter::SaveOutputFile(const TArray64<uint8>& Data, const FString& FilePath) const
 {
-    if (MaxPendingTasks <= 0)
+    if (Data.Num() == 0)
     {
-        return;
+        return false;
     }
 
-    while (true)
+    if (Container)
     {
-        TFuture<bool> TaskToWait;
-        {
-            FScopeLock Lock(&PendingTasksCS);
-            if (PendingTasks.Num() <= MaxPendingTasks)
-            {
-                break;
-            }
-
-            TaskToWait = MoveTemp(PendingTasks[0]);
-            PendingTasks.RemoveAt(0, 1, EAllowShrinking::No);
-        }
+        return AppendToContainer(FilePath, Data.GetData(), Data.Num());
+    }
 
-        if (TaskToWait.IsValid())
-        {
-            const bool bResult = TaskToWait.Get();
-            if (!bResult)
-            {
-                UE_LOG(LogTemp, Warning, TEXT("OmniCapture image write task failed"));
-            }
-        }
+    IFileManager::Get().Delete(*FilePath, false, true, false);
+    if (!FFileHelper::SaveArrayToFile(Data, *FilePath))
+    {
+        return false;
     }
+    OutputBytesWritten += Data.Num();
+    return true;
 }
 
-void FOmniCaptureImageWriter::WaitForAllTasks()
+bool FOmniCaptureImageWriter::AppendToContainer(const FString& FilePath, const uint8* Data, int64 Size) const
 {
-    TArray<TFuture<bool>> TasksToWait;
+    // Images written outside a frame task, such as a still, are filed as frame 0.
+    const FOmniCaptureFrameMetadata DefaultMetadata;
+    const FOmniCaptureFrameMetadata& Metadata = GContainerFrameContext.Metadata ? *GContainerFrameContext.Metadata : DefaultMetadata;
+    const bool bPrimary = !GContainerFrameContext.PrimaryPath || *GContainerFrameContext.PrimaryPath == FilePath;
+    return Container->Append(FPaths::GetCleanFilename(FilePath), Metadata, bPrimary, Data, Size);
+}
+
+bool FOmniCaptureImageWriter::CloseOutputArchive(FArchive& Archive) const
+{
+    // Container archives are counted when they append.
+    const int64 ArchiveBytes = Archive.Tell();
+    Archive.Close();
+    if (Archive.IsError())
     {
-        FScopeLock Lock(&PendingTasksCS);
-        TasksToWait = MoveTemp(PendingTasks);
-        PendingTasks.Reset();
+        return false;
     }
 
-    for (TFuture<bool>& Task : TasksToWait)
+    if (!Container)
     {
-        const bool bResult = Task.Get();
-        if (!bResult)
-        {
-            UE_LOG(LogTemp, Warning, TEXT("OmniCapture image write task failed"));
-        }
+        OutputBytesWritten += ArchiveBytes;
     }
+    return true;
+}
+
+int64 FOmniCaptureImageWriter::GetContainerBytesWritten() const
+{
+    return Container ? Container->GetBytesWritten() : 0;
+}
+
+int64 FOmniCaptureImageWriter::GetBytesWritten() const
+{
+    // Raw segments and the container count their own bytes, including their framing and index.
+    return OutputBytesWritten.Load() + (RawWriter ? RawWriter->GetBytesWritten() : 0) + (Container ? Container->GetBytesWritten() : 0);
+}
+
+void FOmniCaptureImageWriter::RequestStop()
+{
+    bStopRequested.Store(true);
 }
+
+bool FOmniCaptureImageWriter::IsStopRequested() const
+{
+    return bStopRequested.Load();
+}
+
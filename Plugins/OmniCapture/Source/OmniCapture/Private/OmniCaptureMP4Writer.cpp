@@ -0,0 +1,672 @@
+#include "OmniCaptureMP4Writer.h"
+
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "NVENC/NVENCAnnexB.h"
+#include "OmniCaptureLog.h"
+
+namespace
+{
+    constexpr uint32 MovieTimescale = 1000;
+    constexpr uint32 VideoTimescale = 90000;
+    constexpr uint32 VideoTrackId = 1;
+    constexpr uint32 AudioTrackId = 2;
+    // Audio packets this close to where the track expects them are rounding, not gaps or overlaps.
+    constexpr int64 AudioPlacementTolerance = 2;
+
+    // trun/tfhd sample_flags: a sync sample depends on nothing; anything else depends on earlier samples and is not sync.
+    constexpr uint32 SyncSampleFlags = 0x02000000;
+    constexpr uint32 NonSyncSampleFlags = 0x01010000;
+
+    constexpr uint32 TfhdDefaultBaseIsMoof = 0x020000;
+    constexpr uint32 TfhdDefaultSampleDuration = 0x000008;
+    constexpr uint32 TfhdDefaultSampleSize = 0x000010;
+    constexpr uint32 TfhdDefaultSampleFlags = 0x000020;
+    constexpr uint32 TrunDataOffset = 0x000001;
+    constexpr uint32 TrunSampleDuration = 0x000100;
+    constexpr uint32 TrunSampleSize = 0x000200;
+    constexpr uint32 TrunSampleFlags = 0x000400;
+
+    // Appends big-endian ISO BMFF boxes to a buffer, patching each box's size when it is closed.
+    class FBoxWriter
+    {
+    public:
+        explicit FBoxWriter(TArray<uint8>& InBuffer)
+            : Buffer(InBuffer)
+        {
+        }
+
+        void U8(uint32 Value) { Buffer.Add(static_cast<uint8>(Value)); }
+        void U16(uint32 Value) { U8(Value >> 8); U8(Value); }
+        void U32(uint32 Value) { U16(Value >> 16); U16(Value & 0xFFFF); }
+        void U64(uint64 Value) { U32(static_cast<uint32>(Value >> 32)); U32(static_cast<uint32>(Value)); }
+        void Zeros(int32 Count) { Buffer.AddZeroed(Count); }
+        void Bytes(const uint8* Data, int32 Size) { Buffer.Append(Data, Size); }
+        void FourCC(const char* Type) { Bytes(reinterpret_cast<const uint8*>(Type), 4); }
+        void String(const char* Text) { Bytes(reinterpret_cast<const uint8*>(Text), FCStringAnsi::Strlen(Text) + 1); }
+
+        void Begin(const char* Type)
+        {
+            OpenBoxes.Push(Buffer.Num());
+            U32(0);
+            FourCC(Type);
+        }
+
+        void BeginFull(const char* Type, uint8 Version, uint32 Flags)
+        {
+            Begin(Type);
+            U32((static_cast<uint32>(Version) << 24) | (Flags & 0xFFFFFF));
+        }
+
+        void End()
+        {
+            const int32 Start = OpenBoxes.Pop(EAllowShrinking::No);
+            PatchU32(Start, static_cast<uint32>(Buffer.Num() - Start));
+        }
+
+        void PatchU32(int32 Offset, uint32 Value)
+        {
+            Buffer[Offset + 0] = static_cast<uint8>(Value >> 24);
+            Buffer[Offset + 1] = static_cast<uint8>(Value >> 16);
+            Buffer[Offset + 2] = static_cast<uint8>(Value >> 8);
+            Buffer[Offset + 3] = static_cast<uint8>(Value);
+        }
+
+        int32 Tell() const { return Buffer.Num(); }
+
+    private:
+        TArray<uint8>& Buffer;
+        TArray<int32, TInlineAllocator<8>> OpenBoxes;
+    };
+
+    void WriteMatrix(FBoxWriter& Box)
+    {
+        const uint32 Unity[] = { 0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000 };
+        for (const uint32 Value : Unity)
+        {
+            Box.U32(Value);
+        }
+    }
+
+    void WriteTrackHeader(FBoxWriter& Box, uint32 TrackId, bool bAudio, const FIntPoint& Size)
+    {
+        Box.BeginFull("tkhd", 0, 0x3); // enabled, in movie
+        Box.U32(0);                     // creation_time
+        Box.U32(0);                     // modification_time
+        Box.U32(TrackId);
+        Box.U32(0);
+        Box.U32(0);                     // duration, carried by the fragments
+        Box.Zeros(8);
+        Box.U16(0);                     // layer
+        Box.U16(0);                     // alternate_group
+        Box.U16(bAudio ? 0x0100 : 0);   // volume
+        Box.U16(0);
+        WriteMatrix(Box);
+        Box.U32(static_cast<uint32>(Size.X) << 16);
+        Box.U32(static_cast<uint32>(Size.Y) << 16);
+        Box.End();
+    }
+
+    void WriteMediaHeader(FBoxWriter& Box, uint32 Timescale, const char* HandlerType, const char* HandlerName)
+    {
+        Box.BeginFull("mdhd", 0, 0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.U32(Timescale);
+        Box.U32(0);
+        Box.U16(0x55C4); // "und"
+        Box.U16(0);
+        Box.End();
+
+        Box.BeginFull("hdlr", 0, 0);
+        Box.U32(0);
+        Box.FourCC(HandlerType);
+        Box.Zeros(12);
+        Box.String(HandlerName);
+        Box.End();
+    }
+
+    void WriteDataInformation(FBoxWriter& Box)
+    {
+        Box.Begin("dinf");
+        Box.BeginFull("dref", 0, 0);
+        Box.U32(1);
+        Box.BeginFull("url ", 0, 0x1); // media is in this file
+        Box.End();
+        Box.End();
+        Box.End();
+    }
+
+    // Fragmented files keep their sample tables in the fragments; the moov only carries empty ones.
+    void WriteEmptySampleTables(FBoxWriter& Box)
+    {
+        for (const char* Type : { "stts", "stsc", "stco" })
+        {
+            Box.BeginFull(Type, 0, 0);
+            Box.U32(0);
+            Box.End();
+        }
+        Box.BeginFull("stsz", 0, 0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.End();
+    }
+
+    // Spherical Video V2: st3d for the frame packing, sv3d for the equirectangular projection.
+    void WriteSphericalBoxes(FBoxWriter& Box, const FOmniCaptureMP4WriterConfig& Config)
+    {
+        Box.BeginFull("st3d", 0, 0);
+        Box.U8(!Config.bStereo ? 0 : (Config.StereoLayout == EOmniCaptureStereoLayout::TopBottom ? 1 : 2));
+        Box.End();
+
+        Box.Begin("sv3d");
+        Box.BeginFull("svhd", 0, 0);
+        Box.String("OmniCapture");
+        Box.End();
+        Box.Begin("proj");
+        Box.BeginFull("prhd", 0, 0);
+        Box.U32(0); // yaw
+        Box.U32(0); // pitch
+        Box.U32(0); // roll
+        Box.End();
+        Box.BeginFull("equi", 0, 0);
+        // Bounds are 0.32 fixed point fractions cropped from each edge; a half sphere drops a quarter of the width on either side.
+        const uint32 HorizontalCrop = Config.bHalfSphere ? 0x40000000 : 0;
+        Box.U32(0);
+        Box.U32(0);
+        Box.U32(HorizontalCrop);
+        Box.U32(HorizontalCrop);
+        Box.End();
+        Box.End();
+        Box.End();
+    }
+}
+
+FOmniCaptureMP4WriterConfig FOmniCaptureMP4WriterConfig::FromSettings(const FOmniCaptureSettings& Settings)
+{
+    FOmniCaptureMP4WriterConfig Config;
+    Config.Codec = Settings.Codec;
+    Config.Size = Settings.GetOutputResolution();
+    Config.FrameRate = Settings.TargetFrameRate > 0.0f ? Settings.TargetFrameRate : 30.0;
+    Config.bWithAudio = Settings.bRecordAudio;
+    Config.bSpherical = Settings.bWriteSpatialMetadata && Settings.SupportsSphericalMetadata();
+    Config.bStereo = Settings.IsStereo();
+    Config.StereoLayout = Settings.StereoLayout;
+    Config.bHalfSphere = Settings.IsVR180();
+    return Config;
+}
+
+FOmniCaptureMP4Writer::FOmniCaptureMP4Writer() = default;
+
+FOmniCaptureMP4Writer::~FOmniCaptureMP4Writer()
+{
+    Close();
+}
+
+bool FOmniCaptureMP4Writer::Open(const FString& Path, const FOmniCaptureMP4WriterConfig& InConfig)
+{
+    Close();
+
+    Config = InConfig;
+    CodecConfig.Reset();
+    bHeaderWritten = false;
+    bFailed = false;
+    bHasPendingSample = false;
+    FragmentVideo.Reset();
+    FragmentVideoStart = 0;
+    FragmentVideoDuration = 0;
+    FragmentAudio.Reset();
+    FragmentAudioStart = 0;
+    bAudioFormatKnown = false;
+    FragmentDurationOffset = INDEX_NONE;
+    BytesWritten = 0;
+    SequenceNumber = 0;
+    VideoSampleCount = 0;
+    DroppedVideoSamples = 0;
+    DroppedAudioPackets = 0;
+    SilentAudioFrames = 0;
+    NominalVideoDuration = FMath::Max<uint32>(1, static_cast<uint32>(FMath::RoundToInt(VideoTimescale / FMath::Max(Config.FrameRate, 1.0))));
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+    File.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path, false, false));
+    if (!File)
+    {
+        UE_LOG(LogOmniCaptureNVENC, Warning, TEXT("Failed to create MP4 output %s."), *Path);
+        return false;
+    }
+    return true;
+}
+
+void FOmniCaptureMP4Writer::SetCodecConfig(const uint8* Data, int64 Size)
+{
+    CodecConfig.Reset();
+    if (Data && Size > 0)
+    {
+        CodecConfig.Append(Data, static_cast<int32>(Size));
+    }
+}
+
+bool FOmniCaptureMP4Writer::WriteVideoSample(const uint8* Data, int64 Size, bool bKeyFrame, uint64 TimestampMicroseconds)
+{
+    if (!File || bFailed || !Data || Size <= 0)
+    {
+        return false;
+    }
+
+    if (!bHeaderWritten)
+    {
+        if (!bKeyFrame || !WriteHeader(Data, Size))
+        {
+            ++DroppedVideoSamples;
+            return false;
+        }
+        FirstVideoTimestamp = TimestampMicroseconds;
+    }
+
+    FVideoSample Sample;
+    OmniNVENC::FNVENCAnnexB::ToLengthPrefixed(Data, Size, Config.Codec == EOmniCaptureCodec::HEVC, Sample.Data);
+    if (Sample.Data.Num() == 0)
+    {
+        // Parameter sets or delimiters only; they already live in the sample entry.
+        return true;
+    }
+    Sample.bKeyFrame = bKeyFrame;
+    Sample.Timestamp = FMath::Max(TimestampMicroseconds, FirstVideoTimestamp);
+
+    // A sample's duration is only known once the next one arrives, so each is held back by one.
+    if (bHasPendingSample)
+    {
+        const uint64 Start = ToVideoTime(PendingSample.Timestamp);
+        const uint64 End = ToVideoTime(Sample.Timestamp);
+        PendingSample.Duration = End > Start ? static_cast<uint32>(FMath::Min<uint64>(End - Start, MAX_uint32)) : NominalVideoDuration;
+        AddToFragment(MoveTemp(PendingSample));
+    }
+    PendingSample = MoveTemp(Sample);
+    bHasPendingSample = true;
+    return !bFailed;
+}
+
+void FOmniCaptureMP4Writer::WriteAudio(const FOmniAudioPacket& Packet)
+{
+    if (!File || !Config.bWithAudio || Packet.PCM16.Num() == 0)
+    {
+        return;
+    }
+
+    if (!bAudioFormatKnown)
+    {
+        AudioSampleRate = Packet.SampleRate;
+        AudioChannels = Packet.NumChannels;
+        bAudioFormatKnown = AudioSampleRate > 0 && AudioChannels > 0;
+    }
+    if (!bAudioFormatKnown || Packet.SampleRate != AudioSampleRate || Packet.NumChannels != AudioChannels)
+    {
+        ++DroppedAudioPackets;
+        return;
+    }
+
+    if (!bHeaderWritten)
+    {
+        // Audio ahead of the first keyframe has no video to play against; the track starts with the video.
+        return;
+    }
+
+    // Packets are stamped on the video clock, so each is placed where it belongs rather than after the previous one.
+    // Audio lost with a dropped frame becomes silence instead of pulling everything after it early.
+    const int32 FrameBytes = AudioChannels * static_cast<int32>(sizeof(int16));
+    const int64 NumFrames = Packet.PCM16.Num() / AudioChannels;
+    const int64 Buffered = static_cast<int64>(FragmentAudioStart) + FragmentAudio.Num() / FrameBytes;
+    const double Elapsed = Packet.Timestamp - static_cast<double>(FirstVideoTimestamp) / 1'000'000.0;
+    const int64 Position = FMath::RoundToInt64(Elapsed * AudioSampleRate);
+    const int64 Offset = Position - Buffered;
+
+    int64 SkipFrames = 0;
+    if (Offset > AudioPlacementTolerance)
+    {
+        FragmentAudio.AddZeroed(static_cast<int32>(Offset * FrameBytes));
+        SilentAudioFrames += Offset;
+    }
+    else if (Offset < -AudioPlacementTolerance)
+    {
+        // Overlaps audio already placed, or predates the first video frame.
+        SkipFrames = FMath::Min(-Offset, NumFrames);
+    }
+
+    if (SkipFrames < NumFrames)
+    {
+        FragmentAudio.Append(reinterpret_cast<const uint8*>(Packet.PCM16.GetData() + SkipFrames * AudioChannels), static_cast<int32>((NumFrames - SkipFrames) * FrameBytes));
+    }
+}
+
+bool FOmniCaptureMP4Writer::Close()
+{
+    if (!File)
+    {
+        return false;
+    }
+
+    if (bHasPendingSample)
+    {
+        PendingSample.Duration = NominalVideoDuration;
+        AddToFragment(MoveTemp(PendingSample));
+        bHasPendingSample = false;
+    }
+
+    const bool bHadHeader = bHeaderWritten;
+    if (bHeaderWritten)
+    {
+        FlushFragment();
+
+        // mehd lets players show the length without walking every fragment.
+        if (FragmentDurationOffset != INDEX_NONE && !bFailed)
+        {
+            const uint64 Duration = FragmentVideoStart * MovieTimescale / VideoTimescale;
+            TArray<uint8> DurationBytes;
+            FBoxWriter(DurationBytes).U64(Duration);
+            File->Seek(FragmentDurationOffset);
+            bFailed |= !File->Write(DurationBytes.GetData(), DurationBytes.Num());
+            File->SeekFromEnd(0);
+        }
+    }
+
+    File->Flush();
+    File.Reset();
+    FragmentVideo.Reset();
+    FragmentAudio.Reset();
+    return bHadHeader && VideoSampleCount > 0 && !bFailed;
+}
+
+bool FOmniCaptureMP4Writer::WriteHeader(const uint8* KeyFrameData, int64 KeyFrameSize)
+{
+    // Parameter sets may come from the encoder up front, inline with the keyframe, or both.
+    TArray<uint8> ParameterSets = CodecConfig;
+    ParameterSets.Append(KeyFrameData, static_cast<int32>(KeyFrameSize));
+
+    const bool bHEVC = Config.Codec == EOmniCaptureCodec::HEVC;
+    TArray<uint8> DecoderConfiguration;
+    const bool bBuilt = bHEVC
+        ? OmniNVENC::FNVENCAnnexB::BuildHEVCDecoderConfigurationRecord(ParameterSets.GetData(), ParameterSets.Num(), DecoderConfiguration)
+        : OmniNVENC::FNVENCAnnexB::BuildAVCDecoderConfigurationRecord(ParameterSets.GetData(), ParameterSets.Num(), DecoderConfiguration);
+    if (!bBuilt)
+    {
+        UE_LOG(LogOmniCaptureNVENC, Warning, TEXT("No usable %s parameter sets reached the MP4 writer yet; waiting for the next keyframe."), bHEVC ? TEXT("HEVC") : TEXT("H.264"));
+        return false;
+    }
+
+    if (Config.bWithAudio && !bAudioFormatKnown)
+    {
+        AudioSampleRate = FMath::Max(1, Config.AudioSampleRate);
+        AudioChannels = FMath::Max(1, Config.AudioChannels);
+        bAudioFormatKnown = true;
+    }
+    const bool bAudioTrack = Config.bWithAudio && bAudioFormatKnown;
+
+    TArray<uint8> Header;
+    FBoxWriter Box(Header);
+
+    Box.Begin("ftyp");
+    Box.FourCC("iso6");
+    Box.U32(0);
+    Box.FourCC("iso6");
+    Box.FourCC("iso5");
+    Box.FourCC("mp41");
+    Box.End();
+
+    Box.Begin("moov");
+
+    Box.BeginFull("mvhd", 0, 0);
+    Box.U32(0);
+    Box.U32(0);
+    Box.U32(MovieTimescale);
+    Box.U32(0);
+    Box.U32(0x00010000); // rate
+    Box.U16(0x0100);     // volume
+    Box.Zeros(2 + 8);
+    WriteMatrix(Box);
+    Box.Zeros(24);
+    Box.U32(bAudioTrack ? AudioTrackId + 1 : VideoTrackId + 1);
+    Box.End();
+
+    Box.Begin("trak");
+    WriteTrackHeader(Box, VideoTrackId, false, Config.Size);
+    Box.Begin("mdia");
+    WriteMediaHeader(Box, VideoTimescale, "vide", "VideoHandler");
+    Box.Begin("minf");
+    Box.BeginFull("vmhd", 0, 0x1);
+    Box.Zeros(8);
+    Box.End();
+    WriteDataInformation(Box);
+    Box.Begin("stbl");
+    Box.BeginFull("stsd", 0, 0);
+    Box.U32(1);
+    Box.Begin(bHEVC ? "hvc1" : "avc1");
+    Box.Zeros(6);
+    Box.U16(1);          // data_reference_index
+    Box.Zeros(16);
+    Box.U16(Config.Size.X);
+    Box.U16(Config.Size.Y);
+    Box.U32(0x00480000); // 72 dpi
+    Box.U32(0x00480000);
+    Box.U32(0);
+    Box.U16(1);          // frame_count
+    Box.Zeros(32);       // compressorname
+    Box.U16(0x0018);     // depth
+    Box.U16(0xFFFF);
+    Box.Begin(bHEVC ? "hvcC" : "avcC");
+    Box.Bytes(DecoderConfiguration.GetData(), DecoderConfiguration.Num());
+    Box.End();
+    if (Config.bSpherical)
+    {
+        WriteSphericalBoxes(Box, Config);
+    }
+    Box.End();
+    Box.End();
+    WriteEmptySampleTables(Box);
+    Box.End();
+    Box.End();
+    Box.End();
+    Box.End();
+
+    if (bAudioTrack)
+    {
+        Box.Begin("trak");
+        WriteTrackHeader(Box, AudioTrackId, true, FIntPoint::ZeroValue);
+        Box.Begin("mdia");
+        WriteMediaHeader(Box, AudioSampleRate, "soun", "SoundHandler");
+        Box.Begin("minf");
+        Box.BeginFull("smhd", 0, 0);
+        Box.Zeros(4);
+        Box.End();
+        WriteDataInformation(Box);
+        Box.Begin("stbl");
+        Box.BeginFull("stsd", 0, 0);
+        Box.U32(1);
+        // Little-endian signed 16-bit PCM, the samples exactly as the audio recorder captured them.
+        Box.Begin("sowt");
+        Box.Zeros(6);
+        Box.U16(1);
+        Box.Zeros(8);
+        Box.U16(AudioChannels);
+        Box.U16(16);
+        Box.Zeros(4);
+        Box.U32(static_cast<uint32>(FMath::Min(AudioSampleRate, 0xFFFF)) << 16);
+        Box.End();
+        Box.End();
+        WriteEmptySampleTables(Box);
+        Box.End();
+        Box.End();
+        Box.End();
+        Box.End();
+    }
+
+    Box.Begin("mvex");
+    Box.BeginFull("mehd", 1, 0);
+    FragmentDurationOffset = BytesWritten + Box.Tell();
+    Box.U64(0);
+    Box.End();
+    for (const uint32 TrackId : { VideoTrackId, AudioTrackId })
+    {
+        if (TrackId == AudioTrackId && !bAudioTrack)
+        {
+            continue;
+        }
+        Box.BeginFull("trex", 0, 0);
+        Box.U32(TrackId);
+        Box.U32(1); // default_sample_description_index
+        Box.U32(0);
+        Box.U32(0);
+        Box.U32(0);
+        Box.End();
+    }
+    Box.End();
+
+    Box.End();
+
+    if (!Write(Header))
+    {
+        return false;
+    }
+    if (!bAudioTrack)
+    {
+        FragmentAudio.Reset();
+    }
+    bHeaderWritten = true;
+    return true;
+}
+
+void FOmniCaptureMP4Writer::AddToFragment(FVideoSample&& Sample)
+{
+    if (Sample.bKeyFrame && FragmentVideo.Num() > 0 && FragmentVideoDuration >= static_cast<uint64>(Config.MinFragmentSeconds * VideoTimescale))
+    {
+        FlushFragment();
+    }
+
+    FragmentVideoDuration += Sample.Duration;
+    ++VideoSampleCount;
+    FragmentVideo.Add(MoveTemp(Sample));
+}
+
+bool FOmniCaptureMP4Writer::FlushFragment()
+{
+    const int32 AudioFrameBytes = bAudioFormatKnown ? AudioChannels * static_cast<int32>(sizeof(int16)) : 0;
+    const int32 AudioSampleCount = AudioFrameBytes > 0 ? FragmentAudio.Num() / AudioFrameBytes : 0;
+    if (!File || bFailed || (FragmentVideo.Num() == 0 && AudioSampleCount == 0))
+    {
+        return !bFailed;
+    }
+
+    ++SequenceNumber;
+
+    TArray<uint8> Fragment;
+    FBoxWriter Box(Fragment);
+    Box.Begin("moof");
+    Box.BeginFull("mfhd", 0, 0);
+    Box.U32(SequenceNumber);
+    Box.End();
+
+    int32 VideoDataOffset = INDEX_NONE;
+    int64 VideoBytes = 0;
+    if (FragmentVideo.Num() > 0)
+    {
+        Box.Begin("traf");
+        Box.BeginFull("tfhd", 0, TfhdDefaultBaseIsMoof);
+        Box.U32(VideoTrackId);
+        Box.End();
+        Box.BeginFull("tfdt", 1, 0);
+        Box.U64(FragmentVideoStart);
+        Box.End();
+        Box.BeginFull("trun", 0, TrunDataOffset | TrunSampleDuration | TrunSampleSize | TrunSampleFlags);
+        Box.U32(FragmentVideo.Num());
+        VideoDataOffset = Box.Tell();
+        Box.U32(0);
+        for (const FVideoSample& Sample : FragmentVideo)
+        {
+            Box.U32(Sample.Duration);
+            Box.U32(Sample.Data.Num());
+            Box.U32(Sample.bKeyFrame ? SyncSampleFlags : NonSyncSampleFlags);
+            VideoBytes += Sample.Data.Num();
+        }
+        Box.End();
+        Box.End();
+    }
+
+    int32 AudioDataOffset = INDEX_NONE;
+    const int64 AudioBytes = static_cast<int64>(AudioSampleCount) * AudioFrameBytes;
+    if (AudioSampleCount > 0)
+    {
+        // Every PCM frame is a sample of the same size and duration, so the run only needs a count.
+        Box.Begin("traf");
+        Box.BeginFull("tfhd", 0, TfhdDefaultBaseIsMoof | TfhdDefaultSampleDuration | TfhdDefaultSampleSize | TfhdDefaultSampleFlags);
+        Box.U32(AudioTrackId);
+        Box.U32(1);
+        Box.U32(AudioFrameBytes);
+        Box.U32(SyncSampleFlags);
+        Box.End();
+        Box.BeginFull("tfdt", 1, 0);
+        Box.U64(FragmentAudioStart);
+        Box.End();
+        Box.BeginFull("trun", 0, TrunDataOffset);
+        Box.U32(AudioSampleCount);
+        AudioDataOffset = Box.Tell();
+        Box.U32(0);
+        Box.End();
+        Box.End();
+    }
+    Box.End();
+
+    // Data offsets count from the start of the moof; the mdat payload follows its 8 byte header.
+    const int32 MoofSize = Fragment.Num();
+    if (VideoDataOffset != INDEX_NONE)
+    {
+        Box.PatchU32(VideoDataOffset, MoofSize + 8);
+    }
+    if (AudioDataOffset != INDEX_NONE)
+    {
+        Box.PatchU32(AudioDataOffset, static_cast<uint32>(MoofSize + 8 + VideoBytes));
+    }
+    Box.U32(static_cast<uint32>(8 + VideoBytes + AudioBytes));
+    Box.FourCC("mdat");
+
+    bool bWritten = Write(Fragment);
+    for (const FVideoSample& Sample : FragmentVideo)
+    {
+        bWritten = bWritten && Write(Sample.Data);
+    }
+    if (AudioBytes > 0 && bWritten)
+    {
+        bWritten = File->Write(FragmentAudio.GetData(), AudioBytes);
+        BytesWritten += bWritten ? AudioBytes : 0;
+        bFailed |= !bWritten;
+    }
+
+    FragmentVideoStart += FragmentVideoDuration;
+    FragmentVideoDuration = 0;
+    FragmentVideo.Reset();
+    FragmentAudioStart += AudioSampleCount;
+    FragmentAudio.RemoveAt(0, static_cast<int32>(AudioBytes), EAllowShrinking::No);
+    return bWritten;
+}
+
+bool FOmniCaptureMP4Writer::Write(const TArray<uint8>& Bytes)
+{
+    if (!File || bFailed)
+    {
+        return false;
+    }
+    if (!File->Write(Bytes.GetData(), Bytes.Num()))
+    {
+        UE_LOG(LogOmniCaptureNVENC, Warning, TEXT("Failed to write to the MP4 output; the file ends at the last complete fragment."));
+        bFailed = true;
+        return false;
+    }
+    BytesWritten += Bytes.Num();
+    return true;
+}
+
+uint64 FOmniCaptureMP4Writer::ToVideoTime(uint64 TimestampMicroseconds) const
+{
+    const uint64 Elapsed = TimestampMicroseconds - FirstVideoTimestamp;
+    return (Elapsed * 9 + 50) / 100;
+}
@@ -1,4 +1,6 @@
 #include "OmniCaptureMuxer.h"
+#include "OmniCaptureContainer.h"
+#include "OmniCaptureFFmpegPipe.h"
 #include "OmniCaptureTypes.h"
 #include "Misc/EngineVersionComparison.h"
 
@@ -7,6 +9,7 @@
 #include "Misc/FileHelper.h"
 #include "Misc/Paths.h"
 #include "HAL/PlatformMisc.h"
+#include "Misc/ScopeLock.h"
 #include "Serialization/JsonSerializer.h"
 #include "Serialization/JsonWriter.h"
 
@@ -97,6 +100,19 @@ namespace
     }
 }
 
+FOmniCaptureMuxer::FOmniCaptureMuxer() = default;
+
+FOmniCaptureMuxer::~FOmniCaptureMuxer()
+{
+    // A capture discarded without finalizing still lets its encoders finish, so no process outlives the muxer.
+    FScopeLock Lock(&LiveStreamCriticalSection);
+    FinishLiveStream();
+    for (TPair<FString, TUniquePtr<FOmniCaptureFFmpegPipe>>& Pair : FinishingLiveStreams)
+    {
+        Pair.Value->WaitForExit();
+    }
+}
+
 FString FOmniCaptureMuxer::ResolveFFmpegBinary(const FOmniCaptureSettings& Settings)
 {
     if (!Settings.PreferredFFmpegPath.IsEmpty())
@@ -135,6 +151,11 @@ bool FOmniCaptureMuxer::IsFFmpegAvailable(const FOmniCaptureSettings& Settings,
     return FPaths::FileExists(AbsoluteResolved);
 }
 
+bool FOmniCaptureMuxer::ShouldStreamLive(const FOmniCaptureSettings& Settings)
+{
+    return Settings.bStreamToFFmpeg && IsImageSequenceFormat(Settings.OutputFormat);
+}
+
 void FOmniCaptureMuxer::Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory)
 {
     OutputDirectory = InOutputDirectory.IsEmpty() ? (FPaths::ProjectSavedDir() / TEXT("OmniCaptures")) : InOutputDirectory;
@@ -142,6 +163,15 @@ void FOmniCaptureMuxer::Initialize(const FOmniCaptureSettings& Settings, const F
     BaseFileName = Settings.OutputFileName.IsEmpty() ? TEXT("OmniCapture") : Settings.OutputFileName;
     IFileManager::Get().MakeDirectory(*OutputDirectory, true);
     CachedFFmpegPath = ResolveFFmpegBinary(Settings);
+
+    // The previous segment's encoder drains in the background; FinalizeCapture collects it.
+    FScopeLock Lock(&LiveStreamCriticalSection);
+    FinishLiveStream();
+    LiveSettings = Settings;
+    bStreamLive = ShouldStreamLive(Settings);
+    bLiveStreamFailed = false;
+    LiveOutputBytes = 0;
+    LiveOutputPath = bStreamLive ? GetLiveOutputPath() : FString();
 }
 
 void FOmniCaptureMuxer::BeginRealtimeSession(const FOmniCaptureSettings& Settings)
@@ -191,6 +221,166 @@ void FOmniCaptureMuxer::PushFrame(const FOmniCaptureFrame& Frame)
     AudioStats.bInError = FMath::Abs(AudioStats.DriftMilliseconds) > DriftWarningThresholdMs;
 }
 
+bool FOmniCaptureMuxer::PushFrame(const FOmniCaptureSharedFrame& Frame)
+{
+    if (!Frame.IsValid())
+    {
+        return true;
+    }
+
+    PushFrame(*Frame);
+
+    if (!bStreamLive || !bRealtimeSessionActive || !Frame->PixelData.IsValid())
+    {
+        return true;
+    }
+    if (bLiveStreamFailed.Load())
+    {
+        return false;
+    }
+
+    // Held across the push so the pipe cannot be closed and moved out by FinishLiveStream while it takes the frame.
+    FScopeLock Lock(&LiveStreamCriticalSection);
+    if (!LivePipe.IsValid() && !StartLiveStream(*Frame))
+    {
+        bLiveStreamFailed = true;
+        return false;
+    }
+
+    if (!LivePipe->PushFrame(Frame))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Live encoder for %s stopped taking frames at frame %d."), *BaseFileName, Frame->Metadata.FrameIndex);
+        bLiveStreamFailed = true;
+        return false;
+    }
+    LiveOutputBytes = LivePipe->GetStats().OutputBytes;
+    return true;
+}
+
+bool FOmniCaptureMuxer::StartLiveStream(const FOmniCaptureFrame& Frame)
+{
+    const TCHAR* PixelFormat = FOmniCaptureFFmpegPipe::GetRawPixelFormat(Frame.PixelDataType);
+    if (!PixelFormat)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Frames of %s cannot be streamed to FFmpeg; live encoding is disabled for this segment."), *BaseFileName);
+        return false;
+    }
+
+    const FString Binary = CachedFFmpegPath.IsEmpty() ? BuildFFmpegBinaryPath() : CachedFFmpegPath;
+    const FIntPoint FrameSize = Frame.PixelData->GetSize();
+    const double FrameRate = LiveSettings.TargetFrameRate > 0.0f ? LiveSettings.TargetFrameRate : 30.0;
+
+    FString CommandLine = FString::Printf(TEXT("-y -f rawvideo -pix_fmt %s -s %dx%d -framerate %.3f -i - -an"), PixelFormat, FrameSize.X, FrameSize.Y, FrameRate);
+    CommandLine += BuildVideoOutputArguments(LiveSettings);
+    CommandLine += FString::Printf(TEXT(" \"%s\""), *LiveOutputPath);
+
+    UE_LOG(LogTemp, Log, TEXT("Starting live FFmpeg encode: %s %s"), *Binary, *CommandLine);
+
+    TUniquePtr<FOmniCaptureFFmpegPipe> Pipe = MakeUnique<FOmniCaptureFFmpegPipe>();
+    Pipe->WatchOutputFile(LiveOutputPath);
+    if (!Pipe->Start(Binary, CommandLine, OutputDirectory, FrameSize, Frame.PixelDataType, LiveSettings.FFmpegPipeQueueFrames))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to start the live FFmpeg encode for %s."), *BaseFileName);
+        return false;
+    }
+
+    LivePipe = MoveTemp(Pipe);
+    return true;
+}
+
+void FOmniCaptureMuxer::FinishLiveStream()
+{
+    FScopeLock Lock(&LiveStreamCriticalSection);
+    if (!LivePipe.IsValid())
+    {
+        return;
+    }
+
+    LivePipe->CloseInput();
+    FinishingLiveStreams.Add(LiveOutputPath, MoveTemp(LivePipe));
+}
+
+void FOmniCaptureMuxer::HandOverLiveStream(FOmniCaptureMuxer& Target)
+{
+    const FString TargetPath = Target.GetLiveOutputPath();
+    FScopeLock Lock(&LiveStreamCriticalSection);
+    FScopeLock TargetLock(&Target.LiveStreamCriticalSection);
+    if (TUniquePtr<FOmniCaptureFFmpegPipe>* Pipe = FinishingLiveStreams.Find(TargetPath))
+    {
+        Target.FinishingLiveStreams.Add(TargetPath, MoveTemp(*Pipe));
+        FinishingLiveStreams.Remove(TargetPath);
+    }
+}
+
+bool FOmniCaptureMuxer::CompleteLiveStream(const FOmniCaptureSettings& Settings, FOmniCaptureFFmpegPipe& Pipe, const FString& AudioPath) const
+{
+    const FString LivePath = GetLiveOutputPath();
+    const bool bEncoded = Pipe.WaitForExit();
+    const FOmniCaptureFFmpegPipeStats Stats = Pipe.GetStats();
+    if (!bEncoded || !FPaths::FileExists(LivePath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Live FFmpeg encode of %s failed after %d frames."), *BaseFileName, Stats.FramesWritten);
+        return false;
+    }
+    if (Stats.SkippedFrames > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Live FFmpeg encode of %s skipped %d frames."), *BaseFileName, Stats.SkippedFrames);
+    }
+
+    const FString OutputFile = OutputDirectory / (BaseFileName + TEXT(".mp4"));
+    if (AudioPath.IsEmpty() || !FPaths::FileExists(AudioPath))
+    {
+        if (!AudioPath.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Audio file %s was not found; muxed output will be silent."), *AudioPath);
+        }
+        if (!IFileManager::Get().Move(*OutputFile, *LivePath, true, true))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Failed to move live encode %s to %s."), *LivePath, *OutputFile);
+            return false;
+        }
+        UE_LOG(LogTemp, Log, TEXT("FFmpeg muxing complete: %s"), *OutputFile);
+        return true;
+    }
+
+    // The video is already encoded; adding the audio only rewrites the container.
+    FString CommandLine = FString::Printf(TEXT("-y -i \"%s\" -i \"%s\" -map 0:v -map 1:a -c:v copy -c:a aac -b:a 192k -shortest"), *LivePath, *AudioPath);
+    if (Settings.bEnableFastStart)
+    {
+        CommandLine += TEXT(" -movflags +faststart");
+    }
+    CommandLine += FString::Printf(TEXT(" \"%s\""), *OutputFile);
+
+    const FString Binary = CachedFFmpegPath.IsEmpty() ? BuildFFmpegBinaryPath() : CachedFFmpegPath;
+    UE_LOG(LogTemp, Log, TEXT("Invoking FFmpeg: %s %s"), *Binary, *CommandLine);
+
+    FProcHandle ProcHandle = FPlatformProcess::CreateProc(*Binary, *CommandLine, true, true, true, nullptr, 0, *OutputDirectory, nullptr);
+    if (!ProcHandle.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to launch FFmpeg process."));
+        return false;
+    }
+
+    FPlatformProcess::WaitForProc(ProcHandle);
+    int32 ReturnCode = 0;
+    FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
+    FPlatformProcess::CloseProc(ProcHandle);
+    if (ReturnCode != 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FFmpeg returned non-zero exit code %d; the video without audio is kept at %s"), ReturnCode, *LivePath);
+        return false;
+    }
+
+    IFileManager::Get().Delete(*LivePath);
+    UE_LOG(LogTemp, Log, TEXT("FFmpeg muxing complete: %s"), *OutputFile);
+    return true;
+}
+
+FString FOmniCaptureMuxer::GetLiveOutputPath() const
+{
+    return OutputDirectory / (BaseFileName + TEXT("_live.mp4"));
+}
+
 bool FOmniCaptureMuxer::FinalizeCapture(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath, int32 DroppedFrames)
 {
     bool bSuccess = true;
@@ -215,7 +405,30 @@ bool FOmniCaptureMuxer::FinalizeCapture(const FOmniCaptureSettings& Settings, co
         bSuccess = false;
     }
 
-    const bool bMuxed = TryInvokeFFmpeg(Settings, Frames, AudioPath, VideoPath);
+    FinishLiveStream();
+    TUniquePtr<FOmniCaptureFFmpegPipe> Pipe;
+    {
+        FScopeLock Lock(&LiveStreamCriticalSection);
+        FinishingLiveStreams.RemoveAndCopyValue(GetLiveOutputPath(), Pipe);
+    }
+
+    bool bMuxed = false;
+    if (Pipe.IsValid())
+    {
+        bMuxed = CompleteLiveStream(Settings, *Pipe, AudioPath);
+    }
+    else if (ShouldStreamLive(Settings))
+    {
+        // The live encode never started, so every frame that reached disk went to the image sequence instead.
+        UE_LOG(LogTemp, Warning, TEXT("No live FFmpeg encode was recorded for %s; muxing its image sequence instead."), *BaseFileName);
+        FOmniCaptureSettings ImageSettings = Settings;
+        ImageSettings.bStreamToFFmpeg = false;
+        bMuxed = TryInvokeFFmpeg(ImageSettings, Frames, AudioPath, VideoPath);
+    }
+    else
+    {
+        bMuxed = TryInvokeFFmpeg(Settings, Frames, AudioPath, VideoPath);
+    }
     return bSuccess && bMuxed;
 }
 
@@ -231,6 +444,11 @@ bool FOmniCaptureMuxer::WriteManifest(const FOmniCaptureSettings& Settings, cons
         OutputFormatString = TEXT("ImageSequence");
     }
     Root->SetStringField(TEXT("outputFormat"), OutputFormatString);
+    if (Settings.bWriteFrameContainer && IsImageSequenceFormat(Settings.OutputFormat))
+    {
+        Root->SetStringField(TEXT("container"), FOmniCaptureContainerWriter::GetContainerPath(OutputDirectory, BaseFileName));
+    }
+    Root->SetBoolField(TEXT("streamedToFFmpeg"), ShouldStreamLive(Settings));
     Root->SetStringField(TEXT("mode"), Settings.Mode == EOmniCaptureMode::Stereo ? TEXT("Stereo") : TEXT("Mono"));
     Root->SetStringField(TEXT("coverage"), ToCoverageString(Settings.Coverage));
     Root->SetStringField(TEXT("gamma"), Settings.Gamma == EOmniCaptureGamma::Linear ? TEXT("Linear") : TEXT("sRGB"));
@@ -475,6 +693,22 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
     }
 
     const bool bImageSequenceOutput = IsImageSequenceFormat(Settings.OutputFormat);
+    if (bImageSequenceOutput && Settings.ImageFormat == EOmniCaptureImageFormat::Raw)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Raw capture segments are not muxed; transcode them to an image sequence first."));
+        return true;
+    }
+
+    if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware && VideoPath.EndsWith(TEXT(".mp4"), ESearchCase::IgnoreCase))
+    {
+        // The encoder already wrote a playable MP4 with its audio; there is nothing left for FFmpeg to wrap.
+        if (!FPaths::FileExists(VideoPath))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("NVENC MP4 output %s not found."), *VideoPath);
+            return false;
+        }
+        return true;
+    }
 
     const FString Binary = CachedFFmpegPath.IsEmpty() ? BuildFFmpegBinaryPath() : CachedFFmpegPath;
     if (Binary.IsEmpty())
@@ -491,33 +725,23 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
     const double FrameRate = CalculateFrameRate(Frames);
     const double EffectiveFrameRate = FrameRate <= 0.0 ? 30.0 : FrameRate;
 
-    FString ColorSpaceArg = TEXT("bt709");
-    FString ColorPrimariesArg = TEXT("bt709");
-    FString ColorTransferArg = TEXT("bt709");
-    FString PixelFormatArg = TEXT("yuv420p");
-
-    switch (Settings.ColorSpace)
-    {
-    case EOmniCaptureColorSpace::BT2020:
-        ColorSpaceArg = TEXT("bt2020nc");
-        ColorPrimariesArg = TEXT("bt2020");
-        ColorTransferArg = TEXT("bt2020-10");
-        PixelFormatArg = TEXT("yuv420p10le");
-        break;
-    case EOmniCaptureColorSpace::HDR10:
-        ColorSpaceArg = TEXT("bt2020nc");
-        ColorPrimariesArg = TEXT("bt2020");
-        ColorTransferArg = TEXT("smpte2084");
-        PixelFormatArg = TEXT("yuv420p10le");
-        break;
-    default:
-        break;
-    }
-
     FString OutputFile = OutputDirectory / (BaseFileName + TEXT(".mp4"));
     FString CommandLine;
 
-    if (bImageSequenceOutput)
+    FOmniCaptureContainerReader ContainerReader;
+    TArray<const FOmniCaptureContainerEntry*> PipedFrames;
+    if (bImageSequenceOutput && Settings.bWriteFrameContainer && ContainerReader.Open(FOmniCaptureContainerWriter::GetContainerPath(OutputDirectory, BaseFileName)))
+    {
+        // Frames go to FFmpeg over stdin straight from the mapped container, in the order of its index.
+        PipedFrames = ContainerReader.GetPrimaryEntries();
+        if (PipedFrames.Num() == 0)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Capture container for %s holds no frames; skipping FFmpeg mux."), *BaseFileName);
+            return false;
+        }
+        CommandLine = FString::Printf(TEXT("-y -f image2pipe -framerate %.3f -i -"), EffectiveFrameRate);
+    }
+    else if (bImageSequenceOutput)
     {
         const FString Extension = Settings.GetImageFileExtension();
         FString Pattern = OutputDirectory / FString::Printf(TEXT("%s_%%06d%s"), *BaseFileName, *Extension);
@@ -551,6 +775,85 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         }
     }
 
+    CommandLine += BuildVideoOutputArguments(Settings);
+    CommandLine += FString::Printf(TEXT(" -shortest \"%s\""), *OutputFile);
+
+    UE_LOG(LogTemp, Log, TEXT("Invoking FFmpeg: %s %s"), *Binary, *CommandLine);
+
+    void* StdInRead = nullptr;
+    void* StdInWrite = nullptr;
+    if (PipedFrames.Num() > 0 && !FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to create a pipe to FFmpeg."));
+        return false;
+    }
+
+    FProcHandle ProcHandle = FPlatformProcess::CreateProc(*Binary, *CommandLine, true, true, true, nullptr, 0, *OutputDirectory, nullptr, StdInRead);
+    if (!ProcHandle.IsValid())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Failed to launch FFmpeg process."));
+        if (StdInWrite)
+        {
+            FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+        }
+        return false;
+    }
+
+    if (StdInWrite)
+    {
+        for (const FOmniCaptureContainerEntry* Entry : PipedFrames)
+        {
+            if (!FOmniCaptureFFmpegPipe::WriteToProcess(ProcHandle, StdInWrite, ContainerReader.GetPayload(*Entry), Entry->PayloadSize))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("FFmpeg stopped reading at frame %lld of the capture container."), Entry->FrameIndex);
+                break;
+            }
+        }
+
+        // Closing our end is FFmpeg's end of input.
+        FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+    }
+
+    FPlatformProcess::WaitForProc(ProcHandle);
+    int32 ReturnCode = 0;
+    FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
+    if (ReturnCode != 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("FFmpeg returned non-zero exit code %d"), ReturnCode);
+        return false;
+    }
+
+    UE_LOG(LogTemp, Log, TEXT("FFmpeg muxing complete: %s"), *OutputFile);
+    return true;
+}
+
+FString FOmniCaptureMuxer::BuildVideoOutputArguments(const FOmniCaptureSettings& Settings) const
+{
+    FString Arguments;
+
+    FString ColorSpaceArg = TEXT("bt709");
+    FString ColorPrimariesArg = TEXT("bt709");
+    FString ColorTransferArg = TEXT("bt709");
+    FString PixelFormatArg = TEXT("yuv420p");
+
+    switch (Settings.ColorSpace)
+    {
+    case EOmniCaptureColorSpace::BT2020:
+        ColorSpaceArg = TEXT("bt2020nc");
+        ColorPrimariesArg = TEXT("bt2020");
+        ColorTransferArg = TEXT("bt2020-10");
+        PixelFormatArg = TEXT("yuv420p10le");
+        break;
+    case EOmniCaptureColorSpace::HDR10:
+        ColorSpaceArg = TEXT("bt2020nc");
+        ColorPrimariesArg = TEXT("bt2020");
+        ColorTransferArg = TEXT("smpte2084");
+        PixelFormatArg = TEXT("yuv420p10le");
+        break;
+    default:
+        break;
+    }
+
     const FString StereoModeTag = Settings.GetStereoModeMetadataTag();
     const TCHAR* StereoMode = *StereoModeTag;
     const bool bHalfSphere = Settings.IsVR180();
@@ -564,11 +867,11 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
     if (IsImageSequenceFormat(Settings.OutputFormat))
     {
         const TCHAR* CodecName = Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("libx265") : TEXT("libx264");
-        CommandLine += FString::Printf(TEXT(" -c:v %s -pix_fmt %s"), CodecName, *PixelFormatArg);
+        Arguments += FString::Printf(TEXT(" -c:v %s -pix_fmt %s"), CodecName, *PixelFormatArg);
     }
     else if (Settings.OutputFormat == EOmniOutputFormat::NVENCHardware)
     {
-        CommandLine += TEXT(" -c:v copy");
+        Arguments += TEXT(" -c:v copy");
     }
 
     if (Settings.bInjectFFmpegMetadata && Settings.SupportsSphericalMetadata())
@@ -596,41 +899,20 @@ bool FOmniCaptureMuxer::TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, co
         MetadataArgs += FString::Printf(TEXT(" -metadata:s:v:0 gpano:CroppedAreaTopPixels=%d"), CroppedTop);
         MetadataArgs += FString::Printf(TEXT(" -metadata:s:v:0 gpano:InitialHorizontalFOVDegrees=%.2f"), static_cast<double>(Settings.GetHorizontalFOVDegrees()));
         MetadataArgs += FString::Printf(TEXT(" -metadata:s:v:0 gpano:InitialVerticalFOVDegrees=%.2f"), static_cast<double>(Settings.GetVerticalFOVDegrees()));
-        CommandLine += MetadataArgs;
+        Arguments += MetadataArgs;
     }
-    CommandLine += FString::Printf(TEXT(" -colorspace %s -color_primaries %s -color_trc %s"), *ColorSpaceArg, *ColorPrimariesArg, *ColorTransferArg);
+    Arguments += FString::Printf(TEXT(" -colorspace %s -color_primaries %s -color_trc %s"), *ColorSpaceArg, *ColorPrimariesArg, *ColorTransferArg);
 
     if (Settings.bForceConstantFrameRate)
     {
-        CommandLine += TEXT(" -vsync cfr");
+        Arguments += TEXT(" -vsync cfr");
     }
     if (Settings.bEnableFastStart)
     {
-        CommandLine += TEXT(" -movflags +faststart");
-    }
-
-    CommandLine += FString::Printf(TEXT(" -shortest \"%s\""), *OutputFile);
-
-    UE_LOG(LogTemp, Log, TEXT("Invoking FFmpeg: %s %s"), *Binary, *CommandLine);
-
-    FProcHandle ProcHandle = FPlatformProcess::CreateProc(*Binary, *CommandLine, true, true, true, nullptr, 0, *OutputDirectory, nullptr);
-    if (!ProcHandle.IsValid())
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Failed to launch FFmpeg process."));
-        return false;
+        Arguments += TEXT(" -movflags +faststart");
     }
 
-    FPlatformProcess::WaitForProc(ProcHandle);
-    int32 ReturnCode = 0;
-    FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
-    if (ReturnCode != 0)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("FFmpeg returned non-zero exit code %d"), ReturnCode);
-        return false;
-    }
-
-    UE_LOG(LogTemp, Log, TEXT("FFmpeg muxing complete: %s"), *OutputFile);
-    return true;
+    return Arguments;
 }
 
 FString FOmniCaptureMuxer::BuildFFmpegBinaryPath() const
@@ -8,6 +8,8 @@
 #include "Misc/Paths.h"
 #include "Misc/ScopeLock.h"
 #include "Modules/ModuleManager.h"
+#include "OmniCaptureLog.h"
+#include "OmniCaptureMP4Writer.h"
 #include "OmniCaptureTypes.h"
 #include "Math/UnrealMathUtility.h"
 #include "PixelFormat.h"
@@ -24,7 +26,7 @@
 #include "GenericPlatform/GenericPlatformDriver.h"
 #include "Interfaces/IPluginManager.h"
 
-DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureNVENC, Log, All);
+DEFINE_LOG_CATEGORY(LogOmniCaptureNVENC);
 
 #if OMNI_WITH_NVENC
 #include "RHICommandList.h"
@@ -938,13 +940,15 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
 
     LastErrorMessage.Reset();
     bInitialized = false;
+    BytesWritten.Store(0);
 
 #if OMNI_WITH_NVENC
     AnnexB.Reset();
     bAnnexBHeaderWritten = false;
 #endif
 
-    const FString FileName = FString::Printf(TEXT("%s.%s"), *Settings.OutputFileName, Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("h265") : TEXT("h264"));
+    const TCHAR* Extension = Settings.bNativeMP4Mux ? TEXT("mp4") : (Settings.Codec == EOmniCaptureCodec::HEVC ? TEXT("h265") : TEXT("h264"));
+    const FString FileName = FString::Printf(TEXT("%s.%s"), *Settings.OutputFileName, Extension);
     OutputFilePath = FPaths::Combine(OutputDirectory, FileName);
 
     ColorFormat = Settings.NVENCColorFormat;
@@ -1002,9 +1006,23 @@ void FOmniCaptureNVENCEncoder::Initialize(const FOmniCaptureSettings& Settings,
         ActiveParameters.QPMax = 51;
     }
 
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    BitstreamFile.Reset(PlatformFile.OpenWrite(*OutputFilePath, /*bAppend=*/false));
-    if (!BitstreamFile)
+    if (Settings.bNativeMP4Mux)
+    {
+        MP4Writer = MakeUnique<FOmniCaptureMP4Writer>();
+        if (!MP4Writer->Open(OutputFilePath, FOmniCaptureMP4WriterConfig::FromSettings(Settings)))
+        {
+            MP4Writer.Reset();
+            LastErrorMessage = FString::Printf(TEXT("Unable to open NVENC output file at %s."), *OutputFilePath);
+            UE_LOG(LogOmniCaptureNVENC, Error, TEXT("%s"), *LastErrorMessage);
+            return;
+        }
+    }
+    else
+    {
+        IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+        BitstreamFile.Reset(PlatformFile.OpenWrite(*OutputFilePath, /*bAppend=*/false));
+    }
+    if (!BitstreamFile && !MP4Writer)
     {
         LastErrorMessage = FString::Printf(TEXT("Unable to open NVENC output file at %s."), *OutputFilePath);
         UE_LOG(LogOmniCaptureNVENC, Error, TEXT("%s"), *LastErrorMessage);
@@ -1044,7 +1062,7 @@ namespace
 void FOmniCaptureNVENCEncoder::EnqueueFrame(const FOmniCaptureFrame& Frame)
 {
 #if PLATFORM_WINDOWS && OMNI_WITH_NVENC
-    if (!bInitialized || !BitstreamFile)
+    if (!bInitialized || (!BitstreamFile && !MP4Writer))
     {
         return;
     }
@@ -1086,6 +1104,16 @@ void FOmniCaptureNVENCEncoder::Finalize()
         BitstreamFile.Reset();
     }
 
+    if (MP4Writer)
+    {
+        if (!MP4Writer->Close())
+        {
+            UE_LOG(LogOmniCaptureNVENC, Warning, TEXT("NVENC MP4 output %s holds no playable video."), *OutputFilePath);
+        }
+        BytesWritten.Store(MP4Writer->GetBytesWritten());
+        MP4Writer.Reset();
+    }
+
     Bitstream.Release();
     D3D11Input.Shutdown();
     D3D12Input.Shutdown();
@@ -1115,16 +1143,46 @@ bool FOmniCaptureNVENCEncoder::WriteAnnexBHeader()
 
     AnnexB.SetCodecConfig(SequenceData);
     const TArray<uint8>& Header = AnnexB.GetCodecConfig();
-    if (Header.Num() == 0 || !BitstreamFile)
+    if (Header.Num() == 0 || (!BitstreamFile && !MP4Writer))
     {
         return false;
     }
 
-    BitstreamFile->Write(Header.GetData(), Header.Num());
+    if (MP4Writer)
+    {
+        // The MP4 keeps parameter sets in its sample entry, written with the first keyframe.
+        MP4Writer->SetCodecConfig(Header.GetData(), Header.Num());
+    }
+    else
+    {
+        BitstreamFile->Write(Header.GetData(), Header.Num());
+        BytesWritten += Header.Num();
+    }
     bAnnexBHeaderWritten = true;
     UE_LOG(LogOmniCaptureNVENC, Verbose, TEXT("Wrote NVENC Annex B header (%d bytes)."), Header.Num());
     return true;
 }
+
+void FOmniCaptureNVENCEncoder::WriteEncodedOutput(const OmniNVENC::FNVENCEncodedPacket& Packet, const FOmniCaptureFrame& Frame)
+{
+    if (MP4Writer)
+    {
+        if (Packet.Data.Num() > 0)
+        {
+            MP4Writer->WriteVideoSample(Packet.Data.GetData(), Packet.Data.Num(), Packet.bKeyFrame, Packet.Timestamp);
+        }
+        for (const FOmniAudioPacket& AudioPacket : Frame.AudioPackets)
+        {
+            MP4Writer->WriteAudio(AudioPacket);
+        }
+        BytesWritten.Store(MP4Writer->GetBytesWritten());
+    }
+    else if (BitstreamFile && Packet.Data.Num() > 0)
+    {
+        BitstreamFile->Write(Packet.Data.GetData(), Packet.Data.Num());
+        BytesWritten += Packet.Data.Num();
+    }
+}
 #else
 bool FOmniCaptureNVENCEncoder::WriteAnnexBHeader()
 {
@@ -1265,10 +1323,8 @@ bool FOmniCaptureNVENCEncoder::EncodeFrameD3D11(const FOmniCaptureFrame& Frame)
     }
 
     OmniNVENC::FNVENCEncodedPacket Packet;
-    if (Bitstream.ExtractPacket(Packet) && Packet.Data.Num() > 0 && BitstreamFile)
-    {
-        BitstreamFile->Write(Packet.Data.GetData(), Packet.Data.Num());
-    }
+    Bitstream.ExtractPacket(Packet);
+    WriteEncodedOutput(Packet, Frame);
 
     Bitstream.Unlock();
     D3D11Input.UnmapResource(MappedInput);
@@ -1481,10 +1537,8 @@ bool FOmniCaptureNVENCEncoder::EncodeFrameD3D12(const FOmniCaptureFrame& Frame)
     }
 
     OmniNVENC::FNVENCEncodedPacket Packet;
-    if (Bitstream.ExtractPacket(Packet) && Packet.Data.Num() > 0 && BitstreamFile)
-    {
-        BitstreamFile->Write(Packet.Data.GetData(), Packet.Data.Num());
-    }
+    Bitstream.ExtractPacket(Packet);
+    WriteEncodedOutput(Packet, Frame);
 
     Bitstream.Unlock();
     D3D12Input.UnmapResource(MappedInput);
@@ -0,0 +1,379 @@
+#include "OmniCapturePNGEncoder.h"
+
+#include "Async/ParallelFor.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Serialization/Archive.h"
+
+THIRD_PARTY_INCLUDES_START
+#include "zlib.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+    // Rows handed to PrepareRows and deflate per step inside a band.
+    constexpr int64 BandBatchBytes = 4ll * 1024ll * 1024ll;
+    constexpr int64 DeflateOutputChunkBytes = 1ll * 1024ll * 1024ll;
+    // PNG chunks carry a 31-bit length; stay well below it.
+    constexpr int64 MaxIDATChunkBytes = 1ll << 30;
+    // Fewer rows per band than this costs more in flush overhead than it gains in parallelism.
+    constexpr int32 MinRowsPerBand = 16;
+
+    const uint8 PNGSignature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    struct FEncodedBand
+    {
+        TArray64<uint8> Deflated;
+        uLong Adler = 1;
+        int64 FilteredBytes = 0;
+        bool bSucceeded = false;
+    };
+
+    void StoreBigEndian32(uint8* Destination, uint32 Value)
+    {
+        Destination[0] = static_cast<uint8>(Value >> 24);
+        Destination[1] = static_cast<uint8>(Value >> 16);
+        Destination[2] = static_cast<uint8>(Value >> 8);
+        Destination[3] = static_cast<uint8>(Value);
+    }
+
+    void WriteChunk(FArchive& Archive, const char* Type, const uint8* Data, int64 Length)
+    {
+        uint8 Header[8];
+        StoreBigEndian32(Header, static_cast<uint32>(Length));
+        FMemory::Memcpy(Header + 4, Type, 4);
+        Archive.Serialize(Header, sizeof(Header));
+
+        uLong Crc = crc32(0L, reinterpret_cast<const Bytef*>(Type), 4);
+        if (Length > 0)
+        {
+            Archive.Serialize(const_cast<uint8*>(Data), Length);
+            Crc = crc32(Crc, Data, static_cast<uInt>(Length));
+        }
+
+        uint8 Trailer[4];
+        StoreBigEndian32(Trailer, static_cast<uint32>(Crc));
+        Archive.Serialize(Trailer, sizeof(Trailer));
+    }
+
+    // Converts one prepared row to PNG sample order: RGBA channel order and big-endian 16-bit samples.
+    void ToPNGSampleOrder(const uint8* Source, uint8* Destination, int32 Width, int32 Channels, int32 BytesPerChannel, bool bSwapRedBlue)
+    {
+        const int32 BytesPerPixel = Channels * BytesPerChannel;
+        for (int32 X = 0; X < Width; ++X)
+        {
+            const uint8* SourcePixel = Source + static_cast<int64>(X) * BytesPerPixel;
+            uint8* DestinationPixel = Destination + static_cast<int64>(X) * BytesPerPixel;
+            for (int32 Channel = 0; Channel < Channels; ++Channel)
+            {
+                const int32 SourceChannel = (bSwapRedBlue && Channel != 1 && Channel != 3) ? 2 - Channel : Channel;
+                const uint8* Sample = SourcePixel + SourceChannel * BytesPerChannel;
+                uint8* Target = DestinationPixel + Channel * BytesPerChannel;
+                if (BytesPerChannel == 2)
+                {
+                    Target[0] = Sample[1];
+                    Target[1] = Sample[0];
+                }
+                else
+                {
+                    Target[0] = Sample[0];
+                }
+            }
+        }
+    }
+
+    FORCEINLINE uint8 PaethPredictor(int32 Left, int32 Above, int32 UpperLeft)
+    {
+        const int32 Estimate = Left + Above - UpperLeft;
+        const int32 DistanceLeft = FMath::Abs(Estimate - Left);
+        const int32 DistanceAbove = FMath::Abs(Estimate - Above);
+        const int32 DistanceUpperLeft = FMath::Abs(Estimate - UpperLeft);
+        if (DistanceLeft <= DistanceAbove && DistanceLeft <= DistanceUpperLeft)
+        {
+            return static_cast<uint8>(Left);
+        }
+        return static_cast<uint8>(DistanceAbove <= DistanceUpperLeft ? Above : UpperLeft);
+    }
+
+    FORCEINLINE uint32 FilterCost(uint8 Value)
+    {
+        return Value < 128 ? Value : 256u - Value;
+    }
+
+    // Filters Row against Prior (nullptr for the first image row) with every PNG filter and writes the filter byte
+    // followed by the cheapest result to Output. Same minimum-sum-of-absolute-differences heuristic libpng uses by
+    // default, so compression ratio matches the single-threaded path.
+    void FilterRow(const uint8* Row, const uint8* Prior, int64 RowBytes, int32 BytesPerPixel, TArray64<uint8> (&Candidates)[5], uint8* Output)
+    {
+        uint32 Costs[5] = { 0, 0, 0, 0, 0 };
+        uint8* None = Candidates[0].GetData();
+        uint8* Sub = Candidates[1].GetData();
+        uint8* Up = Candidates[2].GetData();
+        uint8* Average = Candidates[3].GetData();
+        uint8* Paeth = Candidates[4].GetData();
+
+        for (int64 Index = 0; Index < RowBytes; ++Index)
+        {
+            const int32 Value = Row[Index];
+            const int32 Left = Index >= BytesPerPixel ? Row[Index - BytesPerPixel] : 0;
+            const int32 Above = Prior ? Prior[Index] : 0;
+            const int32 UpperLeft = (Prior && Index >= BytesPerPixel) ? Prior[Index - BytesPerPixel] : 0;
+
+            None[Index] = static_cast<uint8>(Value);
+            Sub[Index] = static_cast<uint8>(Value - Left);
+            Up[Index] = static_cast<uint8>(Value - Above);
+            Average[Index] = static_cast<uint8>(Value - ((Left + Above) >> 1));
+            Paeth[Index] = static_cast<uint8>(Value - PaethPredictor(Left, Above, UpperLeft));
+
+            Costs[0] += FilterCost(None[Index]);
+            Costs[1] += FilterCost(Sub[Index]);
+            Costs[2] += FilterCost(Up[Index]);
+            Costs[3] += FilterCost(Average[Index]);
+            Costs[4] += FilterCost(Paeth[Index]);
+        }
+
+        int32 Best = 0;
+        for (int32 Filter = 1; Filter < 5; ++Filter)
+        {
+            Best = Costs[Filter] < Costs[Best] ? Filter : Best;
+        }
+
+        Output[0] = static_cast<uint8>(Best);
+        FMemory::Memcpy(Output + 1, Candidates[Best].GetData(), RowBytes);
+    }
+
+    bool DeflateInto(z_stream& Stream, const uint8* Input, int64 InputBytes, int32 FlushMode, TArray64<uint8>& Output)
+    {
+        Stream.next_in = const_cast<Bytef*>(Input);
+        Stream.avail_in = static_cast<uInt>(InputBytes);
+
+        for (;;)
+        {
+            const int64 OutputOffset = Output.Num();
+            Output.AddUninitialized(DeflateOutputChunkBytes);
+            Stream.next_out = Output.GetData() + OutputOffset;
+            Stream.avail_out = static_cast<uInt>(DeflateOutputChunkBytes);
+
+            const int32 Result = deflate(&Stream, FlushMode);
+            Output.SetNum(OutputOffset + (DeflateOutputChunkBytes - Stream.avail_out), EAllowShrinking::No);
+            if (Result == Z_STREAM_ERROR)
+            {
+                return false;
+            }
+            if (Result == Z_STREAM_END)
+            {
+                return true;
+            }
+
+            // With output space left over, deflate has consumed all input and completed any requested flush. A
+            // finishing stream keeps going until deflate reports its end.
+            if (FlushMode != Z_FINISH && Stream.avail_out != 0 && Stream.avail_in == 0)
+            {
+                return true;
+            }
+        }
+    }
+}
+
+FOmniCapturePNGEncodeOptions FOmniCapturePNGEncodeOptions::FromSettings(const FOmniCaptureSettings& Settings)
+{
+    FOmniCapturePNGEncodeOptions Options;
+    Options.BandCount = Settings.PNGEncodeBands;
+    Options.CompressionLevel = FMath::Clamp(Settings.PNGCompressionLevel, 0, 9);
+    Options.Strategy = Settings.PNGZlibStrategy;
+    return Options;
+}
+
+int32 FOmniCaptureParallelPNGEncoder::ToZlibStrategy(EOmniCapturePNGZlibStrategy Strategy)
+{
+    switch (Strategy)
+    {
+    case EOmniCapturePNGZlibStrategy::Filtered:
+        return Z_FILTERED;
+    case EOmniCapturePNGZlibStrategy::HuffmanOnly:
+        return Z_HUFFMAN_ONLY;
+    case EOmniCapturePNGZlibStrategy::RLE:
+        return Z_RLE;
+    case EOmniCapturePNGZlibStrategy::Default:
+    default:
+        return Z_DEFAULT_STRATEGY;
+    }
+}
+
+int32 FOmniCaptureParallelPNGEncoder::ResolveBandCount(const FOmniCapturePNGEncodeOptions& Options, int32 Height)
+{
+    const int32 Requested = Options.BandCount > 0
+        ? Options.BandCount
+        : FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+    const int32 MaxBands = FMath::Max(1, Height / MinRowsPerBand);
+    return FMath::Clamp(Requested, 1, MaxBands);
+}
+
+bool FOmniCaptureParallelPNGEncoder::Encode(FArchive& Archive, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, const FOmniCapturePNGEncodeOptions& Options, FPrepareRows PrepareRows, TFunctionRef<bool()> ShouldCancel)
+{
+    int32 Channels = 0;
+    uint8 ColorType = 0;
+    switch (Format)
+    {
+    case ERGBFormat::Gray:
+    case ERGBFormat::GrayF:
+        Channels = 1;
+        ColorType = 0;
+        break;
+    case ERGBFormat::RGBA:
+    case ERGBFormat::BGRA:
+    case ERGBFormat::RGBAF:
+        Channels = 4;
+        ColorType = 6;
+        break;
+    default:
+        return false;
+    }
+
+    if ((BitDepth != 8 && BitDepth != 16) || Size.X <= 0 || Size.Y <= 0)
+    {
+        return false;
+    }
+
+    const int32 BytesPerChannel = BitDepth / 8;
+    const int32 BytesPerPixel = Channels * BytesPerChannel;
+    const int64 BytesPerRow = static_cast<int64>(Size.X) * BytesPerPixel;
+    const bool bSwapRedBlue = Format == ERGBFormat::BGRA;
+    const int32 BandCount = ResolveBandCount(Options, Size.Y);
+    const int32 RowsPerBand = FMath::DivideAndRoundUp(Size.Y, BandCount);
+    const int32 RowsPerBatch = FMath::Clamp(static_cast<int32>(BandBatchBytes / FMath::Max<int64>(BytesPerRow, 1)), 1, RowsPerBand);
+    const int32 CompressionLevel = FMath::Clamp(Options.CompressionLevel, 0, 9);
+    const int32 Strategy = ToZlibStrategy(Options.Strategy);
+
+    TArray<FEncodedBand> Bands;
+    Bands.SetNum(BandCount);
+
+    ParallelFor(BandCount, [&](int32 BandIndex)
+    {
+        FEncodedBand& Band = Bands[BandIndex];
+        const int32 FirstRow = BandIndex * RowsPerBand;
+        const int32 EndRow = FMath::Min(Size.Y, FirstRow + RowsPerBand);
+        if (FirstRow >= EndRow)
+        {
+            Band.bSucceeded = true;
+            return;
+        }
+
+        z_stream Stream;
+        FMemory::Memzero(Stream);
+        // Raw deflate: the zlib header and checksum are written once for the whole image.
+        if (deflateInit2(&Stream, CompressionLevel, Z_DEFLATED, -MAX_WBITS, 8, Strategy) != Z_OK)
+        {
+            return;
+        }
+
+        TArray64<uint8> TempBuffer;
+        TArray<uint8*> RowPointers;
+        TArray64<uint8> SampleRows;
+        TArray64<uint8> PriorRow;
+        TArray64<uint8> Filtered;
+        TArray64<uint8> Candidates[5];
+        for (TArray64<uint8>& Candidate : Candidates)
+        {
+            Candidate.SetNumUninitialized(BytesPerRow);
+        }
+
+        // Filters reference the row above, so a band starts from the last row of the band before it.
+        bool bHasPrior = false;
+        if (FirstRow > 0)
+        {
+            RowPointers.SetNum(1, EAllowShrinking::No);
+            PrepareRows(FirstRow - 1, 1, BytesPerRow, TempBuffer, RowPointers);
+            PriorRow.SetNumUninitialized(BytesPerRow);
+            ToPNGSampleOrder(RowPointers[0], PriorRow.GetData(), Size.X, Channels, BytesPerChannel, bSwapRedBlue);
+            bHasPrior = true;
+        }
+
+        bool bOk = true;
+        for (int32 BatchStart = FirstRow; BatchStart < EndRow && bOk; BatchStart += RowsPerBatch)
+        {
+            if (ShouldCancel())
+            {
+                bOk = false;
+                break;
+            }
+
+            const int32 BatchRows = FMath::Min(RowsPerBatch, EndRow - BatchStart);
+            RowPointers.SetNum(BatchRows, EAllowShrinking::No);
+            PrepareRows(BatchStart, BatchRows, BytesPerRow, TempBuffer, RowPointers);
+
+            SampleRows.SetNumUninitialized(BytesPerRow * BatchRows, EAllowShrinking::No);
+            Filtered.SetNumUninitialized((BytesPerRow + 1) * BatchRows, EAllowShrinking::No);
+            for (int32 Row = 0; Row < BatchRows; ++Row)
+            {
+                uint8* Samples = SampleRows.GetData() + BytesPerRow * Row;
+                ToPNGSampleOrder(RowPointers[Row], Samples, Size.X, Channels, BytesPerChannel, bSwapRedBlue);
+
+                const uint8* Prior = Row > 0 ? Samples - BytesPerRow : (bHasPrior ? PriorRow.GetData() : nullptr);
+                FilterRow(Samples, Prior, BytesPerRow, BytesPerPixel, Candidates, Filtered.GetData() + (BytesPerRow + 1) * Row);
+            }
+
+            // Keep the batch's last row as the prior row of the next batch.
+            PriorRow.SetNumUninitialized(BytesPerRow, EAllowShrinking::No);
+            FMemory::Memcpy(PriorRow.GetData(), SampleRows.GetData() + BytesPerRow * (BatchRows - 1), BytesPerRow);
+            bHasPrior = true;
+
+            const int64 FilteredBytes = Filtered.Num();
+            Band.Adler = adler32(Band.Adler, Filtered.GetData(), static_cast<uInt>(FilteredBytes));
+            Band.FilteredBytes += FilteredBytes;
+
+            const bool bLastBatch = BatchStart + BatchRows >= EndRow;
+            const bool bLastBand = EndRow >= Size.Y;
+            // Non-final bands end byte-aligned on a sync flush, without the final-block bit, so they concatenate.
+            const int32 FlushMode = bLastBatch ? (bLastBand ? Z_FINISH : Z_SYNC_FLUSH) : Z_NO_FLUSH;
+            bOk = DeflateInto(Stream, Filtered.GetData(), FilteredBytes, FlushMode, Band.Deflated);
+        }
+
+        deflateEnd(&Stream);
+        Band.bSucceeded = bOk;
+    }, EParallelForFlags::Unbalanced);
+
+    uLong Adler = 1;
+    for (const FEncodedBand& Band : Bands)
+    {
+        if (!Band.bSucceeded)
+        {
+            return false;
+        }
+        Adler = adler32_combine(Adler, Band.Adler, static_cast<z_off_t>(Band.FilteredBytes));
+    }
+
+    Archive.Serialize(const_cast<uint8*>(PNGSignature), sizeof(PNGSignature));
+
+    uint8 Header[13];
+    StoreBigEndian32(Header, static_cast<uint32>(Size.X));
+    StoreBigEndian32(Header + 4, static_cast<uint32>(Size.Y));
+    Header[8] = static_cast<uint8>(BitDepth);
+    Header[9] = ColorType;
+    Header[10] = 0; // deflate
+    Header[11] = 0; // adaptive filtering
+    Header[12] = 0; // no interlace
+    WriteChunk(Archive, "IHDR", Header, sizeof(Header));
+
+    // zlib header: 32K window deflate, level hint in FLEVEL, check bits making the pair a multiple of 31.
+    const uint8 CompressionMethod = 0x78;
+    const uint8 LevelHint = CompressionLevel < 2 ? 0 : (CompressionLevel < 6 ? 1 : (CompressionLevel == 6 ? 2 : 3));
+    uint8 Flags = static_cast<uint8>(LevelHint << 6);
+    Flags = static_cast<uint8>(Flags + (31 - ((CompressionMethod * 256 + Flags) % 31)) % 31);
+    const uint8 ZlibHeader[2] = { CompressionMethod, Flags };
+    WriteChunk(Archive, "IDAT", ZlibHeader, sizeof(ZlibHeader));
+
+    for (const FEncodedBand& Band : Bands)
+    {
+        for (int64 Offset = 0; Offset < Band.Deflated.Num(); Offset += MaxIDATChunkBytes)
+        {
+            WriteChunk(Archive, "IDAT", Band.Deflated.GetData() + Offset, FMath::Min(MaxIDATChunkBytes, Band.Deflated.Num() - Offset));
+        }
+    }
+
+    uint8 ZlibTrailer[4];
+    StoreBigEndian32(ZlibTrailer, static_cast<uint32>(Adler));
+    WriteChunk(Archive, "IDAT", ZlibTrailer, sizeof(ZlibTrailer));
+    WriteChunk(Archive, "IEND", nullptr, 0);
+
+    return !Archive.IsError();
+}
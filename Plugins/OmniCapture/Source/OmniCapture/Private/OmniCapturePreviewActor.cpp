@@ -1,12 +1,12 @@
 #include "OmniCapturePreviewActor.h"
 
 #include "Components/StaticMeshComponent.h"
-#include "OmniCaptureEquirectConverter.h"
 #include "Engine/StaticMesh.h"
 #include "Engine/Texture2D.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "Materials/MaterialInterface.h"
 #include "OmniCaptureIncludeFixes.h"
+#include "OmniCapturePreviewImage.h"
 
 namespace
 {
@@ -80,6 +80,7 @@ void AOmniCapturePreviewActor::EnsureMaterial()
 
 void AOmniCapturePreviewActor::SetPreviewEnabled(bool bEnabled)
 {
+    bPreviewEnabled = bEnabled;
     if (ScreenComponent)
     {
         ScreenComponent->SetVisibility(bEnabled);
@@ -105,7 +106,9 @@ void AOmniCapturePreviewActor::ResizePreviewTexture(const FIntPoint& Size)
     PreviewTexture->MipGenSettings = TMGS_NoMipmaps;
     PreviewTexture->CompressionSettings = TC_HDR;
     PreviewTexture->SRGB = true;
+    PreviewTexture->NeverStream = true;
     PreviewTexture->UpdateResource();
+    UploadedPixels.Reset();
 
     ApplyTexture(PreviewTexture);
 }
@@ -136,88 +139,47 @@ void AOmniCapturePreviewActor::ApplyTexture(UTexture2D* Texture)
     }
 }
 
-void AOmniCapturePreviewActor::SetPreviewView(EOmniCapturePreviewView InView)
+void AOmniCapturePreviewActor::UpdatePreviewTexture(const FOmniCapturePreviewImage& Image)
 {
-    PreviewViewMode = InView;
-}
-
-void AOmniCapturePreviewActor::UpdatePreviewTexture(const FOmniCaptureEquirectResult& Result, const FOmniCaptureSettings& Settings)
-{
-    const FIntPoint Size = Result.Size;
-    if (Size.X <= 0 || Size.Y <= 0)
+    if (!Image.IsValid())
     {
         return;
     }
 
-    const bool bStereo = Settings.IsStereo();
-    const bool bShowSingleEye = bStereo && PreviewViewMode != EOmniCapturePreviewView::StereoComposite;
-
-    FIntPoint TargetSize = Size;
-    if (bShowSingleEye)
-    {
-        if (Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide)
-        {
-            TargetSize.X = FMath::Max(1, Size.X / 2);
-        }
-        else
-        {
-            TargetSize.Y = FMath::Max(1, Size.Y / 2);
-        }
-    }
-
-    ResizePreviewTexture(TargetSize);
+    ResizePreviewTexture(Image.Size);
     if (!PreviewTexture)
     {
         return;
     }
 
-    FTexture2DMipMap& Mip = PreviewTexture->GetPlatformData()->Mips[0];
-    void* TextureMemory = Mip.BulkData.Lock(LOCK_READ_WRITE);
-
-    if (Result.PreviewPixels.Num() != Size.X * Size.Y)
+    FIntRect Dirty;
+    if (!FOmniCapturePreviewImage::FindChangedRect(UploadedPixels, Image, Dirty))
     {
-        Mip.BulkData.Unlock();
         return;
     }
 
-    if (bShowSingleEye)
+    if (UploadedPixels.Num() != Image.Pixels.Num())
     {
-        const int32 OutputPixels = TargetSize.X * TargetSize.Y;
-        PreviewScratchBuffer.SetNum(OutputPixels, EAllowShrinking::No);
-
-        if (Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide)
-        {
-            const int32 EyeWidth = TargetSize.X;
-            const int32 SourceWidth = Size.X;
-            const int32 StartX = PreviewViewMode == EOmniCapturePreviewView::LeftEye ? 0 : EyeWidth;
-            for (int32 Row = 0; Row < Size.Y; ++Row)
-            {
-                const int32 DestIndex = Row * EyeWidth;
-                const int32 SourceIndex = Row * SourceWidth + StartX;
-                FMemory::Memcpy(PreviewScratchBuffer.GetData() + DestIndex, Result.PreviewPixels.GetData() + SourceIndex, EyeWidth * sizeof(FColor));
-            }
-        }
-        else
-        {
-            const int32 EyeHeight = TargetSize.Y;
-            const int32 SourceWidth = Size.X;
-            const int32 StartRow = PreviewViewMode == EOmniCapturePreviewView::LeftEye ? 0 : EyeHeight;
-            for (int32 Row = 0; Row < EyeHeight; ++Row)
-            {
-                const int32 DestIndex = Row * TargetSize.X;
-                const int32 SourceIndex = (StartRow + Row) * SourceWidth;
-                FMemory::Memcpy(PreviewScratchBuffer.GetData() + DestIndex, Result.PreviewPixels.GetData() + SourceIndex, TargetSize.X * sizeof(FColor));
-            }
-        }
-
-        FMemory::Memcpy(TextureMemory, PreviewScratchBuffer.GetData(), PreviewScratchBuffer.Num() * sizeof(FColor));
+        UploadedPixels.SetNumUninitialized(Image.Pixels.Num());
     }
-    else
+
+    // The render thread reads the region after this returns, so it gets its own copy of the dirty rows.
+    const int32 DirtyWidth = Dirty.Width();
+    const int32 DirtyHeight = Dirty.Height();
+    const int32 RowBytes = DirtyWidth * sizeof(FColor);
+    uint8* UploadData = static_cast<uint8*>(FMemory::Malloc(static_cast<SIZE_T>(RowBytes) * DirtyHeight));
+    for (int32 Row = 0; Row < DirtyHeight; ++Row)
     {
-        const int32 CopyCount = FMath::Min(Result.PreviewPixels.Num(), TargetSize.X * TargetSize.Y);
-        FMemory::Memcpy(TextureMemory, Result.PreviewPixels.GetData(), CopyCount * sizeof(FColor));
+        const int32 SourceIndex = (Dirty.Min.Y + Row) * Image.Size.X + Dirty.Min.X;
+        FMemory::Memcpy(UploadData + static_cast<SIZE_T>(Row) * RowBytes, Image.Pixels.GetData() + SourceIndex, RowBytes);
+        FMemory::Memcpy(UploadedPixels.GetData() + SourceIndex, Image.Pixels.GetData() + SourceIndex, RowBytes);
     }
 
-    Mip.BulkData.Unlock();
-    PreviewTexture->UpdateResource();
+    FUpdateTextureRegion2D* Region = new FUpdateTextureRegion2D(Dirty.Min.X, Dirty.Min.Y, 0, 0, DirtyWidth, DirtyHeight);
+    PreviewTexture->UpdateTextureRegions(0, 1, Region, RowBytes, sizeof(FColor), UploadData,
+        [](uint8* SrcData, const FUpdateTextureRegion2D* Regions)
+        {
+            FMemory::Free(SrcData);
+            delete Regions;
+        });
 }
@@ -0,0 +1,235 @@
+#include "OmniCapturePreviewImage.h"
+
+#include "Async/ParallelFor.h"
+
+namespace
+{
+    // Where the taps of one preview pixel fall along one axis of the source.
+    struct FPreviewTaps
+    {
+        int32 First = 0;
+        int32 Step = 1;
+        int32 Count = 1;
+    };
+
+    void BuildTaps(int32 SourceStart, int32 SourceLength, int32 PreviewLength, TArray<FPreviewTaps>& OutTaps)
+    {
+        OutTaps.SetNumUninitialized(PreviewLength);
+        for (int32 Index = 0; Index < PreviewLength; ++Index)
+        {
+            const int32 Begin = static_cast<int32>(static_cast<int64>(Index) * SourceLength / PreviewLength);
+            const int32 End = FMath::Max(Begin + 1, static_cast<int32>(static_cast<int64>(Index + 1) * SourceLength / PreviewLength));
+            const int32 Footprint = End - Begin;
+
+            FPreviewTaps& Taps = OutTaps[Index];
+            Taps.Count = FMath::Min(Footprint, FOmniCapturePreviewImage::MaxTapsPerAxis);
+            Taps.Step = Footprint / Taps.Count;
+            // Centre the taps in the footprint so a sparse grid does not lean towards one edge.
+            Taps.First = SourceStart + Begin + (Footprint - Taps.Step * (Taps.Count - 1)) / 2;
+        }
+    }
+
+    FORCEINLINE FLinearColor ToAccumulated(const FColor& Source)
+    {
+        return FLinearColor(Source.R, Source.G, Source.B, Source.A);
+    }
+
+    FORCEINLINE FLinearColor ToAccumulated(const FFloat16Color& Source)
+    {
+        return FLinearColor(Source.R.GetFloat(), Source.G.GetFloat(), Source.B.GetFloat(), Source.A.GetFloat());
+    }
+
+    FORCEINLINE FLinearColor ToAccumulated(const FLinearColor& Source)
+    {
+        return Source;
+    }
+
+    template <typename PixelType>
+    FORCEINLINE FColor ToPreview(const FLinearColor& Average)
+    {
+        if constexpr (std::is_same_v<PixelType, FColor>)
+        {
+            // 8-bit frames are already sRGB; averaging the encoded values is close enough for a preview.
+            return FColor(
+                static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Average.R), 0, 255)),
+                static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Average.G), 0, 255)),
+                static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Average.B), 0, 255)),
+                static_cast<uint8>(FMath::Clamp(FMath::RoundToInt(Average.A), 0, 255)));
+        }
+        else
+        {
+            return Average.ToFColor(true);
+        }
+    }
+
+    template <typename PixelType>
+    bool DownscalePixels(const FImagePixelData& PixelData, const FIntRect& Region, const FIntPoint& PreviewSize, FColor* OutPixels)
+    {
+        const TArray64<PixelType>& Source = static_cast<const TImagePixelData<PixelType>&>(PixelData).Pixels;
+        const int64 SourceWidth = PixelData.GetSize().X;
+        if (Source.Num() != SourceWidth * PixelData.GetSize().Y)
+        {
+            return false;
+        }
+
+        TArray<FPreviewTaps> ColumnTaps;
+        TArray<FPreviewTaps> RowTaps;
+        BuildTaps(Region.Min.X, Region.Width(), PreviewSize.X, ColumnTaps);
+        BuildTaps(Region.Min.Y, Region.Height(), PreviewSize.Y, RowTaps);
+
+        ParallelFor(PreviewSize.Y, [&](int32 PreviewY)
+        {
+            const FPreviewTaps& Rows = RowTaps[PreviewY];
+            FColor* OutRow = OutPixels + static_cast<int64>(PreviewY) * PreviewSize.X;
+            for (int32 PreviewX = 0; PreviewX < PreviewSize.X; ++PreviewX)
+            {
+                const FPreviewTaps& Columns = ColumnTaps[PreviewX];
+                FLinearColor Sum(0.0f, 0.0f, 0.0f, 0.0f);
+                for (int32 RowTap = 0; RowTap < Rows.Count; ++RowTap)
+                {
+                    const PixelType* SourceRow = Source.GetData() + (Rows.First + RowTap * Rows.Step) * SourceWidth;
+                    for (int32 ColumnTap = 0; ColumnTap < Columns.Count; ++ColumnTap)
+                    {
+                        Sum += ToAccumulated(SourceRow[Columns.First + ColumnTap * Columns.Step]);
+                    }
+                }
+                OutRow[PreviewX] = ToPreview<PixelType>(Sum / static_cast<float>(Rows.Count * Columns.Count));
+            }
+        });
+        return true;
+    }
+}
+
+void FOmniCapturePreviewImage::Reset()
+{
+    Pixels.Reset();
+    Size = FIntPoint::ZeroValue;
+}
+
+FIntRect FOmniCapturePreviewImage::GetViewRect(const FIntPoint& FrameSize, const FOmniCaptureSettings& Settings, EOmniCapturePreviewView View)
+{
+    FIntRect Rect(FIntPoint::ZeroValue, FrameSize);
+    if (!Settings.IsStereo() || View == EOmniCapturePreviewView::StereoComposite)
+    {
+        return Rect;
+    }
+
+    const bool bRightEye = View == EOmniCapturePreviewView::RightEye;
+    if (Settings.StereoLayout == EOmniCaptureStereoLayout::SideBySide)
+    {
+        const int32 EyeWidth = FMath::Max(1, FrameSize.X / 2);
+        Rect.Min.X = bRightEye ? EyeWidth : 0;
+        Rect.Max.X = FMath::Min(FrameSize.X, Rect.Min.X + EyeWidth);
+    }
+    else
+    {
+        const int32 EyeHeight = FMath::Max(1, FrameSize.Y / 2);
+        Rect.Min.Y = bRightEye ? EyeHeight : 0;
+        Rect.Max.Y = FMath::Min(FrameSize.Y, Rect.Min.Y + EyeHeight);
+    }
+    return Rect;
+}
+
+FIntPoint FOmniCapturePreviewImage::GetScaledSize(const FIntPoint& RegionSize, int32 MaxEdge)
+{
+    const int32 LongEdge = FMath::Max(RegionSize.X, RegionSize.Y);
+    if (MaxEdge <= 0 || LongEdge <= MaxEdge)
+    {
+        return RegionSize;
+    }
+
+    const double Scale = static_cast<double>(MaxEdge) / LongEdge;
+    return FIntPoint(
+        FMath::Max(1, FMath::RoundToInt(RegionSize.X * Scale)),
+        FMath::Max(1, FMath::RoundToInt(RegionSize.Y * Scale)));
+}
+
+bool FOmniCapturePreviewImage::Build(const FImagePixelData& PixelData, EOmniCapturePixelDataType PixelDataType, const FIntRect& Region, int32 MaxEdge)
+{
+    const FIntPoint FrameSize = PixelData.GetSize();
+    if (Region.Min.X < 0 || Region.Min.Y < 0 || Region.Max.X > FrameSize.X || Region.Max.Y > FrameSize.Y || Region.Width() <= 0 || Region.Height() <= 0)
+    {
+        Reset();
+        return false;
+    }
+
+    const FIntPoint PreviewSize = GetScaledSize(Region.Size(), MaxEdge);
+    Pixels.SetNumUninitialized(PreviewSize.X * PreviewSize.Y, EAllowShrinking::No);
+
+    bool bBuilt = false;
+    switch (PixelDataType)
+    {
+    case EOmniCapturePixelDataType::Color8:
+        bBuilt = DownscalePixels<FColor>(PixelData, Region, PreviewSize, Pixels.GetData());
+        break;
+    case EOmniCapturePixelDataType::LinearColorFloat16:
+        bBuilt = DownscalePixels<FFloat16Color>(PixelData, Region, PreviewSize, Pixels.GetData());
+        break;
+    case EOmniCapturePixelDataType::LinearColorFloat32:
+        bBuilt = DownscalePixels<FLinearColor>(PixelData, Region, PreviewSize, Pixels.GetData());
+        break;
+    default:
+        break;
+    }
+
+    if (!bBuilt)
+    {
+        Reset();
+        return false;
+    }
+    Size = PreviewSize;
+    return true;
+}
+
+bool FOmniCapturePreviewImage::FindChangedRect(const TArray<FColor>& Previous, const FOmniCapturePreviewImage& Current, FIntRect& OutRect)
+{
+    if (!Current.IsValid())
+    {
+        return false;
+    }
+
+    if (Previous.Num() != Current.Pixels.Num())
+    {
+        OutRect = FIntRect(FIntPoint::ZeroValue, Current.Size);
+        return true;
+    }
+
+    const int32 Width = Current.Size.X;
+    int32 MinX = Width;
+    int32 MaxX = -1;
+    int32 MinY = -1;
+    int32 MaxY = -1;
+    for (int32 Row = 0; Row < Current.Size.Y; ++Row)
+    {
+        const FColor* PreviousRow = Previous.GetData() + static_cast<int64>(Row) * Width;
+        const FColor* CurrentRow = Current.Pixels.GetData() + static_cast<int64>(Row) * Width;
+        if (FMemory::Memcmp(PreviousRow, CurrentRow, Width * sizeof(FColor)) == 0)
+        {
+            continue;
+        }
+
+        // Only the columns outside what earlier rows already cover need to be compared.
+        int32 Left = 0;
+        while (Left < MinX && PreviousRow[Left] == CurrentRow[Left])
+        {
+            ++Left;
+        }
+        int32 Right = Width - 1;
+        while (Right > MaxX && PreviousRow[Right] == CurrentRow[Right])
+        {
+            --Right;
+        }
+
+        MinX = FMath::Min(MinX, Left);
+        MaxX = FMath::Max(MaxX, Right);
+        MinY = MinY < 0 ? Row : MinY;
+        MaxY = Row;
+    }
+
+    if (MinY < 0)
+    {
+        return false;
+    }
+    OutRect = FIntRect(MinX, MinY, MaxX + 1, MaxY + 1);
+    return true;
+}
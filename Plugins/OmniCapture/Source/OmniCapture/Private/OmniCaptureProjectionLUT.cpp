@@ -0,0 +1,355 @@
+#include "OmniCaptureProjectionLUT.h"
+
+#include "Async/ParallelFor.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+    // The beauty projection plus one for auxiliary layers rendered at another face size. A stereo 8K equirect LUT is
+    // ~256 MB on its own, so nothing beyond the working set of one capture is kept around.
+    constexpr int32 GMaxCachedProjectionLUTs = 2;
+
+    FCriticalSection GProjectionLUTCacheCS;
+    TArray<TSharedRef<const FOmniCaptureProjectionLUT>> GProjectionLUTCache;
+
+    FVector DirectionFromEquirectPixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double LongitudeSpan, double LatitudeSpan, float& OutLatitude)
+    {
+        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
+        const double Longitude = (UV.X - 0.5) * LongitudeSpan;
+        const double Latitude = (0.5 - UV.Y) * LatitudeSpan;
+        OutLatitude = static_cast<float>(Latitude);
+
+        const double CosLat = FMath::Cos(Latitude);
+        const double SinLat = FMath::Sin(Latitude);
+        const double CosLon = FMath::Cos(Longitude);
+        const double SinLon = FMath::Sin(Longitude);
+
+        FVector Direction;
+        Direction.X = CosLat * CosLon;
+        Direction.Y = SinLat;
+        Direction.Z = CosLat * SinLon;
+        return Direction.GetSafeNormal();
+    }
+
+    FVector DirectionFromFisheyePixelCPU(const FIntPoint& Pixel, const FIntPoint& EyeResolution, double FovRadians, bool& bOutValid)
+    {
+        if (EyeResolution.X <= 0 || EyeResolution.Y <= 0)
+        {
+            bOutValid = false;
+            return FVector::ZeroVector;
+        }
+
+        const FVector2D UV((static_cast<double>(Pixel.X) + 0.5) / EyeResolution.X, (static_cast<double>(Pixel.Y) + 0.5) / EyeResolution.Y);
+        FVector2D Normalized = FVector2D(UV.X * 2.0 - 1.0, 1.0 - UV.Y * 2.0);
+
+        const double Radius = Normalized.Size();
+        if (Radius > 1.0)
+        {
+            bOutValid = false;
+            return FVector::ZeroVector;
+        }
+
+        const double HalfFov = FMath::Clamp(FovRadians * 0.5, 0.0, PI);
+        const double Theta = Radius * HalfFov;
+        const double Phi = FMath::Atan2(Normalized.Y, Normalized.X);
+        const double SinTheta = FMath::Sin(Theta);
+
+        FVector Direction;
+        Direction.X = FMath::Cos(Theta);
+        Direction.Y = SinTheta * FMath::Sin(Phi);
+        Direction.Z = SinTheta * FMath::Cos(Phi);
+
+        bOutValid = true;
+        return Direction.GetSafeNormal();
+    }
+
+    void DirectionToFaceUVCPU(const FVector& Direction, uint32& OutFaceIndex, FVector2D& OutUV, int32 FaceResolution, float SeamStrength)
+    {
+        const FVector AbsDir = Direction.GetAbs();
+
+        if (AbsDir.X >= AbsDir.Y && AbsDir.X >= AbsDir.Z)
+        {
+            if (Direction.X > 0.0f)
+            {
+                OutFaceIndex = 0;
+                OutUV = FVector2D(-Direction.Z, Direction.Y) / AbsDir.X;
+            }
+            else
+            {
+                OutFaceIndex = 1;
+                OutUV = FVector2D(Direction.Z, Direction.Y) / AbsDir.X;
+            }
+        }
+        else if (AbsDir.Y >= AbsDir.X && AbsDir.Y >= AbsDir.Z)
+        {
+            if (Direction.Y > 0.0f)
+            {
+                OutFaceIndex = 2;
+                OutUV = FVector2D(Direction.X, -Direction.Z) / AbsDir.Y;
+            }
+            else
+            {
+                OutFaceIndex = 3;
+                OutUV = FVector2D(Direction.X, Direction.Z) / AbsDir.Y;
+            }
+        }
+        else
+        {
+            if (Direction.Z > 0.0f)
+            {
+                OutFaceIndex = 4;
+                OutUV = FVector2D(Direction.X, Direction.Y) / AbsDir.Z;
+            }
+            else
+            {
+                OutFaceIndex = 5;
+                OutUV = FVector2D(-Direction.X, Direction.Y) / AbsDir.Z;
+            }
+        }
+
+        OutUV = (OutUV + FVector2D(1.0, 1.0)) * 0.5f;
+
+        const double Resolution = static_cast<double>(FMath::Max(1, FaceResolution));
+        const double Scale = FMath::Lerp(1.0, (Resolution - 1.0) / Resolution, SeamStrength);
+        const double Bias = (0.5 / Resolution) * SeamStrength;
+        OutUV = FVector2D(OutUV.X * Scale + Bias, OutUV.Y * Scale + Bias);
+        OutUV.X = FMath::Clamp(OutUV.X, 0.0f, 1.0f);
+        OutUV.Y = FMath::Clamp(OutUV.Y, 0.0f, 1.0f);
+    }
+
+    // Inverse of the face selection in DirectionToFaceUVCPU, for face-local coordinates in [-1, 1] (or beyond).
+    FVector DirectionFromFaceUVCPU(uint32 FaceIndex, double U, double V)
+    {
+        switch (FaceIndex)
+        {
+        case 0: return FVector(1.0, V, -U);
+        case 1: return FVector(-1.0, V, U);
+        case 2: return FVector(U, 1.0, -V);
+        case 3: return FVector(U, -1.0, V);
+        case 4: return FVector(U, V, 1.0);
+        default: return FVector(-U, V, -1.0);
+        }
+    }
+
+    void ApplyPolarMitigation(float PolarStrength, float Latitude, FVector& Direction)
+    {
+        if (PolarStrength <= 0.0f)
+        {
+            return;
+        }
+
+        double PoleFactor = FMath::Clamp(FMath::Abs(Latitude) / (PI * 0.5), 0.0, 1.0);
+        PoleFactor = FMath::Pow(PoleFactor, 4.0);
+        const double Blend = PoleFactor * PolarStrength;
+        if (Blend <= 0.0)
+        {
+            return;
+        }
+
+        const FVector PoleVector(0.0f, Latitude >= 0.0f ? 1.0f : -1.0f, 0.0f);
+        Direction = FVector(FMath::Lerp(Direction.X, PoleVector.X, Blend),
+            FMath::Lerp(Direction.Y, PoleVector.Y, Blend),
+            FMath::Lerp(Direction.Z, PoleVector.Z, Blend));
+        Direction.Normalize();
+    }
+
+    FOmniCaptureProjectionSample PackSample(uint32 FaceIndex, const FVector2D& FaceUV, int32 FaceResolution, EOmniCaptureCPUFilter Filter)
+    {
+        // Nearest lookups keep the UV * (Resolution - 1) mapping the sampler always had, so the integer part of
+        // the fixed-point coordinate is exactly the texel the direct path would have read. Filtered lookups need
+        // the true texel-edge origin so neighbouring faces line up across seams.
+        const int32 Extent = Filter == EOmniCaptureCPUFilter::Nearest ? FMath::Max(0, FaceResolution - 1) : FaceResolution;
+        const uint32 MaxFixed = static_cast<uint32>(Extent) << FOmniCaptureProjectionSample::FractionBits;
+        const double Scale = static_cast<double>(Extent) * (1 << FOmniCaptureProjectionSample::FractionBits);
+        const uint32 FixedX = FMath::Min(static_cast<uint32>(FMath::Max(FaceUV.X * Scale, 0.0)), MaxFixed);
+        const uint32 FixedY = FMath::Min(static_cast<uint32>(FMath::Max(FaceUV.Y * Scale, 0.0)), MaxFixed);
+
+        FOmniCaptureProjectionSample Sample;
+        Sample.PackedX = (FaceIndex << 24) | FixedX;
+        Sample.PackedY = FixedY;
+        return Sample;
+    }
+}
+
+FOmniCaptureProjectionKey FOmniCaptureProjectionKey::MakeEquirect(const FOmniCaptureSettings& Settings, int32 FaceResolution, const FIntPoint& EyeResolution)
+{
+    FOmniCaptureProjectionKey Key;
+    Key.Kind = EOmniCaptureProjectionKind::Equirectangular;
+    Key.FaceResolution = FaceResolution;
+    Key.EyeResolution = EyeResolution;
+    Key.LongitudeSpan = Settings.GetLongitudeSpanRadians();
+    Key.LatitudeSpan = Settings.GetLatitudeSpanRadians();
+    Key.SeamBlend = Settings.SeamBlend;
+    Key.PolarDampening = Settings.PolarDampening;
+    Key.bHalfSphere = Settings.IsVR180();
+    Key.Filter = Settings.CPUFallbackFilter;
+    return Key;
+}
+
+FOmniCaptureProjectionKey FOmniCaptureProjectionKey::MakeFisheye(const FOmniCaptureSettings& Settings, int32 FaceResolution, const FIntPoint& EyeResolution)
+{
+    FOmniCaptureProjectionKey Key;
+    Key.Kind = EOmniCaptureProjectionKind::Fisheye;
+    Key.FaceResolution = FaceResolution;
+    Key.EyeResolution = EyeResolution;
+    Key.SeamBlend = Settings.SeamBlend;
+    Key.FisheyeFOV = FMath::Clamp(Settings.FisheyeFOV, 0.0f, 360.0f);
+    Key.bHalfSphere = Settings.IsVR180();
+    Key.Filter = Settings.CPUFallbackFilter;
+    return Key;
+}
+
+bool FOmniCaptureProjectionKey::operator==(const FOmniCaptureProjectionKey& Other) const
+{
+    return Kind == Other.Kind
+        && FaceResolution == Other.FaceResolution
+        && EyeResolution == Other.EyeResolution
+        && LongitudeSpan == Other.LongitudeSpan
+        && LatitudeSpan == Other.LatitudeSpan
+        && SeamBlend == Other.SeamBlend
+        && PolarDampening == Other.PolarDampening
+        && FisheyeFOV == Other.FisheyeFOV
+        && bHalfSphere == Other.bHalfSphere
+        && Filter == Other.Filter;
+}
+
+TSharedRef<const FOmniCaptureProjectionLUT> FOmniCaptureProjectionLUT::FindOrBuild(const FOmniCaptureProjectionKey& Key)
+{
+    FScopeLock Lock(&GProjectionLUTCacheCS);
+
+    for (int32 Index = 0; Index < GProjectionLUTCache.Num(); ++Index)
+    {
+        if (GProjectionLUTCache[Index]->GetKey() == Key)
+        {
+            TSharedRef<const FOmniCaptureProjectionLUT> Found = GProjectionLUTCache[Index];
+            if (Index != GProjectionLUTCache.Num() - 1)
+            {
+                GProjectionLUTCache.RemoveAt(Index);
+                GProjectionLUTCache.Add(Found);
+            }
+            return Found;
+        }
+    }
+
+    // Evict before building so the old table is gone by the time the new one allocates, unless a caller still holds it.
+    if (GProjectionLUTCache.Num() >= GMaxCachedProjectionLUTs)
+    {
+        GProjectionLUTCache.RemoveAt(0);
+    }
+    TSharedRef<const FOmniCaptureProjectionLUT> Built = MakeShared<FOmniCaptureProjectionLUT>(Key);
+    GProjectionLUTCache.Add(Built);
+    return Built;
+}
+
+void FOmniCaptureProjectionLUT::ResetCache()
+{
+    FScopeLock Lock(&GProjectionLUTCacheCS);
+    GProjectionLUTCache.Reset();
+}
+
+FOmniCaptureCubeSeamTable::FOmniCaptureCubeSeamTable(int32 InResolution)
+    : Resolution(FMath::Max(0, InResolution))
+{
+    if (Resolution <= 0)
+    {
+        return;
+    }
+
+    const int32 PaddedResolution = Resolution + 2 * Apron;
+    EntriesPerFace = 2 * Apron * PaddedResolution + 2 * Apron * Resolution;
+    Texels.SetNumZeroed(6 * EntriesPerFace);
+
+    for (uint32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    {
+        for (int32 Y = -Apron; Y < Resolution + Apron; ++Y)
+        {
+            for (int32 X = -Apron; X < Resolution + Apron; ++X)
+            {
+                if (X >= 0 && X < Resolution && Y >= 0 && Y < Resolution)
+                {
+                    continue;
+                }
+
+                // Project the apron texel centre onto the cube and take the texel it lands in. Corner texels,
+                // which have no single owner, resolve to whichever adjacent face the direction favours.
+                const double U = ((X + 0.5) / Resolution) * 2.0 - 1.0;
+                const double V = ((Y + 0.5) / Resolution) * 2.0 - 1.0;
+                uint32 TargetFace = 0;
+                FVector2D TargetUV = FVector2D::ZeroVector;
+                DirectionToFaceUVCPU(DirectionFromFaceUVCPU(FaceIndex, U, V), TargetFace, TargetUV, Resolution, 0.0f);
+
+                const int32 TargetX = FMath::Clamp(FMath::FloorToInt(TargetUV.X * Resolution), 0, Resolution - 1);
+                const int32 TargetY = FMath::Clamp(FMath::FloorToInt(TargetUV.Y * Resolution), 0, Resolution - 1);
+
+                FOmniCaptureCubeTexel& Entry = Texels[FaceIndex * EntriesPerFace + GetEntryIndex(X, Y)];
+                Entry.Face = TargetFace;
+                Entry.Offset = static_cast<uint32>(TargetY * Resolution + TargetX);
+            }
+        }
+    }
+}
+
+FOmniCaptureProjectionLUT::FOmniCaptureProjectionLUT(const FOmniCaptureProjectionKey& InKey)
+    : Key(InKey)
+{
+    Build();
+
+    if (Key.Filter != EOmniCaptureCPUFilter::Nearest)
+    {
+        SeamTable = FOmniCaptureCubeSeamTable(Key.FaceResolution);
+    }
+}
+
+void FOmniCaptureProjectionLUT::Build()
+{
+    const FIntPoint EyeResolution = Key.EyeResolution;
+    if (EyeResolution.X <= 0 || EyeResolution.Y <= 0 || Key.FaceResolution <= 0)
+    {
+        Samples.Reset();
+        return;
+    }
+
+    Samples.SetNumUninitialized(static_cast<int64>(EyeResolution.X) * EyeResolution.Y);
+
+    const double LongitudeSpan = Key.LongitudeSpan;
+    const double LatitudeSpan = Key.LatitudeSpan;
+    const double FovRadians = FMath::DegreesToRadians(Key.FisheyeFOV);
+
+    ParallelFor(EyeResolution.Y, [this, EyeResolution, LongitudeSpan, LatitudeSpan, FovRadians](int32 Y)
+    {
+        FOmniCaptureProjectionSample* Row = Samples.GetData() + static_cast<int64>(Y) * EyeResolution.X;
+        for (int32 X = 0; X < EyeResolution.X; ++X)
+        {
+            const FIntPoint EyePixel(X, Y);
+            FVector Direction;
+
+            if (Key.Kind == EOmniCaptureProjectionKind::Fisheye)
+            {
+                bool bValid = false;
+                Direction = DirectionFromFisheyePixelCPU(EyePixel, EyeResolution, FovRadians, bValid);
+                if (!bValid)
+                {
+                    Row[X] = FOmniCaptureProjectionSample();
+                    continue;
+                }
+            }
+            else
+            {
+                float Latitude = 0.0f;
+                Direction = DirectionFromEquirectPixelCPU(EyePixel, EyeResolution, LongitudeSpan, LatitudeSpan, Latitude);
+                ApplyPolarMitigation(Key.PolarDampening, Latitude, Direction);
+            }
+
+            if (Key.bHalfSphere && Direction.X < 0.0f)
+            {
+                Row[X] = FOmniCaptureProjectionSample();
+                continue;
+            }
+
+            uint32 FaceIndex = 0;
+            FVector2D FaceUV = FVector2D::ZeroVector;
+            DirectionToFaceUVCPU(Direction, FaceIndex, FaceUV, Key.FaceResolution, Key.SeamBlend);
+            Row[X] = PackSample(FaceIndex, FaceUV, Key.FaceResolution, Key.Filter);
+        }
+    });
+}
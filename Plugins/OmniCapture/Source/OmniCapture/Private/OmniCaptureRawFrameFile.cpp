@@ -0,0 +1,607 @@
+#include "OmniCaptureRawFrameFile.h"
+
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "OmniCaptureImageWriter.h"
+
+#if PLATFORM_WINDOWS
+    #include "Windows/AllowWindowsPlatformTypes.h"
+    #include <windows.h>
+    #include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_LINUX || PLATFORM_MAC
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureRaw, Log, All);
+
+namespace
+{
+    // Unbuffered writes go through one aligned staging buffer of this size; large enough to keep a queue of NVMe
+    // requests busy, small enough not to matter next to the frames themselves.
+    constexpr int64 RawStagingBytes = 8 * 1024 * 1024;
+
+    int64 AlignUp(int64 Value, int64 Alignment)
+    {
+        return (Value + Alignment - 1) / Alignment * Alignment;
+    }
+
+    EOmniCapturePixelDataType ResolveRawPixelDataType(const FImagePixelData& PixelData, EOmniCapturePixelDataType Declared)
+    {
+        if (Declared != EOmniCapturePixelDataType::Unknown)
+        {
+            return Declared;
+        }
+
+        switch (PixelData.GetType())
+        {
+        case EImagePixelType::Float32:
+            return EOmniCapturePixelDataType::LinearColorFloat32;
+        case EImagePixelType::Float16:
+            return EOmniCapturePixelDataType::LinearColorFloat16;
+        case EImagePixelType::Color:
+        default:
+            return EOmniCapturePixelDataType::Color8;
+        }
+    }
+
+    template <typename PixelType>
+    TUniquePtr<FImagePixelData> MakeRawPixelData(const FIntPoint& Size, int64 SizeInBytes, void*& OutPixels)
+    {
+        const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
+        if (PixelCount * static_cast<int64>(sizeof(PixelType)) != SizeInBytes)
+        {
+            return nullptr;
+        }
+
+        TUniquePtr<TImagePixelData<PixelType>> PixelData = MakeUnique<TImagePixelData<PixelType>>(Size);
+        PixelData->Pixels.SetNumUninitialized(PixelCount);
+        OutPixels = PixelData->Pixels.GetData();
+        return PixelData;
+    }
+}
+
+// One open segment. Writes are positional and, when unbuffered, must be Alignment-sized from Alignment-aligned memory.
+class FOmniCaptureRawSegmentWriter::FSegmentFile
+{
+public:
+    ~FSegmentFile()
+    {
+        Close(-1);
+    }
+
+    bool Open(const FString& Path, int64 PreallocateBytes, bool bRequestUnbuffered)
+    {
+#if PLATFORM_WINDOWS
+        const DWORD Flags = FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN;
+        if (bRequestUnbuffered)
+        {
+            Handle = ::CreateFileW(*Path, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, Flags | FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH, nullptr);
+            bUnbuffered = Handle != INVALID_HANDLE_VALUE;
+        }
+        if (Handle == INVALID_HANDLE_VALUE)
+        {
+            Handle = ::CreateFileW(*Path, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, Flags, nullptr);
+        }
+        if (Handle == INVALID_HANDLE_VALUE)
+        {
+            return false;
+        }
+
+        // Reserves clusters without moving end of file, so sequential writes never wait on zero fill.
+        FILE_ALLOCATION_INFO Allocation;
+        Allocation.AllocationSize.QuadPart = PreallocateBytes;
+        ::SetFileInformationByHandle(Handle, FileAllocationInfo, &Allocation, sizeof(Allocation));
+        return true;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+        const FTCHARToUTF8 PathUtf8(*Path);
+#if defined(O_DIRECT)
+        if (bRequestUnbuffered)
+        {
+            // tmpfs and some network file systems reject O_DIRECT; those fall back to the page cache below.
+            Descriptor = ::open(PathUtf8.Get(), O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+            bUnbuffered = Descriptor >= 0;
+        }
+#endif
+        if (Descriptor < 0)
+        {
+            Descriptor = ::open(PathUtf8.Get(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        }
+        if (Descriptor < 0)
+        {
+            return false;
+        }
+
+#if PLATFORM_MAC
+        if (bRequestUnbuffered)
+        {
+            bUnbuffered = ::fcntl(Descriptor, F_NOCACHE, 1) != -1;
+        }
+        fstore_t Store = { F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(PreallocateBytes), 0 };
+        ::fcntl(Descriptor, F_PREALLOCATE, &Store);
+#else
+        // Extends the file; Close trims it back to what was written.
+        ::posix_fallocate(Descriptor, 0, static_cast<off_t>(PreallocateBytes));
+#endif
+        return true;
+#else
+        bUnbuffered = false;
+        Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path));
+        return Handle.IsValid();
+#endif
+    }
+
+    bool Write(const uint8* Data, int64 Size, int64 Offset)
+    {
+#if PLATFORM_WINDOWS
+        while (Size > 0)
+        {
+            const DWORD ChunkBytes = static_cast<DWORD>(FMath::Min<int64>(Size, RawStagingBytes));
+            OVERLAPPED Overlapped = {};
+            Overlapped.Offset = static_cast<DWORD>(Offset & 0xFFFFFFFF);
+            Overlapped.OffsetHigh = static_cast<DWORD>(Offset >> 32);
+            DWORD Written = 0;
+            if (!::WriteFile(Handle, Data, ChunkBytes, &Written, &Overlapped) || Written != ChunkBytes)
+            {
+                return false;
+            }
+            Data += ChunkBytes;
+            Offset += ChunkBytes;
+            Size -= ChunkBytes;
+        }
+        return true;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+        while (Size > 0)
+        {
+            const ssize_t Written = ::pwrite(Descriptor, Data, static_cast<size_t>(FMath::Min<int64>(Size, RawStagingBytes)), static_cast<off_t>(Offset));
+            if (Written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return false;
+            }
+            Data += Written;
+            Offset += Written;
+            Size -= Written;
+        }
+        return true;
+#else
+        return Handle->Seek(Offset) && Handle->Write(Data, Size);
+#endif
+    }
+
+    // Trims the preallocated tail off the file; a negative size leaves it as it is.
+    void Close(int64 FinalSize)
+    {
+#if PLATFORM_WINDOWS
+        if (Handle != INVALID_HANDLE_VALUE)
+        {
+            if (FinalSize >= 0)
+            {
+                FILE_END_OF_FILE_INFO EndOfFile;
+                EndOfFile.EndOfFile.QuadPart = FinalSize;
+                ::SetFileInformationByHandle(Handle, FileEndOfFileInfo, &EndOfFile, sizeof(EndOfFile));
+            }
+            ::CloseHandle(Handle);
+            Handle = INVALID_HANDLE_VALUE;
+        }
+#elif PLATFORM_LINUX || PLATFORM_MAC
+        if (Descriptor >= 0)
+        {
+            if (FinalSize >= 0)
+            {
+                ::ftruncate(Descriptor, static_cast<off_t>(FinalSize));
+            }
+            ::close(Descriptor);
+            Descriptor = -1;
+        }
+#else
+        Handle.Reset();
+#endif
+    }
+
+    bool IsUnbuffered() const
+    {
+        return bUnbuffered;
+    }
+
+private:
+#if PLATFORM_WINDOWS
+    HANDLE Handle = INVALID_HANDLE_VALUE;
+#elif PLATFORM_LINUX || PLATFORM_MAC
+    int Descriptor = -1;
+#else
+    TUniquePtr<IFileHandle> Handle;
+#endif
+    bool bUnbuffered = false;
+};
+
+FOmniCaptureRawSegmentWriter::FOmniCaptureRawSegmentWriter(const FString& InDirectory, const FString& InBaseName, int64 InSegmentCapacityBytes, bool bInUnbufferedIO)
+    : Directory(InDirectory)
+    , BaseName(InBaseName)
+    , SegmentCapacityBytes(AlignUp(FMath::Max<int64>(InSegmentCapacityBytes, Alignment), Alignment))
+    , bUnbufferedIO(bInUnbufferedIO)
+{
+    IFileManager::Get().MakeDirectory(*Directory, true);
+}
+
+FOmniCaptureRawSegmentWriter::~FOmniCaptureRawSegmentWriter()
+{
+    Close();
+    if (StagingBuffer)
+    {
+        FMemory::Free(StagingBuffer);
+        StagingBuffer = nullptr;
+    }
+}
+
+FString FOmniCaptureRawSegmentWriter::GetSegmentPath(const FString& Directory, const FString& BaseName, int32 SegmentNumber)
+{
+    return Directory / FString::Printf(TEXT("%s_seg%03d.omniraw"), *BaseName, SegmentNumber);
+}
+
+FString FOmniCaptureRawSegmentWriter::GetIndexPath(const FString& Directory, const FString& BaseName, int32 SegmentNumber)
+{
+    return Directory / FString::Printf(TEXT("%s_seg%03d.omniidx"), *BaseName, SegmentNumber);
+}
+
+bool FOmniCaptureRawSegmentWriter::WritePayload(const FOmniCaptureFrameMetadata& Metadata, FName LayerName, const FImagePixelData& PixelData, EOmniCapturePixelDataType PixelDataType, EOmniCapturePixelPrecision Precision, bool bLinear)
+{
+    const void* RawData = nullptr;
+    int64 SizeInBytes = 0;
+    PixelData.GetRawData(RawData, SizeInBytes);
+    if (!RawData || SizeInBytes <= 0)
+    {
+        return false;
+    }
+
+    FScopeLock Lock(&CriticalSection);
+    if (bFailed)
+    {
+        return false;
+    }
+
+    const int64 PaddedBytes = AlignUp(SizeInBytes, Alignment);
+    // A payload larger than a whole segment still gets one to itself.
+    if (Segment.IsValid() && SegmentOffset > 0 && SegmentOffset + PaddedBytes > SegmentCapacityBytes)
+    {
+        CloseSegment();
+    }
+    if (!Segment.IsValid() && !OpenSegment())
+    {
+        bFailed = true;
+        return false;
+    }
+
+    const int64 PayloadOffset = SegmentOffset;
+    const uint8* Source = static_cast<const uint8*>(RawData);
+    bool bWritten = true;
+    if (Segment->IsUnbuffered())
+    {
+        // Unbuffered writes need aligned memory and whole blocks, so copy through the staging buffer and zero the tail.
+        if (!StagingBuffer)
+        {
+            StagingBuffer = static_cast<uint8*>(FMemory::Malloc(RawStagingBytes, Alignment));
+        }
+
+        for (int64 Copied = 0; Copied < SizeInBytes && bWritten;)
+        {
+            const int64 ChunkBytes = FMath::Min(SizeInBytes - Copied, RawStagingBytes);
+            const int64 ChunkPadded = AlignUp(ChunkBytes, Alignment);
+            FMemory::Memcpy(StagingBuffer, Source + Copied, ChunkBytes);
+            FMemory::Memzero(StagingBuffer + ChunkBytes, ChunkPadded - ChunkBytes);
+            bWritten = Segment->Write(StagingBuffer, ChunkPadded, PayloadOffset + Copied);
+            Copied += ChunkBytes;
+        }
+    }
+    else
+    {
+        bWritten = Segment->Write(Source, SizeInBytes, PayloadOffset);
+    }
+
+    if (!bWritten)
+    {
+        UE_LOG(LogOmniCaptureRaw, Error, TEXT("Failed to write raw frame %d to %s"), Metadata.FrameIndex, *GetSegmentPath(Directory, BaseName, SegmentNumber));
+        bFailed = true;
+        return false;
+    }
+
+    // The segment is trimmed to the end of its last payload on close, so each payload adds itself and the padding
+    // behind the one before it.
+    BytesWritten += PayloadOffset + SizeInBytes - SegmentEnd;
+    SegmentOffset += PaddedBytes;
+    SegmentEnd = PayloadOffset + SizeInBytes;
+
+    FOmniCaptureRawIndexRecord Record;
+    Record.FrameIndex = Metadata.FrameIndex;
+    Record.Timecode = Metadata.Timecode;
+    Record.Offset = static_cast<uint64>(PayloadOffset);
+    Record.Size = static_cast<uint64>(SizeInBytes);
+    Record.Width = PixelData.GetSize().X;
+    Record.Height = PixelData.GetSize().Y;
+    Record.PixelDataType = static_cast<uint8>(ResolveRawPixelDataType(PixelData, PixelDataType));
+    Record.Precision = static_cast<uint8>(Precision);
+    Record.bLinear = bLinear ? 1 : 0;
+    Record.bKeyFrame = Metadata.bKeyFrame ? 1 : 0;
+    if (!LayerName.IsNone())
+    {
+        FCStringAnsi::Strncpy(Record.LayerName, TCHAR_TO_ANSI(*LayerName.ToString()), UE_ARRAY_COUNT(Record.LayerName));
+    }
+
+    // Records follow their payload, so if the process dies the index only points at data the OS already has. Only
+    // write-through unbuffered segments keep that promise across a power loss; the buffered fallback and the index
+    // itself are never fsynced and can lose their tail to an OS crash.
+    IndexArchive->Serialize(&Record, sizeof(Record));
+    IndexArchive->Flush();
+    BytesWritten += sizeof(Record);
+    return true;
+}
+
+void FOmniCaptureRawSegmentWriter::Close()
+{
+    FScopeLock Lock(&CriticalSection);
+    CloseSegment();
+}
+
+int64 FOmniCaptureRawSegmentWriter::GetBytesWritten() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return BytesWritten;
+}
+
+int32 FOmniCaptureRawSegmentWriter::GetSegmentCount() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return SegmentNumber + 1;
+}
+
+bool FOmniCaptureRawSegmentWriter::IsUsingUnbufferedIO() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return bUsingUnbufferedIO;
+}
+
+bool FOmniCaptureRawSegmentWriter::OpenSegment()
+{
+    ++SegmentNumber;
+    const FString SegmentPath = GetSegmentPath(Directory, BaseName, SegmentNumber);
+    TUniquePtr<FSegmentFile> NewSegment = MakeUnique<FSegmentFile>();
+    if (!NewSegment->Open(SegmentPath, SegmentCapacityBytes, bUnbufferedIO))
+    {
+        UE_LOG(LogOmniCaptureRaw, Error, TEXT("Failed to create raw capture segment %s"), *SegmentPath);
+        return false;
+    }
+
+    const FString IndexPath = GetIndexPath(Directory, BaseName, SegmentNumber);
+    IndexArchive.Reset(IFileManager::Get().CreateFileWriter(*IndexPath));
+    if (!IndexArchive.IsValid())
+    {
+        UE_LOG(LogOmniCaptureRaw, Error, TEXT("Failed to create raw capture index %s"), *IndexPath);
+        return false;
+    }
+
+    FOmniCaptureRawIndexHeader Header;
+    Header.RecordSize = sizeof(FOmniCaptureRawIndexRecord);
+    Header.Alignment = static_cast<uint32>(Alignment);
+    IndexArchive->Serialize(&Header, sizeof(Header));
+    BytesWritten += sizeof(Header);
+
+    if (bUnbufferedIO && !NewSegment->IsUnbuffered() && !bUsingUnbufferedIO)
+    {
+        UE_LOG(LogOmniCaptureRaw, Log, TEXT("Unbuffered I/O is not available for %s; raw frames go through the file cache"), *SegmentPath);
+    }
+    bUsingUnbufferedIO = NewSegment->IsUnbuffered();
+    Segment = MoveTemp(NewSegment);
+    SegmentOffset = 0;
+    SegmentEnd = 0;
+    return true;
+}
+
+void FOmniCaptureRawSegmentWriter::CloseSegment()
+{
+    if (Segment.IsValid())
+    {
+        Segment->Close(SegmentEnd);
+        Segment.Reset();
+    }
+    if (IndexArchive.IsValid())
+    {
+        IndexArchive->Close();
+        IndexArchive.Reset();
+    }
+}
+
+bool FOmniCaptureRawSequenceReader::Open(const FString& InDirectory, const FString& InBaseName)
+{
+    Directory = InDirectory;
+    BaseName = InBaseName;
+    Entries.Reset();
+    FrameIndices.Reset();
+    EntriesByFrame.Reset();
+
+    for (int32 SegmentNumber = 0;; ++SegmentNumber)
+    {
+        const FString IndexPath = FOmniCaptureRawSegmentWriter::GetIndexPath(Directory, BaseName, SegmentNumber);
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*IndexPath));
+        if (!Reader.IsValid())
+        {
+            break;
+        }
+
+        FOmniCaptureRawIndexHeader Header;
+        Header.Magic = 0;
+        if (Reader->TotalSize() >= static_cast<int64>(sizeof(Header)))
+        {
+            Reader->Serialize(&Header, sizeof(Header));
+        }
+        if (Header.Magic != FOmniCaptureRawIndexHeader::ExpectedMagic || Header.Version > FOmniCaptureRawIndexHeader::CurrentVersion || Header.RecordSize < sizeof(FOmniCaptureRawIndexRecord))
+        {
+            UE_LOG(LogOmniCaptureRaw, Warning, TEXT("%s is not a raw capture index this version can read"), *IndexPath);
+            return false;
+        }
+
+        // Newer versions may append fields to a record; skip what this version does not know about. A record cut
+        // short by a crash is dropped.
+        while (Reader->Tell() + Header.RecordSize <= Reader->TotalSize())
+        {
+            const int64 RecordStart = Reader->Tell();
+            FEntry& Entry = Entries.AddDefaulted_GetRef();
+            Reader->Serialize(&Entry.Record, sizeof(Entry.Record));
+            Entry.Record.LayerName[UE_ARRAY_COUNT(Entry.Record.LayerName) - 1] = '\0';
+            Entry.SegmentNumber = SegmentNumber;
+            Reader->Seek(RecordStart + Header.RecordSize);
+        }
+    }
+
+    for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+    {
+        const int64 FrameIndex = Entries[EntryIndex].Record.FrameIndex;
+        TArray<int32, TInlineAllocator<4>>* FrameEntries = EntriesByFrame.Find(FrameIndex);
+        if (!FrameEntries)
+        {
+            FrameEntries = &EntriesByFrame.Add(FrameIndex);
+            FrameIndices.Add(FrameIndex);
+        }
+        FrameEntries->Add(EntryIndex);
+    }
+
+    return Entries.Num() > 0;
+}
+
+TUniquePtr<FImagePixelData> FOmniCaptureRawSequenceReader::ReadPixelData(const FEntry& Entry) const
+{
+    const FOmniCaptureRawIndexRecord& Record = Entry.Record;
+    const FIntPoint Size(Record.Width, Record.Height);
+    const int64 SizeInBytes = static_cast<int64>(Record.Size);
+
+    void* Pixels = nullptr;
+    TUniquePtr<FImagePixelData> PixelData;
+    switch (static_cast<EOmniCapturePixelDataType>(Record.PixelDataType))
+    {
+    case EOmniCapturePixelDataType::LinearColorFloat32:
+        PixelData = MakeRawPixelData<FLinearColor>(Size, SizeInBytes, Pixels);
+        break;
+    case EOmniCapturePixelDataType::LinearColorFloat16:
+        PixelData = MakeRawPixelData<FFloat16Color>(Size, SizeInBytes, Pixels);
+        break;
+    case EOmniCapturePixelDataType::Color8:
+        PixelData = MakeRawPixelData<FColor>(Size, SizeInBytes, Pixels);
+        break;
+    case EOmniCapturePixelDataType::ScalarFloat32:
+        PixelData = MakeRawPixelData<float>(Size, SizeInBytes, Pixels);
+        break;
+    case EOmniCapturePixelDataType::Vector2Float32:
+        PixelData = MakeRawPixelData<FVector2f>(Size, SizeInBytes, Pixels);
+        break;
+    default:
+        break;
+    }
+
+    const FString SegmentPath = FOmniCaptureRawSegmentWriter::GetSegmentPath(Directory, BaseName, Entry.SegmentNumber);
+    if (!PixelData.IsValid())
+    {
+        UE_LOG(LogOmniCaptureRaw, Warning, TEXT("Raw frame %lld in %s has an unexpected size or pixel type"), Record.FrameIndex, *SegmentPath);
+        return nullptr;
+    }
+
+    TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*SegmentPath));
+    if (!Handle.IsValid() || !Handle->Seek(static_cast<int64>(Record.Offset)) || !Handle->Read(static_cast<uint8*>(Pixels), SizeInBytes))
+    {
+        UE_LOG(LogOmniCaptureRaw, Warning, TEXT("Failed to read raw frame %lld from %s"), Record.FrameIndex, *SegmentPath);
+        return nullptr;
+    }
+
+    return PixelData;
+}
+
+TUniquePtr<FOmniCaptureFrame> FOmniCaptureRawSequenceReader::ReadFrame(int64 FrameIndex) const
+{
+    const TArray<int32, TInlineAllocator<4>>* FrameEntries = EntriesByFrame.Find(FrameIndex);
+    if (!FrameEntries)
+    {
+        return nullptr;
+    }
+
+    TUniquePtr<FOmniCaptureFrame> Frame;
+    for (const int32 EntryIndex : *FrameEntries)
+    {
+        const FEntry& Entry = Entries[EntryIndex];
+        TUniquePtr<FImagePixelData> PixelData = ReadPixelData(Entry);
+        if (!PixelData.IsValid())
+        {
+            return nullptr;
+        }
+
+        if (!Frame.IsValid())
+        {
+            Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = static_cast<int32>(Entry.Record.FrameIndex);
+            Frame->Metadata.Timecode = Entry.Record.Timecode;
+            Frame->Metadata.bKeyFrame = Entry.Record.bKeyFrame != 0;
+        }
+
+        const EOmniCapturePixelDataType PixelDataType = static_cast<EOmniCapturePixelDataType>(Entry.Record.PixelDataType);
+        const EOmniCapturePixelPrecision Precision = static_cast<EOmniCapturePixelPrecision>(Entry.Record.Precision);
+        if (Entry.Record.LayerName[0] == '\0')
+        {
+            Frame->PixelData = MoveTemp(PixelData);
+            Frame->bLinearColor = Entry.Record.bLinear != 0;
+            Frame->PixelPrecision = Precision;
+            Frame->PixelDataType = PixelDataType;
+        }
+        else
+        {
+            FOmniCaptureLayerPayload& Layer = Frame->AuxiliaryLayers.Add(FName(ANSI_TO_TCHAR(Entry.Record.LayerName)));
+            Layer.PixelData = MoveTemp(PixelData);
+            Layer.bLinear = Entry.Record.bLinear != 0;
+            Layer.Precision = Precision;
+            Layer.PixelDataType = PixelDataType;
+        }
+    }
+
+    return Frame;
+}
+
+int32 FOmniCaptureRawTranscoder::Transcode(const FString& RawDirectory, const FString& RawBaseName, const FOmniCaptureSettings& Settings, const FString& OutputDirectory)
+{
+    if (Settings.ImageFormat == EOmniCaptureImageFormat::Raw)
+    {
+        UE_LOG(LogOmniCaptureRaw, Warning, TEXT("Raw captures transcode to PNG, JPG, EXR or BMP, not to another raw dump"));
+        return 0;
+    }
+
+    FOmniCaptureRawSequenceReader Reader;
+    if (!Reader.Open(RawDirectory, RawBaseName))
+    {
+        UE_LOG(LogOmniCaptureRaw, Warning, TEXT("No raw capture named %s found in %s"), *RawBaseName, *RawDirectory);
+        return 0;
+    }
+
+    FOmniCaptureImageWriter Writer;
+    Writer.Initialize(Settings, OutputDirectory);
+
+    // Frames are read on this thread while the writer's pool encodes the ones before them; its byte budget keeps the
+    // reader from running ahead of the encoders.
+    int32 SubmittedFrames = 0;
+    for (const int64 FrameIndex : Reader.GetFrameIndices())
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = Reader.ReadFrame(FrameIndex);
+        if (!Frame.IsValid() || !Frame->PixelData.IsValid())
+        {
+            continue;
+        }
+
+        const FString FrameFileName = FString::Printf(TEXT("%s_%06d%s"), *Settings.OutputFileName, Frame->Metadata.FrameIndex, *Settings.GetImageFileExtension());
+        Writer.EnqueueFrame(MoveTemp(Frame), FrameFileName);
+        ++SubmittedFrames;
+    }
+
+    Writer.Flush();
+    return FMath::Max(0, SubmittedFrames - Writer.GetWriterPoolStats().FailedTasks);
+}
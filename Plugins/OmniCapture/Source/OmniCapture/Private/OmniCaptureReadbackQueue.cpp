@@ -0,0 +1,284 @@
+#include "OmniCaptureReadbackQueue.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "OmniCaptureFramePool.h"
+#include "RenderingThread.h"
+
+namespace
+{
+    FORCEINLINE FLinearColor ToLinear(const FLinearColor& Source)
+    {
+        return Source;
+    }
+
+    FORCEINLINE FLinearColor ToLinear(const FFloat16Color& Source)
+    {
+        return FLinearColor(Source.R.GetFloat(), Source.G.GetFloat(), Source.B.GetFloat(), Source.A.GetFloat());
+    }
+
+    template <typename SourceType>
+    void CopyLinearRows(const uint8* RawData, uint32 RowStrideInBytes, const FIntPoint& Size, SourceType* DestData)
+    {
+        ParallelFor(Size.Y, [&](int32 Row)
+        {
+            const SourceType* SourceRow = reinterpret_cast<const SourceType*>(RawData + static_cast<SIZE_T>(RowStrideInBytes) * Row);
+            SourceType* DestRow = DestData + static_cast<int64>(Row) * Size.X;
+            FMemory::Memcpy(DestRow, SourceRow, Size.X * sizeof(SourceType));
+        });
+    }
+
+    template <typename SourceType>
+    void ConvertRowsToSRGB(const uint8* RawData, uint32 RowStrideInBytes, const FIntPoint& Size, FColor* DestData)
+    {
+        ParallelFor(Size.Y, [&](int32 Row)
+        {
+            const SourceType* SourceRow = reinterpret_cast<const SourceType*>(RawData + static_cast<SIZE_T>(RowStrideInBytes) * Row);
+            FColor* DestRow = DestData + static_cast<int64>(Row) * Size.X;
+            for (int32 Column = 0; Column < Size.X; ++Column)
+            {
+                DestRow[Column] = ToLinear(SourceRow[Column]).ToFColor(true);
+            }
+        });
+    }
+
+    bool AreCopiesReady(const FOmniCaptureReadbackRequest& Request)
+    {
+        if (Request.Readback.IsValid() && !Request.Readback->IsReady())
+        {
+            return false;
+        }
+
+        for (const TPair<FName, FOmniCaptureLayerReadback>& Layer : Request.LayerReadbacks)
+        {
+            if (Layer.Value.Readback.IsValid() && !Layer.Value.Readback->IsReady())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+void FOmniCaptureReadbackQueue::Initialize(int32 InDepth, const FConsumer& InConsumer)
+{
+    Drain();
+
+    Slots.Reset();
+    Slots.SetNum(FMath::Max(1, InDepth));
+    Head = 0;
+    Count = 0;
+    Consumer = InConsumer;
+
+    FScopeLock Lock(&StatsCriticalSection);
+    Stats = FOmniCaptureReadbackStats();
+    Stats.QueueDepth = Slots.Num();
+    TotalLatencySeconds = 0.0;
+    FirstIssueSeconds = 0.0;
+}
+
+void FOmniCaptureReadbackQueue::Enqueue(FOmniCaptureReadbackRequest&& Request)
+{
+    if (Request.Issue)
+    {
+        Request.Issue(Request);
+        Request.Issue.Reset();
+    }
+
+    if (Slots.Num() == 0)
+    {
+        Slots.SetNum(1);
+    }
+
+    if (Count == Slots.Num())
+    {
+        {
+            FScopeLock Lock(&StatsCriticalSection);
+            ++Stats.StalledEnqueues;
+        }
+        ResolveOldest();
+    }
+
+    const double IssueSeconds = FPlatformTime::Seconds();
+    Request.IssueSeconds = IssueSeconds;
+    Slots[(Head + Count) % Slots.Num()] = MoveTemp(Request);
+    ++Count;
+
+    FScopeLock Lock(&StatsCriticalSection);
+    if (FirstIssueSeconds <= 0.0)
+    {
+        FirstIssueSeconds = IssueSeconds;
+    }
+    Stats.InFlightReadbacks = Count;
+}
+
+int32 FOmniCaptureReadbackQueue::Poll()
+{
+    int32 ResolvedCount = 0;
+    while (Count > 0)
+    {
+        if (!AreCopiesReady(Slots[Head]))
+        {
+            break;
+        }
+
+        ResolveOldest();
+        ++ResolvedCount;
+    }
+    return ResolvedCount;
+}
+
+void FOmniCaptureReadbackQueue::Drain()
+{
+    while (Count > 0)
+    {
+        ResolveOldest();
+    }
+}
+
+void FOmniCaptureReadbackQueue::EnqueueOnRenderThread(const TSharedPtr<FOmniCaptureReadbackQueue, ESPMode::ThreadSafe>& Queue, FOmniCaptureReadbackRequest&& Request)
+{
+    if (!Queue.IsValid())
+    {
+        return;
+    }
+
+    ENQUEUE_RENDER_COMMAND(OmniCaptureQueueReadback)([Queue, Request = MoveTemp(Request)](FRHICommandListImmediate&) mutable
+    {
+        Queue->Enqueue(MoveTemp(Request));
+        Queue->Poll();
+    });
+}
+
+FOmniCaptureReadbackStats FOmniCaptureReadbackQueue::GetStats() const
+{
+    FScopeLock Lock(&StatsCriticalSection);
+    return Stats;
+}
+
+void FOmniCaptureReadbackQueue::ResolveOldest()
+{
+    check(Count > 0);
+
+    FOmniCaptureReadbackRequest Request = MoveTemp(Slots[Head]);
+    Slots[Head] = FOmniCaptureReadbackRequest();
+    Head = (Head + 1) % Slots.Num();
+    --Count;
+
+    bool bResolved = true;
+    if (Request.Readback.IsValid())
+    {
+        Request.Readback->WaitUntilReady();
+
+        if (Request.Frame.IsValid())
+        {
+            bResolved = ResolvePixels(*Request.Readback, Request.Size, Request.Precision, Request.bLinear, Request.Frame->PixelData, Request.Frame->PixelDataType);
+            Request.Frame->PixelPrecision = Request.Precision;
+        }
+
+        // Release the staging resources before handing the frame on; the consumer may hold it for a while.
+        Request.Readback.Reset();
+    }
+
+    for (TPair<FName, FOmniCaptureLayerReadback>& Layer : Request.LayerReadbacks)
+    {
+        if (!Layer.Value.Readback.IsValid())
+        {
+            continue;
+        }
+
+        Layer.Value.Readback->WaitUntilReady();
+        if (Request.Frame.IsValid())
+        {
+            FOmniCaptureLayerPayload Payload;
+            Payload.bLinear = true;
+            Payload.Precision = Layer.Value.Precision;
+            if (ResolvePixels(*Layer.Value.Readback, Layer.Value.Size, Layer.Value.Precision, true, Payload.PixelData, Payload.PixelDataType))
+            {
+                Request.Frame->AuxiliaryLayers.Add(Layer.Key, MoveTemp(Payload));
+            }
+            else
+            {
+                bResolved = false;
+            }
+        }
+        Layer.Value.Readback.Reset();
+    }
+    Request.LayerReadbacks.Empty();
+
+    const double NowSeconds = FPlatformTime::Seconds();
+    {
+        FScopeLock Lock(&StatsCriticalSection);
+        const double LatencySeconds = NowSeconds - Request.IssueSeconds;
+        ++Stats.CompletedReadbacks;
+        Stats.FailedReadbacks += bResolved ? 0 : 1;
+        Stats.InFlightReadbacks = Count;
+        Stats.LastLatencyMilliseconds = LatencySeconds * 1000.0;
+        Stats.MaxLatencyMilliseconds = FMath::Max(Stats.MaxLatencyMilliseconds, Stats.LastLatencyMilliseconds);
+        TotalLatencySeconds += LatencySeconds;
+        Stats.AverageLatencyMilliseconds = TotalLatencySeconds * 1000.0 / Stats.CompletedReadbacks;
+        const double ElapsedSeconds = NowSeconds - FirstIssueSeconds;
+        Stats.ResolvedFramesPerSecond = ElapsedSeconds > KINDA_SMALL_NUMBER ? Stats.CompletedReadbacks / ElapsedSeconds : 0.0;
+    }
+
+    if (Consumer)
+    {
+        Consumer(MoveTemp(Request));
+    }
+}
+
+bool FOmniCaptureReadbackQueue::ResolvePixels(IOmniCaptureReadback& Readback, const FIntPoint& Size, EOmniCapturePixelPrecision Precision, bool bLinear, TUniquePtr<FImagePixelData>& OutPixelData, EOmniCapturePixelDataType& OutPixelDataType)
+{
+    if (Size.X <= 0 || Size.Y <= 0)
+    {
+        return false;
+    }
+
+    int32 RowPitchInBytes = 0;
+    const uint8* RawData = static_cast<const uint8*>(Readback.Lock(RowPitchInBytes));
+    if (!RawData)
+    {
+        return false;
+    }
+
+    const bool bFullFloat = Precision == EOmniCapturePixelPrecision::FullFloat;
+    const uint32 BytesPerPixel = bFullFloat ? sizeof(FLinearColor) : sizeof(FFloat16Color);
+    const uint32 RowStrideInBytes = RowPitchInBytes > 0
+        ? static_cast<uint32>(RowPitchInBytes)
+        : static_cast<uint32>(Size.X * BytesPerPixel);
+    if (bLinear)
+    {
+        if (bFullFloat)
+        {
+            TUniquePtr<TImagePixelData<FLinearColor>> PixelData = FOmniCaptureFramePool::Get().Acquire<FLinearColor>(Size);
+            CopyLinearRows(RawData, RowStrideInBytes, Size, PixelData->Pixels.GetData());
+            OutPixelData = MoveTemp(PixelData);
+            OutPixelDataType = EOmniCapturePixelDataType::LinearColorFloat32;
+        }
+        else
+        {
+            TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = FOmniCaptureFramePool::Get().Acquire<FFloat16Color>(Size);
+            CopyLinearRows(RawData, RowStrideInBytes, Size, PixelData->Pixels.GetData());
+            OutPixelData = MoveTemp(PixelData);
+            OutPixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+        }
+    }
+    else
+    {
+        TUniquePtr<TImagePixelData<FColor>> PixelData = FOmniCaptureFramePool::Get().Acquire<FColor>(Size);
+        if (bFullFloat)
+        {
+            ConvertRowsToSRGB<FLinearColor>(RawData, RowStrideInBytes, Size, PixelData->Pixels.GetData());
+        }
+        else
+        {
+            ConvertRowsToSRGB<FFloat16Color>(RawData, RowStrideInBytes, Size, PixelData->Pixels.GetData());
+        }
+        OutPixelData = MoveTemp(PixelData);
+        OutPixelDataType = EOmniCapturePixelDataType::Color8;
+    }
+
+    Readback.Unlock();
+    return true;
+}
@@ -1,35 +1,80 @@
 #include "OmniCaptureRingBuffer.h"
 
 #include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
 #include "HAL/Runnable.h"
 #include "HAL/RunnableThread.h"
-#include "Math/UnrealMathUtility.h"
+#include "OmniCaptureBoundedQueue.h"
 
-class FOmniCaptureRingBufferWorker final : public FRunnable
+#include <atomic>
+
+// One consumer of the ring buffer: its own queue of shared frame references (the sink's read cursor), its own
+// worker thread and its own backpressure policy.
+class FOmniCaptureFrameSink final : public FRunnable
 {
 public:
-    FOmniCaptureRingBufferWorker(TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc>& InQueue, FEvent* InEvent, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer, FCriticalSection& InQueueCS, TAtomic<bool>& InRunning, TAtomic<int32>& InPending)
-        : Queue(InQueue)
-        , DataEvent(InEvent)
+    FOmniCaptureFrameSink(FName InName, const FOmniCaptureRingBuffer::FSinkConsumer& InConsumer, EOmniCaptureRingBufferPolicy InPolicy, int32 InCapacity)
+        : Name(InName)
         , Consumer(InConsumer)
-        , QueueCS(InQueueCS)
-        , bRunning(InRunning)
-        , Pending(InPending)
+        , Queue(static_cast<uint32>(InCapacity))
+        , Capacity(InCapacity)
+        , Policy(InPolicy)
     {
+        bRunning = true;
+        bConsumerWaiting = false;
+        WaitingProducerCount = 0;
+        PendingCount = 0;
+        InFlightCount = 0;
+        DroppedCount = 0;
+        BlockedCount = 0;
+        ConsumedCount = 0;
+        ConsumeCycles = 0;
+
+        DataEvent = FPlatformProcess::GetSynchEventFromPool();
+        SpaceEvent = FPlatformProcess::GetSynchEventFromPool();
+        IdleEvent = FPlatformProcess::GetSynchEventFromPool();
+        WorkerThread.Reset(FRunnableThread::Create(this, *FString::Printf(TEXT("OmniCaptureSink_%s"), *Name.ToString())));
+    }
+
+    virtual ~FOmniCaptureFrameSink() override
+    {
+        bRunning = false;
+        DataEvent->Trigger();
+        if (WorkerThread.IsValid())
+        {
+            WorkerThread->WaitForCompletion();
+            WorkerThread.Reset();
+        }
+
+        // The worker drains before it exits; this only catches frames if the thread could not be created.
+        Drain();
+
+        FPlatformProcess::ReturnSynchEventToPool(IdleEvent);
+        IdleEvent = nullptr;
+
+        FPlatformProcess::ReturnSynchEventToPool(DataEvent);
+        DataEvent = nullptr;
+        FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+        SpaceEvent = nullptr;
     }
 
     virtual uint32 Run() override
     {
         while (bRunning.Load())
         {
-            DataEvent->Wait();
+            Drain();
 
-            if (!bRunning.Load())
+            // Announce the sleep before the final emptiness check so a producer that enqueues in between sees the
+            // flag and raises the event. The fences order the flag against the queue's slot sequence loads/stores.
+            bConsumerWaiting = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!Queue.IsEmpty() || !bRunning.Load())
             {
-                break;
+                bConsumerWaiting = false;
+                continue;
             }
 
-            Drain();
+            DataEvent->Wait();
         }
 
         Drain();
@@ -37,187 +82,266 @@ public:
         return 0;
     }
 
-private:
-    void Drain()
+    EOmniCaptureRingBufferPolicy GetPolicy() const
     {
-        if (!Consumer)
-        {
-            return;
-        }
+        return Policy;
+    }
 
-        for (;;)
+    void Push(const FOmniCaptureSharedFrame& Frame)
+    {
+        if (!TryReserveSlot())
         {
-            TUniquePtr<FOmniCaptureFrame> Frame;
+            if (Policy == EOmniCaptureRingBufferPolicy::DropOldest)
             {
-                FScopeLock Lock(&QueueCS);
-                if (!Queue.Dequeue(Frame))
+                for (;;)
                 {
-                    break;
+                    // Taking the oldest frame out hands its slot over to this producer.
+                    FOmniCaptureSharedFrame Discarded;
+                    if (Queue.TryDequeue(Discarded))
+                    {
+                        DroppedCount.IncrementExchange();
+                        break;
+                    }
+
+                    // The consumer emptied a slot in the meantime, or another producer has reserved but not yet
+                    // published the oldest one; either way retry.
+                    if (TryReserveSlot())
+                    {
+                        break;
+                    }
+                    FPlatformProcess::Yield();
                 }
             }
-
-            if (Frame.IsValid())
+            else
             {
-                Consumer(MoveTemp(Frame));
-                Pending.DecrementExchange();
+                BlockedCount.IncrementExchange();
+                WaitingProducerCount.IncrementExchange();
+                while (!TryReserveSlot())
+                {
+                    SpaceEvent->Wait();
+                }
+                WaitingProducerCount.DecrementExchange();
+
+                // Auto-reset events coalesce; pass the wake-up on in case another producer is still waiting.
+                if (WaitingProducerCount.Load() > 0 && PendingCount.Load() < Capacity)
+                {
+                    SpaceEvent->Trigger();
+                }
             }
         }
-    }
 
-private:
-    TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc>& Queue;
-    FEvent* DataEvent = nullptr;
-    TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)> Consumer;
-    FCriticalSection& QueueCS;
-    TAtomic<bool>& bRunning;
-    TAtomic<int32>& Pending;
-};
-
-FOmniCaptureRingBuffer::FOmniCaptureRingBuffer()
-{
-    bRunning = false;
-    PendingCount = 0;
-    DroppedCount = 0;
-    BlockedCount = 0;
-}
+        // A reserved slot guarantees room: the queue holds at least Capacity frames.
+        FOmniCaptureSharedFrame Entry = Frame;
+        verify(Queue.TryEnqueue(Entry));
 
-FOmniCaptureRingBuffer::~FOmniCaptureRingBuffer()
-{
-    StopWorker();
-    Flush();
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (bConsumerWaiting.Exchange(false))
+        {
+            DataEvent->Trigger();
+        }
+    }
 
-    if (DataEvent)
+    // Wakes the worker and waits until every frame pushed so far has been consumed, including one the worker is
+    // still handing to the consumer. Frames are only ever consumed on the worker thread, so they stay in order.
+    void Flush()
     {
-        FPlatformProcess::ReturnSynchEventToPool(DataEvent);
-        DataEvent = nullptr;
-    }
-}
+        if (!WorkerThread.IsValid())
+        {
+            Drain();
+            return;
+        }
 
-void FOmniCaptureRingBuffer::Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer)
-{
-    Consumer = InConsumer;
-    Capacity = FMath::Max(0, Settings.RingBufferCapacity);
-    Policy = Settings.RingBufferPolicy;
-    StartWorker();
-}
+        while (!IsIdle())
+        {
+            DataEvent->Trigger();
+            // The timeout covers a wake-up the worker raised between the check above and this wait.
+            IdleEvent->Wait(10);
+        }
+    }
 
-void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
-{
-    if (!Consumer)
+    FOmniCaptureFrameSinkStats GetStats() const
     {
-        return;
+        FOmniCaptureFrameSinkStats Stats;
+        Stats.Name = Name;
+        Stats.Capacity = Capacity;
+        Stats.PendingFrames = PendingCount.Load();
+        Stats.DroppedFrames = DroppedCount.Load();
+        Stats.BlockedPushes = BlockedCount.Load();
+        Stats.ConsumedFrames = ConsumedCount.Load();
+        Stats.AverageConsumeMilliseconds = Stats.ConsumedFrames > 0
+            ? FPlatformTime::ToMilliseconds64(ConsumeCycles.Load()) / Stats.ConsumedFrames
+            : 0.0;
+        return Stats;
     }
 
-    if (Capacity > 0)
+private:
+    // Dequeues and consumes frames until the queue is empty. Runs on the worker thread only, or on the destroying
+    // thread once the worker has exited.
+    void Drain()
     {
         for (;;)
         {
-            const int32 Current = PendingCount.Load();
-            if (Current < Capacity)
+            // Count the frame as in flight before it leaves the queue so Flush never sees it in neither place.
+            InFlightCount.IncrementExchange();
+            FOmniCaptureSharedFrame Frame;
+            if (!Queue.TryDequeue(Frame))
             {
+                InFlightCount.DecrementExchange();
                 break;
             }
 
-            if (Policy == EOmniCaptureRingBufferPolicy::DropOldest)
-            {
-                TUniquePtr<FOmniCaptureFrame> Discarded;
-                {
-                    FScopeLock Lock(&QueueCriticalSection);
-                    if (Queue.Dequeue(Discarded))
-                    {
-                        PendingCount.DecrementExchange();
-                    }
-                }
-                DroppedCount.IncrementExchange();
-                break;
-            }
-            else
+            // Free the slot before the (possibly slow) consumer runs so a blocked producer can continue.
+            ReleaseSlot();
+            if (Frame.IsValid())
             {
-                BlockedCount.IncrementExchange();
-                FPlatformProcess::Sleep(0.001f);
+                const uint64 StartCycles = FPlatformTime::Cycles64();
+                Consumer(Frame);
+                ConsumeCycles.AddExchange(FPlatformTime::Cycles64() - StartCycles);
+                ConsumedCount.IncrementExchange();
             }
+            Frame.Reset();
+            InFlightCount.DecrementExchange();
         }
-    }
 
-    {
-        FScopeLock Lock(&QueueCriticalSection);
-        Queue.Enqueue(MoveTemp(Frame));
-        PendingCount.IncrementExchange();
+        IdleEvent->Trigger();
     }
 
-    if (DataEvent)
+    // A pushed frame holds its slot until it is dequeued and is in flight from just before then until its consumer
+    // returns, so reading the slot count first leaves no gap between the two.
+    bool IsIdle() const
     {
-        DataEvent->Trigger();
+        return PendingCount.Load() == 0 && InFlightCount.Load() == 0;
     }
-}
 
-void FOmniCaptureRingBuffer::Flush()
-{
-    if (!Consumer)
-    {
-        return;
-    }
-
-    TUniquePtr<FOmniCaptureFrame> Frame;
-    for (;;)
+    // Claims one of the Capacity slots for a producer; fails when the sink is full.
+    bool TryReserveSlot()
     {
+        int32 Current = PendingCount.Load();
+        while (Current < Capacity)
         {
-            FScopeLock Lock(&QueueCriticalSection);
-            if (!Queue.Dequeue(Frame))
+            if (PendingCount.CompareExchange(Current, Current + 1))
             {
-                break;
+                return true;
             }
         }
+        return false;
+    }
 
-        if (Frame.IsValid())
+    void ReleaseSlot()
+    {
+        PendingCount.DecrementExchange();
+        if (WaitingProducerCount.Load() > 0)
         {
-            Consumer(MoveTemp(Frame));
-            PendingCount.DecrementExchange();
+            SpaceEvent->Trigger();
         }
     }
+
+    FName Name;
+    FOmniCaptureRingBuffer::FSinkConsumer Consumer;
+    TOmniCaptureBoundedQueue<FOmniCaptureSharedFrame> Queue;
+    int32 Capacity = 0;
+    EOmniCaptureRingBufferPolicy Policy = EOmniCaptureRingBufferPolicy::DropOldest;
+
+    TUniquePtr<FRunnableThread> WorkerThread;
+    // Raised by producers only when the worker has announced it is about to sleep.
+    FEvent* DataEvent = nullptr;
+    // Raised by the consumer only when a BlockProducer producer is waiting for a slot.
+    FEvent* SpaceEvent = nullptr;
+    // Raised by the worker whenever it runs out of frames, for a waiting Flush.
+    FEvent* IdleEvent = nullptr;
+    TAtomic<bool> bRunning;
+    TAtomic<bool> bConsumerWaiting;
+    TAtomic<int32> WaitingProducerCount;
+    TAtomic<int32> PendingCount;
+    TAtomic<int32> InFlightCount;
+    TAtomic<int32> DroppedCount;
+    TAtomic<int32> BlockedCount;
+    TAtomic<int32> ConsumedCount;
+    TAtomic<uint64> ConsumeCycles;
+};
+
+FOmniCaptureRingBuffer::FOmniCaptureRingBuffer()
+{
 }
 
-void FOmniCaptureRingBuffer::StartWorker()
+FOmniCaptureRingBuffer::~FOmniCaptureRingBuffer()
 {
-    if (WorkerThread.IsValid())
+    // Each sink stops its worker and drains what it still holds.
+    Sinks.Reset();
+}
+
+void FOmniCaptureRingBuffer::Initialize(const FOmniCaptureSettings& Settings)
+{
+    Capacity = Settings.RingBufferCapacity > 0 ? Settings.RingBufferCapacity : UnboundedCapacity;
+    Policy = Settings.RingBufferCapacity > 0 ? Settings.RingBufferPolicy : EOmniCaptureRingBufferPolicy::BlockProducer;
+}
+
+void FOmniCaptureRingBuffer::AddSink(FName Name, const FSinkConsumer& Consumer)
+{
+    AddSink(Name, Consumer, Policy, Capacity);
+}
+
+void FOmniCaptureRingBuffer::AddSink(FName Name, const FSinkConsumer& Consumer, EOmniCaptureRingBufferPolicy SinkPolicy, int32 SinkCapacity)
+{
+    if (!Consumer)
     {
         return;
     }
 
-    DataEvent = FPlatformProcess::GetSynchEventFromPool();
-    bRunning = true;
+    if (SinkCapacity <= 0)
+    {
+        SinkCapacity = UnboundedCapacity;
+        SinkPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+    }
 
-    Worker = new FOmniCaptureRingBufferWorker(Queue, DataEvent, Consumer, QueueCriticalSection, bRunning, PendingCount);
-    WorkerThread.Reset(FRunnableThread::Create(Worker, TEXT("OmniCaptureRingBuffer")));
+    Sinks.Add(MakeUnique<FOmniCaptureFrameSink>(Name, Consumer, SinkPolicy, SinkCapacity));
 }
 
-void FOmniCaptureRingBuffer::StopWorker()
+void FOmniCaptureRingBuffer::Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
 {
-    if (!WorkerThread.IsValid())
+    if (!Frame.IsValid() || Sinks.Num() == 0)
     {
         return;
     }
 
-    bRunning = false;
+    const FOmniCaptureSharedFrame SharedFrame = MakeShareable(Frame.Release());
 
-    if (DataEvent)
+    // Hand the frame to sinks that never wait first, so a producer held up by a full blocking sink does not also
+    // hold the frame back from the others.
+    for (const TUniquePtr<FOmniCaptureFrameSink>& Sink : Sinks)
     {
-        DataEvent->Trigger();
+        if (Sink->GetPolicy() == EOmniCaptureRingBufferPolicy::DropOldest)
+        {
+            Sink->Push(SharedFrame);
+        }
     }
 
-    WorkerThread->WaitForCompletion();
-    WorkerThread.Reset();
+    for (const TUniquePtr<FOmniCaptureFrameSink>& Sink : Sinks)
+    {
+        if (Sink->GetPolicy() != EOmniCaptureRingBufferPolicy::DropOldest)
+        {
+            Sink->Push(SharedFrame);
+        }
+    }
+}
 
-    delete Worker;
-    Worker = nullptr;
+void FOmniCaptureRingBuffer::Flush()
+{
+    for (const TUniquePtr<FOmniCaptureFrameSink>& Sink : Sinks)
+    {
+        Sink->Flush();
+    }
 }
 
 FOmniCaptureRingBufferStats FOmniCaptureRingBuffer::GetStats() const
 {
     FOmniCaptureRingBufferStats Stats;
-    Stats.PendingFrames = PendingCount.Load();
-    Stats.DroppedFrames = DroppedCount.Load();
-    Stats.BlockedPushes = BlockedCount.Load();
+    for (const TUniquePtr<FOmniCaptureFrameSink>& Sink : Sinks)
+    {
+        FOmniCaptureFrameSinkStats& SinkStats = Stats.Sinks.Add_GetRef(Sink->GetStats());
+        Stats.PendingFrames = FMath::Max(Stats.PendingFrames, SinkStats.PendingFrames);
+        Stats.DroppedFrames += SinkStats.DroppedFrames;
+        Stats.BlockedPushes += SinkStats.BlockedPushes;
+    }
     return Stats;
 }
-
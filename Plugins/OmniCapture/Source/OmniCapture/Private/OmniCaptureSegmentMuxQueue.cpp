@@ -0,0 +1,135 @@
+#include "OmniCaptureSegmentMuxQueue.h"
+
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+FOmniCaptureSegmentMuxQueue::FOmniCaptureSegmentMuxQueue(FMuxStep InMuxStep)
+    : MuxStep(MoveTemp(InMuxStep))
+{
+}
+
+FOmniCaptureSegmentMuxQueue::~FOmniCaptureSegmentMuxQueue()
+{
+    // The pool's tasks point back at this queue, so it has to be gone before the jobs and the lock are.
+    Cancel();
+}
+
+void FOmniCaptureSegmentMuxQueue::Reset(int32 InMaxConcurrentMuxes)
+{
+    Pool.Reset();
+    Jobs.Empty();
+    MaxConcurrentMuxes = FMath::Max(1, InMaxConcurrentMuxes);
+    bCancelled.Store(false);
+}
+
+void FOmniCaptureSegmentMuxQueue::Submit(const FJobRef& Job)
+{
+    if (!Job.IsValid())
+    {
+        return;
+    }
+
+    if (!Pool)
+    {
+        Pool = MakeUnique<FOmniCaptureWriterPool>(TEXT("SegmentMux"), MaxConcurrentMuxes, 0, TPri_BelowNormal, 0);
+    }
+
+    {
+        FScopeLock Lock(&CriticalSection);
+        Job->Status.State = EOmniCaptureSegmentMuxState::Queued;
+    }
+    Jobs.Add(Job);
+    Pool->Submit([this, Job]()
+    {
+        return RunJob(*Job);
+    }, 0);
+}
+
+void FOmniCaptureSegmentMuxQueue::WaitUntilIdle()
+{
+    if (Pool)
+    {
+        Pool->WaitUntilIdle();
+        Pool.Reset();
+    }
+}
+
+void FOmniCaptureSegmentMuxQueue::Cancel()
+{
+    bCancelled.Store(true);
+    // The pool drains on destruction; the flag turns what is still queued into no-ops.
+    Pool.Reset();
+}
+
+void FOmniCaptureSegmentMuxQueue::ReportFinished(TFunctionRef<void(const FOmniCaptureSegmentMuxJob&)> Report)
+{
+    for (const FJobRef& Job : Jobs)
+    {
+        if (Job->bReported)
+        {
+            continue;
+        }
+
+        EOmniCaptureSegmentMuxState State;
+        {
+            FScopeLock Lock(&CriticalSection);
+            State = Job->Status.State;
+        }
+        if (State == EOmniCaptureSegmentMuxState::Queued || State == EOmniCaptureSegmentMuxState::Muxing)
+        {
+            return;
+        }
+
+        Job->bReported = true;
+        if (State != EOmniCaptureSegmentMuxState::Cancelled)
+        {
+            Report(*Job);
+        }
+    }
+}
+
+TArray<FOmniCaptureSegmentMuxStatus> FOmniCaptureSegmentMuxQueue::GetStatus() const
+{
+    TArray<FOmniCaptureSegmentMuxStatus> Result;
+    Result.Reserve(Jobs.Num());
+
+    const double Now = FPlatformTime::Seconds();
+    FScopeLock Lock(&CriticalSection);
+    for (const FJobRef& Job : Jobs)
+    {
+        FOmniCaptureSegmentMuxStatus& Status = Result.Add_GetRef(Job->Status);
+        if (Status.State == EOmniCaptureSegmentMuxState::Muxing)
+        {
+            Status.MuxSeconds = Now - Job->StartTime;
+        }
+    }
+    return Result;
+}
+
+bool FOmniCaptureSegmentMuxQueue::RunJob(FOmniCaptureSegmentMuxJob& Job)
+{
+    if (bCancelled.Load())
+    {
+        Job.Muxer.Reset();
+        FScopeLock Lock(&CriticalSection);
+        Job.Status.State = EOmniCaptureSegmentMuxState::Cancelled;
+        return true;
+    }
+
+    {
+        FScopeLock Lock(&CriticalSection);
+        Job.StartTime = FPlatformTime::Seconds();
+        Job.Status.State = EOmniCaptureSegmentMuxState::Muxing;
+    }
+
+    FString OutputPath;
+    const bool bSucceeded = MuxStep ? MuxStep(Job, OutputPath) : false;
+    Job.Muxer.Reset();
+
+    FScopeLock Lock(&CriticalSection);
+    Job.bSucceeded = bSucceeded;
+    Job.Status.State = bSucceeded ? EOmniCaptureSegmentMuxState::Succeeded : EOmniCaptureSegmentMuxState::Failed;
+    Job.Status.OutputPath = bSucceeded ? OutputPath : FString();
+    Job.Status.MuxSeconds = FPlatformTime::Seconds() - Job.StartTime;
+    return bSucceeded;
+}
@@ -3,13 +3,17 @@
 #include "OmniCaptureAudioRecorder.h"
 #include "OmniCaptureDirectorActor.h"
 #include "OmniCaptureEquirectConverter.h"
+#include "OmniCaptureFramePool.h"
 #include "OmniCaptureNVENCEncoder.h"
 #include "OmniCaptureImageWriter.h"
 #include "OmniCaptureRigActor.h"
 #include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureReadbackQueue.h"
 #include "OmniCapturePreviewActor.h"
 #include "OmniCaptureMuxer.h"
+#include "OmniCaptureProjectionLUT.h"
 #include "OmniCaptureSettingsValidator.h"
+#include "OmniCaptureWriterPool.h"
 
 #include "Curves/CurveFloat.h"
 #include "Engine/World.h"
@@ -23,6 +27,7 @@
 #include "HAL/PlatformMisc.h"
 #include "HAL/PlatformProcess.h"
 #include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
 #include "RHI.h"
 #include "PixelFormat.h"
 #include "Math/UnrealMathUtility.h"
@@ -62,6 +67,32 @@ namespace
             return EOmniCaptureDiagnosticLevel::Info;
         }
     }
+
+    // Hands the GPU outputs of a conversion to its frame: the texture and planes the encoder reads, and the target
+    // they come from, which the frame keeps alive.
+    void AttachGPUOutputs(const FOmniCaptureEquirectResult& Result, FOmniCaptureFrame& Frame)
+    {
+        Frame.GPUSource = Result.OutputTarget;
+        Frame.Texture = Result.Texture;
+        Frame.ReadyFence = Result.ReadyFence;
+        Frame.EncoderTextures.Reset();
+        for (const TRefCountPtr<IPooledRenderTarget>& Plane : Result.EncoderPlanes)
+        {
+            if (!Plane.IsValid())
+            {
+                continue;
+            }
+
+            if (FRHITexture* PlaneTexture = Plane->GetRHI())
+            {
+                Frame.EncoderTextures.Add(PlaneTexture);
+            }
+        }
+        if (Frame.EncoderTextures.Num() == 0 && Frame.Texture.IsValid())
+        {
+            Frame.EncoderTextures.Add(Frame.Texture);
+        }
+    }
 }
 
 bool UOmniCaptureSubsystem::ShouldRecordDiagnostic(EOmniCaptureDiagnosticLevel Level) const
@@ -311,6 +342,17 @@ void UOmniCaptureSubsystem::ClearCaptureDiagnosticLog()
     }
 }
 
+bool UOmniCaptureSubsystem::RecoverAudioFile(const FString& FilePath)
+{
+    if (!FOmniCaptureAudioFileWriter::RecoverFile(FilePath))
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("Audio"), FString::Printf(TEXT("Could not recover audio file %s"), *FilePath));
+        return false;
+    }
+    LogDiagnosticMessage(ELogVerbosity::Log, TEXT("Audio"), FString::Printf(TEXT("Recovered audio file %s"), *FilePath));
+    return true;
+}
+
 void UOmniCaptureSubsystem::Initialize(FSubsystemCollectionBase& Collection)
 {
     Super::Initialize(Collection);
@@ -362,6 +404,7 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     CurrentSegmentIndex = 0;
     CapturedFrameMetadata.Empty();
     CompletedSegments.Empty();
+    SegmentMuxes.Reset(ActiveSettings.MaxConcurrentSegmentMuxes);
     RecordedAudioPath.Reset();
     RecordedVideoPath.Reset();
     LastFinalizedOutput.Empty();
@@ -374,6 +417,9 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
 
     ActiveWarnings.Empty();
     LatestRingBufferStats = FOmniCaptureRingBufferStats();
+    LatestReadbackStats = FOmniCaptureReadbackStats();
+    LatestFramePoolStats = FOmniCaptureFramePoolStats();
+    LatestWriterPoolStats = FOmniCaptureWriterPoolStats();
     AudioStats = FOmniAudioSyncStats();
     ResetDynamicWarnings();
 
@@ -385,7 +431,6 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     LastFpsSampleTime = 0.0;
     FramesSinceLastFpsSample = 0;
     LastRuntimeWarningCheckTime = FPlatformTime::Seconds();
-    LastSegmentSizeCheckTime = LastRuntimeWarningCheckTime;
 
     SetDiagnosticContext(TEXT("ValidateEnvironment"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Validating capture environment."), TEXT("ValidateEnvironment"));
@@ -482,58 +527,117 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
         OutputMuxer->BeginRealtimeSession(ActiveSettings);
     }
 
+    // Each output reads the ring buffer on its own thread, so a slow image encode never holds up encoder submission
+    // or the muxer's audio sync bookkeeping.
     RingBuffer = MakeUnique<FOmniCaptureRingBuffer>();
-    RingBuffer->Initialize(ActiveSettings, [this](TUniquePtr<FOmniCaptureFrame>&& Frame)
-    {
-        if (!Frame.IsValid())
-        {
-            return;
-        }
+    RingBuffer->Initialize(ActiveSettings);
+    ReportedRingBufferDrops = 0;
 
-        if (OutputMuxer)
+    const bool bStreamToFFmpeg = FOmniCaptureMuxer::ShouldStreamLive(ActiveSettings);
+    if (OutputMuxer)
+    {
+        // Without a live encode the muxer only keeps timing bookkeeping per frame and never stalls, so it must not miss
+        // frames. A live encode waits on FFmpeg, and what happens when it falls behind is the ring buffer policy's call.
+        const EOmniCaptureRingBufferPolicy MuxerPolicy = bStreamToFFmpeg ? ActiveSettings.RingBufferPolicy : EOmniCaptureRingBufferPolicy::BlockProducer;
+        RingBuffer->AddSink(TEXT("Muxer"), [this](const FOmniCaptureSharedFrame& Frame)
         {
-            OutputMuxer->PushFrame(*Frame);
+            if (!OutputMuxer->PushFrame(Frame) && ImageWriter)
+            {
+                // The live encode failed; the rest of the segment goes to the image sequence rather than nowhere.
+                const FString FileName = BuildFrameFileName(Frame->Metadata.FrameIndex, ActiveSettings.GetImageFileExtension());
+                ImageWriter->EnqueueFrame(Frame, FileName);
+            }
             AudioStats = OutputMuxer->GetAudioStats();
             if (AudioRecorder)
             {
                 AudioStats.PendingPackets += AudioRecorder->GetPendingPacketCount();
+                AudioStats.DroppedPackets = AudioRecorder->GetDroppedPacketCount();
+                AudioStats.Underruns = AudioRecorder->GetUnderrunCount();
+                AudioStats.ClockCorrectionPPM = AudioRecorder->GetClockCorrectionPPM();
+                AudioStats.ClockResyncs = AudioRecorder->GetClockResyncCount();
             }
-        }
+        }, MuxerPolicy, ActiveSettings.RingBufferCapacity);
+    }
 
-        switch (ActiveSettings.OutputFormat)
+    switch (ActiveSettings.OutputFormat)
+    {
+    case EOmniOutputFormat::ImageSequence:
+        if (bStreamToFFmpeg)
+        {
+            // The muxer sink hands the frames to FFmpeg, and to the image writer only if the live encode fails.
+            break;
+        }
+        RingBuffer->AddSink(TEXT("ImageWriter"), [this](const FOmniCaptureSharedFrame& Frame)
         {
-        case EOmniOutputFormat::ImageSequence:
             if (ImageWriter)
             {
                 const FString FileName = BuildFrameFileName(Frame->Metadata.FrameIndex, ActiveSettings.GetImageFileExtension());
-                ImageWriter->EnqueueFrame(MoveTemp(Frame), FileName);
+                ImageWriter->EnqueueFrame(Frame, FileName);
             }
-            break;
-        case EOmniOutputFormat::NVENCHardware:
+        });
+        break;
+    case EOmniOutputFormat::NVENCHardware:
+        RingBuffer->AddSink(TEXT("NVENC"), [this](const FOmniCaptureSharedFrame& Frame)
+        {
             if (NVENCEncoder)
             {
                 NVENCEncoder->EnqueueFrame(*Frame);
             }
-            if (bUsingNVENCImageFallback.Load() && ImageWriter && Frame.IsValid())
+        });
+        // The fallback writer is best effort next to the encoder; it drops its own backlog rather than pushing back.
+        RingBuffer->AddSink(TEXT("ImageFallback"), [this](const FOmniCaptureSharedFrame& Frame)
+        {
+            if (bUsingNVENCImageFallback.Load() && ImageWriter)
             {
                 const FString FileName = BuildFrameFileName(Frame->Metadata.FrameIndex, ActiveSettings.GetImageFileExtension());
-                ImageWriter->EnqueueFrame(MoveTemp(Frame), FileName);
+                ImageWriter->EnqueueFrame(Frame, FileName);
             }
-            break;
-        default:
-            break;
-        }
+        }, EOmniCaptureRingBufferPolicy::DropOldest, FMath::Max(ActiveSettings.RingBufferCapacity, 1));
+        break;
+    default:
+        break;
+    }
 
-        if (RingBuffer.IsValid())
+    ReadbackQueue.Reset();
+    ResolvedFrames.Empty();
+    if (ActiveSettings.ReadbackQueueDepth > 0)
+    {
+        ReadbackQueue = MakeShared<FOmniCaptureReadbackQueue, ESPMode::ThreadSafe>();
+        // The consumer runs on the render thread, so it works from a copy of the settings taken here and never waits on
+        // a sink: resolved frames are handed to the game thread, which feeds them to the ring buffer.
+        ReadbackQueue->Initialize(ActiveSettings.ReadbackQueueDepth, [this, ReadbackSettings = ActiveSettings](FOmniCaptureReadbackRequest&& Request)
         {
-            LatestRingBufferStats = RingBuffer->GetStats();
-            if (LatestRingBufferStats.DroppedFrames > DroppedFrameCount)
+            if (Request.bWantsPreview && Request.Frame.IsValid() && Request.Frame->PixelData.IsValid())
             {
-                DroppedFrameCount = LatestRingBufferStats.DroppedFrames;
-                HandleDroppedFrame();
+                const FImagePixelData& PixelData = *Request.Frame->PixelData;
+                const FIntRect ViewRect = FOmniCapturePreviewImage::GetViewRect(PixelData.GetSize(), ReadbackSettings, ReadbackSettings.PreviewVisualization);
+                if (ReadbackPreview.Build(PixelData, Request.Frame->PixelDataType, ViewRect, ReadbackSettings.PreviewMaxEdge))
+                {
+                    FScopeLock Lock(&ResolvedPreviewCriticalSection);
+                    Swap(ResolvedPreview, ReadbackPreview);
+                }
+            }
+
+            if (!Request.Frame.IsValid())
+            {
+                return;
+            }
+
+            // A failed copy leaves nothing to write for image output; the failure shows up in the readback stats. A
+            // GPU conversion that failed on the render thread likewise leaves the encoder nothing to read.
+            if (!Request.Frame->PixelData.IsValid() && ReadbackSettings.OutputFormat == EOmniOutputFormat::ImageSequence)
+            {
+                return;
+            }
+            if (!Request.Frame->Texture.IsValid() && ReadbackSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+            {
+                return;
             }
-        }
-    });
+
+            ResolvedFrames.Enqueue(MoveTemp(Request.Frame));
+        });
+        LatestReadbackStats = ReadbackQueue->GetStats();
+    }
 
     InitializeAudioRecording();
 
@@ -543,7 +647,6 @@ void UOmniCaptureSubsystem::BeginCapture(const FOmniCaptureSettings& InSettings)
     FrameCounter = 0;
     CaptureStartTime = FPlatformTime::Seconds();
     CurrentSegmentStartTime = CaptureStartTime;
-    LastSegmentSizeCheckTime = CurrentSegmentStartTime;
     LastRuntimeWarningCheckTime = CurrentSegmentStartTime;
     PreviewFrameInterval = (ActiveSettings.bEnablePreviewWindow && ActiveSettings.PreviewFrameRate > 0.f) ? (1.0 / FMath::Max(1.0f, ActiveSettings.PreviewFrameRate)) : 0.0;
     LastPreviewUpdateTime = CaptureStartTime;
@@ -600,14 +703,14 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
     DestroyTickActor();
     DestroyPreviewActor();
     DestroyRig();
+    // Conversion is synchronous with the capture tick, so nothing projects through the cache past this point.
+    FOmniCaptureProjectionLUT::ResetCache();
 
     ShutdownAudioRecording();
 
-    if (RingBuffer)
-    {
-        RingBuffer->Flush();
-        RingBuffer.Reset();
-    }
+    FlushRingBuffer();
+    ReadbackQueue.Reset();
+    RingBuffer.Reset();
 
     ShutdownOutputWriters(bFinalize);
     if (OutputMuxer)
@@ -615,6 +718,8 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
         OutputMuxer->EndRealtimeSession();
     }
     FinalizeOutputs(bFinalize);
+    // Writers are done with their frames; give the idle buffers back to the allocator.
+    FOmniCaptureFramePool::Get().Trim();
 
     RecordCaptureCompletion(bFinalize);
 
@@ -626,6 +731,9 @@ void UOmniCaptureSubsystem::EndCapture(bool bFinalize)
 
     State = EOmniCaptureState::Idle;
     LatestRingBufferStats = FOmniCaptureRingBufferStats();
+    LatestReadbackStats = FOmniCaptureReadbackStats();
+    LatestFramePoolStats = FOmniCaptureFramePoolStats();
+    LatestWriterPoolStats = FOmniCaptureWriterPoolStats();
     AudioStats = FOmniAudioSyncStats();
 }
 
@@ -641,10 +749,7 @@ void UOmniCaptureSubsystem::PauseCapture()
     SetDiagnosticContext(TEXT("Paused"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Capture paused."), TEXT("Paused"));
 
-    if (RingBuffer)
-    {
-        RingBuffer->Flush();
-    }
+    FlushRingBuffer();
 
     if (AudioRecorder)
     {
@@ -748,60 +853,20 @@ bool UOmniCaptureSubsystem::CapturePanoramaStill(const FOmniCaptureSettings& InS
 
     FlushRenderingCommands();
 
-    auto ConvertFrame = [](const FOmniCaptureSettings& CaptureSettings, const FOmniEyeCapture& Left, const FOmniEyeCapture& Right)
-    {
-        if (CaptureSettings.IsPlanar())
-        {
-            return FOmniCaptureEquirectConverter::ConvertToPlanar(CaptureSettings, Left);
-        }
-
-        if (CaptureSettings.IsFisheye() && !CaptureSettings.ShouldConvertFisheyeToEquirect())
-        {
-            return FOmniCaptureEquirectConverter::ConvertToFisheye(CaptureSettings, Left, Right);
-        }
-
-        return FOmniCaptureEquirectConverter::ConvertToEquirectangular(CaptureSettings, Left, Right);
-    };
-
-    FOmniCaptureEquirectResult Result = ConvertFrame(StillSettings, LeftEye, RightEye);
+    FOmniCaptureEquirectResult Result = FOmniCaptureEquirectConverter::ConvertLayers(StillSettings, LeftEye, RightEye, StillSettings.AuxiliaryPasses);
 
     TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers;
-    if (StillSettings.AuxiliaryPasses.Num() > 0)
+    for (TPair<EOmniCaptureAuxiliaryPassType, FOmniCaptureLayerPayload>& Layer : Result.AuxiliaryLayers)
     {
-        auto BuildAuxEye = [](const FOmniEyeCapture& SourceEye, EOmniCaptureAuxiliaryPassType PassType)
-        {
-            FOmniEyeCapture AuxEye;
-            AuxEye.ActiveFaceCount = SourceEye.ActiveFaceCount;
-            for (int32 FaceIndex = 0; FaceIndex < AuxEye.ActiveFaceCount && FaceIndex < UE_ARRAY_COUNT(AuxEye.Faces); ++FaceIndex)
-            {
-                AuxEye.Faces[FaceIndex].RenderTarget = SourceEye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType);
-            }
-            return AuxEye;
-        };
-
-        for (EOmniCaptureAuxiliaryPassType PassType : StillSettings.AuxiliaryPasses)
-        {
-            if (PassType == EOmniCaptureAuxiliaryPassType::None)
-            {
-                continue;
-            }
-
-            const FOmniEyeCapture AuxLeft = BuildAuxEye(LeftEye, PassType);
-            const FOmniEyeCapture AuxRight = BuildAuxEye(RightEye, PassType);
-            FOmniCaptureEquirectResult AuxResult = ConvertFrame(StillSettings, AuxLeft, AuxRight);
-            if (AuxResult.PixelData.IsValid())
-            {
-                FOmniCaptureLayerPayload Payload;
-                Payload.PixelData = MoveTemp(AuxResult.PixelData);
-                Payload.bLinear = AuxResult.bIsLinear;
-                Payload.Precision = AuxResult.PixelPrecision;
-                Payload.PixelDataType = AuxResult.PixelDataType;
-                AuxiliaryLayers.Add(GetAuxiliaryLayerName(PassType), MoveTemp(Payload));
-            }
-        }
+        AuxiliaryLayers.Add(GetAuxiliaryLayerName(Layer.Key), MoveTemp(Layer.Value));
     }
 
     World->DestroyActor(TempRig);
+    // A still taken between recordings must not keep its projection tables alive until the next one.
+    if (!bIsCapturing)
+    {
+        FOmniCaptureProjectionLUT::ResetCache();
+    }
 
     if (!Result.PixelData.IsValid())
     {
@@ -827,6 +892,8 @@ bool UOmniCaptureSubsystem::CapturePanoramaStill(const FOmniCaptureSettings& InS
     FOmniCaptureSettings WriterSettings = StillSettings;
     WriterSettings.OutputDirectory = OutputDirectory;
     WriterSettings.OutputFileName = BaseName;
+    // A still is a single image; callers expect it as a file at OutFilePath.
+    WriterSettings.bWriteFrameContainer = false;
     Writer.Initialize(WriterSettings, OutputDirectory);
 
     TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
@@ -909,6 +976,18 @@ FString UOmniCaptureSubsystem::GetStatusString() const
     }
 
     Status += FString::Printf(TEXT(" | Frames:%d Pending:%d Dropped:%d Blocked:%d"), FrameCounter, LatestRingBufferStats.PendingFrames, LatestRingBufferStats.DroppedFrames, LatestRingBufferStats.BlockedPushes);
+    if (LatestReadbackStats.QueueDepth > 0)
+    {
+        Status += FString::Printf(TEXT(" | Readback:%d/%d %.1fms"), LatestReadbackStats.InFlightReadbacks, LatestReadbackStats.QueueDepth, LatestReadbackStats.AverageLatencyMilliseconds);
+    }
+    if (LatestFramePoolStats.Hits + LatestFramePoolStats.Misses > 0)
+    {
+        Status += FString::Printf(TEXT(" | Pool:%lld/%lld hit %.0fMB peak"), LatestFramePoolStats.Hits, LatestFramePoolStats.Hits + LatestFramePoolStats.Misses, LatestFramePoolStats.HighWaterBytes / (1024.0 * 1024.0));
+    }
+    if (LatestWriterPoolStats.WorkerCount > 0)
+    {
+        Status += FString::Printf(TEXT(" | Writer:%d queued %.0f/%.0fMB %.1fms"), LatestWriterPoolStats.QueueDepth, LatestWriterPoolStats.BytesInFlight / (1024.0 * 1024.0), LatestWriterPoolStats.MaxBytesInFlight / (1024.0 * 1024.0), LatestWriterPoolStats.AverageTaskMilliseconds);
+    }
     Status += FString::Printf(TEXT(" | FPS:%.2f"), CurrentCaptureFPS);
     Status += FString::Printf(TEXT(" | Segment:%d"), CurrentSegmentIndex);
 
@@ -936,6 +1015,11 @@ FOmniAudioSyncStats UOmniCaptureSubsystem::GetAudioSyncStats() const
     return AudioStats;
 }
 
+TArray<FOmniCaptureSegmentMuxStatus> UOmniCaptureSubsystem::GetSegmentMuxStatus() const
+{
+    return SegmentMuxes.GetStatus();
+}
+
 UTexture2D* UOmniCaptureSubsystem::GetPreviewTexture() const
 {
     if (const AOmniCapturePreviewActor* Preview = PreviewActor.Get())
@@ -950,9 +1034,14 @@ void UOmniCaptureSubsystem::SetPreviewVisualizationMode(EOmniCapturePreviewView
     ActiveSettings.PreviewVisualization = InView;
     OriginalSettings.PreviewVisualization = InView;
 
+    LastPreviewUpdateTime = 0.0;
+}
+
+void UOmniCaptureSubsystem::SetPreviewEnabled(bool bEnabled)
+{
     if (AOmniCapturePreviewActor* Preview = PreviewActor.Get())
     {
-        Preview->SetPreviewView(InView);
+        Preview->SetPreviewEnabled(bEnabled);
     }
 
     LastPreviewUpdateTime = 0.0;
@@ -1065,7 +1154,6 @@ void UOmniCaptureSubsystem::SpawnPreviewActor()
         const FIntPoint OutputSize = ActiveSettings.GetOutputResolution();
         Preview->Initialize(ActiveSettings.PreviewScreenScale, OutputSize);
         Preview->SetPreviewEnabled(true);
-        Preview->SetPreviewView(ActiveSettings.PreviewVisualization);
         if (RigActor.IsValid())
         {
             Preview->AttachToActor(RigActor.Get(), FAttachmentTransformRules::KeepWorldTransform);
@@ -1096,6 +1184,11 @@ void UOmniCaptureSubsystem::InitializeOutputWriters()
     case EOmniOutputFormat::ImageSequence:
         ImageWriter = MakeUnique<FOmniCaptureImageWriter>();
         ImageWriter->Initialize(ActiveSettings, ActiveSettings.OutputDirectory);
+        if (FOmniCaptureMuxer::ShouldStreamLive(ActiveSettings))
+        {
+            AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Frames will be streamed to FFmpeg; an image sequence is written only if the live encode fails."), TEXT("InitializeOutputs"));
+            break;
+        }
         AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, TEXT("Image sequence writer initialized."), TEXT("InitializeOutputs"));
         break;
     case EOmniOutputFormat::NVENCHardware:
@@ -1149,11 +1242,11 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
 {
     SetDiagnosticContext(TEXT("FinalizeOutputs"));
     AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Finalize outputs requested (Finalize=%s)."), bFinalizeOutputs ? TEXT("true") : TEXT("false")), TEXT("FinalizeOutputs"));
-    bLastCaptureUsedImageSequenceFallback = false;
-    LastImageSequenceFallbackDirectory.Reset();
 
     if (!bFinalizeOutputs)
     {
+        // Muxes already running finish; those still queued are skipped.
+        SegmentMuxes.Cancel();
         CapturedFrameMetadata.Empty();
         CompletedSegments.Empty();
         RecordedAudioPath.Reset();
@@ -1170,7 +1263,7 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
         CompleteActiveSegment(true);
     }
 
-    if (CompletedSegments.Num() == 0)
+    if (CompletedSegments.Num() == 0 && SegmentMuxes.Num() == 0)
     {
         LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("FinalizeOutputs called with no captured frames"));
         OutputMuxer.Reset();
@@ -1181,94 +1274,151 @@ void UOmniCaptureSubsystem::FinalizeOutputs(bool bFinalizeOutputs)
         return;
     }
 
-    if (!OutputMuxer)
+    if (OutputMuxer)
     {
-        OutputMuxer = MakeUnique<FOmniCaptureMuxer>();
+        OutputMuxer->FinishLiveStream();
     }
+    QueueCompletedSegmentMuxes();
 
-    LastFinalizedOutput.Empty();
+    // Earlier segments have been muxing since they rotated, so this mostly waits on the last one.
+    SegmentMuxes.WaitUntilIdle();
+    ReportFinishedSegmentMuxes();
 
-    for (const FOmniCaptureSegmentRecord& Segment : CompletedSegments)
+    if (ActiveSettings.bOpenPreviewOnFinalize && !LastFinalizedOutput.IsEmpty())
     {
-        if (!OutputMuxer)
+        FPlatformProcess::LaunchFileInDefaultExternalApplication(*LastFinalizedOutput);
+    }
+
+    CompletedSegments.Empty();
+    CapturedFrameMetadata.Reset();
+    RecordedAudioPath.Reset();
+    RecordedVideoPath.Reset();
+    OutputMuxer.Reset();
+    RecordedSegmentDroppedFrames = 0;
+}
+
+void UOmniCaptureSubsystem::QueueCompletedSegmentMuxes()
+{
+    if (CompletedSegments.Num() == 0)
+    {
+        return;
+    }
+
+    for (FOmniCaptureSegmentRecord& Segment : CompletedSegments)
+    {
+        TSharedPtr<FOmniCaptureSegmentMuxJob, ESPMode::ThreadSafe> Job = MakeShared<FOmniCaptureSegmentMuxJob, ESPMode::ThreadSafe>();
+        Job->Settings = ActiveSettings;
+        Job->Settings.OutputDirectory = Segment.Directory;
+        Job->Settings.OutputFileName = Segment.BaseFileName;
+        Job->bMuxingExpected = Job->Settings.OutputFormat != EOmniOutputFormat::ImageSequence || FOmniCaptureMuxer::ShouldStreamLive(Job->Settings);
+        Job->Status.SegmentIndex = Segment.SegmentIndex;
+        Job->Status.FrameCount = Segment.Frames.Num();
+
+        // Each job gets its own muxer; a live encode of the segment moves over from the capture's muxer.
+        Job->Muxer = MakeUnique<FOmniCaptureMuxer>();
+        Job->Muxer->Initialize(Job->Settings, Segment.Directory);
+        if (OutputMuxer)
         {
-            break;
+            OutputMuxer->HandOverLiveStream(*Job->Muxer);
         }
+        Job->Segment = MoveTemp(Segment);
 
-        FOmniCaptureSettings SegmentSettings = ActiveSettings;
-        SegmentSettings.OutputDirectory = Segment.Directory;
-        SegmentSettings.OutputFileName = Segment.BaseFileName;
+        SegmentMuxes.Submit(Job);
+    }
+
+    CompletedSegments.Empty();
+}
 
-        OutputMuxer->Initialize(SegmentSettings, Segment.Directory);
-        OutputMuxer->BeginRealtimeSession(SegmentSettings);
+bool UOmniCaptureSubsystem::MuxSegment(FOmniCaptureSegmentMuxJob& Job, FString& OutOutputPath)
+{
+    const FOmniCaptureSegmentRecord& Segment = Job.Segment;
+    const bool bMuxed = Job.Muxer->FinalizeCapture(Job.Settings, Segment.Frames, Segment.AudioPath, Segment.VideoPath, Segment.DroppedFrames);
 
-        const bool bMuxingExpected = SegmentSettings.OutputFormat != EOmniOutputFormat::ImageSequence;
-        const bool bFallbackFromNVENC = (OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware && SegmentSettings.OutputFormat == EOmniOutputFormat::ImageSequence);
-        const bool bSuccess = OutputMuxer->FinalizeCapture(SegmentSettings, Segment.Frames, Segment.AudioPath, Segment.VideoPath, Segment.DroppedFrames);
-        OutputMuxer->EndRealtimeSession();
+    const FString FinalVideoPath = Segment.Directory / (Segment.BaseFileName + TEXT(".mp4"));
+    if (!bMuxed || (Job.bMuxingExpected && !FPaths::FileExists(FinalVideoPath)))
+    {
+        return false;
+    }
 
-        const FString FinalVideoPath = Segment.Directory / (Segment.BaseFileName + TEXT(".mp4"));
-        const bool bFinalFileExists = bMuxingExpected ? FPaths::FileExists(FinalVideoPath) : true;
+    if (Job.bMuxingExpected)
+    {
+        OutOutputPath = FinalVideoPath;
+    }
+    return true;
+}
 
-        if (!bSuccess || (bMuxingExpected && !bFinalFileExists))
+void UOmniCaptureSubsystem::ReportFinishedSegmentMuxes()
+{
+    // Reported in segment order, so LastFinalizedOutput ends up naming the last segment.
+    SegmentMuxes.ReportFinished([this](const FOmniCaptureSegmentMuxJob& Job)
+    {
+        ReportSegmentMux(Job);
+    });
+}
+
+void UOmniCaptureSubsystem::ReportSegmentMux(const FOmniCaptureSegmentMuxJob& Job)
+{
+    const FOmniCaptureSegmentRecord& Segment = Job.Segment;
+    const FOmniCaptureSettings& SegmentSettings = Job.Settings;
+    const bool bFallbackFromNVENC = (OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware && SegmentSettings.OutputFormat == EOmniOutputFormat::ImageSequence);
+    // Live segments only write images once their encode has failed.
+    const bool bFallbackFromLiveStream = FOmniCaptureMuxer::ShouldStreamLive(SegmentSettings) && Segment.bHasImageSequence;
+
+    if (!Job.bSucceeded)
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Output muxing failed for segment %d. Check OmniCapture manifest for details."), Segment.SegmentIndex));
+        if (Segment.bHasImageSequence)
         {
-            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Output muxing failed for segment %d. Check OmniCapture manifest for details."), Segment.SegmentIndex));
-            if (Segment.bHasImageSequence)
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
+            if (LastImageSequenceFallbackDirectory.IsEmpty())
             {
-                LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
-                if (LastImageSequenceFallbackDirectory.IsEmpty())
-                {
-                    LastImageSequenceFallbackDirectory = Segment.Directory;
-                }
-                if (OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
-                {
-                    bLastCaptureUsedImageSequenceFallback = true;
-                }
+                LastImageSequenceFallbackDirectory = Segment.Directory;
             }
-            else
+            if (OriginalSettings.OutputFormat == EOmniOutputFormat::NVENCHardware || bFallbackFromLiveStream)
             {
-                LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("No image sequence fallback was recorded for this segment."));
+                bLastCaptureUsedImageSequenceFallback = true;
             }
         }
-        else if (Segment.bHasImageSequence)
+        else
+        {
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), TEXT("No image sequence fallback was recorded for this segment."));
+        }
+    }
+    else if (Segment.bHasImageSequence)
+    {
+        if (!Job.bMuxingExpected)
         {
-            if (!bMuxingExpected)
+            const ELogVerbosity::Type Verbosity = bFallbackFromNVENC ? ELogVerbosity::Warning : ELogVerbosity::Log;
+            LogDiagnosticMessage(Verbosity, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
+            if (LastImageSequenceFallbackDirectory.IsEmpty())
             {
-                const ELogVerbosity::Type Verbosity = bFallbackFromNVENC ? ELogVerbosity::Warning : ELogVerbosity::Log;
-                LogDiagnosticMessage(Verbosity, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Image sequence frames saved to %s with base name %s."), *Segment.Directory, *Segment.BaseFileName));
-                if (LastImageSequenceFallbackDirectory.IsEmpty())
-                {
-                    LastImageSequenceFallbackDirectory = Segment.Directory;
-                }
-                if (bFallbackFromNVENC)
-                {
-                    bLastCaptureUsedImageSequenceFallback = true;
-                }
+                LastImageSequenceFallbackDirectory = Segment.Directory;
             }
-            else if (SegmentSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+            if (bFallbackFromNVENC)
             {
-                AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Image sequence fallback saved alongside NVENC output in %s."), *Segment.Directory), TEXT("FinalizeOutputs"));
+                bLastCaptureUsedImageSequenceFallback = true;
             }
         }
-
-        LastFinalizedOutput = (bSuccess && bMuxingExpected && bFinalFileExists) ? FinalVideoPath : FString();
-        if (!LastFinalizedOutput.IsEmpty())
+        else if (SegmentSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
         {
-            AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Muxed output ready: %s"), *LastFinalizedOutput), TEXT("FinalizeOutputs"));
+            AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Image sequence fallback saved alongside NVENC output in %s."), *Segment.Directory), TEXT("FinalizeOutputs"));
         }
-
-        if (SegmentSettings.bOpenPreviewOnFinalize && !LastFinalizedOutput.IsEmpty())
+        else if (bFallbackFromLiveStream)
         {
-            FPlatformProcess::LaunchFileInDefaultExternalApplication(*LastFinalizedOutput);
+            LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("FinalizeOutputs"), FString::Printf(TEXT("Live FFmpeg encode failed; the image sequence written in its place is in %s."), *Segment.Directory));
+            if (LastImageSequenceFallbackDirectory.IsEmpty())
+            {
+                LastImageSequenceFallbackDirectory = Segment.Directory;
+            }
+            bLastCaptureUsedImageSequenceFallback = true;
         }
     }
 
-    CompletedSegments.Empty();
-    CapturedFrameMetadata.Reset();
-    RecordedAudioPath.Reset();
-    RecordedVideoPath.Reset();
-    OutputMuxer.Reset();
-    RecordedSegmentDroppedFrames = 0;
+    LastFinalizedOutput = Job.Status.OutputPath;
+    if (!LastFinalizedOutput.IsEmpty())
+    {
+        AppendDiagnostic(EOmniCaptureDiagnosticLevel::Info, FString::Printf(TEXT("Muxed output ready: %s (segment %d, %.1fs)"), *LastFinalizedOutput, Segment.SegmentIndex, Job.Status.MuxSeconds), TEXT("FinalizeOutputs"));
+    }
 }
 
 bool UOmniCaptureSubsystem::ValidateEnvironment()
@@ -1413,7 +1563,16 @@ bool UOmniCaptureSubsystem::ValidateEnvironment()
     FString ResolvedFFmpeg;
     if (!FOmniCaptureMuxer::IsFFmpegAvailable(ActiveSettings, &ResolvedFFmpeg))
     {
-        AddWarningUnique(TEXT("FFmpeg not detected - automatic muxing disabled"));
+        // NVENC output written straight to MP4 needs no FFmpeg pass.
+        if (ActiveSettings.OutputFormat != EOmniOutputFormat::NVENCHardware || !ActiveSettings.bNativeMP4Mux)
+        {
+            AddWarningUnique(TEXT("FFmpeg not detected - automatic muxing disabled"));
+        }
+        if (ActiveSettings.bStreamToFFmpeg)
+        {
+            AddWarningUnique(TEXT("FFmpeg not detected - frames will be written as images instead of streamed"));
+            ActiveSettings.bStreamToFFmpeg = false;
+        }
     }
     else if (!ResolvedFFmpeg.IsEmpty() && !ResolvedFFmpeg.Equals(TEXT("ffmpeg"), ESearchCase::IgnoreCase))
     {
@@ -1567,7 +1726,7 @@ void UOmniCaptureSubsystem::ShutdownAudioRecording()
         return;
     }
 
-    AudioRecorder->Stop(ActiveSettings.OutputDirectory, ActiveSettings.OutputFileName);
+    AudioRecorder->Stop();
     RecordedAudioPath = AudioRecorder->GetOutputFilePath();
     if (!RecordedAudioPath.IsEmpty())
     {
@@ -1590,6 +1749,9 @@ void UOmniCaptureSubsystem::TickCapture(float DeltaTime)
         CaptureFrame();
     }
 
+    // Frames keep leaving the readback queue while paused; they still belong in the ring buffer.
+    EnqueueResolvedFrames();
+    ReportFinishedSegmentMuxes();
     UpdateRuntimeWarnings();
 }
 
@@ -1605,69 +1767,35 @@ void UOmniCaptureSubsystem::CaptureFrame()
     FOmniEyeCapture RightEye;
     RigActor->Capture(LeftEye, RightEye);
 
-    FlushRenderingCommands();
-
-    auto ConvertActiveFrame = [](const FOmniCaptureSettings& CaptureSettings, const FOmniEyeCapture& Left, const FOmniEyeCapture& Right)
+    // With pipelined readback the GPU conversion runs behind the scene captures when the render thread reaches the
+    // frame's readback request, and its copy is collected frames later, so nothing here waits for the render thread.
+    const bool bPipelinedReadback = ReadbackQueue.IsValid();
+    if (!bPipelinedReadback)
     {
-        if (CaptureSettings.IsPlanar())
-        {
-            return FOmniCaptureEquirectConverter::ConvertToPlanar(CaptureSettings, Left);
-        }
-
-        if (CaptureSettings.IsFisheye() && !CaptureSettings.ShouldConvertFisheyeToEquirect())
-        {
-            return FOmniCaptureEquirectConverter::ConvertToFisheye(CaptureSettings, Left, Right);
-        }
-
-        return FOmniCaptureEquirectConverter::ConvertToEquirectangular(CaptureSettings, Left, Right);
-    };
+        FlushRenderingCommands();
+    }
 
-    FOmniCaptureEquirectResult ConversionResult = ConvertActiveFrame(ActiveSettings, LeftEye, RightEye);
+    FOmniCaptureEquirectResult ConversionResult = FOmniCaptureEquirectConverter::ConvertLayers(ActiveSettings, LeftEye, RightEye, ActiveSettings.AuxiliaryPasses, bPipelinedReadback ? EOmniCaptureReadbackMode::Deferred : EOmniCaptureReadbackMode::Blocking);
+    if (ConversionResult.bUsedCPUFallback)
+    {
+        LogDiagnosticMessage(ELogVerbosity::Verbose, TEXT("CaptureLoop"), FString::Printf(TEXT("CPU fallback conversion for frame %d took %.2f ms (%dx%d)"), FrameCounter, ConversionResult.ConversionMilliseconds, ConversionResult.Size.X, ConversionResult.Size.Y));
+    }
 
     TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers;
-    if (ActiveSettings.AuxiliaryPasses.Num() > 0)
+    for (TPair<EOmniCaptureAuxiliaryPassType, FOmniCaptureLayerPayload>& Layer : ConversionResult.AuxiliaryLayers)
     {
-        auto BuildAuxiliaryEye = [](const FOmniEyeCapture& SourceEye, EOmniCaptureAuxiliaryPassType PassType)
-        {
-            FOmniEyeCapture AuxEye;
-            AuxEye.ActiveFaceCount = SourceEye.ActiveFaceCount;
-            for (int32 FaceIndex = 0; FaceIndex < AuxEye.ActiveFaceCount && FaceIndex < UE_ARRAY_COUNT(AuxEye.Faces); ++FaceIndex)
-            {
-                AuxEye.Faces[FaceIndex].RenderTarget = SourceEye.Faces[FaceIndex].GetAuxiliaryRenderTarget(PassType);
-            }
-            return AuxEye;
-        };
-
-        for (EOmniCaptureAuxiliaryPassType PassType : ActiveSettings.AuxiliaryPasses)
-        {
-            if (PassType == EOmniCaptureAuxiliaryPassType::None)
-            {
-                continue;
-            }
-
-            const FOmniEyeCapture AuxLeft = BuildAuxiliaryEye(LeftEye, PassType);
-            const FOmniEyeCapture AuxRight = BuildAuxiliaryEye(RightEye, PassType);
-            FOmniCaptureEquirectResult AuxResult = ConvertActiveFrame(ActiveSettings, AuxLeft, AuxRight);
-            if (AuxResult.PixelData.IsValid())
-            {
-                FOmniCaptureLayerPayload Payload;
-                Payload.PixelData = MoveTemp(AuxResult.PixelData);
-                Payload.bLinear = AuxResult.bIsLinear;
-                Payload.Precision = AuxResult.PixelPrecision;
-                Payload.PixelDataType = AuxResult.PixelDataType;
-                AuxiliaryLayers.Add(GetAuxiliaryLayerName(PassType), MoveTemp(Payload));
-            }
-        }
+        AuxiliaryLayers.Add(GetAuxiliaryLayerName(Layer.Key), MoveTemp(Layer.Value));
     }
     const bool bRequiresGPU = ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware;
     const bool bRequiresPixelData = (ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence) || ImageWriter.IsValid();
-    if (bRequiresPixelData && !ConversionResult.PixelData.IsValid())
+    const bool bConversionPending = static_cast<bool>(ConversionResult.DeferredConversion);
+    if (bRequiresPixelData && !ConversionResult.PixelData.IsValid() && !bConversionPending)
     {
         HandleDroppedFrame();
         return;
     }
 
-    if (bRequiresGPU && !ConversionResult.Texture.IsValid())
+    if (bRequiresGPU && !ConversionResult.Texture.IsValid() && !bConversionPending)
     {
         HandleDroppedFrame();
         return;
@@ -1694,68 +1822,177 @@ void UOmniCaptureSubsystem::CaptureFrame()
     }
 
     Frame->PixelData = MoveTemp(ConversionResult.PixelData);
-    Frame->GPUSource = ConversionResult.OutputTarget;
-    Frame->Texture = ConversionResult.Texture;
-    Frame->ReadyFence = ConversionResult.ReadyFence;
     Frame->bLinearColor = ConversionResult.bIsLinear;
     Frame->bUsedCPUFallback = ConversionResult.bUsedCPUFallback;
     Frame->PixelDataType = ConversionResult.PixelDataType;
     Frame->PixelPrecision = ConversionResult.PixelPrecision;
-    Frame->EncoderTextures.Reset();
     Frame->AuxiliaryLayers = MoveTemp(AuxiliaryLayers);
-    for (const TRefCountPtr<IPooledRenderTarget>& Plane : ConversionResult.EncoderPlanes)
+    AttachGPUOutputs(ConversionResult, *Frame);
+
+    if (AudioRecorder)
     {
-        if (!Plane.IsValid())
+        AudioRecorder->GatherAudio(Frame->Metadata.Timecode, Frame->AudioPackets);
+    }
+
+    CapturedFrameMetadata.Add(Frame->Metadata);
+
+    const bool bWritesImages = ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence && !FOmniCaptureMuxer::ShouldStreamLive(ActiveSettings);
+    if (ImageWriter && (bWritesImages || bUsingNVENCImageFallback.Load()))
+    {
+        bCapturedImageSequenceThisSegment = true;
+    }
+
+    bool bPreviewDue = false;
+    if (PreviewActor.IsValid() && PreviewActor->IsPreviewEnabled())
+    {
+        const double Now = FPlatformTime::Seconds();
+        if (PreviewFrameInterval <= 0.0 || (Now - LastPreviewUpdateTime) >= PreviewFrameInterval)
         {
-            continue;
+            bPreviewDue = true;
+            LastPreviewUpdateTime = Now;
         }
+    }
 
-        if (FRHITexture* PlaneTexture = Plane->GetRHI())
+    if (bPipelinedReadback)
+    {
+        // Every frame goes through the queue, even ones converted on the CPU, so frames reach the ring buffer in order.
+        FOmniCaptureReadbackRequest Request;
+        Request.Frame = MoveTemp(Frame);
+        Request.bWantsPreview = bPreviewDue;
+        if (bConversionPending)
         {
-            Frame->EncoderTextures.Add(PlaneTexture);
+            Request.Issue = [Convert = MoveTemp(ConversionResult.DeferredConversion)](FOmniCaptureReadbackRequest& IssuedRequest)
+            {
+                FOmniCaptureEquirectResult Result;
+                Convert(Result);
+                if (!Result.OutputTarget.IsValid())
+                {
+                    return;
+                }
+
+                FOmniCaptureFrame& IssuedFrame = *IssuedRequest.Frame;
+                AttachGPUOutputs(Result, IssuedFrame);
+                IssuedFrame.bLinearColor = Result.bIsLinear;
+                IssuedFrame.PixelPrecision = Result.PixelPrecision;
+                IssuedRequest.Readback = MoveTemp(Result.PendingReadback);
+                IssuedRequest.Size = Result.Size;
+                IssuedRequest.Precision = Result.PixelPrecision;
+                IssuedRequest.bLinear = Result.bIsLinear;
+                for (TPair<EOmniCaptureAuxiliaryPassType, FOmniCaptureLayerReadback>& Layer : Result.PendingLayerReadbacks)
+                {
+                    IssuedRequest.LayerReadbacks.Add(GetAuxiliaryLayerName(Layer.Key), MoveTemp(Layer.Value));
+                }
+            };
         }
+
+        FOmniCaptureReadbackQueue::EnqueueOnRenderThread(ReadbackQueue, MoveTemp(Request));
+
+        LatestReadbackStats = ReadbackQueue->GetStats();
     }
-    if (Frame->EncoderTextures.Num() == 0 && Frame->Texture.IsValid())
+    else
     {
-        Frame->EncoderTextures.Add(Frame->Texture);
-    }
+        bool bPreviewBuilt = false;
+        if (bPreviewDue && Frame->PixelData.IsValid())
+        {
+            const FIntRect ViewRect = FOmniCapturePreviewImage::GetViewRect(Frame->PixelData->GetSize(), ActiveSettings, ActiveSettings.PreviewVisualization);
+            bPreviewBuilt = GamePreview.Build(*Frame->PixelData, Frame->PixelDataType, ViewRect, ActiveSettings.PreviewMaxEdge);
+        }
 
-    if (AudioRecorder)
-    {
-        AudioRecorder->GatherAudio(Frame->Metadata.Timecode, Frame->AudioPackets);
-    }
+        RingBuffer->Enqueue(MoveTemp(Frame));
 
-    CapturedFrameMetadata.Add(Frame->Metadata);
+        if (bPreviewBuilt)
+        {
+            PreviewActor->UpdatePreviewTexture(GamePreview);
+        }
+    }
 
-    if (ImageWriter && (ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence || bUsingNVENCImageFallback.Load()))
+    UpdateRingBufferStats();
+    LatestFramePoolStats = FOmniCaptureFramePool::Get().GetStats();
+    if (ImageWriter)
     {
-        bCapturedImageSequenceThisSegment = true;
+        LatestWriterPoolStats = ImageWriter->GetWriterPoolStats();
     }
 
-    RingBuffer->Enqueue(MoveTemp(Frame));
+    ApplyResolvedPreview();
+}
+
+void UOmniCaptureSubsystem::FlushRingBuffer()
+{
+    // Frames still waiting on their readback have to reach the ring buffer before it is drained.
+    FlushReadbackQueue();
+    EnqueueResolvedFrames();
 
     if (RingBuffer)
     {
-        LatestRingBufferStats = RingBuffer->GetStats();
+        RingBuffer->Flush();
+        UpdateRingBufferStats();
     }
+}
 
-    if (PreviewActor.IsValid())
+void UOmniCaptureSubsystem::EnqueueResolvedFrames()
+{
+    TUniquePtr<FOmniCaptureFrame> Frame;
+    while (ResolvedFrames.Dequeue(Frame))
     {
-        const double Now = FPlatformTime::Seconds();
-        if (PreviewFrameInterval <= 0.0 || (Now - LastPreviewUpdateTime) >= PreviewFrameInterval)
+        if (RingBuffer)
         {
-            PreviewActor->UpdatePreviewTexture(ConversionResult, ActiveSettings);
-            LastPreviewUpdateTime = Now;
+            RingBuffer->Enqueue(MoveTemp(Frame));
         }
+        Frame.Reset();
     }
 }
 
-void UOmniCaptureSubsystem::FlushRingBuffer()
+void UOmniCaptureSubsystem::UpdateRingBufferStats()
 {
-    if (RingBuffer)
+    if (!RingBuffer)
     {
-        RingBuffer->Flush();
+        return;
     }
+
+    // Sinks drop frames on their own threads; the capture only learns of it here, so its state stays on the game thread.
+    LatestRingBufferStats = RingBuffer->GetStats();
+    if (LatestRingBufferStats.DroppedFrames > ReportedRingBufferDrops)
+    {
+        HandleDroppedFrame(LatestRingBufferStats.DroppedFrames - ReportedRingBufferDrops);
+        ReportedRingBufferDrops = LatestRingBufferStats.DroppedFrames;
+    }
+}
+
+void UOmniCaptureSubsystem::FlushReadbackQueue()
+{
+    if (!ReadbackQueue.IsValid())
+    {
+        return;
+    }
+
+    ENQUEUE_RENDER_COMMAND(OmniCaptureDrainReadbacks)([Queue = ReadbackQueue](FRHICommandListImmediate&)
+    {
+        Queue->Drain();
+    });
+    FlushRenderingCommands();
+
+    LatestReadbackStats = ReadbackQueue->GetStats();
+}
+
+void UOmniCaptureSubsystem::ApplyResolvedPreview()
+{
+    if (!PreviewActor.IsValid())
+    {
+        return;
+    }
+
+    {
+        FScopeLock Lock(&ResolvedPreviewCriticalSection);
+        if (!ResolvedPreview.IsValid())
+        {
+            return;
+        }
+
+        Swap(GamePreview, ResolvedPreview);
+        ResolvedPreview.Reset();
+    }
+
+    PreviewActor->UpdatePreviewTexture(GamePreview);
 }
 
 void UOmniCaptureSubsystem::UpdateDynamicStereoParameters()
@@ -2025,11 +2262,11 @@ void UOmniCaptureSubsystem::RestoreRenderFeatureOverrides()
     LastDynamicConvergence = -1.0f;
 }
 
-void UOmniCaptureSubsystem::HandleDroppedFrame()
+void UOmniCaptureSubsystem::HandleDroppedFrame(int32 Count)
 {
     bDroppedFrames = true;
     State = EOmniCaptureState::DroppedFrames;
-    ++DroppedFrameCount;
+    DroppedFrameCount += Count;
     AddWarningUnique(OmniCapture::WarningFrameDrop);
     LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("CaptureLoop"), TEXT("OmniCapture frame dropped"));
 }
@@ -2057,7 +2294,6 @@ void UOmniCaptureSubsystem::ConfigureActiveSegment()
     bCapturedImageSequenceThisSegment = false;
 
     CurrentSegmentStartTime = FPlatformTime::Seconds();
-    LastSegmentSizeCheckTime = CurrentSegmentStartTime;
 }
 
 void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
@@ -2089,15 +2325,10 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
 
     if (!bShouldRotate && ActiveSettings.SegmentSizeLimitMB > 0)
     {
-        if ((Now - LastSegmentSizeCheckTime) >= 1.0)
+        const int64 LimitBytes = static_cast<int64>(ActiveSettings.SegmentSizeLimitMB) * 1024 * 1024;
+        if (CalculateActiveSegmentSizeBytes() >= LimitBytes)
         {
-            LastSegmentSizeCheckTime = Now;
-            const int64 SegmentBytes = CalculateActiveSegmentSizeBytes();
-            const int64 LimitBytes = static_cast<int64>(ActiveSettings.SegmentSizeLimitMB) * 1024 * 1024;
-            if (LimitBytes > 0 && SegmentBytes >= LimitBytes)
-            {
-                bShouldRotate = true;
-            }
+            bShouldRotate = true;
         }
     }
 
@@ -2108,10 +2339,7 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
 
     LogDiagnosticMessage(ELogVerbosity::Log, TEXT("SegmentRotation"), FString::Printf(TEXT("Rotating capture segment -> %d"), CurrentSegmentIndex + 1));
 
-    if (RingBuffer)
-    {
-        RingBuffer->Flush();
-    }
+    FlushRingBuffer();
 
     if (OutputMuxer)
     {
@@ -2139,10 +2367,12 @@ void UOmniCaptureSubsystem::RotateSegmentIfNeeded()
         AudioStats = FOmniAudioSyncStats();
     }
 
+    // The finished segment's files are closed; mux it while the capture carries on.
+    QueueCompletedSegmentMuxes();
+
     InitializeAudioRecording();
 
     CurrentSegmentStartTime = FPlatformTime::Seconds();
-    LastSegmentSizeCheckTime = CurrentSegmentStartTime;
     LastFpsSampleTime = 0.0;
     FramesSinceLastFpsSample = 0;
 }
@@ -2178,7 +2408,12 @@ void UOmniCaptureSubsystem::CompleteActiveSegment(bool bStoreResults)
     SegmentRecord.DroppedFrames = SegmentDroppedFrames;
     RecordedSegmentDroppedFrames = TotalDroppedFrames;
     SegmentRecord.Frames = MoveTemp(CapturedFrameMetadata);
-    SegmentRecord.bHasImageSequence = bCapturedImageSequenceThisSegment || ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence;
+    if (OutputMuxer && OutputMuxer->HasLiveStreamFailed())
+    {
+        LogDiagnosticMessage(ELogVerbosity::Warning, TEXT("SegmentRotation"), FString::Printf(TEXT("Live FFmpeg encode of segment %d failed; the frames it missed were written as an image sequence."), CurrentSegmentIndex));
+        bCapturedImageSequenceThisSegment = true;
+    }
+    SegmentRecord.bHasImageSequence = bCapturedImageSequenceThisSegment || (ActiveSettings.OutputFormat == EOmniOutputFormat::ImageSequence && !FOmniCaptureMuxer::ShouldStreamLive(ActiveSettings));
 
     CompletedSegments.Add(MoveTemp(SegmentRecord));
 
@@ -2190,62 +2425,23 @@ void UOmniCaptureSubsystem::CompleteActiveSegment(bool bStoreResults)
 
 int64 UOmniCaptureSubsystem::CalculateActiveSegmentSizeBytes() const
 {
+    // The writers count their output as they go, so this stays O(1) however many images the segment holds.
     int64 TotalBytes = 0;
-    IFileManager& FileManager = IFileManager::Get();
-
-    if (ActiveSettings.OutputFormat == EOmniOutputFormat::NVENCHardware)
+    if (NVENCEncoder)
     {
-        if (!RecordedVideoPath.IsEmpty())
-        {
-            const int64 BitstreamSize = FileManager.FileSize(*RecordedVideoPath);
-            if (BitstreamSize > 0)
-            {
-                TotalBytes += BitstreamSize;
-            }
-        }
+        TotalBytes += NVENCEncoder->GetBytesWritten();
     }
-    else
+    if (ImageWriter)
     {
-        class FSegmentStatVisitor final : public IPlatformFile::FDirectoryStatVisitor
-        {
-        public:
-            FSegmentStatVisitor(const FString& InPrefix, int64& InTotal)
-                : Prefix(InPrefix)
-                , Total(InTotal)
-            {
-            }
-
-            virtual bool Visit(const TCHAR* FilenameOrDirectory, const FFileStatData& StatData) override
-            {
-                if (StatData.bIsDirectory)
-                {
-                    return true;
-                }
-
-                const FString FileName = FPaths::GetCleanFilename(FilenameOrDirectory);
-                if (Prefix.IsEmpty() || FileName.StartsWith(Prefix))
-                {
-                    Total += StatData.FileSize;
-                }
-                return true;
-            }
-
-        private:
-            FString Prefix;
-            int64& Total;
-        };
-
-        FSegmentStatVisitor Visitor(ActiveSettings.OutputFileName, TotalBytes);
-        FileManager.IterateDirectoryStat(*ActiveSettings.OutputDirectory, Visitor);
+        TotalBytes += ImageWriter->GetBytesWritten();
     }
-
-    if (!RecordedAudioPath.IsEmpty())
+    if (OutputMuxer)
     {
-        const int64 AudioSize = FileManager.FileSize(*RecordedAudioPath);
-        if (AudioSize > 0)
-        {
-            TotalBytes += AudioSize;
-        }
+        TotalBytes += OutputMuxer->GetLiveOutputBytes();
+    }
+    if (AudioRecorder)
+    {
+        TotalBytes += AudioRecorder->GetBytesWritten();
     }
 
     return TotalBytes;
@@ -392,6 +392,8 @@ FString FOmniCaptureSettings::GetImageFileExtension() const
         return TEXT(".exr");
     case EOmniCaptureImageFormat::BMP:
         return TEXT(".bmp");
+    case EOmniCaptureImageFormat::Raw:
+        return TEXT(".omniraw");
     case EOmniCaptureImageFormat::PNG:
     default:
         return TEXT(".png");
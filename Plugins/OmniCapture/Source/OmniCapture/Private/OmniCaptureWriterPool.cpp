@@ -0,0 +1,295 @@
+#include "OmniCaptureWriterPool.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformAffinity.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogOmniCaptureWriterPool, Log, All);
+
+class FOmniCaptureWriterPool::FWorker final : public FRunnable
+{
+public:
+    FWorker(FOmniCaptureWriterPool& InPool, int32 Index, uint64 AffinityMask, EThreadPriority Priority)
+        : Pool(InPool)
+    {
+        Thread.Reset(FRunnableThread::Create(this, *FString::Printf(TEXT("OmniCapture%s_%d"), *Pool.Name.ToString(), Index), 0, Priority, AffinityMask));
+    }
+
+    virtual ~FWorker() override
+    {
+        if (Thread.IsValid())
+        {
+            Thread->WaitForCompletion();
+            Thread.Reset();
+        }
+    }
+
+    virtual uint32 Run() override
+    {
+        Pool.RunWorker();
+        return 0;
+    }
+
+    bool HasThread() const
+    {
+        return Thread.IsValid();
+    }
+
+private:
+    FOmniCaptureWriterPool& Pool;
+    TUniquePtr<FRunnableThread> Thread;
+};
+
+FOmniCaptureWriterPool::FOmniCaptureWriterPool(FName InName, int32 InWorkerCount, uint64 InAffinityMask, EThreadPriority InPriority, int64 InMaxBytesInFlight)
+    : Name(InName)
+    , MaxBytesInFlight(InMaxBytesInFlight)
+{
+    WorkEvent = FPlatformProcess::GetSynchEventFromPool();
+    SpaceEvent = FPlatformProcess::GetSynchEventFromPool();
+    IdleEvent = FPlatformProcess::GetSynchEventFromPool();
+
+    const uint64 AffinityMask = InAffinityMask != 0 ? InAffinityMask : FPlatformAffinity::GetNoAffinityMask();
+    for (int32 Index = 0; Index < FMath::Max(1, InWorkerCount); ++Index)
+    {
+        TUniquePtr<FWorker> Worker = MakeUnique<FWorker>(*this, Index, AffinityMask, InPriority);
+        if (Worker->HasThread())
+        {
+            Workers.Add(MoveTemp(Worker));
+        }
+    }
+}
+
+FOmniCaptureWriterPool::~FOmniCaptureWriterPool()
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        bRunning = false;
+    }
+
+    // Workers finish the queue before they exit; each passes the wake-up on to the next.
+    WorkEvent->Trigger();
+    Workers.Reset();
+
+    FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+    WorkEvent = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(SpaceEvent);
+    SpaceEvent = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(IdleEvent);
+    IdleEvent = nullptr;
+}
+
+void FOmniCaptureWriterPool::Submit(FTask&& Task, int64 Bytes)
+{
+    const uint64 SubmitStartCycles = FPlatformTime::Cycles64();
+    bool bThrottled = false;
+    bool bWakeNextProducer = false;
+
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&CriticalSection);
+            const bool bFits = BytesInFlight == 0 || MaxBytesInFlight <= 0 || BytesInFlight + Bytes <= MaxBytesInFlight;
+            if (bFits)
+            {
+                const uint64 NowCycles = FPlatformTime::Cycles64();
+                if (bThrottled)
+                {
+                    --WaitingProducers;
+                    ++Stats.ThrottledSubmits;
+                    AdmissionCycles += NowCycles - SubmitStartCycles;
+                    bWakeNextProducer = WaitingProducers > 0;
+                }
+
+                BytesInFlight += Bytes;
+                Stats.PeakBytesInFlight = FMath::Max(Stats.PeakBytesInFlight, BytesInFlight);
+
+                FQueuedTask& Queued = Queue.AddDefaulted_GetRef();
+                Queued.Task = MoveTemp(Task);
+                Queued.Bytes = Bytes;
+                Queued.SubmitCycles = NowCycles;
+                break;
+            }
+
+            if (!bThrottled)
+            {
+                bThrottled = true;
+                ++WaitingProducers;
+            }
+        }
+
+        SpaceEvent->Wait();
+    }
+
+    // Auto-reset events coalesce; another producer may fit in what is left of the budget.
+    if (bWakeNextProducer)
+    {
+        SpaceEvent->Trigger();
+    }
+
+    if (Workers.Num() == 0)
+    {
+        // No threads on this platform: write on the caller, as the engine's task system would.
+        FQueuedTask Inline;
+        if (TryTakeTask(Inline))
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            const bool bSucceeded = Inline.Task();
+            CompleteTask(Inline, bSucceeded, StartCycles);
+        }
+        return;
+    }
+
+    WorkEvent->Trigger();
+}
+
+void FOmniCaptureWriterPool::WaitUntilIdle()
+{
+    for (;;)
+    {
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (NumQueued() == 0 && ActiveTasks == 0)
+            {
+                return;
+            }
+        }
+
+        IdleEvent->Wait();
+    }
+}
+
+void FOmniCaptureWriterPool::SetMaxBytesInFlight(int64 InMaxBytesInFlight)
+{
+    {
+        FScopeLock Lock(&CriticalSection);
+        MaxBytesInFlight = InMaxBytesInFlight;
+    }
+    SpaceEvent->Trigger();
+}
+
+int64 FOmniCaptureWriterPool::GetMaxBytesInFlight() const
+{
+    FScopeLock Lock(&CriticalSection);
+    return MaxBytesInFlight;
+}
+
+FOmniCaptureWriterPoolStats FOmniCaptureWriterPool::GetStats() const
+{
+    FScopeLock Lock(&CriticalSection);
+    FOmniCaptureWriterPoolStats Result = Stats;
+    Result.WorkerCount = Workers.Num();
+    Result.QueueDepth = NumQueued();
+    Result.ActiveTasks = ActiveTasks;
+    Result.BytesInFlight = BytesInFlight;
+    Result.MaxBytesInFlight = MaxBytesInFlight;
+
+    const int32 StartedTasks = Stats.CompletedTasks + ActiveTasks;
+    Result.AverageAdmissionWaitMilliseconds = Stats.ThrottledSubmits > 0 ? FPlatformTime::ToMilliseconds64(AdmissionCycles) / Stats.ThrottledSubmits : 0.0;
+    Result.AverageQueueMilliseconds = StartedTasks > 0 ? FPlatformTime::ToMilliseconds64(QueueCycles) / StartedTasks : 0.0;
+    Result.AverageTaskMilliseconds = Stats.CompletedTasks > 0 ? FPlatformTime::ToMilliseconds64(TaskCycles) / Stats.CompletedTasks : 0.0;
+    return Result;
+}
+
+void FOmniCaptureWriterPool::RunWorker()
+{
+    for (;;)
+    {
+        FQueuedTask Task;
+        if (TryTakeTask(Task))
+        {
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            const bool bSucceeded = Task.Task();
+            // Release the payload before the bytes are returned to the budget.
+            Task.Task.Reset();
+            CompleteTask(Task, bSucceeded, StartCycles);
+            continue;
+        }
+
+        {
+            FScopeLock Lock(&CriticalSection);
+            if (!bRunning && NumQueued() == 0)
+            {
+                break;
+            }
+        }
+
+        WorkEvent->Wait();
+    }
+
+    WorkEvent->Trigger();
+}
+
+bool FOmniCaptureWriterPool::TryTakeTask(FQueuedTask& OutTask)
+{
+    bool bMoreQueued = false;
+    {
+        FScopeLock Lock(&CriticalSection);
+        if (NumQueued() == 0)
+        {
+            return false;
+        }
+
+        OutTask = MoveTemp(Queue[QueueHead++]);
+        ++ActiveTasks;
+        QueueCycles += FPlatformTime::Cycles64() - OutTask.SubmitCycles;
+        bMoreQueued = NumQueued() > 0;
+
+        // Drop the taken slots once they make up half the array, so each dequeue costs O(1) amortised.
+        if (!bMoreQueued)
+        {
+            Queue.Reset();
+            QueueHead = 0;
+        }
+        else if (QueueHead * 2 >= Queue.Num())
+        {
+            Queue.RemoveAt(0, QueueHead, EAllowShrinking::No);
+            QueueHead = 0;
+        }
+    }
+
+    // Several submits can collapse into one wake-up; hand the rest to another worker.
+    if (bMoreQueued)
+    {
+        WorkEvent->Trigger();
+    }
+    return true;
+}
+
+void FOmniCaptureWriterPool::CompleteTask(const FQueuedTask& Task, bool bSucceeded, uint64 StartCycles)
+{
+    const uint64 ElapsedCycles = FPlatformTime::Cycles64() - StartCycles;
+    const double ElapsedMilliseconds = FPlatformTime::ToMilliseconds64(ElapsedCycles);
+
+    bool bWakeProducer = false;
+    bool bIdle = false;
+    {
+        FScopeLock Lock(&CriticalSection);
+        --ActiveTasks;
+        BytesInFlight -= Task.Bytes;
+        TaskCycles += ElapsedCycles;
+        ++Stats.CompletedTasks;
+        if (!bSucceeded)
+        {
+            ++Stats.FailedTasks;
+        }
+        Stats.LastTaskMilliseconds = ElapsedMilliseconds;
+        Stats.MaxTaskMilliseconds = FMath::Max(Stats.MaxTaskMilliseconds, ElapsedMilliseconds);
+        bWakeProducer = WaitingProducers > 0;
+        bIdle = NumQueued() == 0 && ActiveTasks == 0;
+    }
+
+    if (!bSucceeded)
+    {
+        UE_LOG(LogOmniCaptureWriterPool, Warning, TEXT("OmniCapture %s task failed"), *Name.ToString());
+    }
+    if (bWakeProducer)
+    {
+        SpaceEvent->Trigger();
+    }
+    if (bIdle)
+    {
+        IdleEvent->Trigger();
+    }
+}
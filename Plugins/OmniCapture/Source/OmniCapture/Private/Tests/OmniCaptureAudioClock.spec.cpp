@@ -0,0 +1,265 @@
+#include "Misc/AutomationTest.h"
+
+#include "Math/RandomStream.h"
+#include "OmniCaptureAudioClock.h"
+
+namespace
+{
+    constexpr int32 ClockTestSampleRate = 48000;
+
+    int16 SyntheticSample(int64 Frame)
+    {
+        return static_cast<int16>(8000.0 * FMath::Sin(2.0 * PI * 440.0 * Frame / ClockTestSampleRate));
+    }
+
+    // A synthetic audio device: it renders SampleRate * (1 + Drift) frames per wall-clock second in fixed blocks,
+    // timestamped on its own sample clock, and each block reaches the game thread after a jittered latency.
+    struct FSyntheticAudioDevice
+    {
+        double Drift = 0.0;
+        int32 BlockFrames = 512;
+        double MaxLatencySeconds = 0.0;
+        int64 RenderedFrames = 0;
+
+        void DeliverUntil(double WallSeconds, FRandomStream& Random, FOmniCaptureAudioClock& Clock)
+        {
+            for (;;)
+            {
+                const double BlockEnd = static_cast<double>(RenderedFrames + BlockFrames) / (ClockTestSampleRate * (1.0 + Drift));
+                if (BlockEnd + Random.FRand() * MaxLatencySeconds > WallSeconds)
+                {
+                    return;
+                }
+
+                FOmniAudioPacket Packet;
+                Packet.Timestamp = static_cast<double>(RenderedFrames) / ClockTestSampleRate;
+                Packet.SampleRate = ClockTestSampleRate;
+                Packet.NumChannels = 1;
+                Packet.PCM16.SetNumUninitialized(BlockFrames);
+                for (int32 Index = 0; Index < BlockFrames; ++Index)
+                {
+                    Packet.PCM16[Index] = SyntheticSample(RenderedFrames + Index);
+                }
+                Clock.AddInput(Packet);
+                RenderedFrames += BlockFrames;
+            }
+        }
+    };
+
+    struct FClockRunResult
+    {
+        bool bContiguous = true;
+        int64 EmittedFrames = 0;
+        double LastVideoTimestamp = 0.0;
+        double MaxLockErrorAfterSettling = 0.0;
+        double MaxCorrectionPPM = 0.0;
+    };
+
+    FClockRunResult RunClock(FOmniCaptureAudioClock& Clock, FSyntheticAudioDevice& Device, double FrameRate, double FrameJitterSeconds, double Seconds, double SettleSeconds)
+    {
+        FRandomStream Random(1234);
+        FClockRunResult Result;
+        double ExpectedTimestamp = -1.0;
+        for (int32 FrameIndex = 0; FrameIndex / FrameRate < Seconds; ++FrameIndex)
+        {
+            const double VideoTimestamp = FrameIndex / FrameRate + (FrameIndex > 0 ? Random.FRandRange(-FrameJitterSeconds, FrameJitterSeconds) : 0.0);
+            Device.DeliverUntil(VideoTimestamp, Random, Clock);
+
+            FOmniAudioPacket Packet;
+            if (Clock.Produce(VideoTimestamp, Packet))
+            {
+                if (ExpectedTimestamp >= 0.0 && !FMath::IsNearlyEqual(Packet.Timestamp, ExpectedTimestamp, 1e-9))
+                {
+                    Result.bContiguous = false;
+                }
+                ExpectedTimestamp = Packet.Timestamp + static_cast<double>(Packet.PCM16.Num()) / ClockTestSampleRate;
+                Result.EmittedFrames += Packet.PCM16.Num();
+            }
+            Result.LastVideoTimestamp = VideoTimestamp;
+
+            const FOmniCaptureAudioClockStats Stats = Clock.GetStats();
+            Result.MaxCorrectionPPM = FMath::Max(Result.MaxCorrectionPPM, FMath::Abs(Stats.CorrectionPPM));
+            if (VideoTimestamp > SettleSeconds)
+            {
+                Result.MaxLockErrorAfterSettling = FMath::Max(Result.MaxLockErrorAfterSettling, FMath::Abs(Stats.LockErrorMilliseconds));
+            }
+        }
+        return Result;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioClockSliceTest, "OmniCapture.AudioClock.SlicesAtFrameBoundaries", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioClockSliceTest::RunTest(const FString& Parameters)
+{
+    // 29.97 fps does not divide 48 kHz, and 441-frame blocks straddle every frame boundary. With correction off the
+    // ratio stays at exactly 1, so every output sample can be checked against the device's.
+    const double FrameRate = 30000.0 / 1001.0;
+    FOmniCaptureAudioClock Clock;
+    Clock.SetMaxRatioDeviation(0.0);
+    FSyntheticAudioDevice Device;
+    Device.BlockFrames = 441;
+    FRandomStream Random(7);
+
+    const double Origin = 0.25;
+    int32 WrongSizes = 0;
+    int32 WrongTimestamps = 0;
+    int32 WrongSamples = 0;
+    for (int32 FrameIndex = 0; FrameIndex < 300; ++FrameIndex)
+    {
+        const double VideoTimestamp = Origin + FrameIndex / FrameRate;
+        // The device starts with the first frame and then runs two blocks ahead, enough to cover the filter's
+        // look-ahead, so every slice can be cut in full.
+        Device.DeliverUntil(VideoTimestamp - Origin + (FrameIndex > 0 ? 2.0 * Device.BlockFrames / ClockTestSampleRate : 0.0), Random, Clock);
+
+        FOmniAudioPacket Packet;
+        const bool bProduced = Clock.Produce(VideoTimestamp, Packet);
+        if (FrameIndex == 0)
+        {
+            TestFalse(TEXT("The first frame only sets the origin"), bProduced);
+            continue;
+        }
+
+        const int64 Start = FMath::RoundToInt64((FrameIndex - 1) / FrameRate * ClockTestSampleRate);
+        const int64 End = FMath::RoundToInt64(FrameIndex / FrameRate * ClockTestSampleRate);
+        if (!bProduced || Packet.PCM16.Num() != End - Start)
+        {
+            ++WrongSizes;
+        }
+        if (bProduced && !FMath::IsNearlyEqual(Packet.Timestamp, Origin + static_cast<double>(Start) / ClockTestSampleRate, 1e-9))
+        {
+            ++WrongTimestamps;
+        }
+        for (int32 Index = 0; bProduced && Index < Packet.PCM16.Num(); ++Index)
+        {
+            WrongSamples += Packet.PCM16[Index] != SyntheticSample(Start + Index) ? 1 : 0;
+        }
+    }
+
+    TestEqual(TEXT("Every frame gets exactly the samples of its interval"), WrongSizes, 0);
+    TestEqual(TEXT("Every packet starts on its sample position"), WrongTimestamps, 0);
+    TestEqual(TEXT("Blocks are split without losing or repeating a sample"), WrongSamples, 0);
+    TestEqual(TEXT("Nothing is skipped or padded"), Clock.GetStats().Resyncs, 0);
+    TestEqual(TEXT("Input that covers every frame is no underrun, however the blocks fall"), Clock.GetStats().Underruns, 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioClockDriftTest, "OmniCapture.AudioClock.LocksToVideoUnderDriftAndJitter", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioClockDriftTest::RunTest(const FString& Parameters)
+{
+    for (const double Drift : { 0.001, -0.002 })
+    {
+        FOmniCaptureAudioClock Clock;
+        FSyntheticAudioDevice Device;
+        Device.Drift = Drift;
+        Device.MaxLatencySeconds = 0.008;
+
+        const FClockRunResult Result = RunClock(Clock, Device, 30.0, 0.004, 90.0, 60.0);
+        const FOmniCaptureAudioClockStats Stats = Clock.GetStats();
+        const FString Label = FString::Printf(TEXT("%+.0f ppm"), Drift * 1e6);
+
+        TestTrue(Label + TEXT(": packets are contiguous"), Result.bContiguous);
+        TestEqual(Label + TEXT(": no block is dropped or repeated"), Stats.Resyncs, 0);
+        TestTrue(Label + TEXT(": the correction stays within its bound"), Result.MaxCorrectionPPM <= FOmniCaptureAudioClock::DefaultMaxRatioDeviation * 1e6 + 0.5);
+        TestTrue(Label + TEXT(": the correction converges on the drift"), FMath::Abs(Stats.CorrectionPPM - Drift * 1e6) < 300.0);
+        TestTrue(Label + TEXT(": audio stays locked within 5 ms"), Result.MaxLockErrorAfterSettling < 5.0);
+
+        // Without correction, 90 s at this drift would have piled up or starved 90-180 ms of audio.
+        const int64 VideoFrames = FMath::RoundToInt64(Result.LastVideoTimestamp * ClockTestSampleRate);
+        TestTrue(Label + TEXT(": output keeps pace with the video clock"), FMath::Abs(VideoFrames - Result.EmittedFrames) < 2 * Device.BlockFrames);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioClockStallTest, "OmniCapture.AudioClock.RecoversFromStalledAudio", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioClockStallTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureAudioClock Clock;
+    FSyntheticAudioDevice Device;
+    FRandomStream Random(3);
+
+    int64 Emitted = 0;
+    double LastTimestamp = 0.0;
+    for (int32 FrameIndex = 0; FrameIndex < 150; ++FrameIndex)
+    {
+        LastTimestamp = FrameIndex / 30.0;
+        // The device delivers nothing for one second in the middle of the take.
+        if (LastTimestamp < 2.0 || LastTimestamp >= 3.0)
+        {
+            Device.DeliverUntil(LastTimestamp, Random, Clock);
+        }
+        else
+        {
+            Device.RenderedFrames = FMath::RoundToInt64(LastTimestamp * ClockTestSampleRate);
+        }
+
+        FOmniAudioPacket Packet;
+        if (Clock.Produce(LastTimestamp, Packet))
+        {
+            Emitted += Packet.PCM16.Num();
+        }
+    }
+
+    TestTrue(TEXT("The stall is bridged with silence"), Clock.GetStats().Resyncs > 0);
+    TestTrue(TEXT("Frames during the stall are underruns"), Clock.GetStats().Underruns > 0);
+    TestTrue(TEXT("Audio is locked again after the stall"), FMath::Abs(Clock.GetStats().LockErrorMilliseconds) < 5.0);
+    TestTrue(TEXT("Output stays on the video timeline"), FMath::Abs(FMath::RoundToInt64(LastTimestamp * ClockTestSampleRate) - Emitted) < 2 * Device.BlockFrames);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioResamplerQualityTest, "OmniCapture.AudioClock.ResamplesCleanly", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioResamplerQualityTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 InputFrames = 24000;
+    constexpr double Ratio = 1.003;
+
+    for (const double Frequency : { 440.0, 8000.0, 16000.0 })
+    {
+        TArray<int16> Input;
+        Input.SetNumUninitialized(InputFrames * 2);
+        for (int32 Index = 0; Index < InputFrames; ++Index)
+        {
+            const double Value = 0.5 * FMath::Sin(2.0 * PI * Frequency * Index / ClockTestSampleRate);
+            Input[Index * 2] = static_cast<int16>(FMath::RoundToInt(Value * 32767.0));
+            Input[Index * 2 + 1] = static_cast<int16>(FMath::RoundToInt(-Value * 32767.0));
+        }
+
+        FOmniCaptureAudioResampler Resampler;
+        Resampler.Reset(2);
+        Resampler.AddInput(Input.GetData(), InputFrames);
+
+        TArray<float> Output;
+        Output.SetNumUninitialized(InputFrames * 2);
+        const int32 Written = Resampler.Process(Ratio, Output.GetData(), InputFrames);
+
+        double MaxError = 0.0;
+        // The first frames still see the silent history in front of the input.
+        for (int32 Index = FOmniCaptureAudioResampler::HalfTaps * 2; Index < Written; ++Index)
+        {
+            const double Expected = 0.5 * FMath::Sin(2.0 * PI * Frequency * Index * Ratio / ClockTestSampleRate);
+            MaxError = FMath::Max(MaxError, FMath::Abs(Output[Index * 2] - Expected));
+            MaxError = FMath::Max(MaxError, FMath::Abs(Output[Index * 2 + 1] + Expected));
+        }
+
+        TestTrue(FString::Printf(TEXT("%.0f Hz resamples more than 70 dB below the signal"), Frequency), MaxError < 0.5 * 3.2e-4);
+    }
+
+    // At a ratio of exactly 1 the input comes through untouched.
+    TArray<int16> Ramp;
+    for (int32 Index = 0; Index < 100; ++Index)
+    {
+        Ramp.Add(static_cast<int16>(Index * 300 - 15000));
+    }
+    FOmniCaptureAudioResampler Resampler;
+    Resampler.Reset(1);
+    Resampler.AddInput(Ramp.GetData(), Ramp.Num());
+    float Passthrough[100];
+    const int32 Written = Resampler.Process(1.0, Passthrough, 100);
+    TestEqual(TEXT("Only the filter's look-ahead is held back"), Written, Ramp.Num() - FOmniCaptureAudioResampler::HalfTaps);
+    int32 Mismatches = 0;
+    for (int32 Index = 0; Index < Written; ++Index)
+    {
+        Mismatches += FMath::RoundToInt(Passthrough[Index] * 32767.0f) != Ramp[Index] ? 1 : 0;
+    }
+    TestEqual(TEXT("Passthrough is bit exact"), Mismatches, 0);
+    return true;
+}
@@ -0,0 +1,162 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OmniCaptureAudioFileWriter.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    FString MakeAudioFileTestDirectory(const TCHAR* Name)
+    {
+        return OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureAudioFileWriter"), Name);
+    }
+
+    FOmniAudioPacket MakeAudioFilePacket(int32 FirstFrame, int32 NumFrames, int32 NumChannels, int32 SampleRate)
+    {
+        FOmniAudioPacket Packet;
+        Packet.SampleRate = SampleRate;
+        Packet.NumChannels = NumChannels;
+        Packet.PCM16.SetNumUninitialized(NumFrames * NumChannels);
+        for (int32 Index = 0; Index < Packet.PCM16.Num(); ++Index)
+        {
+            Packet.PCM16[Index] = static_cast<int16>((FirstFrame * NumChannels + Index) * 7);
+        }
+        return Packet;
+    }
+
+    // Writes NumPackets packets of PacketFrames frames and returns the samples the file should hold.
+    TArray<int16> WriteTestTake(FOmniCaptureAudioFileWriter& Writer, int32 NumPackets, int32 PacketFrames, int32 NumChannels, int32 SampleRate)
+    {
+        TArray<int16> Expected;
+        for (int32 PacketIndex = 0; PacketIndex < NumPackets; ++PacketIndex)
+        {
+            const FOmniAudioPacket Packet = MakeAudioFilePacket(PacketIndex * PacketFrames, PacketFrames, NumChannels, SampleRate);
+            Writer.Write(Packet);
+            Expected.Append(Packet.PCM16);
+        }
+        return Expected;
+    }
+
+    bool FileMatches(const TArray<uint8>& Bytes, const TArray<uint8>& Header, const TArray<int16>& Samples)
+    {
+        const int64 DataBytes = static_cast<int64>(Samples.Num()) * sizeof(int16);
+        return Bytes.Num() == Header.Num() + DataBytes
+            && FMemory::Memcmp(Bytes.GetData(), Header.GetData(), Header.Num()) == 0
+            && FMemory::Memcmp(Bytes.GetData() + Header.Num(), Samples.GetData(), DataBytes) == 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioFileWriterWavTest, "OmniCapture.AudioFileWriter.StreamsWav", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioFileWriterWavTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeAudioFileTestDirectory(TEXT("Wav"));
+    const FString FilePath = Directory / TEXT("Take.wav");
+
+    // Six channels so chunks have to stop short of ChunkBytes to hold whole frames; the take spans several chunks.
+    const int32 NumChannels = 6;
+    const int32 PacketFrames = 1601;
+    FOmniCaptureAudioFileWriter Writer;
+    TestTrue(TEXT("The writer opens"), Writer.Open(FilePath, EOmniCaptureAudioFileFormat::WAV, 48000, NumChannels));
+    const TArray<int16> Expected = WriteTestTake(Writer, 40, PacketFrames, NumChannels, 48000);
+    TestFalse(TEXT("A packet at another rate is refused"), Writer.Write(MakeAudioFilePacket(0, 16, NumChannels, 44100)));
+    TestTrue(TEXT("The writer closes cleanly"), Writer.Close());
+
+    const FOmniCaptureAudioFileStats Stats = Writer.GetStats();
+    TestEqual(TEXT("Every frame is counted"), Stats.FramesWritten, static_cast<int64>(40 * PacketFrames));
+    TestEqual(TEXT("The refused packet is counted"), Stats.RejectedPackets, 1);
+
+    TArray<uint8> Bytes;
+    TestTrue(TEXT("The file loads"), FFileHelper::LoadFileToArray(Bytes, *FilePath));
+    TestEqual(TEXT("Bytes written match the file"), Stats.BytesWritten, static_cast<int64>(Bytes.Num()));
+    const TArray<uint8> Header = FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat::WAV, 48000, NumChannels, static_cast<int64>(Expected.Num()) * sizeof(int16));
+    TestTrue(TEXT("The file holds the final header and every sample in order"), FileMatches(Bytes, Header, Expected));
+    TestTrue(TEXT("Small takes stay plain RIFF"), Bytes.Num() > 4 && FMemory::Memcmp(Bytes.GetData(), "RIFF", 4) == 0);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioFileWriterCafTest, "OmniCapture.AudioFileWriter.StreamsCaf", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioFileWriterCafTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeAudioFileTestDirectory(TEXT("Caf"));
+    const FString FilePath = Directory / TEXT("Take.caf");
+
+    FOmniCaptureAudioFileWriter Writer;
+    TestTrue(TEXT("The writer opens"), Writer.Open(FilePath, EOmniCaptureAudioFileFormat::CAF, 44100, 2));
+    const TArray<int16> Expected = WriteTestTake(Writer, 25, 1470, 2, 44100);
+    TestTrue(TEXT("The writer closes cleanly"), Writer.Close());
+
+    TArray<uint8> Bytes;
+    TestTrue(TEXT("The file loads"), FFileHelper::LoadFileToArray(Bytes, *FilePath));
+    const TArray<uint8> Header = FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat::CAF, 44100, 2, static_cast<int64>(Expected.Num()) * sizeof(int16));
+    TestTrue(TEXT("The file holds the final header and every sample in order"), FileMatches(Bytes, Header, Expected));
+
+    const TArray<uint8> OpenHeader = FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat::CAF, 44100, 2, -1);
+    TestEqual(TEXT("Open and closed headers are the same size"), OpenHeader.Num(), Header.Num());
+    TestTrue(TEXT("An open data chunk runs to the end of the file"), OpenHeader[56] == 0xFF && OpenHeader[63] == 0xFF);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioFileWriterRF64Test, "OmniCapture.AudioFileWriter.SwitchesToRF64", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioFileWriterRF64Test::RunTest(const FString& Parameters)
+{
+    const TArray<uint8> Small = FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat::WAV, 48000, 2, 1024);
+    const int64 LargeBytes = 5ll * 1024 * 1024 * 1024;
+    const TArray<uint8> Large = FOmniCaptureAudioFileWriter::BuildHeader(EOmniCaptureAudioFileFormat::WAV, 48000, 2, LargeBytes);
+    TestEqual(TEXT("RF64 headers take the place of the RIFF header"), Large.Num(), Small.Num());
+
+    TestTrue(TEXT("Small files start RIFF"), FMemory::Memcmp(Small.GetData(), "RIFF", 4) == 0);
+    TestTrue(TEXT("Small files reserve the ds64 chunk as JUNK"), FMemory::Memcmp(Small.GetData() + 12, "JUNK", 4) == 0);
+    TestTrue(TEXT("Large files start RF64"), FMemory::Memcmp(Large.GetData(), "RF64", 4) == 0);
+    TestTrue(TEXT("Large files carry a ds64 chunk"), FMemory::Memcmp(Large.GetData() + 12, "ds64", 4) == 0);
+
+    int64 DataSize64 = 0;
+    FMemory::Memcpy(&DataSize64, Large.GetData() + 28, sizeof(DataSize64));
+    TestEqual(TEXT("ds64 holds the real data size"), DataSize64, LargeBytes);
+    uint32 DataSize32 = 0;
+    FMemory::Memcpy(&DataSize32, Large.GetData() + 76, sizeof(DataSize32));
+    TestTrue(TEXT("The 32-bit data size defers to ds64"), DataSize32 == MAX_uint32);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioFileWriterRecoveryTest, "OmniCapture.AudioFileWriter.RecoversUnfinishedFiles", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioFileWriterRecoveryTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeAudioFileTestDirectory(TEXT("Recovery"));
+
+    for (const EOmniCaptureAudioFileFormat Format : { EOmniCaptureAudioFileFormat::WAV, EOmniCaptureAudioFileFormat::CAF })
+    {
+        const FString FilePath = Directory / (FString(TEXT("Take")) + FOmniCaptureAudioFileWriter::GetExtension(Format));
+        FOmniCaptureAudioFileWriter Writer;
+        TestTrue(TEXT("The writer opens"), Writer.Open(FilePath, Format, 48000, 2));
+        const TArray<int16> Expected = WriteTestTake(Writer, 10, 4800, 2, 48000);
+        TestTrue(TEXT("The writer closes cleanly"), Writer.Close());
+
+        // A crash leaves the header as it was opened and may cut the last frame short.
+        TArray<uint8> Bytes;
+        TestTrue(TEXT("The file loads"), FFileHelper::LoadFileToArray(Bytes, *FilePath));
+        const TArray<uint8> OpenHeader = FOmniCaptureAudioFileWriter::BuildHeader(Format, 48000, 2, -1);
+        FMemory::Memcpy(Bytes.GetData(), OpenHeader.GetData(), OpenHeader.Num());
+        Bytes.Add(0x5A);
+        Bytes.Add(0x5A);
+        Bytes.Add(0x5A);
+        TestTrue(TEXT("The damaged file saves"), FFileHelper::SaveArrayToFile(Bytes, *FilePath));
+
+        TestTrue(TEXT("The file is recovered"), FOmniCaptureAudioFileWriter::RecoverFile(FilePath));
+        TestTrue(TEXT("The recovered file loads"), FFileHelper::LoadFileToArray(Bytes, *FilePath));
+        const TArray<uint8> Header = FOmniCaptureAudioFileWriter::BuildHeader(Format, 48000, 2, static_cast<int64>(Expected.Num()) * sizeof(int16));
+        TestTrue(TEXT("The header counts every whole frame"), Bytes.Num() >= Header.Num() && FMemory::Memcmp(Bytes.GetData(), Header.GetData(), Header.Num()) == 0);
+    }
+
+    const FString ForeignPath = Directory / TEXT("NotAudio.wav");
+    TestTrue(TEXT("A stray file saves"), FFileHelper::SaveStringToFile(TEXT("not a wave file at all"), *ForeignPath));
+    TestFalse(TEXT("Files that are not audio are left alone"), FOmniCaptureAudioFileWriter::RecoverFile(ForeignPath));
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,99 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureAudioRing.h"
+
+namespace
+{
+    int16 ReferencePCM16(float Sample, float Gain)
+    {
+        const float Value = FMath::Clamp(Sample * Gain * 32767.0f, -32767.0f, 32767.0f);
+        return static_cast<int16>(FMath::RoundHalfToEven(Value));
+    }
+
+    TArray<float> MakeRamp(int32 Count, float Start, float Step)
+    {
+        TArray<float> Samples;
+        Samples.SetNumUninitialized(Count);
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            Samples[Index] = Start + Step * Index;
+        }
+        return Samples;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioRingConvertTest, "OmniCapture.AudioRing.ConvertsToPCM16", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioRingConvertTest::RunTest(const FString& Parameters)
+{
+    // An odd count so both the vector loop and the scalar tail run, with values past full scale on both sides.
+    const TArray<float> Source = MakeRamp(77, -1.5f, 0.0391f);
+    const float Gain = 0.8f;
+
+    TArray<int16> Converted;
+    Converted.SetNumUninitialized(Source.Num());
+    FOmniCaptureAudioRing::ConvertToPCM16(Source.GetData(), Converted.GetData(), Source.Num(), Gain);
+
+    int32 Mismatches = 0;
+    for (int32 Index = 0; Index < Source.Num(); ++Index)
+    {
+        // The vector loop and the scalar tail both break ties to even, so they agree with the reference exactly.
+        if (Converted[Index] != ReferencePCM16(Source[Index], Gain))
+        {
+            ++Mismatches;
+        }
+    }
+    TestEqual(TEXT("Every sample matches the scalar conversion"), Mismatches, 0);
+
+    const float Extremes[8] = { 4.0f, -4.0f, 1.0f, -1.0f, 0.0f, 0.5f, -0.5f, 2.0f };
+    int16 Clamped[8];
+    FOmniCaptureAudioRing::ConvertToPCM16(Extremes, Clamped, 8, 1.0f);
+    TestEqual(TEXT("Positive overload clamps"), static_cast<int32>(Clamped[0]), 32767);
+    TestEqual(TEXT("Negative overload clamps"), static_cast<int32>(Clamped[1]), -32767);
+    TestEqual(TEXT("Full scale is kept"), static_cast<int32>(Clamped[2]), 32767);
+    TestEqual(TEXT("Silence stays silent"), static_cast<int32>(Clamped[4]), 0);
+    TestEqual(TEXT("Half scale rounds"), static_cast<int32>(Clamped[5]), 16384);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAudioRingRoundTripTest, "OmniCapture.AudioRing.WrapsAndRefusesOverflow", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAudioRingRoundTripTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureAudioRing Ring;
+    Ring.Initialize(4, 100);
+
+    const TArray<float> Block = MakeRamp(40, -0.5f, 0.025f);
+    TestTrue(TEXT("First block fits"), Ring.Write(Block.GetData(), Block.Num(), 2, 48000, 0.0, 1.0f));
+    TestTrue(TEXT("Second block fits"), Ring.Write(Block.GetData(), Block.Num(), 2, 48000, 0.01, 1.0f));
+    TestFalse(TEXT("A block that does not fit the samples left is refused"), Ring.Write(Block.GetData(), Block.Num(), 2, 48000, 0.02, 1.0f));
+    TestEqual(TEXT("Refused blocks are not queued"), Ring.GetPendingBlockCount(), 2);
+
+    double Timestamp = -1.0;
+    TestTrue(TEXT("The oldest block is visible"), Ring.PeekTimestamp(Timestamp) && Timestamp == 0.0);
+
+    TArray<int16> Expected;
+    Expected.SetNumUninitialized(Block.Num());
+    FOmniCaptureAudioRing::ConvertToPCM16(Block.GetData(), Expected.GetData(), Block.Num(), 1.0f);
+
+    FOmniAudioPacket Packet;
+    TestTrue(TEXT("The first block reads back"), Ring.Read(Packet));
+    TestTrue(TEXT("Samples survive the ring"), Packet.PCM16 == Expected);
+    TestEqual(TEXT("Channels are carried"), Packet.NumChannels, 2);
+    TestEqual(TEXT("Sample rate is carried"), Packet.SampleRate, 48000);
+
+    // Sample 80 onwards crosses the end of the 100-sample ring.
+    TestTrue(TEXT("A block that wraps fits once space is freed"), Ring.Write(Block.GetData(), Block.Num(), 2, 48000, 0.02, 1.0f));
+    TestTrue(TEXT("The second block reads back"), Ring.Read(Packet) && Packet.Timestamp == 0.01);
+    TestTrue(TEXT("The wrapped block reads back"), Ring.Read(Packet) && Packet.Timestamp == 0.02);
+    TestTrue(TEXT("Wrapped samples come back in order"), Packet.PCM16 == Expected);
+    TestFalse(TEXT("The ring is empty"), Ring.Read(Packet));
+
+    for (int32 Index = 0; Index < 4; ++Index)
+    {
+        Ring.Write(Block.GetData(), 10, 1, 48000, Index, 1.0f);
+    }
+    TestFalse(TEXT("Block descriptors are bounded too"), Ring.Write(Block.GetData(), 10, 1, 48000, 4.0, 1.0f));
+    Ring.DiscardAll();
+    TestEqual(TEXT("Discarding empties the ring"), Ring.GetPendingBlockCount(), 0);
+    TestTrue(TEXT("Discarded space is reusable"), Ring.Write(Block.GetData(), 90, 1, 48000, 5.0, 1.0f));
+    return true;
+}
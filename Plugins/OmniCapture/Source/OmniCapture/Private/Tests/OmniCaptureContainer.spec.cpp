@@ -0,0 +1,277 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OmniCaptureContainer.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    FString MakeContainerTestDirectory(const TCHAR* Name)
+    {
+        return OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureContainer"), Name);
+    }
+
+    TUniquePtr<FOmniCaptureFrame> MakeContainerTestFrame(const FIntPoint& Size, int32 FrameIndex)
+    {
+        return OmniCaptureTests::MakeColor8Frame(Size, FrameIndex, FColor(static_cast<uint8>(FrameIndex * 40), 64, 128, 255));
+    }
+
+    // Writes and closes a container of EntryCount small chunks named Take_000000.bin onwards, and returns its bytes.
+    TArray<uint8> WriteSmallContainer(FAutomationTestBase& Test, const FString& ContainerPath, int32 EntryCount)
+    {
+        const uint8 Payload[] = { 1, 2, 3, 4, 5, 6, 7 };
+        {
+            FOmniCaptureContainerWriter Writer(ContainerPath);
+            for (int32 Index = 0; Index < EntryCount; ++Index)
+            {
+                FOmniCaptureFrameMetadata Metadata;
+                Metadata.FrameIndex = Index;
+                Test.TestTrue(TEXT("Images append"), Writer.Append(FString::Printf(TEXT("Take_%06d.bin"), Index), Metadata, true, Payload, UE_ARRAY_COUNT(Payload)));
+            }
+            Test.TestTrue(TEXT("The container closes"), Writer.Close());
+        }
+
+        TArray<uint8> Bytes;
+        Test.TestTrue(TEXT("The container loads"), FFileHelper::LoadFileToArray(Bytes, *ContainerPath));
+        return Bytes;
+    }
+
+    // Byte offset of the ChunkIndex-th chunk header, found by walking the chunks in front of it.
+    int64 FindChunkOffset(const TArray<uint8>& Bytes, int32 ChunkIndex)
+    {
+        int64 Offset = sizeof(FOmniCaptureContainerHeader);
+        for (int32 Index = 0; Index < ChunkIndex; ++Index)
+        {
+            FOmniCaptureContainerChunkHeader Chunk;
+            FMemory::Memcpy(&Chunk, Bytes.GetData() + Offset, sizeof(Chunk));
+            Offset += sizeof(Chunk) + Chunk.NameLength + static_cast<int64>(Chunk.PayloadSize);
+        }
+        return Offset;
+    }
+
+    // Turns a closed container into one whose capture died before writing the index.
+    void DropIndex(TArray<uint8>& Bytes)
+    {
+        FOmniCaptureContainerHeader Header;
+        FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+        Bytes.SetNum(static_cast<int32>(Header.IndexOffset));
+        Header.IndexOffset = 0;
+        Header.IndexSize = 0;
+        Header.EntryCount = 0;
+        FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+    }
+
+    bool HasPNGSignature(const uint8* Data, int64 Size)
+    {
+        static const uint8 Signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+        return Data && Size >= UE_ARRAY_COUNT(Signature) && FMemory::Memcmp(Data, Signature, UE_ARRAY_COUNT(Signature)) == 0;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureContainerImageWriterTest, "OmniCapture.Container.PacksImageWriterOutput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureContainerImageWriterTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeContainerTestDirectory(TEXT("Packed"));
+    const FIntPoint Size(32, 16);
+    constexpr int32 FrameCount = 4;
+
+    FOmniCaptureSettings Settings;
+    Settings.OutputFileName = TEXT("Shot");
+    Settings.ImageFormat = EOmniCaptureImageFormat::PNG;
+    Settings.PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth8;
+    Settings.bWriteFrameContainer = true;
+
+    int64 ReportedBytes = 0;
+    {
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(Settings, Directory);
+        TestTrue(TEXT("The writer packs into a container"), Writer.IsWritingContainer());
+        // Enqueued in reverse so the container's chunk order differs from frame order.
+        for (int32 FrameIndex = FrameCount - 1; FrameIndex >= 0; --FrameIndex)
+        {
+            Writer.EnqueueFrame(MakeContainerTestFrame(Size, FrameIndex), FString::Printf(TEXT("Shot_%06d.png"), FrameIndex));
+        }
+        ReportedBytes = Writer.GetContainerBytesWritten();
+        Writer.Flush();
+        TestEqual(TEXT("Container writes succeed"), Writer.GetWriterPoolStats().FailedTasks, 0);
+    }
+
+    const FString ContainerPath = FOmniCaptureContainerWriter::GetContainerPath(Directory, Settings.OutputFileName);
+    TestFalse(TEXT("No loose image is written"), FPaths::FileExists(Directory / TEXT("Shot_000000.png")));
+    TestTrue(TEXT("The in-memory size tracks the file"), ReportedBytes > 0 && ReportedBytes <= IFileManager::Get().FileSize(*ContainerPath));
+
+    FOmniCaptureContainerReader Reader;
+    if (!TestTrue(TEXT("The container opens"), Reader.Open(ContainerPath)))
+    {
+        return false;
+    }
+    TestFalse(TEXT("A closed container reads its index"), Reader.WasRecovered());
+
+    const TArray<const FOmniCaptureContainerEntry*> Frames = Reader.GetPrimaryEntries();
+    TestEqual(TEXT("Every frame is packed"), Frames.Num(), FrameCount);
+    for (int32 Index = 0; Index < Frames.Num(); ++Index)
+    {
+        TestEqual(TEXT("Primary entries come back in frame order"), Frames[Index]->FrameIndex, static_cast<int64>(Index));
+        TestTrue(TEXT("Payloads are the encoded images"), HasPNGSignature(Reader.GetPayload(*Frames[Index]), Frames[Index]->PayloadSize));
+    }
+    TestNotNull(TEXT("Entries are found by file name"), Reader.FindEntry(TEXT("Shot_000002.png")));
+
+    const FString ExtractDirectory = MakeContainerTestDirectory(TEXT("Extracted"));
+    TestEqual(TEXT("Every image is extracted"), Reader.ExtractAll(ExtractDirectory), FrameCount);
+    TestEqual(TEXT("Extracted files keep their size"), IFileManager::Get().FileSize(*(ExtractDirectory / TEXT("Shot_000001.png"))), Reader.FindEntry(TEXT("Shot_000001.png"))->PayloadSize);
+
+    Reader.Close();
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    IFileManager::Get().DeleteDirectory(*ExtractDirectory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureContainerRecoveryTest, "OmniCapture.Container.RecoversMissingIndex", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureContainerRecoveryTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeContainerTestDirectory(TEXT("Recovery"));
+    const FString ContainerPath = FOmniCaptureContainerWriter::GetContainerPath(Directory, TEXT("Take"));
+    const TArray<uint8> Payload = { 1, 2, 3, 4, 5, 6, 7 };
+    constexpr int32 EntryCount = 3;
+
+    int64 ClosedBytes = 0;
+    {
+        FOmniCaptureContainerWriter Writer(ContainerPath);
+        TestTrue(TEXT("The container is created"), Writer.IsOpen());
+        for (int32 Index = 0; Index < EntryCount; ++Index)
+        {
+            FOmniCaptureFrameMetadata Metadata;
+            Metadata.FrameIndex = Index;
+            TestTrue(TEXT("Images append"), Writer.Append(FString::Printf(TEXT("Take_%06d.bin"), Index), Metadata, true, Payload.GetData(), Payload.Num()));
+        }
+        TestTrue(TEXT("The container closes"), Writer.Close());
+        ClosedBytes = Writer.GetBytesWritten();
+    }
+
+    TArray<uint8> Bytes;
+    TestTrue(TEXT("The container loads"), FFileHelper::LoadFileToArray(Bytes, *ContainerPath));
+    TestEqual(TEXT("The count covers chunk headers and the index"), ClosedBytes, static_cast<int64>(Bytes.Num()));
+
+    // Simulate a capture that died before the index was written: drop the index and half of the last chunk.
+    FOmniCaptureContainerHeader Header;
+    FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+    Bytes.SetNum(static_cast<int32>(Header.IndexOffset) - Payload.Num() / 2);
+    Header.IndexOffset = 0;
+    Header.IndexSize = 0;
+    Header.EntryCount = 0;
+    FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+    TestTrue(TEXT("The damaged container saves"), FFileHelper::SaveArrayToFile(Bytes, *ContainerPath));
+
+    FOmniCaptureContainerReader Reader;
+    TestTrue(TEXT("The damaged container opens"), Reader.Open(ContainerPath));
+    TestTrue(TEXT("The index is rebuilt"), Reader.WasRecovered());
+    TestEqual(TEXT("Only whole chunks are recovered"), Reader.GetEntries().Num(), EntryCount - 1);
+    if (const FOmniCaptureContainerEntry* Entry = Reader.FindEntry(TEXT("Take_000001.bin")))
+    {
+        TestEqual(TEXT("Recovered payloads are intact"), FMemory::Memcmp(Reader.GetPayload(*Entry), Payload.GetData(), Payload.Num()), 0);
+    }
+    else
+    {
+        AddError(TEXT("The last whole chunk was not recovered"));
+    }
+
+    Reader.Close();
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureContainerHostileSizeTest, "OmniCapture.Container.RejectsHostileSizes", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureContainerHostileSizeTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeContainerTestDirectory(TEXT("Hostile"));
+    const FString ContainerPath = FOmniCaptureContainerWriter::GetContainerPath(Directory, TEXT("Take"));
+    constexpr int32 EntryCount = 3;
+    const TArray<uint8> Closed = WriteSmallContainer(*this, ContainerPath, EntryCount);
+    if (!TestTrue(TEXT("The container has an index"), Closed.Num() > static_cast<int32>(sizeof(FOmniCaptureContainerHeader))))
+    {
+        return false;
+    }
+
+    const auto OpenCorrupted = [this, &ContainerPath](const TArray<uint8>& Bytes, FOmniCaptureContainerReader& Reader)
+    {
+        TestTrue(TEXT("The corrupted container saves"), FFileHelper::SaveArrayToFile(Bytes, *ContainerPath));
+        return TestTrue(TEXT("The corrupted container opens"), Reader.Open(ContainerPath));
+    };
+
+    // A payload size past 2^63 is negative as an int64 and used to walk the recovery back over earlier chunks.
+    {
+        TArray<uint8> Bytes = Closed;
+        DropIndex(Bytes);
+        FOmniCaptureContainerChunkHeader Chunk;
+        const int64 ChunkOffset = FindChunkOffset(Bytes, 1);
+        FMemory::Memcpy(&Chunk, Bytes.GetData() + ChunkOffset, sizeof(Chunk));
+        Chunk.PayloadSize = MAX_uint64 - 15;
+        FMemory::Memcpy(Bytes.GetData() + ChunkOffset, &Chunk, sizeof(Chunk));
+
+        FOmniCaptureContainerReader Reader;
+        if (OpenCorrupted(Bytes, Reader))
+        {
+            TestTrue(TEXT("The index is rebuilt"), Reader.WasRecovered());
+            TestEqual(TEXT("Recovery stops at the chunk with the impossible size"), Reader.GetEntries().Num(), 1);
+        }
+    }
+
+    // A name running past the end of the file ends the recovery instead of being read.
+    {
+        TArray<uint8> Bytes = Closed;
+        DropIndex(Bytes);
+        FOmniCaptureContainerChunkHeader Chunk;
+        const int64 ChunkOffset = FindChunkOffset(Bytes, 0);
+        FMemory::Memcpy(&Chunk, Bytes.GetData() + ChunkOffset, sizeof(Chunk));
+        Chunk.NameLength = MAX_uint32;
+        FMemory::Memcpy(Bytes.GetData() + ChunkOffset, &Chunk, sizeof(Chunk));
+
+        FOmniCaptureContainerReader Reader;
+        if (OpenCorrupted(Bytes, Reader))
+        {
+            TestEqual(TEXT("Nothing is recovered past a bad name length"), Reader.GetEntries().Num(), 0);
+        }
+    }
+
+    // An index record whose offset plus size wraps around 2^64 is rejected, and the chunks are walked instead.
+    {
+        TArray<uint8> Bytes = Closed;
+        FOmniCaptureContainerHeader Header;
+        FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+        const int64 RecordOffset = static_cast<int64>(Header.IndexOffset) + sizeof(FOmniCaptureContainerIndexRecord);
+        FOmniCaptureContainerIndexRecord Record;
+        FMemory::Memcpy(&Record, Bytes.GetData() + RecordOffset, sizeof(Record));
+        Record.PayloadOffset = MAX_uint64 - 2;
+        Record.PayloadSize = 8;
+        FMemory::Memcpy(Bytes.GetData() + RecordOffset, &Record, sizeof(Record));
+
+        FOmniCaptureContainerReader Reader;
+        if (OpenCorrupted(Bytes, Reader))
+        {
+            TestTrue(TEXT("The damaged index is not trusted"), Reader.WasRecovered());
+            TestEqual(TEXT("Every chunk is still recovered"), Reader.GetEntries().Num(), EntryCount);
+        }
+    }
+
+    // An index that claims to run past the end of the file is rejected the same way.
+    {
+        TArray<uint8> Bytes = Closed;
+        FOmniCaptureContainerHeader Header;
+        FMemory::Memcpy(&Header, Bytes.GetData(), sizeof(Header));
+        Header.IndexSize = MAX_uint64 - Header.IndexOffset + 1;
+        FMemory::Memcpy(Bytes.GetData(), &Header, sizeof(Header));
+
+        FOmniCaptureContainerReader Reader;
+        if (OpenCorrupted(Bytes, Reader))
+        {
+            TestTrue(TEXT("The oversized index is not trusted"), Reader.WasRecovered());
+            TestEqual(TEXT("Every chunk is still recovered"), Reader.GetEntries().Num(), EntryCount);
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,501 @@
+#include "Misc/AutomationTest.h"
+
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "OmniCaptureCubemapSampler.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureProjectionLUT.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    struct FTestCubemap
+    {
+        TArray<FLinearColor> Faces[6];
+        TArray<FFloat16Color> HalfFaces[6];
+        FOmniCaptureCubeSeamTable SeamTable;
+        int32 Resolution = 0;
+
+        FTestCubemap(int32 InResolution, FRandomStream& Random)
+            : SeamTable(InResolution)
+            , Resolution(InResolution)
+        {
+            for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+            {
+                Faces[FaceIndex].SetNumUninitialized(Resolution * Resolution);
+                HalfFaces[FaceIndex].SetNumUninitialized(Resolution * Resolution);
+                for (int32 Index = 0; Index < Faces[FaceIndex].Num(); ++Index)
+                {
+                    // Cover negative, [0, 1] and HDR values so clamping and the sRGB toe/curve split are exercised.
+                    Faces[FaceIndex][Index] = FLinearColor(Random.FRandRange(-0.25f, 4.0f), Random.FRandRange(0.0f, 1.0f), Random.FRandRange(0.0f, 0.01f), Random.FRandRange(0.0f, 1.0f));
+                    HalfFaces[FaceIndex][Index] = FFloat16Color(Faces[FaceIndex][Index]);
+                }
+            }
+        }
+
+        FOmniCaptureCubemapView GetView(EOmniCaptureCPUFilter Filter, EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::FullFloat) const
+        {
+            FOmniCaptureCubemapView View;
+            View.Resolution = Resolution;
+            View.Precision = Precision;
+            View.Filter = Filter;
+            View.SeamTable = &SeamTable;
+            for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+            {
+                View.Faces[FaceIndex] = Precision == EOmniCapturePixelPrecision::HalfFloat
+                    ? static_cast<const void*>(HalfFaces[FaceIndex].GetData())
+                    : static_cast<const void*>(Faces[FaceIndex].GetData());
+            }
+            return View;
+        }
+    };
+
+    const TCHAR* GetFilterName(EOmniCaptureCPUFilter Filter)
+    {
+        switch (Filter)
+        {
+        case EOmniCaptureCPUFilter::Bilinear: return TEXT("Bilinear");
+        case EOmniCaptureCPUFilter::Bicubic: return TEXT("Bicubic");
+        default: return TEXT("Nearest");
+        }
+    }
+
+    TArray<FOmniCaptureProjectionSample> MakeRandomSamples(int32 Count, int32 Resolution, EOmniCaptureCPUFilter Filter, FRandomStream& Random)
+    {
+        const int32 MaxFixed = (Filter == EOmniCaptureCPUFilter::Nearest ? Resolution - 1 : Resolution) << FOmniCaptureProjectionSample::FractionBits;
+
+        TArray<FOmniCaptureProjectionSample> Samples;
+        Samples.SetNum(Count);
+        for (FOmniCaptureProjectionSample& Sample : Samples)
+        {
+            if (Random.FRand() < 0.1f)
+            {
+                continue;
+            }
+
+            // Bias a share of the samples onto the face border so seam lookups are exercised.
+            const bool bBorder = Random.FRand() < 0.25f;
+            const uint32 Face = static_cast<uint32>(Random.RandRange(0, 5));
+            const uint32 FixedX = static_cast<uint32>(bBorder ? (Random.FRand() < 0.5f ? Random.RandRange(0, 511) : Random.RandRange(MaxFixed - 511, MaxFixed)) : Random.RandRange(0, MaxFixed));
+            const uint32 FixedY = static_cast<uint32>(Random.RandRange(0, MaxFixed));
+            Sample.PackedX = (Face << 24) | FixedX;
+            Sample.PackedY = FixedY;
+        }
+        return Samples;
+    }
+
+    bool ColorsMatch(const FColor& A, const FColor& B)
+    {
+        return FMath::Abs(A.R - B.R) <= 1 && FMath::Abs(A.G - B.G) <= 1 && FMath::Abs(A.B - B.B) <= 1 && A.A == B.A;
+    }
+
+    template <typename PixelType>
+    double MeasureMegapixelsPerSecond(const FOmniCaptureCubemapView& View, const FOmniCaptureProjectionLUT& LUT, bool bScalar, TArray<PixelType>& Pixels)
+    {
+        const FIntPoint EyeResolution = LUT.GetEyeResolution();
+        constexpr int32 Iterations = 4;
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            for (int32 Y = 0; Y < EyeResolution.Y; ++Y)
+            {
+                const int64 Offset = static_cast<int64>(Y) * EyeResolution.X;
+                if (bScalar)
+                {
+                    FOmniCaptureCubemapSampler::GatherRowScalar(View, LUT.GetRow(Y), EyeResolution.X, Pixels.GetData() + Offset);
+                }
+                else
+                {
+                    FOmniCaptureCubemapSampler::GatherRow(View, LUT.GetRow(Y), EyeResolution.X, Pixels.GetData() + Offset);
+                }
+            }
+        }
+        const double ElapsedSeconds = FMath::Max(FPlatformTime::Seconds() - StartSeconds, 1.0e-9);
+
+        return static_cast<double>(EyeResolution.X) * EyeResolution.Y * Iterations / ElapsedSeconds / 1.0e6;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapGatherMatchesScalarTest, "OmniCapture.CubemapSampler.GatherMatchesScalar", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCubemapGatherMatchesScalarTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 Resolution = 17;
+    constexpr int32 Count = 1031;
+
+    FRandomStream Random(0x0C0FFEE);
+    const FTestCubemap Cubemap(Resolution, Random);
+
+    for (EOmniCapturePixelPrecision Precision : { EOmniCapturePixelPrecision::FullFloat, EOmniCapturePixelPrecision::HalfFloat })
+    for (EOmniCaptureCPUFilter Filter : { EOmniCaptureCPUFilter::Nearest, EOmniCaptureCPUFilter::Bilinear, EOmniCaptureCPUFilter::Bicubic })
+    {
+        const FOmniCaptureCubemapView View = Cubemap.GetView(Filter, Precision);
+        const FString Label = FString::Printf(TEXT("%s %s faces"), GetFilterName(Filter), Precision == EOmniCapturePixelPrecision::HalfFloat ? TEXT("half") : TEXT("float"));
+        const TArray<FOmniCaptureProjectionSample> Samples = MakeRandomSamples(Count, Resolution, Filter, Random);
+        // Filtered kernels may fuse multiply-adds differently from the scalar reference.
+        const float LinearTolerance = Filter == EOmniCaptureCPUFilter::Nearest ? 0.0f : 1.0e-4f;
+
+        TArray<FLinearColor> LinearVector, LinearScalar;
+        LinearVector.SetNumZeroed(Count);
+        LinearScalar.SetNumZeroed(Count);
+        FOmniCaptureCubemapSampler::GatherRow(View, Samples.GetData(), Count, LinearVector.GetData());
+        FOmniCaptureCubemapSampler::GatherRowScalar(View, Samples.GetData(), Count, LinearScalar.GetData());
+
+        int32 Mismatches = 0;
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            Mismatches += !LinearVector[Index].Equals(LinearScalar[Index], LinearTolerance) ? 1 : 0;
+        }
+        TestEqual(FString::Printf(TEXT("%s: FLinearColor gather matches scalar reference"), *Label), Mismatches, 0);
+
+        TArray<FFloat16Color> HalfVector, HalfScalar;
+        HalfVector.SetNumZeroed(Count);
+        HalfScalar.SetNumZeroed(Count);
+        FOmniCaptureCubemapSampler::GatherRow(View, Samples.GetData(), Count, HalfVector.GetData());
+        FOmniCaptureCubemapSampler::GatherRowScalar(View, Samples.GetData(), Count, HalfScalar.GetData());
+
+        Mismatches = 0;
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const FLinearColor Vector = HalfVector[Index].GetFloats();
+            const FLinearColor Scalar = HalfScalar[Index].GetFloats();
+            Mismatches += !Vector.Equals(Scalar, 4.0e-3f) ? 1 : 0;
+        }
+        TestEqual(FString::Printf(TEXT("%s: FFloat16Color gather matches scalar reference"), *Label), Mismatches, 0);
+
+        TArray<FColor> ColorVector, ColorScalar;
+        ColorVector.SetNumZeroed(Count);
+        ColorScalar.SetNumZeroed(Count);
+        FOmniCaptureCubemapSampler::GatherRow(View, Samples.GetData(), Count, ColorVector.GetData());
+        FOmniCaptureCubemapSampler::GatherRowScalar(View, Samples.GetData(), Count, ColorScalar.GetData());
+
+        Mismatches = 0;
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            Mismatches += !ColorsMatch(ColorVector[Index], ColorScalar[Index]) ? 1 : 0;
+        }
+        TestEqual(FString::Printf(TEXT("%s: FColor gather matches scalar reference within one sRGB step"), *Label), Mismatches, 0);
+    }
+
+    FOmniCaptureProjectionSample Invalid;
+    FColor InvalidColor = FColor::White;
+    FOmniCaptureCubemapSampler::GatherRow(Cubemap.GetView(EOmniCaptureCPUFilter::Nearest), &Invalid, 1, &InvalidColor);
+    TestTrue(TEXT("Invalid samples resolve to transparent"), InvalidColor == FColor::Transparent);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapDataLayerGatherTest, "OmniCapture.CubemapSampler.GathersDataLayers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCubemapDataLayerGatherTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 Resolution = 17;
+    constexpr int32 Count = 1031;
+
+    FRandomStream Random(0xDA7A);
+    const FTestCubemap Cubemap(Resolution, Random);
+
+    // Single-channel faces as depth is read back: the red channel of the colour faces, one float per texel.
+    TArray<float> ScalarFaces[6];
+    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    {
+        ScalarFaces[FaceIndex].SetNumUninitialized(Resolution * Resolution);
+        for (int32 Index = 0; Index < ScalarFaces[FaceIndex].Num(); ++Index)
+        {
+            ScalarFaces[FaceIndex][Index] = Cubemap.Faces[FaceIndex][Index].R;
+        }
+    }
+
+    for (EOmniCaptureCPUFilter Filter : { EOmniCaptureCPUFilter::Nearest, EOmniCaptureCPUFilter::Bilinear, EOmniCaptureCPUFilter::Bicubic })
+    {
+        const FOmniCaptureCubemapView ColorView = Cubemap.GetView(Filter);
+        FOmniCaptureCubemapView ScalarView = ColorView;
+        ScalarView.bScalarTexels = true;
+        for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+        {
+            ScalarView.Faces[FaceIndex] = ScalarFaces[FaceIndex].GetData();
+        }
+
+        const TArray<FOmniCaptureProjectionSample> Samples = MakeRandomSamples(Count, Resolution, Filter, Random);
+        const float Tolerance = Filter == EOmniCaptureCPUFilter::Nearest ? 0.0f : 1.0e-4f;
+
+        TArray<FLinearColor> Colors;
+        TArray<float> Values, ScalarValues, ReferenceValues;
+        TArray<FVector2f> Vectors, ReferenceVectors;
+        Colors.SetNumZeroed(Count);
+        Values.SetNumZeroed(Count);
+        ScalarValues.SetNumZeroed(Count);
+        ReferenceValues.SetNumZeroed(Count);
+        Vectors.SetNumZeroed(Count);
+        ReferenceVectors.SetNumZeroed(Count);
+        FOmniCaptureCubemapSampler::GatherRow(ColorView, Samples.GetData(), Count, Colors.GetData());
+        FOmniCaptureCubemapSampler::GatherRow(ColorView, Samples.GetData(), Count, Values.GetData());
+        FOmniCaptureCubemapSampler::GatherRow(ColorView, Samples.GetData(), Count, Vectors.GetData());
+        FOmniCaptureCubemapSampler::GatherRowScalar(ColorView, Samples.GetData(), Count, ReferenceVectors.GetData());
+        FOmniCaptureCubemapSampler::GatherRow(ScalarView, Samples.GetData(), Count, ScalarValues.GetData());
+        FOmniCaptureCubemapSampler::GatherRowScalar(ScalarView, Samples.GetData(), Count, ReferenceValues.GetData());
+
+        int32 ChannelMismatches = 0;
+        int32 ScalarFaceMismatches = 0;
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            ChannelMismatches += (Values[Index] != Colors[Index].R || Vectors[Index] != FVector2f(Colors[Index].R, Colors[Index].G)) ? 1 : 0;
+            ChannelMismatches += !Vectors[Index].Equals(ReferenceVectors[Index], Tolerance) ? 1 : 0;
+            ScalarFaceMismatches += (!FMath::IsNearlyEqual(ScalarValues[Index], ReferenceValues[Index], Tolerance) || !FMath::IsNearlyEqual(ScalarValues[Index], Colors[Index].R, Tolerance)) ? 1 : 0;
+        }
+        TestEqual(FString::Printf(TEXT("%s: data layers keep the leading channels of the colour gather"), GetFilterName(Filter)), ChannelMismatches, 0);
+        TestEqual(FString::Printf(TEXT("%s: single-channel faces gather like the channel they hold"), GetFilterName(Filter)), ScalarFaceMismatches, 0);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapParallelProjectionTest, "OmniCapture.CubemapSampler.ParallelProjectionMatchesSerial", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCubemapParallelProjectionTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 Resolution = 32;
+    // Neither eye dimension is a whole number of row bands or gather runs, so the partial tiles are covered too.
+    const FIntPoint EyeSize(523, 101);
+
+    FRandomStream Random(0x7A11);
+    const FTestCubemap LeftCubemap(Resolution, Random);
+    const FTestCubemap RightCubemap(Resolution, Random);
+    const FString Directory = OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureCubemapSampler"), TEXT("ParallelProjection"));
+
+    FOmniCaptureSettings Settings;
+    Settings.Mode = EOmniCaptureMode::Stereo;
+    Settings.CPUFallbackFilter = EOmniCaptureCPUFilter::Bilinear;
+    Settings.ImageFormat = EOmniCaptureImageFormat::PNG;
+    Settings.PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth8;
+    const FOmniCaptureProjectionLUT LUT(FOmniCaptureProjectionKey::MakeEquirect(Settings, Resolution, EyeSize));
+
+    for (EOmniCaptureStereoLayout Layout : { EOmniCaptureStereoLayout::TopBottom, EOmniCaptureStereoLayout::SideBySide })
+    {
+        const bool bSideBySide = Layout == EOmniCaptureStereoLayout::SideBySide;
+        const TCHAR* LayoutName = bSideBySide ? TEXT("SideBySide") : TEXT("TopBottom");
+        const FIntPoint OutputSize = bSideBySide ? FIntPoint(EyeSize.X * 2, EyeSize.Y) : FIntPoint(EyeSize.X, EyeSize.Y * 2);
+
+        // The same frame converted on one thread and on the task graph, then written the same way.
+        TArray<FString> FileNames;
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(Settings, Directory);
+        for (const bool bParallel : { false, true })
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = OmniCaptureTests::MakeColor8Frame(OutputSize, 0, FColor::Magenta);
+
+            FOmniCaptureGatherLayer Layer;
+            Layer.Left = LeftCubemap.GetView(Settings.CPUFallbackFilter);
+            Layer.Right = RightCubemap.GetView(Settings.CPUFallbackFilter);
+            Layer.PixelDataType = EOmniCapturePixelDataType::Color8;
+            Layer.Pixels = OmniCaptureTests::GetColor8Pixels(*Frame).GetData();
+            FOmniCaptureCubemapSampler::GatherProjection(LUT, MakeArrayView(&Layer, 1), true, bSideBySide, OutputSize, bParallel);
+
+            FileNames.Add(FString::Printf(TEXT("%s_%s.png"), LayoutName, bParallel ? TEXT("Parallel") : TEXT("Serial")));
+            Writer.EnqueueFrame(MoveTemp(Frame), FileNames.Last());
+        }
+        Writer.Flush();
+
+        TArray<uint8> SerialBytes;
+        TArray<uint8> ParallelBytes;
+        const bool bLoaded = FFileHelper::LoadFileToArray(SerialBytes, *(Directory / FileNames[0])) && FFileHelper::LoadFileToArray(ParallelBytes, *(Directory / FileNames[1]));
+        TestTrue(FString::Printf(TEXT("%s: both frames were written"), LayoutName), bLoaded && SerialBytes.Num() > 0);
+        TestTrue(FString::Printf(TEXT("%s: the parallel conversion writes the same bytes as the serial one"), LayoutName), SerialBytes == ParallelBytes);
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapBilinearSeamTest, "OmniCapture.CubemapSampler.BilinearReadsAcrossSeams", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureCubemapBilinearSeamTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 Resolution = 8;
+
+    // Paint every face with its own index so the blend weights across a seam can be read back directly.
+    TArray<FLinearColor> Faces[6];
+    const FOmniCaptureCubeSeamTable SeamTable(Resolution);
+    FOmniCaptureCubemapView View;
+    View.Resolution = Resolution;
+    View.Filter = EOmniCaptureCPUFilter::Bilinear;
+    View.SeamTable = &SeamTable;
+    for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+    {
+        Faces[FaceIndex].Init(FLinearColor(static_cast<float>(FaceIndex), 0.0f, 0.0f, 1.0f), Resolution * Resolution);
+        View.Faces[FaceIndex] = Faces[FaceIndex].GetData();
+    }
+
+    // Exactly on the left edge of +X, which borders +Z: half of each face.
+    FOmniCaptureProjectionSample EdgeSample;
+    EdgeSample.PackedX = (0u << 24) | 0u;
+    EdgeSample.PackedY = static_cast<uint32>(Resolution / 2) << FOmniCaptureProjectionSample::FractionBits;
+
+    // The centre of the first texel on +X: no contribution from the neighbour.
+    FOmniCaptureProjectionSample CentreSample;
+    CentreSample.PackedX = (0u << 24) | (1u << (FOmniCaptureProjectionSample::FractionBits - 1));
+    CentreSample.PackedY = EdgeSample.PackedY;
+
+    FLinearColor EdgeColor;
+    FLinearColor CentreColor;
+    FOmniCaptureCubemapSampler::GatherRow(View, &EdgeSample, 1, &EdgeColor);
+    FOmniCaptureCubemapSampler::GatherRow(View, &CentreSample, 1, &CentreColor);
+
+    TestEqual(TEXT("Face edge blends evenly with the neighbouring face"), EdgeColor.R, 2.0f, 1.0e-5f);
+    TestEqual(TEXT("Texel centre next to the seam is unaffected by the neighbour"), CentreColor.R, 0.0f, 1.0e-5f);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapGatherThroughputTest, "OmniCapture.CubemapSampler.GatherThroughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureCubemapGatherThroughputTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 FaceResolution = 1024;
+
+    FRandomStream Random(0x5EED);
+    const FTestCubemap Cubemap(FaceResolution, Random);
+    const FOmniCaptureCubemapView View = Cubemap.GetView(EOmniCaptureCPUFilter::Nearest);
+
+    FOmniCaptureSettings Settings;
+    const FOmniCaptureProjectionLUT LUT(FOmniCaptureProjectionKey::MakeEquirect(Settings, FaceResolution, FIntPoint(FaceResolution * 4, FaceResolution * 2)));
+    const FIntPoint EyeResolution = LUT.GetEyeResolution();
+    const int32 PixelCount = EyeResolution.X * EyeResolution.Y;
+
+    auto Report = [this](const TCHAR* Format, double VectorRate, double ScalarRate)
+    {
+        AddInfo(FString::Printf(TEXT("%s: %.1f MP/s vector, %.1f MP/s scalar (%.2fx)"), Format, VectorRate, ScalarRate, VectorRate / FMath::Max(ScalarRate, 1.0e-9)));
+    };
+
+    {
+        TArray<FLinearColor> Pixels;
+        Pixels.SetNumUninitialized(PixelCount);
+        const double ScalarRate = MeasureMegapixelsPerSecond(View, LUT, true, Pixels);
+        Report(TEXT("FLinearColor"), MeasureMegapixelsPerSecond(View, LUT, false, Pixels), ScalarRate);
+    }
+    {
+        TArray<FFloat16Color> Pixels;
+        Pixels.SetNumUninitialized(PixelCount);
+        const double ScalarRate = MeasureMegapixelsPerSecond(View, LUT, true, Pixels);
+        Report(TEXT("FFloat16Color"), MeasureMegapixelsPerSecond(View, LUT, false, Pixels), ScalarRate);
+    }
+    {
+        TArray<FColor> Pixels;
+        Pixels.SetNumUninitialized(PixelCount);
+        const double ScalarRate = MeasureMegapixelsPerSecond(View, LUT, true, Pixels);
+        Report(TEXT("FColor"), MeasureMegapixelsPerSecond(View, LUT, false, Pixels), ScalarRate);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapFilterThroughputTest, "OmniCapture.CubemapSampler.FilterThroughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureCubemapFilterThroughputTest::RunTest(const FString& Parameters)
+{
+    // Filtered 1x faces against nearest 2x faces at the same equirect output size, gathering straight from half-float
+    // faces as the fallback does. The GPU render cost of 2x faces, roughly four times that of 1x faces, comes on top
+    // and is not measured.
+    constexpr int32 BaseResolution = 1024;
+    const FIntPoint EyeResolution(BaseResolution * 4, BaseResolution * 2);
+
+    FRandomStream Random(0xF117E5);
+    FOmniCaptureSettings Settings;
+
+    TArray<FColor> Pixels;
+    Pixels.SetNumUninitialized(EyeResolution.X * EyeResolution.Y);
+
+    auto MeasureMilliseconds = [&](int32 FaceResolution, EOmniCaptureCPUFilter Filter)
+    {
+        const FTestCubemap Cubemap(FaceResolution, Random);
+        Settings.CPUFallbackFilter = Filter;
+        const FOmniCaptureProjectionLUT LUT(FOmniCaptureProjectionKey::MakeEquirect(Settings, FaceResolution, EyeResolution));
+        const FOmniCaptureCubemapView View = Cubemap.GetView(Filter, EOmniCapturePixelPrecision::HalfFloat);
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        ParallelFor(EyeResolution.Y, [&](int32 Y)
+        {
+            const int64 Offset = static_cast<int64>(Y) * EyeResolution.X;
+            FOmniCaptureCubemapSampler::GatherRow(View, LUT.GetRow(Y), EyeResolution.X, Pixels.GetData() + Offset);
+        });
+        const double EndSeconds = FPlatformTime::Seconds();
+
+        AddInfo(FString::Printf(TEXT("%s, %d faces: %.2f ms gather"), GetFilterName(Filter), FaceResolution, (EndSeconds - StartSeconds) * 1000.0));
+        return (EndSeconds - StartSeconds) * 1000.0;
+    };
+
+    const double NearestDoubleMs = MeasureMilliseconds(BaseResolution * 2, EOmniCaptureCPUFilter::Nearest);
+    const double BilinearMs = MeasureMilliseconds(BaseResolution, EOmniCaptureCPUFilter::Bilinear);
+    const double BicubicMs = MeasureMilliseconds(BaseResolution, EOmniCaptureCPUFilter::Bicubic);
+
+    AddInfo(FString::Printf(TEXT("Bilinear 1x is %.2fx the CPU cost of nearest 2x; bicubic 1x is %.2fx"), BilinearMs / FMath::Max(NearestDoubleMs, 1.0e-9), BicubicMs / FMath::Max(NearestDoubleMs, 1.0e-9)));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureCubemapNativeHalfStorageTest, "OmniCapture.CubemapSampler.NativeHalfStorage", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureCubemapNativeHalfStorageTest::RunTest(const FString& Parameters)
+{
+    // A stereo half-float frame as the fallback sees it: twelve read-back faces converted to a half-float equirect.
+    // The widened path reproduces the old behaviour of expanding every face to FLinearColor before gathering.
+    constexpr int32 FaceResolution = 1024;
+    const FIntPoint EyeResolution(FaceResolution * 4, FaceResolution * 2);
+    const int32 FacePixelCount = FaceResolution * FaceResolution;
+
+    FRandomStream Random(0x4A1F);
+    const FTestCubemap LeftCubemap(FaceResolution, Random);
+    const FTestCubemap RightCubemap(FaceResolution, Random);
+
+    FOmniCaptureSettings Settings;
+    const FOmniCaptureProjectionLUT LUT(FOmniCaptureProjectionKey::MakeEquirect(Settings, FaceResolution, EyeResolution));
+
+    TArray<FFloat16Color> Pixels;
+    Pixels.SetNumUninitialized(EyeResolution.X * EyeResolution.Y);
+
+    auto GatherEye = [&](const FOmniCaptureCubemapView& View)
+    {
+        ParallelFor(EyeResolution.Y, [&](int32 Y)
+        {
+            const int64 Offset = static_cast<int64>(Y) * EyeResolution.X;
+            FOmniCaptureCubemapSampler::GatherRow(View, LUT.GetRow(Y), EyeResolution.X, Pixels.GetData() + Offset);
+        });
+    };
+
+    double WidenedMs = 0.0;
+    {
+        TArray<FLinearColor> WidenedFaces[2][6];
+
+        const double StartSeconds = FPlatformTime::Seconds();
+        const FTestCubemap* Cubemaps[2] = { &LeftCubemap, &RightCubemap };
+        for (int32 EyeIndex = 0; EyeIndex < 2; ++EyeIndex)
+        {
+            FOmniCaptureCubemapView View = Cubemaps[EyeIndex]->GetView(EOmniCaptureCPUFilter::Nearest);
+            for (int32 FaceIndex = 0; FaceIndex < 6; ++FaceIndex)
+            {
+                const TArray<FFloat16Color>& HalfFace = Cubemaps[EyeIndex]->HalfFaces[FaceIndex];
+                TArray<FLinearColor>& WidenedFace = WidenedFaces[EyeIndex][FaceIndex];
+                WidenedFace.SetNumUninitialized(FacePixelCount);
+                for (int32 Index = 0; Index < FacePixelCount; ++Index)
+                {
+                    WidenedFace[Index] = FLinearColor(HalfFace[Index]);
+                }
+                View.Faces[FaceIndex] = WidenedFace.GetData();
+            }
+            GatherEye(View);
+        }
+        WidenedMs = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+    }
+
+    const double NativeStartSeconds = FPlatformTime::Seconds();
+    GatherEye(LeftCubemap.GetView(EOmniCaptureCPUFilter::Nearest, EOmniCapturePixelPrecision::HalfFloat));
+    GatherEye(RightCubemap.GetView(EOmniCaptureCPUFilter::Nearest, EOmniCapturePixelPrecision::HalfFloat));
+    const double NativeMs = (FPlatformTime::Seconds() - NativeStartSeconds) * 1000.0;
+
+    // The widened path keeps the half-float read-back alive alongside its FLinearColor copy.
+    const double FaceCount = 12.0;
+    const double HalfFaceMB = FaceCount * FacePixelCount * sizeof(FFloat16Color) / (1024.0 * 1024.0);
+    const double WidenedFaceMB = HalfFaceMB + FaceCount * FacePixelCount * sizeof(FLinearColor) / (1024.0 * 1024.0);
+
+    AddInfo(FString::Printf(TEXT("Widened faces: %.2f ms, %.1f MB of face storage"), WidenedMs, WidenedFaceMB));
+    AddInfo(FString::Printf(TEXT("Native half faces: %.2f ms, %.1f MB of face storage (%.2fx faster)"), NativeMs, HalfFaceMB, WidenedMs / FMath::Max(NativeMs, 1.0e-9)));
+
+    return true;
+}
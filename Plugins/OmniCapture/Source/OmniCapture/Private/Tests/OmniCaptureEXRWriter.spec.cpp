@@ -0,0 +1,317 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+#include "OmniCaptureImageWriter.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureEXRConcurrencyTest, "OmniCapture.EXRWriter.ConcurrencyFillsCores", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureEXRConcurrencyTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.ImageFormat = EOmniCaptureImageFormat::EXR;
+    Settings.EXRCompression = EOmniCaptureEXRCompression::Zip;
+    Settings.MaxPendingImageTasks = 8;
+
+    FOmniCaptureEXRConcurrency Resolved = FOmniCaptureImageWriter::ResolveEXRConcurrency(Settings, 16);
+    TestEqual(TEXT("Auto mode splits 16 cores into frames"), Resolved.ConcurrentFrames, 4);
+    TestEqual(TEXT("Auto mode splits 16 cores into compression threads"), Resolved.CompressionThreads, 4);
+
+    Resolved = FOmniCaptureImageWriter::ResolveEXRConcurrency(Settings, 128);
+    TestEqual(TEXT("Concurrent frames never exceed the pending task limit"), Resolved.ConcurrentFrames, 8);
+    TestEqual(TEXT("Compression threads take up the remaining cores"), Resolved.CompressionThreads, 16);
+
+    Resolved = FOmniCaptureImageWriter::ResolveEXRConcurrency(Settings, 2);
+    TestEqual(TEXT("Small machines still write one frame"), Resolved.ConcurrentFrames, 1);
+    TestEqual(TEXT("Small machines compress on every core"), Resolved.CompressionThreads, 2);
+
+    Settings.EXRCompressionThreads = 8;
+    Resolved = FOmniCaptureImageWriter::ResolveEXRConcurrency(Settings, 16);
+    TestEqual(TEXT("Fixed compression threads leave the rest to frames"), Resolved.ConcurrentFrames, 2);
+    TestEqual(TEXT("Fixed compression threads are kept"), Resolved.CompressionThreads, 8);
+
+    Settings.EXRCompressionThreads = 0;
+    Settings.EXRConcurrentFrames = 3;
+    Resolved = FOmniCaptureImageWriter::ResolveEXRConcurrency(Settings, 16);
+    TestEqual(TEXT("Fixed frame parallelism is kept"), Resolved.ConcurrentFrames, 3);
+    TestEqual(TEXT("Fixed frame parallelism leaves the rest to compression"), Resolved.CompressionThreads, 5);
+
+    Settings.EXRConcurrentFrames = 0;
+    Settings.EXRCompression = EOmniCaptureEXRCompression::None;
+    Resolved = FOmniCaptureImageWriter::ResolveEXRConcurrency(Settings, 16);
+    TestEqual(TEXT("Uncompressed output writes as many frames as allowed"), Resolved.ConcurrentFrames, 8);
+    TestEqual(TEXT("Uncompressed output gets no compression threads"), Resolved.CompressionThreads, 1);
+
+    return true;
+}
+
+#if WITH_OMNICAPTURE_OPENEXR
+
+THIRD_PARTY_INCLUDES_START
+#include "OpenEXR/ImfFrameBuffer.h"
+#include "OpenEXR/ImfHeader.h"
+#include "OpenEXR/ImfTiledInputFile.h"
+THIRD_PARTY_INCLUDES_END
+
+namespace
+{
+    template <typename PixelType>
+    FOmniCaptureLayerPayload MakeLayer(const FIntPoint& Size, const PixelType& Value, EOmniCapturePixelPrecision Precision, EOmniCapturePixelDataType PixelDataType)
+    {
+        TUniquePtr<TImagePixelData<PixelType>> PixelData = MakeUnique<TImagePixelData<PixelType>>(Size);
+        PixelData->Pixels.Init(Value, static_cast<int64>(Size.X) * Size.Y);
+
+        FOmniCaptureLayerPayload Layer;
+        Layer.PixelData = MoveTemp(PixelData);
+        Layer.bLinear = true;
+        Layer.Precision = Precision;
+        Layer.PixelDataType = PixelDataType;
+        return Layer;
+    }
+
+    // Half-float beauty plus the float, scalar and vector layers the converters emit.
+    TUniquePtr<FOmniCaptureFrame> MakeLayeredFrame(const FIntPoint& Size, bool bIncludeColor8Layer)
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        FOmniCaptureLayerPayload Beauty = MakeLayer(Size, FFloat16Color(FLinearColor(0.25f, 0.5f, 0.75f, 1.0f)), EOmniCapturePixelPrecision::HalfFloat, EOmniCapturePixelDataType::LinearColorFloat16);
+        Frame->PixelData = MoveTemp(Beauty.PixelData);
+        Frame->bLinearColor = true;
+        Frame->PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
+        Frame->PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+
+        Frame->AuxiliaryLayers.Add(TEXT("Emissive"), MakeLayer(Size, FLinearColor(2.0f, 1.0f, 0.5f, 1.0f), EOmniCapturePixelPrecision::FullFloat, EOmniCapturePixelDataType::LinearColorFloat32));
+        Frame->AuxiliaryLayers.Add(TEXT("Depth"), MakeLayer(Size, 1234.5f, EOmniCapturePixelPrecision::FullFloat, EOmniCapturePixelDataType::ScalarFloat32));
+        Frame->AuxiliaryLayers.Add(TEXT("Motion"), MakeLayer(Size, FVector2f(0.5f, -0.5f), EOmniCapturePixelPrecision::FullFloat, EOmniCapturePixelDataType::Vector2Float32));
+        if (bIncludeColor8Layer)
+        {
+            Frame->AuxiliaryLayers.Add(TEXT("Mask"), MakeLayer(Size, FColor(255, 128, 0, 255), EOmniCapturePixelPrecision::Unknown, EOmniCapturePixelDataType::Color8));
+        }
+        return Frame;
+    }
+
+    FOmniCaptureSettings MakeEXRSettings(bool bZeroCopy)
+    {
+        FOmniCaptureSettings Settings;
+        Settings.ImageFormat = EOmniCaptureImageFormat::EXR;
+        Settings.bPackEXRAuxiliaryLayers = true;
+        Settings.bZeroCopyEXRLayers = bZeroCopy;
+        // Uncompressed, so the write time is dominated by what the writer does rather than by zlib.
+        Settings.EXRCompression = EOmniCaptureEXRCompression::None;
+        return Settings;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureEXRZeroCopyTest, "OmniCapture.EXRWriter.CombinedLayersAreNotCopied", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureEXRZeroCopyTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(64, 32);
+    const int64 PixelCount = static_cast<int64>(Size.X) * Size.Y;
+    const FString OutputDirectory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("OmniCaptureEXRZeroCopy"));
+
+    FOmniCaptureImageWriter Writer;
+    Writer.Initialize(MakeEXRSettings(true), OutputDirectory);
+    Writer.EnqueueFrame(MakeLayeredFrame(Size, true), TEXT("Layered.exr"));
+    Writer.Flush();
+
+    const FOmniCaptureEXRStagingStats Stats = Writer.GetEXRStagingStats();
+    const int64 ExpectedReferenced = PixelCount * (sizeof(FFloat16Color) + sizeof(FLinearColor) + sizeof(float) + sizeof(FVector2f));
+    TestTrue(TEXT("The combined EXR was written"), IFileManager::Get().FileExists(*FPaths::Combine(OutputDirectory, TEXT("Layered.exr"))));
+    TestEqual(TEXT("Float, half, scalar and vector layers are read in place"), Stats.ReferencedBytes, ExpectedReferenced);
+    TestEqual(TEXT("Only the 8-bit layer is converted"), Stats.StagedBytes, PixelCount * static_cast<int64>(sizeof(FLinearColor)));
+
+    IFileManager::Get().DeleteDirectory(*OutputDirectory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureTiledEXRTest, "OmniCapture.EXRWriter.TiledRipmapsRoundTrip", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureTiledEXRTest::RunTest(const FString& Parameters)
+{
+    using namespace OPENEXR_IMF_NAMESPACE;
+
+    // Not a multiple of the tile size, so edge tiles and odd level sizes are exercised.
+    const FIntPoint Size(100, 60);
+    const FString OutputDirectory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("OmniCaptureTiledEXR"));
+    const FString FilePath = FPaths::ConvertRelativePathToFull(FPaths::Combine(OutputDirectory, TEXT("Tiled.exr")));
+
+    FOmniCaptureSettings Settings = MakeEXRSettings(true);
+    Settings.EXRCompression = EOmniCaptureEXRCompression::Zip;
+    Settings.bWriteTiledEXR = true;
+    Settings.EXRTileSize = 32;
+    Settings.EXRTileLevels = EOmniCaptureEXRTileLevels::RipMaps;
+
+    FOmniCaptureImageWriter Writer;
+    Writer.Initialize(Settings, OutputDirectory);
+    Writer.EnqueueFrame(MakeLayeredFrame(Size, true), TEXT("Tiled.exr"));
+    Writer.Flush();
+
+    TestTrue(TEXT("8-bit layers are converted a tile row at a time"), Writer.GetEXRStagingStats().StagedBytes == static_cast<int64>(Settings.EXRTileSize) * Size.X * sizeof(FLinearColor));
+
+    try
+    {
+        TiledInputFile Input(TCHAR_TO_UTF8(*FilePath));
+        TestEqual(TEXT("Tile width"), static_cast<int32>(Input.tileXSize()), 32);
+        TestTrue(TEXT("Ripmap levels are written"), Input.levelMode() == RIPMAP_LEVELS);
+        TestEqual(TEXT("X levels"), Input.numXLevels(), 7);
+        TestEqual(TEXT("Y levels"), Input.numYLevels(), 6);
+
+        const auto ReadLevel = [&Input](const char* ChannelName, int32 LevelX, int32 LevelY)
+        {
+            const int32 Width = Input.levelWidth(LevelX);
+            const int32 Height = Input.levelHeight(LevelY);
+            TArray<float> Values;
+            Values.SetNumZeroed(Width * Height);
+            FrameBuffer Buffer;
+            Buffer.insert(ChannelName, Slice(PixelType::FLOAT, reinterpret_cast<char*>(Values.GetData()), sizeof(float), sizeof(float) * Width));
+            Input.setFrameBuffer(Buffer);
+            Input.readTiles(0, Input.numXTiles(LevelX) - 1, 0, Input.numYTiles(LevelY) - 1, LevelX, LevelY);
+            return Values;
+        };
+
+        const auto AllNear = [](const TArray<float>& Values, float Expected)
+        {
+            return Values.Num() > 0 && Values.FindByPredicate([Expected](float Value) { return !FMath::IsNearlyEqual(Value, Expected, 1e-3f); }) == nullptr;
+        };
+
+        TestTrue(TEXT("Half beauty survives at level 0"), AllNear(ReadLevel("Beauty.B", 0, 0), 0.75f));
+        TestTrue(TEXT("Float layer survives at level 0"), AllNear(ReadLevel("Emissive.R", 0, 0), 2.0f));
+        TestTrue(TEXT("Scalar layer survives at level 0"), AllNear(ReadLevel("Depth.R", 0, 0), 1234.5f));
+        TestTrue(TEXT("Vector layer survives at level 0"), AllNear(ReadLevel("Motion.G", 0, 0), -0.5f));
+        TestTrue(TEXT("8-bit layer is converted at level 0"), AllNear(ReadLevel("Mask.G", 0, 0), 128.0f / 255.0f));
+        TestTrue(TEXT("Ripmap levels filter one axis"), AllNear(ReadLevel("Emissive.R", 3, 0), 2.0f));
+        TestTrue(TEXT("Ripmap levels filter both axes"), AllNear(ReadLevel("Mask.G", 2, 4), 128.0f / 255.0f));
+    }
+    catch (const std::exception& Exception)
+    {
+        AddError(FString::Printf(TEXT("Reading the tiled EXR failed: %s"), UTF8_TO_TCHAR(Exception.what())));
+    }
+
+    IFileManager::Get().DeleteDirectory(*OutputDirectory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureEXRZeroCopyBenchmark, "OmniCapture.EXRWriter.ZeroCopySavings", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureEXRZeroCopyBenchmark::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(8192, 4096);
+    const int32 FrameCount = 4;
+    const FString OutputDirectory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("OmniCaptureEXRBenchmark"));
+
+    double MillisecondsPerFrame[2] = { 0.0, 0.0 };
+    double StagedMegaBytesPerFrame[2] = { 0.0, 0.0 };
+
+    for (const bool bZeroCopy : { false, true })
+    {
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(MakeEXRSettings(bZeroCopy), OutputDirectory);
+
+        double Seconds = 0.0;
+        for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeLayeredFrame(Size, false);
+            const double StartSeconds = FPlatformTime::Seconds();
+            Writer.EnqueueFrame(MoveTemp(Frame), FString::Printf(TEXT("Frame_%d.exr"), FrameIndex));
+            Writer.Flush();
+            Seconds += FPlatformTime::Seconds() - StartSeconds;
+        }
+
+        MillisecondsPerFrame[bZeroCopy] = Seconds * 1000.0 / FrameCount;
+        StagedMegaBytesPerFrame[bZeroCopy] = Writer.GetEXRStagingStats().StagedBytes / (1024.0 * 1024.0) / FrameCount;
+        AddInfo(FString::Printf(TEXT("%s: %.1f ms/frame, %.1f MB staged/frame"), bZeroCopy ? TEXT("Zero-copy") : TEXT("Staged"), MillisecondsPerFrame[bZeroCopy], StagedMegaBytesPerFrame[bZeroCopy]));
+    }
+
+    AddInfo(FString::Printf(TEXT("Saved per %dx%d frame: %.1f ms, %.1f MB"), Size.X, Size.Y,
+        MillisecondsPerFrame[0] - MillisecondsPerFrame[1], StagedMegaBytesPerFrame[0] - StagedMegaBytesPerFrame[1]));
+    TestEqual(TEXT("Zero-copy writes stage nothing for float layers"), StagedMegaBytesPerFrame[1], 0.0);
+
+    IFileManager::Get().DeleteDirectory(*OutputDirectory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureEXRCompressionBenchmark, "OmniCapture.EXRWriter.CompressionThroughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureEXRCompressionBenchmark::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(4096, 2048);
+    const int32 FrameCount = 8;
+    const int32 Cores = FPlatformMisc::NumberOfCoresIncludingHyperthreads();
+    const FString OutputDirectory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("OmniCaptureEXRCompression"));
+
+    // Smooth content with sensor-like noise, so the codecs land near their real-world ratios.
+    TArray64<FFloat16Color> Beauty;
+    Beauty.SetNumUninitialized(static_cast<int64>(Size.X) * Size.Y);
+    FRandomStream Random(Size.X);
+    for (int32 Y = 0; Y < Size.Y; ++Y)
+    {
+        for (int32 X = 0; X < Size.X; ++X)
+        {
+            const float Noise = Random.FRandRange(-0.01f, 0.01f);
+            Beauty[static_cast<int64>(Y) * Size.X + X] = FFloat16Color(FLinearColor(X / float(Size.X) + Noise, Y / float(Size.Y) + Noise, 0.5f + Noise, 1.0f));
+        }
+    }
+
+    struct FConfiguration
+    {
+        const TCHAR* Name;
+        int32 ConcurrentFrames;
+        int32 CompressionThreads;
+    };
+    const FConfiguration Configurations[] = {
+        { TEXT("auto"), 0, 0 },
+        { TEXT("frames only"), 0, 1 },
+        { TEXT("threads only"), 1, 0 },
+    };
+    const EOmniCaptureEXRCompression Compressions[] = {
+        EOmniCaptureEXRCompression::Zip,
+        EOmniCaptureEXRCompression::Piz,
+        EOmniCaptureEXRCompression::Dwaa,
+        EOmniCaptureEXRCompression::Dwab,
+    };
+
+    for (const EOmniCaptureEXRCompression Compression : Compressions)
+    {
+        for (const FConfiguration& Configuration : Configurations)
+        {
+            FOmniCaptureSettings Settings = MakeEXRSettings(true);
+            Settings.EXRCompression = Compression;
+            Settings.EXRConcurrentFrames = Configuration.ConcurrentFrames;
+            Settings.EXRCompressionThreads = Configuration.CompressionThreads;
+
+            FOmniCaptureImageWriter Writer;
+            Writer.Initialize(Settings, OutputDirectory);
+            const FOmniCaptureEXRConcurrency Concurrency = Writer.GetEXRConcurrency();
+
+            const double StartSeconds = FPlatformTime::Seconds();
+            for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+            {
+                TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+                TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = MakeUnique<TImagePixelData<FFloat16Color>>(Size);
+                PixelData->Pixels = Beauty;
+                Frame->PixelData = MoveTemp(PixelData);
+                Frame->bLinearColor = true;
+                Frame->PixelPrecision = EOmniCapturePixelPrecision::HalfFloat;
+                Frame->PixelDataType = EOmniCapturePixelDataType::LinearColorFloat16;
+                // A second layer keeps the frame on the packed OpenEXR path, where the concurrency settings apply.
+                Frame->AuxiliaryLayers.Add(TEXT("Depth"), MakeLayer(Size, 100.0f, EOmniCapturePixelPrecision::FullFloat, EOmniCapturePixelDataType::ScalarFloat32));
+                Writer.EnqueueFrame(MoveTemp(Frame), FString::Printf(TEXT("Frame_%d.exr"), FrameIndex));
+            }
+            Writer.Flush();
+            const double Seconds = FPlatformTime::Seconds() - StartSeconds;
+
+            int64 TotalBytes = 0;
+            for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+            {
+                TotalBytes += FMath::Max<int64>(0, IFileManager::Get().FileSize(*FPaths::Combine(OutputDirectory, FString::Printf(TEXT("Frame_%d.exr"), FrameIndex))));
+            }
+
+            AddInfo(FString::Printf(TEXT("%s, %s (%d frames x %d threads on %d cores): %.2f frames/s, %.1f MB/frame"),
+                *UEnum::GetDisplayValueAsText(Compression).ToString(), Configuration.Name, Concurrency.ConcurrentFrames, Concurrency.CompressionThreads, Cores,
+                FrameCount / FMath::Max(Seconds, 1e-6), TotalBytes / (1024.0 * 1024.0) / FrameCount));
+
+            IFileManager::Get().DeleteDirectory(*OutputDirectory, false, true);
+        }
+    }
+
+    return true;
+}
+
+#endif // WITH_OMNICAPTURE_OPENEXR
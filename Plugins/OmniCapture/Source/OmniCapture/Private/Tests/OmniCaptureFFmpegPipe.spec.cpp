@@ -0,0 +1,168 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "OmniCaptureFFmpegPipe.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    FString MakePipeTestDirectory(const TCHAR* Name)
+    {
+        const FString Directory = OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureFFmpegPipe"), Name);
+        IFileManager::Get().MakeDirectory(*Directory, true);
+        return Directory;
+    }
+
+    // Stands in for FFmpeg: a process that copies its stdin to OutputPath, optionally after sleeping so the queue fills.
+    void GetStubEncoder(const FString& OutputPath, bool bSlowStart, FString& OutBinary, FString& OutArguments)
+    {
+#if PLATFORM_WINDOWS
+        OutBinary = TEXT("powershell.exe");
+        OutArguments = FString::Printf(TEXT("-NoProfile -Command \"%s$i=[Console]::OpenStandardInput(); $o=[IO.File]::Create('%s'); $i.CopyTo($o); $o.Close()\""),
+            bSlowStart ? TEXT("Start-Sleep -Seconds 1; ") : TEXT(""), *OutputPath);
+#else
+        OutBinary = TEXT("/bin/sh");
+        OutArguments = FString::Printf(TEXT("-c \"%scat > '%s'\""), bSlowStart ? TEXT("sleep 1; ") : TEXT(""), *OutputPath);
+#endif
+    }
+
+    // Stands in for an encoder that hangs: it never reads its stdin and outlives any reasonable wait.
+    void GetHungEncoder(FString& OutBinary, FString& OutArguments)
+    {
+#if PLATFORM_WINDOWS
+        OutBinary = TEXT("powershell.exe");
+        OutArguments = TEXT("-NoProfile -Command \"Start-Sleep -Seconds 60\"");
+#else
+        OutBinary = TEXT("/bin/sh");
+        OutArguments = TEXT("-c \"sleep 60\"");
+#endif
+    }
+
+    FOmniCaptureSharedFrame MakePipeTestFrame(const FIntPoint& Size, int32 FrameIndex)
+    {
+        return MakeShareable(OmniCaptureTests::MakeColor8Frame(Size, FrameIndex, FColor(static_cast<uint8>(FrameIndex), 32, 64, 255)).Release());
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFFmpegPipeRoundTripTest, "OmniCapture.FFmpegPipe.StreamsEveryFrame", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFFmpegPipeRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakePipeTestDirectory(TEXT("RoundTrip"));
+    const FString OutputPath = Directory / TEXT("stream.raw");
+    const FIntPoint Size(16, 8);
+    constexpr int32 FrameCount = 10;
+
+    FString Binary;
+    FString Arguments;
+    GetStubEncoder(OutputPath, false, Binary, Arguments);
+
+    FOmniCaptureFFmpegPipe Pipe;
+    if (!TestTrue(TEXT("The stub encoder starts"), Pipe.Start(Binary, Arguments, Directory, Size, EOmniCapturePixelDataType::Color8, 2)))
+    {
+        return false;
+    }
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        TestTrue(TEXT("Frames are accepted"), Pipe.PushFrame(MakePipeTestFrame(Size, FrameIndex)));
+    }
+    // A frame of another size would misalign the raw stream, so it is skipped rather than sent.
+    Pipe.PushFrame(MakePipeTestFrame(FIntPoint(4, 4), FrameCount));
+    TestTrue(TEXT("The stub encoder exits cleanly"), Pipe.WaitForExit());
+
+    const FOmniCaptureFFmpegPipeStats Stats = Pipe.GetStats();
+    const int64 FrameBytes = static_cast<int64>(Size.X) * Size.Y * sizeof(FColor);
+    TestEqual(TEXT("Every matching frame is written"), Stats.FramesWritten, FrameCount);
+    TestEqual(TEXT("The mismatched frame is skipped"), Stats.SkippedFrames, 1);
+    TestEqual(TEXT("Bytes are counted"), Stats.BytesWritten, FrameBytes * FrameCount);
+    TestFalse(TEXT("A closed pipe takes no frames"), Pipe.PushFrame(MakePipeTestFrame(Size, 0)));
+
+    TArray<uint8> Written;
+    TestTrue(TEXT("The stream reaches the encoder"), FFileHelper::LoadFileToArray(Written, *OutputPath));
+    TestEqual(TEXT("The encoder reads every byte"), static_cast<int64>(Written.Num()), FrameBytes * FrameCount);
+    if (Written.Num() == FrameBytes * FrameCount)
+    {
+        for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+        {
+            const FColor* First = reinterpret_cast<const FColor*>(Written.GetData() + FrameBytes * FrameIndex);
+            TestEqual(TEXT("Frames arrive in order"), static_cast<int32>(First->R), FrameIndex);
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFFmpegPipeBackpressureTest, "OmniCapture.FFmpegPipe.BlocksWhenEncoderFallsBehind", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFFmpegPipeBackpressureTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakePipeTestDirectory(TEXT("Backpressure"));
+    const FString OutputPath = Directory / TEXT("stream.raw");
+    // Larger than an OS pipe buffer, so a stub that is not reading yet stalls the writer thread on the first frame.
+    const FIntPoint Size(256, 256);
+    constexpr int32 FrameCount = 8;
+    constexpr int32 QueueFrames = 2;
+
+    FString Binary;
+    FString Arguments;
+    GetStubEncoder(OutputPath, true, Binary, Arguments);
+
+    FOmniCaptureFFmpegPipe Pipe;
+    if (!TestTrue(TEXT("The stub encoder starts"), Pipe.Start(Binary, Arguments, Directory, Size, EOmniCapturePixelDataType::Color8, QueueFrames)))
+    {
+        return false;
+    }
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        TestTrue(TEXT("Frames are accepted"), Pipe.PushFrame(MakePipeTestFrame(Size, FrameIndex)));
+    }
+    TestTrue(TEXT("The stub encoder exits cleanly"), Pipe.WaitForExit());
+
+    const FOmniCaptureFFmpegPipeStats Stats = Pipe.GetStats();
+    TestTrue(TEXT("A slow encoder pushes back on the producer"), Stats.BlockedPushes > 0);
+    TestEqual(TEXT("No frame is lost while waiting"), Stats.FramesWritten, FrameCount);
+    TestEqual(TEXT("The encoder reads every byte"), IFileManager::Get().FileSize(*OutputPath), static_cast<int64>(Size.X) * Size.Y * sizeof(FColor) * FrameCount);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFFmpegPipeFormatTest, "OmniCapture.FFmpegPipe.RawPixelFormats", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFFmpegPipeFormatTest::RunTest(const FString& Parameters)
+{
+    TestEqual(TEXT("8-bit frames go as BGRA"), FString(FOmniCaptureFFmpegPipe::GetRawPixelFormat(EOmniCapturePixelDataType::Color8)), FString(TEXT("bgra")));
+    TestEqual(TEXT("Half floats go as 16-bit RGBA"), FString(FOmniCaptureFFmpegPipe::GetRawPixelFormat(EOmniCapturePixelDataType::LinearColorFloat16)), FString(TEXT("rgba64le")));
+    TestEqual(TEXT("Floats go as 16-bit RGBA"), FString(FOmniCaptureFFmpegPipe::GetRawPixelFormat(EOmniCapturePixelDataType::LinearColorFloat32)), FString(TEXT("rgba64le")));
+    TestNull(TEXT("Scalar layers cannot be streamed"), FOmniCaptureFFmpegPipe::GetRawPixelFormat(EOmniCapturePixelDataType::ScalarFloat32));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFFmpegPipeTimeoutTest, "OmniCapture.FFmpegPipe.GivesUpOnHungEncoder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFFmpegPipeTimeoutTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakePipeTestDirectory(TEXT("Timeout"));
+    // Larger than an OS pipe buffer, so the writer thread is stuck on it while the encoder is not reading.
+    const FIntPoint Size(256, 256);
+
+    FString Binary;
+    FString Arguments;
+    GetHungEncoder(Binary, Arguments);
+
+    FOmniCaptureFFmpegPipe Pipe;
+    if (!TestTrue(TEXT("The stub encoder starts"), Pipe.Start(Binary, Arguments, Directory, Size, EOmniCapturePixelDataType::Color8, 2)))
+    {
+        return false;
+    }
+    Pipe.PushFrame(MakePipeTestFrame(Size, 0));
+
+    const double StartTime = FPlatformTime::Seconds();
+    TestFalse(TEXT("A hung encoder is a failed encode"), Pipe.WaitForExit(0.5));
+    TestTrue(TEXT("The wait ends near the timeout, not when the encoder would have"), FPlatformTime::Seconds() - StartTime < 30.0);
+    TestFalse(TEXT("The pipe no longer runs"), Pipe.IsRunning());
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
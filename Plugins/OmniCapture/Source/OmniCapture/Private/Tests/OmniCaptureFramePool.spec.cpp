@@ -0,0 +1,70 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCaptureFramePool.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFramePoolRecycleTest, "OmniCapture.FramePool.RecyclesReleasedFrames", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFramePoolRecycleTest::RunTest(const FString& Parameters)
+{
+    const TSharedRef<FOmniCaptureFramePool, ESPMode::ThreadSafe> Pool = MakeShared<FOmniCaptureFramePool, ESPMode::ThreadSafe>();
+    const FIntPoint Size(64, 32);
+
+    const void* FirstStorage = nullptr;
+    {
+        // The frame owns its pixels through the base type, like every writer and encoder does.
+        FOmniCaptureFrame Frame;
+        TUniquePtr<TImagePixelData<FFloat16Color>> PixelData = Pool->Acquire<FFloat16Color>(Size);
+        TestEqual(TEXT("Acquire sizes the pixels"), PixelData->Pixels.Num(), static_cast<int64>(Size.X * Size.Y));
+        FirstStorage = PixelData->Pixels.GetData();
+        Frame.PixelData = MoveTemp(PixelData);
+        TestEqual(TEXT("Held by the frame"), Pool->GetStats().OutstandingBuffers, 1);
+    }
+
+    FOmniCaptureFramePoolStats Stats = Pool->GetStats();
+    TestEqual(TEXT("Destroying the frame returned its buffer"), Stats.OutstandingBuffers, 0);
+    TestEqual(TEXT("Returned buffer waits for reuse"), Stats.IdleBuffers, 1);
+
+    TUniquePtr<TImagePixelData<FFloat16Color>> Reused = Pool->Acquire<FFloat16Color>(Size);
+    TestTrue(TEXT("Same size and format reuses the storage"), Reused->Pixels.GetData() == FirstStorage);
+
+    // A different format or size is a different key.
+    TUniquePtr<TImagePixelData<FLinearColor>> OtherFormat = Pool->Acquire<FLinearColor>(Size);
+    TUniquePtr<TImagePixelData<FFloat16Color>> OtherSize = Pool->Acquire<FFloat16Color>(FIntPoint(32, 32));
+
+    Stats = Pool->GetStats();
+    TestEqual(TEXT("One hit"), Stats.Hits, static_cast<int64>(1));
+    TestEqual(TEXT("Three misses"), Stats.Misses, static_cast<int64>(3));
+    TestEqual(TEXT("Three buffers out"), Stats.OutstandingBuffers, 3);
+    TestEqual(TEXT("High water tracks the peak"), Stats.HighWaterBuffers, 3);
+    TestEqual(TEXT("Outstanding bytes"), Stats.OutstandingBytes, static_cast<int64>(Size.X * Size.Y * (sizeof(FFloat16Color) + sizeof(FLinearColor)) + 32 * 32 * sizeof(FFloat16Color)));
+
+    Reused.Reset();
+    OtherFormat.Reset();
+    OtherSize.Reset();
+    Pool->Trim();
+
+    Stats = Pool->GetStats();
+    TestEqual(TEXT("Nothing outstanding"), Stats.OutstandingBuffers, 0);
+    TestEqual(TEXT("Trim frees idle buffers"), Stats.IdleBytes, static_cast<int64>(0));
+    TestEqual(TEXT("High water survives trimming"), Stats.HighWaterBuffers, 3);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureFramePoolMovedPixelsTest, "OmniCapture.FramePool.MovedOutPixelsAreNotRecycled", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureFramePoolMovedPixelsTest::RunTest(const FString& Parameters)
+{
+    const TSharedRef<FOmniCaptureFramePool, ESPMode::ThreadSafe> Pool = MakeShared<FOmniCaptureFramePool, ESPMode::ThreadSafe>();
+    const FIntPoint Size(16, 16);
+
+    TUniquePtr<FImagePixelData> PixelData = Pool->Acquire<FColor>(Size);
+    // The engine's image write path may steal the pixels into a plain TImagePixelData.
+    TUniquePtr<FImagePixelData> Moved = PixelData->Move();
+    PixelData.Reset();
+
+    const FOmniCaptureFramePoolStats Stats = Pool->GetStats();
+    TestEqual(TEXT("The emptied buffer is no longer outstanding"), Stats.OutstandingBuffers, 0);
+    TestEqual(TEXT("Nothing usable went back to the pool"), Stats.IdleBuffers, 0);
+    TestTrue(TEXT("The moved pixels are intact"), Moved.IsValid() && static_cast<TImagePixelData<FColor>*>(Moved.Get())->Pixels.Num() == Size.X * Size.Y);
+
+    return true;
+}
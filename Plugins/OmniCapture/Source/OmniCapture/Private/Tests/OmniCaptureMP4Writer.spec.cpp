@@ -0,0 +1,340 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NVENC/NVENCAnnexB.h"
+#include "OmniCaptureMP4Writer.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    using OmniNVENC::FNVENCAnnexB;
+
+    // Parameter sets as NVENC emits them: a 4-byte start code before each.
+    const TArray<uint8> H264SPS = { 0x67, 0x42, 0xC0, 0x1E, 0xDA, 0x02, 0x80 };
+    const TArray<uint8> H264PPS = { 0x68, 0xCE, 0x3C, 0x80 };
+    // Main10 SPS, 64x32, level 5.1. Its constraint flags are mostly zero, so it carries emulation prevention bytes.
+    const TArray<uint8> HEVCSPS = { 0x42, 0x01, 0x01, 0x02, 0x60, 0x00, 0x00, 0x03, 0x00, 0x90, 0x00, 0x00, 0x03, 0x00, 0x00, 0x03, 0x00, 0x99, 0xA0, 0x20, 0x82, 0x13, 0x70 };
+    const TArray<uint8> HEVCVPS = { 0x40, 0x01, 0x0C, 0x01, 0xFF, 0xFF };
+    const TArray<uint8> HEVCPPS = { 0x44, 0x01, 0xC1, 0x72, 0xB4, 0x62, 0x40 };
+
+    void AppendNAL(TArray<uint8>& Stream, const TArray<uint8>& Unit, bool bLongStartCode = true)
+    {
+        if (bLongStartCode)
+        {
+            Stream.Add(0);
+        }
+        Stream.Append({ 0, 0, 1 });
+        Stream.Append(Unit);
+    }
+
+    uint32 ReadU32(const TArray<uint8>& Bytes, int64 Offset)
+    {
+        return (static_cast<uint32>(Bytes[Offset]) << 24) | (static_cast<uint32>(Bytes[Offset + 1]) << 16) | (static_cast<uint32>(Bytes[Offset + 2]) << 8) | Bytes[Offset + 3];
+    }
+
+    bool IsBoxType(const TArray<uint8>& Bytes, int64 Offset, const char* Type)
+    {
+        return Offset + 8 <= Bytes.Num() && FMemory::Memcmp(Bytes.GetData() + Offset + 4, Type, 4) == 0;
+    }
+
+    // Offset of the first box of Type inside [Start, End), or INDEX_NONE. A plain byte search; the synthetic payloads avoid box names.
+    int64 FindBox(const TArray<uint8>& Bytes, int64 Start, int64 End, const char* Type)
+    {
+        for (int64 Offset = Start; Offset + 8 <= End; ++Offset)
+        {
+            if (FMemory::Memcmp(Bytes.GetData() + Offset + 4, Type, 4) == 0)
+            {
+                return Offset;
+            }
+        }
+        return INDEX_NONE;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAnnexBSplitTest, "OmniCapture.MP4Writer.SplitsAnnexB", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAnnexBSplitTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Stream;
+    AppendNAL(Stream, { 0x09, 0xF0 });
+    AppendNAL(Stream, H264SPS);
+    AppendNAL(Stream, H264PPS, false);
+    AppendNAL(Stream, { 0x65, 0x88, 0x84, 0x21 });
+    Stream.Append({ 0, 0 }); // trailing_zero_8bits
+
+    TArray<TArrayView<const uint8>> Units;
+    FNVENCAnnexB::SplitNALUnits(Stream.GetData(), Stream.Num(), Units);
+    if (TestEqual(TEXT("3 and 4 byte start codes both split"), Units.Num(), 4))
+    {
+        TestEqual(TEXT("Units exclude start codes"), static_cast<int32>(Units[1][0]), 0x67);
+        TestEqual(TEXT("The short start code does not eat the previous unit"), Units[1].Num(), H264SPS.Num());
+        TestEqual(TEXT("Trailing zeros are not part of the last unit"), Units[3].Num(), 4);
+    }
+
+    TArray<uint8> Sample;
+    FNVENCAnnexB::ToLengthPrefixed(Stream.GetData(), Stream.Num(), false, Sample);
+    const TArray<uint8> Expected = { 0, 0, 0, 4, 0x65, 0x88, 0x84, 0x21 };
+    TestTrue(TEXT("Only the slice remains, length prefixed"), Sample == Expected);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureAVCConfigTest, "OmniCapture.MP4Writer.BuildsAVCDecoderConfiguration", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureAVCConfigTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Stream;
+    AppendNAL(Stream, H264SPS);
+    AppendNAL(Stream, H264PPS);
+
+    TArray<uint8> Record;
+    TestTrue(TEXT("A baseline record builds"), FNVENCAnnexB::BuildAVCDecoderConfigurationRecord(Stream.GetData(), Stream.Num(), Record));
+    TArray<uint8> Expected = { 0x01, 0x42, 0xC0, 0x1E, 0xFF, 0xE1, 0x00, 0x07 };
+    Expected.Append(H264SPS);
+    Expected.Append({ 0x01, 0x00, 0x04 });
+    Expected.Append(H264PPS);
+    TestTrue(TEXT("The baseline record matches ISO/IEC 14496-15"), Record == Expected);
+
+    // High 10 records carry the chroma format and bit depths parsed from the SPS.
+    Stream.Reset();
+    AppendNAL(Stream, { 0x67, 0x6E, 0x00, 0x28, 0xA6, 0xE0 });
+    AppendNAL(Stream, H264PPS);
+    TestTrue(TEXT("A High 10 record builds"), FNVENCAnnexB::BuildAVCDecoderConfigurationRecord(Stream.GetData(), Stream.Num(), Record));
+    if (TestTrue(TEXT("The High 10 record has its extension"), Record.Num() >= 4))
+    {
+        TestEqual(TEXT("4:2:0 chroma"), static_cast<int32>(Record[Record.Num() - 4]), 0xFD);
+        TestEqual(TEXT("10-bit luma"), static_cast<int32>(Record[Record.Num() - 3]), 0xFA);
+        TestEqual(TEXT("10-bit chroma"), static_cast<int32>(Record[Record.Num() - 2]), 0xFA);
+    }
+
+    Stream.Reset();
+    AppendNAL(Stream, H264PPS);
+    TestFalse(TEXT("A record needs an SPS"), FNVENCAnnexB::BuildAVCDecoderConfigurationRecord(Stream.GetData(), Stream.Num(), Record));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureHEVCConfigTest, "OmniCapture.MP4Writer.BuildsHEVCDecoderConfiguration", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureHEVCConfigTest::RunTest(const FString& Parameters)
+{
+    TArray<uint8> Stream;
+    AppendNAL(Stream, HEVCVPS);
+    AppendNAL(Stream, HEVCSPS);
+    AppendNAL(Stream, HEVCPPS);
+    AppendNAL(Stream, { 0x26, 0x01, 0xAF, 0x11 });
+
+    TArray<uint8> Record;
+    if (!TestTrue(TEXT("The record builds"), FNVENCAnnexB::BuildHEVCDecoderConfigurationRecord(Stream.GetData(), Stream.Num(), Record)))
+    {
+        return false;
+    }
+
+    const TArray<uint8> ExpectedPrefix = { 0x01, 0x02, 0x60, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x00, 0x00, 0x00, 0x99, 0xF0, 0x00, 0xFC, 0xFD, 0xFA, 0xFA, 0x00, 0x00, 0x0F, 0x03 };
+    TestTrue(TEXT("The record is longer than its fixed part"), Record.Num() > ExpectedPrefix.Num());
+    TestTrue(TEXT("Profile, level, chroma and bit depth are read through the emulation prevention bytes"), TArray<uint8>(Record.GetData(), FMath::Min(Record.Num(), ExpectedPrefix.Num())) == ExpectedPrefix);
+
+    const int32 SPSArray = ExpectedPrefix.Num() + 5 + HEVCVPS.Num();
+    if (TestTrue(TEXT("The record holds the SPS array"), Record.Num() > SPSArray + 5))
+    {
+        TestEqual(TEXT("Arrays follow in VPS, SPS, PPS order"), static_cast<int32>(Record[SPSArray]), 0x80 | 33);
+        TestEqual(TEXT("Parameter sets are stored escaped, as sent"), static_cast<int32>((Record[SPSArray + 3] << 8) | Record[SPSArray + 4]), HEVCSPS.Num());
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureMP4WriterRoundTripTest, "OmniCapture.MP4Writer.WritesFragmentedMP4", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureMP4WriterRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureMP4Writer"), TEXT("RoundTrip"));
+    const FString Path = Directory / TEXT("Shot.mp4");
+    constexpr int32 GOPLength = 30;
+    constexpr int32 FrameCount = GOPLength * 2;
+    constexpr int32 AudioFramesPerVideoFrame = 48000 / 30;
+
+    FOmniCaptureMP4WriterConfig Config;
+    Config.Codec = EOmniCaptureCodec::H264;
+    Config.Size = FIntPoint(64, 32);
+    Config.FrameRate = 30.0;
+    Config.bWithAudio = true;
+    Config.bSpherical = true;
+    Config.bStereo = true;
+    Config.StereoLayout = EOmniCaptureStereoLayout::TopBottom;
+    Config.MinFragmentSeconds = 0.5;
+
+    FOmniCaptureMP4Writer Writer;
+    if (!TestTrue(TEXT("The file opens"), Writer.Open(Path, Config)))
+    {
+        return false;
+    }
+
+    TArray<uint8> Leading;
+    AppendNAL(Leading, { 0x41, 0x9A, 0x01 });
+    TestFalse(TEXT("A frame before the first keyframe is refused"), Writer.WriteVideoSample(Leading.GetData(), Leading.Num(), false, 0));
+
+    FOmniAudioPacket Audio;
+    Audio.SampleRate = 48000;
+    Audio.NumChannels = 2;
+    Audio.PCM16.Init(0x1234, AudioFramesPerVideoFrame * Audio.NumChannels);
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        const bool bKeyFrame = FrameIndex % GOPLength == 0;
+        TArray<uint8> AccessUnit;
+        if (FrameIndex == 0)
+        {
+            // Parameter sets inline with the first keyframe, as NVENC sends them.
+            AppendNAL(AccessUnit, H264SPS);
+            AppendNAL(AccessUnit, H264PPS);
+        }
+        AppendNAL(AccessUnit, bKeyFrame ? TArray<uint8>{ 0x65, 0x88, static_cast<uint8>(FrameIndex + 1) } : TArray<uint8>{ 0x41, 0x9A, static_cast<uint8>(FrameIndex + 1) });
+
+        const uint64 Timestamp = static_cast<uint64>(FrameIndex) * 1000000 / 30;
+        TestTrue(TEXT("Samples are accepted"), Writer.WriteVideoSample(AccessUnit.GetData(), AccessUnit.Num(), bKeyFrame, Timestamp));
+        Audio.Timestamp = static_cast<double>(FrameIndex) / 30.0;
+        Writer.WriteAudio(Audio);
+    }
+
+    FOmniAudioPacket OtherRate = Audio;
+    OtherRate.SampleRate = 44100;
+    Writer.WriteAudio(OtherRate);
+
+    const int64 ReportedBytes = Writer.GetBytesWritten();
+    TestTrue(TEXT("The file closes with playable video"), Writer.Close());
+    TestEqual(TEXT("Every sample is written"), Writer.GetVideoSampleCount(), FrameCount);
+    TestEqual(TEXT("The leading delta frame is dropped"), Writer.GetDroppedVideoSamples(), 1);
+    TestEqual(TEXT("Audio in another format is dropped"), Writer.GetDroppedAudioPackets(), 1);
+    TestEqual(TEXT("Each GOP gets its own fragment"), Writer.GetFragmentCount(), 2);
+
+    TArray<uint8> Bytes;
+    if (!TestTrue(TEXT("The file loads"), FFileHelper::LoadFileToArray(Bytes, *Path)))
+    {
+        return false;
+    }
+    TestEqual(TEXT("Counted bytes match the file"), Writer.GetBytesWritten(), static_cast<int64>(Bytes.Num()));
+    TestTrue(TEXT("Bytes were counted while writing"), ReportedBytes > 0);
+
+    // Top level: ftyp, moov, then a moof/mdat pair per fragment, with sizes that add up to the file.
+    TArray<FString> TopLevel;
+    int64 MoovOffset = INDEX_NONE;
+    TArray<int64> MoofOffsets;
+    for (int64 Offset = 0; Offset + 8 <= Bytes.Num();)
+    {
+        const uint32 Size = ReadU32(Bytes, Offset);
+        if (!TestTrue(TEXT("Box sizes are sane"), Size >= 8 && Offset + Size <= Bytes.Num()))
+        {
+            return false;
+        }
+        FString Type;
+        for (int32 Char = 0; Char < 4; ++Char)
+        {
+            Type.AppendChar(static_cast<TCHAR>(Bytes[Offset + 4 + Char]));
+        }
+        TopLevel.Add(Type);
+        MoovOffset = IsBoxType(Bytes, Offset, "moov") ? Offset : MoovOffset;
+        if (IsBoxType(Bytes, Offset, "moof"))
+        {
+            MoofOffsets.Add(Offset);
+        }
+        Offset += Size;
+    }
+    TestEqual(TEXT("Boxes are laid out as a fragmented MP4"), FString::Join(TopLevel, TEXT(",")), FString(TEXT("ftyp,moov,moof,mdat,moof,mdat")));
+    if (MoovOffset == INDEX_NONE || MoofOffsets.Num() != 2)
+    {
+        return false;
+    }
+
+    const int64 MoovEnd = MoovOffset + ReadU32(Bytes, MoovOffset);
+    TestTrue(TEXT("The sample entry has an avcC"), FindBox(Bytes, MoovOffset, MoovEnd, "avcC") != INDEX_NONE);
+    TestTrue(TEXT("PCM audio gets a track"), FindBox(Bytes, MoovOffset, MoovEnd, "sowt") != INDEX_NONE);
+    TestTrue(TEXT("Spherical projection is declared"), FindBox(Bytes, MoovOffset, MoovEnd, "sv3d") != INDEX_NONE);
+    const int64 Stereo = FindBox(Bytes, MoovOffset, MoovEnd, "st3d");
+    if (TestTrue(TEXT("Stereo packing is declared"), Stereo != INDEX_NONE))
+    {
+        TestEqual(TEXT("Top-bottom packing"), static_cast<int32>(Bytes[Stereo + 12]), 1);
+    }
+    const int64 Mehd = FindBox(Bytes, MoovOffset, MoovEnd, "mehd");
+    if (TestTrue(TEXT("The movie extends header exists"), Mehd != INDEX_NONE))
+    {
+        TestEqual(TEXT("The total duration is patched in at close"), static_cast<int64>(ReadU32(Bytes, Mehd + 16)), static_cast<int64>(2000));
+    }
+
+    int32 VideoSamples = 0;
+    int32 AudioSamples = 0;
+    for (const int64 Moof : MoofOffsets)
+    {
+        const int64 MoofEnd = Moof + ReadU32(Bytes, Moof);
+        const int64 VideoRun = FindBox(Bytes, Moof, MoofEnd, "trun");
+        const int64 AudioRun = VideoRun != INDEX_NONE ? FindBox(Bytes, VideoRun + 8, MoofEnd, "trun") : INDEX_NONE;
+        if (!TestTrue(TEXT("Each fragment has a video and an audio run"), VideoRun != INDEX_NONE && AudioRun != INDEX_NONE))
+        {
+            return false;
+        }
+        VideoSamples += static_cast<int32>(ReadU32(Bytes, VideoRun + 12));
+        AudioSamples += static_cast<int32>(ReadU32(Bytes, AudioRun + 12));
+
+        // The first video sample's data offset must land on its length prefix in the following mdat.
+        const int64 FirstSample = Moof + static_cast<int32>(ReadU32(Bytes, VideoRun + 16));
+        TestEqual(TEXT("Fragments start on a keyframe"), static_cast<int32>(Bytes[FirstSample + 4]), 0x65);
+        TestEqual(TEXT("Sync samples are flagged"), static_cast<int64>(ReadU32(Bytes, VideoRun + 28)), static_cast<int64>(0x02000000));
+    }
+    TestEqual(TEXT("Every video sample is in a run"), VideoSamples, FrameCount);
+    TestEqual(TEXT("Every audio frame is in a run"), AudioSamples, FrameCount * AudioFramesPerVideoFrame);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureMP4WriterAudioGapTest, "OmniCapture.MP4Writer.KeepsAudioOnTheVideoClock", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureMP4WriterAudioGapTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureMP4Writer"), TEXT("AudioGap"));
+    constexpr int32 FrameCount = 30;
+    constexpr int32 DroppedFrame = 10;
+    constexpr int32 AudioFramesPerVideoFrame = 48000 / 30;
+
+    FOmniCaptureMP4WriterConfig Config;
+    Config.Codec = EOmniCaptureCodec::H264;
+    Config.Size = FIntPoint(64, 32);
+    Config.bWithAudio = true;
+
+    FOmniCaptureMP4Writer Writer;
+    if (!TestTrue(TEXT("The file opens"), Writer.Open(Directory / TEXT("Gap.mp4"), Config)))
+    {
+        return false;
+    }
+
+    FOmniAudioPacket Audio;
+    Audio.SampleRate = 48000;
+    Audio.NumChannels = 2;
+    Audio.PCM16.Init(0x1234, AudioFramesPerVideoFrame * Audio.NumChannels);
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        if (FrameIndex == DroppedFrame)
+        {
+            // The frame and the audio gathered with it never reach the writer, as when the encoder drops it.
+            continue;
+        }
+        TArray<uint8> AccessUnit;
+        if (FrameIndex == 0)
+        {
+            AppendNAL(AccessUnit, H264SPS);
+            AppendNAL(AccessUnit, H264PPS);
+        }
+        AppendNAL(AccessUnit, FrameIndex == 0 ? TArray<uint8>{ 0x65, 0x88, 0x01 } : TArray<uint8>{ 0x41, 0x9A, static_cast<uint8>(FrameIndex + 1) });
+        Writer.WriteVideoSample(AccessUnit.GetData(), AccessUnit.Num(), FrameIndex == 0, static_cast<uint64>(FrameIndex) * 1000000 / 30);
+
+        Audio.Timestamp = static_cast<double>(FrameIndex) / 30.0;
+        Writer.WriteAudio(Audio);
+    }
+
+    // A packet repeated over audio already placed must not push the track further out.
+    Writer.WriteAudio(Audio);
+
+    const int64 ExpectedFrames = static_cast<int64>(FrameCount) * AudioFramesPerVideoFrame;
+    TestEqual(TEXT("The audio track lasts as long as the video it covers"), Writer.GetAudioFrameCount(), ExpectedFrames);
+    TestEqual(TEXT("The dropped frame's audio is silence"), Writer.GetSilentAudioFrames(), static_cast<int64>(AudioFramesPerVideoFrame));
+    TestTrue(TEXT("The file closes"), Writer.Close());
+    TestEqual(TEXT("The written track keeps its length"), Writer.GetAudioFrameCount(), ExpectedFrames);
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,149 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCapturePNGEncoder.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace
+{
+    // Smooth gradients with a little noise, so filters and deflate both have real work to do.
+    TArray64<uint8> MakeTestRows(const FIntPoint& Size, int32 BytesPerPixel)
+    {
+        TArray64<uint8> Bytes;
+        Bytes.SetNumUninitialized(static_cast<int64>(Size.X) * Size.Y * BytesPerPixel);
+        FRandomStream Random(Size.X * 31 + Size.Y);
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                uint8* Pixel = Bytes.GetData() + (static_cast<int64>(Y) * Size.X + X) * BytesPerPixel;
+                for (int32 Byte = 0; Byte < BytesPerPixel; ++Byte)
+                {
+                    Pixel[Byte] = static_cast<uint8>((X * (Byte + 1) + Y * 3 + Random.RandRange(0, 3)) & 0xFF);
+                }
+            }
+        }
+        return Bytes;
+    }
+
+    bool EncodeRows(const TArray64<uint8>& Rows, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, int32 BandCount, TArray64<uint8>& OutPNG)
+    {
+        const int64 BytesPerRow = Rows.Num() / Size.Y;
+        FOmniCapturePNGEncodeOptions Options;
+        Options.BandCount = BandCount;
+
+        FMemoryWriter64 Writer(OutPNG);
+        return FOmniCaptureParallelPNGEncoder::Encode(Writer, Size, Format, BitDepth, Options,
+            [&Rows, BytesPerRow](int32 RowStart, int32 RowCount, int64, TArray64<uint8>&, TArray<uint8*>& RowPointers)
+            {
+                for (int32 Row = 0; Row < RowCount; ++Row)
+                {
+                    RowPointers[Row] = const_cast<uint8*>(Rows.GetData() + (RowStart + Row) * BytesPerRow);
+                }
+            },
+            []()
+            {
+                return false;
+            });
+    }
+
+    bool DecodePNG(const TArray64<uint8>& PNG, ERGBFormat Format, int32 BitDepth, TArray64<uint8>& OutRaw)
+    {
+        IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(TEXT("ImageWrapper"));
+        const TSharedPtr<IImageWrapper> Wrapper = ImageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+        return Wrapper.IsValid() && Wrapper->SetCompressed(PNG.GetData(), PNG.Num()) && Wrapper->GetRaw(Format, BitDepth, OutRaw);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePNGEncoderRoundTripTest, "OmniCapture.PNGEncoder.BandedOutputDecodes", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePNGEncoderRoundTripTest::RunTest(const FString& Parameters)
+{
+    // An odd size so the last band is short and rows are not a multiple of any SIMD width.
+    const FIntPoint Size(97, 83);
+
+    struct FCase
+    {
+        ERGBFormat Format;
+        int32 BitDepth;
+        int32 BytesPerPixel;
+    };
+    const FCase Cases[] = {
+        { ERGBFormat::BGRA, 8, 4 },
+        { ERGBFormat::RGBA, 16, 8 },
+        { ERGBFormat::Gray, 8, 1 },
+    };
+
+    for (const FCase& Case : Cases)
+    {
+        const TArray64<uint8> Rows = MakeTestRows(Size, Case.BytesPerPixel);
+        for (const int32 BandCount : { 1, 4, 5 })
+        {
+            const FString Context = FString::Printf(TEXT("%d-bit, %d channel byte(s), %d band(s)"), Case.BitDepth, Case.BytesPerPixel, BandCount);
+
+            TArray64<uint8> PNG;
+            if (!TestTrue(*FString::Printf(TEXT("Encodes (%s)"), *Context), EncodeRows(Rows, Size, Case.Format, Case.BitDepth, BandCount, PNG)))
+            {
+                continue;
+            }
+
+            TArray64<uint8> Decoded;
+            if (!TestTrue(*FString::Printf(TEXT("A stock decoder accepts it (%s)"), *Context), DecodePNG(PNG, Case.Format, Case.BitDepth, Decoded)))
+            {
+                continue;
+            }
+            TestTrue(*FString::Printf(TEXT("Pixels survive the round trip (%s)"), *Context), Decoded == Rows);
+        }
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePNGEncodeThroughputTest, "OmniCapture.PNGEncoder.Throughput", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCapturePNGEncodeThroughputTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint Size(8192, 4096);
+    const TArray64<uint8> Rows = MakeTestRows(Size, sizeof(FColor));
+    const double MegaBytes = Rows.Num() / (1024.0 * 1024.0);
+    const FString OutputDirectory = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("OmniCapturePNGThroughput"));
+
+    for (const bool bParallel : { false, true })
+    {
+        FOmniCaptureSettings Settings;
+        Settings.ImageFormat = EOmniCaptureImageFormat::PNG;
+        Settings.PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth8;
+        Settings.bParallelPNGEncoding = bParallel;
+        Settings.OutputFileName = bParallel ? TEXT("Parallel") : TEXT("LibPNG");
+
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(Settings, OutputDirectory);
+
+        TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(Size);
+        PixelData->Pixels.SetNumUninitialized(Rows.Num() / sizeof(FColor));
+        FMemory::Memcpy(PixelData->Pixels.GetData(), Rows.GetData(), Rows.Num());
+
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        Frame->PixelData = MoveTemp(PixelData);
+        Frame->PixelDataType = EOmniCapturePixelDataType::Color8;
+
+        const FString FileName = Settings.OutputFileName + TEXT(".png");
+        const double StartSeconds = FPlatformTime::Seconds();
+        Writer.EnqueueFrame(MoveTemp(Frame), FileName);
+        Writer.Flush();
+        const double Seconds = FPlatformTime::Seconds() - StartSeconds;
+
+        const int64 FileSize = IFileManager::Get().FileSize(*FPaths::Combine(OutputDirectory, FileName));
+        AddInfo(FString::Printf(TEXT("%s: %.1f MB/s (%.0f ms, %.1f MB on disk)"),
+            bParallel ? *FString::Printf(TEXT("Banded (%d bands)"), FOmniCaptureParallelPNGEncoder::ResolveBandCount(FOmniCapturePNGEncodeOptions::FromSettings(Settings), Size.Y)) : TEXT("libpng"),
+            MegaBytes / FMath::Max(Seconds, 1e-6), Seconds * 1000.0, FileSize / (1024.0 * 1024.0)));
+    }
+
+    IFileManager::Get().DeleteDirectory(*OutputDirectory, false, true);
+    return true;
+}
@@ -0,0 +1,104 @@
+#include "Misc/AutomationTest.h"
+
+#include "OmniCapturePreviewImage.h"
+
+namespace
+{
+    // Each pixel encodes its own coordinates so a preview pixel shows which source pixels were averaged into it.
+    TUniquePtr<TImagePixelData<FColor>> MakePreviewTestPixels(const FIntPoint& Size)
+    {
+        TUniquePtr<TImagePixelData<FColor>> PixelData = MakeUnique<TImagePixelData<FColor>>(Size);
+        PixelData->Pixels.SetNumUninitialized(static_cast<int64>(Size.X) * Size.Y);
+        for (int32 Y = 0; Y < Size.Y; ++Y)
+        {
+            for (int32 X = 0; X < Size.X; ++X)
+            {
+                PixelData->Pixels[static_cast<int64>(Y) * Size.X + X] = FColor(static_cast<uint8>(X), static_cast<uint8>(Y), 7, 255);
+            }
+        }
+        return PixelData;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePreviewImageSizeTest, "OmniCapture.PreviewImage.FitsMaxEdge", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePreviewImageSizeTest::RunTest(const FString& Parameters)
+{
+    TestEqual(TEXT("Wide frames scale by their width"), FOmniCapturePreviewImage::GetScaledSize(FIntPoint(7680, 3840), 1024), FIntPoint(1024, 512));
+    TestEqual(TEXT("Tall frames scale by their height"), FOmniCapturePreviewImage::GetScaledSize(FIntPoint(4096, 8192), 1024), FIntPoint(512, 1024));
+    TestEqual(TEXT("Small frames are never scaled up"), FOmniCapturePreviewImage::GetScaledSize(FIntPoint(640, 320), 1024), FIntPoint(640, 320));
+    TestEqual(TEXT("A max edge of zero keeps the size"), FOmniCapturePreviewImage::GetScaledSize(FIntPoint(7680, 3840), 0), FIntPoint(7680, 3840));
+    TestEqual(TEXT("Thin frames keep at least one pixel"), FOmniCapturePreviewImage::GetScaledSize(FIntPoint(8192, 2), 256), FIntPoint(256, 1));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePreviewImageViewTest, "OmniCapture.PreviewImage.SelectsEye", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePreviewImageViewTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint FrameSize(2048, 1024);
+    FOmniCaptureSettings Settings;
+    Settings.Mode = EOmniCaptureMode::Mono;
+    TestEqual(TEXT("Mono frames are shown whole"), FOmniCapturePreviewImage::GetViewRect(FrameSize, Settings, EOmniCapturePreviewView::RightEye), FIntRect(0, 0, 2048, 1024));
+
+    Settings.Mode = EOmniCaptureMode::Stereo;
+    Settings.StereoLayout = EOmniCaptureStereoLayout::SideBySide;
+    TestEqual(TEXT("The composite shows both eyes"), FOmniCapturePreviewImage::GetViewRect(FrameSize, Settings, EOmniCapturePreviewView::StereoComposite), FIntRect(0, 0, 2048, 1024));
+    TestEqual(TEXT("Side by side left eye"), FOmniCapturePreviewImage::GetViewRect(FrameSize, Settings, EOmniCapturePreviewView::LeftEye), FIntRect(0, 0, 1024, 1024));
+    TestEqual(TEXT("Side by side right eye"), FOmniCapturePreviewImage::GetViewRect(FrameSize, Settings, EOmniCapturePreviewView::RightEye), FIntRect(1024, 0, 2048, 1024));
+
+    Settings.StereoLayout = EOmniCaptureStereoLayout::TopBottom;
+    TestEqual(TEXT("Top bottom left eye"), FOmniCapturePreviewImage::GetViewRect(FrameSize, Settings, EOmniCapturePreviewView::LeftEye), FIntRect(0, 0, 2048, 512));
+    TestEqual(TEXT("Top bottom right eye"), FOmniCapturePreviewImage::GetViewRect(FrameSize, Settings, EOmniCapturePreviewView::RightEye), FIntRect(0, 512, 2048, 1024));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePreviewImageBuildTest, "OmniCapture.PreviewImage.DownscalesRegion", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePreviewImageBuildTest::RunTest(const FString& Parameters)
+{
+    const FIntPoint FrameSize(64, 32);
+    const TUniquePtr<TImagePixelData<FColor>> PixelData = MakePreviewTestPixels(FrameSize);
+
+    FOmniCapturePreviewImage Image;
+    TestTrue(TEXT("The right half builds"), Image.Build(*PixelData, EOmniCapturePixelDataType::Color8, FIntRect(32, 0, 64, 32), 16));
+    TestEqual(TEXT("The region is scaled to the max edge"), Image.Size, FIntPoint(16, 16));
+    TestTrue(TEXT("The image is complete"), Image.IsValid());
+
+    // Each preview pixel covers a 2x2 block, so it averages to the middle of that block.
+    const FColor& First = Image.Pixels[0];
+    TestEqual(TEXT("The first column comes from the region, not the frame"), static_cast<int32>(First.R), 33);
+    TestEqual(TEXT("The first row averages its block"), static_cast<int32>(First.G), 1);
+    const FColor& Last = Image.Pixels.Last();
+    TestEqual(TEXT("The last column reaches the region's edge"), static_cast<int32>(Last.R), 63);
+    TestEqual(TEXT("The last row reaches the frame's edge"), static_cast<int32>(Last.G), 31);
+
+    TestFalse(TEXT("Regions outside the frame are refused"), Image.Build(*PixelData, EOmniCapturePixelDataType::Color8, FIntRect(32, 0, 96, 32), 16));
+    TestFalse(TEXT("A refused build leaves no image"), Image.IsValid());
+    TestFalse(TEXT("Pixel types the preview cannot read are refused"), Image.Build(*PixelData, EOmniCapturePixelDataType::Unknown, FIntRect(0, 0, 64, 32), 16));
+
+    TUniquePtr<TImagePixelData<FLinearColor>> LinearData = MakeUnique<TImagePixelData<FLinearColor>>(FIntPoint(8, 8));
+    LinearData->Pixels.Init(FLinearColor(1.0f, 0.0f, 0.25f, 1.0f), 64);
+    TestTrue(TEXT("Linear frames build"), Image.Build(*LinearData, EOmniCapturePixelDataType::LinearColorFloat32, FIntRect(0, 0, 8, 8), 4));
+    TestEqual(TEXT("Linear pixels are encoded as sRGB"), Image.Pixels[0], FLinearColor(1.0f, 0.0f, 0.25f, 1.0f).ToFColor(true));
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCapturePreviewImageChangedRectTest, "OmniCapture.PreviewImage.FindsChangedRect", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCapturePreviewImageChangedRectTest::RunTest(const FString& Parameters)
+{
+    FOmniCapturePreviewImage Image;
+    Image.Size = FIntPoint(16, 8);
+    Image.Pixels.Init(FColor::Black, 16 * 8);
+
+    FIntRect Changed;
+    TestTrue(TEXT("A first upload covers the whole image"), FOmniCapturePreviewImage::FindChangedRect(TArray<FColor>(), Image, Changed));
+    TestEqual(TEXT("The first rect is the whole image"), Changed, FIntRect(0, 0, 16, 8));
+
+    const TArray<FColor> Uploaded = Image.Pixels;
+    TestFalse(TEXT("An unchanged image uploads nothing"), FOmniCapturePreviewImage::FindChangedRect(Uploaded, Image, Changed));
+
+    Image.Pixels[2 * 16 + 9] = FColor::White;
+    Image.Pixels[5 * 16 + 4] = FColor::White;
+    Image.Pixels[5 * 16 + 11] = FColor::White;
+    TestTrue(TEXT("A changed image uploads"), FOmniCapturePreviewImage::FindChangedRect(Uploaded, Image, Changed));
+    TestEqual(TEXT("Only the changed pixels' bounds upload"), Changed, FIntRect(4, 2, 12, 6));
+    return true;
+}
@@ -0,0 +1,129 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureRawFrameFile.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    FString MakeRawTestDirectory(const TCHAR* Name)
+    {
+        return OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureRaw"), Name);
+    }
+
+    // Color8 beauty whose pixels encode the frame index, plus a float depth layer.
+    TUniquePtr<FOmniCaptureFrame> MakeRawTestFrame(const FIntPoint& Size, int32 FrameIndex)
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = OmniCaptureTests::MakeColor8Frame(Size, FrameIndex, FColor::Black);
+        TArray64<FColor>& Beauty = OmniCaptureTests::GetColor8Pixels(*Frame);
+        for (int64 Index = 0; Index < Beauty.Num(); ++Index)
+        {
+            Beauty[Index] = FColor(static_cast<uint8>(Index), static_cast<uint8>(FrameIndex), static_cast<uint8>(Index >> 8), 255);
+        }
+
+        TUniquePtr<TImagePixelData<float>> Depth = MakeUnique<TImagePixelData<float>>(Size);
+        Depth->Pixels.Init(static_cast<float>(FrameIndex) + 0.5f, static_cast<int64>(Size.X) * Size.Y);
+        FOmniCaptureLayerPayload& DepthLayer = Frame->AuxiliaryLayers.Add(TEXT("Depth"));
+        DepthLayer.PixelData = MoveTemp(Depth);
+        DepthLayer.bLinear = true;
+        DepthLayer.Precision = EOmniCapturePixelPrecision::FullFloat;
+        DepthLayer.PixelDataType = EOmniCapturePixelDataType::ScalarFloat32;
+        return Frame;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRawRoundTripTest, "OmniCapture.RawFrameFile.RoundTripsAcrossSegments", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRawRoundTripTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeRawTestDirectory(TEXT("RoundTrip"));
+    // 61 x 37 pixels: neither payload is a multiple of the alignment, so every write needs padding.
+    const FIntPoint Size(61, 37);
+    constexpr int32 FrameCount = 5;
+
+    {
+        // Room for about one frame per segment, to exercise the rollover.
+        FOmniCaptureRawSegmentWriter Writer(Directory, TEXT("Raw"), 3 * FOmniCaptureRawSegmentWriter::Alignment, true);
+        for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeRawTestFrame(Size, FrameIndex);
+            TestTrue(TEXT("The beauty payload is written"), Writer.WritePayload(Frame->Metadata, NAME_None, *Frame->PixelData, Frame->PixelDataType, Frame->PixelPrecision, Frame->bLinearColor));
+            const FOmniCaptureLayerPayload& Depth = Frame->AuxiliaryLayers.FindChecked(TEXT("Depth"));
+            TestTrue(TEXT("The depth payload is written"), Writer.WritePayload(Frame->Metadata, TEXT("Depth"), *Depth.PixelData, Depth.PixelDataType, Depth.Precision, Depth.bLinear));
+        }
+        Writer.Close();
+        TestTrue(TEXT("Full segments roll over to new files"), Writer.GetSegmentCount() > 1);
+    }
+
+    FOmniCaptureRawSequenceReader Reader;
+    TestTrue(TEXT("The index opens"), Reader.Open(Directory, TEXT("Raw")));
+    TestEqual(TEXT("Every payload is indexed"), Reader.GetEntries().Num(), FrameCount * 2);
+    TestEqual(TEXT("Frames are listed once each"), Reader.GetFrameIndices().Num(), FrameCount);
+    for (const FOmniCaptureRawSequenceReader::FEntry& Entry : Reader.GetEntries())
+    {
+        TestEqual(TEXT("Payloads start on an aligned offset"), Entry.Record.Offset % FOmniCaptureRawSegmentWriter::Alignment, static_cast<uint64>(0));
+    }
+
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        TUniquePtr<FOmniCaptureFrame> Expected = MakeRawTestFrame(Size, FrameIndex);
+        TUniquePtr<FOmniCaptureFrame> Frame = Reader.ReadFrame(FrameIndex);
+        if (!TestTrue(TEXT("The frame reads back"), Frame.IsValid() && Frame->PixelData.IsValid()))
+        {
+            return false;
+        }
+
+        TestEqual(TEXT("The timecode is kept"), Frame->Metadata.Timecode, Expected->Metadata.Timecode);
+        TestEqual(TEXT("The key frame flag is kept"), Frame->Metadata.bKeyFrame, Expected->Metadata.bKeyFrame);
+        TestEqual(TEXT("The pixel type is kept"), Frame->PixelDataType, EOmniCapturePixelDataType::Color8);
+        TestTrue(TEXT("Beauty pixels match"), OmniCaptureTests::GetColor8Pixels(*Frame) == OmniCaptureTests::GetColor8Pixels(*Expected));
+
+        const FOmniCaptureLayerPayload* Depth = Frame->AuxiliaryLayers.Find(TEXT("Depth"));
+        if (TestNotNull(TEXT("The depth layer reads back"), Depth))
+        {
+            TestEqual(TEXT("The depth layer keeps its type"), Depth->PixelDataType, EOmniCapturePixelDataType::ScalarFloat32);
+            TestEqual(TEXT("Depth values match"), static_cast<TImagePixelData<float>*>(Depth->PixelData.Get())->Pixels[0], FrameIndex + 0.5f);
+        }
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRawTranscodeTest, "OmniCapture.RawFrameFile.TranscodesToPNG", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRawTranscodeTest::RunTest(const FString& Parameters)
+{
+    const FString RawDirectory = MakeRawTestDirectory(TEXT("Capture"));
+    const FString PNGDirectory = MakeRawTestDirectory(TEXT("Transcoded"));
+    const FIntPoint Size(64, 32);
+    constexpr int32 FrameCount = 3;
+
+    FOmniCaptureSettings Settings;
+    Settings.OutputFileName = TEXT("Shot");
+    Settings.ImageFormat = EOmniCaptureImageFormat::Raw;
+    {
+        // Captured through the image writer, as the subsystem does.
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(Settings, RawDirectory);
+        for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+        {
+            Writer.EnqueueFrame(MakeRawTestFrame(Size, FrameIndex), FString::Printf(TEXT("Shot_%06d%s"), FrameIndex, *Settings.GetImageFileExtension()));
+        }
+        Writer.Flush();
+        TestEqual(TEXT("Raw writes succeed"), Writer.GetWriterPoolStats().FailedTasks, 0);
+    }
+
+    Settings.ImageFormat = EOmniCaptureImageFormat::PNG;
+    Settings.PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth8;
+    TestEqual(TEXT("Every frame is transcoded"), FOmniCaptureRawTranscoder::Transcode(RawDirectory, TEXT("Shot"), Settings, PNGDirectory), FrameCount);
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        TestTrue(TEXT("The beauty PNG exists"), FPaths::FileExists(PNGDirectory / FString::Printf(TEXT("Shot_%06d.png"), FrameIndex)));
+        TestTrue(TEXT("The depth PNG exists"), FPaths::FileExists(PNGDirectory / FString::Printf(TEXT("Shot_%06d_Depth.png"), FrameIndex)));
+    }
+
+    IFileManager::Get().DeleteDirectory(*RawDirectory, false, true);
+    IFileManager::Get().DeleteDirectory(*PNGDirectory, false, true);
+    return true;
+}
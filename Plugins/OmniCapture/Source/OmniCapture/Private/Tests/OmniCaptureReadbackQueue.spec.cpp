@@ -0,0 +1,292 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "OmniCaptureReadbackQueue.h"
+#include "RenderingThread.h"
+
+namespace
+{
+    // Software stand-in for a GPU readback: a CPU buffer whose "copy" completes when the test says so.
+    class FTestReadback final : public IOmniCaptureReadback
+    {
+    public:
+        FTestReadback(const FIntPoint& InSize, int32 InRowPitchInBytes, bool& InReadyFlag)
+            : RowPitchInBytes(InRowPitchInBytes)
+            , bReady(InReadyFlag)
+        {
+            Bytes.SetNumZeroed(InRowPitchInBytes * InSize.Y);
+        }
+
+        virtual bool IsReady() override { return bReady; }
+        virtual void WaitUntilReady() override { bReady = true; }
+
+        virtual const void* Lock(int32& OutRowPitchInBytes) override
+        {
+            OutRowPitchInBytes = RowPitchInBytes;
+            return Bytes.GetData();
+        }
+
+        virtual void Unlock() override
+        {
+        }
+
+        TArray<uint8> Bytes;
+        int32 RowPitchInBytes = 0;
+        bool& bReady;
+    };
+
+    FOmniCaptureReadbackRequest MakeRequest(int32 FrameIndex, bool& bReadyFlag)
+    {
+        const FIntPoint Size(4, 2);
+        TUniquePtr<FTestReadback> Readback = MakeUnique<FTestReadback>(Size, Size.X * sizeof(FFloat16Color), bReadyFlag);
+        FFloat16Color* Pixels = reinterpret_cast<FFloat16Color*>(Readback->Bytes.GetData());
+        for (int32 Index = 0; Index < Size.X * Size.Y; ++Index)
+        {
+            // Tag every pixel with its frame so a mix-up between frames and pixels is visible.
+            Pixels[Index] = FFloat16Color(FLinearColor(static_cast<float>(FrameIndex), 0.0f, 0.0f, 1.0f));
+        }
+
+        FOmniCaptureReadbackRequest Request;
+        Request.Readback = MoveTemp(Readback);
+        Request.Frame = MakeUnique<FOmniCaptureFrame>();
+        Request.Frame->Metadata.FrameIndex = FrameIndex;
+        Request.Size = Size;
+        Request.Precision = EOmniCapturePixelPrecision::HalfFloat;
+        Request.bLinear = true;
+        return Request;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReadbackQueueOrderTest, "OmniCapture.ReadbackQueue.ResolvesInCaptureOrder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReadbackQueueOrderTest::RunTest(const FString& Parameters)
+{
+    bool ReadyFlags[3] = { false, false, false };
+    TArray<TUniquePtr<FOmniCaptureFrame>> Resolved;
+
+    FOmniCaptureReadbackQueue Queue;
+    Queue.Initialize(3, [&Resolved](FOmniCaptureReadbackRequest&& Request)
+    {
+        Resolved.Add(MoveTemp(Request.Frame));
+    });
+
+    for (int32 FrameIndex = 0; FrameIndex < 3; ++FrameIndex)
+    {
+        Queue.Enqueue(MakeRequest(FrameIndex, ReadyFlags[FrameIndex]));
+    }
+    TestEqual(TEXT("All requests in flight"), Queue.Num(), 3);
+
+    // A later copy landing first must not overtake the frame in front of it.
+    ReadyFlags[1] = true;
+    TestEqual(TEXT("Nothing resolves while the oldest copy is pending"), Queue.Poll(), 0);
+
+    ReadyFlags[0] = true;
+    TestEqual(TEXT("Oldest two frames resolve once both copies landed"), Queue.Poll(), 2);
+
+    Queue.Drain();
+    TestEqual(TEXT("Drain resolves the rest"), Resolved.Num(), 3);
+
+    for (int32 Index = 0; Index < Resolved.Num(); ++Index)
+    {
+        const FOmniCaptureFrame* Frame = Resolved[Index].Get();
+        if (!TestNotNull(TEXT("Resolved frame"), Frame) || !TestTrue(TEXT("Pixels attached"), Frame->PixelData.IsValid()))
+        {
+            continue;
+        }
+
+        TestEqual(TEXT("Frames leave in capture order"), Frame->Metadata.FrameIndex, Index);
+        TestTrue(TEXT("Half-float pixel type"), Frame->PixelDataType == EOmniCapturePixelDataType::LinearColorFloat16);
+        const TImagePixelData<FFloat16Color>* Pixels = static_cast<const TImagePixelData<FFloat16Color>*>(Frame->PixelData.Get());
+        TestEqual(TEXT("Pixels belong to their own frame"), Pixels->Pixels[0].R.GetFloat(), static_cast<float>(Index));
+    }
+
+    const FOmniCaptureReadbackStats Stats = Queue.GetStats();
+    TestEqual(TEXT("Completed count"), Stats.CompletedReadbacks, 3);
+    TestEqual(TEXT("No stalls below the queue depth"), Stats.StalledEnqueues, 0);
+    TestEqual(TEXT("Nothing left in flight"), Stats.InFlightReadbacks, 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReadbackQueueBackpressureTest, "OmniCapture.ReadbackQueue.FullQueueWaitsForOldest", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReadbackQueueBackpressureTest::RunTest(const FString& Parameters)
+{
+    bool ReadyFlags[3] = { false, false, false };
+    TArray<int32> ResolvedFrames;
+
+    FOmniCaptureReadbackQueue Queue;
+    Queue.Initialize(2, [&ResolvedFrames](FOmniCaptureReadbackRequest&& Request)
+    {
+        ResolvedFrames.Add(Request.Frame->Metadata.FrameIndex);
+    });
+
+    Queue.Enqueue(MakeRequest(0, ReadyFlags[0]));
+    Queue.Enqueue(MakeRequest(1, ReadyFlags[1]));
+    Queue.Enqueue(MakeRequest(2, ReadyFlags[2]));
+
+    TestEqual(TEXT("Third enqueue resolved exactly the oldest frame"), ResolvedFrames.Num(), 1);
+    TestTrue(TEXT("Oldest frame was the one waited on"), ResolvedFrames.Num() == 1 && ResolvedFrames[0] == 0);
+    TestEqual(TEXT("Queue stays at its depth"), Queue.Num(), 2);
+    TestEqual(TEXT("Stall recorded"), Queue.GetStats().StalledEnqueues, 1);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReadbackResolvePixelsTest, "OmniCapture.ReadbackQueue.ResolvePixelsHonoursRowPitch", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReadbackResolvePixelsTest::RunTest(const FString& Parameters)
+{
+    // Staging textures are usually padded; give each row two pixels of garbage past the visible width.
+    const FIntPoint Size(3, 2);
+    const int32 RowPitchInBytes = (Size.X + 2) * sizeof(FLinearColor);
+    bool bReady = true;
+    FTestReadback Readback(Size, RowPitchInBytes, bReady);
+    for (int32 Row = 0; Row < Size.Y; ++Row)
+    {
+        FLinearColor* RowPixels = reinterpret_cast<FLinearColor*>(Readback.Bytes.GetData() + Row * RowPitchInBytes);
+        for (int32 Column = 0; Column < Size.X + 2; ++Column)
+        {
+            RowPixels[Column] = Column < Size.X
+                ? FLinearColor(0.1f * (Row * Size.X + Column), 0.5f, 0.25f, 1.0f)
+                : FLinearColor(99.0f, 99.0f, 99.0f, 99.0f);
+        }
+    }
+
+    TUniquePtr<FImagePixelData> PixelData;
+    EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
+    TestTrue(TEXT("Resolve succeeds"), FOmniCaptureReadbackQueue::ResolvePixels(Readback, Size, EOmniCapturePixelPrecision::FullFloat, false, PixelData, PixelDataType));
+    TestTrue(TEXT("sRGB output is 8-bit"), PixelDataType == EOmniCapturePixelDataType::Color8);
+    if (!TestTrue(TEXT("Pixel data present"), PixelData.IsValid()))
+    {
+        return false;
+    }
+
+    const TImagePixelData<FColor>* Pixels = static_cast<const TImagePixelData<FColor>*>(PixelData.Get());
+    TestEqual(TEXT("Pixel count excludes row padding"), Pixels->Pixels.Num(), Size.X * Size.Y);
+
+    int32 Mismatches = 0;
+    for (int32 Index = 0; Index < Size.X * Size.Y; ++Index)
+    {
+        const FColor Expected = FLinearColor(0.1f * Index, 0.5f, 0.25f, 1.0f).ToFColor(true);
+        Mismatches += Pixels->Pixels[Index] == Expected ? 0 : 1;
+    }
+    TestEqual(TEXT("Rows are read at the staging pitch"), Mismatches, 0);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReadbackIssueTest, "OmniCapture.ReadbackQueue.IssueFillsFrameAndLayers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReadbackIssueTest::RunTest(const FString& Parameters)
+{
+    bool bBeautyReady = false;
+    bool bLayerReady = false;
+    TArray<TUniquePtr<FOmniCaptureFrame>> Resolved;
+
+    FOmniCaptureReadbackQueue Queue;
+    Queue.Initialize(2, [&Resolved](FOmniCaptureReadbackRequest&& Request)
+    {
+        Resolved.Add(MoveTemp(Request.Frame));
+    });
+
+    // The producer only sends the frame; the copies are issued by the deferred step, as a render-thread conversion does.
+    FOmniCaptureReadbackRequest Request;
+    Request.Frame = MakeUnique<FOmniCaptureFrame>();
+    Request.Frame->Metadata.FrameIndex = 7;
+    Request.Issue = [&bBeautyReady, &bLayerReady](FOmniCaptureReadbackRequest& Issued)
+    {
+        FOmniCaptureReadbackRequest Beauty = MakeRequest(7, bBeautyReady);
+        Issued.Readback = MoveTemp(Beauty.Readback);
+        Issued.Size = Beauty.Size;
+        Issued.Precision = Beauty.Precision;
+        Issued.bLinear = Beauty.bLinear;
+
+        FOmniCaptureReadbackRequest Normal = MakeRequest(3, bLayerReady);
+        FOmniCaptureLayerReadback& Layer = Issued.LayerReadbacks.Add(TEXT("WorldNormal"));
+        Layer.Readback = MoveTemp(Normal.Readback);
+        Layer.Size = Normal.Size;
+        Layer.Precision = Normal.Precision;
+    };
+    Queue.Enqueue(MoveTemp(Request));
+
+    bBeautyReady = true;
+    TestEqual(TEXT("The frame waits for its layer copy too"), Queue.Poll(), 0);
+
+    bLayerReady = true;
+    TestEqual(TEXT("The frame resolves once every copy landed"), Queue.Poll(), 1);
+
+    if (!TestEqual(TEXT("One frame resolved"), Resolved.Num(), 1) || !TestTrue(TEXT("Pixels attached"), Resolved[0].IsValid() && Resolved[0]->PixelData.IsValid()))
+    {
+        return false;
+    }
+
+    const FOmniCaptureFrame& Frame = *Resolved[0];
+    TestEqual(TEXT("Beauty pixels come from the issued copy"), static_cast<const TImagePixelData<FFloat16Color>*>(Frame.PixelData.Get())->Pixels[0].R.GetFloat(), 7.0f);
+    const FOmniCaptureLayerPayload* Layer = Frame.AuxiliaryLayers.Find(TEXT("WorldNormal"));
+    if (TestNotNull(TEXT("Layer resolved into the frame"), Layer) && TestTrue(TEXT("Layer pixels attached"), Layer->PixelData.IsValid()))
+    {
+        TestTrue(TEXT("Layers are linear"), Layer->bLinear && Layer->PixelDataType == EOmniCapturePixelDataType::LinearColorFloat16);
+        TestEqual(TEXT("Layer pixels come from the layer copy"), static_cast<const TImagePixelData<FFloat16Color>*>(Layer->PixelData.Get())->Pixels[0].R.GetFloat(), 3.0f);
+    }
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureReadbackProducerTest, "OmniCapture.ReadbackQueue.ProducerDoesNotWaitForRenderThread", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureReadbackProducerTest::RunTest(const FString& Parameters)
+{
+    if (!GIsThreadedRendering)
+    {
+        AddInfo(TEXT("Render commands run inline without a rendering thread; nothing to measure."));
+        return true;
+    }
+
+    constexpr int32 FrameCount = 3;
+    bool ReadyFlags[FrameCount] = { true, true, true };
+    TArray<int32> ResolvedFrames;
+    TAtomic<int32> IssuedCount(0);
+
+    TSharedPtr<FOmniCaptureReadbackQueue, ESPMode::ThreadSafe> Queue = MakeShared<FOmniCaptureReadbackQueue, ESPMode::ThreadSafe>();
+    Queue->Initialize(FrameCount, [&ResolvedFrames](FOmniCaptureReadbackRequest&& Request)
+    {
+        if (Request.Frame.IsValid() && Request.Frame->PixelData.IsValid())
+        {
+            ResolvedFrames.Add(Request.Frame->Metadata.FrameIndex);
+        }
+    });
+
+    // Stands in for a slow GPU conversion: every issue step holds the render thread until the producer is done.
+    FEvent* ReleaseRenderThread = FPlatformProcess::GetSynchEventFromPool(true);
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        FOmniCaptureReadbackRequest Request;
+        Request.Frame = MakeUnique<FOmniCaptureFrame>();
+        Request.Frame->Metadata.FrameIndex = FrameIndex;
+        Request.Issue = [ReleaseRenderThread, &IssuedCount, &ReadyFlags, FrameIndex](FOmniCaptureReadbackRequest& Issued)
+        {
+            ReleaseRenderThread->Wait(10000);
+            FOmniCaptureReadbackRequest Converted = MakeRequest(FrameIndex, ReadyFlags[FrameIndex]);
+            Issued.Readback = MoveTemp(Converted.Readback);
+            Issued.Size = Converted.Size;
+            Issued.Precision = Converted.Precision;
+            Issued.bLinear = Converted.bLinear;
+            ++IssuedCount;
+        };
+        FOmniCaptureReadbackQueue::EnqueueOnRenderThread(Queue, MoveTemp(Request));
+    }
+
+    TestEqual(TEXT("Every frame was handed over before the render thread converted any"), IssuedCount.Load(), 0);
+
+    ReleaseRenderThread->Trigger();
+    FlushRenderingCommands();
+    FPlatformProcess::ReturnSynchEventToPool(ReleaseRenderThread);
+
+    TestEqual(TEXT("Every frame was issued on the render thread"), IssuedCount.Load(), FrameCount);
+    if (TestEqual(TEXT("Every frame resolved"), ResolvedFrames.Num(), FrameCount))
+    {
+        for (int32 Index = 0; Index < FrameCount; ++Index)
+        {
+            TestEqual(TEXT("Frames resolve in capture order"), ResolvedFrames[Index], Index);
+        }
+    }
+
+    return true;
+}
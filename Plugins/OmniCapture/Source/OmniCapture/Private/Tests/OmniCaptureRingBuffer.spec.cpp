@@ -0,0 +1,351 @@
+#include "Misc/AutomationTest.h"
+
+#include "Async/ParallelFor.h"
+#include "Containers/Queue.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+#include "OmniCaptureRingBuffer.h"
+
+namespace
+{
+    constexpr int32 StressProducerCount = 4;
+    constexpr int32 StressFramesPerProducer = 2000;
+
+    struct FConsumedFrames
+    {
+        FCriticalSection CriticalSection;
+        TArray<int32> FrameIndices;
+
+        void Add(int32 FrameIndex)
+        {
+            FScopeLock Lock(&CriticalSection);
+            FrameIndices.Add(FrameIndex);
+        }
+
+        int32 Num()
+        {
+            FScopeLock Lock(&CriticalSection);
+            return FrameIndices.Num();
+        }
+    };
+
+    void RunStressProducers(FOmniCaptureRingBuffer& RingBuffer)
+    {
+        ParallelFor(StressProducerCount, [&RingBuffer](int32 ProducerIndex)
+        {
+            for (int32 Index = 0; Index < StressFramesPerProducer; ++Index)
+            {
+                TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+                Frame->Metadata.FrameIndex = ProducerIndex * StressFramesPerProducer + Index;
+                RingBuffer.Enqueue(MoveTemp(Frame));
+            }
+        }, EParallelForFlags::Unbalanced);
+    }
+
+    // Every frame consumed at most once, and each producer's frames in the order that producer pushed them.
+    bool ValidateConsumedFrames(FAutomationTestBase& Test, const TArray<int32>& FrameIndices)
+    {
+        TSet<int32> Seen;
+        int32 LastPerProducer[StressProducerCount];
+        for (int32& Last : LastPerProducer)
+        {
+            Last = -1;
+        }
+
+        int32 Duplicates = 0;
+        int32 OutOfOrder = 0;
+        for (const int32 FrameIndex : FrameIndices)
+        {
+            bool bAlreadySeen = false;
+            Seen.Add(FrameIndex, &bAlreadySeen);
+            Duplicates += bAlreadySeen ? 1 : 0;
+
+            const int32 Producer = FrameIndex / StressFramesPerProducer;
+            OutOfOrder += FrameIndex > LastPerProducer[Producer] ? 0 : 1;
+            LastPerProducer[Producer] = FrameIndex;
+        }
+
+        Test.TestEqual(TEXT("No frame is consumed twice"), Duplicates, 0);
+        Test.TestEqual(TEXT("Each producer's frames stay in order"), OutOfOrder, 0);
+        return Duplicates == 0 && OutOfOrder == 0;
+    }
+
+    // The queue this ring buffer replaced: a locked MPSC TQueue whose worker is woken by an event on every push.
+    class FLockedRingBuffer final : public FRunnable
+    {
+    public:
+        FLockedRingBuffer()
+        {
+            DataEvent = FPlatformProcess::GetSynchEventFromPool();
+            bRunning = true;
+            Thread.Reset(FRunnableThread::Create(this, TEXT("OmniCaptureLockedRingBuffer")));
+        }
+
+        virtual ~FLockedRingBuffer() override
+        {
+            bRunning = false;
+            DataEvent->Trigger();
+            Thread->WaitForCompletion();
+            Thread.Reset();
+            FPlatformProcess::ReturnSynchEventToPool(DataEvent);
+        }
+
+        void Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame)
+        {
+            {
+                FScopeLock Lock(&QueueCriticalSection);
+                Queue.Enqueue(MoveTemp(Frame));
+            }
+            DataEvent->Trigger();
+        }
+
+        virtual uint32 Run() override
+        {
+            while (bRunning.Load())
+            {
+                DataEvent->Wait();
+                for (;;)
+                {
+                    TUniquePtr<FOmniCaptureFrame> Frame;
+                    FScopeLock Lock(&QueueCriticalSection);
+                    if (!Queue.Dequeue(Frame))
+                    {
+                        break;
+                    }
+                }
+            }
+            return 0;
+        }
+
+    private:
+        TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc> Queue;
+        FCriticalSection QueueCriticalSection;
+        FEvent* DataEvent = nullptr;
+        TAtomic<bool> bRunning;
+        TUniquePtr<FRunnableThread> Thread;
+    };
+
+    template <typename EnqueueFunction>
+    FString MeasureEnqueueLatency(int32 FrameCount, EnqueueFunction&& Enqueue)
+    {
+        TArray<uint64> Cycles;
+        Cycles.SetNumUninitialized(FrameCount);
+        for (int32 Index = 0; Index < FrameCount; ++Index)
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = Index;
+            const uint64 StartCycles = FPlatformTime::Cycles64();
+            Enqueue(MoveTemp(Frame));
+            Cycles[Index] = FPlatformTime::Cycles64() - StartCycles;
+        }
+
+        Cycles.Sort();
+        auto Percentile = [&Cycles](double Fraction)
+        {
+            const int32 Index = FMath::Clamp(static_cast<int32>(Fraction * (Cycles.Num() - 1)), 0, Cycles.Num() - 1);
+            return FPlatformTime::ToMilliseconds64(Cycles[Index]) * 1000.0;
+        };
+        return FString::Printf(TEXT("p50 %.2f us, p99 %.2f us, p99.9 %.2f us, max %.2f us"), Percentile(0.5), Percentile(0.99), Percentile(0.999), Percentile(1.0));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferDropOldestStressTest, "OmniCapture.RingBuffer.DropOldestUnderContention", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRingBufferDropOldestStressTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.RingBufferCapacity = 4;
+    Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::DropOldest;
+
+    // Destroying the ring buffer lets the sink's worker drain what is left, so consumption stays on one thread and in order.
+    FConsumedFrames Consumed;
+    int32 DroppedFrames = 0;
+    {
+        FOmniCaptureRingBuffer RingBuffer;
+        RingBuffer.Initialize(Settings);
+        RingBuffer.AddSink(TEXT("Stress"), [&Consumed](const FOmniCaptureSharedFrame& Frame)
+        {
+            Consumed.Add(Frame->Metadata.FrameIndex);
+            // A consumer slower than the producers forces the drop path.
+            FPlatformProcess::Yield();
+        });
+
+        RunStressProducers(RingBuffer);
+        DroppedFrames = RingBuffer.GetStats().DroppedFrames;
+    }
+
+    AddInfo(FString::Printf(TEXT("Dropped %d of %d frames"), DroppedFrames, StressProducerCount * StressFramesPerProducer));
+    TestEqual(TEXT("Every frame is either consumed or dropped"), Consumed.FrameIndices.Num() + DroppedFrames, StressProducerCount * StressFramesPerProducer);
+    ValidateConsumedFrames(*this, Consumed.FrameIndices);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferBlockProducerStressTest, "OmniCapture.RingBuffer.BlockProducerUnderContention", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRingBufferBlockProducerStressTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSettings Settings;
+    Settings.RingBufferCapacity = 2;
+    Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+
+    FConsumedFrames Consumed;
+    {
+        FOmniCaptureRingBuffer RingBuffer;
+        RingBuffer.Initialize(Settings);
+        RingBuffer.AddSink(TEXT("Stress"), [&Consumed](const FOmniCaptureSharedFrame& Frame)
+        {
+            Consumed.Add(Frame->Metadata.FrameIndex);
+        });
+
+        RunStressProducers(RingBuffer);
+
+        TestEqual(TEXT("Blocking producers never drop"), RingBuffer.GetStats().DroppedFrames, 0);
+    }
+
+    TestEqual(TEXT("Every frame is consumed"), Consumed.FrameIndices.Num(), StressProducerCount * StressFramesPerProducer);
+    ValidateConsumedFrames(*this, Consumed.FrameIndices);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferStalledSinkTest, "OmniCapture.RingBuffer.StalledSinkDoesNotThrottleOthers", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRingBufferStalledSinkTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 FrameCount = 64;
+
+    FOmniCaptureSettings Settings;
+    Settings.RingBufferCapacity = 4;
+    Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+
+    FEvent* ReleaseStalledSink = FPlatformProcess::GetSynchEventFromPool(true);
+    FConsumedFrames FastFrames;
+    TAtomic<int32> MismatchedFrames(0);
+    TAtomic<const FOmniCaptureFrame*> LastFastFrame(nullptr);
+    FOmniCaptureRingBufferStats Stats;
+    {
+        FOmniCaptureRingBuffer RingBuffer;
+        RingBuffer.Initialize(Settings);
+        RingBuffer.AddSink(TEXT("Fast"), [&FastFrames, &LastFastFrame](const FOmniCaptureSharedFrame& Frame)
+        {
+            FastFrames.Add(Frame->Metadata.FrameIndex);
+            LastFastFrame = Frame.Get();
+        });
+        RingBuffer.AddSink(TEXT("Stalled"), [ReleaseStalledSink, &LastFastFrame, &MismatchedFrames](const FOmniCaptureSharedFrame& Frame)
+        {
+            ReleaseStalledSink->Wait();
+            // Both sinks see the one shared frame, not copies of it.
+            MismatchedFrames += Frame->Metadata.FrameIndex == FrameCount - 1 && LastFastFrame.Load() != Frame.Get() ? 1 : 0;
+        }, EOmniCaptureRingBufferPolicy::DropOldest, 2);
+
+        for (int32 Index = 0; Index < FrameCount; ++Index)
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = Index;
+            RingBuffer.Enqueue(MoveTemp(Frame));
+        }
+
+        // The producer got every frame through even though one sink has not finished a single frame.
+        const double TimeoutSeconds = FPlatformTime::Seconds() + 5.0;
+        while (FastFrames.Num() < FrameCount && FPlatformTime::Seconds() < TimeoutSeconds)
+        {
+            FPlatformProcess::Sleep(0.001f);
+        }
+        Stats = RingBuffer.GetStats();
+        ReleaseStalledSink->Trigger();
+    }
+    FPlatformProcess::ReturnSynchEventToPool(ReleaseStalledSink);
+
+    TestEqual(TEXT("The fast sink consumed every frame"), FastFrames.FrameIndices.Num(), FrameCount);
+    TestEqual(TEXT("One entry per sink"), Stats.Sinks.Num(), 2);
+    if (Stats.Sinks.Num() == 2)
+    {
+        TestEqual(TEXT("The fast sink never dropped"), Stats.Sinks[0].DroppedFrames, 0);
+        TestTrue(TEXT("The stalled sink shed its own backlog"), Stats.Sinks[1].DroppedFrames > 0);
+        TestEqual(TEXT("Buffer-wide drops are the stalled sink's"), Stats.DroppedFrames, Stats.Sinks[1].DroppedFrames);
+    }
+    TestEqual(TEXT("Sinks share the frame"), MismatchedFrames.Load(), 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferFlushWaitsForConsumerTest, "OmniCapture.RingBuffer.FlushWaitsForInFlightConsumer", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureRingBufferFlushWaitsForConsumerTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 FrameCount = 8;
+
+    FOmniCaptureSettings Settings;
+    Settings.RingBufferCapacity = 4;
+    Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::BlockProducer;
+
+    const uint32 FlushThreadId = FPlatformTLS::GetCurrentThreadId();
+    TAtomic<int32> ActiveConsumers(0);
+    TAtomic<int32> OverlappingConsumers(0);
+    TAtomic<int32> ConsumedOnFlushThread(0);
+    FConsumedFrames Consumed;
+    {
+        FOmniCaptureRingBuffer RingBuffer;
+        RingBuffer.Initialize(Settings);
+        RingBuffer.AddSink(TEXT("Slow"), [&](const FOmniCaptureSharedFrame& Frame)
+        {
+            OverlappingConsumers += ActiveConsumers.IncrementExchange() > 0 ? 1 : 0;
+            ConsumedOnFlushThread += FPlatformTLS::GetCurrentThreadId() == FlushThreadId ? 1 : 0;
+            // Long enough that Flush is reached while the worker is still inside the consumer.
+            FPlatformProcess::Sleep(0.005f);
+            Consumed.Add(Frame->Metadata.FrameIndex);
+            ActiveConsumers.DecrementExchange();
+        });
+
+        for (int32 Index = 0; Index < FrameCount; ++Index)
+        {
+            TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+            Frame->Metadata.FrameIndex = Index;
+            RingBuffer.Enqueue(MoveTemp(Frame));
+        }
+
+        RingBuffer.Flush();
+
+        TestEqual(TEXT("Flush returns only after every frame is consumed"), Consumed.Num(), FrameCount);
+        TestEqual(TEXT("No consumer is running after Flush"), ActiveConsumers.Load(), 0);
+    }
+
+    TestEqual(TEXT("Consumers never overlap"), OverlappingConsumers.Load(), 0);
+    TestEqual(TEXT("Flush never consumes on its own thread"), ConsumedOnFlushThread.Load(), 0);
+    for (int32 Index = 0; Index < Consumed.FrameIndices.Num(); ++Index)
+    {
+        TestEqual(TEXT("Frames are consumed in order"), Consumed.FrameIndices[Index], Index);
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureRingBufferEnqueueLatencyTest, "OmniCapture.RingBuffer.EnqueueLatency", EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+bool FOmniCaptureRingBufferEnqueueLatencyTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 FrameCount = 100000;
+
+    {
+        FLockedRingBuffer LockedRingBuffer;
+        AddInfo(FString::Printf(TEXT("Locked TQueue: %s"), *MeasureEnqueueLatency(FrameCount, [&LockedRingBuffer](TUniquePtr<FOmniCaptureFrame>&& Frame)
+        {
+            LockedRingBuffer.Enqueue(MoveTemp(Frame));
+        })));
+    }
+
+    {
+        FOmniCaptureSettings Settings;
+        Settings.RingBufferCapacity = 6;
+        Settings.RingBufferPolicy = EOmniCaptureRingBufferPolicy::DropOldest;
+
+        FOmniCaptureRingBuffer RingBuffer;
+        RingBuffer.Initialize(Settings);
+        RingBuffer.AddSink(TEXT("Null"), [](const FOmniCaptureSharedFrame&)
+        {
+        });
+        AddInfo(FString::Printf(TEXT("Lock-free ring: %s"), *MeasureEnqueueLatency(FrameCount, [&RingBuffer](TUniquePtr<FOmniCaptureFrame>&& Frame)
+        {
+            RingBuffer.Enqueue(MoveTemp(Frame));
+        })));
+        AddInfo(FString::Printf(TEXT("Lock-free ring dropped %d of %d frames"), RingBuffer.GetStats().DroppedFrames, FrameCount));
+    }
+
+    return true;
+}
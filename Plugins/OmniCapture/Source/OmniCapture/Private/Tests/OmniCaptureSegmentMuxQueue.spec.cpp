@@ -0,0 +1,185 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "OmniCaptureSegmentMuxQueue.h"
+
+namespace
+{
+    // Polls Predicate for up to TimeoutSeconds; the queue's muxes run on their own threads.
+    template <typename PredicateType>
+    bool WaitFor(PredicateType Predicate, double TimeoutSeconds = 5.0)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (!Predicate())
+        {
+            if (FPlatformTime::Seconds() > Deadline)
+            {
+                return false;
+            }
+            FPlatformProcess::Sleep(0.001f);
+        }
+        return true;
+    }
+
+    // A job with no muxer; the stub steps below stand in for FOmniCaptureMuxer::FinalizeCapture.
+    FOmniCaptureSegmentMuxQueue::FJobRef MakeJob(int32 SegmentIndex)
+    {
+        FOmniCaptureSegmentMuxQueue::FJobRef Job = MakeShared<FOmniCaptureSegmentMuxJob, ESPMode::ThreadSafe>();
+        Job->Segment.SegmentIndex = SegmentIndex;
+        Job->Status.SegmentIndex = SegmentIndex;
+        return Job;
+    }
+
+    FString StubOutputPath(const FOmniCaptureSegmentMuxJob& Job)
+    {
+        return FString::Printf(TEXT("Segment%d.mp4"), Job.Segment.SegmentIndex);
+    }
+
+    TArray<int32> ReportAll(FOmniCaptureSegmentMuxQueue& Queue)
+    {
+        TArray<int32> Reported;
+        Queue.ReportFinished([&Reported](const FOmniCaptureSegmentMuxJob& Job)
+        {
+            Reported.Add(Job.Segment.SegmentIndex);
+        });
+        return Reported;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureSegmentMuxQueueOrderTest, "OmniCapture.SegmentMuxQueue.ReportsInQueueOrder", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureSegmentMuxQueueOrderTest::RunTest(const FString& Parameters)
+{
+    FEvent* ReleaseFirst = FPlatformProcess::GetSynchEventFromPool(true);
+    FOmniCaptureSegmentMuxQueue Queue([ReleaseFirst](FOmniCaptureSegmentMuxJob& Job, FString& OutOutputPath)
+    {
+        if (Job.Segment.SegmentIndex == 0)
+        {
+            ReleaseFirst->Wait();
+        }
+        OutOutputPath = StubOutputPath(Job);
+        return true;
+    });
+
+    Queue.Reset(2);
+    Queue.Submit(MakeJob(0));
+    Queue.Submit(MakeJob(1));
+
+    // The second segment finishes while the first is still muxing; it must not be reported ahead of it.
+    TestTrue(TEXT("The later segment finishes first"), WaitFor([&Queue]()
+    {
+        const TArray<FOmniCaptureSegmentMuxStatus> Status = Queue.GetStatus();
+        return Status.Num() == 2 && Status[1].State == EOmniCaptureSegmentMuxState::Succeeded;
+    }));
+    TestEqual(TEXT("Nothing is reported while the first segment is muxing"), ReportAll(Queue).Num(), 0);
+    TestEqual(TEXT("The running mux is shown as muxing"), Queue.GetStatus()[0].State, EOmniCaptureSegmentMuxState::Muxing);
+
+    ReleaseFirst->Trigger();
+    Queue.WaitUntilIdle();
+
+    const TArray<int32> Reported = ReportAll(Queue);
+    TestEqual(TEXT("Both segments are reported"), Reported.Num(), 2);
+    if (Reported.Num() == 2)
+    {
+        TestEqual(TEXT("The first segment is reported first"), Reported[0], 0);
+        TestEqual(TEXT("The second segment is reported second"), Reported[1], 1);
+    }
+    TestEqual(TEXT("Each segment is reported once"), ReportAll(Queue).Num(), 0);
+
+    const TArray<FOmniCaptureSegmentMuxStatus> Status = Queue.GetStatus();
+    TestEqual(TEXT("The muxed file is recorded"), Status[0].OutputPath, FString(TEXT("Segment0.mp4")));
+
+    FPlatformProcess::ReturnSynchEventToPool(ReleaseFirst);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureSegmentMuxQueueFailureTest, "OmniCapture.SegmentMuxQueue.SurfacesFailures", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureSegmentMuxQueueFailureTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureSegmentMuxQueue Queue([](FOmniCaptureSegmentMuxJob& Job, FString& OutOutputPath)
+    {
+        OutOutputPath = StubOutputPath(Job);
+        return Job.Segment.SegmentIndex != 1;
+    });
+
+    Queue.Reset(2);
+    for (int32 SegmentIndex = 0; SegmentIndex < 3; ++SegmentIndex)
+    {
+        Queue.Submit(MakeJob(SegmentIndex));
+    }
+    Queue.WaitUntilIdle();
+
+    TArray<int32> Reported;
+    TArray<bool> Succeeded;
+    Queue.ReportFinished([&Reported, &Succeeded](const FOmniCaptureSegmentMuxJob& Job)
+    {
+        Reported.Add(Job.Segment.SegmentIndex);
+        Succeeded.Add(Job.bSucceeded);
+    });
+
+    TestEqual(TEXT("A failed segment is still reported"), Reported.Num(), 3);
+    if (Succeeded.Num() == 3)
+    {
+        TestTrue(TEXT("The first segment succeeded"), Succeeded[0]);
+        TestFalse(TEXT("The failure reaches the report"), Succeeded[1]);
+        TestTrue(TEXT("A failure does not stop later segments"), Succeeded[2]);
+    }
+
+    const TArray<FOmniCaptureSegmentMuxStatus> Status = Queue.GetStatus();
+    TestEqual(TEXT("The failed segment's state is Failed"), Status[1].State, EOmniCaptureSegmentMuxState::Failed);
+    TestTrue(TEXT("A failed segment names no output"), Status[1].OutputPath.IsEmpty());
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureSegmentMuxQueueCancelTest, "OmniCapture.SegmentMuxQueue.CancelSkipsPendingMuxes", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureSegmentMuxQueueCancelTest::RunTest(const FString& Parameters)
+{
+    FEvent* FirstStarted = FPlatformProcess::GetSynchEventFromPool(true);
+    TAtomic<int32> MuxedSegments(0);
+    FOmniCaptureSegmentMuxQueue* QueuePtr = nullptr;
+    FOmniCaptureSegmentMuxQueue Queue([FirstStarted, &MuxedSegments, &QueuePtr](FOmniCaptureSegmentMuxJob& Job, FString& OutOutputPath)
+    {
+        ++MuxedSegments;
+        if (Job.Segment.SegmentIndex == 0)
+        {
+            // Keep muxing until the capture is abandoned, so the other segments are still queued behind it.
+            FirstStarted->Trigger();
+            while (!QueuePtr->IsCancelled())
+            {
+                FPlatformProcess::Sleep(0.001f);
+            }
+        }
+        OutOutputPath = StubOutputPath(Job);
+        return true;
+    });
+    QueuePtr = &Queue;
+
+    Queue.Reset(1);
+    for (int32 SegmentIndex = 0; SegmentIndex < 3; ++SegmentIndex)
+    {
+        Queue.Submit(MakeJob(SegmentIndex));
+    }
+
+    TestTrue(TEXT("The first mux starts"), FirstStarted->Wait(5000));
+    Queue.Cancel();
+
+    const TArray<FOmniCaptureSegmentMuxStatus> Status = Queue.GetStatus();
+    TestEqual(TEXT("Only the running mux ran"), MuxedSegments.Load(), 1);
+    TestEqual(TEXT("The running mux finishes"), Status[0].State, EOmniCaptureSegmentMuxState::Succeeded);
+    TestEqual(TEXT("Queued muxes are cancelled"), Status[1].State, EOmniCaptureSegmentMuxState::Cancelled);
+    TestEqual(TEXT("Every queued mux is cancelled"), Status[2].State, EOmniCaptureSegmentMuxState::Cancelled);
+
+    const TArray<int32> Reported = ReportAll(Queue);
+    TestEqual(TEXT("Cancelled muxes are not reported"), Reported.Num(), 1);
+
+    // The next capture starts from a clean queue that muxes again.
+    Queue.Reset(1);
+    Queue.Submit(MakeJob(3));
+    Queue.WaitUntilIdle();
+    TestEqual(TEXT("Reset forgets the cancelled capture"), Queue.Num(), 1);
+    TestEqual(TEXT("Reset clears the cancellation"), Queue.GetStatus()[0].State, EOmniCaptureSegmentMuxState::Succeeded);
+
+    FPlatformProcess::ReturnSynchEventToPool(FirstStarted);
+    return true;
+}
@@ -0,0 +1,110 @@
+#include "Misc/AutomationTest.h"
+
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "OmniCaptureContainer.h"
+#include "OmniCaptureImageWriter.h"
+#include "OmniCaptureTestUtils.h"
+
+namespace
+{
+    FString MakeSegmentSizeTestDirectory(const TCHAR* Name)
+    {
+        return OmniCaptureTests::MakeTestDirectory(TEXT("OmniCaptureSegmentSize"), Name);
+    }
+
+    TUniquePtr<FOmniCaptureFrame> MakeSegmentSizeTestFrame(const FIntPoint& Size, int32 FrameIndex)
+    {
+        return OmniCaptureTests::MakeColor8Frame(Size, FrameIndex, FColor(static_cast<uint8>(FrameIndex), static_cast<uint8>(FrameIndex >> 8), 0, 255), 60.0);
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureSegmentSizeLooseFilesTest, "OmniCapture.SegmentSize.MatchesFilesOnDisk", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureSegmentSizeLooseFilesTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeSegmentSizeTestDirectory(TEXT("Loose"));
+    constexpr int32 FrameCount = 12;
+
+    FOmniCaptureSettings Settings;
+    Settings.OutputFileName = TEXT("Shot");
+    Settings.PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth8;
+
+    // Raw frames land in padded segments beside an index, which the count has to include as well.
+    for (const EOmniCaptureImageFormat Format : { EOmniCaptureImageFormat::PNG, EOmniCaptureImageFormat::BMP, EOmniCaptureImageFormat::Raw })
+    {
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+        Settings.ImageFormat = Format;
+
+        FOmniCaptureImageWriter Writer;
+        Writer.Initialize(Settings, Directory);
+        for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+        {
+            Writer.EnqueueFrame(MakeSegmentSizeTestFrame(FIntPoint(37, 11), FrameIndex), FString::Printf(TEXT("Shot_%06d%s"), FrameIndex, *Settings.GetImageFileExtension()));
+        }
+        Writer.Flush();
+
+        int64 BytesOnDisk = 0;
+        IFileManager::Get().IterateDirectoryStat(*Directory, [&BytesOnDisk](const TCHAR*, const FFileStatData& StatData)
+        {
+            BytesOnDisk += StatData.bIsDirectory ? 0 : StatData.FileSize;
+            return true;
+        });
+        TestTrue(TEXT("Something was written"), BytesOnDisk > 0);
+        TestEqual(FString::Printf(TEXT("Counted bytes match the %s files on disk"), *Settings.GetImageFileExtension()), Writer.GetBytesWritten(), BytesOnDisk);
+    }
+
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
+
+// A long take used to make every size check walk the output directory; the count must stay exact without one.
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureSegmentSizeLongTakeTest, "OmniCapture.SegmentSize.HundredThousandFrames", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureSegmentSizeLongTakeTest::RunTest(const FString& Parameters)
+{
+    const FString Directory = MakeSegmentSizeTestDirectory(TEXT("LongTake"));
+    constexpr int32 FrameCount = 100000;
+
+    FOmniCaptureSettings Settings;
+    Settings.OutputFileName = TEXT("Take");
+    Settings.ImageFormat = EOmniCaptureImageFormat::BMP;
+    // Packed into the container so the test does not leave 100k files behind.
+    Settings.bWriteFrameContainer = true;
+
+    FOmniCaptureImageWriter Writer;
+    Writer.Initialize(Settings, Directory);
+
+    int64 LastBytes = 0;
+    bool bMonotonic = true;
+    double SlowestCheckSeconds = 0.0;
+    for (int32 FrameIndex = 0; FrameIndex < FrameCount; ++FrameIndex)
+    {
+        Writer.EnqueueFrame(MakeSegmentSizeTestFrame(FIntPoint(2, 2), FrameIndex), FString::Printf(TEXT("Take_%06d.bmp"), FrameIndex));
+
+        // What the subsystem does every tick while a size limit is set.
+        const double CheckStart = FPlatformTime::Seconds();
+        const int64 Bytes = Writer.GetBytesWritten();
+        SlowestCheckSeconds = FMath::Max(SlowestCheckSeconds, FPlatformTime::Seconds() - CheckStart);
+
+        bMonotonic &= Bytes >= LastBytes;
+        LastBytes = Bytes;
+    }
+    Writer.Flush();
+
+    TestTrue(TEXT("The count never goes backwards"), bMonotonic);
+    AddInfo(FString::Printf(TEXT("Slowest size check over %d frames: %.3f ms"), FrameCount, SlowestCheckSeconds * 1000.0));
+    TestEqual(TEXT("Writes succeed"), Writer.GetWriterPoolStats().FailedTasks, 0);
+
+    FOmniCaptureContainerReader Reader;
+    if (!TestTrue(TEXT("The container opens"), Reader.Open(FOmniCaptureContainerWriter::GetContainerPath(Directory, Settings.OutputFileName))))
+    {
+        return false;
+    }
+
+    TestEqual(TEXT("Every frame is written"), Reader.GetEntries().Num(), FrameCount);
+    TestEqual(TEXT("The count is the container's size on disk"), Writer.GetBytesWritten(), IFileManager::Get().FileSize(*FOmniCaptureContainerWriter::GetContainerPath(Directory, Settings.OutputFileName)));
+
+    Reader.Close();
+    IFileManager::Get().DeleteDirectory(*Directory, false, true);
+    return true;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+#include "OmniCaptureTypes.h"
+
+namespace OmniCaptureTests
+{
+    // Absolute path to an emptied Suite/Name directory under the automation transient dir. The directory itself is not created.
+    inline FString MakeTestDirectory(const TCHAR* Suite, const TCHAR* Name)
+    {
+        const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::AutomationTransientDir() / Suite / Name);
+        IFileManager::Get().DeleteDirectory(*Directory, false, true);
+        return Directory;
+    }
+
+    // Color8 frame of Size filled with Fill, stamped with FrameIndex on a FrameRate clock. Frame 0 is the key frame.
+    inline TUniquePtr<FOmniCaptureFrame> MakeColor8Frame(const FIntPoint& Size, int32 FrameIndex, const FColor& Fill, double FrameRate = 30.0)
+    {
+        TUniquePtr<FOmniCaptureFrame> Frame = MakeUnique<FOmniCaptureFrame>();
+        Frame->Metadata.FrameIndex = FrameIndex;
+        Frame->Metadata.Timecode = FrameIndex / FrameRate;
+        Frame->Metadata.bKeyFrame = FrameIndex == 0;
+
+        TUniquePtr<TImagePixelData<FColor>> Pixels = MakeUnique<TImagePixelData<FColor>>(Size);
+        Pixels->Pixels.Init(Fill, static_cast<int64>(Size.X) * Size.Y);
+        Frame->PixelData = MoveTemp(Pixels);
+        Frame->PixelDataType = EOmniCapturePixelDataType::Color8;
+        return Frame;
+    }
+
+    // The Color8 pixels of a frame built by MakeColor8Frame.
+    inline TArray64<FColor>& GetColor8Pixels(FOmniCaptureFrame& Frame)
+    {
+        return static_cast<TImagePixelData<FColor>*>(Frame.PixelData.Get())->Pixels;
+    }
+}
@@ -0,0 +1,106 @@
+#include "Misc/AutomationTest.h"
+
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "OmniCaptureWriterPool.h"
+
+namespace
+{
+    // Polls Predicate for up to TimeoutSeconds; the pool's workers run on their own threads.
+    template <typename PredicateType>
+    bool WaitFor(PredicateType Predicate, double TimeoutSeconds = 5.0)
+    {
+        const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+        while (!Predicate())
+        {
+            if (FPlatformTime::Seconds() > Deadline)
+            {
+                return false;
+            }
+            FPlatformProcess::Sleep(0.001f);
+        }
+        return true;
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureWriterPoolAdmissionTest, "OmniCapture.WriterPool.AdmitsByBytesInFlight", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureWriterPoolAdmissionTest::RunTest(const FString& Parameters)
+{
+    FOmniCaptureWriterPool Pool(TEXT("Test"), 2, 0, TPri_Normal, 100);
+    FEvent* ReleaseFirst = FPlatformProcess::GetSynchEventFromPool(true);
+    TAtomic<int32> CompletedTasks(0);
+
+    Pool.Submit([ReleaseFirst, &CompletedTasks]()
+    {
+        ReleaseFirst->Wait();
+        ++CompletedTasks;
+        return true;
+    }, 60);
+
+    // A second 60-byte payload would take the pool to 120 of its 100 bytes, so it has to wait even with a worker free.
+    TAtomic<bool> bSecondAdmitted(false);
+    TFuture<void> Producer = Async(EAsyncExecution::Thread, [&Pool, &CompletedTasks, &bSecondAdmitted]()
+    {
+        Pool.Submit([&CompletedTasks]()
+        {
+            ++CompletedTasks;
+            return true;
+        }, 60);
+        bSecondAdmitted = true;
+    });
+
+    TestTrue(TEXT("The first task starts"), WaitFor([&Pool]() { return Pool.GetStats().ActiveTasks == 1; }));
+    FPlatformProcess::Sleep(0.05f);
+    TestFalse(TEXT("A payload over the byte budget waits"), bSecondAdmitted.Load());
+    TestEqual(TEXT("Only the admitted payload counts as in flight"), Pool.GetStats().BytesInFlight, static_cast<int64>(60));
+
+    ReleaseFirst->Trigger();
+    Producer.Wait();
+    Pool.WaitUntilIdle();
+
+    FOmniCaptureWriterPoolStats Stats = Pool.GetStats();
+    TestEqual(TEXT("Both tasks ran"), CompletedTasks.Load(), 2);
+    TestEqual(TEXT("The second submit was throttled"), Stats.ThrottledSubmits, 1);
+    TestEqual(TEXT("The budget was never exceeded"), Stats.PeakBytesInFlight, static_cast<int64>(60));
+    TestEqual(TEXT("Nothing is left in flight"), Stats.BytesInFlight, static_cast<int64>(0));
+
+    // A payload bigger than the whole budget still goes through when nothing else is in flight.
+    Pool.Submit([&CompletedTasks]()
+    {
+        ++CompletedTasks;
+        return true;
+    }, 500);
+    Pool.WaitUntilIdle();
+
+    Stats = Pool.GetStats();
+    TestEqual(TEXT("An oversized payload is admitted on an idle pool"), CompletedTasks.Load(), 3);
+    TestEqual(TEXT("Completed tasks are counted"), Stats.CompletedTasks, 3);
+    TestEqual(TEXT("The worker count is reported"), Stats.WorkerCount, 2);
+
+    FPlatformProcess::ReturnSynchEventToPool(ReleaseFirst);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FOmniCaptureWriterPoolDrainTest, "OmniCapture.WriterPool.DrainsOnShutdown", EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+bool FOmniCaptureWriterPoolDrainTest::RunTest(const FString& Parameters)
+{
+    constexpr int32 TaskCount = 64;
+    TAtomic<int32> CompletedTasks(0);
+    {
+        FOmniCaptureWriterPool Pool(TEXT("Test"), 4, 0, TPri_Normal, 0);
+        for (int32 Index = 0; Index < TaskCount; ++Index)
+        {
+            Pool.Submit([&CompletedTasks]()
+            {
+                FPlatformProcess::Sleep(0.001f);
+                ++CompletedTasks;
+                return true;
+            }, 1024);
+        }
+    }
+
+    TestEqual(TEXT("Destroying the pool finishes every queued task"), CompletedTasks.Load(), TaskCount);
+    return true;
+}
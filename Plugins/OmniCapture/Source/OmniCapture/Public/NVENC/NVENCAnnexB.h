@@ -24,6 +24,21 @@ namespace OmniNVENC
          */
         void SetCodecConfig(const TArray<uint8>& InData);
 
+        /** Splits an Annex B byte stream into its NAL units, without start codes. Accepts 3 and 4 byte start codes. */
+        static void SplitNALUnits(const uint8* Data, int64 Size, TArray<TArrayView<const uint8>>& OutUnits);
+
+        /**
+         * Rewrites an Annex B access unit as the 4-byte length-prefixed NAL units an MP4 sample holds. Parameter sets,
+         * access unit delimiters and filler are dropped; they live in the sample entry instead.
+         */
+        static void ToLengthPrefixed(const uint8* Data, int64 Size, bool bHEVC, TArray<uint8>& OutSample);
+
+        /** Builds an avcC AVCDecoderConfigurationRecord from the SPS and PPS found in Annex B data. */
+        static bool BuildAVCDecoderConfigurationRecord(const uint8* Data, int64 Size, TArray<uint8>& OutRecord);
+
+        /** Builds an hvcC HEVCDecoderConfigurationRecord from the VPS, SPS and PPS found in Annex B data. */
+        static bool BuildHEVCDecoderConfigurationRecord(const uint8* Data, int64 Size, TArray<uint8>& OutRecord);
+
     private:
         TArray<uint8> CodecConfig;
     };
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+// Windowed-sinc resampler over an interleaved float FIFO. The step between output frames is given per call, so the
+// ratio can be steered a little at a time without clicks. At a ratio of exactly 1 with no fractional offset the
+// input passes through unchanged.
+class OMNICAPTURE_API FOmniCaptureAudioResampler
+{
+public:
+    // Input frames on each side of the read position that contribute to an output frame.
+    static constexpr int32 HalfTaps = 16;
+
+    void Reset(int32 InNumChannels);
+    int32 GetNumChannels() const { return NumChannels; }
+
+    void AddInput(const int16* Samples, int32 NumFrames);
+    void AddSilence(int32 NumFrames);
+    // Drops input ahead of the read position, at most what is buffered.
+    void Skip(double NumFrames);
+
+    // Input frames ahead of the read position that can be consumed now; the filter's look-ahead is not counted.
+    double GetBufferedFrames() const;
+
+    // Writes up to MaxFrames interleaved frames, advancing Ratio input frames per output frame. Returns the frames
+    // written, fewer than MaxFrames when the input runs out.
+    int32 Process(double Ratio, float* Output, int32 MaxFrames);
+
+private:
+    void Compact();
+
+    TArray<float> Buffer;
+    int32 NumChannels = 0;
+    // In frames from the start of Buffer. Always at least HalfTaps - 1 so the filter has history to read.
+    double ReadPosition = 0.0;
+};
+
+struct FOmniCaptureAudioClockStats
+{
+    // Input buffered beyond what the video timeline has asked for, smoothed. Negative when audio is late.
+    double LockErrorMilliseconds = 0.0;
+    // Current resampling correction in parts per million; positive when input is consumed faster than real time.
+    double CorrectionPPM = 0.0;
+    int64 InputFrames = 0;
+    int64 OutputFrames = 0;
+    // Times the error exceeded what resampling may correct and input was skipped or silence inserted instead.
+    int32 Resyncs = 0;
+    // Frames whose audio the input could not cover when they asked for it.
+    int32 Underruns = 0;
+};
+
+// Puts captured audio on the video timeline. Input blocks arrive in whatever sizes and at whatever times the audio
+// device delivers them; Produce cuts exactly the samples between the previous video timestamp and the given one, so
+// sample N of the output always sits at Origin + N / SampleRate. The audio device clock and the video clock drift
+// apart over a long take; a PI controller steers a bounded resampling ratio to keep the buffered input near zero
+// instead of dropping or repeating blocks. Only errors beyond MaxBacklogSeconds, such as a stalled audio device,
+// are fixed by skipping input or inserting silence. Not thread safe; the recorder drives it from the game thread.
+class OMNICAPTURE_API FOmniCaptureAudioClock
+{
+public:
+    // 0.5% corrects up to 5 ms of drift per second, well beyond any real device, with no audible pitch change.
+    static constexpr double DefaultMaxRatioDeviation = 0.005;
+    static constexpr double MaxBacklogSeconds = 0.25;
+
+    FOmniCaptureAudioClock();
+
+    void Reset();
+    void SetMaxRatioDeviation(double InMaxRatioDeviation);
+
+    // Queues a block timestamped on the audio clock. A short gap after the previous block is filled with silence so
+    // later audio keeps its place. After a gap longer than MaxBacklogSeconds, or when input first starts, the block is
+    // taken to be current and the output is padded up to it. A change of format starts the input over.
+    void AddInput(const FOmniAudioPacket& Packet);
+
+    // Emits the audio for the video time between the previous call and VideoTimestamp. The first call only sets the
+    // origin and drops what was captured before it. Returns false when there is nothing to emit; a frame whose audio
+    // has not arrived yet gets what there is, and the rest leads the next frame's packet.
+    bool Produce(double VideoTimestamp, FOmniAudioPacket& OutPacket);
+
+    FOmniCaptureAudioClockStats GetStats() const { return Stats; }
+
+private:
+    void UpdateCorrection(double Backlog, double DeltaSeconds);
+
+    FOmniCaptureAudioResampler Resampler;
+    int32 SampleRate = 0;
+    double MaxRatioDeviation = DefaultMaxRatioDeviation;
+
+    bool bHasInputTime = false;
+    double NextInputTimestamp = 0.0;
+    // Set when the buffered input starts afresh and belongs at the present rather than after what was emitted.
+    bool bRealign = false;
+    bool bRealignAfterGap = false;
+
+    bool bHasOrigin = false;
+    double Origin = 0.0;
+    double LastVideoTimestamp = 0.0;
+    int64 EmittedFrames = 0;
+
+    double SmoothedBacklog = 0.0;
+    double IntegratedBacklog = 0.0;
+    double Ratio = 1.0;
+    TArray<float> OutputScratch;
+
+    FOmniCaptureAudioClockStats Stats;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "OmniCaptureTypes.h"
+
+class FEvent;
+class IFileHandle;
+
+struct FOmniCaptureAudioFileStats
+{
+    // Sample frames that reached the file.
+    int64 FramesWritten = 0;
+    // Header included.
+    int64 BytesWritten = 0;
+    // Writes that had to wait for the writer thread because the queue was full.
+    int32 BlockedWrites = 0;
+    // Packets refused because their format differed from the file's.
+    int32 RejectedPackets = 0;
+    bool bFailed = false;
+};
+
+// Streams 16-bit PCM into a WAV or CAF file while the capture runs, so a long take never sits in memory and closing
+// it costs one header patch. Packets are gathered into chunks of ChunkBytes on the caller's thread and written by the
+// writer's own thread; Write waits while MaxQueuedChunks chunks are pending.
+//
+// WAV files reserve a JUNK chunk where an RF64 ds64 chunk goes, and the header sizes are rewritten after every chunk,
+// so a crash loses at most the chunk in flight; a take that passes 4 GB becomes RF64. CAF files carry an open-ended
+// data chunk until Close, which players read to the end of the file. RecoverFile repairs either kind when the process
+// died before Close.
+class OMNICAPTURE_API FOmniCaptureAudioFileWriter final : public FRunnable
+{
+public:
+    static constexpr int32 ChunkBytes = 256 * 1024;
+    static constexpr int32 MaxQueuedChunks = 32;
+
+    FOmniCaptureAudioFileWriter();
+    virtual ~FOmniCaptureAudioFileWriter() override;
+
+    // Creates the file, writes its header and starts the writer thread.
+    bool Open(const FString& InPath, EOmniCaptureAudioFileFormat InFormat, int32 InSampleRate, int32 InNumChannels);
+    // False when the packet's format differs from the file's or the file can no longer be written.
+    bool Write(const FOmniAudioPacket& Packet);
+    // Writes what is left, patches the header and closes the file. True when every sample reached the disk.
+    bool Close();
+
+    bool IsOpen() const { return Thread.IsValid(); }
+    const FString& GetPath() const { return Path; }
+    int32 GetSampleRate() const { return SampleRate; }
+    int32 GetNumChannels() const { return NumChannels; }
+    FOmniCaptureAudioFileStats GetStats() const;
+
+    static const TCHAR* GetExtension(EOmniCaptureAudioFileFormat Format);
+    // The header the writer puts in front of DataBytes of PCM; always the same size for a format. A negative
+    // DataBytes gives the header of a file still being written.
+    static TArray<uint8> BuildHeader(EOmniCaptureAudioFileFormat Format, int32 SampleRate, int32 NumChannels, int64 DataBytes);
+    // Rewrites the sizes in the header of a WAV, RF64 or CAF file whose writer never closed it, counting every whole
+    // sample frame on disk. Files this writer did not produce are patched in place when their sizes fit.
+    static bool RecoverFile(const FString& FilePath);
+
+    //~ FRunnable
+    virtual uint32 Run() override;
+
+private:
+    bool QueueChunk(TArray<uint8>&& Chunk);
+    bool WriteChunk(const TArray<uint8>& Chunk);
+    bool PatchHeader();
+
+    FString Path;
+    EOmniCaptureAudioFileFormat Format = EOmniCaptureAudioFileFormat::WAV;
+    int32 SampleRate = 0;
+    int32 NumChannels = 0;
+    int64 HeaderBytes = 0;
+    // Filled by Write until it holds a chunk; only touched by the caller's thread.
+    TArray<uint8> PendingChunk;
+
+    // Only touched by the writer thread once it runs.
+    TUniquePtr<IFileHandle> File;
+    int64 DataBytes = 0;
+
+    TUniquePtr<FRunnableThread> Thread;
+    mutable FCriticalSection CriticalSection;
+    TArray<TArray<uint8>> Queue;
+    FOmniCaptureAudioFileStats Stats;
+    bool bInputClosed = false;
+
+    FEvent* WorkEvent = nullptr;
+    FEvent* SpaceEvent = nullptr;
+};
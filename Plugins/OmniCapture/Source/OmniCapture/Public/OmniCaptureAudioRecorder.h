@@ -1,6 +1,9 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "OmniCaptureAudioClock.h"
+#include "OmniCaptureAudioFileWriter.h"
+#include "OmniCaptureAudioRing.h"
 #include "OmniCaptureTypes.h"
 #include "Templates/Atomic.h"
 
@@ -19,11 +22,22 @@ public:
 
     bool Initialize(UWorld* InWorld, const FOmniCaptureSettings& Settings);
     void Start();
-    void Stop(const FString& OutputDirectory, const FString& BaseFileName);
+    // Closes the audio file; GetOutputFilePath is empty afterwards when no audio reached it.
+    void Stop();
 
+    // Adds the audio between the previous frame and this one, resampled onto the video timeline, as one packet.
     void GatherAudio(double FrameTimestamp, TArray<FOmniAudioPacket>& OutPackets);
     FString GetDebugStatus() const;
     int32 GetPendingPacketCount() const;
+    // Blocks the audio thread could not fit into the ring.
+    int32 GetDroppedPacketCount() const { return DroppedPacketCount.Load(); }
+    // Frames gathered while recording that found no audio waiting.
+    int32 GetUnderrunCount() const { return UnderrunCount.Load(); }
+    // Published after every frame so the muxer's thread can read them.
+    int32 GetClockCorrectionPPM() const { return ClockCorrectionPPM.Load(); }
+    int32 GetClockResyncCount() const { return ClockResyncCount.Load(); }
+    // Size of the audio file so far, header included.
+    int64 GetBytesWritten() const { return FileWriter.GetStats().BytesWritten; }
 
     void SetPaused(bool bInPaused);
     bool IsPaused() const { return bPaused.Load(); }
@@ -40,17 +54,25 @@ private:
     bool bIsRecording = false;
     float Gain = 1.0f;
     FString OutputFilePath;
+    EOmniCaptureAudioFileFormat FileFormat = EOmniCaptureAudioFileFormat::WAV;
+    // Opened on the first packet the clock produces, so the file starts with the first video frame.
+    FOmniCaptureAudioFileWriter FileWriter;
+    bool bFileWriterFailed = false;
 
-    mutable FCriticalSection PacketCS;
-    TQueue<FOmniAudioPacket, EQueueMode::Mpsc> PendingPackets;
+    // Filled on the audio render thread, drained on the game thread.
+    FOmniCaptureAudioRing SampleRing;
+    // Game thread only.
+    FOmniCaptureAudioClock AudioClock;
     TWeakObjectPtr<USoundSubmix> TargetSubmix;
     class FOmniCaptureSubmixListener* SubmixListener = nullptr;
     class Audio::FMixerDevice* MixerDevice = nullptr;
     double AudioClockOrigin = -1.0;
     double AudioStartTime = 0.0;
-    int32 CachedSampleRate = 48000;
-    TAtomic<int32> PendingPacketCount = 0;
+    TAtomic<int32> CachedSampleRate = 48000;
     TAtomic<int32> DroppedPacketCount = 0;
+    TAtomic<int32> UnderrunCount = 0;
+    TAtomic<int32> ClockCorrectionPPM = 0;
+    TAtomic<int32> ClockResyncCount = 0;
     TAtomic<bool> bPaused = false;
     TAtomic<bool> bLoggedOverflowWarning = false;
 };
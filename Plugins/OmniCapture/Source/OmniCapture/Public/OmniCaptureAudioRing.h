@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+#include <atomic>
+
+// Single-producer, single-consumer ring of 16-bit PCM blocks between the audio render thread and the game thread.
+// Sample storage and block descriptors are allocated once in Initialize; Write converts straight into the ring and
+// never locks or allocates, so the audio thread cannot stall on the game thread. A write that does not fit is refused
+// rather than blocking; the caller counts it as a drop.
+class OMNICAPTURE_API FOmniCaptureAudioRing
+{
+public:
+    FOmniCaptureAudioRing() = default;
+    FOmniCaptureAudioRing(const FOmniCaptureAudioRing&) = delete;
+    FOmniCaptureAudioRing& operator=(const FOmniCaptureAudioRing&) = delete;
+
+    // Not thread safe; call before the producer starts.
+    void Initialize(int32 InMaxBlocks, int32 InMaxSamples);
+    bool IsInitialized() const { return SampleCapacity > 0; }
+
+    // Producer. Applies Gain, clamps and converts NumSamples interleaved floats into one block. False when the ring
+    // lacks room for the block, in which case nothing is written.
+    bool Write(const float* Samples, int32 NumSamples, int32 NumChannels, int32 SampleRate, double Timestamp, float Gain);
+
+    // Consumer. Timestamp of the oldest block, if any.
+    bool PeekTimestamp(double& OutTimestamp) const;
+    // Consumer. Copies the oldest block out into a packet and frees its space.
+    bool Read(FOmniAudioPacket& OutPacket);
+    // Consumer. Frees every block written so far.
+    void DiscardAll();
+
+    // Snapshot only.
+    int32 GetPendingBlockCount() const;
+
+    // Gain, clamp to [-1, 1] and round to 16-bit PCM, eight samples at a time where vector intrinsics are available.
+    static void ConvertToPCM16(const float* Source, int16* Destination, int32 Count, float Gain);
+
+private:
+    struct FBlock
+    {
+        double Timestamp = 0.0;
+        uint64 SampleStart = 0;
+        int32 NumSamples = 0;
+        int32 SampleRate = 0;
+        int32 NumChannels = 0;
+    };
+
+    TArray<int16> Samples;
+    TArray<FBlock> Blocks;
+    uint64 SampleCapacity = 0;
+    uint64 BlockCapacity = 0;
+
+    // Producer-owned; the consumer learns where samples live from the block descriptors.
+    uint64 SampleWritePosition = 0;
+
+    // Written by one side each and read by the other; kept on separate cache lines.
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> BlockWritePosition{0};
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> BlockReadPosition{0};
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> SampleReadPosition{0};
+};
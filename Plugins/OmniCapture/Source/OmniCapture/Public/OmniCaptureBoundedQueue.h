@@ -0,0 +1,113 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <atomic>
+
+// Fixed-capacity lock-free queue for any number of producers and consumers (Vyukov's bounded MPMC ring). Slots are
+// allocated once; every slot carries a sequence number that tells producers and consumers whose turn it is, so
+// neither side ever takes a lock. The scheme needs at least two slots.
+template <typename ElementType>
+class TOmniCaptureBoundedQueue
+{
+public:
+    explicit TOmniCaptureBoundedQueue(uint32 InCapacity)
+    {
+        Capacity = FMath::Max(2u, InCapacity);
+        Slots = MakeUnique<FSlot[]>(Capacity);
+        for (uint32 Index = 0; Index < Capacity; ++Index)
+        {
+            Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+        }
+        EnqueuePosition.store(0, std::memory_order_relaxed);
+        DequeuePosition.store(0, std::memory_order_relaxed);
+    }
+
+    TOmniCaptureBoundedQueue(const TOmniCaptureBoundedQueue&) = delete;
+    TOmniCaptureBoundedQueue& operator=(const TOmniCaptureBoundedQueue&) = delete;
+
+    // Moves Item into the queue and returns true, or leaves Item untouched and returns false if the queue is full.
+    bool TryEnqueue(ElementType& Item)
+    {
+        uint64 Position = EnqueuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            FSlot& Slot = Slots[Position % Capacity];
+            const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+            const int64 Difference = static_cast<int64>(Sequence) - static_cast<int64>(Position);
+            if (Difference == 0)
+            {
+                if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    Slot.Value = MoveTemp(Item);
+                    Slot.Sequence.store(Position + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Position = EnqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool TryDequeue(ElementType& OutItem)
+    {
+        uint64 Position = DequeuePosition.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            FSlot& Slot = Slots[Position % Capacity];
+            const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+            const int64 Difference = static_cast<int64>(Sequence) - static_cast<int64>(Position + 1);
+            if (Difference == 0)
+            {
+                if (DequeuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed))
+                {
+                    OutItem = MoveTemp(Slot.Value);
+                    Slot.Value = ElementType();
+                    Slot.Sequence.store(Position + Capacity, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (Difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                Position = DequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Snapshot only; other threads may change the queue before the caller acts on it.
+    bool IsEmpty() const
+    {
+        const uint64 Position = DequeuePosition.load(std::memory_order_acquire);
+        const uint64 Sequence = Slots[Position % Capacity].Sequence.load(std::memory_order_acquire);
+        return static_cast<int64>(Sequence) - static_cast<int64>(Position + 1) < 0;
+    }
+
+    uint32 GetCapacity() const
+    {
+        return Capacity;
+    }
+
+private:
+    struct FSlot
+    {
+        std::atomic<uint64> Sequence;
+        ElementType Value;
+    };
+
+    TUniquePtr<FSlot[]> Slots;
+    uint32 Capacity = 0;
+
+    // Producers and consumers hammer different counters; keep them on separate cache lines.
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePosition;
+    alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> DequeuePosition;
+};
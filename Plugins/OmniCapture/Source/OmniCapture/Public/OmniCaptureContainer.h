@@ -0,0 +1,142 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Single-file capture container (<OutputFileName>.omnicap) holding every encoded image of a segment, so a long take
+// is one file instead of hundreds of thousands. Layout: an FOmniCaptureContainerHeader, then one chunk per image in
+// the order images finish (FOmniCaptureContainerChunkHeader, UTF-8 name, encoded file bytes), then a trailing index of
+// FOmniCaptureContainerIndexRecord followed by the names, whose offset is patched into the header when the container
+// is closed. A container whose index was never written is recovered by walking the chunk headers.
+struct FOmniCaptureContainerHeader
+{
+    static constexpr uint32 ExpectedMagic = 0x5041434F; // "OCAP"
+    static constexpr uint32 CurrentVersion = 1;
+
+    uint32 Magic = ExpectedMagic;
+    uint32 Version = CurrentVersion;
+    // 0 until the container is closed.
+    uint64 IndexOffset = 0;
+    uint64 IndexSize = 0;
+    uint32 EntryCount = 0;
+    uint32 Reserved = 0;
+};
+static_assert(sizeof(FOmniCaptureContainerHeader) == 32, "Container header layout is part of the file format");
+
+struct FOmniCaptureContainerChunkHeader
+{
+    static constexpr uint32 ExpectedMagic = 0x4B4E4843; // "CHNK"
+
+    uint32 Magic = ExpectedMagic;
+    uint32 NameLength = 0;
+    uint64 PayloadSize = 0;
+    int64 FrameIndex = 0;
+    double Timecode = 0.0;
+    // The frame's main image, as opposed to an auxiliary layer written beside it.
+    uint8 bPrimary = 0;
+    uint8 bKeyFrame = 0;
+    uint16 Reserved0 = 0;
+    uint32 Reserved1 = 0;
+};
+static_assert(sizeof(FOmniCaptureContainerChunkHeader) == 40, "Container chunk layout is part of the file format");
+
+struct FOmniCaptureContainerIndexRecord
+{
+    int64 FrameIndex = 0;
+    double Timecode = 0.0;
+    uint64 PayloadOffset = 0;
+    uint64 PayloadSize = 0;
+    // Byte range of the name in the table that follows the records.
+    uint32 NameOffset = 0;
+    uint16 NameLength = 0;
+    uint8 bPrimary = 0;
+    uint8 bKeyFrame = 0;
+};
+static_assert(sizeof(FOmniCaptureContainerIndexRecord) == 40, "Container index layout is part of the file format");
+
+struct FOmniCaptureContainerEntry
+{
+    // File name the image would have had on disk, e.g. "Shot_000042.png".
+    FString Name;
+    int64 FrameIndex = 0;
+    double Timecode = 0.0;
+    int64 PayloadOffset = 0;
+    int64 PayloadSize = 0;
+    bool bPrimary = false;
+    bool bKeyFrame = false;
+};
+
+// Appends encoded images to a container. Append is thread-safe; each chunk is written whole under a lock.
+class OMNICAPTURE_API FOmniCaptureContainerWriter
+{
+public:
+    explicit FOmniCaptureContainerWriter(const FString& InFilePath);
+    ~FOmniCaptureContainerWriter();
+
+    bool IsOpen() const;
+    bool Append(const FString& Name, const FOmniCaptureFrameMetadata& Metadata, bool bPrimary, const uint8* Data, int64 Size);
+    // Writes the trailing index and patches the header; nothing can be appended afterwards.
+    bool Close();
+
+    // Container size so far, from the in-memory index rather than the file system: the header, every chunk with its
+    // header and name, and the trailing index Close writes for them. Once closed, this is the size of the file.
+    int64 GetBytesWritten() const;
+    int32 GetEntryCount() const;
+    int32 GetFrameCount() const;
+    const FString& GetFilePath() const { return FilePath; }
+
+    static FString GetContainerPath(const FString& Directory, const FString& BaseName);
+
+private:
+    FString FilePath;
+    mutable FCriticalSection CriticalSection;
+    TUniquePtr<IFileHandle> Handle;
+    TArray<FOmniCaptureContainerEntry> Entries;
+    int64 WriteOffset = 0;
+    // Size of the trailing index for the entries so far.
+    int64 IndexBytes = 0;
+    int32 PrimaryEntryCount = 0;
+    bool bFailed = false;
+};
+
+// Memory-maps a container and serves its images without copying them.
+class OMNICAPTURE_API FOmniCaptureContainerReader
+{
+public:
+    FOmniCaptureContainerReader();
+    ~FOmniCaptureContainerReader();
+
+    bool Open(const FString& InFilePath);
+    void Close();
+
+    const TArray<FOmniCaptureContainerEntry>& GetEntries() const { return Entries; }
+    // Each frame's primary image, in frame order.
+    TArray<const FOmniCaptureContainerEntry*> GetPrimaryEntries() const;
+    const FOmniCaptureContainerEntry* FindEntry(const FString& Name) const;
+    // Points into the mapping; valid until Close.
+    const uint8* GetPayload(const FOmniCaptureContainerEntry& Entry) const;
+    // True when the index was rebuilt from the chunks because the container was never closed.
+    bool WasRecovered() const { return bRecovered; }
+
+    // Writes every image out as the loose file it stands for. Returns the number written.
+    int32 ExtractAll(const FString& Directory) const;
+
+private:
+    bool ReadIndex(const FOmniCaptureContainerHeader& Header);
+    void RecoverIndex();
+
+    FString FilePath;
+    TUniquePtr<IMappedFileHandle> MappedHandle;
+    TUniquePtr<IMappedFileRegion> MappedRegion;
+    // Used where the platform cannot map files.
+    TArray64<uint8> LoadedData;
+    const uint8* Data = nullptr;
+    int64 DataSize = 0;
+    TArray<FOmniCaptureContainerEntry> Entries;
+    TMap<FString, int32> EntriesByName;
+    bool bRecovered = false;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureProjectionLUT.h"
+
+// Read-only view of six square cube faces held in CPU memory, indexed like FOmniCaptureProjectionSample faces,
+// together with the filter the samples were packed for. Faces stay in the precision they were read back in:
+// FLinearColor texels for FullFloat, FFloat16Color texels for HalfFloat, or one float per texel for single-channel
+// faces such as depth, which sample as that value in every channel.
+struct FOmniCaptureCubemapView
+{
+    const void* Faces[6] = { nullptr, nullptr, nullptr, nullptr, nullptr, nullptr };
+    int32 Resolution = 0;
+    EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::FullFloat;
+    bool bScalarTexels = false;
+    EOmniCaptureCPUFilter Filter = EOmniCaptureCPUFilter::Nearest;
+    // Required by the filtered modes to read across face edges.
+    const FOmniCaptureCubeSeamTable* SeamTable = nullptr;
+
+    template <typename TexelType>
+    FORCEINLINE const TexelType* GetFace(uint32 FaceIndex) const
+    {
+        return static_cast<const TexelType*>(Faces[FaceIndex]);
+    }
+
+    bool IsValid() const
+    {
+        for (const void* Face : Faces)
+        {
+            if (!Face)
+            {
+                return false;
+            }
+        }
+
+        if (Precision == EOmniCapturePixelPrecision::Unknown)
+        {
+            return false;
+        }
+
+        if (Filter != EOmniCaptureCPUFilter::Nearest && (!SeamTable || SeamTable->GetResolution() != Resolution))
+        {
+            return false;
+        }
+
+        return Resolution > 0;
+    }
+};
+
+// One output layer of a projection gather: the faces each eye samples and the pixels it writes, as PixelDataType.
+// Mono gathers only read Left.
+struct FOmniCaptureGatherLayer
+{
+    FOmniCaptureCubemapView Left;
+    FOmniCaptureCubemapView Right;
+    EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
+    void* Pixels = nullptr;
+};
+
+// Row kernels that resolve precomputed projection samples into output pixels. Invalid samples produce transparent
+// black.
+class OMNICAPTURE_API FOmniCaptureCubemapSampler
+{
+public:
+    static void GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FLinearColor* OutPixels);
+    static void GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FFloat16Color* OutPixels);
+    static void GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FColor* OutPixels);
+    // Data layers: the first channel, or the first two, of the filtered texel.
+    static void GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, float* OutPixels);
+    static void GatherRow(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FVector2f* OutPixels);
+
+    // Resolves every output pixel of every layer through one projection LUT. The output is split into row bands, and
+    // into per-eye halves for side-by-side stereo, which idle task graph workers take in turn; with bParallel false the
+    // same tiles run in order on the caller. Each tile hands short runs of one eye's row to every layer's row kernel so
+    // the samples stay in cache across layers. Stereo layouts map output pixels onto the eye like the GPU path does.
+    static void GatherProjection(const FOmniCaptureProjectionLUT& ProjectionLUT, TConstArrayView<FOmniCaptureGatherLayer> Layers, bool bStereo, bool bSideBySide, const FIntPoint& OutputSize, bool bParallel = true);
+
+    // Per-pixel reference implementation built on FLinearColor conversions; the vector kernels are tested against it.
+    static void GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FLinearColor* OutPixels);
+    static void GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FFloat16Color* OutPixels);
+    static void GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FColor* OutPixels);
+    static void GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, float* OutPixels);
+    static void GatherRowScalar(const FOmniCaptureCubemapView& Cubemap, const FOmniCaptureProjectionSample* Samples, int32 Count, FVector2f* OutPixels);
+};
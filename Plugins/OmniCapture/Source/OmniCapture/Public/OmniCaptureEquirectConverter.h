@@ -3,6 +3,7 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
+#include "OmniCaptureReadbackQueue.h"
 #include "OmniCaptureRigActor.h"
 
 // 公共头只做前置声明，避免路径/版本差异在项目内扩散
@@ -12,10 +13,10 @@ class FTextureRenderTargetResource;
 struct FOmniCaptureEquirectResult
 {
     TUniquePtr<FImagePixelData> PixelData;
-    TArray<FColor> PreviewPixels;
     FIntPoint Size = FIntPoint::ZeroValue;
     bool bIsLinear = false;
     bool bUsedCPUFallback = false;
+    double ConversionMilliseconds = 0.0;
     EOmniCapturePixelPrecision PixelPrecision = EOmniCapturePixelPrecision::Unknown;
     EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
     TRefCountPtr<IPooledRenderTarget> OutputTarget;
@@ -23,13 +24,38 @@ struct FOmniCaptureEquirectResult
     FTextureRHIRef Texture;
     FGPUFenceRHIRef ReadyFence;
     TArray<TRefCountPtr<IPooledRenderTarget>> EncoderPlanes;
+    // Set instead of PixelData by a deferred conversion once it has run on the render thread, with the copies of the
+    // auxiliary layers the GPU projected next to it.
+    TUniquePtr<IOmniCaptureReadback> PendingReadback;
+    TMap<EOmniCaptureAuxiliaryPassType, FOmniCaptureLayerReadback> PendingLayerReadbacks;
+    // Auxiliary passes converted alongside the frame by ConvertLayers, each in its own pixel format.
+    TMap<EOmniCaptureAuxiliaryPassType, FOmniCaptureLayerPayload> AuxiliaryLayers;
+    // The GPU part of a conversion that ran with EOmniCaptureReadbackMode::Deferred, still to be run on the render
+    // thread, where it fills in the GPU outputs of the result it is given. Its inputs are captured by value.
+    TUniqueFunction<void(FOmniCaptureEquirectResult&)> DeferredConversion;
+};
+
+enum class EOmniCaptureReadbackMode : uint8
+{
+    // Wait for the render thread and the GPU copy, and return CPU pixels with the result.
+    Blocking,
+    // Return the GPU work in DeferredConversion without waiting for the render thread; it leaves its copy unresolved
+    // in PendingReadback.
+    Deferred
 };
 
 class OMNICAPTURE_API FOmniCaptureEquirectConverter
 {
 public:
-    static FOmniCaptureEquirectResult ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
-    static FOmniCaptureEquirectResult ConvertToFisheye(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye);
-    static FOmniCaptureEquirectResult ConvertToPlanar(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& SourceEye);
+    static FOmniCaptureEquirectResult ConvertToEquirectangular(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, EOmniCaptureReadbackMode ReadbackMode = EOmniCaptureReadbackMode::Blocking);
+    static FOmniCaptureEquirectResult ConvertToFisheye(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, EOmniCaptureReadbackMode ReadbackMode = EOmniCaptureReadbackMode::Blocking);
+    static FOmniCaptureEquirectResult ConvertToPlanar(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& SourceEye, EOmniCaptureReadbackMode ReadbackMode = EOmniCaptureReadbackMode::Blocking);
+
+    // Converts the frame in the projection Settings asks for together with its auxiliary passes. When the GPU converts
+    // the beauty pass, normal and base colour passes are projected by the same shader; every other auxiliary face is
+    // read back in one batch and resolved through one projection lookup, depth, roughness and occlusion as
+    // ScalarFloat32 and motion as Vector2Float32. ReadbackMode applies to the beauty pass and the GPU-projected layers;
+    // a deferred conversion that fails on the render thread has no CPU fallback and resolves without those pixels.
+    static FOmniCaptureEquirectResult ConvertLayers(const FOmniCaptureSettings& Settings, const FOmniEyeCapture& LeftEye, const FOmniEyeCapture& RightEye, TConstArrayView<EOmniCaptureAuxiliaryPassType> AuxiliaryPasses, EOmniCaptureReadbackMode ReadbackMode = EOmniCaptureReadbackMode::Blocking);
 };
 
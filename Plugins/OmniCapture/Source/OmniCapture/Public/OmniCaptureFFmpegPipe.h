@@ -0,0 +1,89 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureTypes.h"
+
+class FEvent;
+
+struct FOmniCaptureFFmpegPipeStats
+{
+    int32 FramesWritten = 0;
+    // Frames that could not be sent: no pixels, a different size or type than the stream, or a pipe that had closed.
+    int32 SkippedFrames = 0;
+    // Pushes that had to wait for the writer thread because the queue was full.
+    int32 BlockedPushes = 0;
+    int64 BytesWritten = 0;
+    // Size of the encoder's output file as last sampled by the pipe thread, or 0 when no output file is watched.
+    int64 OutputBytes = 0;
+};
+
+// Streams raw frames into the stdin of a child process, normally FFmpeg reading "-f rawvideo -i -", while the capture
+// is still running. Frames are queued by reference and written by the pipe's own thread. The queue is bounded and
+// PushFrame waits while it is full, so an encoder that falls behind pushes back on the ring buffer sink feeding it.
+class OMNICAPTURE_API FOmniCaptureFFmpegPipe final : public FRunnable
+{
+public:
+    FOmniCaptureFFmpegPipe();
+    virtual ~FOmniCaptureFFmpegPipe() override;
+
+    // Launches Binary with its stdin on the pipe. Every frame must be FrameSize pixels of PixelDataType, which
+    // GetRawPixelFormat must support.
+    bool Start(const FString& Binary, const FString& Arguments, const FString& WorkingDirectory, const FIntPoint& InFrameSize, EOmniCapturePixelDataType InPixelDataType, int32 InMaxQueuedFrames);
+    // Has the pipe thread sample the size of the process's output file into the stats every OutputSizeIntervalSeconds,
+    // so callers can read it without touching the file system. Call before Start.
+    void WatchOutputFile(const FString& InOutputPath);
+    // Queues a frame, waiting while the queue is full. Returns false once the process has stopped reading.
+    bool PushFrame(const FOmniCaptureSharedFrame& Frame);
+    // Stops taking frames; stdin is closed once the queue has been written out. Does not wait.
+    void CloseInput();
+    // Closes the input and waits for the process. True when every queued frame was written and it exited with 0.
+    // A process still running after TimeoutSeconds is killed, so a hung encoder cannot stall finalization.
+    bool WaitForExit(double TimeoutSeconds = DefaultExitTimeoutSeconds);
+
+    static constexpr double DefaultExitTimeoutSeconds = 300.0;
+    static constexpr double OutputSizeIntervalSeconds = 0.25;
+
+    bool IsRunning() const;
+    FOmniCaptureFFmpegPipeStats GetStats() const;
+
+    // FFmpeg -pix_fmt of the bytes sent for frames of this type, or nullptr when they cannot be streamed. 8-bit frames
+    // go as they are; float frames are clamped to 16-bit RGBA on the pipe thread.
+    static const TCHAR* GetRawPixelFormat(EOmniCapturePixelDataType PixelDataType);
+    // Writes all of Data to a child's stdin, waiting while the pipe is full. False if the child exits first.
+    static bool WriteToProcess(FProcHandle& ProcHandle, void* WritePipe, const uint8* Data, int64 Size);
+
+    //~ FRunnable
+    virtual uint32 Run() override;
+
+private:
+    bool WriteFrame(const FOmniCaptureFrame& Frame);
+    void SampleOutputSize();
+
+    FProcHandle ProcHandle;
+    void* StdInRead = nullptr;
+    void* StdInWrite = nullptr;
+    TUniquePtr<FRunnableThread> Thread;
+    FIntPoint FrameSize = FIntPoint::ZeroValue;
+    EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
+    int32 MaxQueuedFrames = 1;
+    FString OutputPath;
+    double NextOutputSizeSeconds = 0.0;
+    // Float frames are converted here a band of rows at a time.
+    TArray64<uint8> ConversionBuffer;
+
+    mutable FCriticalSection CriticalSection;
+    TArray<FOmniCaptureSharedFrame> Queue;
+    FOmniCaptureFFmpegPipeStats Stats;
+    bool bStarted = false;
+    bool bInputClosed = false;
+    bool bBroken = false;
+    bool bExited = false;
+    bool bExitResult = false;
+
+    FEvent* WorkEvent = nullptr;
+    FEvent* SpaceEvent = nullptr;
+};
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageWriteTypes.h"
+#include "OmniCaptureTypes.h"
+
+class FOmniCaptureFramePool;
+
+// Pixel data whose storage goes back to the pool it came from when it is destroyed, whoever destroys it: the frame,
+// the image writer, or the engine's image write queue.
+template <typename PixelType>
+struct TOmniCapturePooledPixelData : public TImagePixelData<PixelType>
+{
+    TOmniCapturePooledPixelData(const FIntPoint& InSize, TArray64<PixelType>&& InPixels, const TSharedRef<FOmniCaptureFramePool, ESPMode::ThreadSafe>& InPool)
+        : TImagePixelData<PixelType>(InSize, MoveTemp(InPixels))
+        , Pool(InPool)
+    {
+    }
+
+    virtual ~TOmniCapturePooledPixelData() override;
+
+private:
+    TSharedRef<FOmniCaptureFramePool, ESPMode::ThreadSafe> Pool;
+};
+
+// Recycles full-frame pixel buffers, keyed by size and pixel format, so a long capture stops allocating and freeing
+// hundreds of megabytes per frame. Buffers handed out keep the pool alive until they are returned.
+class OMNICAPTURE_API FOmniCaptureFramePool : public TSharedFromThis<FOmniCaptureFramePool, ESPMode::ThreadSafe>
+{
+public:
+    // Idle buffers kept per size and format; anything returned beyond that is freed.
+    static constexpr int32 MaxIdleBuffersPerKey = 16;
+
+    // Process-wide pool shared by the converters and the readback queue.
+    static FOmniCaptureFramePool& Get();
+
+    // Returns pixel data with Size.X * Size.Y uninitialised pixels.
+    template <typename PixelType>
+    TUniquePtr<TImagePixelData<PixelType>> Acquire(const FIntPoint& Size)
+    {
+        TArray64<PixelType> Pixels;
+        TakeBuffer(Size, Pixels);
+        return MakeUnique<TOmniCapturePooledPixelData<PixelType>>(Size, MoveTemp(Pixels), AsShared());
+    }
+
+    // Frees every idle buffer, e.g. once a capture ends or its resolution changes.
+    void Trim();
+    FOmniCaptureFramePoolStats GetStats() const;
+
+private:
+    template <typename PixelType>
+    friend struct TOmniCapturePooledPixelData;
+
+    void TakeBuffer(const FIntPoint& Size, TArray64<FColor>& OutPixels);
+    void TakeBuffer(const FIntPoint& Size, TArray64<FFloat16Color>& OutPixels);
+    void TakeBuffer(const FIntPoint& Size, TArray64<FLinearColor>& OutPixels);
+    void TakeBuffer(const FIntPoint& Size, TArray64<float>& OutPixels);
+    void TakeBuffer(const FIntPoint& Size, TArray64<FVector2f>& OutPixels);
+    void ReturnBuffer(const FIntPoint& Size, TArray64<FColor>&& Pixels);
+    void ReturnBuffer(const FIntPoint& Size, TArray64<FFloat16Color>&& Pixels);
+    void ReturnBuffer(const FIntPoint& Size, TArray64<FLinearColor>&& Pixels);
+    void ReturnBuffer(const FIntPoint& Size, TArray64<float>&& Pixels);
+    void ReturnBuffer(const FIntPoint& Size, TArray64<FVector2f>&& Pixels);
+
+    template <typename PixelType>
+    void TakeBufferImpl(TMap<FIntPoint, TArray<TArray64<PixelType>>>& FreeLists, const FIntPoint& Size, TArray64<PixelType>& OutPixels);
+    template <typename PixelType>
+    void ReturnBufferImpl(TMap<FIntPoint, TArray<TArray64<PixelType>>>& FreeLists, const FIntPoint& Size, TArray64<PixelType>&& Pixels);
+
+    mutable FCriticalSection CriticalSection;
+    TMap<FIntPoint, TArray<TArray64<FColor>>> ColorBuffers;
+    TMap<FIntPoint, TArray<TArray64<FFloat16Color>>> HalfBuffers;
+    TMap<FIntPoint, TArray<TArray64<FLinearColor>>> FloatBuffers;
+    // Single- and two-channel auxiliary layers.
+    TMap<FIntPoint, TArray<TArray64<float>>> ScalarBuffers;
+    TMap<FIntPoint, TArray<TArray64<FVector2f>>> Vector2Buffers;
+    FOmniCaptureFramePoolStats Stats;
+};
+
+template <typename PixelType>
+TOmniCapturePooledPixelData<PixelType>::~TOmniCapturePooledPixelData()
+{
+    Pool->ReturnBuffer(this->GetSize(), MoveTemp(this->Pixels));
+}
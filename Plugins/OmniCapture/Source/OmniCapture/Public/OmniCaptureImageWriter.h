@@ -2,10 +2,28 @@
 
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
-#include "Async/Future.h"
+#include "OmniCaptureContainer.h"
+#include "OmniCapturePNGEncoder.h"
+#include "OmniCaptureRawFrameFile.h"
+#include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureWriterPool.h"
 #include "Templates/Function.h"
 #include "ImageWriteTypes.h"
 
+// Bytes of layer data that combined EXR writes handed to OpenEXR, split by whether they had to be copied first.
+struct FOmniCaptureEXRStagingStats
+{
+    int64 StagedBytes = 0;
+    int64 ReferencedBytes = 0;
+};
+
+// How EXR output splits the machine: whole frames written side by side, each compressed by a number of threads.
+struct FOmniCaptureEXRConcurrency
+{
+    int32 ConcurrentFrames = 1;
+    int32 CompressionThreads = 1;
+};
+
 class OMNICAPTURE_API FOmniCaptureImageWriter
 {
 public:
@@ -14,22 +32,38 @@ public:
 
     void Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory);
     void EnqueueFrame(TUniquePtr<FOmniCaptureFrame>&& Frame, const FString& FrameFileName);
+    // Keeps the frame alive until it is written and only reads from it, so the other sinks sharing it see it unchanged.
+    void EnqueueFrame(const FOmniCaptureSharedFrame& Frame, const FString& FrameFileName);
+    // Waits for every queued frame to be written, then stops accepting frames.
     void Flush();
     const TArray<FOmniCaptureFrameMetadata>& GetCapturedFrames() const { return CapturedMetadata; }
     TArray<FOmniCaptureFrameMetadata> ConsumeCapturedFrames();
+    FOmniCaptureEXRStagingStats GetEXRStagingStats() const;
+    FOmniCaptureEXRConcurrency GetEXRConcurrency() const { return EXRConcurrency; }
+    FOmniCaptureWriterPoolStats GetWriterPoolStats() const;
+    bool IsWritingContainer() const { return Container.IsValid(); }
+    // Size of the capture container so far, index included; 0 when images go to loose files.
+    int64 GetContainerBytesWritten() const;
+    // Bytes of finished output since Initialize, counted as each image is written; cheap enough to poll every tick.
+    int64 GetBytesWritten() const;
+
+    // Resolves the auto (0) EXR concurrency settings so ConcurrentFrames * CompressionThreads roughly fills CoreCount.
+    static FOmniCaptureEXRConcurrency ResolveEXRConcurrency(const FOmniCaptureSettings& Settings, int32 CoreCount);
 
 private:
     struct FExrLayerRequest
     {
         FString Name;
-        TUniquePtr<FImagePixelData> PixelData;
+        // Borrowed from the frame being written, which outlives the request.
+        const FImagePixelData* PixelData = nullptr;
         bool bLinear = false;
         EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
         EOmniCapturePixelDataType PixelDataType = EOmniCapturePixelDataType::Unknown;
     };
 
-    bool WritePixelDataToDisk(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EOmniCaptureImageFormat Format, bool bIsLinear, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const;
+    bool WritePixelDataToDisk(const FImagePixelData& SourcePixelData, const FString& FilePath, EOmniCaptureImageFormat Format, bool bIsLinear, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const;
     bool WritePNGRaw(const FString& FilePath, const FIntPoint& Size, const void* RawData, int64 RawSizeInBytes, ERGBFormat Format, int32 BitDepth) const;
+    bool WritePNGParallel(const FString& FilePath, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, TFunctionRef<void(int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)> PrepareRows) const;
     bool WritePNGWithRowSource(const FString& FilePath, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, TFunctionRef<void(int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)> PrepareRows) const;
     bool WritePNG(const TImagePixelData<FColor>& PixelData, const FString& FilePath) const;
     bool WritePNGFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const;
@@ -40,34 +74,50 @@ private:
     bool WriteJPEG(const TImagePixelData<FColor>& PixelData, const FString& FilePath) const;
     bool WriteJPEGFromLinear(const TImagePixelData<FFloat16Color>& PixelData, const FString& FilePath) const;
     bool WriteJPEGFromLinearFloat32(const TImagePixelData<FLinearColor>& PixelData, const FString& FilePath) const;
-    bool WriteEXR(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const;
+    bool WriteEXR(const FImagePixelData& PixelData, const FString& FilePath, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType) const;
     bool WriteEXRFromColor(const TImagePixelData<FColor>& PixelData, const FString& FilePath) const;
-    bool WriteEXRInternal(TUniquePtr<FImagePixelData> PixelData, const FString& FilePath, EImagePixelType PixelType) const;
-    bool WriteEXRFrame(const FString& FilePath, bool bIsLinear, TUniquePtr<FImagePixelData> PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, TMap<FName, FOmniCaptureLayerPayload>&& AuxiliaryLayers, const FString& LayerDirectory, const FString& LayerBaseName, const FString& LayerExtension) const;
+    bool WriteEXRInternal(const FImagePixelData& PixelData, const FString& FilePath, EImagePixelType PixelType) const;
+    bool WriteEXRFrame(const FString& FilePath, bool bIsLinear, const FImagePixelData& PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers, const FString& LayerDirectory, const FString& LayerBaseName, const FString& LayerExtension) const;
     bool WriteCombinedEXR(const FString& FilePath, TArray<FExrLayerRequest>& Layers) const;
+    bool WriteRawFrame(const FOmniCaptureFrameMetadata& Metadata, bool bIsLinear, const FImagePixelData& PixelData, EOmniCapturePixelPrecision PixelPrecision, EOmniCapturePixelDataType PixelDataType, const TMap<FName, FOmniCaptureLayerPayload>& AuxiliaryLayers) const;
+    // Every encoded image leaves through these, which write a loose file or append to the capture container.
+    TUniquePtr<FArchive> CreateOutputArchive(const FString& FilePath) const;
+    bool SaveOutputFile(const TArray64<uint8>& Data, const FString& FilePath) const;
+    bool AppendToContainer(const FString& FilePath, const uint8* Data, int64 Size) const;
+    // Closes an archive from CreateOutputArchive and counts what it wrote.
+    bool CloseOutputArchive(FArchive& Archive) const;
     void RequestStop();
     bool IsStopRequested() const;
-    void WaitForAvailableTaskSlot();
-    void TrackPendingTask(TFuture<bool>&& TaskFuture);
-    void PruneCompletedTasks();
-    void EnforcePendingTaskLimit();
-    void WaitForAllTasks();
 
     bool bInitialized = false;
     FString OutputDirectory;
     FString SequenceBaseName;
     EOmniCaptureImageFormat TargetFormat = EOmniCaptureImageFormat::PNG;
     EOmniCapturePNGBitDepth TargetPNGBitDepth = EOmniCapturePNGBitDepth::BitDepth32;
+    bool bParallelPNGEncoding = true;
+    FOmniCapturePNGEncodeOptions PNGEncodeOptions;
     int32 MaxPendingTasks = 8;
     bool bPackEXRAuxiliaryLayers = true;
     bool bUseEXRMultiPart = false;
     EOmniCaptureEXRCompression TargetEXRCompression = EOmniCaptureEXRCompression::Zip;
+    bool bZeroCopyEXRLayers = true;
+    bool bWriteTiledEXR = false;
+    int32 EXRTileSize = 256;
+    EOmniCaptureEXRTileLevels EXRTileLevels = EOmniCaptureEXRTileLevels::SingleLevel;
+    FOmniCaptureEXRConcurrency EXRConcurrency;
+    TUniquePtr<FOmniCaptureRawSegmentWriter> RawWriter;
+    TUniquePtr<FOmniCaptureContainerWriter> Container;
+    mutable TAtomic<int64> EXRStagedBytes{ 0 };
+    mutable TAtomic<int64> EXRReferencedBytes{ 0 };
+    mutable TAtomic<int64> OutputBytesWritten{ 0 };
 
     TArray<FOmniCaptureFrameMetadata> CapturedMetadata;
     FCriticalSection MetadataCS;
 
-    TArray<TFuture<bool>> PendingTasks;
-    FCriticalSection PendingTasksCS;
+    TUniquePtr<FOmniCaptureWriterPool> WriterPool;
+    // 0 until the first frame when the budget is sized from it.
+    int64 MaxBytesInFlight = 0;
+    FOmniCaptureWriterPoolStats FinalWriterPoolStats;
     TAtomic<bool> bStopRequested;
 };
 
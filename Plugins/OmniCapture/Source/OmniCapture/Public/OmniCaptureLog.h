@@ -0,0 +1,7 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Log categories shared by more than one file. Categories only one file uses stay DEFINE_LOG_CATEGORY_STATIC there.
+DECLARE_LOG_CATEGORY_EXTERN(LogOmniCaptureAudio, Log, All);
+DECLARE_LOG_CATEGORY_EXTERN(LogOmniCaptureNVENC, Log, All);
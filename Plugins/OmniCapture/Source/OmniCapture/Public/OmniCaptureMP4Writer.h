@@ -0,0 +1,103 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+class IFileHandle;
+
+struct FOmniCaptureMP4WriterConfig
+{
+    EOmniCaptureCodec Codec = EOmniCaptureCodec::HEVC;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    // Duration given to the last video sample, which has no successor to measure against.
+    double FrameRate = 30.0;
+    bool bWithAudio = false;
+    // Used when no audio packet has arrived by the time the header is written; otherwise the first packet decides.
+    int32 AudioSampleRate = 48000;
+    int32 AudioChannels = 2;
+    // Adds st3d/sv3d boxes so players treat the track as an equirectangular panorama.
+    bool bSpherical = false;
+    bool bStereo = false;
+    EOmniCaptureStereoLayout StereoLayout = EOmniCaptureStereoLayout::TopBottom;
+    bool bHalfSphere = false;
+    // A new fragment starts at the first keyframe after this much video.
+    double MinFragmentSeconds = 1.0;
+
+    static FOmniCaptureMP4WriterConfig FromSettings(const FOmniCaptureSettings& Settings);
+};
+
+// Writes NVENC access units straight into a fragmented MP4, so the NVENC path needs no FFmpeg pass to become playable.
+// The moov is written once the first keyframe arrives and its parameter sets are known; after that every fragment is a
+// moof/mdat pair with the video samples and the PCM audio that arrived alongside them. A file cut short by a crash keeps
+// every fragment written before it. Not thread safe; the encoder calls it under its own lock.
+class OMNICAPTURE_API FOmniCaptureMP4Writer
+{
+public:
+    FOmniCaptureMP4Writer();
+    ~FOmniCaptureMP4Writer();
+
+    bool Open(const FString& Path, const FOmniCaptureMP4WriterConfig& InConfig);
+    // Annex B parameter sets (VPS/SPS/PPS) from the encoder. Optional when keyframes carry them inline.
+    void SetCodecConfig(const uint8* Data, int64 Size);
+    // One Annex B access unit. Samples before the first keyframe are dropped, as nothing could decode them.
+    bool WriteVideoSample(const uint8* Data, int64 Size, bool bKeyFrame, uint64 TimestampMicroseconds);
+    // Interleaved 16-bit PCM, placed by its video-clock timestamp. Gaps are filled with silence and overlaps trimmed.
+    // Packets whose format differs from the track's are dropped.
+    void WriteAudio(const FOmniAudioPacket& Packet);
+    // Writes the last fragment and the total duration. True when the file holds at least one decodable sample.
+    bool Close();
+
+    bool IsOpen() const { return File.IsValid(); }
+    int64 GetBytesWritten() const { return BytesWritten; }
+    int32 GetVideoSampleCount() const { return VideoSampleCount; }
+    int32 GetFragmentCount() const { return SequenceNumber; }
+    int32 GetDroppedVideoSamples() const { return DroppedVideoSamples; }
+    int32 GetDroppedAudioPackets() const { return DroppedAudioPackets; }
+    // Audio frames placed in the track so far, silence included.
+    int64 GetAudioFrameCount() const { return static_cast<int64>(FragmentAudioStart) + (AudioChannels > 0 ? FragmentAudio.Num() / (AudioChannels * static_cast<int32>(sizeof(int16))) : 0); }
+    int64 GetSilentAudioFrames() const { return SilentAudioFrames; }
+
+private:
+    struct FVideoSample
+    {
+        TArray<uint8> Data;
+        uint64 Timestamp = 0;
+        uint32 Duration = 0;
+        bool bKeyFrame = false;
+    };
+
+    bool WriteHeader(const uint8* KeyFrameData, int64 KeyFrameSize);
+    void AddToFragment(FVideoSample&& Sample);
+    bool FlushFragment();
+    bool Write(const TArray<uint8>& Bytes);
+    uint64 ToVideoTime(uint64 TimestampMicroseconds) const;
+
+    TUniquePtr<IFileHandle> File;
+    FOmniCaptureMP4WriterConfig Config;
+    TArray<uint8> CodecConfig;
+    bool bHeaderWritten = false;
+    bool bFailed = false;
+
+    FVideoSample PendingSample;
+    bool bHasPendingSample = false;
+    uint64 FirstVideoTimestamp = 0;
+    uint32 NominalVideoDuration = 3000;
+
+    TArray<FVideoSample> FragmentVideo;
+    uint64 FragmentVideoStart = 0;
+    uint64 FragmentVideoDuration = 0;
+    TArray<uint8> FragmentAudio;
+    uint64 FragmentAudioStart = 0;
+
+    bool bAudioFormatKnown = false;
+    int32 AudioSampleRate = 0;
+    int32 AudioChannels = 0;
+
+    int64 FragmentDurationOffset = INDEX_NONE;
+    int64 BytesWritten = 0;
+    int32 SequenceNumber = 0;
+    int32 VideoSampleCount = 0;
+    int32 DroppedVideoSamples = 0;
+    int32 DroppedAudioPackets = 0;
+    int64 SilentAudioFrames = 0;
+};
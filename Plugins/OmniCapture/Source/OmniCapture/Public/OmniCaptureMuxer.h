@@ -1,24 +1,46 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "OmniCaptureFFmpegPipe.h"
+#include "OmniCaptureRingBuffer.h"
 #include "OmniCaptureTypes.h"
 
 class OMNICAPTURE_API FOmniCaptureMuxer
 {
 public:
+    FOmniCaptureMuxer();
+    ~FOmniCaptureMuxer();
+
     void Initialize(const FOmniCaptureSettings& Settings, const FString& InOutputDirectory);
     bool FinalizeCapture(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath, int32 DroppedFrames);
     void BeginRealtimeSession(const FOmniCaptureSettings& Settings);
     void EndRealtimeSession();
     void PushFrame(const FOmniCaptureFrame& Frame);
+    // Also feeds the live encoder when the capture streams to FFmpeg. May block while the encoder catches up.
+    // False when the frame was meant for the live encoder but it failed to start or stopped taking frames.
+    bool PushFrame(const FOmniCaptureSharedFrame& Frame);
+    // True once the live encode of this segment has failed; the frames it missed were not encoded.
+    bool HasLiveStreamFailed() const { return bLiveStreamFailed.Load(); }
+    // Size of the live encoder's output as of the last frame pushed, or 0 when not streaming. Never touches the disk.
+    int64 GetLiveOutputBytes() const { return LiveOutputBytes.Load(); }
+    // Closes the live encoder's input without waiting; FinalizeCapture collects it.
+    void FinishLiveStream();
+    // Moves the closed live encode of Target's segment to Target, so that its FinalizeCapture collects it instead.
+    void HandOverLiveStream(FOmniCaptureMuxer& Target);
     FOmniAudioSyncStats GetAudioStats() const { return AudioStats; }
     static FString ResolveFFmpegBinary(const FOmniCaptureSettings& Settings);
     static bool IsFFmpegAvailable(const FOmniCaptureSettings& Settings, FString* OutResolvedPath = nullptr);
+    // True when image-sequence frames go straight to FFmpeg instead of to image files.
+    static bool ShouldStreamLive(const FOmniCaptureSettings& Settings);
 
 private:
     bool WriteManifest(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath, int32 DroppedFrames, FString& OutManifestPath) const;
     bool TryInvokeFFmpeg(const FOmniCaptureSettings& Settings, const TArray<FOmniCaptureFrameMetadata>& Frames, const FString& AudioPath, const FString& VideoPath) const;
     bool WriteSpatialMetadata(const FOmniCaptureSettings& Settings) const;
+    FString BuildVideoOutputArguments(const FOmniCaptureSettings& Settings) const;
+    bool StartLiveStream(const FOmniCaptureFrame& Frame);
+    bool CompleteLiveStream(const FOmniCaptureSettings& Settings, FOmniCaptureFFmpegPipe& Pipe, const FString& AudioPath) const;
+    FString GetLiveOutputPath() const;
     FString BuildFFmpegBinaryPath() const;
     double CalculateFrameRate(const TArray<FOmniCaptureFrameMetadata>& Frames) const;
 
@@ -31,4 +53,16 @@ private:
     double LastAudioTimestamp = 0.0;
     double DriftWarningThresholdMs = 25.0;
     bool bRealtimeSessionActive = false;
+
+    // The live encoder of the segment being recorded, and those of earlier segments whose input has been closed but
+    // which FinalizeCapture has not collected yet, keyed by their output path. The ring buffer's muxer sink starts and
+    // feeds the live encoder while the game thread closes it on rotation, so the lock guards the pipes and their path.
+    mutable FCriticalSection LiveStreamCriticalSection;
+    FOmniCaptureSettings LiveSettings;
+    TUniquePtr<FOmniCaptureFFmpegPipe> LivePipe;
+    TMap<FString, TUniquePtr<FOmniCaptureFFmpegPipe>> FinishingLiveStreams;
+    FString LiveOutputPath;
+    bool bStreamLive = false;
+    TAtomic<bool> bLiveStreamFailed{ false };
+    TAtomic<int64> LiveOutputBytes{ 0 };
 };
@@ -22,6 +22,8 @@
     #define OMNI_WITH_NVENC 0
 #endif
 
+class FOmniCaptureMP4Writer;
+
 struct FOmniNVENCCapabilities
 {
     bool bHardwareAvailable = false;
@@ -68,9 +70,12 @@ public:
     bool IsInitialized() const { return bInitialized; }
     FString GetOutputFilePath() const { return OutputFilePath; }
     const FString& GetLastError() const { return LastErrorMessage; }
+    // Output bytes written since Initialize, counted per packet.
+    int64 GetBytesWritten() const { return BytesWritten.Load(); }
 
 private:
     FString OutputFilePath;
+    TAtomic<int64> BytesWritten{ 0 };
     bool bInitialized = false;
     EOmniCaptureColorFormat ColorFormat = EOmniCaptureColorFormat::NV12;
     bool bZeroCopyRequested = true;
@@ -87,9 +92,11 @@ private:
     OmniNVENC::FNVENCParameters ActiveParameters;
     FCriticalSection EncoderCS;
     TUniquePtr<IFileHandle> BitstreamFile;
+    TUniquePtr<FOmniCaptureMP4Writer> MP4Writer;
     bool bAnnexBHeaderWritten = false;
 
     bool WriteAnnexBHeader();
+    void WriteEncodedOutput(const OmniNVENC::FNVENCEncodedPacket& Packet, const FOmniCaptureFrame& Frame);
 
 #if PLATFORM_WINDOWS
 #if OMNI_WITH_D3D11_RHI
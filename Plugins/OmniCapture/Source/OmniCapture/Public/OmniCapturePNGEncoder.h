@@ -0,0 +1,36 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageWriteTypes.h"
+#include "OmniCaptureTypes.h"
+
+struct FOmniCapturePNGEncodeOptions
+{
+    // 0 picks one band per worker thread.
+    int32 BandCount = 0;
+    int32 CompressionLevel = 6;
+    EOmniCapturePNGZlibStrategy Strategy = EOmniCapturePNGZlibStrategy::Default;
+
+    static FOmniCapturePNGEncodeOptions FromSettings(const FOmniCaptureSettings& Settings);
+};
+
+// Writes a PNG whose image data is split into row bands that are filtered and deflated concurrently, each with its
+// own zlib stream. Every band but the last ends on a sync flush, so the raw deflate outputs concatenate into the one
+// zlib stream a PNG requires; the Adler-32 checksums are combined in band order. Any conforming decoder reads the
+// result like a single-threaded encode.
+class OMNICAPTURE_API FOmniCaptureParallelPNGEncoder
+{
+public:
+    // Same contract as the image writer's libpng row source: fill RowPointers[0..RowCount) with rows starting at
+    // RowStart, optionally backed by TempBuffer. Rows are in the layout of Format (BGRA is swizzled to RGBA here) and
+    // 16-bit samples are little-endian. Called concurrently for disjoint rows, each call with its own buffers.
+    using FPrepareRows = TFunctionRef<void(int32 RowStart, int32 RowCount, int64 BytesPerRow, TArray64<uint8>& TempBuffer, TArray<uint8*>& RowPointers)>;
+
+    static bool Encode(FArchive& Archive, const FIntPoint& Size, ERGBFormat Format, int32 BitDepth, const FOmniCapturePNGEncodeOptions& Options, FPrepareRows PrepareRows, TFunctionRef<bool()> ShouldCancel);
+
+    // zlib strategy constant for deflateInit2 / png_set_compression_strategy.
+    static int32 ToZlibStrategy(EOmniCapturePNGZlibStrategy Strategy);
+
+    // Bands actually used for an image of Height rows.
+    static int32 ResolveBandCount(const FOmniCapturePNGEncodeOptions& Options, int32 Height);
+};
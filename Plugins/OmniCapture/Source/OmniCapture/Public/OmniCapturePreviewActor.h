@@ -8,7 +8,7 @@
 class UStaticMeshComponent;
 class UMaterialInstanceDynamic;
 class UTexture2D;
-struct FOmniCaptureEquirectResult;
+struct FOmniCapturePreviewImage;
 
 UCLASS()
 class OMNICAPTURE_API AOmniCapturePreviewActor : public AActor
@@ -19,9 +19,11 @@ public:
     AOmniCapturePreviewActor();
 
     void Initialize(float InScale, const FIntPoint& InitialResolution);
-    void UpdatePreviewTexture(const FOmniCaptureEquirectResult& Result, const FOmniCaptureSettings& Settings);
+    // Uploads the pixels of Image that differ from the last upload into a texture that persists until the image size
+    // changes.
+    void UpdatePreviewTexture(const FOmniCapturePreviewImage& Image);
     void SetPreviewEnabled(bool bEnabled);
-    void SetPreviewView(EOmniCapturePreviewView InView);
+    bool IsPreviewEnabled() const { return bPreviewEnabled; }
     UTexture2D* GetPreviewTexture() const { return PreviewTexture; }
     FIntPoint GetPreviewResolution() const { return PreviewResolution; }
 
@@ -47,6 +49,7 @@ private:
     FName TextureParameterName = TEXT("SpriteTexture");
     float PreviewScale = 1.0f;
     FIntPoint PreviewResolution = FIntPoint::ZeroValue;
-    EOmniCapturePreviewView PreviewViewMode = EOmniCapturePreviewView::StereoComposite;
-    TArray<FColor> PreviewScratchBuffer;
+    bool bPreviewEnabled = true;
+    // What the texture holds, to find the rows and columns each update changes.
+    TArray<FColor> UploadedPixels;
 };
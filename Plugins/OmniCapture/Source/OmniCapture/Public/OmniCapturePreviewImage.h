@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+// A scaled-down sRGB copy of the part of a captured frame the preview shows. It is built from the frame's pixels only
+// on frames where a preview is due, so the capture never produces a full-resolution preview it does not upload.
+struct OMNICAPTURE_API FOmniCapturePreviewImage
+{
+    // Source pixels averaged per axis for each preview pixel; larger footprints are sampled evenly rather than in full.
+    static constexpr int32 MaxTapsPerAxis = 4;
+
+    TArray<FColor> Pixels;
+    FIntPoint Size = FIntPoint::ZeroValue;
+
+    bool IsValid() const { return Size.X > 0 && Size.Y > 0 && Pixels.Num() == Size.X * Size.Y; }
+    void Reset();
+
+    // The region of a frame of FrameSize that View shows: one eye of a stereo layout, otherwise the whole frame.
+    static FIntRect GetViewRect(const FIntPoint& FrameSize, const FOmniCaptureSettings& Settings, EOmniCapturePreviewView View);
+    // RegionSize scaled to fit MaxEdge on its longer side, keeping the aspect ratio. Never scales up; 0 keeps the size.
+    static FIntPoint GetScaledSize(const FIntPoint& RegionSize, int32 MaxEdge);
+
+    // Box-filters Region of PixelData down to GetScaledSize, encoding linear pixels as sRGB. Reuses the pixel
+    // allocation across calls. Returns false, leaving no image, for a region outside the frame or a pixel type the
+    // preview cannot read.
+    bool Build(const FImagePixelData& PixelData, EOmniCapturePixelDataType PixelDataType, const FIntRect& Region, int32 MaxEdge);
+
+    // The smallest rectangle holding every pixel of Current that differs from Previous, which holds the pixels last
+    // uploaded. All of Current when Previous has another size; false when nothing changed.
+    static bool FindChangedRect(const TArray<FColor>& Previous, const FOmniCapturePreviewImage& Current, FIntRect& OutRect);
+};
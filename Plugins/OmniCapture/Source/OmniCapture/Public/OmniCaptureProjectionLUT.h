@@ -0,0 +1,129 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+enum class EOmniCaptureProjectionKind : uint8
+{
+    Equirectangular,
+    Fisheye
+};
+
+// One output pixel of a projection: which cube face to read and where, in 16.8 fixed-point texel space.
+// Nearest lookups store UV * (Resolution - 1) so the integer part is the texel to read. Filtered lookups store
+// UV * Resolution, i.e. the origin sits on the face's outer edge and texel centres fall on half-integers.
+struct FOmniCaptureProjectionSample
+{
+    static constexpr uint32 FractionBits = 8;
+    static constexpr uint32 FractionMask = (1u << FractionBits) - 1u;
+    static constexpr uint32 CoordinateMask = 0x00FFFFFFu;
+    static constexpr uint32 InvalidFace = 0xFFu;
+
+    // [31:24] face index (InvalidFace for pixels outside the projection), [23:0] texel X
+    uint32 PackedX = InvalidFace << 24;
+    // [23:0] texel Y
+    uint32 PackedY = 0;
+
+    FORCEINLINE uint32 GetFace() const { return PackedX >> 24; }
+    FORCEINLINE bool IsValid() const { return GetFace() != InvalidFace; }
+    FORCEINLINE uint32 GetFixedX() const { return PackedX & CoordinateMask; }
+    FORCEINLINE uint32 GetFixedY() const { return PackedY & CoordinateMask; }
+    FORCEINLINE int32 GetTexelX() const { return static_cast<int32>(GetFixedX() >> FractionBits); }
+    FORCEINLINE int32 GetTexelY() const { return static_cast<int32>(GetFixedY() >> FractionBits); }
+};
+
+// Everything that influences the per-pixel geometry of a CPU projection. Two captures with equal keys share a LUT.
+struct OMNICAPTURE_API FOmniCaptureProjectionKey
+{
+    EOmniCaptureProjectionKind Kind = EOmniCaptureProjectionKind::Equirectangular;
+    int32 FaceResolution = 0;
+    FIntPoint EyeResolution = FIntPoint::ZeroValue;
+    float LongitudeSpan = 0.0f;
+    float LatitudeSpan = 0.0f;
+    float SeamBlend = 0.0f;
+    float PolarDampening = 0.0f;
+    float FisheyeFOV = 0.0f;
+    bool bHalfSphere = false;
+    EOmniCaptureCPUFilter Filter = EOmniCaptureCPUFilter::Nearest;
+
+    static FOmniCaptureProjectionKey MakeEquirect(const FOmniCaptureSettings& Settings, int32 FaceResolution, const FIntPoint& EyeResolution);
+    static FOmniCaptureProjectionKey MakeFisheye(const FOmniCaptureSettings& Settings, int32 FaceResolution, const FIntPoint& EyeResolution);
+
+    bool operator==(const FOmniCaptureProjectionKey& Other) const;
+    bool operator!=(const FOmniCaptureProjectionKey& Other) const { return !(*this == Other); }
+};
+
+// A texel addressed by face and linear offset into that face.
+struct FOmniCaptureCubeTexel
+{
+    uint32 Face = 0;
+    uint32 Offset = 0;
+};
+
+// Maps texels in a narrow apron around each cube face onto the neighbouring face that actually holds them, so
+// filtered sampling can read across seams instead of clamping at the face edge.
+class OMNICAPTURE_API FOmniCaptureCubeSeamTable
+{
+public:
+    static constexpr int32 Apron = 2;
+
+    FOmniCaptureCubeSeamTable() = default;
+    explicit FOmniCaptureCubeSeamTable(int32 InResolution);
+
+    bool IsValid() const { return Resolution > 0; }
+    int32 GetResolution() const { return Resolution; }
+
+    // X and Y must lie within Apron texels of the face and outside of it on at least one axis.
+    FORCEINLINE const FOmniCaptureCubeTexel& Resolve(uint32 Face, int32 X, int32 Y) const
+    {
+        return Texels.GetData()[Face * EntriesPerFace + GetEntryIndex(X, Y)];
+    }
+
+private:
+    // Entries are stored per face as the Apron rows above, the Apron rows below, then the left and right
+    // columns of every row in between.
+    FORCEINLINE int32 GetEntryIndex(int32 X, int32 Y) const
+    {
+        const int32 PaddedX = X + Apron;
+        const int32 PaddedResolution = Resolution + 2 * Apron;
+
+        if (Y < 0)
+        {
+            return (Y + Apron) * PaddedResolution + PaddedX;
+        }
+        if (Y >= Resolution)
+        {
+            return (Apron + Y - Resolution) * PaddedResolution + PaddedX;
+        }
+        return 2 * Apron * PaddedResolution + Y * 2 * Apron + (PaddedX < Apron ? PaddedX : PaddedX - Resolution);
+    }
+
+    int32 Resolution = 0;
+    int32 EntriesPerFace = 0;
+    TArray<FOmniCaptureCubeTexel> Texels;
+};
+
+// Per-eye lookup table mapping output pixels to cube face texels. Built once per key and shared across frames and layers.
+class OMNICAPTURE_API FOmniCaptureProjectionLUT
+{
+public:
+    static TSharedRef<const FOmniCaptureProjectionLUT> FindOrBuild(const FOmniCaptureProjectionKey& Key);
+    static void ResetCache();
+
+    explicit FOmniCaptureProjectionLUT(const FOmniCaptureProjectionKey& InKey);
+
+    const FOmniCaptureProjectionKey& GetKey() const { return Key; }
+    FIntPoint GetEyeResolution() const { return Key.EyeResolution; }
+    const FOmniCaptureProjectionSample* GetRow(int32 EyeY) const { return Samples.GetData() + static_cast<int64>(EyeY) * Key.EyeResolution.X; }
+    const FOmniCaptureProjectionSample& GetSample(int32 EyeX, int32 EyeY) const { return GetRow(EyeY)[EyeX]; }
+    // Only populated for filtered keys.
+    const FOmniCaptureCubeSeamTable& GetSeamTable() const { return SeamTable; }
+    int64 GetAllocatedSize() const { return Samples.GetAllocatedSize(); }
+
+private:
+    void Build();
+
+    FOmniCaptureProjectionKey Key;
+    TArray64<FOmniCaptureProjectionSample> Samples;
+    FOmniCaptureCubeSeamTable SeamTable;
+};
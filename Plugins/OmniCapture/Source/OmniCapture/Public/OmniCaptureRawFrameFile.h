@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ImageWriteTypes.h"
+#include "OmniCaptureTypes.h"
+
+// Raw capture dumps: frames are written uncompressed into large preallocated segment files
+// (<BaseName>_seg000.omniraw, _seg001, ...) at disk speed and encoded later. Every payload starts on an Alignment
+// boundary so the segments can be written with unbuffered I/O. Each segment has a small binary index next to it
+// (<BaseName>_seg000.omniidx): an FOmniCaptureRawIndexHeader followed by one FOmniCaptureRawIndexRecord per payload.
+struct FOmniCaptureRawIndexHeader
+{
+    static constexpr uint32 ExpectedMagic = 0x4952494F; // "OIRI"
+    static constexpr uint32 CurrentVersion = 1;
+
+    uint32 Magic = ExpectedMagic;
+    uint32 Version = CurrentVersion;
+    uint32 RecordSize = 0;
+    uint32 Alignment = 0;
+};
+static_assert(sizeof(FOmniCaptureRawIndexHeader) == 16, "Raw index header layout is part of the file format");
+
+struct FOmniCaptureRawIndexRecord
+{
+    int64 FrameIndex = 0;
+    double Timecode = 0.0;
+    // Byte offset of the payload in its segment; always a multiple of the header's Alignment.
+    uint64 Offset = 0;
+    // Payload bytes, excluding the padding up to the next aligned offset.
+    uint64 Size = 0;
+    int32 Width = 0;
+    int32 Height = 0;
+    uint8 PixelDataType = 0; // EOmniCapturePixelDataType
+    uint8 Precision = 0; // EOmniCapturePixelPrecision
+    uint8 bLinear = 0;
+    uint8 bKeyFrame = 0;
+    uint32 Reserved = 0;
+    // Auxiliary layer name, NUL-terminated; empty for the beauty layer.
+    ANSICHAR LayerName[48] = {};
+};
+static_assert(sizeof(FOmniCaptureRawIndexRecord) == 96, "Raw index record layout is part of the file format");
+
+// Appends frame payloads to raw segments. Safe to call from several threads; payloads are written one at a time.
+class OMNICAPTURE_API FOmniCaptureRawSegmentWriter
+{
+public:
+    // Payload offsets, sizes written to disk and staging buffers are multiples of this, which satisfies the sector
+    // alignment unbuffered I/O needs on every platform we ship.
+    static constexpr int64 Alignment = 4096;
+
+    FOmniCaptureRawSegmentWriter(const FString& InDirectory, const FString& InBaseName, int64 InSegmentCapacityBytes, bool bInUnbufferedIO);
+    ~FOmniCaptureRawSegmentWriter();
+
+    bool WritePayload(const FOmniCaptureFrameMetadata& Metadata, FName LayerName, const FImagePixelData& PixelData, EOmniCapturePixelDataType PixelDataType, EOmniCapturePixelPrecision Precision, bool bLinear);
+
+    // Trims the open segment to what was written and closes it along with its index.
+    void Close();
+
+    // Size of the segments, as trimmed on close, and their index files.
+    int64 GetBytesWritten() const;
+    int32 GetSegmentCount() const;
+    // False when the platform or file system refused unbuffered writes and the writer fell back to buffered ones.
+    bool IsUsingUnbufferedIO() const;
+
+    static FString GetSegmentPath(const FString& Directory, const FString& BaseName, int32 SegmentNumber);
+    static FString GetIndexPath(const FString& Directory, const FString& BaseName, int32 SegmentNumber);
+
+private:
+    class FSegmentFile;
+
+    bool OpenSegment();
+    void CloseSegment();
+
+    FString Directory;
+    FString BaseName;
+    int64 SegmentCapacityBytes = 0;
+    bool bUnbufferedIO = true;
+
+    mutable FCriticalSection CriticalSection;
+    TUniquePtr<FSegmentFile> Segment;
+    TUniquePtr<FArchive> IndexArchive;
+    int32 SegmentNumber = -1;
+    // Next aligned write offset, and the end of the last payload, which is where the segment is trimmed on close.
+    int64 SegmentOffset = 0;
+    int64 SegmentEnd = 0;
+    int64 BytesWritten = 0;
+    uint8* StagingBuffer = nullptr;
+    bool bUsingUnbufferedIO = false;
+    bool bFailed = false;
+};
+
+// Reads raw segments back, for transcoding or inspection.
+class OMNICAPTURE_API FOmniCaptureRawSequenceReader
+{
+public:
+    struct FEntry
+    {
+        FOmniCaptureRawIndexRecord Record;
+        int32 SegmentNumber = 0;
+    };
+
+    // Loads the index of every segment <BaseName>_segNNN in Directory, in segment order.
+    bool Open(const FString& InDirectory, const FString& InBaseName);
+
+    const TArray<FEntry>& GetEntries() const { return Entries; }
+    // Distinct frame indices, in capture order.
+    const TArray<int64>& GetFrameIndices() const { return FrameIndices; }
+
+    TUniquePtr<FImagePixelData> ReadPixelData(const FEntry& Entry) const;
+    // Rebuilds a frame from its beauty payload and auxiliary layers, ready for FOmniCaptureImageWriter.
+    TUniquePtr<FOmniCaptureFrame> ReadFrame(int64 FrameIndex) const;
+
+private:
+    FString Directory;
+    FString BaseName;
+    TArray<FEntry> Entries;
+    TArray<int64> FrameIndices;
+    // Positions in Entries of every payload of a frame, so ReadFrame does not scan the whole dump.
+    TMap<int64, TArray<int32, TInlineAllocator<4>>> EntriesByFrame;
+};
+
+class OMNICAPTURE_API FOmniCaptureRawTranscoder
+{
+public:
+    // Encodes every frame of a raw dump with Settings.ImageFormat (PNG, JPG, EXR or BMP) into OutputDirectory, named
+    // as a live capture would name them. Returns the number of frames transcoded.
+    static int32 Transcode(const FString& RawDirectory, const FString& RawBaseName, const FOmniCaptureSettings& Settings, const FString& OutputDirectory);
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureTypes.h"
+
+// A GPU-to-CPU copy that has been issued but not necessarily completed. The engine implementation wraps
+// FRHIGPUTextureReadback; tests and null-RHI builds substitute a CPU buffer.
+class IOmniCaptureReadback
+{
+public:
+    virtual ~IOmniCaptureReadback() = default;
+
+    virtual bool IsReady() = 0;
+    // Blocks until IsReady() returns true.
+    virtual void WaitUntilReady() = 0;
+    virtual const void* Lock(int32& OutRowPitchInBytes) = 0;
+    virtual void Unlock() = 0;
+};
+
+// An auxiliary layer copied back alongside a frame's beauty pass. Layers are linear data in the precision they were
+// converted in.
+struct FOmniCaptureLayerReadback
+{
+    TUniquePtr<IOmniCaptureReadback> Readback;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
+};
+
+// A captured frame whose pixels are still on their way back from the GPU. The frame carries its own metadata, audio
+// and GPU handles from the moment it is captured, so resolving it late never pairs pixels with the wrong frame.
+struct FOmniCaptureReadbackRequest
+{
+    // May be null when the frame's pixels were produced on the CPU; the frame then only keeps its place in line.
+    TUniquePtr<IOmniCaptureReadback> Readback;
+    // Resolved into the frame's auxiliary layers under their names once every copy of the request has landed.
+    TMap<FName, FOmniCaptureLayerReadback> LayerReadbacks;
+    // GPU work the producer queued without waiting for it. Enqueue runs it on the queue's thread before taking the
+    // request, where it fills in the frame's GPU outputs and issues the readbacks above.
+    TUniqueFunction<void(FOmniCaptureReadbackRequest&)> Issue;
+    TUniquePtr<FOmniCaptureFrame> Frame;
+    FIntPoint Size = FIntPoint::ZeroValue;
+    EOmniCapturePixelPrecision Precision = EOmniCapturePixelPrecision::Unknown;
+    bool bLinear = false;
+    // The consumer scales a preview down from the resolved pixels; the queue itself never builds one.
+    bool bWantsPreview = false;
+    double IssueSeconds = 0.0;
+};
+
+// Fixed-depth ring of in-flight readbacks. Frames leave strictly in the order they were enqueued: Poll stops at the
+// first copy that has not landed yet. Enqueue, Poll and Drain must be called from a single thread (the render thread
+// in the capture pipeline); GetStats may be called from any thread.
+class OMNICAPTURE_API FOmniCaptureReadbackQueue
+{
+public:
+    using FConsumer = TFunction<void(FOmniCaptureReadbackRequest&&)>;
+
+    void Initialize(int32 InDepth, const FConsumer& InConsumer);
+
+    // Takes ownership of the request after running its Issue step. If the queue is already full, the oldest request is
+    // waited on and resolved first.
+    void Enqueue(FOmniCaptureReadbackRequest&& Request);
+    // Enqueues the request and polls the queue from a render command, without waiting for the render thread to get
+    // to it. The producer side of the capture pipeline goes through here.
+    static void EnqueueOnRenderThread(const TSharedPtr<FOmniCaptureReadbackQueue, ESPMode::ThreadSafe>& Queue, FOmniCaptureReadbackRequest&& Request);
+    // Resolves every leading request whose copy has completed. Returns the number of frames handed to the consumer.
+    int32 Poll();
+    // Waits for and resolves everything still in flight.
+    void Drain();
+
+    int32 GetDepth() const { return Slots.Num(); }
+    int32 Num() const { return Count; }
+    FOmniCaptureReadbackStats GetStats() const;
+
+    // Copies a locked readback into image pixel data matching the capture gamma, honouring the row pitch. sRGB output
+    // is quantized to FColor. Returns false if the lock failed.
+    static bool ResolvePixels(IOmniCaptureReadback& Readback, const FIntPoint& Size, EOmniCapturePixelPrecision Precision, bool bLinear, TUniquePtr<FImagePixelData>& OutPixelData, EOmniCapturePixelDataType& OutPixelDataType);
+
+private:
+    void ResolveOldest();
+
+    TArray<FOmniCaptureReadbackRequest> Slots;
+    int32 Head = 0;
+    int32 Count = 0;
+    FConsumer Consumer;
+
+    mutable FCriticalSection StatsCriticalSection;
+    FOmniCaptureReadbackStats Stats;
+    double TotalLatencySeconds = 0.0;
+    double FirstIssueSeconds = 0.0;
+};
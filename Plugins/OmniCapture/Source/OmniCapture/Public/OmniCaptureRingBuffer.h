@@ -3,36 +3,42 @@
 #include "CoreMinimal.h"
 #include "OmniCaptureTypes.h"
 
-class FRunnableThread;
-class FOmniCaptureRingBufferWorker;
+class FOmniCaptureFrameSink;
 
+// A captured frame shared by every sink that still has to process it; the frame is freed once the last sink lets go.
+// Sinks only read it, so none can take data another sink has yet to see.
+using FOmniCaptureSharedFrame = TSharedPtr<const FOmniCaptureFrame, ESPMode::ThreadSafe>;
+
+// Fans captured frames out to a set of sinks (muxer, encoder, image writer, ...). Every sink reads through its own
+// bounded lock-free queue on its own worker thread, with its own capacity and backpressure policy, so a slow sink
+// only falls behind itself. The frame is stored once and shared by reference count.
 class OMNICAPTURE_API FOmniCaptureRingBuffer
 {
 public:
+    using FSinkConsumer = TFunction<void(const FOmniCaptureSharedFrame&)>;
+
+    // Slot count used when the settings ask for an unbounded buffer (RingBufferCapacity == 0). Such a buffer never
+    // drops frames; producers wait for the consumer instead.
+    static constexpr int32 UnboundedCapacity = 64;
+
     FOmniCaptureRingBuffer();
     ~FOmniCaptureRingBuffer();
 
-    void Initialize(const FOmniCaptureSettings& Settings, const TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)>& InConsumer);
+    // Takes the capacity and policy that sinks registered without their own use.
+    void Initialize(const FOmniCaptureSettings& Settings);
+
+    // Sinks must be registered before the first Enqueue. Consumers only ever run on the sink's worker thread.
+    void AddSink(FName Name, const FSinkConsumer& Consumer);
+    void AddSink(FName Name, const FSinkConsumer& Consumer, EOmniCaptureRingBufferPolicy SinkPolicy, int32 SinkCapacity);
+
     void Enqueue(TUniquePtr<FOmniCaptureFrame>&& Frame);
+    // Blocks until every sink has finished consuming the frames enqueued so far; consumers are not running afterwards
+    // until the next Enqueue.
     void Flush();
     FOmniCaptureRingBufferStats GetStats() const;
 
 private:
-    void StartWorker();
-    void StopWorker();
-
-    TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Mpsc> Queue;
-    TFunction<void(TUniquePtr<FOmniCaptureFrame>&&)> Consumer;
-
-    TUniquePtr<FRunnableThread> WorkerThread;
-    FOmniCaptureRingBufferWorker* Worker = nullptr;
-    FEvent* DataEvent = nullptr;
-    FCriticalSection QueueCriticalSection;
-    TAtomic<bool> bRunning;
-    TAtomic<int32> PendingCount;
-    TAtomic<int32> DroppedCount;
-    TAtomic<int32> BlockedCount;
-    int32 Capacity = 0;
-    EOmniCaptureRingBufferPolicy Policy = EOmniCaptureRingBufferPolicy::DropOldest;
+    TArray<TUniquePtr<FOmniCaptureFrameSink>> Sinks;
+    int32 Capacity = UnboundedCapacity;
+    EOmniCaptureRingBufferPolicy Policy = EOmniCaptureRingBufferPolicy::BlockProducer;
 };
-
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "OmniCaptureMuxer.h"
+#include "OmniCaptureTypes.h"
+#include "OmniCaptureWriterPool.h"
+#include "Templates/Atomic.h"
+#include "Templates/Function.h"
+
+struct FOmniCaptureSegmentRecord
+{
+    int32 SegmentIndex = 0;
+    FString Directory;
+    FString BaseFileName;
+    FString AudioPath;
+    FString VideoPath;
+    TArray<FOmniCaptureFrameMetadata> Frames;
+    int32 DroppedFrames = 0;
+    bool bHasImageSequence = false;
+};
+
+// A completed segment being muxed on a segment mux queue. Status is written by the pool thread under the queue's lock;
+// everything else belongs to the game thread once the job is queued.
+struct FOmniCaptureSegmentMuxJob
+{
+    FOmniCaptureSegmentRecord Segment;
+    FOmniCaptureSettings Settings;
+    TUniquePtr<FOmniCaptureMuxer> Muxer;
+    FOmniCaptureSegmentMuxStatus Status;
+    double StartTime = 0.0;
+    bool bMuxingExpected = false;
+    bool bSucceeded = false;
+    bool bReported = false;
+};
+
+// Completed segments muxing on their own pool while the capture carries on. Muxes run side by side, but finished
+// jobs are reported in the order they were queued, so the last one reported is always the last segment.
+class OMNICAPTURE_API FOmniCaptureSegmentMuxQueue
+{
+public:
+    using FJobRef = TSharedPtr<FOmniCaptureSegmentMuxJob, ESPMode::ThreadSafe>;
+    // Muxes one job on a pool thread and returns whether it succeeded; OutOutputPath names the muxed file, if any.
+    using FMuxStep = TFunction<bool(FOmniCaptureSegmentMuxJob& Job, FString& OutOutputPath)>;
+
+    explicit FOmniCaptureSegmentMuxQueue(FMuxStep InMuxStep);
+    // Cancels whatever has not started yet and waits for the running muxes.
+    ~FOmniCaptureSegmentMuxQueue();
+
+    // Forgets the previous capture's jobs. MaxConcurrentMuxes sizes the pool the next Submit creates.
+    void Reset(int32 InMaxConcurrentMuxes);
+    void Submit(const FJobRef& Job);
+    // Blocks until every queued job has run.
+    void WaitUntilIdle();
+    // Jobs that have not started are marked Cancelled without muxing; running ones finish before this returns.
+    void Cancel();
+    bool IsCancelled() const { return bCancelled.Load(); }
+
+    // Calls Report for each finished job in queue order, stopping at the first one still queued or muxing. Each job is
+    // reported once; cancelled jobs are skipped.
+    void ReportFinished(TFunctionRef<void(const FOmniCaptureSegmentMuxJob&)> Report);
+
+    int32 Num() const { return Jobs.Num(); }
+    TArray<FOmniCaptureSegmentMuxStatus> GetStatus() const;
+
+private:
+    bool RunJob(FOmniCaptureSegmentMuxJob& Job);
+
+    FMuxStep MuxStep;
+    int32 MaxConcurrentMuxes = 1;
+    TUniquePtr<FOmniCaptureWriterPool> Pool;
+    TArray<FJobRef> Jobs;
+    mutable FCriticalSection CriticalSection;
+    TAtomic<bool> bCancelled{ false };
+};
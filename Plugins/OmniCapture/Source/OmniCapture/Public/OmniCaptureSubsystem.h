@@ -3,10 +3,15 @@
 #include "OmniCaptureTypes.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "OmniCaptureRingBuffer.h"
+#include "OmniCaptureReadbackQueue.h"
 #include "OmniCaptureImageWriter.h"
 #include "OmniCaptureAudioRecorder.h"
 #include "OmniCaptureNVENCEncoder.h"
 #include "OmniCaptureMuxer.h"
+#include "OmniCapturePreviewImage.h"
+#include "OmniCaptureSegmentMuxQueue.h"
+#include "OmniCaptureWriterPool.h"
+#include "Containers/Queue.h"
 #include "Templates/Atomic.h"
 #include "Logging/LogVerbosity.h"
 #include "OmniCaptureOptional.h"
@@ -18,18 +23,6 @@ class AOmniCapturePreviewActor;
 class UTexture2D;
 class IConsoleVariable;
 
-struct FOmniCaptureSegmentRecord
-{
-    int32 SegmentIndex = 0;
-    FString Directory;
-    FString BaseFileName;
-    FString AudioPath;
-    FString VideoPath;
-    TArray<FOmniCaptureFrameMetadata> Frames;
-    int32 DroppedFrames = 0;
-    bool bHasImageSequence = false;
-};
-
 UCLASS()
 class OMNICAPTURE_API UOmniCaptureSubsystem final : public UWorldSubsystem
 {
@@ -75,9 +68,22 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FOmniCaptureRingBufferStats GetRingBufferStats() const { return LatestRingBufferStats; }
 
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureReadbackStats GetReadbackStats() const { return LatestReadbackStats; }
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureFramePoolStats GetFramePoolStats() const { return LatestFramePoolStats; }
+
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    FOmniCaptureWriterPoolStats GetWriterPoolStats() const { return LatestWriterPoolStats; }
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     FOmniAudioSyncStats GetAudioSyncStats() const;
 
+    // One entry per segment of the current or last capture that has been handed to the muxer, in segment order.
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    TArray<FOmniCaptureSegmentMuxStatus> GetSegmentMuxStatus() const;
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     const FOmniCaptureSettings& GetActiveSettings() const { return ActiveSettings; }
 
@@ -99,6 +105,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture")
     void SetPreviewVisualizationMode(EOmniCapturePreviewView InView);
 
+    // Hides the preview screen; while it is hidden the capture builds and uploads no preview at all.
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture")
+    void SetPreviewEnabled(bool bEnabled);
+
     UFUNCTION(BlueprintCallable, Category = "OmniCapture|Diagnostics")
     void GetCaptureDiagnosticLog(TArray<FOmniCaptureDiagnosticEntry>& OutEntries) const;
 
@@ -108,6 +118,10 @@ public:
     UFUNCTION(BlueprintCallable, Category = "OmniCapture|Diagnostics")
     FString GetLastErrorMessage() const { return LastErrorMessage; }
 
+    // Repairs the header of a WAV or CAF take whose capture never finished, such as after a crash.
+    UFUNCTION(BlueprintCallable, Category = "OmniCapture|Diagnostics")
+    bool RecoverAudioFile(const FString& FilePath);
+
     void SetActiveDiagnosticVerbosity(EOmniCaptureLogVerbosity InVerbosity);
 
     void SetPendingRigTransform(const FTransform& InTransform);
@@ -134,15 +148,24 @@ private:
     void TickCapture(float DeltaTime);
     void CaptureFrame();
     void FlushRingBuffer();
+    void EnqueueResolvedFrames();
+    void UpdateRingBufferStats();
+    void FlushReadbackQueue();
+    void ApplyResolvedPreview();
     void UpdateDynamicStereoParameters();
     void ApplyRenderFeatureOverrides();
     void RestoreRenderFeatureOverrides();
 
-    void HandleDroppedFrame();
+    void HandleDroppedFrame(int32 Count = 1);
 
     void ConfigureActiveSegment();
     void RotateSegmentIfNeeded();
     void CompleteActiveSegment(bool bStoreResults);
+    void QueueCompletedSegmentMuxes();
+    // The mux queue's step: finalizes one segment on a mux pool thread.
+    static bool MuxSegment(FOmniCaptureSegmentMuxJob& Job, FString& OutOutputPath);
+    void ReportFinishedSegmentMuxes();
+    void ReportSegmentMux(const FOmniCaptureSegmentMuxJob& Job);
     int64 CalculateActiveSegmentSizeBytes() const;
     void UpdateRuntimeWarnings();
     void AddWarningUnique(const FString& Warning);
@@ -180,6 +203,8 @@ private:
     bool bDroppedFrames = false;
 
     int32 DroppedFrameCount = 0;
+    // Ring buffer drops already counted into DroppedFrameCount.
+    int32 ReportedRingBufferDrops = 0;
     int32 RecordedSegmentDroppedFrames = 0;
 
     int32 FrameCounter = 0;
@@ -194,7 +219,6 @@ private:
     double LastFpsSampleTime = 0.0;
     int32 FramesSinceLastFpsSample = 0;
     double LastRuntimeWarningCheckTime = 0.0;
-    double LastSegmentSizeCheckTime = 0.0;
     double CurrentSegmentStartTime = 0.0;
     int32 CurrentSegmentIndex = 0;
     double DynamicParameterStartTime = 0.0;
@@ -206,6 +230,11 @@ private:
     TWeakObjectPtr<AOmniCapturePreviewActor> PreviewActor;
 
     TUniquePtr<FOmniCaptureRingBuffer> RingBuffer;
+    // Owned jointly with in-flight render commands; only touched on the render thread while capturing.
+    TSharedPtr<FOmniCaptureReadbackQueue, ESPMode::ThreadSafe> ReadbackQueue;
+    // Frames whose readback has resolved, passed from the render thread to the game thread, which enqueues them into
+    // the ring buffer so a blocking sink never stalls rendering.
+    TQueue<TUniquePtr<FOmniCaptureFrame>, EQueueMode::Spsc> ResolvedFrames;
     TUniquePtr<FOmniCaptureImageWriter> ImageWriter;
     TUniquePtr<FOmniCaptureAudioRecorder> AudioRecorder;
     TUniquePtr<FOmniCaptureNVENCEncoder> NVENCEncoder;
@@ -218,6 +247,8 @@ private:
 
     TArray<FOmniCaptureFrameMetadata> CapturedFrameMetadata;
     TArray<FOmniCaptureSegmentRecord> CompletedSegments;
+    // Segments are muxed here as soon as they rotate, so EndCapture is left with only the last one.
+    FOmniCaptureSegmentMuxQueue SegmentMuxes{ &UOmniCaptureSubsystem::MuxSegment };
     FString RecordedAudioPath;
     FString RecordedVideoPath;
     FString LastFinalizedOutput;
@@ -232,6 +263,16 @@ private:
 
     TArray<FString> ActiveWarnings;
     FOmniCaptureRingBufferStats LatestRingBufferStats;
+    FOmniCaptureReadbackStats LatestReadbackStats;
+    FOmniCaptureFramePoolStats LatestFramePoolStats;
+    FOmniCaptureWriterPoolStats LatestWriterPoolStats;
+
+    // Previews are built from a resolved frame into ReadbackPreview on the render thread, swapped into ResolvedPreview
+    // and swapped again into GamePreview before upload, so none of them reallocates from one tick to the next.
+    FCriticalSection ResolvedPreviewCriticalSection;
+    FOmniCapturePreviewImage ResolvedPreview;
+    FOmniCapturePreviewImage ReadbackPreview;
+    FOmniCapturePreviewImage GamePreview;
     FOmniAudioSyncStats AudioStats;
 
     EOmniCaptureState State = EOmniCaptureState::Idle;
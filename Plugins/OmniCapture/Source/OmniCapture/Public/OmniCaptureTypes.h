@@ -59,7 +59,15 @@ enum class EOmniOutputFormat : uint8
 };
 
 UENUM(BlueprintType)
-enum class EOmniCaptureImageFormat : uint8 { PNG, JPG, EXR, BMP };
+enum class EOmniCaptureImageFormat : uint8
+{
+    PNG,
+    JPG,
+    EXR,
+    BMP,
+    // Uncompressed frames in preallocated segment files, written at disk speed and transcoded afterwards.
+    Raw
+};
 
 UENUM(BlueprintType)
 enum class EOmniCaptureEXRCompression : uint8
@@ -73,6 +81,15 @@ enum class EOmniCaptureEXRCompression : uint8
     Dwab,
     Rle
 };
+
+UENUM(BlueprintType)
+enum class EOmniCaptureEXRTileLevels : uint8
+{
+    SingleLevel UMETA(DisplayName = "Single Level"),
+    MipMaps UMETA(DisplayName = "Mipmaps"),
+    RipMaps UMETA(DisplayName = "Ripmaps")
+};
+
 UENUM(BlueprintType)
 enum class EOmniCaptureHDRPrecision : uint8
 {
@@ -100,6 +117,14 @@ enum class EOmniCapturePixelDataType : uint8
 UENUM(BlueprintType)
 enum class EOmniCaptureGamma : uint8 { SRGB, Linear };
 
+UENUM(BlueprintType)
+enum class EOmniCaptureCPUFilter : uint8
+{
+        Nearest,
+        Bilinear,
+        Bicubic UMETA(DisplayName = "Bicubic (Catmull-Rom)")
+};
+
 UENUM(BlueprintType)
 enum class EOmniCapturePNGBitDepth : uint8
 {
@@ -108,6 +133,16 @@ enum class EOmniCapturePNGBitDepth : uint8
         BitDepth8 = 2 UMETA(DisplayName = "8-bit Color")
 };
 
+// zlib deflate strategies offered for PNG output.
+UENUM(BlueprintType)
+enum class EOmniCapturePNGZlibStrategy : uint8
+{
+        Default,
+        Filtered,
+        HuffmanOnly,
+        RLE
+};
+
 UENUM(BlueprintType)
 enum class EOmniCaptureColorSpace : uint8 { BT709, BT2020, HDR10 };
 
@@ -158,6 +193,9 @@ enum class EOmniCaptureState : uint8 { Idle, Recording, Paused, DroppedFrames, F
 UENUM(BlueprintType)
 enum class EOmniCaptureRingBufferPolicy : uint8 { DropOldest, BlockProducer };
 
+UENUM(BlueprintType)
+enum class EOmniCaptureAudioFileFormat : uint8 { WAV, CAF };
+
 UENUM(BlueprintType)
 enum class EOmniCapturePreviewView : uint8 { StereoComposite, LeftEye, RightEye };
 
@@ -261,9 +299,13 @@ struct OMNICAPTURE_API FOmniCaptureSettings
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") bool bEnablePreviewWindow = true;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.1, UIMin = 0.1)) float PreviewScreenScale = 1.0f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 1.0, UIMin = 5.0, ClampMax = 240.0)) float PreviewFrameRate = 30.0f;
+	// Longest edge of the preview texture in pixels; the preview is scaled down from the captured frame. 0 keeps the full size.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0, UIMin = 256, UIMax = 4096)) int32 PreviewMaxEdge = 1024;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") bool bRecordAudio = true;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") float AudioGain = 1.0f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") TSoftObjectPtr<class USoundSubmix> SubmixToRecord;
+	// WAV turns into RF64 past 4 GB; CAF has no size limit.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") EOmniCaptureAudioFileFormat AudioFileFormat = EOmniCaptureAudioFileFormat::WAV;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") float InterPupillaryDistanceCm = 6.4f;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo", meta = (ClampMin = 0.0, UIMin = 0.0)) float EyeConvergenceDistanceCm = 0.0f;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture|Stereo") UCurveFloat* InterpupillaryDistanceCurve = nullptr;
@@ -271,11 +313,19 @@ struct OMNICAPTURE_API FOmniCaptureSettings
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.0, UIMin = 0.0)) float SegmentDurationSeconds = 0.0f;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0)) int32 SegmentSizeLimitMB = 0;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0, UIMin = 0)) int32 SegmentFrameCount = 0;
+        // Segments are muxed in the background as soon as they rotate; this caps how many FFmpeg runs overlap.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 1, ClampMax = 16, UIMax = 8)) int32 MaxConcurrentSegmentMuxes = 2;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") bool bCreateSegmentSubfolders = true;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniOutputFormat OutputFormat = EOmniOutputFormat::ImageSequence;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCaptureImageFormat ImageFormat = EOmniCaptureImageFormat::PNG;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCaptureHDRPrecision HDRPrecision = EOmniCaptureHDRPrecision::HalfFloat;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCapturePNGBitDepth PNGBitDepth = EOmniCapturePNGBitDepth::BitDepth32;
+        // Split each PNG into row bands that are filtered and deflated on separate threads, then joined into one zlib stream.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG") bool bParallelPNGEncoding = true;
+        // Number of bands per image; 0 uses one per worker thread.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG", meta = (ClampMin = 0, ClampMax = 256, UIMin = 0, UIMax = 64, EditCondition = "bParallelPNGEncoding")) int32 PNGEncodeBands = 0;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG", meta = (ClampMin = 0, ClampMax = 9, UIMin = 0, UIMax = 9)) int32 PNGCompressionLevel = 6;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|PNG") EOmniCapturePNGZlibStrategy PNGZlibStrategy = EOmniCapturePNGZlibStrategy::Default;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FString OutputDirectory;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FString OutputFileName = TEXT("OmniCapture");
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") EOmniCaptureColorSpace ColorSpace = EOmniCaptureColorSpace::BT709;
@@ -283,20 +333,50 @@ struct OMNICAPTURE_API FOmniCaptureSettings
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") bool bPackEXRAuxiliaryLayers = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") bool bUseEXRMultiPart = false;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") EOmniCaptureEXRCompression EXRCompression = EOmniCaptureEXRCompression::Zip;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Output|EXR") bool bZeroCopyEXRLayers = true;
+        // Threads compressing one EXR file. 0 balances against EXRConcurrentFrames and the core count; 1 compresses on the writing thread.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (ClampMin = 0, ClampMax = 64, UIMin = 0, UIMax = 32)) int32 EXRCompressionThreads = 0;
+        // EXR frames written at once. 0 balances against EXRCompressionThreads, capped by MaxPendingImageTasks.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (ClampMin = 0, ClampMax = 64, UIMin = 0, UIMax = 16)) int32 EXRConcurrentFrames = 0;
+        // Write tiled EXRs so compositors can read a viewport of a large panorama without decoding every scanline.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR") bool bWriteTiledEXR = false;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (ClampMin = 16, ClampMax = 4096, UIMin = 32, UIMax = 1024, EditCondition = "bWriteTiledEXR")) int32 EXRTileSize = 256;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|EXR", meta = (EditCondition = "bWriteTiledEXR")) EOmniCaptureEXRTileLevels EXRTileLevels = EOmniCaptureEXRTileLevels::SingleLevel;
+        // Pack each segment's images into one <OutputFileName>.omnicap file instead of a file per image; the muxer reads it in place.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") bool bWriteFrameContainer = false;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") bool bForceConstantFrameRate = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") bool bAllowNVENCFallback = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 1, UIMin = 1)) int32 MaxPendingImageTasks = 8;
+        // Writer threads owned by the image writer; 0 uses half the cores, up to MaxPendingImageTasks. EXR output uses EXRConcurrentFrames instead.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 0, ClampMax = 64, UIMin = 0, UIMax = 32)) int32 ImageWriterThreads = 0;
+        // Bytes of frame data the writer may hold queued or in progress before capture waits; 0 allows MaxPendingImageTasks frames' worth.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output", meta = (ClampMin = 0, UIMin = 0, UIMax = 16384, Units = "Megabytes")) int32 ImageWriterMaxInFlightMB = 0;
+        // Cores the writer threads may run on, as a bit mask; 0 lets them run anywhere.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Output") int64 ImageWriterAffinityMask = 0;
+        // Space preallocated per raw segment file; the capture moves on to a new segment when one fills up.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|Raw", meta = (ClampMin = 64, UIMin = 256, UIMax = 65536, Units = "Megabytes")) int32 RawSegmentSizeMB = 4096;
+        // Bypass the OS file cache for raw segments, falling back to buffered writes where the file system refuses.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|Raw") bool bRawUnbufferedIO = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0)) int32 MinimumFreeDiskSpaceGB = 2;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics", meta = (ClampMin = 0.1, ClampMax = 1.0)) float LowFrameRateWarningRatio = 0.85f;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Diagnostics") EOmniCaptureLogVerbosity DiagnosticVerbosity = EOmniCaptureLogVerbosity::Info;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FString PreferredFFmpegPath;
+	// Encode image-sequence captures while recording by piping raw frames to FFmpeg; no image files are written.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|FFmpeg") bool bStreamToFFmpeg = false;
+	// Frames queued for the live encoder before the capture waits on it or drops, per RingBufferPolicy.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output|FFmpeg", meta = (ClampMin = 1, UIMax = 16, EditCondition = "bStreamToFFmpeg")) int32 FFmpegPipeQueueFrames = 4;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.0, ClampMax = 1.0)) float SeamBlend = 0.25f;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0.0, ClampMax = 1.0)) float PolarDampening = 0.5f;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture") EOmniCaptureCPUFilter CPUFallbackFilter = EOmniCaptureCPUFilter::Nearest;
+	// Number of GPU readbacks allowed in flight before the capture waits for the oldest; 0 reads every frame back before the next one is captured.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = 0, ClampMax = 8, UIMin = 0, UIMax = 8)) int32 ReadbackQueueDepth = 3;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Output") FOmniCaptureQuality Quality;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureCodec Codec = EOmniCaptureCodec::HEVC;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureColorFormat NVENCColorFormat = EOmniCaptureColorFormat::NV12;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") bool bZeroCopy = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureNVENCD3D12Interop D3D12InteropMode = EOmniCaptureNVENCD3D12Interop::Bridge;
+        // Write NVENC output straight into a fragmented MP4 with the recorded audio; off writes a raw bitstream for FFmpeg to wrap.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") bool bNativeMP4Mux = true;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC", meta = (ClampMin = 0, UIMin = 0)) int32 RingBufferCapacity = 6;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") EOmniCaptureRingBufferPolicy RingBufferPolicy = EOmniCaptureRingBufferPolicy::DropOldest;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "NVENC") FString NVENCRuntimeDirectory;
@@ -403,13 +483,102 @@ struct FOmniCaptureFrame
         TMap<FName, FOmniCaptureLayerPayload> AuxiliaryLayers;
 };
 
+USTRUCT(BlueprintType)
+struct FOmniCaptureFrameSinkStats
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") FName Name;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 Capacity = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 PendingFrames = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 DroppedFrames = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 BlockedPushes = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 ConsumedFrames = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double AverageConsumeMilliseconds = 0.0;
+};
+
 USTRUCT(BlueprintType)
 struct FOmniCaptureRingBufferStats
 {
 	GENERATED_BODY()
+	// Backlog of the furthest-behind sink.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 PendingFrames = 0;
+	// Totals over all sinks.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 DroppedFrames = 0;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 BlockedPushes = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") TArray<FOmniCaptureFrameSinkStats> Sinks;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureFramePoolStats
+{
+	GENERATED_BODY()
+	// Acquires served from an idle buffer / that had to allocate.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 Hits = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 Misses = 0;
+	// Buffers currently held by frames, writers and encoders.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 OutstandingBuffers = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 OutstandingBytes = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 HighWaterBuffers = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 HighWaterBytes = 0;
+	// Buffers waiting in the pool for reuse.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 IdleBuffers = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 IdleBytes = 0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureWriterPoolStats
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 WorkerCount = 0;
+	// Tasks admitted but not yet picked up by a worker / currently running.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 QueueDepth = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 ActiveTasks = 0;
+	// Payload bytes of queued and running tasks, against the admission budget.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 BytesInFlight = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 MaxBytesInFlight = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int64 PeakBytesInFlight = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 CompletedTasks = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 FailedTasks = 0;
+	// Submits that had to wait for bytes to drain before they were admitted.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 ThrottledSubmits = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double AverageAdmissionWaitMilliseconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double AverageQueueMilliseconds = 0.0;
+	// Encode plus write time of one task.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double AverageTaskMilliseconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double LastTaskMilliseconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double MaxTaskMilliseconds = 0.0;
+};
+
+UENUM(BlueprintType)
+enum class EOmniCaptureSegmentMuxState : uint8 { Queued, Muxing, Succeeded, Failed, Cancelled };
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureSegmentMuxStatus
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 SegmentIndex = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") EOmniCaptureSegmentMuxState State = EOmniCaptureSegmentMuxState::Queued;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 FrameCount = 0;
+	// The muxed file once State is Succeeded.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") FString OutputPath;
+	// Time spent muxing so far, or in total once finished.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double MuxSeconds = 0.0;
+};
+
+USTRUCT(BlueprintType)
+struct FOmniCaptureReadbackStats
+{
+	GENERATED_BODY()
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 QueueDepth = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 InFlightReadbacks = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 CompletedReadbacks = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 FailedReadbacks = 0;
+	// Enqueues that found the queue full and had to wait for the oldest copy to land.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") int32 StalledEnqueues = 0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double LastLatencyMilliseconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double AverageLatencyMilliseconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double MaxLatencyMilliseconds = 0.0;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stats") double ResolvedFramesPerSecond = 0.0;
 };
 
 USTRUCT(BlueprintType)
@@ -421,6 +590,13 @@ struct FOmniAudioSyncStats
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") double DriftMilliseconds = 0.0;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") double MaxObservedDriftMilliseconds = 0.0;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") int32 PendingPackets = 0;
+        // Audio blocks the recorder had no room for, and frames that found no audio waiting.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") int32 DroppedPackets = 0;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") int32 Underruns = 0;
+        // Resampling correction the recorder applies to keep audio on the video clock, and the times it had to skip
+        // audio or insert silence instead.
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") double ClockCorrectionPPM = 0.0;
+        UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") int32 ClockResyncs = 0;
         UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio") bool bInError = false;
 };
 
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "OmniCaptureTypes.h"
+#include "Templates/Function.h"
+
+class FEvent;
+
+// Worker threads owned by one image writer, so encoding and disk writes stay off the engine's global pool and the
+// render thread's tasks. Admission is by bytes in flight rather than task count: a producer blocks while the payloads
+// already queued or running would push the total over the budget, so a float frame weighs four times an 8-bit one.
+class OMNICAPTURE_API FOmniCaptureWriterPool
+{
+public:
+    // Returns false when the write failed; failures are counted and logged.
+    using FTask = TUniqueFunction<bool()>;
+
+    // Name labels the pool's threads and its failure messages, e.g. "ImageWrite" or "SegmentMux".
+    FOmniCaptureWriterPool(FName InName, int32 InWorkerCount, uint64 InAffinityMask, EThreadPriority InPriority, int64 InMaxBytesInFlight);
+    ~FOmniCaptureWriterPool();
+
+    // Queues Task, blocking while Bytes would take the pool over its budget. A task is always admitted when nothing
+    // else is in flight, so a single payload larger than the budget cannot stall the capture.
+    void Submit(FTask&& Task, int64 Bytes);
+
+    // Blocks until every submitted task has finished.
+    void WaitUntilIdle();
+
+    void SetMaxBytesInFlight(int64 InMaxBytesInFlight);
+    int64 GetMaxBytesInFlight() const;
+    int32 GetWorkerCount() const { return Workers.Num(); }
+    FOmniCaptureWriterPoolStats GetStats() const;
+
+private:
+    class FWorker;
+
+    struct FQueuedTask
+    {
+        FTask Task;
+        int64 Bytes = 0;
+        uint64 SubmitCycles = 0;
+    };
+
+    // Worker loop body: runs queued tasks until the pool shuts down.
+    void RunWorker();
+    bool TryTakeTask(FQueuedTask& OutTask);
+    void CompleteTask(const FQueuedTask& Task, bool bSucceeded, uint64 StartCycles);
+    // Tasks waiting for a worker; callers hold CriticalSection.
+    int32 NumQueued() const { return Queue.Num() - QueueHead; }
+
+    FName Name;
+    mutable FCriticalSection CriticalSection;
+    // FIFO: tasks before QueueHead have already been taken and are compacted away in batches.
+    TArray<FQueuedTask> Queue;
+    int32 QueueHead = 0;
+    int32 ActiveTasks = 0;
+    int32 WaitingProducers = 0;
+    int64 BytesInFlight = 0;
+    int64 MaxBytesInFlight = 0;
+    bool bRunning = true;
+    FOmniCaptureWriterPoolStats Stats;
+    uint64 QueueCycles = 0;
+    uint64 TaskCycles = 0;
+    uint64 AdmissionCycles = 0;
+
+    FEvent* WorkEvent = nullptr;
+    FEvent* SpaceEvent = nullptr;
+    FEvent* IdleEvent = nullptr;
+    TArray<TUniquePtr<FWorker>> Workers;
+};
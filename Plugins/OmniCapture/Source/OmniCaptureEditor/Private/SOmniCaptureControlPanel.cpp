@@ -130,6 +130,24 @@ namespace
         }
     }
 
+    FText SegmentMuxStateToText(EOmniCaptureSegmentMuxState State)
+    {
+        switch (State)
+        {
+        case EOmniCaptureSegmentMuxState::Muxing:
+            return LOCTEXT("SegmentMuxMuxing", "Muxing");
+        case EOmniCaptureSegmentMuxState::Succeeded:
+            return LOCTEXT("SegmentMuxSucceeded", "Done");
+        case EOmniCaptureSegmentMuxState::Failed:
+            return LOCTEXT("SegmentMuxFailed", "Failed");
+        case EOmniCaptureSegmentMuxState::Cancelled:
+            return LOCTEXT("SegmentMuxCancelled", "Cancelled");
+        case EOmniCaptureSegmentMuxState::Queued:
+        default:
+            return LOCTEXT("SegmentMuxQueued", "Queued");
+        }
+    }
+
     FText ProjectionToText(EOmniCaptureProjection Projection)
     {
         switch (Projection)
@@ -172,6 +190,8 @@ namespace
             return LOCTEXT("ImageFormatEXR", "EXR Sequence");
         case EOmniCaptureImageFormat::BMP:
             return LOCTEXT("ImageFormatBMP", "BMP Sequence");
+        case EOmniCaptureImageFormat::Raw:
+            return LOCTEXT("ImageFormatRaw", "Raw Dump (transcode later)");
         case EOmniCaptureImageFormat::PNG:
         default:
             return LOCTEXT("ImageFormatPNG", "PNG Sequence");
@@ -341,6 +361,7 @@ void SOmniCaptureControlPanel::Construct(const FArguments& InArgs)
     ImageFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniCaptureImageFormat>>(EOmniCaptureImageFormat::JPG));
     ImageFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniCaptureImageFormat>>(EOmniCaptureImageFormat::EXR));
     ImageFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniCaptureImageFormat>>(EOmniCaptureImageFormat::BMP));
+    ImageFormatOptions.Add(MakeShared<TEnumOptionValue<EOmniCaptureImageFormat>>(EOmniCaptureImageFormat::Raw));
 
     PNGBitDepthOptions.Reset();
     PNGBitDepthOptions.Add(MakeShared<TEnumOptionValue<EOmniCapturePNGBitDepth>>(EOmniCapturePNGBitDepth::BitDepth8));
@@ -1604,6 +1625,11 @@ void SOmniCaptureControlPanel::Construct(const FArguments& InArgs)
             ]
             + SVerticalBox::Slot()
             .AutoHeight()
+            [
+                CreateDisplayText(SegmentMuxTextBlock, LOCTEXT("SegmentMuxInactive", "Segment Muxing: -"))
+            ]
+            + SVerticalBox::Slot()
+            .AutoHeight()
             .Padding(0.f, 8.f)
             [
                 SNew(SSeparator)
@@ -2046,6 +2072,7 @@ void SOmniCaptureControlPanel::RefreshStatus()
         }
         RingBufferTextBlock->SetText(FText::GetEmpty());
         AudioTextBlock->SetText(FText::GetEmpty());
+        SegmentMuxTextBlock->SetText(FText::GetEmpty());
         UpdateOutputDirectoryDisplay();
         RebuildWarningList(TArray<FString>());
         return;
@@ -2117,7 +2144,22 @@ void SOmniCaptureControlPanel::RefreshStatus()
         FText::AsNumber(RingStats.PendingFrames),
         FText::AsNumber(RingStats.DroppedFrames),
         FText::AsNumber(RingStats.BlockedPushes));
-    RingBufferTextBlock->SetText(RingText);
+    FNumberFormattingOptions MillisecondsFormat;
+    MillisecondsFormat.SetMinimumFractionalDigits(2);
+    MillisecondsFormat.SetMaximumFractionalDigits(2);
+    TArray<FText> RingLines;
+    RingLines.Add(RingText);
+    for (const FOmniCaptureFrameSinkStats& SinkStats : RingStats.Sinks)
+    {
+        RingLines.Add(FText::Format(LOCTEXT("RingSinkStatsFormat", "  {0}: Pending {1}/{2} | Dropped {3} | Blocked {4} | {5} ms/frame"),
+            FText::FromName(SinkStats.Name),
+            FText::AsNumber(SinkStats.PendingFrames),
+            FText::AsNumber(SinkStats.Capacity),
+            FText::AsNumber(SinkStats.DroppedFrames),
+            FText::AsNumber(SinkStats.BlockedPushes),
+            FText::AsNumber(SinkStats.AverageConsumeMilliseconds, &MillisecondsFormat)));
+    }
+    RingBufferTextBlock->SetText(FText::Join(FText::FromString(TEXT("\n")), RingLines));
 
     const FOmniAudioSyncStats AudioStats = Subsystem->GetAudioSyncStats();
     const FString DriftString = FString::Printf(TEXT("%.2f"), AudioStats.DriftMilliseconds);
@@ -2129,6 +2171,35 @@ void SOmniCaptureControlPanel::RefreshStatus()
     AudioTextBlock->SetText(AudioText);
     AudioTextBlock->SetForegroundColor(AudioStats.bInError ? FSlateColor(FLinearColor::Red) : FSlateColor::UseForeground());
 
+    const TArray<FOmniCaptureSegmentMuxStatus> SegmentMuxStatus = Subsystem->GetSegmentMuxStatus();
+    if (SegmentMuxStatus.Num() == 0)
+    {
+        SegmentMuxTextBlock->SetText(LOCTEXT("SegmentMuxInactive", "Segment Muxing: -"));
+        SegmentMuxTextBlock->SetForegroundColor(FSlateColor::UseForeground());
+    }
+    else
+    {
+        int32 FinishedSegments = 0;
+        int32 FailedSegments = 0;
+        FNumberFormattingOptions SecondsFormat;
+        SecondsFormat.SetMinimumFractionalDigits(1);
+        SecondsFormat.SetMaximumFractionalDigits(1);
+        TArray<FText> SegmentLines;
+        for (const FOmniCaptureSegmentMuxStatus& Status : SegmentMuxStatus)
+        {
+            FinishedSegments += (Status.State == EOmniCaptureSegmentMuxState::Queued || Status.State == EOmniCaptureSegmentMuxState::Muxing) ? 0 : 1;
+            FailedSegments += Status.State == EOmniCaptureSegmentMuxState::Failed ? 1 : 0;
+            SegmentLines.Add(FText::Format(LOCTEXT("SegmentMuxLineFormat", "  Segment {0}: {1} | {2} frames | {3} s"),
+                FText::AsNumber(Status.SegmentIndex),
+                SegmentMuxStateToText(Status.State),
+                FText::AsNumber(Status.FrameCount),
+                FText::AsNumber(Status.MuxSeconds, &SecondsFormat)));
+        }
+        SegmentLines.Insert(FText::Format(LOCTEXT("SegmentMuxFormat", "Segment Muxing: {0}/{1} done"), FText::AsNumber(FinishedSegments), FText::AsNumber(SegmentMuxStatus.Num())), 0);
+        SegmentMuxTextBlock->SetText(FText::Join(FText::FromString(TEXT("\n")), SegmentLines));
+        SegmentMuxTextBlock->SetForegroundColor(FailedSegments > 0 ? FSlateColor(FLinearColor::Red) : FSlateColor::UseForeground());
+    }
+
     UpdateOutputDirectoryDisplay();
     RebuildWarningList(Subsystem->GetActiveWarnings());
     RefreshConfigurationSummary();
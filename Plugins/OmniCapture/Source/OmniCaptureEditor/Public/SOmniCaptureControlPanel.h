@@ -269,6 +269,7 @@ private:
     TSharedPtr<SMultiLineEditableTextBox> ActiveConfigTextBlock;
     TSharedPtr<SMultiLineEditableTextBox> RingBufferTextBlock;
     TSharedPtr<SMultiLineEditableTextBox> AudioTextBlock;
+    TSharedPtr<SMultiLineEditableTextBox> SegmentMuxTextBlock;
     TSharedPtr<SMultiLineEditableTextBox> FrameRateTextBlock;
     TSharedPtr<SMultiLineEditableTextBox> LastStillTextBlock;
     TSharedPtr<SMultiLineEditableTextBox> OutputDirectoryTextBlock;